@@ -5,9 +5,14 @@
 // ====== Video (tetap pakai addon kamu)
 #include "cam_stream_addon.h"
 
-// ====== Audio (PDM -> WebSocket BIN PCM16)
+// ====== Audio (PDM -> WebSocket BIN PCM16) + video WS (ws_session.h)
 #include <WebSocketsServer.h>
 #include "ESP_I2S.h"
+#include "ws_session.h"
+#include "audio_frame.h"
+#include "audio_codec.h"
+#include "audio_pcm.h"
+#include "esp_timer.h"
 
 // -------------------------------
 // PIN KAMERA (DFRobot ESP32-S3 AI Camera)
@@ -40,17 +45,25 @@
 #define I2S_SD_IO_DEFAULT   GPIO_NUM_39          // PDM DATA default
 #define ALT_SD_PIN          GPIO_NUM_40          // fallback DATA
 
-// Gain software (boleh diubah)
+// Gain software (boleh diubah); dipakai sebagai Q15 (audio_pcm.h)
 #define SOFTWARE_GAIN       (3.0f)     // 6..12 umumnya pas (mulai konservatif 3)
 
 // Buffer input 32-bit dari I2S
 #define AUDIO_BUF_32_COUNT  (1024)
 static int32_t buffer_in_32[AUDIO_BUF_32_COUNT * 2];  // safety
 
+// Pesan audio: audio_header_t lalu PCM16 (header 24 byte, PCM tetap rata 4)
+static uint8_t audio_msg[sizeof(audio_header_t) + AUDIO_BUF_32_COUNT * 2 * sizeof(int16_t)] __attribute__((aligned(4)));
+// Pesan codec lain (audio_codec.h), di-encode dari PCM16 audio_msg; tidak
+// ada codec yang lebih besar dari PCM16 untuk blok sepanjang ini
+static uint8_t audio_enc_msg[sizeof(audio_msg)];
+static audio_codec_state_t g_codec_state[AUDIO_CODEC_MAX];
+static_assert(AUDIO_BUF_32_COUNT % AUDIO_IMA_BLOCK_SAMPLES == 0, "blok IMA-ADPCM harus pas dengan baca I2S");
+
 // -------------------------------
 // GLOBALS
 Preferences preferences;
-WebSocketsServer g_ws(81);     // audio WS di :81
+WebSocketsServer g_ws(81);     // audio + video WS di :81
 static I2SClass g_i2s_mic;
 
 static volatile int  g_dynamic_shift = 8;  // auto shift 32->16
@@ -58,6 +71,7 @@ static gpio_num_t    g_sd_pin        = I2S_SD_IO_DEFAULT;
 static bool          g_triedAltPin   = false;
 static uint32_t      g_zeroRun       = 0;
 static const uint32_t ZERO_RUN_TRY   = 50;
+static uint32_t      g_audio_seq     = 0;  // seq audio_header_t, naik tiap blok I2S
 
 // -------------------------------
 // PROTO
@@ -160,13 +174,30 @@ static bool initI2S(gpio_num_t sd_pin) {
 
 // -------------------------------
 // WS events
+static_assert(WS_SESSION_MAX_CLIENTS >= WEBSOCKETS_SERVER_CLIENT_MAX, "ws_session kurang slot");
+static_assert(WS_SESSION_HEADROOM >= WEBSOCKETS_MAX_HEADER_SIZE, "headroom video kurang");
+
+static bool wsSendBin(uint8_t num, uint8_t *payload, size_t length, bool headerToPayload) {
+  return g_ws.sendBIN(num, payload, length, headerToPayload);
+}
+
+static bool wsSendTxt(uint8_t num, uint8_t *payload, size_t length, bool headerToPayload) {
+  return g_ws.sendTXT(num, payload, length, headerToPayload);
+}
+
 static void onWsEvent(uint8_t num, WStype_t type, uint8_t * payload, size_t length) {
   switch(type) {
     case WStype_CONNECTED:
       Serial.printf("WS[%u] connected: %s\n", num, g_ws.remoteIP(num).toString().c_str());
+      ws_session_connected(num);
       break;
     case WStype_DISCONNECTED:
       Serial.printf("WS[%u] disconnected.\n", num);
+      ws_session_disconnected(num);
+      break;
+    case WStype_TEXT:
+      // subscribe/unsubscribe audio|video, fps & quality video per klien
+      ws_session_text(num, (const char*)payload, length);
       break;
     default: break;
   }
@@ -174,10 +205,11 @@ static void onWsEvent(uint8_t num, WStype_t type, uint8_t * payload, size_t leng
 
 // Start WS + task
 static void startAudioWebSocket() {
+  ws_session_begin(wsSendBin, wsSendTxt);
   g_ws.begin();
   g_ws.onEvent(onWsEvent);
   g_ws.enableHeartbeat(15000, 3000, 2);
-  Serial.println("WebSocket audio server started on :81");
+  Serial.println("WebSocket audio/video server started on :81");
 
   // Jalankan task audio di core 1
   xTaskCreatePinnedToCore(audioTask, "AudioTask", 20000, NULL, 2, NULL, 1);
@@ -185,28 +217,36 @@ static void startAudioWebSocket() {
 }
 
 // -------------------------------
-// TASK: baca I2S 32-bit -> PCM16 + gain -> broadcast BIN via WS
+// TASK: baca I2S 32-bit -> PCM16 + gain -> BIN ke klien channel audio
 static void audioTask(void *pv) {
   if (!initI2S(g_sd_pin)) {
     Serial.println("AudioTask: initI2S FAILED");
     vTaskDelete(NULL);
     return;
   }
+  audio_gain_t gain;
+  if (!audio_gain_init(&gain, SOFTWARE_GAIN)) {
+    audio_gain_init(&gain, 1.0f);
+  }
+  Serial.printf("AudioTask: PCM gain %d/2^%u\n", gain.q15, gain.shift);
 
   size_t bytes_read = 0;
   uint32_t lastBeat = 0;
   uint32_t tlog = 0;
+  uint8_t prev_codecs = 0;
+  uint32_t enc_us = 0;  // encode blok terakhir, semua codec selain PCM16
+  uint32_t pcm_us = 0;  // konversi 32->16 blok terakhir
 
   for (;;) {
     uint32_t now_ms = millis();
 
     // heartbeat 1s
     if (now_ms - lastBeat > 1000) {
-      g_ws.broadcastTXT("beat");
+      ws_session_broadcast_txt(0, "beat");
       lastBeat = now_ms;
     }
 
-    if (g_ws.connectedClients() == 0) {
+    if (ws_session_count(WS_CH_AUDIO) == 0) {
       vTaskDelay(50 / portTICK_PERIOD_MS);
       continue;
     }
@@ -217,15 +257,20 @@ static void audioTask(void *pv) {
       vTaskDelay(5 / portTICK_PERIOD_MS);
       continue;
     }
-
-    // Cari amplitudo 32-bit mentah (untuk auto-shift & failover)
-    int32_t maxAbs32 = 0;
+    // readBytes kembali saat sampel terakhir masuk: sampel pertama = sekarang - durasi blok
+    int64_t capture_us = esp_timer_get_time() -
+                         (int64_t)(bytes_read / sizeof(int32_t)) * 1000000 / I2S_SAMPLE_RATE;
+
+    // Satu lintasan: 32->16 dengan shift blok sebelumnya + gain Q15 +
+    // saturasi, sekaligus amplitudo 32-bit mentah (untuk auto-shift & failover).
+    // Lonjakan tiba-tiba disaturasi satu blok, blok berikutnya sudah ikut shift baru.
+    int16_t *out16 = (int16_t*)(audio_msg + sizeof(audio_header_t));
     size_t n32 = bytes_read / sizeof(int32_t);
-    for (size_t i = 0; i < n32; i++) {
-      int32_t v = buffer_in_32[i];
-      int32_t a = v >= 0 ? v : -v;
-      if (a > maxAbs32) maxAbs32 = a;
-    }
+    int shift = g_dynamic_shift;
+    int64_t t_pcm = esp_timer_get_time();
+    int32_t maxAbs32 = audio_pcm_convert(buffer_in_32, out16, n32, shift, &gain);
+    pcm_us = (uint32_t)(esp_timer_get_time() - t_pcm);
+    cam_metrics_stage(CAM_STAGE_AUDIO_CONVERT, pcm_us);
 
     // Auto-shift dinamis agar tidak clipping / terlalu kecil
     if (maxAbs32 > 0) {
@@ -242,8 +287,9 @@ static void audioTask(void *pv) {
 
     // Log tiap 0.5s
     if (millis() - tlog > 500) {
-      Serial.printf("I2S bytes=%u maxAbs32=%ld SHIFT=%d (DATA=%d)\n",
-                    (unsigned)bytes_read, (long)maxAbs32, g_dynamic_shift, (int)g_sd_pin);
+      Serial.printf("I2S bytes=%u maxAbs32=%ld SHIFT=%d (DATA=%d) pcm=%uus enc=%uus/%ums\n",
+                    (unsigned)bytes_read, (long)maxAbs32, g_dynamic_shift, (int)g_sd_pin, (unsigned)pcm_us, (unsigned)enc_us,
+                    (unsigned)(bytes_read / sizeof(int32_t) * 1000 / I2S_SAMPLE_RATE));
       tlog = millis();
     }
 
@@ -261,18 +307,41 @@ static void audioTask(void *pv) {
       }
     }
 
-    // Konversi 32->16 + software gain
-    static int16_t out16[AUDIO_BUF_32_COUNT * 2];
-    for (size_t i = 0; i < n32; i++) {
-      int16_t s = (int16_t)(buffer_in_32[i] >> g_dynamic_shift);
-      int32_t g = (int32_t)((float)s * SOFTWARE_GAIN);
-      if (g > 32767) g = 32767;
-      if (g < -32768) g = -32768;
-      out16[i] = (int16_t)g;
+    // Kirim biner ke klien audio (di bawah lock ws_session, lihat loop());
+    // klien yang meminta header dapat audio_header_t + PCM16, klien lama PCM16 saja
+    uint32_t seq = g_audio_seq++;
+    uint8_t codecs = ws_session_audio_codecs();
+    if (codecs & (1 << AUDIO_CODEC_PCM16)) {
+      audio_header_init((audio_header_t*)audio_msg, AUDIO_CODEC_PCM16, seq, I2S_SAMPLE_RATE,
+                        (uint16_t)n32, (uint8_t)shift, capture_us);
+      ws_session_send_audio(AUDIO_CODEC_PCM16, audio_msg, sizeof(audio_header_t),
+                            sizeof(audio_header_t) + n32 * sizeof(int16_t));
     }
 
-    // Kirim biner PCM16 ke semua klien
-    g_ws.broadcastBIN((uint8_t*)out16, n32 * sizeof(int16_t));
+    // Codec lain: encode sekali per blok untuk semua klien yang memilihnya
+    uint32_t us = 0;
+    for (uint8_t id = 0; id < AUDIO_CODEC_MAX; id++) {
+      const audio_codec_t *codec = audio_codec_get(id);
+      size_t data_len = audio_frame_data_len(id, (uint16_t)n32);
+      if (id == AUDIO_CODEC_PCM16 || !(codecs & (1 << id)) || !codec ||
+          sizeof(audio_header_t) + data_len > sizeof(audio_enc_msg)) {
+        continue;
+      }
+      if (!(prev_codecs & (1 << id))) {
+        codec->reset(&g_codec_state[id]);  // klien pertama codec ini
+      }
+      audio_header_init((audio_header_t*)audio_enc_msg, id, seq, I2S_SAMPLE_RATE,
+                        (uint16_t)n32, (uint8_t)shift, capture_us);
+      int64_t t0 = esp_timer_get_time();
+      codec->encode(&g_codec_state[id], out16, (uint16_t)n32, audio_enc_msg + sizeof(audio_header_t));
+      us += (uint32_t)(esp_timer_get_time() - t0);
+      ws_session_send_audio(id, audio_enc_msg, sizeof(audio_header_t), sizeof(audio_header_t) + data_len);
+    }
+    if (codecs & ~(1 << AUDIO_CODEC_PCM16)) {
+      enc_us = us;
+      cam_metrics_stage(CAM_STAGE_AUDIO_ENCODE, enc_us);
+    }
+    prev_codecs = codecs;
     taskYIELD();
   }
 }
@@ -297,7 +366,6 @@ void setup() {
   // Video via addon (port 80)
   if (CAM_initCamera()) {
     if (CAM_startOwnServer(80)) {
-      Serial.printf("[CAM] own HTTP server on :80, endpoints: /tm, /stream\n");
       Serial.printf("[CAM] Stream URL: http://%s/stream\n",
                     WiFi.localIP().toString().c_str());
     } else {
@@ -317,7 +385,11 @@ void setup() {
 // -------------------------------
 // LOOP
 void loop() {
-  // WS handling harus dipanggil rutin
+  // WS handling harus dipanggil rutin; WebSocketsServer tidak thread-safe,
+  // jadi loop() (heartbeat, tutup klien) memegang lock yang sama dengan
+  // send audio/video dari task lain (ws_session.h)
+  ws_session_lock();
   g_ws.loop();
+  ws_session_unlock();
   delay(1);
 }
\ No newline at end of file
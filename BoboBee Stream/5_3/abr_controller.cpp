@@ -0,0 +1,130 @@
+#include "abr_controller.h"
+
+#define ABR_ALPHA 0.2f
+
+static inline float ewma(float prev, float sample) {
+  return prev + ABR_ALPHA * (sample - prev);
+}
+
+static inline int clampi(int v, int lo, int hi) {
+  return v < lo ? lo : (v > hi ? hi : v);
+}
+
+void abr_default_config(abr_config_t *cfg) {
+  cfg->target_fps = 15.0f;
+  cfg->max_latency_ms = 300;
+  cfg->quality_best = 10;
+  cfg->quality_worst = 40;
+  cfg->quality_step = 4;
+  cfg->size_min = 0;
+  cfg->size_max = 0;
+  cfg->hold_frames = 10;
+}
+
+void abr_init(abr_state_t *st, const abr_config_t *cfg, int quality, int size) {
+  st->cfg = *cfg;
+  st->quality = clampi(quality, cfg->quality_best, cfg->quality_worst);
+  st->size = clampi(size, cfg->size_min, cfg->size_max);
+  st->send_ms = 0;
+  st->interval_ms = cfg->target_fps > 0 ? 1000.0f / cfg->target_fps : 0;
+  st->latency_ms = 0;
+  st->queue = 0;
+  st->last_us = 0;
+  st->since_change = 0;
+  st->good_streak = 0;
+  st->downgrades = 0;
+  st->upgrades = 0;
+}
+
+static int abr_downgrade(abr_state_t *st, int steps) {
+  const abr_config_t *c = &st->cfg;
+  if (st->quality < c->quality_worst) {
+    st->quality = clampi(st->quality + steps * c->quality_step, c->quality_best, c->quality_worst);
+    return ABR_SET_QUALITY;
+  }
+  if (st->size > c->size_min) {
+    // resolusi turun satu anak tangga (~1/2..1/4 byte), quality kembali ke tengah
+    st->size--;
+    st->quality = (c->quality_best + c->quality_worst) / 2;
+    return ABR_SET_QUALITY | ABR_SET_FRAMESIZE;
+  }
+  return 0;
+}
+
+static int abr_upgrade(abr_state_t *st, float budget_ms) {
+  const abr_config_t *c = &st->cfg;
+  if (st->quality > c->quality_best) {
+    int step = c->quality_step / 2 > 0 ? c->quality_step / 2 : 1;
+    st->quality = clampi(st->quality - step, c->quality_best, c->quality_worst);
+    return ABR_SET_QUALITY;
+  }
+  // naik resolusi hanya kalau headroom besar; frame berikutnya bisa 2-4x lebih besar
+  if (st->size < c->size_max && st->send_ms < 0.2f * budget_ms) {
+    st->size++;
+    st->quality = clampi(st->quality + 2 * c->quality_step, c->quality_best, c->quality_worst);
+    return ABR_SET_QUALITY | ABR_SET_FRAMESIZE;
+  }
+  return 0;
+}
+
+int abr_update(abr_state_t *st, int64_t now_us, uint32_t send_us, uint32_t latency_us, uint32_t dropped) {
+  const abr_config_t *c = &st->cfg;
+  float budget_ms = c->target_fps > 0 ? 1000.0f / c->target_fps : 1000.0f;
+
+  if (st->last_us) {
+    st->interval_ms = ewma(st->interval_ms, (now_us - st->last_us) / 1000.0f);
+  }
+  st->last_us = now_us;
+  st->send_ms = ewma(st->send_ms, send_us / 1000.0f);
+  st->latency_ms = ewma(st->latency_ms, latency_us / 1000.0f);
+  st->queue = ewma(st->queue, (float)dropped);
+  st->since_change++;
+
+  if (st->since_change < c->hold_frames) {
+    return 0;
+  }
+
+  // fps kurang karena link (waktu kirim dominan), bukan karena kamera lambat
+  bool link_bound = st->interval_ms > 1.25f * budget_ms && st->send_ms > 0.6f * st->interval_ms;
+  bool late = st->latency_ms > c->max_latency_ms;
+  bool slow_send = st->send_ms > 0.8f * budget_ms;
+
+  int action = 0;
+  if (link_bound || late || slow_send) {
+    st->good_streak = 0;
+    bool severe = st->send_ms > 1.5f * budget_ms || st->latency_ms > 2.0f * c->max_latency_ms;
+    action = abr_downgrade(st, severe ? 2 : 1);
+    if (action) {
+      st->downgrades++;
+    }
+  } else if (st->send_ms < 0.4f * budget_ms && st->latency_ms < 0.5f * c->max_latency_ms
+             && (st->interval_ms <= 1.1f * budget_ms || st->queue < 0.5f)) {
+    if (++st->good_streak >= 3 * c->hold_frames) {
+      st->good_streak = 0;
+      action = abr_upgrade(st, budget_ms);
+      if (action) {
+        st->upgrades++;
+      }
+    }
+  } else {
+    st->good_streak = 0;
+  }
+
+  if (action) {
+    st->since_change = 0;
+  }
+  return action;
+}
+
+int abr_slowest(const abr_state_t *st, const bool *active, int n) {
+  int worst = -1;
+  for (int i = 0; i < n; i++) {
+    if (!active[i]) {
+      continue;
+    }
+    if (worst < 0 || st[i].size < st[worst].size || (st[i].size == st[worst].size && st[i].quality > st[worst].quality)) {
+      worst = i;
+    }
+  }
+  return worst;
+}
@@ -0,0 +1,47 @@
+#pragma once
+// Adaptive bitrate untuk stream MJPEG (quality + framesize JPEG).
+//
+// Murni logika, tanpa header ESP: input per frame terkirim adalah waktu
+// kirim, latensi capture->terkirim dan jumlah frame yang di-drop sejak frame
+// sebelumnya (kedalaman antrean klien). Output: quality/framesize baru.
+// Turun cepat (step penuh, dobel kalau parah), naik pelan (setengah step
+// setelah beberapa periode sehat) supaya tidak osilasi.
+#include <stdint.h>
+
+typedef struct {
+  float target_fps;         // fps yang ingin dipertahankan
+  uint32_t max_latency_ms;  // batas latensi capture -> selesai kirim
+  int quality_best;         // quality JPEG terbaik (angka kecil = bagus)
+  int quality_worst;
+  int quality_step;
+  int size_min;             // indeks tangga framesize (0 = terkecil)
+  int size_max;
+  uint32_t hold_frames;     // jeda minimal antar perubahan
+} abr_config_t;
+
+typedef struct {
+  abr_config_t cfg;
+  int quality;
+  int size;
+  float send_ms;      // EWMA waktu kirim satu frame
+  float interval_ms;  // EWMA jarak antar frame terkirim
+  float latency_ms;   // EWMA capture -> terkirim
+  float queue;        // EWMA frame drop per frame terkirim
+  int64_t last_us;
+  uint32_t since_change;
+  uint32_t good_streak;
+  uint32_t downgrades;
+  uint32_t upgrades;
+} abr_state_t;
+
+#define ABR_SET_QUALITY   0x1
+#define ABR_SET_FRAMESIZE 0x2
+
+void abr_default_config(abr_config_t *cfg);
+void abr_init(abr_state_t *st, const abr_config_t *cfg, int quality, int size);
+// Return kombinasi ABR_SET_* (0 = tidak ada perubahan).
+int abr_update(abr_state_t *st, int64_t now_us, uint32_t send_us, uint32_t latency_us, uint32_t dropped);
+// Satu sensor, banyak klien: setelan mengikuti klien yang paling membatasi
+// (framesize terkecil, lalu quality terburuk). Return indeks di st[] atau -1
+// kalau tidak ada yang aktif.
+int abr_slowest(const abr_state_t *st, const bool *active, int n);
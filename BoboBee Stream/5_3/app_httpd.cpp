@@ -19,6 +19,18 @@
 #include "esp32-hal-ledc.h"
 #include "sdkconfig.h"
 #include "camera_index.h"
+#include "httpd_async.h"
+#include "cam_stream.h"
+#include "cam_abr.h"
+#include "frame_gate.h"
+#include "cam_clip.h"
+#include "cam_tensor.h"
+#include "cam_status.h"
+#include "cam_control.h"
+#include "cam_metrics.h"
+#include "cam_bmp.h"
+#include "esp_random.h"
+#include "esp_heap_caps.h"
 
 #if defined(ARDUINO_ARCH_ESP32) && defined(CONFIG_ARDUHAL_ESP_LOG)
 #include "esp32-hal-log.h"
@@ -35,6 +47,7 @@
 
 int led_duty = 0;
 bool isStreaming = false;
+static int stream_count = 0;  // stream aktif, isStreaming = stream_count > 0
 
 #endif
 
@@ -44,9 +57,6 @@ typedef struct {
 } jpg_chunking_t;
 
 #define PART_BOUNDARY "123456789000000000000987654321"
-static const char *_STREAM_CONTENT_TYPE = "multipart/x-mixed-replace;boundary=" PART_BOUNDARY;
-static const char *_STREAM_BOUNDARY = "\r\n--" PART_BOUNDARY "\r\n";
-static const char *_STREAM_PART = "Content-Type: image/jpeg\r\nContent-Length: %u\r\nX-Timestamp: %d.%06d\r\n\r\n";
 
 httpd_handle_t stream_httpd = NULL;
 httpd_handle_t camera_httpd = NULL;
@@ -104,45 +114,6 @@ void enable_led(bool en) {  // Turn LED On or Off
 }
 #endif
 
-static esp_err_t bmp_handler(httpd_req_t *req) {
-  camera_fb_t *fb = NULL;
-  esp_err_t res = ESP_OK;
-#if ARDUHAL_LOG_LEVEL >= ARDUHAL_LOG_LEVEL_INFO
-  uint64_t fr_start = esp_timer_get_time();
-#endif
-  fb = esp_camera_fb_get();
-  if (!fb) {
-    log_e("Camera capture failed");
-    httpd_resp_send_500(req);
-    return ESP_FAIL;
-  }
-
-  httpd_resp_set_type(req, "image/x-windows-bmp");
-  httpd_resp_set_hdr(req, "Content-Disposition", "inline; filename=capture.bmp");
-  httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
-
-  char ts[32];
-  snprintf(ts, 32, "%lld.%06ld", fb->timestamp.tv_sec, fb->timestamp.tv_usec);
-  httpd_resp_set_hdr(req, "X-Timestamp", (const char *)ts);
-
-  uint8_t *buf = NULL;
-  size_t buf_len = 0;
-  bool converted = frame2bmp(fb, &buf, &buf_len);
-  esp_camera_fb_return(fb);
-  if (!converted) {
-    log_e("BMP Conversion failed");
-    httpd_resp_send_500(req);
-    return ESP_FAIL;
-  }
-  res = httpd_resp_send(req, (const char *)buf, buf_len);
-  free(buf);
-#if ARDUHAL_LOG_LEVEL >= ARDUHAL_LOG_LEVEL_INFO
-  uint64_t fr_end = esp_timer_get_time();
-#endif
-  log_i("BMP: %llums, %uB", (uint64_t)((fr_end - fr_start) / 1000), buf_len);
-  return res;
-}
-
 static size_t jpg_encode_stream(void *arg, size_t index, const void *data, size_t len) {
   jpg_chunking_t *j = (jpg_chunking_t *)arg;
   if (!index) {
@@ -155,9 +126,44 @@ static size_t jpg_encode_stream(void *arg, size_t index, const void *data, size_
   return len;
 }
 
+// Optional numeric query argument, 0 when absent (e.g. /stream?gate=5)
+static uint32_t query_uint(httpd_req_t *req, const char *key) {
+  char query[64];
+  char value[12];
+  if (httpd_req_get_url_query_str(req, query, sizeof(query)) != ESP_OK || httpd_query_key_value(query, key, value, sizeof(value)) != ESP_OK) {
+    return 0;
+  }
+  return strtoul(value, NULL, 10);
+}
+
+// /capture?gate=1 tags each JPEG with a scene ETag so pollers can use If-None-Match
+static scene_detector_t *capture_scene = NULL;
+static uint32_t capture_boot_id = 0;
+
+static bool capture_scene_etag(camera_fb_t *fb, char *etag, size_t etag_len) {
+  if (fb->format != PIXFORMAT_JPEG) {
+    return false;
+  }
+  if (!capture_scene) {
+    capture_scene = (scene_detector_t *)heap_caps_malloc(sizeof(scene_detector_t), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!capture_scene) {
+      capture_scene = (scene_detector_t *)malloc(sizeof(scene_detector_t));
+    }
+    if (!capture_scene) {
+      return false;
+    }
+    scene_detector_init(capture_scene);
+    capture_boot_id = esp_random();  // scene ids restart at boot
+  }
+  scene_detector_update(capture_scene, fb->buf, fb->len, esp_timer_get_time());
+  snprintf(etag, etag_len, "\"%08lx-%lu\"", (unsigned long)capture_boot_id, (unsigned long)capture_scene->scene);
+  return true;
+}
+
 static esp_err_t capture_handler(httpd_req_t *req) {
   camera_fb_t *fb = NULL;
   esp_err_t res = ESP_OK;
+  char etag[24];
 #if ARDUHAL_LOG_LEVEL >= ARDUHAL_LOG_LEVEL_INFO
   int64_t fr_start = esp_timer_get_time();
 #endif
@@ -177,9 +183,21 @@ static esp_err_t capture_handler(httpd_req_t *req) {
     return ESP_FAIL;
   }
 
+  if (query_uint(req, "gate") && capture_scene_etag(fb, etag, sizeof(etag))) {
+    char if_none_match[24];
+    httpd_resp_set_hdr(req, "ETag", etag);
+    httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
+    if (httpd_req_get_hdr_value_str(req, "If-None-Match", if_none_match, sizeof(if_none_match)) == ESP_OK && strcmp(if_none_match, etag) == 0) {
+      esp_camera_fb_return(fb);
+      httpd_resp_set_status(req, "304 Not Modified");
+      return httpd_resp_send(req, NULL, 0);
+    }
+  } else {
+    httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
+  }
+
   httpd_resp_set_type(req, "image/jpeg");
   httpd_resp_set_hdr(req, "Content-Disposition", "inline; filename=capture.jpg");
-  httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
 
   char ts[32];
   snprintf(ts, 32, "%lld.%06ld", fb->timestamp.tv_sec, fb->timestamp.tv_usec);
@@ -209,96 +227,61 @@ static esp_err_t capture_handler(httpd_req_t *req) {
   return res;
 }
 
-static esp_err_t stream_handler(httpd_req_t *req) {
-  camera_fb_t *fb = NULL;
-  struct timeval _timestamp;
-  esp_err_t res = ESP_OK;
-  size_t _jpg_buf_len = 0;
-  uint8_t *_jpg_buf = NULL;
-  char *part_buf[128];
+// Policy /stream untuk cam_core::serve (cam_stream_core.h), loop yang sama
+// dengan /stream addon dan sketch root.
+struct StreamBoundary {
+  static constexpr const char *value = PART_BOUNDARY;
+};
 
-  static int64_t last_frame = 0;
-  if (!last_frame) {
-    last_frame = esp_timer_get_time();
-  }
-
-  res = httpd_resp_set_type(req, _STREAM_CONTENT_TYPE);
-  if (res != ESP_OK) {
-    return res;
-  }
-
-  httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
-  httpd_resp_set_hdr(req, "X-Framerate", "60");
+struct StreamHeaders {
+  static constexpr const char *value = "Access-Control-Allow-Origin: *\r\nX-Framerate: 60\r\n";
+};
 
 #if CONFIG_LED_ILLUMINATOR_ENABLED
-  isStreaming = true;
-  enable_led(true);
-#endif
-
-  while (true) {
-    fb = esp_camera_fb_get();
-    if (!fb) {
-      log_e("Camera capture failed");
-      res = ESP_FAIL;
-    } else {
-      _timestamp.tv_sec = fb->timestamp.tv_sec;
-      _timestamp.tv_usec = fb->timestamp.tv_usec;
-      if (fb->format != PIXFORMAT_JPEG) {
-        bool jpeg_converted = frame2jpg(fb, 80, &_jpg_buf, &_jpg_buf_len);
-        esp_camera_fb_return(fb);
-        fb = NULL;
-        if (!jpeg_converted) {
-          log_e("JPEG compression failed");
-          res = ESP_FAIL;
-        }
-      } else {
-        _jpg_buf_len = fb->len;
-        _jpg_buf = fb->buf;
-      }
-    }
-    if (res == ESP_OK) {
-      res = httpd_resp_send_chunk(req, _STREAM_BOUNDARY, strlen(_STREAM_BOUNDARY));
-    }
-    if (res == ESP_OK) {
-      size_t hlen = snprintf((char *)part_buf, 128, _STREAM_PART, _jpg_buf_len, _timestamp.tv_sec, _timestamp.tv_usec);
-      res = httpd_resp_send_chunk(req, (const char *)part_buf, hlen);
-    }
-    if (res == ESP_OK) {
-      res = httpd_resp_send_chunk(req, (const char *)_jpg_buf, _jpg_buf_len);
-    }
-    if (fb) {
-      esp_camera_fb_return(fb);
-      fb = NULL;
-      _jpg_buf = NULL;
-    } else if (_jpg_buf) {
-      free(_jpg_buf);
-      _jpg_buf = NULL;
+struct StreamLed {
+  static void stream_start() {
+    if (__atomic_add_fetch(&stream_count, 1, __ATOMIC_SEQ_CST) == 1) {
+      isStreaming = true;
+      enable_led(true);
     }
-    if (res != ESP_OK) {
-      log_e("Send frame failed");
-      break;
+  }
+  static void stream_stop() {
+    if (__atomic_sub_fetch(&stream_count, 1, __ATOMIC_SEQ_CST) == 0) {
+      isStreaming = false;
+      enable_led(false);
     }
-    int64_t fr_end = esp_timer_get_time();
-
-    int64_t frame_time = fr_end - last_frame;
-    last_frame = fr_end;
+  }
+};
+#endif
 
-    frame_time /= 1000;
 #if ARDUHAL_LOG_LEVEL >= ARDUHAL_LOG_LEVEL_INFO
+struct StreamLog {
+  static void frame_sent(size_t len, uint32_t frame_time) {
     uint32_t avg_frame_time = ra_filter_run(&ra_filter, frame_time);
-#endif
     log_i(
-      "MJPG: %uB %ums (%.1ffps), AVG: %ums (%.1ffps)", (uint32_t)(_jpg_buf_len), (uint32_t)frame_time, 1000.0 / (uint32_t)frame_time, avg_frame_time,
-      1000.0 / avg_frame_time
+      "MJPG: %uB %ums (%.1ffps), AVG: %ums (%.1ffps)", (uint32_t)(len), frame_time, 1000.0 / frame_time, avg_frame_time, 1000.0 / avg_frame_time
     );
   }
+};
+#endif
 
+struct StreamConfig : cam_core::Defaults {
+  using Boundary = StreamBoundary;
+  using Headers = StreamHeaders;
 #if CONFIG_LED_ILLUMINATOR_ENABLED
-  isStreaming = false;
-  enable_led(false);
+  using Led = StreamLed;
+#endif
+#if ARDUHAL_LOG_LEVEL >= ARDUHAL_LOG_LEVEL_INFO
+  using Log = StreamLog;
 #endif
+};
 
-  return res;
+static esp_err_t stream_handler(httpd_req_t *req) {
+  // pindah ke worker supaya task httpd tetap melayani URI lain
+  if (!httpd_async_is_worker()) {
+    return httpd_async_submit(req, stream_handler);
+  }
+  return cam_core::serve_bcast<StreamConfig>(req);
 }
 
 static esp_err_t parse_get(httpd_req_t *req, char **obuf) {
@@ -322,108 +305,24 @@ static esp_err_t parse_get(httpd_req_t *req, char **obuf) {
   return ESP_FAIL;
 }
 
-static esp_err_t cmd_handler(httpd_req_t *req) {
-  char *buf = NULL;
-  char variable[32];
-  char value[32];
-
-  if (parse_get(req, &buf) != ESP_OK) {
-    return ESP_FAIL;
-  }
-  if (httpd_query_key_value(buf, "var", variable, sizeof(variable)) != ESP_OK || httpd_query_key_value(buf, "val", value, sizeof(value)) != ESP_OK) {
-    free(buf);
-    httpd_resp_send_404(req);
-    return ESP_FAIL;
-  }
-  free(buf);
-
-  int val = atoi(value);
-  log_i("%s = %d", variable, val);
-  sensor_t *s = esp_camera_sensor_get();
-  int res = 0;
-
-  if (!strcmp(variable, "framesize")) {
-    if (s->pixformat == PIXFORMAT_JPEG) {
-      res = s->set_framesize(s, (framesize_t)val);
-    }
-  } else if (!strcmp(variable, "quality")) {
-    res = s->set_quality(s, val);
-  } else if (!strcmp(variable, "contrast")) {
-    res = s->set_contrast(s, val);
-  } else if (!strcmp(variable, "brightness")) {
-    res = s->set_brightness(s, val);
-  } else if (!strcmp(variable, "saturation")) {
-    res = s->set_saturation(s, val);
-  } else if (!strcmp(variable, "gainceiling")) {
-    res = s->set_gainceiling(s, (gainceiling_t)val);
-  } else if (!strcmp(variable, "colorbar")) {
-    res = s->set_colorbar(s, val);
-  } else if (!strcmp(variable, "awb")) {
-    res = s->set_whitebal(s, val);
-  } else if (!strcmp(variable, "agc")) {
-    res = s->set_gain_ctrl(s, val);
-  } else if (!strcmp(variable, "aec")) {
-    res = s->set_exposure_ctrl(s, val);
-  } else if (!strcmp(variable, "hmirror")) {
-    res = s->set_hmirror(s, val);
-  } else if (!strcmp(variable, "vflip")) {
-    res = s->set_vflip(s, val);
-  } else if (!strcmp(variable, "awb_gain")) {
-    res = s->set_awb_gain(s, val);
-  } else if (!strcmp(variable, "agc_gain")) {
-    res = s->set_agc_gain(s, val);
-  } else if (!strcmp(variable, "aec_value")) {
-    res = s->set_aec_value(s, val);
-  } else if (!strcmp(variable, "aec2")) {
-    res = s->set_aec2(s, val);
-  } else if (!strcmp(variable, "dcw")) {
-    res = s->set_dcw(s, val);
-  } else if (!strcmp(variable, "bpc")) {
-    res = s->set_bpc(s, val);
-  } else if (!strcmp(variable, "wpc")) {
-    res = s->set_wpc(s, val);
-  } else if (!strcmp(variable, "raw_gma")) {
-    res = s->set_raw_gma(s, val);
-  } else if (!strcmp(variable, "lenc")) {
-    res = s->set_lenc(s, val);
-  } else if (!strcmp(variable, "special_effect")) {
-    res = s->set_special_effect(s, val);
-  } else if (!strcmp(variable, "wb_mode")) {
-    res = s->set_wb_mode(s, val);
-  } else if (!strcmp(variable, "ae_level")) {
-    res = s->set_ae_level(s, val);
-  }
 #if CONFIG_LED_ILLUMINATOR_ENABLED
-  else if (!strcmp(variable, "led_intensity")) {
-    led_duty = val;
-    if (isStreaming) {
-      enable_led(true);
-    }
+// led_intensity dari batch /control (cam_control.h)
+static void control_set_led(int duty) {
+  led_duty = duty;
+  if (isStreaming) {
+    enable_led(true);
   }
-#endif
-  else {
-    log_i("Unknown command: %s", variable);
-    res = -1;
-  }
-
-  if (res < 0) {
-    return httpd_resp_send_500(req);
-  }
-
-  httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
-  return httpd_resp_send(req, NULL, 0);
 }
+#endif
 
 static int print_reg(char *p, sensor_t *s, uint16_t reg, uint32_t mask) {
-  return sprintf(p, "\"0x%x\":%u,", reg, s->get_reg(s, reg, mask));
+  return sprintf(p, "\"0x%x\":%u,", reg, cam_status_reg(s, reg, mask));
 }
 
-static esp_err_t status_handler(httpd_req_t *req) {
-  static char json_response[1024];
-
+// Bagian /status yang di-cache (cam_status.h): register + setting sensor.
+static int status_print_config(char *json) {
   sensor_t *s = esp_camera_sensor_get();
-  char *p = json_response;
-  *p++ = '{';
+  char *p = json;
 
   if (s->id.PID == OV5640_PID || s->id.PID == OV3660_PID) {
     for (int reg = 0x3400; reg < 0x3406; reg += 2) {
@@ -485,11 +384,15 @@ static esp_err_t status_handler(httpd_req_t *req) {
 #else
   p += sprintf(p, ",\"led_intensity\":%d", -1);
 #endif
-  *p++ = '}';
-  *p++ = 0;
-  httpd_resp_set_type(req, "application/json");
-  httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
-  return httpd_resp_send(req, json_response, strlen(json_response));
+  return p - json;
+}
+
+// Telemetri: disegarkan paling sering tiap CAM_STATUS_LIVE_MS.
+static int status_print_live(char *json) {
+  char *p = json;
+  p += cam_abr_print_status(p);
+  p += cam_clip_print_status(p);
+  return p - json;
 }
 
 static esp_err_t xclk_handler(httpd_req_t *req) {
@@ -514,6 +417,7 @@ static esp_err_t xclk_handler(httpd_req_t *req) {
   if (res) {
     return httpd_resp_send_500(req);
   }
+  cam_status_invalidate();
 
   httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
   return httpd_resp_send(req, NULL, 0);
@@ -546,6 +450,7 @@ static esp_err_t reg_handler(httpd_req_t *req) {
   if (res) {
     return httpd_resp_send_500(req);
   }
+  cam_status_reg_written(reg);
 
   httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
   return httpd_resp_send(req, NULL, 0);
@@ -612,6 +517,7 @@ static esp_err_t pll_handler(httpd_req_t *req) {
   if (res) {
     return httpd_resp_send_500(req);
   }
+  cam_status_invalidate();
 
   httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
   return httpd_resp_send(req, NULL, 0);
@@ -647,6 +553,7 @@ static esp_err_t win_handler(httpd_req_t *req) {
   if (res) {
     return httpd_resp_send_500(req);
   }
+  cam_status_invalidate();
 
   httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
   return httpd_resp_send(req, NULL, 0);
@@ -672,7 +579,9 @@ static esp_err_t index_handler(httpd_req_t *req) {
 
 void startCameraServer() {
   httpd_config_t config = HTTPD_DEFAULT_CONFIG();
-  config.max_uri_handlers = 16;
+  config.max_uri_handlers = 20;
+  // stream di worker async tetap memegang socket; sisakan slot untuk request biasa
+  config.max_open_sockets = HTTPD_ASYNC_WORKERS + 3;
 
   httpd_uri_t index_uri = {
     .uri = "/",
@@ -690,7 +599,7 @@ void startCameraServer() {
   httpd_uri_t status_uri = {
     .uri = "/status",
     .method = HTTP_GET,
-    .handler = status_handler,
+    .handler = cam_status_handler,
     .user_ctx = NULL
 #ifdef CONFIG_HTTPD_WS_SUPPORT
     ,
@@ -703,7 +612,20 @@ void startCameraServer() {
   httpd_uri_t cmd_uri = {
     .uri = "/control",
     .method = HTTP_GET,
-    .handler = cmd_handler,
+    .handler = cam_control_handler,
+    .user_ctx = NULL
+#ifdef CONFIG_HTTPD_WS_SUPPORT
+    ,
+    .is_websocket = true,
+    .handle_ws_control_frames = false,
+    .supported_subprotocol = NULL
+#endif
+  };
+
+  httpd_uri_t cmd_post_uri = {
+    .uri = "/control",
+    .method = HTTP_POST,
+    .handler = cam_control_handler,
     .user_ctx = NULL
 #ifdef CONFIG_HTTPD_WS_SUPPORT
     ,
@@ -742,7 +664,7 @@ void startCameraServer() {
   httpd_uri_t bmp_uri = {
     .uri = "/bmp",
     .method = HTTP_GET,
-    .handler = bmp_handler,
+    .handler = cam_bmp_handler,
     .user_ctx = NULL
 #ifdef CONFIG_HTTPD_WS_SUPPORT
     ,
@@ -817,15 +739,93 @@ void startCameraServer() {
 #endif
   };
 
+  httpd_uri_t clip_uri = {
+    .uri = "/clip",
+    .method = HTTP_GET,
+    .handler = cam_clip_handler,
+    .user_ctx = NULL
+#ifdef CONFIG_HTTPD_WS_SUPPORT
+    ,
+    .is_websocket = true,
+    .handle_ws_control_frames = false,
+    .supported_subprotocol = NULL
+#endif
+  };
+
+  httpd_uri_t trigger_uri = {
+    .uri = "/trigger",
+    .method = HTTP_GET,
+    .handler = cam_clip_trigger_handler,
+    .user_ctx = NULL
+#ifdef CONFIG_HTTPD_WS_SUPPORT
+    ,
+    .is_websocket = true,
+    .handle_ws_control_frames = false,
+    .supported_subprotocol = NULL
+#endif
+  };
+
+  httpd_uri_t tensor_uri = {
+    .uri = "/tensor",
+    .method = HTTP_GET,
+    .handler = cam_tensor_handler,
+    .user_ctx = NULL
+#ifdef CONFIG_HTTPD_WS_SUPPORT
+    ,
+    .is_websocket = true,
+    .handle_ws_control_frames = false,
+    .supported_subprotocol = NULL
+#endif
+  };
+  httpd_uri_t metrics_uri = {
+    .uri = "/metrics",
+    .method = HTTP_GET,
+    .handler = cam_metrics_handler,
+    .user_ctx = NULL
+#ifdef CONFIG_HTTPD_WS_SUPPORT
+    ,
+    .is_websocket = true,
+    .handle_ws_control_frames = false,
+    .supported_subprotocol = NULL
+#endif
+  };
+  httpd_uri_t clock_uri = {
+    .uri = "/clock",
+    .method = HTTP_GET,
+    .handler = cam_clock_handler,
+    .user_ctx = NULL
+#ifdef CONFIG_HTTPD_WS_SUPPORT
+    ,
+    .is_websocket = true,
+    .handle_ws_control_frames = false,
+    .supported_subprotocol = NULL
+#endif
+  };
+
   ra_filter_init(&ra_filter, 20);
+  cam_status_begin(status_print_config, status_print_live);
+#if CONFIG_LED_ILLUMINATOR_ENABLED
+  cam_control_begin(control_set_led);
+#else
+  cam_control_begin(NULL);
+#endif
+  httpd_async_start();
+  cam_clip_start();
 
   log_i("Starting web server on port: '%d'", config.server_port);
   if (httpd_start(&camera_httpd, &config) == ESP_OK) {
     httpd_register_uri_handler(camera_httpd, &index_uri);
     httpd_register_uri_handler(camera_httpd, &cmd_uri);
+    httpd_register_uri_handler(camera_httpd, &cmd_post_uri);
     httpd_register_uri_handler(camera_httpd, &status_uri);
     httpd_register_uri_handler(camera_httpd, &capture_uri);
     httpd_register_uri_handler(camera_httpd, &bmp_uri);
+    httpd_register_uri_handler(camera_httpd, &stream_uri);
+    httpd_register_uri_handler(camera_httpd, &clip_uri);
+    httpd_register_uri_handler(camera_httpd, &trigger_uri);
+    httpd_register_uri_handler(camera_httpd, &tensor_uri);
+    httpd_register_uri_handler(camera_httpd, &metrics_uri);
+    httpd_register_uri_handler(camera_httpd, &clock_uri);
 
     httpd_register_uri_handler(camera_httpd, &xclk_uri);
     httpd_register_uri_handler(camera_httpd, &reg_uri);
@@ -834,6 +834,7 @@ void startCameraServer() {
     httpd_register_uri_handler(camera_httpd, &win_uri);
   }
 
+  // port+1 tetap ada untuk halaman index bawaan yang membuka stream di :81
   config.server_port += 1;
   config.ctrl_port += 1;
   log_i("Starting stream server on port: '%d'", config.server_port);
@@ -0,0 +1,182 @@
+#include "audio_codec.h"
+#include <string.h>
+
+static_assert(AUDIO_CODEC_PCM16 < AUDIO_CODEC_MAX && AUDIO_CODEC_IMA_ADPCM < AUDIO_CODEC_MAX, "id codec harus < AUDIO_CODEC_MAX");
+static_assert(AUDIO_IMA_BLOCK_SAMPLES % 2 == 0, "blok IMA harus genap (2 sampel per byte)");
+
+// ---------- PCM16 ----------
+static void pcm16_reset(audio_codec_state_t *st) {
+  (void)st;
+}
+
+static size_t pcm16_encode(audio_codec_state_t *st, const int16_t *pcm, uint16_t samples, uint8_t *out) {
+  (void)st;
+  for (uint16_t i = 0; i < samples; i++) {
+    out[2 * i] = (uint8_t)pcm[i];
+    out[2 * i + 1] = (uint8_t)((uint16_t)pcm[i] >> 8);
+  }
+  return (size_t)samples * 2;
+}
+
+static int pcm16_decode(audio_codec_state_t *st, const uint8_t *data, size_t len, int16_t *pcm, uint16_t samples) {
+  (void)st;
+  if (len != (size_t)samples * 2) {
+    return -1;
+  }
+  for (uint16_t i = 0; i < samples; i++) {
+    pcm[i] = (int16_t)(data[2 * i] | data[2 * i + 1] << 8);
+  }
+  return samples;
+}
+
+// ---------- IMA-ADPCM ----------
+// Tabel standar IMA/DVI ADPCM (sama dengan WAV format 0x11).
+static const int16_t _ima_step[89] = {
+  7,     8,     9,     10,    11,    12,    13,    14,    16,    17,    19,    21,    23,    25,    28,
+  31,    34,    37,    41,    45,    50,    55,    60,    66,    73,    80,    88,    97,    107,   118,
+  130,   143,   157,   173,   190,   209,   230,   253,   279,   307,   337,   371,   408,   449,   494,
+  544,   598,   658,   724,   796,   876,   963,   1060,  1166,  1282,  1411,  1552,  1707,  1878,  2066,
+  2272,  2499,  2749,  3024,  3327,  3660,  4026,  4428,  4871,  5358,  5894,  6484,  7132,  7845,  8630,
+  9493,  10442, 11487, 12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767,
+};
+
+static const int8_t _ima_index[16] = {-1, -1, -1, -1, 2, 4, 6, 8, -1, -1, -1, -1, 2, 4, 6, 8};
+
+static inline int ima_clamp_index(int index) {
+  return index < 0 ? 0 : index > 88 ? 88 : index;
+}
+
+static inline int ima_clamp_sample(int v) {
+  return v < -32768 ? -32768 : v > 32767 ? 32767 : v;
+}
+
+// Satu sampel; predictor/index diperbarui persis seperti decoder.
+static inline uint8_t ima_encode_sample(int *predictor, int *index, int sample) {
+  int step = _ima_step[*index];
+  int diff = sample - *predictor;
+  uint8_t code = 0;
+  if (diff < 0) {
+    code = 8;
+    diff = -diff;
+  }
+  int delta = step >> 3;
+  if (diff >= step) {
+    code |= 4;
+    diff -= step;
+    delta += step;
+  }
+  step >>= 1;
+  if (diff >= step) {
+    code |= 2;
+    diff -= step;
+    delta += step;
+  }
+  step >>= 1;
+  if (diff >= step) {
+    code |= 1;
+    delta += step;
+  }
+  *predictor = ima_clamp_sample(code & 8 ? *predictor - delta : *predictor + delta);
+  *index = ima_clamp_index(*index + _ima_index[code]);
+  return code;
+}
+
+static inline int ima_decode_sample(int *predictor, int *index, uint8_t code) {
+  int step = _ima_step[*index];
+  int delta = step >> 3;
+  if (code & 4) {
+    delta += step;
+  }
+  if (code & 2) {
+    delta += step >> 1;
+  }
+  if (code & 1) {
+    delta += step >> 2;
+  }
+  *predictor = ima_clamp_sample(code & 8 ? *predictor - delta : *predictor + delta);
+  *index = ima_clamp_index(*index + _ima_index[code]);
+  return *predictor;
+}
+
+static void ima_reset(audio_codec_state_t *st) {
+  st->ima.predictor = 0;
+  st->ima.index = 0;
+}
+
+static size_t ima_encode(audio_codec_state_t *st, const int16_t *pcm, uint16_t samples, uint8_t *out) {
+  int predictor = st->ima.predictor, index = st->ima.index;
+  uint8_t *p = out;
+  for (uint16_t done = 0; done < samples;) {
+    uint16_t n = samples - done < AUDIO_IMA_BLOCK_SAMPLES ? samples - done : AUDIO_IMA_BLOCK_SAMPLES;
+    p[0] = (uint8_t)predictor;
+    p[1] = (uint8_t)((uint16_t)predictor >> 8);
+    p[2] = (uint8_t)index;
+    p[3] = 0;
+    p += AUDIO_IMA_BLOCK_HEADER;
+    const int16_t *s = pcm + done;
+    uint16_t i = 0;
+    for (; i + 1 < n; i += 2) {
+      uint8_t lo = ima_encode_sample(&predictor, &index, s[i]);
+      uint8_t hi = ima_encode_sample(&predictor, &index, s[i + 1]);
+      *p++ = (uint8_t)(lo | hi << 4);
+    }
+    if (i < n) {
+      *p++ = ima_encode_sample(&predictor, &index, s[i]);
+    }
+    done += n;
+  }
+  st->ima.predictor = (int16_t)predictor;
+  st->ima.index = (uint8_t)index;
+  return (size_t)(p - out);
+}
+
+static int ima_decode(audio_codec_state_t *st, const uint8_t *data, size_t len, int16_t *pcm, uint16_t samples) {
+  (void)st;  // tiap blok membawa keadaannya sendiri
+  if (len != audio_frame_data_len(AUDIO_CODEC_IMA_ADPCM, samples)) {
+    return -1;
+  }
+  const uint8_t *p = data;
+  for (uint16_t done = 0; done < samples;) {
+    uint16_t n = samples - done < AUDIO_IMA_BLOCK_SAMPLES ? samples - done : AUDIO_IMA_BLOCK_SAMPLES;
+    int predictor = (int16_t)(p[0] | p[1] << 8);
+    int index = p[2];
+    if (index > 88) {
+      return -1;
+    }
+    p += AUDIO_IMA_BLOCK_HEADER;
+    int16_t *s = pcm + done;
+    for (uint16_t i = 0; i < n; i += 2) {
+      uint8_t b = *p++;
+      s[i] = (int16_t)ima_decode_sample(&predictor, &index, b & 0x0F);
+      if (i + 1 < n) {
+        s[i + 1] = (int16_t)ima_decode_sample(&predictor, &index, b >> 4);
+      }
+    }
+    done += n;
+  }
+  return samples;
+}
+
+// ---------- registry ----------
+static const audio_codec_t _codecs[] = {
+  {AUDIO_CODEC_PCM16, "pcm16", pcm16_reset, pcm16_encode, pcm16_decode},
+  {AUDIO_CODEC_IMA_ADPCM, "adpcm", ima_reset, ima_encode, ima_decode},
+};
+
+const audio_codec_t *audio_codec_get(uint8_t id) {
+  for (size_t i = 0; i < sizeof(_codecs) / sizeof(_codecs[0]); i++) {
+    if (_codecs[i].id == id) {
+      return &_codecs[i];
+    }
+  }
+  return NULL;
+}
+
+const audio_codec_t *audio_codec_find(const char *name) {
+  for (size_t i = 0; i < sizeof(_codecs) / sizeof(_codecs[0]); i++) {
+    if (strcmp(_codecs[i].name, name) == 0) {
+      return &_codecs[i];
+    }
+  }
+  return NULL;
+}
@@ -0,0 +1,49 @@
+#pragma once
+// Codec audio WebSocket :81, dipilih per klien ("format" di subscribe,
+// lihat ws_session.h). Id codec = field codec audio_header_t.
+//
+// PCM16 mentah 16 kHz = 32 KB/s per klien, dikali jumlah klien di Wi-Fi
+// yang sama dengan MJPEG. IMA-ADPCM memakai 4 bit/sampel: blok 1024 sampel
+// = 516 byte (4 byte header + 512), ~3.97:1 dibanding PCM16.
+//
+// Format data IMA-ADPCM (AUDIO_CODEC_IMA_ADPCM): blok-blok
+// AUDIO_IMA_BLOCK_SAMPLES sampel, masing-masing
+//   predictor i16 LE | step index u8 (0..88) | cadangan u8 (0)
+//   lalu 2 sampel per byte, sampel genap di nibble bawah
+// Header blok adalah keadaan encoder *sebelum* sampel pertama blok, jadi
+// tiap blok (dan tiap pesan) bisa didecode sendiri: pesan yang hilang
+// tidak merusak pesan berikutnya.
+//
+// Encoder dijalankan sekali per blok I2S per codec yang dipakai, bukan
+// per klien. Codec baru (mis. Opus) cukup menambah entri di audio_codec.cpp,
+// id di audio_frame.h dan panjang datanya di audio_frame_data_len().
+//
+// Murni logika, tanpa header ESP, supaya bisa dites di host
+// (tools/audio_codec_bench.cpp).
+#include <stdint.h>
+#include <stddef.h>
+#include "audio_frame.h"
+
+// id codec < AUDIO_CODEC_MAX, supaya himpunan codec muat di bitmask uint8_t
+#define AUDIO_CODEC_MAX 8
+
+// Keadaan encoder/decoder; codec yang butuh keadaan lain menambah anggota.
+typedef union {
+  struct {
+    int16_t predictor;
+    uint8_t index;
+  } ima;
+} audio_codec_state_t;
+
+typedef struct {
+  uint8_t id;        // AUDIO_CODEC_*
+  const char *name;  // nilai "format" di subscribe
+  void (*reset)(audio_codec_state_t *st);
+  // Tulis tepat audio_frame_data_len(id, samples) byte ke out; return panjangnya.
+  size_t (*encode)(audio_codec_state_t *st, const int16_t *pcm, uint16_t samples, uint8_t *out);
+  // Return jumlah sampel yang ditulis ke pcm, -1 kalau data rusak.
+  int (*decode)(audio_codec_state_t *st, const uint8_t *data, size_t len, int16_t *pcm, uint16_t samples);
+} audio_codec_t;
+
+const audio_codec_t *audio_codec_get(uint8_t id);         // NULL = tidak dikenal
+const audio_codec_t *audio_codec_find(const char *name);  // NULL = tidak dikenal
@@ -0,0 +1,101 @@
+#include "audio_frame.h"
+#include <string.h>
+
+static_assert(sizeof(audio_header_t) == 24, "audio_header_t harus 24 byte");
+
+// seq mundur lebih dari ini dianggap perangkat mulai ulang, bukan terlambat
+#define AUDIO_RX_LATE_WINDOW 64
+
+static uint16_t rd16(const uint8_t *p) {
+  return (uint16_t)(p[0] | p[1] << 8);
+}
+
+static uint32_t rd32(const uint8_t *p) {
+  return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+void audio_header_init(audio_header_t *h, uint8_t codec, uint32_t seq, uint16_t sample_rate, uint16_t samples,
+                       uint8_t gain_shift, int64_t capture_us) {
+  memcpy(h->magic, AUDIO_FRAME_MAGIC, 4);
+  h->header_len = sizeof(audio_header_t);
+  h->codec = codec;
+  h->gain_shift = gain_shift;
+  h->seq = seq;
+  h->sample_rate = sample_rate;
+  h->samples = samples;
+  h->capture_us = capture_us;
+}
+
+size_t audio_frame_data_len(uint8_t codec, uint16_t samples) {
+  switch (codec) {
+    case AUDIO_CODEC_PCM16: return (size_t)samples * 2;
+    case AUDIO_CODEC_IMA_ADPCM: {
+      // tiap blok: header + 2 sampel per byte (nibble terakhir blok ganjil diisi 0)
+      size_t full = samples / AUDIO_IMA_BLOCK_SAMPLES, rest = samples % AUDIO_IMA_BLOCK_SAMPLES;
+      return full * (AUDIO_IMA_BLOCK_HEADER + AUDIO_IMA_BLOCK_SAMPLES / 2) +
+             (rest ? AUDIO_IMA_BLOCK_HEADER + (rest + 1) / 2 : 0);
+    }
+  }
+  return 0;
+}
+
+int audio_frame_parse(const uint8_t *msg, size_t len, audio_frame_t *out) {
+  if (len < sizeof(audio_header_t)) {
+    return AUDIO_FRAME_SHORT;
+  }
+  if (memcmp(msg, AUDIO_FRAME_MAGIC, 4) != 0) {
+    return AUDIO_FRAME_BAD_MAGIC;
+  }
+  // header_len boleh lebih besar di versi berikutnya: field baru dilewati
+  uint16_t header_len = rd16(msg + 4);
+  if (header_len < sizeof(audio_header_t) || header_len > len) {
+    return AUDIO_FRAME_BAD_HEADER;
+  }
+  out->codec = msg[6];
+  out->gain_shift = msg[7];
+  out->seq = rd32(msg + 8);
+  out->sample_rate = rd16(msg + 12);
+  out->samples = rd16(msg + 14);
+  out->capture_us = (int64_t)((uint64_t)rd32(msg + 16) | (uint64_t)rd32(msg + 20) << 32);
+  out->data = msg + header_len;
+  out->data_len = len - header_len;
+  size_t want = audio_frame_data_len(out->codec, out->samples);
+  if (want && want != out->data_len) {
+    return AUDIO_FRAME_BAD_LENGTH;
+  }
+  return AUDIO_FRAME_OK;
+}
+
+void audio_rx_init(audio_rx_t *rx) {
+  memset(rx, 0, sizeof(*rx));
+}
+
+uint32_t audio_rx_update(audio_rx_t *rx, const audio_frame_t *f, int64_t arrival_us) {
+  rx->received++;
+  int64_t transit = arrival_us - f->capture_us;
+  if (!rx->started) {
+    rx->started = true;
+    rx->next_seq = f->seq + 1;
+    rx->last_transit_us = transit;
+    return 0;
+  }
+  uint32_t ahead = f->seq - rx->next_seq;  // modulo 2^32
+  uint32_t lost = 0;
+  if (ahead < 0x80000000u) {
+    lost = ahead;
+    rx->lost += lost;
+  } else if (rx->next_seq - f->seq <= AUDIO_RX_LATE_WINDOW) {
+    rx->late++;
+    return 0;  // next_seq dan jitter tetap mengikuti urutan normal
+  } else {
+    rx->restarts++;
+    rx->next_seq = f->seq + 1;
+    rx->last_transit_us = transit;
+    return 0;
+  }
+  rx->next_seq = f->seq + 1;
+  int64_t d = transit - rx->last_transit_us;
+  rx->last_transit_us = transit;
+  rx->jitter_us += ((double)(d < 0 ? -d : d) - rx->jitter_us) / 16.0;
+  return lost;
+}
@@ -0,0 +1,82 @@
+#pragma once
+// Header biner pesan audio WebSocket :81 + parser/statistik penerima.
+//
+// Tiap blok I2S dikirim sebagai audio_header_t diikuti sampel. Dengan seq
+// klien tahu blok yang hilang (bukan sekadar menebak dari jeda waktu),
+// capture_us menyelaraskan audio dengan X-Timestamp /stream (jam yang sama,
+// lihat /clock), dan sample_rate + samples cukup untuk mengukur jitter
+// buffer tanpa heuristik ukuran pesan.
+//
+// Header hanya untuk klien yang memintanya ("header":true di subscribe,
+// lihat ws_session.h) atau memilih codec selain PCM16 ("format", lihat
+// audio_codec.h); klien lama tetap menerima PCM16 polos.
+//
+// Murni logika, tanpa header ESP, supaya bisa dipakai dan dites di host
+// (tools/audio_frame_check.cpp, tools/load_gen.cpp).
+#include <stdint.h>
+#include <stddef.h>
+
+#define AUDIO_FRAME_MAGIC "AUD1"
+
+#define AUDIO_CODEC_PCM16 0      // int16 little-endian, mono
+#define AUDIO_CODEC_IMA_ADPCM 1  // 4 bit/sampel per blok AUDIO_IMA_BLOCK_SAMPLES (audio_codec.h)
+
+// Sampel per blok IMA-ADPCM = AUDIO_BUF_32_COUNT di 5_3.ino, jadi satu
+// baca I2S selalu jadi blok utuh (blok terakhir boleh lebih pendek).
+#define AUDIO_IMA_BLOCK_SAMPLES 1024
+#define AUDIO_IMA_BLOCK_HEADER 4  // predictor i16, step index u8, cadangan u8
+
+// Header wire 24 byte (little-endian) di depan setiap blok audio.
+typedef struct __attribute__((packed)) {
+  char magic[4];          // "AUD1"
+  uint16_t header_len;    // sizeof(audio_header_t); data mulai di offset ini
+  uint8_t codec;          // AUDIO_CODEC_*
+  uint8_t gain_shift;     // shift 32->16 yang dipakai blok ini (auto-gain)
+  uint32_t seq;           // naik 1 per blok I2S; lompat = blok hilang
+  uint16_t sample_rate;   // Hz
+  uint16_t samples;       // sampel mono dalam blok
+  int64_t capture_us;     // sampel pertama, jam esp_timer (sama dengan X-Timestamp)
+} audio_header_t;
+
+enum {
+  AUDIO_FRAME_OK = 0,
+  AUDIO_FRAME_SHORT = -1,       // lebih pendek dari header
+  AUDIO_FRAME_BAD_MAGIC = -2,   // bukan "AUD1" (mis. PCM16 polos klien lama)
+  AUDIO_FRAME_BAD_HEADER = -3,  // header_len < 24 atau melebihi pesan
+  AUDIO_FRAME_BAD_LENGTH = -4,  // panjang data tidak cocok dengan samples
+};
+
+// Hasil parse; data menunjuk ke dalam pesan.
+typedef struct {
+  uint8_t codec;
+  uint8_t gain_shift;
+  uint32_t seq;
+  uint16_t sample_rate;
+  uint16_t samples;
+  int64_t capture_us;
+  const uint8_t *data;
+  size_t data_len;
+} audio_frame_t;
+
+// Statistik penerima: hilang/terlambat dari seq, jitter dari capture_us.
+typedef struct {
+  bool started;
+  uint32_t next_seq;
+  uint64_t received;
+  uint64_t lost;        // blok yang dilewati seq (termasuk yang nanti datang terlambat)
+  uint64_t late;        // seq mundur sedikit: datang terlambat / duplikat
+  uint64_t restarts;    // seq mundur jauh: perangkat reboot
+  int64_t last_transit_us;
+  double jitter_us;     // RFC 3550 interarrival jitter (filter 1/16)
+} audio_rx_t;
+
+void audio_header_init(audio_header_t *h, uint8_t codec, uint32_t seq, uint16_t sample_rate, uint16_t samples,
+                       uint8_t gain_shift, int64_t capture_us);
+int audio_frame_parse(const uint8_t *msg, size_t len, audio_frame_t *out);
+// Panjang data tepat untuk codec dan jumlah sampel; 0 = codec tidak dikenal.
+size_t audio_frame_data_len(uint8_t codec, uint16_t samples);
+
+void audio_rx_init(audio_rx_t *rx);
+// arrival_us: jam penerima (bebas offset). Return jumlah blok hilang tepat
+// sebelum blok ini.
+uint32_t audio_rx_update(audio_rx_t *rx, const audio_frame_t *f, int64_t arrival_us);
@@ -0,0 +1,39 @@
+#include "audio_pcm.h"
+
+static inline int32_t sat16(int32_t v) {
+  return v < -32768 ? -32768 : v > 32767 ? 32767 : v;
+}
+
+static inline int32_t peak_abs(int32_t mx, int32_t mn) {
+  int32_t neg = mn == INT32_MIN ? INT32_MAX : -mn;
+  return mx > neg ? mx : neg;
+}
+
+bool audio_gain_init(audio_gain_t *g, float gain) {
+  if (!(gain > 0.0f) || gain >= 32768.0f) {
+    return false;
+  }
+  // mantissa sebesar mungkin (presisi) tanpa melewati 32767
+  for (int shift = 15; shift >= 0; shift--) {
+    long q = (long)(gain * (float)(1L << shift) + 0.5f);
+    if (q <= 32767) {
+      g->q15 = (int16_t)(q > 0 ? q : 1);
+      g->shift = (uint8_t)shift;
+      return true;
+    }
+  }
+  return false;
+}
+
+int32_t audio_pcm_convert(const int32_t *in, int16_t *out, size_t n, int shift, const audio_gain_t *g) {
+  int32_t mx = 0, mn = 0;
+  int32_t q = g->q15;
+  int k = g->shift;
+  for (size_t i = 0; i < n; i++) {
+    int32_t v = in[i];
+    mx = v > mx ? v : mx;
+    mn = v < mn ? v : mn;
+    out[i] = (int16_t)sat16((sat16(v >> shift) * q) >> k);  // |s * q| <= 2^30
+  }
+  return peak_abs(mx, mn);
+}
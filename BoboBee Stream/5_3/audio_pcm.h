@@ -0,0 +1,28 @@
+#pragma once
+// Konversi blok I2S 32-bit -> PCM16 dalam satu lintasan, fixed point:
+// lacak puncak |x| (untuk auto-shift), geser, saturasi 16 bit, gain Q15,
+// saturasi lagi. Menggantikan dua lintasan lama di audioTask (cari
+// maxAbs32, lalu geser + kali float SOFTWARE_GAIN + clamp).
+//
+//   out[i] = sat16((sat16(in[i] >> shift) * gain.q15) >> gain.shift)
+//   return   max |in[i]| (INT32_MIN dihitung INT32_MAX)
+//
+// Untuk gain bulat (SOFTWARE_GAIN 3.0 = 24576 >> 13) hasilnya sama persis
+// dengan jalur float lama selama in >> shift muat 16 bit; di luar itu
+// nilai disaturasi, bukan terbungkus. Gain pecahan dibulatkan ke bawah,
+// bukan ke arah nol seperti cast float (beda maks 1 LSB).
+//
+// Murni logika, supaya bisa dites di host (tools/audio_pcm_bench.cpp).
+#include <stdint.h>
+#include <stddef.h>
+
+// gain = q15 / 2^shift (q15 < 32768), mis. 3.0 = 24576 / 2^13
+typedef struct {
+  int16_t q15;
+  uint8_t shift;
+} audio_gain_t;
+
+// false kalau gain di luar (0, 32768); g tidak diubah.
+bool audio_gain_init(audio_gain_t *g, float gain);
+
+int32_t audio_pcm_convert(const int32_t *in, int16_t *out, size_t n, int shift, const audio_gain_t *g);
@@ -0,0 +1,231 @@
+#include "bmp_stream.h"
+#include <string.h>
+
+static inline uint8_t *put32(uint8_t *p, uint32_t v) {
+  p[0] = v;
+  p[1] = v >> 8;
+  p[2] = v >> 16;
+  p[3] = v >> 24;
+  return p + 4;
+}
+
+static inline uint8_t *put16(uint8_t *p, uint16_t v) {
+  p[0] = v;
+  p[1] = v >> 8;
+  return p + 2;
+}
+
+void bmp_stream_init(bmp_stream_t *s, bmp_write_t write, void *write_arg) {
+  memset(s, 0, sizeof(*s));
+  s->write = write;
+  s->write_arg = write_arg;
+}
+
+size_t bmp_file_size(uint16_t width, uint16_t height, uint8_t bpp) {
+  return (size_t)width * height * bpp + BMP_HEADER_LEN + (bpp == 1 ? BMP_PALETTE_LEN : 0);
+}
+
+size_t bmp_band_bytes(uint16_t width, uint8_t rows) {
+  return (size_t)width * rows * 3;
+}
+
+uint8_t bmp_jpeg_mcu_rows(const uint8_t *jpg, size_t len) {
+  if (len < 4 || jpg[0] != 0xFF || jpg[1] != 0xD8) {
+    return 0;
+  }
+  size_t i = 2;
+  while (i + 4 <= len) {
+    if (jpg[i] != 0xFF) {
+      return 0;
+    }
+    uint8_t m = jpg[i + 1];
+    if (m == 0xFF) {  // byte pengisi
+      i++;
+      continue;
+    }
+    if (m == 0x01 || (m >= 0xD0 && m <= 0xD7)) {  // marker tanpa panjang
+      i += 2;
+      continue;
+    }
+    size_t seg = ((size_t)jpg[i + 2] << 8) | jpg[i + 3];
+    if (m == 0xDA || seg < 2 || i + 2 + seg > len) {
+      return 0;
+    }
+    // SOF0..SOF15 kecuali DHT (C4), JPG (C8), DAC (CC)
+    if (m >= 0xC0 && m <= 0xCF && m != 0xC4 && m != 0xC8 && m != 0xCC) {
+      const uint8_t *p = jpg + i + 4;  // P, Y, X, Nf, lalu 3 byte per komponen
+      if (seg < 8 || seg < 8 + 3 * (size_t)p[5]) {
+        return 0;
+      }
+      uint8_t vmax = 1;
+      for (int c = 0; c < p[5]; c++) {
+        uint8_t v = p[6 + c * 3 + 1] & 0x0F;
+        vmax = v > vmax ? v : vmax;
+      }
+      return vmax <= 2 ? vmax * 8 : 0;  // tjpgd hanya sampai 16 baris
+    }
+    i += 2 + seg;
+  }
+  return 0;
+}
+
+// Tata letak bmp_header_t to_bmp.c (little-endian, tanpa padding).
+void bmp_format_header(uint8_t out[BMP_HEADER_LEN], uint16_t width, uint16_t height, uint8_t bpp) {
+  size_t palette = bpp == 1 ? BMP_PALETTE_LEN : 0;
+  uint8_t *p = out;
+  *p++ = 'B';
+  *p++ = 'M';
+  p = put32(p, bmp_file_size(width, height, bpp));
+  p = put32(p, 0);
+  p = put32(p, BMP_HEADER_LEN + palette);
+  p = put32(p, 40);
+  p = put32(p, width);
+  p = put32(p, (uint32_t)-(int32_t)height);  // negatif = top-down
+  p = put16(p, 1);
+  p = put16(p, bpp * 8);
+  p = put32(p, 0);
+  p = put32(p, (uint32_t)width * height * bpp);
+  p = put32(p, 0x0B13);  // 2835 px/m = 72 DPI
+  p = put32(p, 0x0B13);
+  p = put32(p, 0);
+  put32(p, 0);
+}
+
+static bool stream_flush(bmp_stream_t *s) {
+  if (s->fill && !s->failed) {
+    s->failed = !s->write(s->write_arg, s->scratch, s->fill);
+    s->sent += s->fill;
+  }
+  s->fill = 0;
+  return !s->failed;
+}
+
+static bool stream_put(bmp_stream_t *s, const uint8_t *data, size_t len) {
+  while (len) {
+    size_t n = BMP_STREAM_CHUNK - s->fill;
+    if (n > len) {
+      n = len;
+    }
+    memcpy(s->scratch + s->fill, data, n);
+    s->fill += n;
+    data += n;
+    len -= n;
+    if (s->fill == BMP_STREAM_CHUNK && !stream_flush(s)) {
+      return false;
+    }
+  }
+  return !s->failed;
+}
+
+static bool stream_header(bmp_stream_t *s, uint16_t width, uint16_t height, uint8_t bpp) {
+  s->width = width;
+  s->height = height;
+  s->total = bmp_file_size(width, height, bpp);
+  uint8_t hdr[BMP_HEADER_LEN];
+  bmp_format_header(hdr, width, height, bpp);
+  if (!stream_put(s, hdr, sizeof(hdr))) {
+    return false;
+  }
+  if (bpp == 1) {
+    for (int i = 0; i < 256; i++) {
+      uint8_t entry[4] = {(uint8_t)i, (uint8_t)i, (uint8_t)i, 0};
+      if (!stream_put(s, entry, sizeof(entry))) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+bool bmp_stream_raw(bmp_stream_t *s, const uint8_t *src, uint16_t width, uint16_t height, uint8_t src_bpp, bmp_convert_t conv,
+                    void *conv_arg) {
+  if (!conv && src_bpp != 1 && src_bpp != 3) {
+    return false;
+  }
+  if (!stream_header(s, width, height, conv ? 3 : src_bpp)) {
+    return false;
+  }
+  size_t pixels = (size_t)width * height;
+  if (!conv) {
+    return stream_put(s, src, pixels * src_bpp) && stream_flush(s) && s->sent == s->total;
+  }
+  while (pixels) {
+    size_t n = (BMP_STREAM_CHUNK - s->fill) / 3;
+    if (n < pixels) {
+      n &= ~(size_t)1;  // YUV422: U/V dipakai berpasangan
+    } else {
+      n = pixels;
+    }
+    if (n == 0) {
+      if (!stream_flush(s)) {
+        return false;
+      }
+      continue;
+    }
+    conv(conv_arg, src, n, s->scratch + s->fill);
+    s->fill += n * 3;
+    src += n * src_bpp;
+    pixels -= n;
+    if (s->fill + 6 > BMP_STREAM_CHUNK && !stream_flush(s)) {
+      return false;
+    }
+  }
+  return stream_flush(s) && s->sent == s->total;
+}
+
+// Salin baris band ke scratch sambil menukar RGB (decoder) -> BGR (BMP).
+static bool band_emit(bmp_stream_t *s, uint16_t rows) {
+  const uint8_t *p = s->band;
+  size_t bytes = (size_t)s->width * rows * 3;
+  while (bytes) {
+    size_t n = (BMP_STREAM_CHUNK - s->fill) / 3 * 3;
+    if (n > bytes) {
+      n = bytes;
+    }
+    uint8_t *o = s->scratch + s->fill;
+    for (size_t i = 0; i < n; i += 3) {
+      o[i] = p[i + 2];
+      o[i + 1] = p[i + 1];
+      o[i + 2] = p[i];
+    }
+    s->fill += n;
+    p += n;
+    bytes -= n;
+    if (s->fill + 3 > BMP_STREAM_CHUNK && !stream_flush(s)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool bmp_jpeg_write(void *arg, uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint8_t *data) {
+  bmp_stream_t *s = (bmp_stream_t *)arg;
+  if (s->failed) {
+    return false;
+  }
+  uint8_t rows = s->band_rows ? s->band_rows : BMP_BAND_ROWS;
+  if (!data) {
+    if (x == 0 && y == 0) {
+      if (!s->band || bmp_band_bytes(w, rows) > s->band_cap) {
+        s->failed = true;
+        return false;
+      }
+      return stream_header(s, w, h, 3);
+    }
+    return stream_flush(s) && s->sent == s->total;
+  }
+  // blok MCU datang kiri -> kanan, atas -> bawah; satu band = satu baris MCU
+  size_t row_bytes = (size_t)s->width * 3;
+  size_t done_rows = (s->sent + s->fill - BMP_HEADER_LEN) / row_bytes;
+  if (h > rows || x + w > s->width || y != done_rows || y + h > s->height) {
+    s->failed = true;
+    return false;
+  }
+  for (uint16_t r = 0; r < h; r++) {
+    memcpy(s->band + r * row_bytes + (size_t)x * 3, data + (size_t)r * w * 3, (size_t)w * 3);
+  }
+  if (x + w == s->width) {
+    return band_emit(s, h);
+  }
+  return true;
+}
@@ -0,0 +1,78 @@
+#pragma once
+// Encoder BMP streaming untuk /bmp: header lalu piksel dikirim per potongan
+// dari scratch tetap, tanpa salinan BMP satu frame penuh di heap.
+//
+// Output byte-identik dengan frame2bmp() esp32-camera: header 54 byte,
+// tinggi negatif (baris top-down, urutan sama dengan buffer sumber), baris
+// tanpa padding, BGR888; grayscale 8 bit dengan palette 256 entri.
+//   - sumber mentah (RGB565, YUV422, RGB888, gray): konversi per potongan
+//     BMP_STREAM_CHUNK byte, memori konstan berapa pun resolusinya.
+//   - sumber JPEG: bmp_jpeg_write() dipasang sebagai writer esp_jpg_decode();
+//     blok MCU dikumpulkan di band setinggi satu baris MCU lalu dikirim
+//     begitu baris itu lengkap. Band = lebar x tinggi MCU x 3 byte: 8 baris
+//     untuk JPEG 4:2:2/4:4:4 dari sensor (UXGA 37.5 KB), 16 untuk 4:2:0
+//     (UXGA 75 KB), bukan 5.7 MB. Tidak bergantung tinggi frame, tapi tetap
+//     sebanding lebar: baris BMP harus utuh sebelum baris berikutnya,
+//     sedangkan tjpgd mengirim blok per MCU. Batas kerasnya BMP_BAND_MAX.
+//
+// Murni logika, tanpa header ESP, supaya bisa dites di host
+// (tools/bmp_check.cpp).
+#include <stdint.h>
+#include <stddef.h>
+
+#define BMP_HEADER_LEN  54
+#define BMP_PALETTE_LEN (256 * 4)
+#define BMP_BAND_ROWS   16  // tinggi MCU JPEG maksimum (4:2:0)
+
+// Band JPEG terbesar yang boleh dialokasikan; frame yang butuh lebih
+// ditolak. Cukup untuk UXGA 4:2:0 dan lebar sampai 3413 pada 4:2:2.
+#ifndef BMP_BAND_MAX
+#define BMP_BAND_MAX (80 * 1024)
+#endif
+
+// Kelipatan 3 (piksel BGR) dan 4 (pasangan YUV422) supaya potongan tidak
+// memecah piksel.
+#ifndef BMP_STREAM_CHUNK
+#define BMP_STREAM_CHUNK 1536
+#endif
+
+// Kirim len byte; false = batal (klien putus).
+typedef bool (*bmp_write_t)(void *arg, const uint8_t *data, size_t len);
+// Ubah n piksel sumber ke BGR888, mis. pembungkus fmt2rgb888().
+typedef void (*bmp_convert_t)(void *arg, const uint8_t *src, size_t n, uint8_t *dst);
+
+typedef struct {
+  bmp_write_t write;
+  void *write_arg;
+  size_t total;      // ukuran file; terisi sebelum write pertama (Content-Length)
+  size_t sent;
+  size_t fill;
+  uint8_t scratch[BMP_STREAM_CHUNK];
+  // khusus JPEG: band RGB888 dari decoder, disediakan pemanggil
+  uint8_t *band;
+  size_t band_cap;
+  uint8_t band_rows;  // tinggi MCU (bmp_jpeg_mcu_rows); 0 = BMP_BAND_ROWS
+  uint16_t width;
+  uint16_t height;
+  bool failed;
+} bmp_stream_t;
+
+void bmp_stream_init(bmp_stream_t *s, bmp_write_t write, void *write_arg);
+// bpp 1 (gray + palette) atau 3.
+size_t bmp_file_size(uint16_t width, uint16_t height, uint8_t bpp);
+void bmp_format_header(uint8_t out[BMP_HEADER_LEN], uint16_t width, uint16_t height, uint8_t bpp);
+
+// Frame mentah src_bpp byte/piksel. conv NULL = salin apa adanya: src_bpp 1
+// jadi BMP 8 bit + palette, src_bpp 3 dianggap sudah BGR888.
+bool bmp_stream_raw(bmp_stream_t *s, const uint8_t *src, uint16_t width, uint16_t height, uint8_t src_bpp, bmp_convert_t conv,
+                    void *conv_arg);
+
+// Writer untuk esp_jpg_decode(JPG_SCALE_NONE), arg = bmp_stream_t* dengan
+// band >= bmp_band_bytes(lebar, band_rows). Panggilan awal (data NULL,
+// x = y = 0) mengirim header; s->failed / s->sent != s->total setelah
+// decode = gagal.
+bool bmp_jpeg_write(void *arg, uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint8_t *data);
+size_t bmp_band_bytes(uint16_t width, uint8_t rows);
+// Tinggi MCU dari SOF (8 x faktor sampling vertikal terbesar): 8 atau 16;
+// 0 kalau SOF tidak ditemukan sebelum SOS.
+uint8_t bmp_jpeg_mcu_rows(const uint8_t *jpg, size_t len);
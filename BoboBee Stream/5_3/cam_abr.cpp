@@ -0,0 +1,175 @@
+#include "cam_abr.h"
+#include <stdio.h>
+#include "esp_camera.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "abr_controller.h"
+#include "cam_broadcast.h"
+#include "cam_status.h"
+
+#if defined(ARDUINO_ARCH_ESP32) && defined(CONFIG_ARDUHAL_ESP_LOG)
+#include "esp32-hal-log.h"
+#endif
+
+// tangga framesize 4:3 yang boleh dipakai ABR (aspect ratio tetap untuk model pose)
+static const framesize_t _abr_ladder[] = {FRAMESIZE_QQVGA, FRAMESIZE_QVGA, FRAMESIZE_CIF, FRAMESIZE_VGA, FRAMESIZE_SVGA, FRAMESIZE_XGA, FRAMESIZE_UXGA};
+#define ABR_LADDER_LEN (int)(sizeof(_abr_ladder) / sizeof(_abr_ladder[0]))
+
+static portMUX_TYPE _abr_mux = portMUX_INITIALIZER_UNLOCKED;
+static abr_config_t _abr_cfg;
+static abr_state_t _abr[CAM_BCAST_MAX_CLIENTS];  // per slot broadcaster
+static bool _abr_active[CAM_BCAST_MAX_CLIENTS];
+static int _abr_quality;  // setelan yang terakhir diterapkan ke sensor
+static int _abr_level;
+static uint32_t _abr_downgrades = 0;
+static uint32_t _abr_upgrades = 0;
+static bool _abr_enabled = CAM_ABR_DEFAULT;
+static bool _abr_seeded = false;
+
+static int ladder_level(framesize_t fs) {
+  int level = 0;
+  for (int i = 0; i < ABR_LADDER_LEN; i++) {
+    if (_abr_ladder[i] <= fs) {
+      level = i;
+    }
+  }
+  return level;
+}
+
+void cam_abr_set_enabled(bool en) {
+  _abr_enabled = en;
+  if (en) {
+    cam_abr_reseed();
+  }
+}
+
+bool cam_abr_enabled(void) {
+  return _abr_enabled;
+}
+
+void cam_abr_reseed(void) {
+  sensor_t *s = esp_camera_sensor_get();
+  if (!s) {
+    return;
+  }
+  abr_config_t cfg;
+  abr_default_config(&cfg);
+  // setelan user jadi plafon; ABR hanya menurunkan lalu kembali ke sana
+  int level = ladder_level(s->status.framesize);
+  cfg.quality_best = s->status.quality;
+  if (cfg.quality_worst < cfg.quality_best) {
+    cfg.quality_worst = cfg.quality_best;
+  }
+  cfg.size_min = 0;
+  cfg.size_max = level;
+  portENTER_CRITICAL(&_abr_mux);
+  _abr_cfg = cfg;
+  _abr_quality = s->status.quality;
+  _abr_level = level;
+  for (int i = 0; i < CAM_BCAST_MAX_CLIENTS; i++) {
+    if (_abr_active[i]) {
+      abr_init(&_abr[i], &cfg, _abr_quality, _abr_level);
+    }
+  }
+  _abr_seeded = true;
+  portEXIT_CRITICAL(&_abr_mux);
+}
+
+// Jalan di task capture (cam_bcast_between_frames): terapkan setelan klien
+// yang paling lambat. Dibaca ulang di sini, bukan dari pemanggil, supaya
+// feed dari klien lain di antaranya tidak tertimpa setelan basi.
+static void abr_apply_job(void *) {
+  sensor_t *s = esp_camera_sensor_get();
+  if (!s) {
+    return;
+  }
+  portENTER_CRITICAL(&_abr_mux);
+  int i = abr_slowest(_abr, _abr_active, CAM_BCAST_MAX_CLIENTS);
+  int quality = i >= 0 ? _abr[i].quality : _abr_quality;
+  int level = i >= 0 ? _abr[i].size : _abr_level;
+  int old_quality = _abr_quality;
+  int old_level = _abr_level;
+  _abr_quality = quality;
+  _abr_level = level;
+  if (level < old_level || (level == old_level && quality > old_quality)) {
+    _abr_downgrades++;
+  } else if (level != old_level || quality != old_quality) {
+    _abr_upgrades++;
+  }
+  portEXIT_CRITICAL(&_abr_mux);
+
+  if (level == old_level && quality == old_quality) {
+    return;
+  }
+  if (level != old_level && s->pixformat == PIXFORMAT_JPEG) {
+    s->set_framesize(s, _abr_ladder[level]);
+  }
+  if (quality != old_quality) {
+    s->set_quality(s, quality);
+  }
+  cam_status_invalidate();
+  log_i("ABR: quality=%d framesize=%d", quality, (int)_abr_ladder[level]);
+}
+
+void cam_abr_feed(int client, uint32_t send_us, const struct timeval *captured, uint32_t dropped) {
+  if (!_abr_enabled || client < 0 || client >= CAM_BCAST_MAX_CLIENTS) {
+    return;
+  }
+  if (!_abr_seeded) {
+    cam_abr_reseed();
+  }
+  int64_t now = esp_timer_get_time();
+  int64_t latency = now - ((int64_t)captured->tv_sec * 1000000LL + captured->tv_usec);
+  if (latency < 0) {
+    latency = 0;
+  }
+
+  portENTER_CRITICAL(&_abr_mux);
+  if (!_abr_active[client]) {
+    // klien baru mulai dari setelan sekarang, bukan dari plafon
+    abr_init(&_abr[client], &_abr_cfg, _abr_quality, _abr_level);
+    _abr_active[client] = true;
+  }
+  abr_update(&_abr[client], now, send_us, (uint32_t)latency, dropped);
+  int i = abr_slowest(_abr, _abr_active, CAM_BCAST_MAX_CLIENTS);
+  bool pending = _abr[i].quality != _abr_quality || _abr[i].size != _abr_level;
+  portEXIT_CRITICAL(&_abr_mux);
+
+  if (pending) {
+    cam_bcast_between_frames(abr_apply_job, NULL);
+  }
+}
+
+void cam_abr_leave(int client) {
+  if (client < 0 || client >= CAM_BCAST_MAX_CLIENTS) {
+    return;
+  }
+  portENTER_CRITICAL(&_abr_mux);
+  _abr_active[client] = false;
+  // klien lain hanya pernah mengukur setelan sekarang: jangan lompat ke
+  // setelan mereka yang lebih tinggi, naik lagi pelan-pelan dari sini
+  for (int i = 0; i < CAM_BCAST_MAX_CLIENTS; i++) {
+    if (_abr_active[i] && (_abr[i].size > _abr_level || (_abr[i].size == _abr_level && _abr[i].quality < _abr_quality))) {
+      _abr[i].size = _abr_level;
+      _abr[i].quality = _abr_quality;
+    }
+  }
+  portEXIT_CRITICAL(&_abr_mux);
+}
+
+int cam_abr_print_status(char *p) {
+  // estimator klien yang sedang menentukan setelan sensor
+  abr_state_t st = {};
+  portENTER_CRITICAL(&_abr_mux);
+  int i = abr_slowest(_abr, _abr_active, CAM_BCAST_MAX_CLIENTS);
+  if (i >= 0) {
+    st = _abr[i];
+  }
+  uint32_t downgrades = _abr_downgrades;
+  uint32_t upgrades = _abr_upgrades;
+  portEXIT_CRITICAL(&_abr_mux);
+  return sprintf(
+    p, ",\"abr\":%u,\"abr_fps\":%.1f,\"abr_send_ms\":%.1f,\"abr_latency_ms\":%.1f,\"abr_queue\":%.2f,\"abr_down\":%u,\"abr_up\":%u", _abr_enabled ? 1 : 0,
+    st.interval_ms > 0 ? 1000.0f / st.interval_ms : 0.0f, st.send_ms, st.latency_ms, st.queue, downgrades, upgrades
+  );
+}
@@ -0,0 +1,22 @@
+#pragma once
+// Glue adaptive bitrate (abr_controller) ke sensor kamera.
+// Dipanggil dari loop stream setelah tiap frame terkirim. Tiap klien
+// broadcaster punya estimator sendiri (EWMA dan jarak frame tidak tercampur);
+// sensor mengikuti klien yang paling lambat, dan perubahan diterapkan lewat
+// cam_bcast_between_frames() seperti setter sensor lain.
+#include <stdint.h>
+#include <sys/time.h>
+
+// ABR saat boot; 0 = mati sampai /control?abr=1 (atau preset yang menyalakannya).
+#ifndef CAM_ABR_DEFAULT
+#define CAM_ABR_DEFAULT 0
+#endif
+
+void cam_abr_set_enabled(bool en);
+bool cam_abr_enabled(void);
+void cam_abr_reseed(void);  // ambil quality/framesize sensor sekarang sebagai batas atas
+// client = id dari cam_bcast_subscribe(). Bisa blok sampai perubahan
+// diterapkan di antara dua frame; jangan dipanggil dari task capture/sink.
+void cam_abr_feed(int client, uint32_t send_us, const struct timeval *captured, uint32_t dropped);
+void cam_abr_leave(int client);  // klien selesai: tidak ikut membatasi lagi
+int cam_abr_print_status(char *p);  // ",\"abr\":..." untuk /status, return panjang
@@ -0,0 +1,146 @@
+#include "cam_bmp.h"
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "esp_camera.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+#include "esp_jpg_decode.h"
+#include "img_converters.h"
+#include "bmp_stream.h"
+#include "httpd_async.h"
+#include "mjpeg_framing.h"
+
+#if defined(ARDUINO_ARCH_ESP32) && defined(CONFIG_ARDUHAL_ESP_LOG)
+#include "esp32-hal-log.h"
+#endif
+
+// State per request; scratch bmp_stream 1.5 KB, jadi tidak di stack worker.
+typedef struct {
+  bmp_stream_t bmp;
+  httpd_req_t *req;
+  mjpeg_writer_t writer;
+  bool begun;
+  char hdrs[128];
+  pixformat_t format;
+  const uint8_t *jpg;
+  size_t jpg_len;
+} bmp_session_t;
+
+// Response header baru dikirim bersama potongan pertama, saat ukuran file
+// sudah diketahui (untuk JPEG: setelah decoder membaca dimensi).
+static bool bmp_send(void *arg, const uint8_t *data, size_t len) {
+  bmp_session_t *b = (bmp_session_t *)arg;
+  if (!b->begun) {
+    b->begun = true;
+    if (mjpeg_body_begin(&b->writer, b->req, "image/x-windows-bmp", b->bmp.total, b->hdrs) != ESP_OK) {
+      return false;
+    }
+  }
+  struct iovec iov = {(void *)data, len};
+  return mjpeg_writev(&b->writer, &iov, 1) == ESP_OK;
+}
+
+// RGB565 / YUV422: 2 byte per piksel, konversi sama dengan frame2bmp().
+static void bmp_convert(void *arg, const uint8_t *src, size_t n, uint8_t *dst) {
+  bmp_session_t *b = (bmp_session_t *)arg;
+  fmt2rgb888(src, n * 2, b->format, dst);
+}
+
+static size_t jpg_read(void *arg, size_t index, uint8_t *buf, size_t len) {
+  bmp_session_t *b = (bmp_session_t *)arg;
+  if (index >= b->jpg_len) {
+    return 0;
+  }
+  if (index + len > b->jpg_len) {
+    len = b->jpg_len - index;
+  }
+  if (buf) {
+    memcpy(buf, b->jpg + index, len);
+  }
+  return len;
+}
+
+static bool jpg_write(void *arg, uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint8_t *data) {
+  return bmp_jpeg_write(&((bmp_session_t *)arg)->bmp, x, y, w, h, data);
+}
+
+static bool bmp_encode(bmp_session_t *b, camera_fb_t *fb) {
+  switch (fb->format) {
+    case PIXFORMAT_GRAYSCALE: return bmp_stream_raw(&b->bmp, fb->buf, fb->width, fb->height, 1, NULL, NULL);
+    case PIXFORMAT_RGB888:    return bmp_stream_raw(&b->bmp, fb->buf, fb->width, fb->height, 3, NULL, NULL);
+    case PIXFORMAT_RGB565:
+    case PIXFORMAT_YUV422:    return bmp_stream_raw(&b->bmp, fb->buf, fb->width, fb->height, 2, bmp_convert, b);
+    case PIXFORMAT_JPEG:      break;
+    default:                  return false;
+  }
+  // satu baris MCU: tinggi dari SOF, lebar fb (dimensi pasti baru
+  // diketahui decoder; band yang kurang ditolak di panggilan header)
+  uint8_t rows = bmp_jpeg_mcu_rows(fb->buf, fb->len);
+  b->bmp.band_rows = rows ? rows : BMP_BAND_ROWS;
+  b->bmp.band_cap = bmp_band_bytes(fb->width, b->bmp.band_rows);
+  if (b->bmp.band_cap > BMP_BAND_MAX) {
+    log_e("BMP: band %uB > BMP_BAND_MAX", (unsigned)b->bmp.band_cap);
+    return false;
+  }
+  b->bmp.band = (uint8_t *)heap_caps_malloc(b->bmp.band_cap, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  if (!b->bmp.band) {
+    b->bmp.band = (uint8_t *)malloc(b->bmp.band_cap);
+  }
+  if (!b->bmp.band) {
+    return false;
+  }
+  b->jpg = fb->buf;
+  b->jpg_len = fb->len;
+  bool ok = esp_jpg_decode(fb->len, JPG_SCALE_NONE, jpg_read, jpg_write, b) == ESP_OK;
+  free(b->bmp.band);
+  b->bmp.band = NULL;
+  return ok && !b->bmp.failed && b->bmp.sent == b->bmp.total;
+}
+
+esp_err_t cam_bmp_handler(httpd_req_t *req) {
+  // UXGA = 5.7 MB di wire: jangan tahan task httpd
+  if (!httpd_async_is_worker()) {
+    return httpd_async_submit(req, cam_bmp_handler);
+  }
+#if ARDUHAL_LOG_LEVEL >= ARDUHAL_LOG_LEVEL_INFO
+  int64_t fr_start = esp_timer_get_time();
+#endif
+  bmp_session_t *b = (bmp_session_t *)malloc(sizeof(bmp_session_t));
+  if (!b) {
+    return httpd_resp_send_500(req);
+  }
+  camera_fb_t *fb = esp_camera_fb_get();
+  if (!fb) {
+    log_e("Camera capture failed");
+    free(b);
+    httpd_resp_send_500(req);
+    return ESP_FAIL;
+  }
+  memset(b, 0, sizeof(*b));
+  bmp_stream_init(&b->bmp, bmp_send, b);
+  b->req = req;
+  b->format = fb->format;
+  snprintf(b->hdrs, sizeof(b->hdrs), "Content-Disposition: inline; filename=capture.bmp\r\nAccess-Control-Allow-Origin: *\r\nX-Timestamp: %lld.%06ld\r\n",
+           (long long)fb->timestamp.tv_sec, (long)fb->timestamp.tv_usec);
+
+  // fb ditahan selama kirim: piksel dibaca langsung dari buffer driver
+  bool ok = bmp_encode(b, fb);
+  esp_camera_fb_return(fb);
+#if ARDUHAL_LOG_LEVEL >= ARDUHAL_LOG_LEVEL_INFO
+  size_t sent = b->bmp.sent;
+#endif
+  bool begun = b->begun;
+  if (begun) {
+    mjpeg_stream_end(&b->writer, req);  // kalau gagal di tengah, close memotong body
+  } else {
+    log_e("BMP Conversion failed");
+    httpd_resp_send_500(req);
+  }
+  free(b);
+#if ARDUHAL_LOG_LEVEL >= ARDUHAL_LOG_LEVEL_INFO
+  log_i("BMP: %" PRIu64 "ms, %uB%s", (uint64_t)((esp_timer_get_time() - fr_start) / 1000), (unsigned)sent, ok ? "" : " (aborted)");
+#endif
+  return ok ? ESP_OK : ESP_FAIL;
+}
@@ -0,0 +1,10 @@
+#pragma once
+// Glue bmp_stream ke kamera + HTTP: /bmp tanpa salinan BMP satu frame di heap.
+//
+// Frame mentah (RGB565, YUV422, RGB888, gray) dikonversi per potongan lewat
+// fmt2rgb888(); frame JPEG di-decode per baris MCU. Body dikirim lewat jalur
+// writev mjpeg_framing dengan Content-Length (ukuran BMP diketahui dari
+// dimensi), byte-identik dengan frame2bmp().
+#include "esp_http_server.h"
+
+esp_err_t cam_bmp_handler(httpd_req_t *req);
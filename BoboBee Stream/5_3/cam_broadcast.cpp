@@ -0,0 +1,500 @@
+#include "cam_broadcast.h"
+#include <string.h>
+#include <stdlib.h>
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_heap_caps.h"
+#include "esp_timer.h"
+#include "img_converters.h"
+#include "frame_gate.h"
+#include "cam_metrics.h"
+
+#if defined(ARDUINO_ARCH_ESP32) && defined(CONFIG_ARDUHAL_ESP_LOG)
+#include "esp32-hal-log.h"
+#endif
+
+typedef struct {
+  bool used;
+  bool gated;
+  cam_frame_t *pending;
+  SemaphoreHandle_t ready;
+  uint32_t delivered;
+  uint32_t dropped;
+} cam_bcast_slot_t;
+
+static portMUX_TYPE _bcast_mux = portMUX_INITIALIZER_UNLOCKED;
+static cam_frame_t _bcast_pool[CAM_BCAST_POOL_SIZE];
+static cam_bcast_slot_t _bcast_slots[CAM_BCAST_MAX_CLIENTS];
+static TaskHandle_t _bcast_task = NULL;
+static volatile int _bcast_clients = 0;
+static volatile int _bcast_gated = 0;
+static volatile cam_bcast_sink_t _bcast_sink = NULL;
+static scene_detector_t *_bcast_scene = NULL;  // dialokasikan saat klien ber-gate pertama
+static uint32_t _bcast_seq = 0;
+static uint32_t _bcast_captured = 0;
+static uint32_t _bcast_capture_failed = 0;
+static uint32_t _bcast_pool_exhausted = 0;
+static SemaphoreHandle_t _bcast_job_lock = NULL;  // satu job sekaligus
+static SemaphoreHandle_t _bcast_job_done = NULL;
+static cam_bcast_job_t _bcast_job = NULL;         // diambil task capture di awal loop
+static void *_bcast_job_arg = NULL;
+static volatile int _bcast_settle = 0;
+static uint32_t _bcast_settle_skipped = 0;
+static uint32_t _bcast_allocs = 0;
+static uint32_t _bcast_encode_overflows = 0;
+static size_t _bcast_encode_cap = 0;  // ukuran buffer pool untuk frame2jpg_cb (non-JPEG)
+
+// harus dipanggil di dalam _bcast_mux
+static inline void frame_unref_locked(cam_frame_t *frame) {
+  if (frame && frame->refs > 0) {
+    frame->refs--;
+  }
+}
+
+static cam_frame_t *frame_acquire(void) {
+  cam_frame_t *frame = NULL;
+  portENTER_CRITICAL(&_bcast_mux);
+  for (int i = 0; i < CAM_BCAST_POOL_SIZE; i++) {
+    if (_bcast_pool[i].refs == 0) {
+      frame = &_bcast_pool[i];
+      frame->refs = 1;  // ref milik producer
+      break;
+    }
+  }
+  portEXIT_CRITICAL(&_bcast_mux);
+  return frame;
+}
+
+static bool frame_reserve(cam_frame_t *frame, size_t len) {
+  if (frame->cap >= len) {
+    return true;
+  }
+  // sisakan headroom supaya tidak realloc tiap kali ukuran JPEG naik sedikit
+  size_t cap = (len + (len >> 2) + 4095) & ~((size_t)4095);
+  uint8_t *buf = (uint8_t *)heap_caps_realloc(frame->buf, cap, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  if (!buf) {
+    buf = (uint8_t *)realloc(frame->buf, cap);
+  }
+  if (!buf) {
+    return false;
+  }
+  frame->buf = buf;
+  frame->cap = cap;
+  _bcast_allocs++;
+  return true;
+}
+
+// Perkiraan ukuran JPEG dari resolusi + kualitas (bit per piksel), plus
+// header; frame yang lebih besar ditangani encode_frame().
+static size_t encode_estimate(size_t width, size_t height, int quality) {
+  size_t bpp4 = quality >= 90 ? 12 : quality >= 80 ? 8 : quality >= 60 ? 6 : 4;  // bit per piksel x4
+  return width * height * bpp4 / 32 + 1024;
+}
+
+// Hanya task capture yang mengambil frame dari pool (frame_acquire), jadi
+// frame dengan refs 0 aman diperbesar dari sini.
+static void pool_prepare(size_t cap) {
+  for (int i = 0; i < CAM_BCAST_POOL_SIZE; i++) {
+    portENTER_CRITICAL(&_bcast_mux);
+    bool idle = _bcast_pool[i].refs == 0;
+    portEXIT_CRITICAL(&_bcast_mux);
+    if (idle && !frame_reserve(&_bcast_pool[i], cap)) {
+      log_e("No memory for %u B encode buffers", (unsigned)cap);
+      return;
+    }
+  }
+}
+
+typedef struct {
+  cam_frame_t *frame;
+  size_t len;
+} encode_out_t;
+
+// Output frame2jpg_cb langsung ke buffer frame. Byte di luar cap dibuang tapi
+// tetap dihitung, supaya ukuran sebenarnya diketahui untuk encode ulang.
+static size_t encode_write(void *arg, size_t index, const void *data, size_t len) {
+  encode_out_t *out = (encode_out_t *)arg;
+  if (index + len <= out->frame->cap) {
+    memcpy(out->frame->buf + index, data, len);
+  }
+  if (index + len > out->len) {
+    out->len = index + len;
+  }
+  return len;
+}
+
+static bool encode_frame(cam_frame_t *frame, camera_fb_t *fb) {
+  size_t estimate = encode_estimate(fb->width, fb->height, CAM_BCAST_JPEG_QUALITY);
+  if (estimate > _bcast_encode_cap) {
+    _bcast_encode_cap = estimate;  // frame pertama / resolusi naik
+    pool_prepare(estimate);
+  }
+  if (!frame_reserve(frame, _bcast_encode_cap)) {
+    return false;
+  }
+  encode_out_t out = {frame, 0};
+  if (!frame2jpg_cb(fb, CAM_BCAST_JPEG_QUALITY, encode_write, &out)) {
+    return false;
+  }
+  if (out.len > frame->cap) {
+    // scene sangat detail: perbesar seluruh pool sekali, encode ulang frame ini
+    _bcast_encode_overflows++;
+    _bcast_encode_cap = out.len;
+    pool_prepare(out.len);
+    if (!frame_reserve(frame, out.len)) {
+      return false;
+    }
+    out.len = 0;
+    if (!frame2jpg_cb(fb, CAM_BCAST_JPEG_QUALITY, encode_write, &out) || out.len > frame->cap) {
+      return false;
+    }
+  }
+  frame->len = out.len;
+  return true;
+}
+
+static bool frame_fill(cam_frame_t *frame, camera_fb_t *fb) {
+  if (fb->format == PIXFORMAT_JPEG) {
+    if (!frame_reserve(frame, fb->len)) {
+      return false;
+    }
+    memcpy(frame->buf, fb->buf, fb->len);
+    frame->len = fb->len;
+  } else {
+    int64_t t0 = esp_timer_get_time();
+    if (!encode_frame(frame, fb)) {
+      log_e("JPEG compression failed");
+      return false;
+    }
+    cam_metrics_stage(CAM_STAGE_JPEG, (uint32_t)(esp_timer_get_time() - t0));
+  }
+  frame->width = fb->width;
+  frame->height = fb->height;
+  frame->timestamp = fb->timestamp;
+  return true;
+}
+
+// Tanpa klien ber-gate setiap frame dianggap scene baru (gate selalu lolos).
+static void frame_classify(cam_frame_t *frame) {
+  int64_t now = esp_timer_get_time();
+  if (_bcast_gated == 0 || !_bcast_scene) {
+    frame->scene = _bcast_seq + 1;
+    frame->changed_us = now;
+    return;
+  }
+  scene_detector_update(_bcast_scene, frame->buf, frame->len, now);
+  frame->scene = _bcast_scene->scene;
+  frame->changed_us = _bcast_scene->changed_us;
+}
+
+static void frame_publish(cam_frame_t *frame) {
+  portENTER_CRITICAL(&_bcast_mux);
+  frame->seq = ++_bcast_seq;
+  for (int i = 0; i < CAM_BCAST_MAX_CLIENTS; i++) {
+    cam_bcast_slot_t *slot = &_bcast_slots[i];
+    if (!slot->used) {
+      continue;
+    }
+    if (slot->pending) {
+      // klien belum sempat ambil frame sebelumnya -> ganti dengan yang terbaru
+      frame_unref_locked(slot->pending);
+      slot->dropped++;
+    }
+    frame->refs++;
+    slot->pending = frame;
+  }
+  portEXIT_CRITICAL(&_bcast_mux);
+
+  for (int i = 0; i < CAM_BCAST_MAX_CLIENTS; i++) {
+    if (_bcast_slots[i].used) {
+      xSemaphoreGive(_bcast_slots[i].ready);
+    }
+  }
+}
+
+// Di antara fb_return dan fb_get berikutnya: tidak ada frame yang dipegang.
+static void bcast_run_job(void) {
+  portENTER_CRITICAL(&_bcast_mux);
+  cam_bcast_job_t job = _bcast_job;
+  void *arg = _bcast_job_arg;
+  _bcast_job = NULL;
+  portEXIT_CRITICAL(&_bcast_mux);
+  if (job) {
+    job(arg);
+    _bcast_settle = CAM_BCAST_SETTLE_FRAMES;
+    xSemaphoreGive(_bcast_job_done);
+  }
+}
+
+static void bcast_task(void *) {
+  for (;;) {
+    bcast_run_job();
+    cam_bcast_sink_t sink = _bcast_sink;
+    if (_bcast_clients == 0 && !sink) {
+      ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+      continue;
+    }
+
+    int64_t t0 = esp_timer_get_time();
+    camera_fb_t *fb = esp_camera_fb_get();
+    cam_metrics_stage(CAM_STAGE_CAPTURE, (uint32_t)(esp_timer_get_time() - t0));
+    if (!fb) {
+      log_e("Camera capture failed");
+      _bcast_capture_failed++;
+      vTaskDelay(10 / portTICK_PERIOD_MS);
+      continue;
+    }
+
+    if (_bcast_settle > 0) {
+      // bisa jadi sudah terekspos saat job menulis register sensor
+      _bcast_settle--;
+      _bcast_settle_skipped++;
+      esp_camera_fb_return(fb);
+      continue;
+    }
+
+    if (_bcast_clients == 0 && !sink) {
+      // klien terakhir pergi selama fb_get: tidak ada yang menerima frame ini
+      esp_camera_fb_return(fb);
+      continue;
+    }
+
+    if (_bcast_clients == 0 && fb->format == PIXFORMAT_JPEG) {
+      // hanya sink: serahkan buffer driver langsung, tanpa lewat pool
+      sink(fb->buf, fb->len, &fb->timestamp, fb->width, fb->height);
+      cam_metrics_frame(fb->len);
+      esp_camera_fb_return(fb);
+      _bcast_captured++;
+      continue;
+    }
+
+    cam_frame_t *frame = frame_acquire();
+    if (!frame) {
+      // tidak seharusnya terjadi selama POOL_SIZE >= 2 * MAX_CLIENTS + 1
+      _bcast_pool_exhausted++;
+      esp_camera_fb_return(fb);
+      vTaskDelay(1);
+      continue;
+    }
+
+    bool ok = frame_fill(frame, fb);
+    esp_camera_fb_return(fb);
+    if (ok) {
+      _bcast_captured++;
+      cam_metrics_frame(frame->len);
+      if (sink) {
+        sink(frame->buf, frame->len, &frame->timestamp, frame->width, frame->height);
+      }
+      frame_classify(frame);
+      frame_publish(frame);
+    }
+    cam_frame_release(frame);
+  }
+}
+
+bool cam_bcast_start(void) {
+  if (_bcast_task) {
+    return true;
+  }
+  if (!_bcast_job_lock) {
+    _bcast_job_lock = xSemaphoreCreateMutex();
+    _bcast_job_done = xSemaphoreCreateBinary();
+    if (!_bcast_job_lock || !_bcast_job_done) {
+      return false;
+    }
+  }
+  for (int i = 0; i < CAM_BCAST_MAX_CLIENTS; i++) {
+    if (!_bcast_slots[i].ready) {
+      _bcast_slots[i].ready = xSemaphoreCreateBinary();
+      if (!_bcast_slots[i].ready) {
+        return false;
+      }
+    }
+  }
+  if (xTaskCreatePinnedToCore(bcast_task, "CamBcast", 4096, NULL, 5, &_bcast_task, 0) != pdPASS) {
+    _bcast_task = NULL;
+    log_e("Failed to start capture task");
+    return false;
+  }
+  log_i("Capture broadcaster started (%d clients max)", CAM_BCAST_MAX_CLIENTS);
+  return true;
+}
+
+bool cam_bcast_set_sink(cam_bcast_sink_t sink) {
+  if (!cam_bcast_start()) {
+    return false;
+  }
+  _bcast_sink = sink;
+  xTaskNotifyGive(_bcast_task);
+  return true;
+}
+
+int cam_bcast_subscribe(void) {
+  if (!cam_bcast_start()) {
+    return -1;
+  }
+  int id = -1;
+  portENTER_CRITICAL(&_bcast_mux);
+  for (int i = 0; i < CAM_BCAST_MAX_CLIENTS; i++) {
+    if (!_bcast_slots[i].used) {
+      _bcast_slots[i].used = true;
+      _bcast_slots[i].gated = false;
+      _bcast_slots[i].pending = NULL;
+      _bcast_slots[i].delivered = 0;
+      _bcast_slots[i].dropped = 0;
+      _bcast_clients++;
+      id = i;
+      break;
+    }
+  }
+  portEXIT_CRITICAL(&_bcast_mux);
+
+  if (id >= 0) {
+    xSemaphoreTake(_bcast_slots[id].ready, 0);  // buang sinyal sisa sesi sebelumnya
+    xTaskNotifyGive(_bcast_task);
+  }
+  return id;
+}
+
+void cam_bcast_unsubscribe(int id) {
+  if (id < 0 || id >= CAM_BCAST_MAX_CLIENTS) {
+    return;
+  }
+  portENTER_CRITICAL(&_bcast_mux);
+  cam_bcast_slot_t *slot = &_bcast_slots[id];
+  if (slot->used) {
+    frame_unref_locked(slot->pending);
+    slot->pending = NULL;
+    slot->used = false;
+    if (slot->gated) {
+      slot->gated = false;
+      _bcast_gated--;
+    }
+    _bcast_clients--;
+  }
+  portEXIT_CRITICAL(&_bcast_mux);
+}
+
+void cam_bcast_set_gated(int id, bool gated) {
+  if (id < 0 || id >= CAM_BCAST_MAX_CLIENTS) {
+    return;
+  }
+  if (gated && !_bcast_scene) {
+    scene_detector_t *d = (scene_detector_t *)heap_caps_malloc(sizeof(scene_detector_t), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!d) {
+      d = (scene_detector_t *)malloc(sizeof(scene_detector_t));
+    }
+    if (!d) {
+      log_e("No memory for scene detector");
+      return;
+    }
+    scene_detector_init(d);
+    portENTER_CRITICAL(&_bcast_mux);
+    if (!_bcast_scene) {
+      _bcast_scene = d;  // hanya dibaca producer setelah _bcast_gated > 0
+      d = NULL;
+    }
+    portEXIT_CRITICAL(&_bcast_mux);
+    free(d);  // klien lain sudah lebih dulu memasang detector
+  }
+  portENTER_CRITICAL(&_bcast_mux);
+  cam_bcast_slot_t *slot = &_bcast_slots[id];
+  if (slot->used && slot->gated != gated) {
+    slot->gated = gated;
+    _bcast_gated += gated ? 1 : -1;
+  }
+  portEXIT_CRITICAL(&_bcast_mux);
+}
+
+cam_frame_t *cam_bcast_wait(int id, TickType_t timeout) {
+  if (id < 0 || id >= CAM_BCAST_MAX_CLIENTS) {
+    return NULL;
+  }
+  cam_bcast_slot_t *slot = &_bcast_slots[id];
+  TickType_t start = xTaskGetTickCount();
+  TickType_t left = timeout;
+  for (;;) {
+    if (xSemaphoreTake(slot->ready, left) != pdTRUE) {
+      return NULL;
+    }
+    portENTER_CRITICAL(&_bcast_mux);
+    cam_frame_t *frame = slot->pending;  // ref pindah ke pemanggil
+    slot->pending = NULL;
+    if (frame) {
+      slot->delivered++;
+    }
+    portEXIT_CRITICAL(&_bcast_mux);
+    if (frame) {
+      return frame;
+    }
+    // sinyal basi: give terjadi di luar mux, jadi frame-nya bisa sudah diambil
+    // lewat sinyal sebelumnya (atau slot dipakai ulang) -> tunggu sisa timeout
+    if (timeout != portMAX_DELAY) {
+      TickType_t elapsed = xTaskGetTickCount() - start;
+      if (elapsed >= timeout) {
+        return NULL;
+      }
+      left = timeout - elapsed;
+    }
+  }
+}
+
+void cam_frame_release(cam_frame_t *frame) {
+  if (!frame) {
+    return;
+  }
+  portENTER_CRITICAL(&_bcast_mux);
+  frame_unref_locked(frame);
+  portEXIT_CRITICAL(&_bcast_mux);
+}
+
+uint32_t cam_bcast_dropped(int id) {
+  if (id < 0 || id >= CAM_BCAST_MAX_CLIENTS) {
+    return 0;
+  }
+  return _bcast_slots[id].dropped;
+}
+
+void cam_bcast_get_stats(cam_bcast_stats_t *out) {
+  portENTER_CRITICAL(&_bcast_mux);
+  out->captured = _bcast_captured;
+  out->capture_failed = _bcast_capture_failed;
+  out->pool_exhausted = _bcast_pool_exhausted;
+  out->scene_changes = _bcast_scene ? _bcast_scene->changes : 0;
+  out->settle_skipped = _bcast_settle_skipped;
+  out->allocs = _bcast_allocs;
+  out->encode_overflows = _bcast_encode_overflows;
+  out->clients = _bcast_clients;
+  for (int i = 0; i < CAM_BCAST_MAX_CLIENTS; i++) {
+    out->delivered[i] = _bcast_slots[i].used ? _bcast_slots[i].delivered : 0;
+    out->dropped[i] = _bcast_slots[i].used ? _bcast_slots[i].dropped : 0;
+  }
+  portEXIT_CRITICAL(&_bcast_mux);
+}
+
+void cam_bcast_between_frames(cam_bcast_job_t job, void *arg) {
+  if (!_bcast_task) {
+    job(arg);  // belum pernah ada capture lewat broadcaster
+    return;
+  }
+  xSemaphoreTake(_bcast_job_lock, portMAX_DELAY);
+  portENTER_CRITICAL(&_bcast_mux);
+  _bcast_job = job;
+  _bcast_job_arg = arg;
+  portEXIT_CRITICAL(&_bcast_mux);
+  xTaskNotifyGive(_bcast_task);  // bangunkan kalau sedang idle tanpa klien
+
+  if (xSemaphoreTake(_bcast_job_done, 1000 / portTICK_PERIOD_MS) != pdTRUE) {
+    // task capture tertahan di fb_get (kamera macet): ambil kembali job-nya
+    portENTER_CRITICAL(&_bcast_mux);
+    bool pending = _bcast_job == job;
+    _bcast_job = NULL;
+    portEXIT_CRITICAL(&_bcast_mux);
+    if (pending) {
+      job(arg);
+    } else {
+      xSemaphoreTake(_bcast_job_done, portMAX_DELAY);  // sudah jalan, arg harus tetap hidup
+    }
+  }
+  xSemaphoreGive(_bcast_job_lock);
+}
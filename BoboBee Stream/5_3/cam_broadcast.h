@@ -0,0 +1,85 @@
+#pragma once
+// Satu task capture -> banyak klien /stream.
+//
+// Producer task memanggil esp_camera_fb_get() sekali per frame, menyalin JPEG
+// ke frame pool (PSRAM, ref-counted) lalu langsung mengembalikan fb ke driver.
+// Setiap subscriber punya slot "latest only": kalau klien masih sibuk kirim
+// frame lama, frame pending yang belum diambil diganti frame terbaru (drop),
+// jadi klien lambat tidak pernah menahan kamera atau klien lain.
+// Selama ada klien ber-gate (cam_bcast_set_gated), producer juga menghitung
+// id scene tiap frame (frame_gate.h) supaya klien bisa melewatkan frame diam.
+// Sink (mis. clip_ring) menerima setiap frame dan membuat capture tetap jalan
+// walau tidak ada klien; tanpa klien JPEG diambil langsung dari buffer driver.
+// Sensor non-JPEG: frame2jpg_cb menulis langsung ke buffer pool yang sudah
+// dialokasikan (ukuran dari resolusi + kualitas), jadi steady state tanpa
+// malloc/free per frame; counter allocs untuk verifikasi.
+// Job (cam_bcast_between_frames) dijalankan task capture di antara dua
+// esp_camera_fb_get(); frame yang mungkin terekspos di tengah perubahan
+// setting dibuang, jadi klien tidak pernah melihat setting setengah jadi.
+#include <stdint.h>
+#include <stddef.h>
+#include <sys/time.h>
+#include "esp_camera.h"
+#include "freertos/FreeRTOS.h"
+
+#ifndef CAM_BCAST_MAX_CLIENTS
+#define CAM_BCAST_MAX_CLIENTS 4
+#endif
+
+// frame yang dibuang setelah job: sebanyak fb_count driver (sudah di-DMA
+// saat register ditulis)
+#ifndef CAM_BCAST_SETTLE_FRAMES
+#define CAM_BCAST_SETTLE_FRAMES 2
+#endif
+
+// kualitas frame2jpg_cb untuk sensor non-JPEG
+#ifndef CAM_BCAST_JPEG_QUALITY
+#define CAM_BCAST_JPEG_QUALITY 80
+#endif
+
+// tiap klien pegang maks 2 frame (sedang dikirim + pending), +2 untuk producer
+#define CAM_BCAST_POOL_SIZE (CAM_BCAST_MAX_CLIENTS * 2 + 2)
+
+typedef struct {
+  uint8_t *buf;
+  size_t len;
+  size_t cap;
+  size_t width;
+  size_t height;
+  struct timeval timestamp;
+  uint32_t seq;
+  uint32_t scene;       // sama dengan frame sebelumnya = tidak ada perubahan
+  int64_t changed_us;   // waktu perubahan scene terakhir (esp_timer)
+  int refs;
+} cam_frame_t;
+
+typedef struct {
+  uint32_t captured;
+  uint32_t capture_failed;
+  uint32_t pool_exhausted;
+  uint32_t scene_changes;
+  uint32_t settle_skipped;  // frame dibuang setelah job between_frames
+  uint32_t allocs;            // alokasi (ulang) buffer pool; tetap di steady state
+  uint32_t encode_overflows;  // output frame2jpg_cb melebihi buffer, di-encode ulang
+  int clients;
+  uint32_t delivered[CAM_BCAST_MAX_CLIENTS];
+  uint32_t dropped[CAM_BCAST_MAX_CLIENTS];
+} cam_bcast_stats_t;
+
+typedef void (*cam_bcast_job_t)(void *arg);
+
+// Dipanggil dari task capture untuk setiap frame JPEG; buf hanya valid selama panggilan.
+typedef void (*cam_bcast_sink_t)(const uint8_t *buf, size_t len, const struct timeval *ts, uint16_t width, uint16_t height);
+
+bool cam_bcast_start(void);                      // idempotent
+bool cam_bcast_set_sink(cam_bcast_sink_t sink);  // NULL = lepas sink
+int cam_bcast_subscribe(void);                   // -1 kalau slot penuh
+void cam_bcast_unsubscribe(int id);
+void cam_bcast_set_gated(int id, bool gated);   // aktifkan deteksi scene untuk klien ini
+cam_frame_t *cam_bcast_wait(int id, TickType_t timeout);  // NULL kalau timeout
+void cam_frame_release(cam_frame_t *frame);
+uint32_t cam_bcast_dropped(int id);              // total frame yang dilewati klien ini
+void cam_bcast_get_stats(cam_bcast_stats_t *out);
+// Blok sampai job selesai. Tanpa task capture job jalan langsung di pemanggil.
+// Jangan dipanggil dari sink (task capture sendiri).
+void cam_bcast_between_frames(cam_bcast_job_t job, void *arg);
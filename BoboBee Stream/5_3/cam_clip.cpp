@@ -0,0 +1,359 @@
+#include "cam_clip.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "clip_ring.h"
+#include "cam_broadcast.h"
+#include "httpd_async.h"
+#include "mjpeg_framing.h"
+
+#if defined(ARDUINO_ARCH_ESP32) && defined(CONFIG_ARDUHAL_ESP_LOG)
+#include "esp32-hal-log.h"
+#endif
+
+#define CLIP_BOUNDARY   "clip"
+#define CLIP_POLL_MS    20
+#define CLIP_GRACE_US   500000  // tunggu frame terakhir window post
+#define AVI_HEADER_LEN  224
+#define AVI_IDX_BATCH   32
+
+static void clip_sink(const uint8_t *buf, size_t len, const struct timeval *ts, uint16_t width, uint16_t height) {
+  clip_ring_append(buf, len, ts, width, height, esp_timer_get_time());
+}
+
+bool cam_clip_start(void) {
+  if (!clip_ring_begin(CLIP_RING_BYTES, CLIP_RING_MAX_FRAMES)) {
+    return false;
+  }
+  return cam_bcast_set_sink(clip_sink);
+}
+
+void cam_clip_trigger(const char *reason) {
+  clip_ring_trigger(reason, esp_timer_get_time());
+  log_i("Clip trigger: %s", reason ? reason : "");
+}
+
+static uint32_t query_seconds(const char *query, const char *key, uint32_t def) {
+  char value[8];
+  if (!query || httpd_query_key_value(query, key, value, sizeof(value)) != ESP_OK) {
+    return def;
+  }
+  uint32_t v = strtoul(value, NULL, 10);
+  return v > CAM_CLIP_MAX_SECONDS ? CAM_CLIP_MAX_SECONDS : v;
+}
+
+// Frame awal window sudah di-evict sebelum window dibuka (pre lebih panjang
+// dari isi ring)? Toleransi dua jarak frame.
+static bool clip_start_missing(const clip_cursor_t *cur, int64_t start_us) {
+  clip_ring_stats_t st;
+  clip_ring_get_stats(&st);
+  clip_frame_t f;
+  if (st.frames < 2 || clip_ring_peek(cur, 0, &f) <= 0) {
+    return false;
+  }
+  int64_t frame_us = (st.newest_us - st.oldest_us) / (st.frames - 1);
+  return f.t_us - start_us > 2 * frame_us;
+}
+
+// ---------- MJPEG: kirim sambil jalan, window post diikuti live ----------
+static esp_err_t clip_send_mjpeg(httpd_req_t *req, clip_cursor_t *cur, int64_t start_us, int64_t end_us) {
+  mjpeg_writer_t w;
+  const char *hdrs = clip_start_missing(cur, start_us) ? "Access-Control-Allow-Origin: *\r\nX-Clip-Truncated: missing\r\n"
+                                                       : "Access-Control-Allow-Origin: *\r\n";
+  esp_err_t res = mjpeg_stream_begin(&w, req, CLIP_BOUNDARY, true, hdrs);
+  while (res == ESP_OK) {
+    clip_frame_t f;
+    int r = clip_ring_next(cur, &f);
+    if (r < 0 || (r > 0 && f.t_us > end_us)) {
+      break;
+    }
+    if (r == 0) {
+      if (esp_timer_get_time() > end_us + CLIP_GRACE_US) {
+        break;  // capture berhenti, jangan menunggu selamanya
+      }
+      vTaskDelay(CLIP_POLL_MS / portTICK_PERIOD_MS);
+      continue;
+    }
+    res = mjpeg_stream_write(&w, f.buf, f.len, &f.timestamp);
+  }
+  mjpeg_stream_end(&w, req);
+  log_i("Clip MJPEG: %u frames", (unsigned)w.frames);
+  return res;
+}
+
+// ---------- AVI ----------
+static inline uint8_t *put32(uint8_t *p, uint32_t v) {
+  p[0] = v;
+  p[1] = v >> 8;
+  p[2] = v >> 16;
+  p[3] = v >> 24;
+  return p + 4;
+}
+
+static inline uint8_t *put16(uint8_t *p, uint16_t v) {
+  p[0] = v;
+  p[1] = v >> 8;
+  return p + 2;
+}
+
+static inline uint8_t *put4cc(uint8_t *p, const char *cc) {
+  memcpy(p, cc, 4);
+  return p + 4;
+}
+
+static size_t avi_header(uint8_t *out, uint32_t frames, uint16_t width, uint16_t height, uint32_t us_per_frame, uint32_t movi_len, uint32_t max_frame) {
+  uint8_t *p = out;
+  p = put4cc(p, "RIFF");
+  p = put32(p, 4 + (8 + 192) + (8 + movi_len) + (8 + 16 * frames));
+  p = put4cc(p, "AVI ");
+  p = put4cc(p, "LIST");
+  p = put32(p, 192);
+  p = put4cc(p, "hdrl");
+  p = put4cc(p, "avih");
+  p = put32(p, 56);
+  p = put32(p, us_per_frame);
+  p = put32(p, (uint32_t)((uint64_t)max_frame * 1000000 / us_per_frame));
+  p = put32(p, 0);
+  p = put32(p, 0x10);  // AVIF_HASINDEX
+  p = put32(p, frames);
+  p = put32(p, 0);
+  p = put32(p, 1);
+  p = put32(p, max_frame);
+  p = put32(p, width);
+  p = put32(p, height);
+  memset(p, 0, 16);
+  p += 16;
+  p = put4cc(p, "LIST");
+  p = put32(p, 116);
+  p = put4cc(p, "strl");
+  p = put4cc(p, "strh");
+  p = put32(p, 56);
+  p = put4cc(p, "vids");
+  p = put4cc(p, "MJPG");
+  p = put32(p, 0);
+  p = put32(p, 0);  // priority + language
+  p = put32(p, 0);
+  p = put32(p, us_per_frame);  // scale / rate = detik per frame
+  p = put32(p, 1000000);
+  p = put32(p, 0);
+  p = put32(p, frames);
+  p = put32(p, max_frame);
+  p = put32(p, 0xFFFFFFFF);
+  p = put32(p, 0);
+  p = put16(p, 0);
+  p = put16(p, 0);
+  p = put16(p, width);
+  p = put16(p, height);
+  p = put4cc(p, "strf");
+  p = put32(p, 40);
+  p = put32(p, 40);
+  p = put32(p, width);
+  p = put32(p, height);
+  p = put16(p, 1);
+  p = put16(p, 24);
+  p = put4cc(p, "MJPG");
+  p = put32(p, (uint32_t)width * height * 3);
+  memset(p, 0, 16);
+  p += 16;
+  p = put4cc(p, "LIST");
+  p = put32(p, movi_len);
+  p = put4cc(p, "movi");
+  return p - out;
+}
+
+// clamped = window sudah dipersempit supaya muat di ring (lihat handler).
+static esp_err_t clip_send_avi(httpd_req_t *req, clip_cursor_t *cur, int64_t start_us, int64_t event_us, int64_t end_us, bool clamped) {
+  bool missing = clip_start_missing(cur, start_us);
+  clip_ring_stats_t st;
+  clip_ring_get_stats(&st);
+  uint32_t dropped_before = st.dropped_pinned;
+
+  // AVI butuh ukuran total di depan: tunggu window post selesai dulu
+  while (esp_timer_get_time() < end_us + CLIP_GRACE_US) {
+    vTaskDelay(100 / portTICK_PERIOD_MS);
+  }
+
+  // hitung frame di window; semua masih di-pin oleh cursor
+  uint32_t frames = 0, movi_len = 4, max_frame = 0;
+  uint16_t width = 0, height = 0;
+  int64_t first_us = 0, last_us = 0;
+  clip_frame_t f;
+  while (clip_ring_peek(cur, frames, &f) > 0 && f.t_us <= end_us) {
+    if (frames == 0) {
+      width = f.width;
+      height = f.height;
+      first_us = f.t_us;
+    }
+    last_us = f.t_us;
+    movi_len += 8 + f.len + (f.len & 1);
+    if (f.len > max_frame) {
+      max_frame = f.len;
+    }
+    frames++;
+  }
+  if (frames == 0) {
+    httpd_resp_send_404(req);
+    return ESP_FAIL;
+  }
+  uint32_t us_per_frame = frames > 1 ? (uint32_t)((last_us - first_us) / (frames - 1)) : 66666;
+  if (us_per_frame == 0) {
+    us_per_frame = 1;
+  }
+
+  // writer membuang frame baru selama window di-pin -> AVI lebih pendek dari window
+  clip_ring_get_stats(&st);
+  bool dropped = st.dropped_pinned != dropped_before;
+  char hdrs[200];
+  int n = snprintf(
+    hdrs, sizeof(hdrs), "Access-Control-Allow-Origin: *\r\nContent-Disposition: attachment; filename=clip.avi\r\nX-Clip-Range-Ms: %d,%d\r\n",
+    (int)((first_us - event_us) / 1000), (int)((last_us - event_us) / 1000)
+  );
+  char why[32] = "";
+  if (clamped) strcat(why, ",clamped");
+  if (dropped) strcat(why, ",dropped");
+  if (missing) strcat(why, ",missing");
+  if (why[0]) {
+    snprintf(hdrs + n, sizeof(hdrs) - n, "X-Clip-Truncated: %s\r\n", why + 1);
+    log_w("Clip AVI truncated: %s", why + 1);
+  }
+
+  uint8_t header[AVI_HEADER_LEN];
+  size_t header_len = avi_header(header, frames, width, height, us_per_frame, movi_len, max_frame);
+  size_t total = header_len + (movi_len - 4) + 8 + 16 * frames;
+
+  mjpeg_writer_t w;
+  esp_err_t res = mjpeg_body_begin(&w, req, "video/x-msvideo", total, hdrs);
+  if (res == ESP_OK) {
+    struct iovec iov = {header, header_len};
+    res = mjpeg_writev(&w, &iov, 1);
+  }
+
+  // movi: langsung dari memori ring, header chunk + data + pad dalam satu writev
+  static const uint8_t pad = 0;
+  uint32_t offset = 4;  // idx1 relatif ke fourcc "movi"
+  uint32_t *sizes = (uint32_t *)heap_caps_malloc(frames * sizeof(uint32_t), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  if (!sizes) {
+    res = ESP_ERR_NO_MEM;
+  }
+  for (uint32_t i = 0; i < frames && res == ESP_OK; i++) {
+    if (clip_ring_next(cur, &f) <= 0) {
+      res = ESP_FAIL;
+      break;
+    }
+    uint8_t chunk[8];
+    put32(put4cc(chunk, "00dc"), f.len);
+    struct iovec iov[3] = {{chunk, 8}, {(void *)f.buf, f.len}, {(void *)&pad, f.len & 1}};
+    res = mjpeg_writev(&w, iov, (f.len & 1) ? 3 : 2);
+    sizes[i] = f.len;
+  }
+
+  if (res == ESP_OK) {
+    uint8_t idx[8 + AVI_IDX_BATCH * 16];
+    uint8_t *p = put32(put4cc(idx, "idx1"), 16 * frames);
+    for (uint32_t i = 0; i < frames && res == ESP_OK; i++) {
+      p = put4cc(p, "00dc");
+      p = put32(p, 0x10);  // AVIIF_KEYFRAME
+      p = put32(p, offset);
+      p = put32(p, sizes[i]);
+      offset += 8 + sizes[i] + (sizes[i] & 1);
+      if (p + 16 > idx + sizeof(idx) || i == frames - 1) {
+        struct iovec iov = {idx, (size_t)(p - idx)};
+        res = mjpeg_writev(&w, &iov, 1);
+        p = idx;
+      }
+    }
+  }
+  heap_caps_free(sizes);
+  mjpeg_stream_end(&w, req);
+  log_i("Clip AVI: %u frames, %u bytes", (unsigned)frames, (unsigned)total);
+  return res;
+}
+
+esp_err_t cam_clip_handler(httpd_req_t *req) {
+  if (!httpd_async_is_worker()) {
+    return httpd_async_submit(req, cam_clip_handler);
+  }
+  if (!clip_ring_active()) {
+    httpd_resp_set_status(req, "503 Service Unavailable");
+    return httpd_resp_send(req, "clip ring not available", HTTPD_RESP_USE_STRLEN);
+  }
+
+  char query[96];
+  const char *q = httpd_req_get_url_query_str(req, query, sizeof(query)) == ESP_OK ? query : NULL;
+  uint32_t pre = query_seconds(q, "pre", 5);
+  uint32_t post = query_seconds(q, "post", 5);
+  char value[8] = "";
+  bool avi = q && httpd_query_key_value(q, "fmt", value, sizeof(value)) == ESP_OK && strcmp(value, "avi") == 0;
+  bool last = q && httpd_query_key_value(q, "event", value, sizeof(value)) == ESP_OK && strcmp(value, "last") == 0;
+
+  // membaca clip bukan event: trigger hanya dari /trigger atau firmware
+  int64_t event_us = esp_timer_get_time();
+  clip_ring_stats_t st;
+  clip_ring_get_stats(&st);
+  if (last && st.triggers) {
+    event_us = st.trigger_us;
+  }
+  int64_t start_us = event_us - (int64_t)pre * 1000000;
+  int64_t end_us = event_us + (int64_t)post * 1000000;
+
+  // AVI mem-pin seluruh window sampai post selesai; window yang tidak muat di
+  // ring (framesize besar) membuat writer membuang frame baru. Persempit pre
+  // dan post secara proporsional supaya muat, dan laporkan di header.
+  bool clamped = false;
+  int64_t fit_us = avi ? clip_ring_fit_us() - CLIP_GRACE_US : 0;
+  if (fit_us > 0 && end_us - start_us > fit_us) {
+    int64_t want_us = end_us - start_us;
+    start_us = event_us - (int64_t)pre * 1000000 * fit_us / want_us;
+    end_us = event_us + (int64_t)post * 1000000 * fit_us / want_us;
+    clamped = true;
+  }
+
+  clip_cursor_t cur;
+  if (!clip_ring_open(&cur, start_us)) {
+    httpd_resp_set_status(req, "503 Service Unavailable");
+    httpd_resp_set_hdr(req, "Retry-After", "1");
+    return httpd_resp_send(req, NULL, 0);
+  }
+  esp_err_t res = avi ? clip_send_avi(req, &cur, start_us, event_us, end_us, clamped) : clip_send_mjpeg(req, &cur, start_us, end_us);
+  clip_ring_close(&cur);
+  return res;
+}
+
+esp_err_t cam_clip_trigger_handler(httpd_req_t *req) {
+  char query[64];
+  char reason[16] = "manual";
+  if (httpd_req_get_url_query_str(req, query, sizeof(query)) == ESP_OK) {
+    httpd_query_key_value(query, "reason", reason, sizeof(reason));
+  }
+  for (char *r = reason; *r; r++) {
+    if (!((*r >= 'a' && *r <= 'z') || (*r >= 'A' && *r <= 'Z') || (*r >= '0' && *r <= '9') || *r == '-')) {
+      *r = '_';  // masuk ke JSON apa adanya
+    }
+  }
+  cam_clip_trigger(reason);
+
+  clip_ring_stats_t st;
+  clip_ring_get_stats(&st);
+  char json[128];
+  snprintf(
+    json, sizeof(json), "{\"triggers\":%u,\"reason\":\"%s\",\"buffered_ms\":%u}", (unsigned)st.triggers, st.trigger_reason,
+    (unsigned)((st.newest_us - st.oldest_us) / 1000)
+  );
+  httpd_resp_set_type(req, "application/json");
+  httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
+  return httpd_resp_send(req, json, HTTPD_RESP_USE_STRLEN);
+}
+
+int cam_clip_print_status(char *p) {
+  clip_ring_stats_t st;
+  clip_ring_get_stats(&st);
+  return sprintf(
+    p, ",\"clip_frames\":%u,\"clip_kb\":%u,\"clip_ms\":%u,\"clip_evicted\":%u,\"clip_dropped\":%u,\"clip_triggers\":%u", (unsigned)st.frames,
+    (unsigned)(st.used / 1024), (unsigned)((st.newest_us - st.oldest_us) / 1000), (unsigned)st.evicted,
+    (unsigned)(st.dropped_pinned + st.dropped_oversize), (unsigned)st.triggers
+  );
+}
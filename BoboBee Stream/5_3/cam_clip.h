@@ -0,0 +1,26 @@
+#pragma once
+// Glue clip_ring ke kamera + HTTP.
+//
+//   /trigger?reason=prone          catat event (juga bisa dari firmware: cam_clip_trigger)
+//   /clip?pre=5&post=5             MJPEG multipart, window sekitar sekarang
+//   /clip?pre=5&post=5&event=last  window sekitar trigger terakhir
+//   /clip?...&fmt=avi              AVI (MJPG) dengan Content-Length + idx1,
+//                                  dikirim setelah window post selesai
+//
+// Membaca clip tidak membuat event. Window AVI di-pin sampai post selesai,
+// jadi dipersempit kalau tidak muat di ring pada framesize sekarang.
+// X-Clip-Range-Ms memberi frame pertama/terakhir relatif ke event, dan
+// X-Clip-Truncated (clamped, dropped, missing) muncul kalau clip lebih
+// pendek dari yang diminta.
+#include <stdint.h>
+#include "esp_http_server.h"
+
+#ifndef CAM_CLIP_MAX_SECONDS
+#define CAM_CLIP_MAX_SECONDS 30  // batas pre/post per sisi
+#endif
+
+bool cam_clip_start(void);  // idempotent: alokasi ring + pasang sink broadcaster
+void cam_clip_trigger(const char *reason);
+esp_err_t cam_clip_handler(httpd_req_t *req);
+esp_err_t cam_clip_trigger_handler(httpd_req_t *req);
+int cam_clip_print_status(char *p);  // ",\"clip_frames\":..." untuk /status, return panjang
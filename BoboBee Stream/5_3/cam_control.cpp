@@ -0,0 +1,667 @@
+#include "cam_control.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "esp_camera.h"
+#include "nvs.h"
+#include "cam_broadcast.h"
+#include "cam_abr.h"
+#include "cam_status.h"
+
+#if defined(ARDUINO_ARCH_ESP32) && defined(CONFIG_ARDUHAL_ESP_LOG)
+#include "esp32-hal-log.h"
+#endif
+
+#define CTRL_NVS_NS     "camctl"
+#define CTRL_HASH_SLOTS 64  // pangkat 2, > 2x jumlah setting supaya seed cepat ketemu
+#define CTRL_MAX_PAIRS  (CAM_CONTROL_MAX_ITEMS + 8)
+#define CTRL_OUT_MAX    1536
+
+// ---------- tabel setting ----------
+enum {
+  CTRL_FRAMESIZE,
+  CTRL_QUALITY,
+  CTRL_ABR,
+  CTRL_CONTRAST,
+  CTRL_BRIGHTNESS,
+  CTRL_SATURATION,
+  CTRL_GAINCEILING,
+  CTRL_COLORBAR,
+  CTRL_AWB,
+  CTRL_AGC,
+  CTRL_AEC,
+  CTRL_HMIRROR,
+  CTRL_VFLIP,
+  CTRL_AWB_GAIN,
+  CTRL_AGC_GAIN,
+  CTRL_AEC_VALUE,
+  CTRL_AEC2,
+  CTRL_DCW,
+  CTRL_BPC,
+  CTRL_WPC,
+  CTRL_RAW_GMA,
+  CTRL_LENC,
+  CTRL_SPECIAL_EFFECT,
+  CTRL_WB_MODE,
+  CTRL_AE_LEVEL,
+  CTRL_LED_INTENSITY,
+  CTRL_COUNT
+};
+
+typedef struct {
+  const char *name;
+  int16_t min;
+  int16_t max;
+} ctrl_def_t;
+
+// urutan harus sama dengan enum di atas
+static constexpr ctrl_def_t _ctrl_defs[CTRL_COUNT] = {
+  {"framesize", 0, FRAMESIZE_INVALID - 1},
+  {"quality", 0, 63},
+  {"abr", 0, 1},
+  {"contrast", -3, 3},
+  {"brightness", -3, 3},
+  {"saturation", -3, 3},
+  {"gainceiling", 0, GAINCEILING_128X},
+  {"colorbar", 0, 1},
+  {"awb", 0, 1},
+  {"agc", 0, 1},
+  {"aec", 0, 1},
+  {"hmirror", 0, 1},
+  {"vflip", 0, 1},
+  {"awb_gain", 0, 1},
+  {"agc_gain", 0, 30},
+  {"aec_value", 0, 1200},
+  {"aec2", 0, 1},
+  {"dcw", 0, 1},
+  {"bpc", 0, 1},
+  {"wpc", 0, 1},
+  {"raw_gma", 0, 1},
+  {"lenc", 0, 1},
+  {"special_effect", 0, 6},
+  {"wb_mode", 0, 4},
+  {"ae_level", -5, 5},
+  {"led_intensity", 0, 255},
+};
+
+// ---------- perfect hash (disusun compiler) ----------
+// FNV-1a dengan seed; seed pertama yang membuat semua nama jatuh di slot
+// berbeda dicari saat compile, jadi menambah setting cukup di tabel di atas.
+static constexpr size_t ctrl_strlen(const char *s) {
+  size_t n = 0;
+  while (s[n]) {
+    n++;
+  }
+  return n;
+}
+
+static constexpr uint32_t ctrl_hash(uint32_t seed, const char *s, size_t len) {
+  uint32_t h = 2166136261u ^ seed;
+  for (size_t i = 0; i < len; i++) {
+    h = (h ^ (uint8_t)s[i]) * 16777619u;
+  }
+  return (h ^ (h >> 16)) & (CTRL_HASH_SLOTS - 1);
+}
+
+typedef struct {
+  uint32_t seed;
+  uint8_t slot[CTRL_HASH_SLOTS];  // indeks _ctrl_defs, 0xFF = kosong
+} ctrl_phash_t;
+
+static constexpr ctrl_phash_t ctrl_phash_build() {
+  ctrl_phash_t t{};
+  for (uint32_t seed = 1; seed < 100000; seed++) {
+    uint64_t used = 0;
+    bool ok = true;
+    for (int i = 0; i < CTRL_COUNT && ok; i++) {
+      uint32_t k = ctrl_hash(seed, _ctrl_defs[i].name, ctrl_strlen(_ctrl_defs[i].name));
+      ok = !((used >> k) & 1);
+      used |= 1ull << k;
+    }
+    if (ok) {
+      t.seed = seed;
+      for (int k = 0; k < CTRL_HASH_SLOTS; k++) {
+        t.slot[k] = 0xFF;
+      }
+      for (int i = 0; i < CTRL_COUNT; i++) {
+        t.slot[ctrl_hash(seed, _ctrl_defs[i].name, ctrl_strlen(_ctrl_defs[i].name))] = (uint8_t)i;
+      }
+      return t;
+    }
+  }
+  return t;
+}
+
+static constexpr ctrl_phash_t _ctrl_phash = ctrl_phash_build();
+static_assert(_ctrl_phash.seed != 0, "no perfect hash seed for control table, raise CTRL_HASH_SLOTS");
+static_assert(CTRL_COUNT <= CAM_CONTROL_MAX_ITEMS, "batch must fit every setting");
+
+int cam_control_lookup(const char *name, size_t len) {
+  int i = _ctrl_phash.slot[ctrl_hash(_ctrl_phash.seed, name, len)];
+  if (i == 0xFF || strncmp(_ctrl_defs[i].name, name, len) != 0 || _ctrl_defs[i].name[len] != '\0') {
+    return -1;
+  }
+  return i;
+}
+
+// ---------- batch ----------
+typedef enum {
+  CTRL_RES_OK,
+  CTRL_RES_SKIPPED,  // valid, tapi batch ditolak karena setting lain
+  CTRL_RES_SAVED,
+  CTRL_RES_UNKNOWN,
+  CTRL_RES_BAD_VALUE,
+  CTRL_RES_RANGE,
+  CTRL_RES_UNSUPPORTED,
+  CTRL_RES_FAILED,   // setter sensor mengembalikan error
+} ctrl_res_t;
+
+static const char *const _ctrl_res_names[] = {"ok", "skipped", "saved", "unknown", "bad_value", "out_of_range", "unsupported", "failed"};
+
+typedef struct {
+  const char *key;
+  const char *val;
+  uint16_t klen;
+  uint16_t vlen;
+} ctrl_pair_t;
+
+typedef struct {
+  const char *name;  // menunjuk ke input (nama tidak dikenal dilaporkan apa adanya)
+  uint8_t name_len;
+  int8_t id;
+  uint8_t res;
+  int32_t val;
+} ctrl_item_t;
+
+typedef struct {
+  int n;
+  bool overflow;
+  ctrl_item_t items[CAM_CONTROL_MAX_ITEMS];
+} ctrl_batch_t;
+
+typedef struct {
+  char in[CAM_CONTROL_BODY_MAX + 1];
+  char preset[CAM_CONTROL_BODY_MAX + 1];  // string preset dari NVS (format query)
+  ctrl_pair_t pairs[CTRL_MAX_PAIRS];
+  ctrl_pair_t preset_pairs[CTRL_MAX_PAIRS];
+  ctrl_batch_t batch;
+  char out[CTRL_OUT_MAX];
+} ctrl_req_t;
+
+static cam_control_led_t _ctrl_led = NULL;
+
+void cam_control_begin(cam_control_led_t led) {
+  _ctrl_led = led;
+}
+
+static bool ctrl_parse_int(const char *s, size_t len, int32_t *out) {
+  if (len == 4 && !memcmp(s, "true", 4)) {
+    *out = 1;
+    return true;
+  }
+  if (len == 5 && !memcmp(s, "false", 5)) {
+    *out = 0;
+    return true;
+  }
+  size_t i = 0;
+  bool neg = len > 0 && s[0] == '-';
+  i += neg;
+  if (i == len || len - i > 6) {
+    return false;
+  }
+  int32_t v = 0;
+  for (; i < len; i++) {
+    if (s[i] < '0' || s[i] > '9') {
+      return false;
+    }
+    v = v * 10 + (s[i] - '0');
+  }
+  *out = neg ? -v : v;
+  return true;
+}
+
+static void ctrl_batch_add(ctrl_batch_t *b, const char *key, size_t klen, const char *val, size_t vlen) {
+  int id = cam_control_lookup(key, klen);
+  ctrl_item_t *it = NULL;
+  for (int i = 0; id >= 0 && i < b->n; i++) {
+    if (b->items[i].id == id) {
+      it = &b->items[i];  // setting sama dua kali: yang terakhir menang
+      break;
+    }
+  }
+  if (!it) {
+    if (b->n == CAM_CONTROL_MAX_ITEMS) {
+      b->overflow = true;
+      return;
+    }
+    it = &b->items[b->n++];
+  }
+  it->name = key;
+  it->name_len = klen > 32 ? 32 : klen;
+  it->id = id;
+  it->res = CTRL_RES_SKIPPED;
+  if (id < 0) {
+    it->res = CTRL_RES_UNKNOWN;
+  } else if (!ctrl_parse_int(val, vlen, &it->val)) {
+    it->res = CTRL_RES_BAD_VALUE;
+  } else if (it->val < _ctrl_defs[id].min || it->val > _ctrl_defs[id].max) {
+    it->res = CTRL_RES_RANGE;
+  }
+}
+
+// Return false kalau ada setting yang tidak bisa diterapkan; batch tidak dijalankan.
+static bool ctrl_batch_validate(ctrl_batch_t *b) {
+  sensor_t *s = esp_camera_sensor_get();
+  bool ok = !b->overflow && b->n > 0;
+  for (int i = 0; i < b->n; i++) {
+    ctrl_item_t *it = &b->items[i];
+    if (it->res == CTRL_RES_SKIPPED) {
+      if ((it->id == CTRL_LED_INTENSITY && !_ctrl_led) || (it->id == CTRL_FRAMESIZE && (!s || s->pixformat != PIXFORMAT_JPEG))) {
+        it->res = CTRL_RES_UNSUPPORTED;
+      } else if (it->id != CTRL_ABR && it->id != CTRL_LED_INTENSITY && !s) {
+        it->res = CTRL_RES_UNSUPPORTED;
+      }
+    }
+    ok = ok && it->res == CTRL_RES_SKIPPED;
+  }
+  return ok;
+}
+
+static int ctrl_set(sensor_t *s, int id, int v) {
+  switch (id) {
+    case CTRL_FRAMESIZE:      return s->set_framesize(s, (framesize_t)v);
+    case CTRL_QUALITY:        return s->set_quality(s, v);
+    case CTRL_ABR:            cam_abr_set_enabled(v); return 0;
+    case CTRL_CONTRAST:       return s->set_contrast(s, v);
+    case CTRL_BRIGHTNESS:     return s->set_brightness(s, v);
+    case CTRL_SATURATION:     return s->set_saturation(s, v);
+    case CTRL_GAINCEILING:    return s->set_gainceiling(s, (gainceiling_t)v);
+    case CTRL_COLORBAR:       return s->set_colorbar(s, v);
+    case CTRL_AWB:            return s->set_whitebal(s, v);
+    case CTRL_AGC:            return s->set_gain_ctrl(s, v);
+    case CTRL_AEC:            return s->set_exposure_ctrl(s, v);
+    case CTRL_HMIRROR:        return s->set_hmirror(s, v);
+    case CTRL_VFLIP:          return s->set_vflip(s, v);
+    case CTRL_AWB_GAIN:       return s->set_awb_gain(s, v);
+    case CTRL_AGC_GAIN:       return s->set_agc_gain(s, v);
+    case CTRL_AEC_VALUE:      return s->set_aec_value(s, v);
+    case CTRL_AEC2:           return s->set_aec2(s, v);
+    case CTRL_DCW:            return s->set_dcw(s, v);
+    case CTRL_BPC:            return s->set_bpc(s, v);
+    case CTRL_WPC:            return s->set_wpc(s, v);
+    case CTRL_RAW_GMA:        return s->set_raw_gma(s, v);
+    case CTRL_LENC:           return s->set_lenc(s, v);
+    case CTRL_SPECIAL_EFFECT: return s->set_special_effect(s, v);
+    case CTRL_WB_MODE:        return s->set_wb_mode(s, v);
+    case CTRL_AE_LEVEL:       return s->set_ae_level(s, v);
+    case CTRL_LED_INTENSITY:  _ctrl_led(v); return 0;
+  }
+  return -1;
+}
+
+// Jalan di task capture (cam_bcast_between_frames): tidak ada frame yang dipegang.
+static void ctrl_apply_job(void *arg) {
+  ctrl_batch_t *b = (ctrl_batch_t *)arg;
+  sensor_t *s = esp_camera_sensor_get();
+  bool reseed = false;
+  for (int i = 0; i < b->n; i++) {
+    ctrl_item_t *it = &b->items[i];
+    it->res = ctrl_set(s, it->id, it->val) < 0 ? CTRL_RES_FAILED : CTRL_RES_OK;
+    reseed |= it->id == CTRL_FRAMESIZE || it->id == CTRL_QUALITY;
+    log_i("%s = %d", _ctrl_defs[it->id].name, (int)it->val);
+  }
+  if (reseed) {
+    cam_abr_reseed();
+  }
+  cam_status_invalidate();  // setter sensor bisa menulis banyak register
+}
+
+static bool ctrl_batch_apply(ctrl_batch_t *b) {
+  cam_bcast_between_frames(ctrl_apply_job, b);
+  for (int i = 0; i < b->n; i++) {
+    if (b->items[i].res != CTRL_RES_OK) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// ---------- input ----------
+// "k=v&k2=v2" (query atau string preset). Return jumlah pasangan, -1 kalau kebanyakan.
+static int ctrl_pairs_query(const char *p, ctrl_pair_t *pairs, int max) {
+  int n = 0;
+  while (*p) {
+    const char *end = strchr(p, '&');
+    size_t len = end ? (size_t)(end - p) : strlen(p);
+    if (len > 0) {
+      if (n == max) {
+        return -1;
+      }
+      const char *eq = (const char *)memchr(p, '=', len);
+      pairs[n].key = p;
+      pairs[n].klen = eq ? eq - p : len;
+      pairs[n].val = eq ? eq + 1 : p + len;
+      pairs[n].vlen = eq ? len - (eq + 1 - p) : 0;
+      n++;
+    }
+    p += len + (end ? 1 : 0);
+  }
+  return n;
+}
+
+static const char *ctrl_skip_ws(const char *p, const char *end) {
+  while (p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')) {
+    p++;
+  }
+  return p;
+}
+
+// {"k":1,"k2":"teks",...}: objek datar, string tanpa escape. -1 kalau tidak valid.
+static int ctrl_pairs_json(const char *p, const char *end, ctrl_pair_t *pairs, int max) {
+  int n = 0;
+  p = ctrl_skip_ws(p, end);
+  if (p == end || *p++ != '{') {
+    return -1;
+  }
+  for (;;) {
+    p = ctrl_skip_ws(p, end);
+    if (p < end && *p == '}' && n == 0) {
+      return 0;
+    }
+    if (p == end || *p++ != '"' || n == max) {
+      return -1;
+    }
+    const char *key = p;
+    while (p < end && *p != '"' && *p != '\\') {
+      p++;
+    }
+    if (p == end || *p != '"') {
+      return -1;
+    }
+    pairs[n].key = key;
+    pairs[n].klen = p++ - key;
+    p = ctrl_skip_ws(p, end);
+    if (p == end || *p++ != ':') {
+      return -1;
+    }
+    p = ctrl_skip_ws(p, end);
+    if (p < end && *p == '"') {
+      const char *val = ++p;
+      while (p < end && *p != '"' && *p != '\\') {
+        p++;
+      }
+      if (p == end || *p != '"') {
+        return -1;
+      }
+      pairs[n].val = val;
+      pairs[n].vlen = p++ - val;
+    } else {
+      const char *val = p;
+      while (p < end && (*p == '-' || (*p >= '0' && *p <= '9') || (*p >= 'a' && *p <= 'z'))) {
+        p++;
+      }
+      pairs[n].val = val;
+      pairs[n].vlen = p - val;
+    }
+    n++;
+    p = ctrl_skip_ws(p, end);
+    if (p < end && *p == ',') {
+      p++;
+    } else if (p < end && *p == '}') {
+      return n;
+    } else {
+      return -1;
+    }
+  }
+}
+
+static bool ctrl_key_is(const ctrl_pair_t *pr, const char *key) {
+  size_t len = strlen(key);
+  return pr->klen == len && !memcmp(pr->key, key, len);
+}
+
+// Nama preset = key NVS: 1..15 karakter [A-Za-z0-9_-].
+static bool ctrl_copy_name(const ctrl_pair_t *pr, char *out) {
+  if (pr->vlen == 0 || pr->vlen > CAM_CONTROL_NAME_MAX) {
+    return false;
+  }
+  for (size_t i = 0; i < pr->vlen; i++) {
+    char c = pr->val[i];
+    if (!((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_' || c == '-')) {
+      return false;
+    }
+    out[i] = c;
+  }
+  out[pr->vlen] = '\0';
+  return true;
+}
+
+// ---------- preset NVS ----------
+static esp_err_t ctrl_preset_load(const char *name, char *out, size_t cap) {
+  nvs_handle_t h;
+  esp_err_t err = nvs_open(CTRL_NVS_NS, NVS_READONLY, &h);
+  if (err != ESP_OK) {
+    return err;
+  }
+  size_t len = cap;
+  err = nvs_get_str(h, name, out, &len);
+  nvs_close(h);
+  return err;
+}
+
+// Hanya setting valid, dengan nama dari tabel (bukan dari input).
+static esp_err_t ctrl_preset_save(const char *name, const ctrl_batch_t *b, char *tmp, size_t cap) {
+  char *p = tmp;
+  for (int i = 0; i < b->n; i++) {
+    p += snprintf(p, cap - (p - tmp), "%s%s=%d", i ? "&" : "", _ctrl_defs[b->items[i].id].name, (int)b->items[i].val);
+  }
+  nvs_handle_t h;
+  esp_err_t err = nvs_open(CTRL_NVS_NS, NVS_READWRITE, &h);
+  if (err != ESP_OK) {
+    return err;
+  }
+  err = nvs_set_str(h, name, tmp);
+  if (err == ESP_OK) {
+    err = nvs_commit(h);
+  }
+  nvs_close(h);
+  return err;
+}
+
+static esp_err_t ctrl_preset_delete(const char *name) {
+  nvs_handle_t h;
+  esp_err_t err = nvs_open(CTRL_NVS_NS, NVS_READWRITE, &h);
+  if (err != ESP_OK) {
+    return err;
+  }
+  err = nvs_erase_key(h, name);
+  if (err == ESP_OK) {
+    err = nvs_commit(h);
+  }
+  nvs_close(h);
+  return err;
+}
+
+static int ctrl_preset_list(char *out, size_t cap) {
+  char *p = out;
+  p += snprintf(p, cap, "{\"presets\":[");
+  nvs_iterator_t it = NULL;
+  esp_err_t err = nvs_entry_find(NVS_DEFAULT_PART_NAME, CTRL_NVS_NS, NVS_TYPE_STR, &it);
+  bool first = true;
+  while (err == ESP_OK && (size_t)(p - out) + NVS_KEY_NAME_MAX_SIZE + 8 < cap) {
+    nvs_entry_info_t info;
+    nvs_entry_info(it, &info);
+    p += sprintf(p, "%s\"%s\"", first ? "" : ",", info.key);
+    first = false;
+    err = nvs_entry_next(&it);
+  }
+  nvs_release_iterator(it);
+  p += sprintf(p, "]}");
+  return p - out;
+}
+
+// ---------- respons ----------
+static int ctrl_print_results(char *out, size_t cap, bool ok, const char *preset, const ctrl_batch_t *b) {
+  char *p = out;
+  char *limit = out + cap - 64;
+  p += sprintf(p, "{\"ok\":%s", ok ? "true" : "false");
+  if (preset) {
+    p += sprintf(p, ",\"preset\":\"%s\"", preset);
+  }
+  if (b->overflow) {
+    p += sprintf(p, ",\"error\":\"too many settings\"");
+  }
+  p += sprintf(p, ",\"results\":{");
+  for (int i = 0; i < b->n && p < limit; i++) {
+    const ctrl_item_t *it = &b->items[i];
+    p += sprintf(p, "%s\"", i ? "," : "");
+    for (int k = 0; k < it->name_len; k++) {
+      char c = it->name[k];
+      *p++ = (c == '"' || c == '\\' || (uint8_t)c < 0x20) ? '_' : c;  // nama dari input
+    }
+    p += sprintf(p, "\":\"%s\"", _ctrl_res_names[it->res]);
+  }
+  p += sprintf(p, "}}");
+  return p - out;
+}
+
+static esp_err_t ctrl_send(httpd_req_t *req, const char *status, const char *json, int len) {
+  httpd_resp_set_status(req, status);
+  httpd_resp_set_type(req, "application/json");
+  httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
+  return httpd_resp_send(req, json, len);
+}
+
+bool cam_control_apply_preset(const char *name) {
+  ctrl_req_t *r = (ctrl_req_t *)calloc(1, sizeof(ctrl_req_t));
+  if (!r) {
+    return false;
+  }
+  bool ok = false;
+  if (ctrl_preset_load(name, r->preset, sizeof(r->preset)) == ESP_OK) {
+    int n = ctrl_pairs_query(r->preset, r->preset_pairs, CTRL_MAX_PAIRS);
+    for (int i = 0; i < n; i++) {
+      ctrl_batch_add(&r->batch, r->preset_pairs[i].key, r->preset_pairs[i].klen, r->preset_pairs[i].val, r->preset_pairs[i].vlen);
+    }
+    ok = n > 0 && ctrl_batch_validate(&r->batch) && ctrl_batch_apply(&r->batch);
+  }
+  log_i("Preset %s: %s", name, ok ? "applied" : "failed");
+  free(r);
+  return ok;
+}
+
+static esp_err_t ctrl_read_input(httpd_req_t *req, ctrl_req_t *r, int *n) {
+  if (req->method == HTTP_POST) {
+    if (req->content_len == 0 || req->content_len > CAM_CONTROL_BODY_MAX) {
+      return ESP_ERR_INVALID_ARG;
+    }
+    size_t got = 0;
+    while (got < req->content_len) {
+      int ret = httpd_req_recv(req, r->in + got, req->content_len - got);
+      if (ret <= 0) {
+        return ESP_FAIL;
+      }
+      got += ret;
+    }
+    r->in[got] = '\0';
+    *n = ctrl_pairs_json(r->in, r->in + got, r->pairs, CTRL_MAX_PAIRS);
+  } else {
+    size_t len = httpd_req_get_url_query_len(req);
+    if (len == 0 || len > CAM_CONTROL_BODY_MAX || httpd_req_get_url_query_str(req, r->in, sizeof(r->in)) != ESP_OK) {
+      return ESP_ERR_INVALID_ARG;
+    }
+    *n = ctrl_pairs_query(r->in, r->pairs, CTRL_MAX_PAIRS);
+  }
+  return *n < 0 ? ESP_ERR_INVALID_ARG : ESP_OK;
+}
+
+esp_err_t cam_control_handler(httpd_req_t *req) {
+  ctrl_req_t *r = (ctrl_req_t *)calloc(1, sizeof(ctrl_req_t));
+  if (!r) {
+    return httpd_resp_send_500(req);
+  }
+  esp_err_t res;
+  int n = 0;
+  esp_err_t err = ctrl_read_input(req, r, &n);
+  if (err != ESP_OK) {
+    free(r);
+    if (err == ESP_FAIL) {
+      return ESP_FAIL;  // koneksi putus saat baca body
+    }
+    return ctrl_send(req, HTTPD_400, "{\"ok\":false,\"error\":\"bad request\"}", HTTPD_RESP_USE_STRLEN);
+  }
+
+  // opsi dulu, setting belakangan supaya override preset tidak bergantung urutan
+  char preset[CAM_CONTROL_NAME_MAX + 1] = "";
+  char save[CAM_CONTROL_NAME_MAX + 1] = "";
+  char del[CAM_CONTROL_NAME_MAX + 1] = "";
+  const ctrl_pair_t *var = NULL, *val = NULL;
+  bool list = false, bad_name = false;
+  for (int i = 0; i < n; i++) {
+    const ctrl_pair_t *pr = &r->pairs[i];
+    if (ctrl_key_is(pr, "preset")) {
+      bad_name |= !ctrl_copy_name(pr, preset);
+    } else if (ctrl_key_is(pr, "save")) {
+      bad_name |= !ctrl_copy_name(pr, save);
+    } else if (ctrl_key_is(pr, "delete")) {
+      bad_name |= !ctrl_copy_name(pr, del);
+    } else if (ctrl_key_is(pr, "list")) {
+      list = true;
+    } else if (ctrl_key_is(pr, "var")) {
+      var = pr;
+    } else if (ctrl_key_is(pr, "val")) {
+      val = pr;
+    }
+  }
+
+  if (bad_name) {
+    res = ctrl_send(req, HTTPD_400, "{\"ok\":false,\"error\":\"preset name must be 1-15 chars [A-Za-z0-9_-]\"}", HTTPD_RESP_USE_STRLEN);
+  } else if (list) {
+    int len = ctrl_preset_list(r->out, sizeof(r->out));
+    res = ctrl_send(req, HTTPD_200, r->out, len);
+  } else if (del[0]) {
+    err = ctrl_preset_delete(del);
+    int len = snprintf(r->out, sizeof(r->out), "{\"ok\":%s,\"deleted\":\"%s\"}", err == ESP_OK ? "true" : "false", del);
+    res = ctrl_send(req, err == ESP_OK ? HTTPD_200 : HTTPD_404, r->out, len);
+  } else if (preset[0] && ctrl_preset_load(preset, r->preset, sizeof(r->preset)) != ESP_OK) {
+    int len = snprintf(r->out, sizeof(r->out), "{\"ok\":false,\"error\":\"preset not found\",\"preset\":\"%s\"}", preset);
+    res = ctrl_send(req, HTTPD_404, r->out, len);
+  } else {
+    ctrl_batch_t *b = &r->batch;
+    if (preset[0]) {
+      int pn = ctrl_pairs_query(r->preset, r->preset_pairs, CTRL_MAX_PAIRS);
+      for (int i = 0; i < pn; i++) {
+        ctrl_batch_add(b, r->preset_pairs[i].key, r->preset_pairs[i].klen, r->preset_pairs[i].val, r->preset_pairs[i].vlen);
+      }
+    }
+    for (int i = 0; i < n; i++) {
+      const ctrl_pair_t *pr = &r->pairs[i];
+      if (pr == var) {
+        if (val) {
+          ctrl_batch_add(b, var->val, var->vlen, val->val, val->vlen);  // bentuk lama var/val
+        }
+      } else if (pr != val && !ctrl_key_is(pr, "preset") && !ctrl_key_is(pr, "save")) {
+        ctrl_batch_add(b, pr->key, pr->klen, pr->val, pr->vlen);
+      }
+    }
+
+    const char *status = HTTPD_200;
+    bool ok = ctrl_batch_validate(b);
+    if (!ok) {
+      status = HTTPD_400;  // tidak ada yang diterapkan
+    } else if (save[0]) {
+      ok = ctrl_preset_save(save, b, r->out, sizeof(r->out)) == ESP_OK;
+      for (int i = 0; ok && i < b->n; i++) {
+        b->items[i].res = CTRL_RES_SAVED;
+      }
+      status = ok ? HTTPD_200 : HTTPD_500;
+    } else if (!ctrl_batch_apply(b)) {
+      ok = false;
+      status = HTTPD_500;  // sebagian setter gagal, lihat results
+    }
+    int len = ctrl_print_results(r->out, sizeof(r->out), ok, save[0] ? save : (preset[0] ? preset : NULL), b);
+    res = ctrl_send(req, status, r->out, len);
+  }
+  free(r);
+  return res;
+}
@@ -0,0 +1,31 @@
+#pragma once
+// Batch /control: banyak setting sensor dalam satu request, diterapkan
+// sekaligus di antara dua frame, plus preset bernama di NVS.
+//
+//   GET  /control?agc=0&aec=0&gainceiling=6&brightness=1&led_intensity=64
+//   GET  /control?var=agc&val=0                  (bentuk lama, satu setting)
+//   POST /control  {"agc":0,"aec":0,"brightness":1}
+//   GET  /control?preset=night[&brightness=2]    terapkan preset (+ override)
+//   GET  /control?save=night&agc=0&aec=0...      simpan ke NVS, tidak diterapkan
+//   GET  /control?delete=night   /control?list=1
+//
+// Nama setting dicari lewat tabel perfect hash yang disusun saat compile
+// (satu hash + satu memcmp, bukan rantai strcmp). Semua setting divalidasi
+// dulu (nama, angka, rentang); kalau satu saja gagal tidak ada yang
+// diterapkan (400). Batch yang valid dijalankan oleh task capture lewat
+// cam_bcast_between_frames(), dan frame yang mungkin setengah jadi dibuang.
+// Respons: {"ok":true,"results":{"agc":"ok","aec":"ok",...}}.
+#include <stddef.h>
+#include "esp_http_server.h"
+
+#define CAM_CONTROL_MAX_ITEMS 32
+#define CAM_CONTROL_BODY_MAX  1024
+#define CAM_CONTROL_NAME_MAX  15  // batas panjang key NVS
+
+// led_intensity diteruskan ke sini (NULL = tidak didukung).
+typedef void (*cam_control_led_t)(int duty);
+
+void cam_control_begin(cam_control_led_t led);
+int cam_control_lookup(const char *name, size_t len);  // id setting, -1 kalau tidak dikenal
+bool cam_control_apply_preset(const char *name);       // mis. dari setup()
+esp_err_t cam_control_handler(httpd_req_t *req);       // daftarkan untuk GET dan POST
@@ -0,0 +1,187 @@
+#include "cam_metrics.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include "esp_heap_caps.h"
+#include "esp_timer.h"
+#include "cam_broadcast.h"
+#include "stream_hist.h"
+
+#define METRICS_BUF_MAX 12288
+
+typedef struct {
+  uint32_t frames;
+  uint32_t dropped;
+  uint64_t bytes;
+} metrics_client_t;
+
+static const char *const _metrics_stage_names[CAM_STAGE_COUNT] = {"capture", "jpeg", "wait", "prefix", "send",
+                                                                        "audio_convert", "audio_encode"};
+
+// Diinisialisasi statis (bukan lewat begin) supaya observasi dari task
+// capture aman sejak frame pertama.
+#define METRICS_LATENCY_HIST {HIST_LATENCY_US, HIST_LATENCY_US_COUNT, {0}, 0}
+static hist_t _metrics_stage[CAM_STAGE_COUNT] = {
+  METRICS_LATENCY_HIST, METRICS_LATENCY_HIST, METRICS_LATENCY_HIST, METRICS_LATENCY_HIST, METRICS_LATENCY_HIST,
+  METRICS_LATENCY_HIST, METRICS_LATENCY_HIST,
+};
+static hist_t _metrics_frame = {HIST_FRAME_BYTES, HIST_FRAME_BYTES_COUNT, {0}, 0};
+static metrics_client_t _metrics_clients[CAM_BCAST_MAX_CLIENTS];
+
+void cam_metrics_stage(cam_stage_t stage, uint32_t us) {
+  if (stage < CAM_STAGE_COUNT) {
+    hist_observe(&_metrics_stage[stage], us);
+  }
+}
+
+void cam_metrics_frame(size_t bytes) {
+  hist_observe(&_metrics_frame, (uint32_t)bytes);
+}
+
+void cam_metrics_sent(int client, uint32_t prefix_us, uint32_t send_us, size_t bytes, uint32_t dropped) {
+  hist_observe(&_metrics_stage[CAM_STAGE_PREFIX], prefix_us);
+  hist_observe(&_metrics_stage[CAM_STAGE_SEND], send_us);
+  if (client < 0 || client >= CAM_BCAST_MAX_CLIENTS) {
+    return;
+  }
+  metrics_client_t *c = &_metrics_clients[client];
+  __atomic_fetch_add(&c->frames, 1, __ATOMIC_RELAXED);
+  __atomic_fetch_add(&c->dropped, dropped, __ATOMIC_RELAXED);
+  __atomic_fetch_add(&c->bytes, (uint64_t)bytes, __ATOMIC_RELAXED);
+}
+
+// Tambah teks ke buffer; berhenti menulis (tapi tetap aman) kalau penuh.
+static void metrics_append(char *buf, size_t *len, bool *full, const char *fmt, ...) __attribute__((format(printf, 4, 5)));
+static void metrics_append(char *buf, size_t *len, bool *full, const char *fmt, ...) {
+  if (*full) {
+    return;
+  }
+  va_list ap;
+  va_start(ap, fmt);
+  int n = vsnprintf(buf + *len, METRICS_BUF_MAX - *len, fmt, ap);
+  va_end(ap);
+  if (n < 0 || (size_t)n >= METRICS_BUF_MAX - *len) {
+    *full = true;
+    return;
+  }
+  *len += n;
+}
+
+static void metrics_hist(char *buf, size_t *len, bool *full, const char *name, const char *labels, const hist_t *h, double scale) {
+  if (*full) {
+    return;
+  }
+  int n = hist_print_prom(buf + *len, METRICS_BUF_MAX - *len, name, labels, h, scale);
+  if (n < 0) {
+    *full = true;
+    return;
+  }
+  *len += n;
+}
+
+esp_err_t cam_metrics_handler(httpd_req_t *req) {
+  char *buf = (char *)malloc(METRICS_BUF_MAX);
+  if (!buf) {
+    return httpd_resp_send_500(req);
+  }
+  size_t len = 0;
+  bool full = false;
+  char labels[32];
+
+  metrics_append(buf, &len, &full, "# HELP bobobee_stage_seconds Camera and audio pipeline stage latency.\n# TYPE bobobee_stage_seconds histogram\n");
+  for (int i = 0; i < CAM_STAGE_COUNT; i++) {
+    snprintf(labels, sizeof(labels), "stage=\"%s\"", _metrics_stage_names[i]);
+    metrics_hist(buf, &len, &full, "bobobee_stage_seconds", labels, &_metrics_stage[i], 1e-6);
+  }
+  metrics_append(buf, &len, &full, "# HELP bobobee_frame_bytes Captured JPEG frame size.\n# TYPE bobobee_frame_bytes histogram\n");
+  metrics_hist(buf, &len, &full, "bobobee_frame_bytes", NULL, &_metrics_frame, 1);
+
+  cam_bcast_stats_t st;
+  cam_bcast_get_stats(&st);
+  metrics_append(
+    buf, &len, &full,
+    "# HELP bobobee_frames_captured_total Frames taken from the camera driver.\n# TYPE bobobee_frames_captured_total counter\n"
+    "bobobee_frames_captured_total %u\n"
+    "# HELP bobobee_capture_failed_total esp_camera_fb_get failures.\n# TYPE bobobee_capture_failed_total counter\n"
+    "bobobee_capture_failed_total %u\n"
+    "# HELP bobobee_pool_exhausted_total Frames dropped because the broadcast pool was full.\n# TYPE bobobee_pool_exhausted_total counter\n"
+    "bobobee_pool_exhausted_total %u\n"
+    "# HELP bobobee_settle_skipped_total Frames dropped after a /control batch.\n# TYPE bobobee_settle_skipped_total counter\n"
+    "bobobee_settle_skipped_total %u\n"
+    "# HELP bobobee_frame_allocs_total Broadcast pool buffer (re)allocations; flat in steady state.\n# TYPE bobobee_frame_allocs_total counter\n"
+    "bobobee_frame_allocs_total %u\n"
+    "# HELP bobobee_encode_overflows_total Non-JPEG frames re-encoded because the pool buffer was short.\n# TYPE bobobee_encode_overflows_total counter\n"
+    "bobobee_encode_overflows_total %u\n"
+    "# HELP bobobee_scene_changes_total Scene changes seen by the frame gate.\n# TYPE bobobee_scene_changes_total counter\n"
+    "bobobee_scene_changes_total %u\n"
+    "# HELP bobobee_stream_clients Subscribed stream clients.\n# TYPE bobobee_stream_clients gauge\n"
+    "bobobee_stream_clients %d\n"
+    "# HELP bobobee_uptime_seconds Time since boot.\n# TYPE bobobee_uptime_seconds gauge\n"
+    "bobobee_uptime_seconds %.3f\n",
+    (unsigned)st.captured, (unsigned)st.capture_failed, (unsigned)st.pool_exhausted, (unsigned)st.settle_skipped, (unsigned)st.allocs,
+    (unsigned)st.encode_overflows, (unsigned)st.scene_changes,
+    st.clients, esp_timer_get_time() / 1e6
+  );
+
+  // heap: untuk soak test (tools/load_gen) — fragmentasi terlihat dari largest_block
+  static const struct {
+    const char *name;
+    uint32_t caps;
+  } regions[2] = {{"internal", MALLOC_CAP_INTERNAL}, {"psram", MALLOC_CAP_SPIRAM}};
+  metrics_append(buf, &len, &full, "# HELP bobobee_heap_free_bytes Free heap.\n# TYPE bobobee_heap_free_bytes gauge\n");
+  for (int i = 0; i < 2; i++) {
+    metrics_append(buf, &len, &full, "bobobee_heap_free_bytes{region=\"%s\"} %u\n", regions[i].name, (unsigned)heap_caps_get_free_size(regions[i].caps));
+  }
+  metrics_append(buf, &len, &full, "# HELP bobobee_heap_min_free_bytes Lowest free heap since boot.\n# TYPE bobobee_heap_min_free_bytes gauge\n");
+  for (int i = 0; i < 2; i++) {
+    metrics_append(buf, &len, &full, "bobobee_heap_min_free_bytes{region=\"%s\"} %u\n", regions[i].name,
+                   (unsigned)heap_caps_get_minimum_free_size(regions[i].caps));
+  }
+  metrics_append(buf, &len, &full, "# HELP bobobee_heap_largest_block_bytes Largest allocatable block.\n# TYPE bobobee_heap_largest_block_bytes gauge\n");
+  for (int i = 0; i < 2; i++) {
+    metrics_append(buf, &len, &full, "bobobee_heap_largest_block_bytes{region=\"%s\"} %u\n", regions[i].name,
+                   (unsigned)heap_caps_get_largest_free_block(regions[i].caps));
+  }
+
+  // counter per slot tidak di-reset saat slot dipakai klien baru (monoton untuk rate())
+  static const char *const families[3][2] = {
+    {"bobobee_client_frames_total", "Frames sent per stream slot."},
+    {"bobobee_client_bytes_total", "JPEG payload bytes sent per stream slot."},
+    {"bobobee_client_dropped_total", "Frames skipped because the client was still sending."},
+  };
+  for (int f = 0; f < 3; f++) {
+    metrics_append(buf, &len, &full, "# HELP %s %s\n# TYPE %s counter\n", families[f][0], families[f][1], families[f][0]);
+    for (int i = 0; i < CAM_BCAST_MAX_CLIENTS; i++) {
+      metrics_client_t *c = &_metrics_clients[i];
+      unsigned long long v = f == 0 ? __atomic_load_n(&c->frames, __ATOMIC_RELAXED)
+                             : f == 1 ? __atomic_load_n(&c->bytes, __ATOMIC_RELAXED)
+                                      : __atomic_load_n(&c->dropped, __ATOMIC_RELAXED);
+      metrics_append(buf, &len, &full, "%s{client=\"%d\"} %llu\n", families[f][0], i, v);
+    }
+  }
+
+  if (full) {
+    free(buf);
+    return httpd_resp_send_500(req);  // METRICS_BUF_MAX terlalu kecil
+  }
+  httpd_resp_set_type(req, "text/plain; version=0.0.4");
+  httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
+  esp_err_t res = httpd_resp_send(req, buf, len);
+  free(buf);
+  return res;
+}
+
+esp_err_t cam_clock_handler(httpd_req_t *req) {
+  httpd_resp_set_type(req, "application/json");
+  httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
+  httpd_resp_set_hdr(req, "Cache-Control", "no-store");
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  int64_t epoch_us = tv.tv_sec > 1600000000 ? (int64_t)tv.tv_sec * 1000000 + tv.tv_usec : 0;
+  // diambil sedekat mungkin dengan send: klien memakai titik tengah RTT
+  char json[64];
+  int n = snprintf(json, sizeof(json), "{\"uptime_us\":%lld,\"epoch_us\":%lld}", (long long)esp_timer_get_time(), (long long)epoch_us);
+  return httpd_resp_send(req, json, n);
+}
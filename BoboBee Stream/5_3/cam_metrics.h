@@ -0,0 +1,43 @@
+#pragma once
+// Telemetri pipeline kamera yang selalu aktif + endpoint Prometheus /metrics.
+//
+// Tahap (histogram bobobee_stage_seconds{stage=...}):
+//   capture  esp_camera_fb_get() di task capture (menunggu driver/DMA)
+//   jpeg     frame2jpg_cb untuk sensor non-JPEG
+//   wait     worker stream menunggu frame berikutnya dari broadcaster
+//   prefix   menyusun boundary + header part
+//   send     writev boundary/header + payload (satu syscall, lihat mjpeg_framing.h)
+//   audio_convert  I2S 32-bit -> PCM16 + gain satu blok (audio_pcm.h)
+//   audio_encode   encode satu blok I2S dengan codec audio WS selain PCM16
+//   (keduanya di AudioTask 5_3.ino; bandingkan dengan durasi blok untuk sisa CPU)
+// Ditambah distribusi ukuran frame, counter drop/gagal dari cam_broadcast
+// dan counter per slot klien (frame, byte, drop) untuk throughput lewat
+// rate() di Prometheus. Biaya per observasi: binary search + 2 atomic add.
+// Heap (free, minimum sejak boot, blok terbesar) per region internal/psram
+// dibaca saat scrape.
+//
+// /clock: jam device untuk tools/g2g_latency (offset jam host <-> device).
+//   {"uptime_us":N,"epoch_us":N}
+// uptime_us = esp_timer_get_time(), jam yang sama dengan fb->timestamp dan
+// X-Timestamp di /stream; epoch_us = gettimeofday() (0 kalau belum ada SNTP).
+#include <stdint.h>
+#include <stddef.h>
+#include "esp_http_server.h"
+
+typedef enum {
+  CAM_STAGE_CAPTURE,
+  CAM_STAGE_JPEG,
+  CAM_STAGE_WAIT,
+  CAM_STAGE_PREFIX,
+  CAM_STAGE_SEND,
+  CAM_STAGE_AUDIO_CONVERT,
+  CAM_STAGE_AUDIO_ENCODE,
+  CAM_STAGE_COUNT
+} cam_stage_t;
+
+void cam_metrics_stage(cam_stage_t stage, uint32_t us);
+void cam_metrics_frame(size_t bytes);  // tiap frame yang di-capture
+// Setelah satu frame terkirim ke klien (id slot broadcaster).
+void cam_metrics_sent(int client, uint32_t prefix_us, uint32_t send_us, size_t bytes, uint32_t dropped);
+esp_err_t cam_metrics_handler(httpd_req_t *req);
+esp_err_t cam_clock_handler(httpd_req_t *req);
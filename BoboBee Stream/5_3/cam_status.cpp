@@ -0,0 +1,230 @@
+#include "cam_status.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "esp_timer.h"
+#include "esp_random.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+#if defined(ARDUINO_ARCH_ESP32) && defined(CONFIG_ARDUHAL_ESP_LOG)
+#include "esp32-hal-log.h"
+#endif
+
+typedef struct {
+  uint16_t reg;
+  int mask;
+  int value;
+  int64_t read_us;  // 0 = basi
+  uint32_t gen;     // naik saat ditandai basi; baca yang tersalip tidak disimpan
+} status_reg_t;
+
+typedef struct {
+  int refs;
+  uint32_t version;
+  size_t len;
+  size_t body_off;  // isi setelah "{\"version\":N," (untuk dibandingkan)
+  char etag[24];
+  char *json;
+} status_snap_t;
+
+static portMUX_TYPE _status_mux = portMUX_INITIALIZER_UNLOCKED;
+static SemaphoreHandle_t _status_lock = NULL;  // build + shadow (SCCB, tidak boleh di critical section)
+static status_reg_t _status_regs[CAM_STATUS_MAX_REGS];
+static volatile int _status_nregs = 0;
+static cam_status_print_t _status_config = NULL;
+static cam_status_print_t _status_live = NULL;
+static status_snap_t *_status_snap = NULL;
+static volatile uint32_t _status_dirty = 1;  // naik setiap invalidasi
+static uint32_t _status_built = 0;           // nilai _status_dirty saat snapshot terakhir disusun
+static int64_t _status_built_us = 0;
+static uint32_t _status_boot = 0;
+static uint32_t _status_version = 0;
+static char _status_scratch[CAM_STATUS_JSON_MAX];
+
+bool cam_status_begin(cam_status_print_t config, cam_status_print_t live) {
+  if (!_status_lock) {
+    _status_lock = xSemaphoreCreateMutex();
+    if (!_status_lock) {
+      return false;
+    }
+    _status_boot = esp_random();  // ETag dari boot sebelumnya tidak boleh cocok
+  }
+  _status_config = config;
+  _status_live = live;
+  cam_status_invalidate();
+  return true;
+}
+
+static bool status_reg_live(int reg) {
+  return (reg >= 0x3400 && reg <= 0x3406) || (reg >= 0x3500 && reg <= 0x350d);
+}
+
+// jumlah byte register yang dibaca get_reg untuk mask ini
+static int status_reg_span(int mask) {
+  return mask > 0xFFFF ? 3 : mask > 0xFF ? 2 : 1;
+}
+
+int cam_status_reg(sensor_t *s, int reg, int mask) {
+  status_reg_t *e = NULL;
+  for (int i = 0; i < _status_nregs; i++) {
+    if (_status_regs[i].reg == reg && _status_regs[i].mask == mask) {
+      e = &_status_regs[i];
+      break;
+    }
+  }
+  if (!e && _status_nregs < CAM_STATUS_MAX_REGS) {
+    e = &_status_regs[_status_nregs];
+    memset(e, 0, sizeof(*e));
+    e->reg = reg;
+    e->mask = mask;
+    portENTER_CRITICAL(&_status_mux);
+    _status_nregs++;
+    portEXIT_CRITICAL(&_status_mux);
+  }
+  if (!e) {
+    return s->get_reg(s, reg, mask);  // shadow penuh: baca langsung
+  }
+
+  int64_t now = esp_timer_get_time();
+  if (e->read_us && !(status_reg_live(reg) && now - e->read_us >= (int64_t)CAM_STATUS_LIVE_MS * 1000)) {
+    return e->value;
+  }
+  uint32_t gen = e->gen;
+  int value = s->get_reg(s, reg, mask);
+  portENTER_CRITICAL(&_status_mux);
+  if (e->gen == gen && value >= 0) {
+    e->value = value;
+    e->read_us = now > 0 ? now : 1;
+  }
+  portEXIT_CRITICAL(&_status_mux);
+  return value;
+}
+
+void cam_status_invalidate(void) {
+  portENTER_CRITICAL(&_status_mux);
+  for (int i = 0; i < _status_nregs; i++) {
+    _status_regs[i].read_us = 0;
+    _status_regs[i].gen++;
+  }
+  _status_dirty++;
+  portEXIT_CRITICAL(&_status_mux);
+}
+
+void cam_status_reg_written(int reg) {
+  portENTER_CRITICAL(&_status_mux);
+  for (int i = 0; i < _status_nregs; i++) {
+    status_reg_t *e = &_status_regs[i];
+    if (reg >= e->reg && reg < e->reg + status_reg_span(e->mask)) {
+      e->read_us = 0;
+      e->gen++;
+    }
+  }
+  _status_dirty++;
+  portEXIT_CRITICAL(&_status_mux);
+}
+
+uint32_t cam_status_version(void) {
+  return _status_version;
+}
+
+static void status_release(status_snap_t *snap) {
+  if (!snap) {
+    return;
+  }
+  portENTER_CRITICAL(&_status_mux);
+  bool last = --snap->refs == 0;
+  portEXIT_CRITICAL(&_status_mux);
+  if (last) {
+    free(snap);
+  }
+}
+
+// Dipanggil di bawah _status_lock. Return false kalau kehabisan memori.
+static bool status_rebuild(int64_t now) {
+  sensor_t *s = esp_camera_sensor_get();
+  if (!s || !_status_config) {
+    return false;
+  }
+  uint32_t dirty = _status_dirty;
+  char *p = _status_scratch;
+  p += _status_config(p);
+  if (_status_live) {
+    p += _status_live(p);
+  }
+  size_t body_len = p - _status_scratch;
+  _status_built = dirty;
+  _status_built_us = now;
+
+  status_snap_t *old = _status_snap;
+  if (old && old->len - old->body_off - 1 == body_len && memcmp(old->json + old->body_off, _status_scratch, body_len) == 0) {
+    return true;  // isi sama: versi + ETag tetap, poll berikutnya dapat 304
+  }
+
+  char prefix[32];
+  int prefix_len = snprintf(prefix, sizeof(prefix), "{\"version\":%u,", (unsigned)(_status_version + 1));
+  size_t len = prefix_len + body_len + 1;
+  status_snap_t *snap = (status_snap_t *)malloc(sizeof(status_snap_t) + len);
+  if (!snap) {
+    return false;
+  }
+  snap->json = (char *)(snap + 1);
+  memcpy(snap->json, prefix, prefix_len);
+  memcpy(snap->json + prefix_len, _status_scratch, body_len);
+  snap->json[len - 1] = '}';
+  snap->len = len;
+  snap->body_off = prefix_len;
+  snap->refs = 1;  // ref milik cache
+  snap->version = ++_status_version;
+  snprintf(snap->etag, sizeof(snap->etag), "\"%08x-%u\"", (unsigned)_status_boot, (unsigned)snap->version);
+
+  portENTER_CRITICAL(&_status_mux);
+  _status_snap = snap;
+  portEXIT_CRITICAL(&_status_mux);
+  status_release(old);
+  return true;
+}
+
+static status_snap_t *status_acquire(void) {
+  if (!_status_lock || xSemaphoreTake(_status_lock, portMAX_DELAY) != pdTRUE) {
+    return NULL;
+  }
+  int64_t now = esp_timer_get_time();
+  if (!_status_snap || _status_dirty != _status_built || now - _status_built_us >= (int64_t)CAM_STATUS_LIVE_MS * 1000) {
+    if (!status_rebuild(now)) {
+      log_e("Status rebuild failed");
+    }
+  }
+  status_snap_t *snap = _status_snap;
+  if (snap) {
+    portENTER_CRITICAL(&_status_mux);
+    snap->refs++;
+    portEXIT_CRITICAL(&_status_mux);
+  }
+  xSemaphoreGive(_status_lock);
+  return snap;
+}
+
+esp_err_t cam_status_handler(httpd_req_t *req) {
+  status_snap_t *snap = status_acquire();
+  if (!snap) {
+    return httpd_resp_send_500(req);
+  }
+  // no-cache = browser tetap revalidasi tiap poll, tapi dengan If-None-Match
+  httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
+  httpd_resp_set_hdr(req, "Access-Control-Expose-Headers", "ETag");
+  httpd_resp_set_hdr(req, "Cache-Control", "no-cache");
+  httpd_resp_set_hdr(req, "ETag", snap->etag);
+
+  char inm[64];
+  esp_err_t res;
+  if (httpd_req_get_hdr_value_str(req, "If-None-Match", inm, sizeof(inm)) == ESP_OK && strstr(inm, snap->etag)) {
+    httpd_resp_set_status(req, "304 Not Modified");
+    res = httpd_resp_send(req, NULL, 0);
+  } else {
+    httpd_resp_set_type(req, "application/json");
+    res = httpd_resp_send(req, snap->json, snap->len);
+  }
+  status_release(snap);  // header menunjuk ke snap->etag sampai terkirim
+  return res;
+}
@@ -0,0 +1,36 @@
+#pragma once
+// Cache /status: shadow register sensor + snapshot JSON berversi.
+//
+// status_handler lama membaca ~40 register lewat SCCB dan memformat ~30 field
+// ke satu buffer static di setiap poll. Di sini:
+//  - register dibaca lewat cam_status_reg() ke shadow, dan baru dibaca ulang
+//    kalau handler yang menulis (cmd/reg/pll/xclk/resolution) menandainya
+//    basi. Register yang digerakkan AEC/AGC/AWB (0x3400-0x3406,
+//    0x3500-0x350d) disegarkan paling sering tiap CAM_STATUS_LIVE_MS.
+//  - JSON disusun ulang hanya kalau ada yang ditandai basi atau snapshot
+//    sudah lebih tua dari CAM_STATUS_LIVE_MS (telemetri abr/clip, status
+//    sensor yang diubah ABR). Body yang sama tidak menaikkan versi.
+//  - snapshot ref-counted: tiap request memegang snapshot-nya sendiri selama
+//    kirim, tidak ada buffer bersama yang ditulis ulang di tengah jalan.
+//  - ETag "<boot>-<versi>" + If-None-Match -> 304 tanpa body.
+#include <stdint.h>
+#include "esp_camera.h"
+#include "esp_http_server.h"
+
+#ifndef CAM_STATUS_LIVE_MS
+#define CAM_STATUS_LIVE_MS 1000
+#endif
+#define CAM_STATUS_JSON_MAX 1536
+#define CAM_STATUS_MAX_REGS 64
+
+// Tulis potongan JSON (field dipisah koma, tanpa kurung) ke p, return panjang.
+typedef int (*cam_status_print_t)(char *p);
+
+// config: field sensor/setting (dipanggil di bawah lock, boleh cam_status_reg);
+// live: telemetri murah, diawali koma seperti cam_abr_print_status.
+bool cam_status_begin(cam_status_print_t config, cam_status_print_t live);  // idempotent
+int cam_status_reg(sensor_t *s, int reg, int mask);  // hanya dari dalam print config
+void cam_status_invalidate(void);                    // setting sensor berubah: semua basi
+void cam_status_reg_written(int reg);                // /reg: register yang tumpang tindih saja
+uint32_t cam_status_version(void);
+esp_err_t cam_status_handler(httpd_req_t *req);
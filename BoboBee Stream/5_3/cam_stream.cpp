@@ -0,0 +1,109 @@
+#include "cam_stream.h"
+#include <stdlib.h>
+#include <string.h>
+#include <sys/uio.h>
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "cam_abr.h"
+#include "cam_metrics.h"
+
+#if defined(ARDUINO_ARCH_ESP32) && defined(CONFIG_ARDUHAL_ESP_LOG)
+#include "esp32-hal-log.h"
+#endif
+
+// ?gate=N dalam detik, 0 kalau tidak ada
+static uint32_t stream_gate_s(httpd_req_t *req) {
+  char query[64];
+  char value[12];
+  if (httpd_req_get_url_query_str(req, query, sizeof(query)) != ESP_OK || httpd_query_key_value(query, "gate", value, sizeof(value)) != ESP_OK) {
+    return 0;
+  }
+  return strtoul(value, NULL, 10);
+}
+
+bool cam_stream_open(cam_stream_t *s, httpd_req_t *req) {
+  memset(s, 0, sizeof(*s));
+  s->req = req;
+  s->writer.fd = -1;
+  s->client = cam_bcast_subscribe();
+  if (s->client < 0) {
+    log_e("Too many stream clients");
+    httpd_resp_set_status(req, "503 Service Unavailable");
+    s->res = httpd_resp_send(req, NULL, 0);
+    return false;
+  }
+  frame_gate_init(&s->gate, stream_gate_s(req) * 1000);
+  if (s->gate.keepalive_ms) {
+    cam_bcast_set_gated(s->client, true);
+  }
+  return true;
+}
+
+esp_err_t cam_stream_begin(cam_stream_t *s, const char *boundary, const char *extra_hdrs) {
+  // prefix writer tidak dipakai (cam_core::PartFormat), hanya header + TCP_NODELAY
+  s->res = mjpeg_stream_begin(&s->writer, s->req, boundary, false, extra_hdrs);
+  s->last_us = esp_timer_get_time();
+  return s->res;
+}
+
+cam_frame_t *cam_stream_next(cam_stream_t *s) {
+  while (true) {
+    // frame dibagi ke semua klien; klien lambat hanya melewatkan frame
+    int64_t wait_start = esp_timer_get_time();
+    cam_frame_t *frame = cam_bcast_wait(s->client, CAM_STREAM_WAIT_MS / portTICK_PERIOD_MS);
+    int64_t now = esp_timer_get_time();
+    cam_metrics_stage(CAM_STAGE_WAIT, (uint32_t)(now - wait_start));
+    if (!frame) {
+      log_e("Camera capture failed");
+      s->res = ESP_FAIL;
+      return NULL;
+    }
+    if (frame_gate_pass(&s->gate, frame->scene, frame->changed_us, now)) {
+      s->ready_us = esp_timer_get_time();
+      return frame;
+    }
+    cam_frame_release(frame);  // scene diam: lewati, koneksi tetap hidup
+  }
+}
+
+esp_err_t cam_stream_send(cam_stream_t *s, const char *prefix, size_t prefix_len, const uint8_t *buf, size_t len) {
+  // boundary + header + payload dalam satu writev
+  struct iovec iov[2];
+  iov[0].iov_base = (void *)prefix;
+  iov[0].iov_len = prefix_len;
+  iov[1].iov_base = (void *)buf;
+  iov[1].iov_len = len;
+  int64_t t0 = esp_timer_get_time();
+  s->res = mjpeg_writev(&s->writer, iov, 2);
+  s->writer.prefix_us = (uint32_t)(t0 - s->ready_us);
+  s->writer.send_us = (uint32_t)(esp_timer_get_time() - t0);
+  if (s->res == ESP_OK) {
+    s->writer.frames++;
+  } else {
+    log_e("Send frame failed");
+  }
+  return s->res;
+}
+
+uint32_t cam_stream_done(cam_stream_t *s, cam_frame_t *frame) {
+  uint32_t total_dropped = cam_bcast_dropped(s->client);
+  cam_abr_feed(s->client, s->writer.send_us, &frame->timestamp, total_dropped - s->dropped);
+  if (s->res == ESP_OK) {
+    cam_metrics_sent(s->client, s->writer.prefix_us, s->writer.send_us, frame->len, total_dropped - s->dropped);
+  }
+  s->dropped = total_dropped;
+  cam_frame_release(frame);
+
+  int64_t now = esp_timer_get_time();
+  uint32_t frame_ms = (uint32_t)((now - s->last_us) / 1000);
+  s->last_us = now;
+  return frame_ms;
+}
+
+void cam_stream_close(cam_stream_t *s) {
+  cam_abr_leave(s->client);  // sebelum slot bisa dipakai klien baru
+  cam_bcast_unsubscribe(s->client);
+  if (s->writer.fd >= 0) {
+    mjpeg_stream_end(&s->writer, s->req);
+  }
+}
@@ -0,0 +1,117 @@
+#pragma once
+// Glue cam_stream_core.h ke broadcaster (cam_broadcast.h) + writev
+// (mjpeg_framing.h): /stream di server utama (app_httpd.cpp) dan addon
+// (cam_stream_addon.h) memakai cam_core::serve yang sama dengan sketch root,
+// dengan policy compile-time yang sama (Boundary, kTimestamp, Headers, Led, Log).
+//
+//   struct StreamConfig : cam_core::Defaults {
+//     static constexpr bool kTimestamp = false;
+//   };
+//   static esp_err_t stream_handler(httpd_req_t *req) {
+//     if (!httpd_async_is_worker()) {
+//       return httpd_async_submit(req, stream_handler);
+//     }
+//     return cam_core::serve_bcast<StreamConfig>(req);
+//   }
+//
+// BcastStream adalah Camera sekaligus Sink untuk cam_core::serve: grab
+// menunggu frame broadcaster dan menerapkan ?gate=N (kirim hanya saat scene
+// berubah + keepalive tiap N detik), write_part mengirim prefix + JPEG dalam
+// satu writev, release mengumpankan waktu kirim ke ABR + metrics. Bagian yang
+// tidak bergantung pada Config ada di cam_stream.cpp.
+#include <stdint.h>
+#include <stddef.h>
+#include "esp_http_server.h"
+#include "cam_broadcast.h"
+#include "mjpeg_framing.h"
+#include "frame_gate.h"
+#include "cam_stream_core.h"
+
+#ifndef CAM_STREAM_WAIT_MS
+#define CAM_STREAM_WAIT_MS 5000  // tanpa frame selama ini -> akhiri stream
+#endif
+
+typedef struct {
+  httpd_req_t *req;
+  int client;              // slot broadcaster, -1 = penuh (503 sudah dikirim)
+  frame_gate_t gate;
+  mjpeg_writer_t writer;
+  uint32_t dropped;        // cam_bcast_dropped saat frame terakhir
+  int64_t ready_us;        // grab selesai: prefix disusun sesudahnya
+  int64_t last_us;         // frame terkirim sebelumnya (Log)
+  esp_err_t res;
+} cam_stream_t;
+
+bool cam_stream_open(cam_stream_t *s, httpd_req_t *req);  // subscribe + ?gate; false = 503 terkirim
+esp_err_t cam_stream_begin(cam_stream_t *s, const char *boundary, const char *extra_hdrs);
+cam_frame_t *cam_stream_next(cam_stream_t *s);  // NULL = kamera diam CAM_STREAM_WAIT_MS
+esp_err_t cam_stream_send(cam_stream_t *s, const char *prefix, size_t prefix_len, const uint8_t *buf, size_t len);
+uint32_t cam_stream_done(cam_stream_t *s, cam_frame_t *frame);  // ABR + metrics; return ms sejak frame sebelumnya
+void cam_stream_close(cam_stream_t *s);
+
+namespace cam_core {
+
+template <class Config>
+class BcastStream {
+ public:
+  struct Frame {
+    const uint8_t *buf;
+    size_t len;
+    struct timeval timestamp;
+    cam_frame_t *frame;
+  };
+
+  explicit BcastStream(httpd_req_t *req) { open_ = cam_stream_open(&s_, req); }
+  ~BcastStream() {
+    if (open_) {
+      cam_stream_close(&s_);
+    }
+  }
+
+  bool open() const { return open_; }
+  esp_err_t result() const { return s_.res; }
+
+  // Header response sama dengan mjpeg_stream_begin (content_type sudah
+  // tersirat dari Boundary); prefix part disusun cam_core::PartFormat.
+  bool begin(const char *, const char *extra_hdrs) { return cam_stream_begin(&s_, Config::Boundary::value, extra_hdrs) == ESP_OK; }
+
+  bool grab(Frame *f) {
+    cam_frame_t *frame = cam_stream_next(&s_);
+    if (!frame) {
+      return false;
+    }
+    f->frame = frame;
+    f->buf = frame->buf;
+    f->len = frame->len;
+    f->timestamp = frame->timestamp;
+    return true;
+  }
+
+  bool write_part(const char *prefix, size_t prefix_len, const uint8_t *buf, size_t len) {
+    return cam_stream_send(&s_, prefix, prefix_len, buf, len) == ESP_OK;
+  }
+
+  void release(Frame *f) {
+    size_t len = f->len;
+    uint32_t frame_ms = cam_stream_done(&s_, f->frame);
+    if (s_.res == ESP_OK) {
+      Config::Log::frame_sent(len, frame_ms);
+    }
+  }
+
+ private:
+  cam_stream_t s_;
+  bool open_;
+};
+
+template <class Config>
+esp_err_t serve_bcast(httpd_req_t *req) {
+  BcastStream<Config> stream(req);
+  if (!stream.open()) {
+    return stream.result();
+  }
+  serve<Config>(stream, stream);
+  return stream.result();
+}
+
+}  // namespace cam_core
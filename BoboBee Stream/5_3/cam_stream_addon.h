@@ -1,7 +1,16 @@
 #pragma once
 #include "esp_camera.h"
 #include "esp_http_server.h"
+#include "esp_timer.h"
 #include <string.h>
+#include "httpd_async.h"
+#include "cam_stream.h"
+#include "cam_clip.h"
+#include "cam_tensor.h"
+#include "cam_metrics.h"
+#include "cam_abr.h"
+#include "cam_control.h"
+#include "cam_status.h"
 
 // === PIN DFRobot ESP32-S3 AI Camera (ubah jika board berbeda)
 #ifndef CAM_PINS_DEFINED
@@ -31,10 +40,6 @@ bool CAM_startOwnServer(uint16_t port);  // start server kecil sendiri (mis. :82
 // ====== Internal
 static httpd_handle_t _cam_httpd = NULL;
 
-static const char* _CAM_STREAM_CT = "multipart/x-mixed-replace;boundary=frame";
-static const char* _CAM_BOUNDARY  = "\r\n--frame\r\n";
-static const char* _CAM_PART_HDR  = "Content-Type: image/jpeg\r\nContent-Length: %u\r\n\r\n";
-
 // ---------- Halaman TM Pose (served by ESP, same-origin) ----------
 static const char TM_HTML[] PROGMEM = R"rawliteral(
 <!doctype html>
@@ -180,25 +185,41 @@ static esp_err_t _CAM_tm_handler(httpd_req_t *req) {
   return httpd_resp_send(req, TM_HTML, HTTPD_RESP_USE_STRLEN);
 }
 
+// loop /stream sama dengan app_httpd.cpp dan sketch root (cam_stream_core.h);
+// same-origin: TIDAK perlu CORS header apa pun
+struct _CAM_Boundary {
+  static constexpr const char *value = "frame";
+};
+
+struct _CAM_StreamConfig : cam_core::Defaults {
+  using Boundary = _CAM_Boundary;
+  static constexpr bool kTimestamp = false;
+};
+
 static esp_err_t _CAM_stream_handler(httpd_req_t *req) {
-  // same-origin: TIDAK perlu CORS header apa pun
-  httpd_resp_set_type(req, _CAM_STREAM_CT);
-
-  while (true) {
-    camera_fb_t *fb = esp_camera_fb_get();
-    if (!fb) break;
-
-    httpd_resp_send_chunk(req, _CAM_BOUNDARY, strlen(_CAM_BOUNDARY));
-    char hdr[64];
-    size_t hlen = snprintf(hdr, sizeof(hdr), _CAM_PART_HDR, fb->len);
-    httpd_resp_send_chunk(req, hdr, hlen);
-    httpd_resp_send_chunk(req, (const char*)fb->buf, fb->len);
-    esp_camera_fb_return(fb);
-    vTaskDelay(1);
+  // loop stream jalan di worker, bukan di task httpd -> /tm tetap responsif
+  if (!httpd_async_is_worker()) {
+    return httpd_async_submit(req, _CAM_stream_handler);
   }
+  cam_core::serve_bcast<_CAM_StreamConfig>(req);
   return ESP_OK;
 }
 
+// /status server sendiri: setelan yang diubah ABR + telemetri abr/clip
+// (app_httpd.cpp punya /status lengkap dengan register sensor)
+static int _CAM_status_config(char *p) {
+  sensor_t *s = esp_camera_sensor_get();
+  if (!s) {
+    return sprintf(p, "\"framesize\":-1");
+  }
+  return sprintf(p, "\"pixformat\":%u,\"framesize\":%u,\"quality\":%u", s->pixformat, s->status.framesize, s->status.quality);
+}
+
+static int _CAM_status_live(char *p) {
+  int n = cam_abr_print_status(p);
+  return n + cam_clip_print_status(p + n);
+}
+
 // ---------- Camera init (idempotent) ----------
 inline bool CAM_initCamera() {
   sensor_t *s = esp_camera_sensor_get();
@@ -250,12 +271,24 @@ inline bool CAM_initCamera() {
 // ---------- Register endpoints ke server yg sudah ada ----------
 inline bool CAM_attachToHttpd(httpd_handle_t server) {
   if (!server) return false;
+  if (!httpd_async_start()) return false;
+  if (!cam_clip_start()) Serial.println("[CAM] clip ring off (no PSRAM)");
 
   httpd_uri_t tm_uri     = { .uri="/tm",     .method=HTTP_GET, .handler=_CAM_tm_handler,     .user_ctx=NULL };
   httpd_uri_t stream_uri = { .uri="/stream", .method=HTTP_GET, .handler=_CAM_stream_handler, .user_ctx=NULL };
+  httpd_uri_t clip_uri   = { .uri="/clip",    .method=HTTP_GET, .handler=cam_clip_handler,         .user_ctx=NULL };
+  httpd_uri_t trig_uri   = { .uri="/trigger", .method=HTTP_GET, .handler=cam_clip_trigger_handler, .user_ctx=NULL };
+  httpd_uri_t tensor_uri = { .uri="/tensor",  .method=HTTP_GET, .handler=cam_tensor_handler,       .user_ctx=NULL };
+  httpd_uri_t metrics_uri= { .uri="/metrics", .method=HTTP_GET, .handler=cam_metrics_handler,      .user_ctx=NULL };
+  httpd_uri_t clock_uri  = { .uri="/clock",   .method=HTTP_GET, .handler=cam_clock_handler,        .user_ctx=NULL };
 
   esp_err_t ok1 = httpd_register_uri_handler(server, &tm_uri);
   esp_err_t ok2 = httpd_register_uri_handler(server, &stream_uri);
+  httpd_register_uri_handler(server, &clip_uri);   // opsional, server bisa kehabisan slot URI
+  httpd_register_uri_handler(server, &trig_uri);
+  httpd_register_uri_handler(server, &tensor_uri);
+  httpd_register_uri_handler(server, &metrics_uri);
+  httpd_register_uri_handler(server, &clock_uri);
 
   if (ok1 == ESP_OK && ok2 == ESP_OK) {
     Serial.println("[CAM] mounted /tm and /stream on existing server");
@@ -269,8 +302,13 @@ inline bool CAM_attachToHttpd(httpd_handle_t server) {
 inline bool CAM_startOwnServer(uint16_t port) {
   if (_cam_httpd) return true;
 
+  if (!httpd_async_start()) return false;
+  if (!cam_clip_start()) Serial.println("[CAM] clip ring off (no PSRAM)");
+
   httpd_config_t cfg = HTTPD_DEFAULT_CONFIG();
   cfg.server_port = port;
+  cfg.max_open_sockets = HTTPD_ASYNC_WORKERS + 3;  // stream async tetap pegang socket
+  cfg.max_uri_handlers = 12;
 
   esp_err_t ok = httpd_start(&_cam_httpd, &cfg);
   if (ok != ESP_OK) {
@@ -281,9 +319,30 @@ inline bool CAM_startOwnServer(uint16_t port) {
   httpd_uri_t tm_uri     = { .uri="/tm",     .method=HTTP_GET, .handler=_CAM_tm_handler,     .user_ctx=NULL };
   httpd_uri_t stream_uri = { .uri="/stream", .method=HTTP_GET, .handler=_CAM_stream_handler, .user_ctx=NULL };
 
+  httpd_uri_t clip_uri   = { .uri="/clip",    .method=HTTP_GET, .handler=cam_clip_handler,         .user_ctx=NULL };
+  httpd_uri_t trig_uri   = { .uri="/trigger", .method=HTTP_GET, .handler=cam_clip_trigger_handler, .user_ctx=NULL };
+  httpd_uri_t tensor_uri = { .uri="/tensor",  .method=HTTP_GET, .handler=cam_tensor_handler,       .user_ctx=NULL };
+  httpd_uri_t metrics_uri= { .uri="/metrics", .method=HTTP_GET, .handler=cam_metrics_handler,      .user_ctx=NULL };
+  httpd_uri_t clock_uri  = { .uri="/clock",   .method=HTTP_GET, .handler=cam_clock_handler,        .user_ctx=NULL };
+  httpd_uri_t status_uri = { .uri="/status",  .method=HTTP_GET, .handler=cam_status_handler,       .user_ctx=NULL };
+  httpd_uri_t ctrl_uri   = { .uri="/control", .method=HTTP_GET, .handler=cam_control_handler,      .user_ctx=NULL };
+  httpd_uri_t ctrl_post  = { .uri="/control", .method=HTTP_POST, .handler=cam_control_handler,     .user_ctx=NULL };
+
+  // server app_httpd.cpp tidak jalan: /status dan /control (mis. abr=1) di sini
+  cam_status_begin(_CAM_status_config, _CAM_status_live);
+  cam_control_begin(NULL);
+
   httpd_register_uri_handler(_cam_httpd, &tm_uri);
   httpd_register_uri_handler(_cam_httpd, &stream_uri);
-
-  Serial.printf("[CAM] own HTTP server on :%u, endpoints: /tm, /stream\n", port);
+  httpd_register_uri_handler(_cam_httpd, &clip_uri);
+  httpd_register_uri_handler(_cam_httpd, &trig_uri);
+  httpd_register_uri_handler(_cam_httpd, &tensor_uri);
+  httpd_register_uri_handler(_cam_httpd, &metrics_uri);
+  httpd_register_uri_handler(_cam_httpd, &clock_uri);
+  httpd_register_uri_handler(_cam_httpd, &status_uri);
+  httpd_register_uri_handler(_cam_httpd, &ctrl_uri);
+  httpd_register_uri_handler(_cam_httpd, &ctrl_post);
+
+  Serial.printf("[CAM] own HTTP server on :%u, endpoints: /tm, /stream, /clip, /trigger, /tensor, /metrics, /clock, /status, /control\n", port);
   return true;
 }
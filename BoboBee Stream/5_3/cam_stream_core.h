@@ -0,0 +1,174 @@
+#pragma once
+// Inti streaming MJPEG bersama: satu loop /stream untuk firmware 5_3
+// (app_httpd.cpp dan addon cam_stream_addon.h, lewat cam_stream.h) dan
+// sketch di root (bobobee.c, webcam-stream.ino, Webcam_image_audio.ino,
+// lewat cam_stream_esp.h), menggantikan stream_handler hasil copy-paste.
+// File ini ada di folder sketch 5_3 supaya build Arduino firmware yang
+// dipasang tidak butuh path di luar sketch; cam_stream_core.h di root hanya
+// meneruskan include ke sini.
+//
+// Semua pilihan adalah policy compile-time di satu struct config:
+//   Boundary   string boundary multipart (constexpr)
+//   kTimestamp tambahkan X-Timestamp di header part
+//   Headers    header response tambahan ("Name: val\r\n...", nullptr = tidak ada)
+//   Led        hook stream_start/stream_stop (mis. nyalakan LED selama stream)
+//   Log        hook frame_sent(len, frame_ms) untuk glue yang punya jam (cam_stream.h)
+//   Grab       fb_count + grab mode untuk camera_config_t (cam_stream_esp.h)
+//   Pixel      JPEG langsung dari sensor, atau encode dari format mentah
+// jadi tiap build hanya mengompilasi cabang yang dipakai; loop per frame
+// tidak memeriksa format/opsi apa pun saat runtime.
+//
+//   struct StreamConfig : cam_core::Defaults {
+//     static constexpr bool kTimestamp = false;
+//   };
+//   esp_err_t stream_handler(httpd_req_t *req) { return cam_core::serve_httpd<StreamConfig>(req); }
+//
+// Prefix part (boundary + Content-Type + Content-Length [+ X-Timestamp])
+// disusun ke buffer yang ukurannya dihitung compile-time dari boundary, jadi
+// tidak ada lagi part_buf 64 byte yang terpotong begitu header bertambah.
+//
+// File ini murni logika, tanpa header ESP, supaya bisa dites di host
+// (tools/stream_core_check.cpp). Glue kamera + esp_http_server ada di
+// cam_stream_esp.h (esp_camera langsung) dan cam_stream.h (broadcaster 5_3).
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/time.h>
+
+namespace cam_core {
+
+constexpr size_t cstrlen(const char *s) {
+  return *s ? 1 + cstrlen(s + 1) : 0;
+}
+
+// ---------- Policy ----------
+struct DefaultBoundary {
+  static constexpr const char *value = "123456789000000000000987654321";
+};
+
+struct NoHeaders {
+  static constexpr const char *value = nullptr;
+};
+
+struct NoLed {
+  static void stream_start() {}
+  static void stream_stop() {}
+};
+
+struct NoLog {
+  static void frame_sent(size_t, uint32_t) {}
+};
+
+// Mode grab driver. Latest: 2 buffer, driver terus menimpa dengan frame
+// terbaru (latensi rendah, perlu PSRAM). WhenEmpty: 1 buffer, diisi saat
+// dikembalikan (hemat RAM, frame bisa setua satu kali kirim).
+struct GrabLatest {
+  static constexpr int fb_count = 2;
+  static constexpr bool latest = true;
+};
+
+struct GrabWhenEmpty {
+  static constexpr int fb_count = 1;
+  static constexpr bool latest = false;
+};
+
+// Config dasar: warisi lalu ganti yang perlu. Pixel diisi cam_stream_esp.h
+// (JpegOnly default).
+struct Defaults {
+  using Boundary = DefaultBoundary;
+  using Headers = NoHeaders;
+  using Led = NoLed;
+  using Log = NoLog;
+  using Grab = GrabLatest;
+  static constexpr bool kTimestamp = true;
+};
+
+// ---------- Framing ----------
+template <class Boundary, bool Timestamp>
+struct PartFormat {
+  static constexpr const char *kPre = "\r\n--";
+  static constexpr const char *kMid = "\r\nContent-Type: image/jpeg\r\nContent-Length: ";
+  static constexpr const char *kTs = "\r\nX-Timestamp: ";
+  static constexpr size_t kBoundaryLen = cstrlen(Boundary::value);
+  static constexpr size_t kFixed = cstrlen(kPre) + kBoundaryLen + cstrlen(kMid);
+  // len <= 10 digit, detik <= 20 karakter (int64 bertanda), mikrodetik 6 digit
+  static constexpr size_t kMax = kFixed + 10 + (Timestamp ? cstrlen(kTs) + 20 + 1 + 6 : 0) + 4 + 1;
+  static_assert(kBoundaryLen > 0 && kBoundaryLen <= 70, "RFC 2046: boundary 1..70 karakter");
+
+  char buf[kMax];
+  size_t fixed_len = 0;
+
+  PartFormat() {
+    memcpy(buf, kPre, cstrlen(kPre));
+    memcpy(buf + cstrlen(kPre), Boundary::value, kBoundaryLen);
+    memcpy(buf + cstrlen(kPre) + kBoundaryLen, kMid, cstrlen(kMid));
+    fixed_len = kFixed;
+  }
+
+  // Return panjang prefix di buf (bagian konstan tidak ditulis ulang).
+  size_t format(uint32_t len, const struct timeval &ts) {
+    int n;
+    if constexpr (Timestamp) {
+      long usec = ts.tv_usec < 0 || ts.tv_usec > 999999 ? 0 : (long)ts.tv_usec;
+      n = snprintf(buf + kFixed, kMax - kFixed, "%u%s%lld.%06ld\r\n\r\n", (unsigned)len, kTs, (long long)ts.tv_sec, usec);
+    } else {
+      (void)ts;
+      n = snprintf(buf + kFixed, kMax - kFixed, "%u\r\n\r\n", (unsigned)len);
+    }
+    return kFixed + (size_t)n;
+  }
+
+  // "multipart/x-mixed-replace;boundary=..." sekali per stream
+  static size_t content_type(char *out, size_t cap) {
+    int n = snprintf(out, cap, "multipart/x-mixed-replace;boundary=%s", Boundary::value);
+    return n > 0 && (size_t)n < cap ? (size_t)n : 0;
+  }
+};
+
+// ---------- Loop ----------
+struct ServeStats {
+  uint32_t frames = 0;
+  uint64_t bytes = 0;  // payload JPEG
+  bool grab_failed = false;
+  bool write_failed = false;
+};
+
+// Camera: bool grab(Frame *), void release(Frame *), Frame punya buf/len/timestamp.
+// Sink:   bool begin(const char *content_type, const char *extra_hdrs),
+//         bool write_part(const char *prefix, size_t prefix_len, const uint8_t *buf, size_t len)
+//         (satu panggilan per frame: sink writev bisa mengirim keduanya sekaligus).
+// Berhenti saat grab/write gagal atau *stop true (host test).
+template <class Config, class Camera, class Sink>
+ServeStats serve(Camera &camera, Sink &sink, const volatile bool *stop = nullptr) {
+  using Format = PartFormat<typename Config::Boundary, Config::kTimestamp>;
+  ServeStats st;
+  Format part;
+  char type[128];
+  if (!Format::content_type(type, sizeof(type)) || !sink.begin(type, Config::Headers::value)) {
+    st.write_failed = true;
+    return st;
+  }
+  Config::Led::stream_start();
+  typename Camera::Frame frame;
+  while (!(stop && *stop)) {
+    if (!camera.grab(&frame)) {
+      st.grab_failed = true;
+      break;
+    }
+    size_t n = part.format((uint32_t)frame.len, frame.timestamp);
+    bool ok = sink.write_part(part.buf, n, (const uint8_t *)frame.buf, frame.len);
+    size_t len = frame.len;
+    camera.release(&frame);  // selalu, juga saat kirim gagal
+    if (!ok) {
+      st.write_failed = true;
+      break;
+    }
+    st.frames++;
+    st.bytes += len;
+  }
+  Config::Led::stream_stop();
+  return st;
+}
+
+}  // namespace cam_core
@@ -0,0 +1,193 @@
+#include "cam_tensor.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+#include "esp_jpg_decode.h"
+#include "freertos/FreeRTOS.h"
+#include "cam_broadcast.h"
+#include "httpd_async.h"
+#include "mjpeg_framing.h"
+#include "tensor_resize.h"
+
+#if defined(ARDUINO_ARCH_ESP32) && defined(CONFIG_ARDUHAL_ESP_LOG)
+#include "esp32-hal-log.h"
+#endif
+
+#define TENSOR_WAIT_MS 5000
+
+// State per request (PSRAM): tabel scaler, hasil decode, tensor output.
+typedef struct {
+  tensor_scaler_t scaler;
+  const uint8_t *jpg;
+  size_t jpg_len;
+  uint8_t *rgb;     // hasil decode RGB888 pada skala JPEG
+  size_t rgb_cap;
+  uint16_t rgb_w;
+  uint16_t rgb_h;
+  uint8_t *out;
+  tensor_header_t header;
+} tensor_session_t;
+
+static void *tensor_alloc(size_t len) {
+  void *p = heap_caps_malloc(len, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  return p ? p : malloc(len);
+}
+
+static size_t jpg_read(void *arg, size_t index, uint8_t *buf, size_t len) {
+  tensor_session_t *t = (tensor_session_t *)arg;
+  if (index >= t->jpg_len) {
+    return 0;
+  }
+  if (index + len > t->jpg_len) {
+    len = t->jpg_len - index;
+  }
+  if (buf) {
+    memcpy(buf, t->jpg + index, len);
+  }
+  return len;
+}
+
+// Decoder mengirim blok MCU (RGB888); data NULL = awal (ukuran output) / akhir.
+static bool rgb_write(void *arg, uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint8_t *data) {
+  tensor_session_t *t = (tensor_session_t *)arg;
+  if (!data) {
+    if (x == 0 && y == 0) {
+      if ((size_t)w * h * 3 > t->rgb_cap) {
+        return false;
+      }
+      t->rgb_w = w;
+      t->rgb_h = h;
+    }
+    return true;
+  }
+  if (x + w > t->rgb_w || y + h > t->rgb_h) {
+    return false;
+  }
+  for (uint16_t r = 0; r < h; r++) {
+    memcpy(t->rgb + ((size_t)(y + r) * t->rgb_w + x) * 3, data + (size_t)r * w * 3, (size_t)w * 3);
+  }
+  return true;
+}
+
+static bool tensor_convert(tensor_session_t *t, const cam_frame_t *frame, uint16_t w, uint16_t h, uint8_t channels) {
+  int shift = tensor_jpeg_scale(frame->width, frame->height, w, h);
+  size_t need = (size_t)(frame->width >> shift) * (frame->height >> shift) * 3;
+  if (need > t->rgb_cap) {
+    free(t->rgb);  // resolusi kamera naik di tengah stream
+    t->rgb = (uint8_t *)tensor_alloc(need);
+    t->rgb_cap = t->rgb ? need : 0;
+    if (!t->rgb) {
+      return false;
+    }
+  }
+  t->jpg = frame->buf;
+  t->jpg_len = frame->len;
+  if (esp_jpg_decode(frame->len, (jpg_scale_t)shift, jpg_read, rgb_write, t) != ESP_OK) {
+    return false;
+  }
+  if (t->scaler.src_w != t->rgb_w || t->scaler.src_h != t->rgb_h) {
+    if (!tensor_scaler_init(&t->scaler, t->rgb_w, t->rgb_h, w, h, channels)) {
+      return false;
+    }
+  }
+  tensor_scale_rgb888(&t->scaler, t->rgb, (size_t)t->rgb_w * 3, t->out);
+  int64_t ts_us = (int64_t)frame->timestamp.tv_sec * 1000000 + frame->timestamp.tv_usec;
+  tensor_header_init(&t->header, &t->scaler, shift, frame->seq, ts_us);
+  return true;
+}
+
+static uint16_t query_dim(const char *query, const char *key, uint16_t def) {
+  char value[8];
+  if (!query || httpd_query_key_value(query, key, value, sizeof(value)) != ESP_OK) {
+    return def;
+  }
+  return (uint16_t)strtoul(value, NULL, 10);
+}
+
+esp_err_t cam_tensor_handler(httpd_req_t *req) {
+  // decode + resize bisa puluhan ms: jangan di task httpd
+  if (!httpd_async_is_worker()) {
+    return httpd_async_submit(req, cam_tensor_handler);
+  }
+
+  char query[64];
+  const char *q = httpd_req_get_url_query_str(req, query, sizeof(query)) == ESP_OK ? query : NULL;
+  uint16_t w = query_dim(q, "w", CAM_TENSOR_W);
+  uint16_t h = query_dim(q, "h", CAM_TENSOR_H);
+  char value[8] = "";
+  uint8_t channels = q && httpd_query_key_value(q, "fmt", value, sizeof(value)) == ESP_OK && strcmp(value, "gray") == 0 ? 1 : 3;
+  bool stream = q && httpd_query_key_value(q, "stream", value, sizeof(value)) == ESP_OK && strcmp(value, "1") == 0;
+  if (w < TENSOR_MIN_DIM || h < TENSOR_MIN_DIM || w > TENSOR_MAX_DIM || h > TENSOR_MAX_DIM) {
+    httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "w/h out of range");
+    return ESP_FAIL;
+  }
+
+  tensor_session_t *t = (tensor_session_t *)tensor_alloc(sizeof(tensor_session_t));
+  size_t out_len = tensor_bytes(w, h, channels);
+  uint8_t *out = (uint8_t *)tensor_alloc(out_len);
+  int client = t && out ? cam_bcast_subscribe() : -1;
+  if (client < 0) {
+    free(out);
+    free(t);
+    httpd_resp_set_status(req, "503 Service Unavailable");
+    return httpd_resp_send(req, NULL, 0);
+  }
+  memset(t, 0, sizeof(*t));
+  t->out = out;
+
+  char hdrs[96];
+  snprintf(hdrs, sizeof(hdrs), "X-Tensor-Shape: %u,%u,%u\r\nAccess-Control-Allow-Origin: *\r\n", h, w, channels);
+  size_t record = sizeof(tensor_header_t) + out_len;
+
+  mjpeg_writer_t writer;
+  bool begun = false;
+  uint32_t sent = 0, failed = 0;
+  int64_t busy_us = 0;
+  esp_err_t res = ESP_OK;
+  while (res == ESP_OK) {
+    cam_frame_t *frame = cam_bcast_wait(client, TENSOR_WAIT_MS / portTICK_PERIOD_MS);
+    if (!frame) {
+      res = ESP_ERR_TIMEOUT;
+      break;
+    }
+    int64_t t0 = esp_timer_get_time();
+    bool ok = tensor_convert(t, frame, w, h, channels);
+    busy_us += esp_timer_get_time() - t0;
+    cam_frame_release(frame);
+    if (!ok) {
+      if (++failed >= 3 && sent == 0) {
+        res = ESP_FAIL;  // JPEG rusak terus / kehabisan memori
+      }
+      continue;
+    }
+
+    if (!begun) {
+      // stream: body dibatasi close, tiap record membawa header (panjang dari shape)
+      res = mjpeg_body_begin(&writer, req, "application/octet-stream", stream ? 0 : record, hdrs);
+      begun = true;
+    }
+    struct iovec iov[2] = {{&t->header, sizeof(tensor_header_t)}, {t->out, out_len}};
+    if (res == ESP_OK) {
+      res = mjpeg_writev(&writer, iov, 2);
+    }
+    sent++;
+    if (!stream) {
+      break;
+    }
+  }
+  cam_bcast_unsubscribe(client);
+
+  if (begun) {
+    mjpeg_stream_end(&writer, req);
+  } else {
+    httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, res == ESP_ERR_TIMEOUT ? "no frame" : "decode failed");
+  }
+  log_i("Tensor %ux%ux%u: %u sent, %u failed, %u us/frame", w, h, channels, (unsigned)sent, (unsigned)failed,
+        (unsigned)(sent ? busy_us / sent : 0));
+  free(t->rgb);
+  free(t->out);
+  free(t);
+  return begun ? ESP_OK : ESP_FAIL;
+}
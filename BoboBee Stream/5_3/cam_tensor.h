@@ -0,0 +1,22 @@
+#pragma once
+// Glue tensor_resize ke kamera + HTTP: profil output kedua untuk inferensi.
+//
+//   /tensor?w=224&h=224&fmt=rgb     satu tensor: tensor_header_t + HxWxC uint8
+//   /tensor?w=96&h=96&fmt=gray      grayscale
+//   /tensor?...&stream=1            record tensor berurutan sampai koneksi
+//                                   ditutup (tiap record membawa header-nya)
+//
+// Frame diambil dari broadcaster, di-decode dengan skala DCT sekecil mungkin
+// lalu di-crop + resize di worker async, jadi klien tidak perlu decode JPEG.
+// Header HTTP X-Tensor-Shape: "h,w,c".
+#include <stdint.h>
+#include "esp_http_server.h"
+
+#ifndef CAM_TENSOR_W
+#define CAM_TENSOR_W 224
+#endif
+#ifndef CAM_TENSOR_H
+#define CAM_TENSOR_H 224
+#endif
+
+esp_err_t cam_tensor_handler(httpd_req_t *req);
@@ -0,0 +1,252 @@
+#include "clip_ring.h"
+#include <string.h>
+#include <stdlib.h>
+#include "freertos/FreeRTOS.h"
+#include "esp_heap_caps.h"
+
+#if defined(ARDUINO_ARCH_ESP32) && defined(CONFIG_ARDUHAL_ESP_LOG)
+#include "esp32-hal-log.h"
+#endif
+
+#define CLIP_PIN_FREE 0xFFFFFFFFu
+
+typedef struct {
+  uint64_t pos;  // posisi absolut (byte ke-n sejak awal), offset = pos % capacity
+  uint32_t len;
+  struct timeval timestamp;
+  int64_t t_us;
+  uint16_t width;
+  uint16_t height;
+} clip_entry_t;
+
+static portMUX_TYPE _clip_mux = portMUX_INITIALIZER_UNLOCKED;
+static uint8_t *_clip_buf = NULL;
+static size_t _clip_cap = 0;
+static clip_entry_t *_clip_index = NULL;
+static uint32_t _clip_max_frames = 0;
+static uint64_t _clip_head = 0;   // posisi absolut akhir frame terakhir
+static uint32_t _clip_first = 0;  // seq frame tertua yang masih valid
+static uint32_t _clip_end = 0;    // seq setelah frame terakhir yang sudah lengkap
+static uint32_t _clip_pins[CLIP_RING_MAX_READERS];
+static uint32_t _clip_appended = 0;
+static uint32_t _clip_evicted = 0;
+static uint32_t _clip_dropped_pinned = 0;
+static uint32_t _clip_dropped_oversize = 0;
+static uint32_t _clip_triggers = 0;
+static int64_t _clip_trigger_us = 0;
+static char _clip_trigger_reason[16] = "";
+
+static inline clip_entry_t *entry_at(uint32_t seq) {
+  return &_clip_index[seq % _clip_max_frames];
+}
+
+// harus dipanggil di dalam _clip_mux
+static uint32_t min_pin_locked(void) {
+  uint32_t min = CLIP_PIN_FREE;
+  for (int i = 0; i < CLIP_RING_MAX_READERS; i++) {
+    if (_clip_pins[i] < min) {
+      min = _clip_pins[i];
+    }
+  }
+  return min;
+}
+
+bool clip_ring_begin(size_t bytes, uint32_t max_frames) {
+  if (_clip_buf) {
+    return true;
+  }
+  if (bytes == 0 || max_frames == 0) {
+    return false;
+  }
+  uint8_t *buf = (uint8_t *)heap_caps_malloc(bytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  clip_entry_t *index = (clip_entry_t *)heap_caps_calloc(max_frames, sizeof(clip_entry_t), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  if (!buf || !index) {
+    // tanpa PSRAM ring sebesar ini tidak muat di DRAM: lebih baik tidak ada
+    heap_caps_free(buf);
+    heap_caps_free(index);
+    log_e("Clip ring: no PSRAM for %u bytes", (unsigned)bytes);
+    return false;
+  }
+  for (int i = 0; i < CLIP_RING_MAX_READERS; i++) {
+    _clip_pins[i] = CLIP_PIN_FREE;
+  }
+  _clip_index = index;
+  _clip_max_frames = max_frames;
+  _clip_cap = bytes;
+  _clip_buf = buf;
+  log_i("Clip ring: %u KB, %u frames max", (unsigned)(bytes / 1024), (unsigned)max_frames);
+  return true;
+}
+
+bool clip_ring_active(void) {
+  return _clip_buf != NULL;
+}
+
+bool clip_ring_append(const uint8_t *buf, size_t len, const struct timeval *ts, uint16_t width, uint16_t height, int64_t now_us) {
+  if (!_clip_buf) {
+    return false;
+  }
+  if (len == 0 || len > _clip_cap) {
+    _clip_dropped_oversize++;
+    return false;
+  }
+
+  portENTER_CRITICAL(&_clip_mux);
+  // frame selalu kontigu: kalau tidak muat di ujung, lompat ke awal buffer
+  uint64_t pos = _clip_head;
+  size_t off = pos % _clip_cap;
+  if (off + len > _clip_cap) {
+    pos += _clip_cap - off;
+  }
+  uint64_t new_head = pos + len;
+  uint32_t min_pin = min_pin_locked();
+  while (_clip_first < _clip_end && (entry_at(_clip_first)->pos + _clip_cap < new_head || _clip_end - _clip_first >= _clip_max_frames)) {
+    if (_clip_first >= min_pin) {
+      // pembaca masih memakai frame ini -> buang frame baru
+      _clip_dropped_pinned++;
+      portEXIT_CRITICAL(&_clip_mux);
+      return false;
+    }
+    _clip_first++;
+    _clip_evicted++;
+  }
+  // frame yang sudah di-evict tidak bisa di-pin lagi; isi index di luar lock aman
+  uint32_t seq = _clip_end;
+  portEXIT_CRITICAL(&_clip_mux);
+
+  memcpy(_clip_buf + (pos % _clip_cap), buf, len);
+  clip_entry_t *e = entry_at(seq);
+  e->pos = pos;
+  e->len = len;
+  e->timestamp = *ts;
+  e->t_us = now_us;
+  e->width = width;
+  e->height = height;
+
+  portENTER_CRITICAL(&_clip_mux);
+  _clip_head = new_head;
+  _clip_end = seq + 1;  // baru terlihat pembaca setelah lengkap
+  _clip_appended++;
+  portEXIT_CRITICAL(&_clip_mux);
+  return true;
+}
+
+bool clip_ring_open(clip_cursor_t *cur, int64_t from_us) {
+  cur->pin = -1;
+  if (!_clip_buf) {
+    return false;
+  }
+  portENTER_CRITICAL(&_clip_mux);
+  int pin = -1;
+  for (int i = 0; i < CLIP_RING_MAX_READERS; i++) {
+    if (_clip_pins[i] == CLIP_PIN_FREE) {
+      pin = i;
+      break;
+    }
+  }
+  if (pin >= 0) {
+    uint32_t seq = _clip_first;
+    while (seq < _clip_end && entry_at(seq)->t_us < from_us) {
+      seq++;
+    }
+    _clip_pins[pin] = seq;
+    cur->pin = pin;
+    cur->next = seq;
+  }
+  portEXIT_CRITICAL(&_clip_mux);
+  return pin >= 0;
+}
+
+// harus dipanggil di dalam _clip_mux
+static int frame_locked(uint32_t seq, clip_frame_t *out) {
+  if (seq < _clip_first) {
+    return -1;
+  }
+  if (seq >= _clip_end) {
+    return 0;
+  }
+  const clip_entry_t *e = entry_at(seq);
+  out->buf = _clip_buf + (e->pos % _clip_cap);
+  out->len = e->len;
+  out->timestamp = e->timestamp;
+  out->t_us = e->t_us;
+  out->width = e->width;
+  out->height = e->height;
+  out->seq = seq;
+  return 1;
+}
+
+int clip_ring_next(clip_cursor_t *cur, clip_frame_t *out) {
+  if (cur->pin < 0) {
+    return -1;
+  }
+  portENTER_CRITICAL(&_clip_mux);
+  int r = frame_locked(cur->next, out);
+  if (r > 0) {
+    _clip_pins[cur->pin] = cur->next;  // frame ini tetap aman sampai panggilan berikutnya
+    cur->next++;
+  }
+  portEXIT_CRITICAL(&_clip_mux);
+  return r;
+}
+
+int clip_ring_peek(const clip_cursor_t *cur, uint32_t offset, clip_frame_t *out) {
+  if (cur->pin < 0) {
+    return -1;
+  }
+  portENTER_CRITICAL(&_clip_mux);
+  int r = frame_locked(cur->next + offset, out);
+  portEXIT_CRITICAL(&_clip_mux);
+  return r;
+}
+
+void clip_ring_close(clip_cursor_t *cur) {
+  if (cur->pin < 0) {
+    return;
+  }
+  portENTER_CRITICAL(&_clip_mux);
+  _clip_pins[cur->pin] = CLIP_PIN_FREE;
+  portEXIT_CRITICAL(&_clip_mux);
+  cur->pin = -1;
+}
+
+int64_t clip_ring_fit_us(void) {
+  portENTER_CRITICAL(&_clip_mux);
+  uint32_t frames = _clip_end - _clip_first;
+  int64_t span = frames > 1 ? entry_at(_clip_end - 1)->t_us - entry_at(_clip_first)->t_us : 0;
+  uint64_t used = frames ? _clip_head - entry_at(_clip_first)->pos : 0;
+  portEXIT_CRITICAL(&_clip_mux);
+  if (span <= 0 || used == 0) {
+    return 0;
+  }
+  // sisakan 1/8: frame bisa membesar (scene ramai) dan wrap membuang ekor buffer
+  int64_t by_bytes = (int64_t)((_clip_cap - _clip_cap / 8) * (uint64_t)span / used);
+  int64_t by_frames = (int64_t)(_clip_max_frames - _clip_max_frames / 8) * span / (frames - 1);
+  return by_bytes < by_frames ? by_bytes : by_frames;
+}
+
+void clip_ring_trigger(const char *reason, int64_t now_us) {
+  portENTER_CRITICAL(&_clip_mux);
+  _clip_triggers++;
+  _clip_trigger_us = now_us;
+  strncpy(_clip_trigger_reason, reason ? reason : "", sizeof(_clip_trigger_reason) - 1);
+  _clip_trigger_reason[sizeof(_clip_trigger_reason) - 1] = 0;
+  portEXIT_CRITICAL(&_clip_mux);
+}
+
+void clip_ring_get_stats(clip_ring_stats_t *out) {
+  portENTER_CRITICAL(&_clip_mux);
+  out->capacity = _clip_cap;
+  out->frames = _clip_end - _clip_first;
+  out->used = out->frames ? (size_t)(_clip_head - entry_at(_clip_first)->pos) : 0;
+  out->appended = _clip_appended;
+  out->evicted = _clip_evicted;
+  out->dropped_pinned = _clip_dropped_pinned;
+  out->dropped_oversize = _clip_dropped_oversize;
+  out->oldest_us = out->frames ? entry_at(_clip_first)->t_us : 0;
+  out->newest_us = out->frames ? entry_at(_clip_end - 1)->t_us : 0;
+  out->triggers = _clip_triggers;
+  out->trigger_us = _clip_trigger_us;
+  memcpy(out->trigger_reason, _clip_trigger_reason, sizeof(out->trigger_reason));
+  portEXIT_CRITICAL(&_clip_mux);
+}
@@ -0,0 +1,75 @@
+#pragma once
+// Ring buffer JPEG pre-event di PSRAM.
+//
+// Broadcaster menyerahkan setiap frame ke clip_ring_append() (lewat
+// cam_bcast_set_sink) sehingga beberapa detik terakhir selalu tersedia
+// sebelum sebuah event (pose tengkurap, tangisan) dilaporkan. Memori dibatasi
+// CLIP_RING_BYTES: frame tertua dibuang kalau ruang atau index habis.
+//
+// Pembaca (handler /clip) membaca langsung dari memori ring tanpa copy.
+// Frame yang sedang dibaca di-"pin": writer tidak akan menimpanya dan
+// memilih membuang frame baru (dihitung di dropped_pinned).
+#include <stdint.h>
+#include <stddef.h>
+#include <sys/time.h>
+
+#ifndef CLIP_RING_BYTES
+#define CLIP_RING_BYTES (3 * 1024 * 1024)
+#endif
+#ifndef CLIP_RING_MAX_FRAMES
+#define CLIP_RING_MAX_FRAMES 900
+#endif
+#ifndef CLIP_RING_MAX_READERS
+#define CLIP_RING_MAX_READERS 2
+#endif
+
+typedef struct {
+  const uint8_t *buf;        // menunjuk ke memori ring, valid sampai clip_ring_next/close berikutnya
+  size_t len;
+  struct timeval timestamp;  // fb->timestamp
+  int64_t t_us;              // esp_timer saat masuk ring (basis window pre/post)
+  uint16_t width;
+  uint16_t height;
+  uint32_t seq;
+} clip_frame_t;
+
+typedef struct {
+  int pin;        // -1 = tidak aktif
+  uint32_t next;  // seq frame berikutnya
+} clip_cursor_t;
+
+typedef struct {
+  size_t capacity;
+  size_t used;
+  uint32_t frames;
+  uint32_t appended;
+  uint32_t evicted;
+  uint32_t dropped_pinned;
+  uint32_t dropped_oversize;
+  int64_t oldest_us;
+  int64_t newest_us;
+  uint32_t triggers;
+  int64_t trigger_us;
+  char trigger_reason[16];
+} clip_ring_stats_t;
+
+bool clip_ring_begin(size_t bytes, uint32_t max_frames);  // idempotent, alokasi PSRAM
+bool clip_ring_active(void);
+// Satu writer (task capture). false kalau frame dibuang.
+bool clip_ring_append(const uint8_t *buf, size_t len, const struct timeval *ts, uint16_t width, uint16_t height, int64_t now_us);
+
+// Cursor mulai dari frame tertua dengan t_us >= from_us (atau frame berikutnya).
+bool clip_ring_open(clip_cursor_t *cur, int64_t from_us);
+// 1 = frame tersedia, 0 = belum ada frame baru, -1 = cursor tertinggal/tidak valid.
+int clip_ring_next(clip_cursor_t *cur, clip_frame_t *out);
+// Seperti clip_ring_next tapi tidak memindahkan cursor/pin (untuk menghitung ukuran AVI).
+int clip_ring_peek(const clip_cursor_t *cur, uint32_t offset, clip_frame_t *out);
+void clip_ring_close(clip_cursor_t *cur);
+
+// Panjang window (us) yang masih muat di ring selama window itu di-pin,
+// ditaksir dari laju byte dan frame isi ring sekarang (dengan cadangan untuk
+// variasi ukuran frame). 0 kalau belum cukup frame untuk menaksir.
+int64_t clip_ring_fit_us(void);
+
+void clip_ring_trigger(const char *reason, int64_t now_us);
+void clip_ring_get_stats(clip_ring_stats_t *out);
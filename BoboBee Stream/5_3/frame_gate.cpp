@@ -0,0 +1,421 @@
+#include "frame_gate.h"
+#include <string.h>
+
+// ---------- Huffman minimal (cukup untuk membaca DC, AC hanya di-skip) ----------
+typedef struct {
+  const uint8_t *p;
+  const uint8_t *end;
+  uint32_t byte;
+  int bits;
+  bool marker;  // ketemu marker di tengah entropy data
+} dc_bits_t;
+
+// Tabel standar (ITU T.81 Annex K.3) untuk JPEG tanpa DHT (gaya MJPEG)
+static const uint8_t _k_dc_l_bits[16] = {0, 1, 5, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0};
+static const uint8_t _k_dc_c_bits[16] = {0, 3, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0};
+static const uint8_t _k_dc_vals[12] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11};
+static const uint8_t _k_ac_l_bits[16] = {0, 2, 1, 3, 3, 2, 4, 3, 5, 5, 4, 4, 0, 0, 1, 0x7d};
+static const uint8_t _k_ac_l_vals[162] = {
+  0x01, 0x02, 0x03, 0x00, 0x04, 0x11, 0x05, 0x12, 0x21, 0x31, 0x41, 0x06, 0x13, 0x51, 0x61, 0x07, 0x22, 0x71, 0x14, 0x32, 0x81, 0x91, 0xa1, 0x08, 0x23, 0x42, 0xb1,
+  0xc1, 0x15, 0x52, 0xd1, 0xf0, 0x24, 0x33, 0x62, 0x72, 0x82, 0x09, 0x0a, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x25, 0x26, 0x27, 0x28, 0x29, 0x2a, 0x34, 0x35, 0x36, 0x37,
+  0x38, 0x39, 0x3a, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49, 0x4a, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5a, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69, 0x6a,
+  0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7a, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 0x89, 0x8a, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9a, 0xa2, 0xa3,
+  0xa4, 0xa5, 0xa6, 0xa7, 0xa8, 0xa9, 0xaa, 0xb2, 0xb3, 0xb4, 0xb5, 0xb6, 0xb7, 0xb8, 0xb9, 0xba, 0xc2, 0xc3, 0xc4, 0xc5, 0xc6, 0xc7, 0xc8, 0xc9, 0xca, 0xd2, 0xd3,
+  0xd4, 0xd5, 0xd6, 0xd7, 0xd8, 0xd9, 0xda, 0xe1, 0xe2, 0xe3, 0xe4, 0xe5, 0xe6, 0xe7, 0xe8, 0xe9, 0xea, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8, 0xf9, 0xfa
+};
+static const uint8_t _k_ac_c_bits[16] = {0, 2, 1, 2, 4, 4, 3, 4, 7, 5, 4, 4, 0, 1, 2, 0x77};
+static const uint8_t _k_ac_c_vals[162] = {
+  0x00, 0x01, 0x02, 0x03, 0x11, 0x04, 0x05, 0x21, 0x31, 0x06, 0x12, 0x41, 0x51, 0x07, 0x61, 0x71, 0x13, 0x22, 0x32, 0x81, 0x08, 0x14, 0x42, 0x91, 0xa1, 0xb1, 0xc1,
+  0x09, 0x23, 0x33, 0x52, 0xf0, 0x15, 0x62, 0x72, 0xd1, 0x0a, 0x16, 0x24, 0x34, 0xe1, 0x25, 0xf1, 0x17, 0x18, 0x19, 0x1a, 0x26, 0x27, 0x28, 0x29, 0x2a, 0x35, 0x36,
+  0x37, 0x38, 0x39, 0x3a, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49, 0x4a, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5a, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69,
+  0x6a, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7a, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 0x89, 0x8a, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9a,
+  0xa2, 0xa3, 0xa4, 0xa5, 0xa6, 0xa7, 0xa8, 0xa9, 0xaa, 0xb2, 0xb3, 0xb4, 0xb5, 0xb6, 0xb7, 0xb8, 0xb9, 0xba, 0xc2, 0xc3, 0xc4, 0xc5, 0xc6, 0xc7, 0xc8, 0xc9, 0xca,
+  0xd2, 0xd3, 0xd4, 0xd5, 0xd6, 0xd7, 0xd8, 0xd9, 0xda, 0xe2, 0xe3, 0xe4, 0xe5, 0xe6, 0xe7, 0xe8, 0xe9, 0xea, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8, 0xf9, 0xfa
+};
+
+static bool huff_build(jpeg_dc_huff_t *t, const uint8_t *bits, const uint8_t *vals) {
+  int total = 0;
+  for (int i = 0; i < 16; i++) {
+    total += bits[i];
+  }
+  if (total > 256) {
+    return false;
+  }
+  memcpy(t->vals, vals, total);
+  int32_t code = 0;
+  int k = 0;
+  for (int len = 1; len <= 16; len++) {
+    t->valoff[len] = k - code;
+    code += bits[len - 1];
+    k += bits[len - 1];
+    t->maxcode[len] = bits[len - 1] ? code - 1 : -1;
+    code <<= 1;
+  }
+  t->maxcode[17] = 0x7fffffff;
+  t->valid = true;
+  return true;
+}
+
+static inline int bits_get(dc_bits_t *b) {
+  if (b->bits == 0) {
+    if (b->marker || b->p >= b->end) {
+      b->marker = true;
+      return 0;  // pad nol setelah data habis
+    }
+    uint8_t c = *b->p++;
+    if (c == 0xFF) {
+      if (b->p < b->end && *b->p == 0x00) {
+        b->p++;  // byte stuffing
+      } else {
+        b->p--;  // marker: berhenti di sini, biarkan pemanggil yang menangani
+        b->marker = true;
+        return 0;
+      }
+    }
+    b->byte = c;
+    b->bits = 8;
+  }
+  b->bits--;
+  return (b->byte >> b->bits) & 1;
+}
+
+static inline int bits_receive(dc_bits_t *b, int s) {
+  int v = 0;
+  for (int i = 0; i < s; i++) {
+    v = (v << 1) | bits_get(b);
+  }
+  return v;
+}
+
+static inline int huff_decode(dc_bits_t *b, const jpeg_dc_huff_t *t) {
+  int32_t code = bits_get(b);
+  int len = 1;
+  while (code > t->maxcode[len]) {
+    code = (code << 1) | bits_get(b);
+    if (++len > 16) {
+      return -1;
+    }
+  }
+  return t->vals[t->valoff[len] + code];
+}
+
+static inline int extend(int v, int s) {
+  return v < (1 << (s - 1)) ? v - (1 << s) + 1 : v;
+}
+
+typedef struct {
+  uint8_t id;
+  uint8_t h, v;
+  uint8_t tq;
+  uint8_t td, ta;
+} dc_comp_t;
+
+int jpeg_dc_grid(jpeg_dc_ctx_t *ctx, const uint8_t *jpg, size_t len, uint8_t *grid, int max_cells, uint16_t *out_w, uint16_t *out_h) {
+  if (len < 4 || jpg[0] != 0xFF || jpg[1] != 0xD8) {
+    return 0;
+  }
+  jpeg_dc_huff_t *dc_tab = ctx->dc;
+  jpeg_dc_huff_t *ac_tab = ctx->ac;
+  memset(dc_tab, 0, sizeof(ctx->dc));
+  memset(ac_tab, 0, sizeof(ctx->ac));
+  uint16_t q0[4] = {1, 1, 1, 1};
+  dc_comp_t comp[3] = {};
+  int ncomp = 0, width = 0, height = 0, hmax = 1, vmax = 1;
+  uint16_t restart = 0;
+
+  const uint8_t *p = jpg + 2;
+  const uint8_t *end = jpg + len;
+  const uint8_t *scan = NULL;
+  int scan_ncomp = 0;
+  uint8_t scan_ids[3] = {0};
+
+  while (p + 4 <= end && !scan) {
+    if (p[0] != 0xFF) {
+      return 0;
+    }
+    uint8_t m = p[1];
+    if (m == 0xFF) {
+      p++;
+      continue;
+    }
+    uint16_t seglen = (p[2] << 8) | p[3];
+    const uint8_t *seg = p + 4;
+    const uint8_t *seg_end = p + 2 + seglen;
+    if (seglen < 2 || seg_end > end) {
+      return 0;
+    }
+    // setiap baca seg[] dicek terhadap seg_end: frame terpotong/rusak -> tanpa grid
+    switch (m) {
+      case 0xC0:
+      case 0xC1:
+        if (seg + 6 > seg_end) {
+          return 0;
+        }
+        height = (seg[1] << 8) | seg[2];
+        width = (seg[3] << 8) | seg[4];
+        ncomp = seg[5];
+        if ((ncomp != 1 && ncomp != 3) || seg + 6 + ncomp * 3 > seg_end) {
+          return 0;
+        }
+        hmax = vmax = 1;
+        for (int i = 0; i < ncomp; i++) {
+          comp[i].id = seg[6 + i * 3];
+          comp[i].h = seg[7 + i * 3] >> 4;
+          comp[i].v = seg[7 + i * 3] & 15;
+          comp[i].tq = seg[8 + i * 3] & 3;
+          if (comp[i].h < 1 || comp[i].h > 4 || comp[i].v < 1 || comp[i].v > 4) {
+            return 0;  // sampling factor di luar 1..4 (T.81)
+          }
+          if (comp[i].h > hmax) hmax = comp[i].h;
+          if (comp[i].v > vmax) vmax = comp[i].v;
+        }
+        break;
+      case 0xC2:
+      case 0xC3:
+        return 0;  // progressive/lossless: pakai fallback ukuran
+      case 0xC4: {
+        const uint8_t *t = seg;
+        while (t < seg_end) {
+          if (t + 17 > seg_end) {
+            return 0;
+          }
+          int cls = t[0] >> 4, id = t[0] & 15;
+          int total = 0;
+          for (int i = 0; i < 16; i++) total += t[1 + i];
+          if (cls > 1 || id > 1 || t + 17 + total > seg_end) {
+            return 0;
+          }
+          if (!huff_build(cls ? &ac_tab[id] : &dc_tab[id], t + 1, t + 17)) {
+            return 0;
+          }
+          t += 17 + total;
+        }
+        break;
+      }
+      case 0xDB: {
+        const uint8_t *t = seg;
+        while (t < seg_end) {
+          int pq = t[0] >> 4, id = t[0] & 3;
+          if (t + 1 + (pq ? 128 : 64) > seg_end) {
+            return 0;
+          }
+          q0[id] = pq ? ((t[1] << 8) | t[2]) : t[1];
+          t += 1 + (pq ? 128 : 64);
+        }
+        break;
+      }
+      case 0xDD:
+        if (seg + 2 > seg_end) {
+          return 0;
+        }
+        restart = (seg[0] << 8) | seg[1];
+        break;
+      case 0xDA:
+        if (seg + 1 > seg_end) {
+          return 0;
+        }
+        scan_ncomp = seg[0];
+        if (scan_ncomp != ncomp || seg + 1 + scan_ncomp * 2 > seg_end) {
+          return 0;  // scan non-interleaved tidak didukung
+        }
+        for (int i = 0; i < scan_ncomp; i++) {
+          scan_ids[i] = seg[1 + i * 2];
+          bool matched = false;
+          for (int c = 0; c < ncomp; c++) {
+            if (comp[c].id == scan_ids[i]) {
+              comp[c].td = (seg[2 + i * 2] >> 4) & 1;
+              comp[c].ta = seg[2 + i * 2] & 1;
+              matched = true;
+            }
+          }
+          if (!matched) {
+            return 0;  // komponen scan tidak ada di SOF
+          }
+        }
+        scan = seg_end;
+        break;
+      default:
+        break;
+    }
+    p += 2 + seglen;
+  }
+  if (!scan || !width || !height || !ncomp) {
+    return 0;
+  }
+
+  // JPEG tanpa DHT (MJPEG) -> tabel standar
+  if (!dc_tab[0].valid) huff_build(&dc_tab[0], _k_dc_l_bits, _k_dc_vals);
+  if (!dc_tab[1].valid) huff_build(&dc_tab[1], _k_dc_c_bits, _k_dc_vals);
+  if (!ac_tab[0].valid) huff_build(&ac_tab[0], _k_ac_l_bits, _k_ac_l_vals);
+  if (!ac_tab[1].valid) huff_build(&ac_tab[1], _k_ac_c_bits, _k_ac_c_vals);
+
+  int mcu_w = 8 * (ncomp == 1 ? 1 : hmax);
+  int mcu_h = 8 * (ncomp == 1 ? 1 : vmax);
+  int mcux = (width + mcu_w - 1) / mcu_w;
+  int mcuy = (height + mcu_h - 1) / mcu_h;
+
+  // binning supaya grid muat di max_cells
+  int bin = 1;
+  while (((mcux + bin - 1) / bin) * ((mcuy + bin - 1) / bin) > max_cells) {
+    bin++;
+  }
+  int gw = (mcux + bin - 1) / bin;
+  int gh = (mcuy + bin - 1) / bin;
+
+  // akumulasi per baris grid: satu baris dikumpulkan lalu ditulis
+  uint32_t *row_sum = ctx->row_sum;
+  uint16_t *row_cnt = ctx->row_cnt;
+  if (gw > SCENE_GRID_MAX_W) {
+    return 0;
+  }
+
+  dc_bits_t br = {scan, end, 0, 0, false};
+  int pred[3] = {0, 0, 0};
+  int mcus_left = restart;
+  int luma = 0;  // komponen pertama = Y
+  int qy = q0[comp[luma].tq];
+  int blocks_y = ncomp == 1 ? 1 : comp[luma].h * comp[luma].v;
+
+  for (int my = 0; my < mcuy; my++) {
+    if (my % bin == 0) {
+      memset(row_sum, 0, gw * sizeof(uint32_t));
+      memset(row_cnt, 0, gw * sizeof(uint16_t));
+    }
+    for (int mx = 0; mx < mcux; mx++) {
+      if (restart) {
+        if (mcus_left == 0) {
+          // RSTn: sejajarkan ke byte, lewati marker, reset prediktor
+          br.bits = 0;
+          if (br.p + 1 >= end || br.p[0] != 0xFF || br.p[1] < 0xD0 || br.p[1] > 0xD7) {
+            return 0;  // RSTn hilang: data terpotong atau rusak
+          }
+          br.p += 2;
+          br.marker = false;
+          pred[0] = pred[1] = pred[2] = 0;
+          mcus_left = restart;
+        }
+        mcus_left--;
+      }
+      int ysum = 0;
+      for (int c = 0; c < ncomp; c++) {
+        int nblocks = ncomp == 1 ? 1 : comp[c].h * comp[c].v;
+        const jpeg_dc_huff_t *dt = &dc_tab[comp[c].td];
+        const jpeg_dc_huff_t *at = &ac_tab[comp[c].ta];
+        for (int b = 0; b < nblocks; b++) {
+          int s = huff_decode(&br, dt);
+          if (s < 0 || s > 11) {
+            return 0;
+          }
+          int diff = s ? extend(bits_receive(&br, s), s) : 0;
+          pred[c] += diff;
+          if (c == luma) {
+            ysum += pred[c];
+          }
+          for (int k = 1; k < 64;) {
+            int rs = huff_decode(&br, at);
+            if (rs < 0) {
+              return 0;
+            }
+            int r = rs >> 4, sz = rs & 15;
+            if (sz == 0) {
+              if (r != 15) {
+                break;  // EOB
+              }
+              k += 16;
+            } else {
+              bits_receive(&br, sz);
+              k += r + 1;
+            }
+          }
+        }
+      }
+      if (br.marker && (my < mcuy - 1 || mx < mcux - 1)) {
+        return 0;  // data habis sebelum MCU terakhir
+      }
+      // DC*Q/8 = rata-rata piksel blok - 128
+      int mean = (ysum / blocks_y) * qy / 8 + 128;
+      row_sum[mx / bin] += mean < 0 ? 0 : (mean > 255 ? 255 : mean);
+      row_cnt[mx / bin]++;
+    }
+    if (my % bin == bin - 1 || my == mcuy - 1) {
+      uint8_t *out = grid + (my / bin) * gw;
+      for (int i = 0; i < gw; i++) {
+        out[i] = row_cnt[i] ? row_sum[i] / row_cnt[i] : 0;
+      }
+    }
+  }
+  *out_w = gw;
+  *out_h = gh;
+  return gw * gh;
+}
+
+// ---------- Scene detector ----------
+void scene_detector_init(scene_detector_t *d) {
+  memset(d, 0, sizeof(*d));
+  d->cell_delta = 10;
+  d->min_permille = 15;
+  d->size_permille = 60;
+}
+
+bool scene_detector_update(scene_detector_t *d, const uint8_t *jpg, size_t len, int64_t now_us) {
+  uint16_t w = 0, h = 0;
+  bool changed;
+  d->frames++;
+  int cells = jpeg_dc_grid(&d->ctx, jpg, len, d->cur, SCENE_GRID_MAX, &w, &h);
+  if (cells > 0) {
+    if (w != d->w || h != d->h) {
+      changed = true;  // framesize berubah (mis. ABR) -> referensi baru
+    } else {
+      int diff = 0;
+      for (int i = 0; i < cells; i++) {
+        int delta = (int)d->cur[i] - (int)d->ref[i];
+        if (delta > d->cell_delta || -delta > d->cell_delta) {
+          diff++;
+        }
+      }
+      // minimal 2 sel supaya satu sel noise tidak memicu
+      changed = diff >= 2 && diff * 1000 >= cells * d->min_permille;
+    }
+    if (changed) {
+      memcpy(d->ref, d->cur, cells);
+      d->w = w;
+      d->h = h;
+    }
+  } else {
+    d->dc_failures++;
+    size_t ref = d->ref_len ? d->ref_len : 1;
+    size_t delta = len > d->ref_len ? len - d->ref_len : d->ref_len - len;
+    changed = d->w != 0 || delta * 1000 >= ref * d->size_permille;
+    d->w = d->h = 0;
+  }
+  if (changed) {
+    d->ref_len = len;
+    d->scene++;
+    d->changes++;
+    d->changed_us = now_us;
+  }
+  return changed;
+}
+
+// ---------- Gate per klien ----------
+void frame_gate_init(frame_gate_t *g, uint32_t keepalive_ms) {
+  memset(g, 0, sizeof(*g));
+  g->keepalive_ms = keepalive_ms;
+  g->hold_ms = 1000;
+  g->last_scene = 0xFFFFFFFF;
+}
+
+bool frame_gate_pass(frame_gate_t *g, uint32_t scene, int64_t changed_us, int64_t now_us) {
+  bool pass = g->keepalive_ms == 0                                   // gate mati
+              || scene != g->last_scene                              // scene baru
+              || now_us - changed_us < (int64_t)g->hold_ms * 1000    // masih ada gerakan
+              || now_us - g->last_sent_us >= (int64_t)g->keepalive_ms * 1000;
+  if (pass) {
+    g->last_scene = scene;
+    g->last_sent_us = now_us;
+    g->passed++;
+  } else {
+    g->skipped++;
+  }
+  return pass;
+}
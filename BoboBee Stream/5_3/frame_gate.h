@@ -0,0 +1,67 @@
+#pragma once
+// Deteksi perubahan scene + gate kirim frame (tanpa decode JPEG penuh).
+//
+// Signature per frame = koefisien DC luma tiap MCU (rata-rata blok 8x8),
+// diambil dengan decode Huffman saja: tanpa IDCT dan tanpa alokasi. Hasilnya
+// thumbnail kecil (maks SCENE_GRID_MAX sel) yang dibandingkan dengan
+// referensi. Kalau JPEG tidak bisa di-parse (progressive, terpotong),
+// fallback ke selisih ukuran JPEG.
+// Tabel Huffman dan akumulator ikut di dalam struct (~4.5 KB), bukan di
+// stack, supaya aman dipanggil dari task httpd; alokasikan di PSRAM.
+//
+// Murni logika, tanpa header ESP, supaya bisa dites dengan rekaman frame.
+#include <stdint.h>
+#include <stddef.h>
+
+#define SCENE_GRID_MAX 1024
+#define SCENE_GRID_MAX_W 128
+
+typedef struct {
+  int32_t maxcode[18];
+  int32_t valoff[17];
+  uint8_t vals[256];
+  bool valid;
+} jpeg_dc_huff_t;
+
+typedef struct {
+  jpeg_dc_huff_t dc[2];
+  jpeg_dc_huff_t ac[2];
+  uint32_t row_sum[SCENE_GRID_MAX_W];
+  uint16_t row_cnt[SCENE_GRID_MAX_W];
+} jpeg_dc_ctx_t;
+
+typedef struct {
+  jpeg_dc_ctx_t ctx;
+  uint8_t ref[SCENE_GRID_MAX];
+  uint8_t cur[SCENE_GRID_MAX];
+  uint16_t w;
+  uint16_t h;
+  size_t ref_len;
+  uint8_t cell_delta;       // selisih DC (skala 0..255) agar sel dianggap berubah
+  uint16_t min_permille;    // sel berubah minimal (per mil) agar scene berubah
+  uint16_t size_permille;   // fallback: selisih ukuran JPEG (per mil)
+  uint32_t scene;           // naik setiap kali scene berubah
+  int64_t changed_us;
+  uint32_t frames;
+  uint32_t changes;
+  uint32_t dc_failures;
+} scene_detector_t;
+
+// Ekstrak grid DC luma. Return jumlah sel (w*h) atau 0 kalau gagal.
+int jpeg_dc_grid(jpeg_dc_ctx_t *ctx, const uint8_t *jpg, size_t len, uint8_t *grid, int max_cells, uint16_t *w, uint16_t *h);
+
+void scene_detector_init(scene_detector_t *d);
+// Return true kalau frame ini dianggap scene baru (d->scene naik).
+bool scene_detector_update(scene_detector_t *d, const uint8_t *jpg, size_t len, int64_t now_us);
+
+typedef struct {
+  uint32_t keepalive_ms;  // 0 = gate mati, kirim semua frame
+  uint32_t hold_ms;       // tetap full rate selama ini setelah perubahan terakhir
+  uint32_t last_scene;
+  int64_t last_sent_us;
+  uint32_t passed;
+  uint32_t skipped;
+} frame_gate_t;
+
+void frame_gate_init(frame_gate_t *g, uint32_t keepalive_ms);
+bool frame_gate_pass(frame_gate_t *g, uint32_t scene, int64_t changed_us, int64_t now_us);
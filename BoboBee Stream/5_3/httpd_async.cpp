@@ -0,0 +1,84 @@
+#include "httpd_async.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+
+#if defined(ARDUINO_ARCH_ESP32) && defined(CONFIG_ARDUHAL_ESP_LOG)
+#include "esp32-hal-log.h"
+#endif
+
+typedef struct {
+  httpd_req_t *req;
+  httpd_async_fn_t fn;
+} httpd_async_job_t;
+
+static QueueHandle_t _async_queue = NULL;
+static SemaphoreHandle_t _async_idle = NULL;  // jumlah worker yang sedang menganggur
+static TaskHandle_t _async_workers[HTTPD_ASYNC_WORKERS];
+
+static void async_worker_task(void *) {
+  httpd_async_job_t job;
+  for (;;) {
+    xSemaphoreGive(_async_idle);
+    if (xQueueReceive(_async_queue, &job, portMAX_DELAY) != pdTRUE) {
+      continue;
+    }
+    job.fn(job.req);
+    if (httpd_req_async_handler_complete(job.req) != ESP_OK) {
+      log_e("Failed to complete async request");
+    }
+  }
+}
+
+bool httpd_async_start(void) {
+  if (_async_queue) {
+    return true;
+  }
+  _async_queue = xQueueCreate(HTTPD_ASYNC_WORKERS, sizeof(httpd_async_job_t));
+  _async_idle = xSemaphoreCreateCounting(HTTPD_ASYNC_WORKERS, 0);
+  if (!_async_queue || !_async_idle) {
+    log_e("Failed to create async queue");
+    return false;
+  }
+  for (int i = 0; i < HTTPD_ASYNC_WORKERS; i++) {
+    if (xTaskCreatePinnedToCore(async_worker_task, "HttpdAsync", 4096, NULL, 5, &_async_workers[i], tskNO_AFFINITY) != pdPASS) {
+      log_e("Failed to start async worker %d", i);
+      return false;
+    }
+  }
+  log_i("Async httpd workers started: %d", HTTPD_ASYNC_WORKERS);
+  return true;
+}
+
+bool httpd_async_is_worker(void) {
+  TaskHandle_t self = xTaskGetCurrentTaskHandle();
+  for (int i = 0; i < HTTPD_ASYNC_WORKERS; i++) {
+    if (_async_workers[i] == self) {
+      return true;
+    }
+  }
+  return false;
+}
+
+esp_err_t httpd_async_submit(httpd_req_t *req, httpd_async_fn_t fn) {
+  // tolak langsung kalau tidak ada worker kosong; antre di sini berarti
+  // menunggu stream lain selesai, bisa selamanya
+  if (!httpd_async_start() || xSemaphoreTake(_async_idle, 0) != pdTRUE) {
+    httpd_resp_set_status(req, "503 Service Unavailable");
+    httpd_resp_set_hdr(req, "Retry-After", "1");
+    return httpd_resp_send(req, NULL, 0);
+  }
+
+  httpd_async_job_t job = {NULL, fn};
+  if (httpd_req_async_handler_begin(req, &job.req) != ESP_OK) {
+    xSemaphoreGive(_async_idle);
+    return httpd_resp_send_500(req);
+  }
+  if (xQueueSend(_async_queue, &job, 0) != pdTRUE) {
+    httpd_req_async_handler_complete(job.req);
+    xSemaphoreGive(_async_idle);
+    return ESP_FAIL;
+  }
+  return ESP_OK;
+}
@@ -0,0 +1,26 @@
+#pragma once
+// Worker pool untuk handler httpd yang lama (mis. /stream).
+//
+// esp_http_server hanya punya satu task; handler yang loop terus (stream)
+// membuat semua URI lain di port yang sama macet. Handler seperti itu
+// memanggil httpd_async_submit(): request di-copy lewat
+// httpd_req_async_handler_begin() lalu dijalankan ulang di task worker,
+// sementara task httpd langsung bebas melayani /status, /control, dst.
+//
+//   static esp_err_t stream_handler(httpd_req_t *req) {
+//     if (!httpd_async_is_worker()) {
+//       return httpd_async_submit(req, stream_handler);
+//     }
+//     ... loop stream ...
+//   }
+#include "esp_http_server.h"
+
+#ifndef HTTPD_ASYNC_WORKERS
+#define HTTPD_ASYNC_WORKERS 4
+#endif
+
+typedef esp_err_t (*httpd_async_fn_t)(httpd_req_t *req);
+
+bool httpd_async_start(void);                              // idempotent
+bool httpd_async_is_worker(void);
+esp_err_t httpd_async_submit(httpd_req_t *req, httpd_async_fn_t fn);  // 503 kalau semua worker sibuk
@@ -0,0 +1,158 @@
+#include "mjpeg_framing.h"
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+
+#if defined(ESP_PLATFORM)
+#include "lwip/sockets.h"
+#include "esp_timer.h"
+#define MJPEG_WRITEV lwip_writev
+#define MJPEG_SETSOCKOPT lwip_setsockopt
+#define MJPEG_NOW_US() esp_timer_get_time()
+#else
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <time.h>
+#define MJPEG_WRITEV writev
+#define MJPEG_SETSOCKOPT setsockopt
+static int64_t mjpeg_now_us(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+#define MJPEG_NOW_US() mjpeg_now_us()
+#endif
+
+#if defined(ARDUINO_ARCH_ESP32) && defined(CONFIG_ARDUHAL_ESP_LOG)
+#include "esp32-hal-log.h"
+#endif
+
+// writev sampai semua iovec terkirim (socket blocking bisa partial write).
+// Socket httpd punya SO_SNDTIMEO (send_wait_timeout): EAGAIN berarti viewer
+// macet selama itu, jadi stream diakhiri seperti httpd_resp_send_chunk yang
+// gagal karena timeout; kalau diulang, handler tidak pernah kembali dan
+// memegang worker async + slot broadcaster selamanya.
+static esp_err_t writev_all(mjpeg_writer_t *w, struct iovec *iov, int cnt) {
+  while (cnt > 0) {
+    ssize_t n = MJPEG_WRITEV(w->fd, iov, cnt);
+    w->writes++;
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        return ESP_ERR_TIMEOUT;
+      }
+      return ESP_FAIL;
+    }
+    w->bytes += n;
+    while (cnt > 0 && (size_t)n >= iov->iov_len) {
+      n -= iov->iov_len;
+      iov++;
+      cnt--;
+    }
+    if (cnt > 0) {
+      iov->iov_base = (char *)iov->iov_base + n;
+      iov->iov_len -= n;
+    }
+  }
+  return ESP_OK;
+}
+
+size_t mjpeg_format_prefix(mjpeg_writer_t *w, size_t len, const struct timeval *ts) {
+  char *p = w->prefix + w->fixed_len;
+  size_t room = MJPEG_PREFIX_MAX - w->fixed_len;
+  int n;
+  if (w->timestamp && ts) {
+    n = snprintf(p, room, "%u\r\nX-Timestamp: %lld.%06ld\r\n\r\n", (unsigned)len, (long long)ts->tv_sec, (long)ts->tv_usec);
+  } else {
+    n = snprintf(p, room, "%u\r\n\r\n", (unsigned)len);
+  }
+  return w->fixed_len + (size_t)n;
+}
+
+esp_err_t mjpeg_stream_begin(mjpeg_writer_t *w, httpd_req_t *req, const char *boundary, bool timestamp, const char *extra_hdrs) {
+  memset(w, 0, sizeof(*w));
+  w->fd = httpd_req_to_sockfd(req);
+  w->timestamp = timestamp;
+  if (w->fd < 0) {
+    return ESP_FAIL;
+  }
+
+  int one = 1;
+  MJPEG_SETSOCKOPT(w->fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+  int n = snprintf(
+    w->prefix, MJPEG_PREFIX_MAX, "\r\n--%s\r\nContent-Type: image/jpeg\r\nContent-Length: ", boundary
+  );
+  if (n <= 0 || n >= MJPEG_PREFIX_MAX - 64) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  w->fixed_len = n;
+
+  char head[320];
+  n = snprintf(
+    head, sizeof(head), "HTTP/1.1 200 OK\r\nContent-Type: multipart/x-mixed-replace;boundary=%s\r\n%sCache-Control: no-cache\r\nConnection: close\r\n\r\n",
+    boundary, extra_hdrs ? extra_hdrs : ""
+  );
+  if (n <= 0 || n >= (int)sizeof(head)) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  struct iovec iov = {head, (size_t)n};
+  esp_err_t res = writev_all(w, &iov, 1);
+  w->bytes = 0;  // hitung overhead per frame saja
+  w->writes = 0;
+  return res;
+}
+
+esp_err_t mjpeg_stream_write(mjpeg_writer_t *w, const uint8_t *buf, size_t len, const struct timeval *ts) {
+  struct iovec iov[2];
+  int64_t t0 = MJPEG_NOW_US();
+  iov[0].iov_base = w->prefix;
+  iov[0].iov_len = mjpeg_format_prefix(w, len, ts);
+  iov[1].iov_base = (void *)buf;
+  iov[1].iov_len = len;
+  int64_t t1 = MJPEG_NOW_US();
+  esp_err_t res = writev_all(w, iov, 2);
+  w->prefix_us = (uint32_t)(t1 - t0);
+  w->send_us = (uint32_t)(MJPEG_NOW_US() - t1);
+  if (res == ESP_OK) {
+    w->frames++;
+  }
+  return res;
+}
+
+void mjpeg_stream_end(mjpeg_writer_t *w, httpd_req_t *req) {
+  if (w->fd >= 0) {
+    httpd_sess_trigger_close(req->handle, w->fd);
+  }
+}
+
+esp_err_t mjpeg_body_begin(mjpeg_writer_t *w, httpd_req_t *req, const char *content_type, size_t content_length, const char *extra_hdrs) {
+  memset(w, 0, sizeof(*w));
+  w->fd = httpd_req_to_sockfd(req);
+  if (w->fd < 0) {
+    return ESP_FAIL;
+  }
+  char head[320], length[32] = "";
+  if (content_length) {
+    snprintf(length, sizeof(length), "Content-Length: %u\r\n", (unsigned)content_length);
+  }
+  int n = snprintf(
+    head, sizeof(head), "HTTP/1.1 200 OK\r\nContent-Type: %s\r\n%s%sConnection: close\r\n\r\n", content_type, length,
+    extra_hdrs ? extra_hdrs : ""
+  );
+  if (n <= 0 || n >= (int)sizeof(head)) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  struct iovec iov = {head, (size_t)n};
+  esp_err_t res = writev_all(w, &iov, 1);
+  w->bytes = 0;
+  w->writes = 0;
+  return res;
+}
+
+esp_err_t mjpeg_writev(mjpeg_writer_t *w, struct iovec *iov, int cnt) {
+  return writev_all(w, iov, cnt);
+}
@@ -0,0 +1,44 @@
+#pragma once
+// Framing MJPEG: satu writev per frame.
+//
+// Jalur lama memanggil httpd_resp_send_chunk tiga kali per frame (boundary,
+// header part, payload); tiap chunk = 3 socket send (panjang hex, data,
+// CRLF). Di sini response stream ditutup dengan Connection: close sehingga
+// tidak perlu chunked encoding sama sekali, dan boundary + header part
+// digabung dalam satu prefix yang bagian konstannya disiapkan sekali di
+// mjpeg_stream_begin(). Payload dikirim langsung dari buffer frame (tanpa
+// copy) sebagai iovec kedua.
+#include <stdint.h>
+#include <stddef.h>
+#include <sys/time.h>
+#include <sys/uio.h>
+#include "esp_http_server.h"
+
+#define MJPEG_PREFIX_MAX 192
+
+typedef struct {
+  int fd;
+  bool timestamp;           // tambahkan header X-Timestamp
+  size_t fixed_len;         // panjang bagian prefix yang konstan
+  char prefix[MJPEG_PREFIX_MAX];
+  uint32_t frames;
+  uint64_t bytes;           // total byte di wire setelah response header
+  uint32_t writes;          // jumlah panggilan writev
+  uint32_t prefix_us;       // frame terakhir: susun boundary + header
+  uint32_t send_us;         // frame terakhir: writev prefix + payload
+} mjpeg_writer_t;
+
+// Susun prefix frame: bagian konstan sudah ada di prefix[0..fixed_len).
+size_t mjpeg_format_prefix(mjpeg_writer_t *w, size_t len, const struct timeval *ts);
+
+// Kirim status line + header, set TCP_NODELAY. extra_hdrs: "Name: val\r\n..." atau NULL.
+esp_err_t mjpeg_stream_begin(mjpeg_writer_t *w, httpd_req_t *req, const char *boundary, bool timestamp, const char *extra_hdrs);
+// ESP_ERR_TIMEOUT kalau viewer tidak membaca selama send_wait_timeout (akhiri stream).
+esp_err_t mjpeg_stream_write(mjpeg_writer_t *w, const uint8_t *buf, size_t len, const struct timeval *ts);
+void mjpeg_stream_end(mjpeg_writer_t *w, httpd_req_t *req);  // tutup sesi (body dibatasi close)
+
+// Response biasa (bukan multipart) lewat jalur writev yang sama, mis. AVI /clip.
+// content_length 0 = tanpa Content-Length (body sampai close, mis. /tensor?stream=1).
+// Akhiri dengan mjpeg_stream_end().
+esp_err_t mjpeg_body_begin(mjpeg_writer_t *w, httpd_req_t *req, const char *content_type, size_t content_length, const char *extra_hdrs);
+esp_err_t mjpeg_writev(mjpeg_writer_t *w, struct iovec *iov, int cnt);  // iov boleh diubah
@@ -0,0 +1,115 @@
+#include "stream_hist.h"
+#include <stdio.h>
+#include <string.h>
+
+// 100 us .. 2.5 s, kira-kira 1-2.5-5 per dekade
+const uint32_t HIST_LATENCY_US[HIST_LATENCY_US_COUNT] = {100,   250,    500,    1000,   2500,   5000,    10000,
+                                                         25000, 50000, 100000, 250000, 500000, 1000000, 2500000};
+// 2 KB .. 512 KB (QQVGA q63 .. UXGA q4)
+const uint32_t HIST_FRAME_BYTES[HIST_FRAME_BYTES_COUNT] = {2048, 4096, 8192, 16384, 32768, 65536, 131072, 262144, 524288};
+
+bool hist_init(hist_t *h, const uint32_t *bounds, uint8_t n) {
+  memset(h, 0, sizeof(*h));
+  if (n > HIST_MAX_BUCKETS) {
+    return false;
+  }
+  for (int i = 1; i < n; i++) {
+    if (bounds[i] <= bounds[i - 1]) {
+      return false;
+    }
+  }
+  h->bounds = bounds;
+  h->n = n;
+  return true;
+}
+
+int hist_bucket(const hist_t *h, uint32_t v) {
+  // bucket pertama dengan v <= bound
+  int lo = 0, hi = h->n;
+  while (lo < hi) {
+    int mid = (lo + hi) >> 1;
+    if (v <= h->bounds[mid]) {
+      hi = mid;
+    } else {
+      lo = mid + 1;
+    }
+  }
+  return lo;
+}
+
+void hist_observe(hist_t *h, uint32_t v) {
+  __atomic_fetch_add(&h->counts[hist_bucket(h, v)], 1, __ATOMIC_RELAXED);
+  __atomic_fetch_add(&h->sum, (uint64_t)v, __ATOMIC_RELAXED);
+}
+
+void hist_snapshot(const hist_t *h, hist_t *out) {
+  out->bounds = h->bounds;
+  out->n = h->n;
+  for (int i = 0; i <= HIST_MAX_BUCKETS; i++) {
+    out->counts[i] = i <= h->n ? __atomic_load_n(&h->counts[i], __ATOMIC_RELAXED) : 0;
+  }
+  out->sum = __atomic_load_n(&h->sum, __ATOMIC_RELAXED);
+}
+
+uint32_t hist_count(const hist_t *snap) {
+  uint32_t total = 0;
+  for (int i = 0; i <= snap->n; i++) {
+    total += snap->counts[i];
+  }
+  return total;
+}
+
+double hist_quantile(const hist_t *snap, double q) {
+  uint32_t total = hist_count(snap);
+  if (total == 0 || snap->n == 0) {
+    return 0;
+  }
+  if (q < 0) {
+    q = 0;
+  } else if (q > 1) {
+    q = 1;
+  }
+  double rank = q * total;
+  uint32_t below = 0;
+  for (int i = 0; i < snap->n; i++) {
+    uint32_t c = snap->counts[i];
+    if (c > 0 && below + c >= rank) {
+      double lower = i ? snap->bounds[i - 1] : 0;
+      return lower + (snap->bounds[i] - lower) * ((rank - below) / c);
+    }
+    below += c;
+  }
+  return snap->bounds[snap->n - 1];  // jatuh di +Inf
+}
+
+int hist_print_prom(char *p, size_t cap, const char *name, const char *labels, const hist_t *h, double scale) {
+  hist_t s;
+  hist_snapshot(h, &s);
+  const char *sep = labels && labels[0] ? "," : "";
+  if (!labels) {
+    labels = "";
+  }
+  size_t len = 0;
+  uint32_t cum = 0;
+  int n;
+  for (int i = 0; i <= s.n; i++) {
+    cum += s.counts[i];
+    if (i < s.n) {
+      n = snprintf(p + len, cap - len, "%s_bucket{%s%sle=\"%g\"} %u\n", name, labels, sep, s.bounds[i] * scale, (unsigned)cum);
+    } else {
+      n = snprintf(p + len, cap - len, "%s_bucket{%s%sle=\"+Inf\"} %u\n", name, labels, sep, (unsigned)cum);
+    }
+    if (n < 0 || (size_t)n >= cap - len) {
+      return -1;
+    }
+    len += n;
+  }
+  const char *open = labels[0] ? "{" : "";
+  const char *close = labels[0] ? "}" : "";
+  n = snprintf(p + len, cap - len, "%s_sum%s%s%s %.9g\n%s_count%s%s%s %u\n", name, open, labels, close, (double)s.sum * scale, name, open, labels,
+               close, (unsigned)cum);
+  if (n < 0 || (size_t)n >= cap - len) {
+    return -1;
+  }
+  return (int)(len + n);
+}
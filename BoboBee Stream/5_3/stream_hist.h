@@ -0,0 +1,46 @@
+#pragma once
+// Histogram bucket tetap untuk telemetri stream (latensi per tahap, ukuran
+// frame), format eksposisi Prometheus.
+//
+// hist_observe() hanya mencari bucket (binary search, maks 16 batas) lalu
+// dua atomic add relaxed; tanpa lock, aman dipanggil dari task capture dan
+// worker stream sekaligus. Pembaca mengambil snapshot; snapshot bisa
+// tertinggal satu-dua observasi dari sum, tapi _count selalu sama dengan
+// bucket +Inf karena dihitung dari bucket.
+//
+// Murni logika, tanpa header ESP, supaya bisa dites di host
+// (tools/hist_check.cpp).
+#include <stdint.h>
+#include <stddef.h>
+
+#define HIST_MAX_BUCKETS 16
+
+// Batas atas inklusif (Prometheus "le"), naik; bucket +Inf implisit.
+#define HIST_LATENCY_US_COUNT 14
+#define HIST_FRAME_BYTES_COUNT 9
+extern const uint32_t HIST_LATENCY_US[HIST_LATENCY_US_COUNT];
+extern const uint32_t HIST_FRAME_BYTES[HIST_FRAME_BYTES_COUNT];
+
+typedef struct {
+  const uint32_t *bounds;
+  uint8_t n;                               // jumlah bounds
+  uint32_t counts[HIST_MAX_BUCKETS + 1];   // per bucket (bukan kumulatif), [n] = +Inf
+  uint64_t sum;
+} hist_t;
+
+// false kalau n > HIST_MAX_BUCKETS atau bounds tidak naik.
+bool hist_init(hist_t *h, const uint32_t *bounds, uint8_t n);
+int hist_bucket(const hist_t *h, uint32_t v);  // indeks bucket untuk v (n = +Inf)
+void hist_observe(hist_t *h, uint32_t v);
+void hist_snapshot(const hist_t *h, hist_t *out);
+uint32_t hist_count(const hist_t *snap);
+
+// Kuantil q (0..1) dengan interpolasi linear di dalam bucket, seperti
+// histogram_quantile() Prometheus. Bucket +Inf dilaporkan sebagai batas
+// terakhir. 0 kalau kosong.
+double hist_quantile(const hist_t *snap, double q);
+
+// Baris sampel _bucket/_sum/_count untuk satu seri. labels: 'stage="send"'
+// atau NULL; scale mengubah satuan (mis. 1e-6 untuk us -> detik).
+// Return panjang, atau -1 kalau cap tidak cukup.
+int hist_print_prom(char *p, size_t cap, const char *name, const char *labels, const hist_t *h, double scale);
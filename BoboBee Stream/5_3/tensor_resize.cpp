@@ -0,0 +1,126 @@
+#include "tensor_resize.h"
+#include <string.h>
+
+#define TENSOR_FRAC 10
+#define TENSOR_ONE  (1 << TENSOR_FRAC)
+#define TENSOR_HALF (1u << (2 * TENSOR_FRAC - 1))
+
+tensor_rect_t tensor_center_crop(uint16_t src_w, uint16_t src_h, uint16_t dst_w, uint16_t dst_h) {
+  tensor_rect_t r = {0, 0, src_w, src_h};
+  if (!dst_w || !dst_h) {
+    return r;
+  }
+  // bandingkan rasio tanpa pembagian: src_w/src_h vs dst_w/dst_h
+  if ((uint32_t)src_w * dst_h > (uint32_t)src_h * dst_w) {
+    r.w = (uint16_t)(((uint32_t)src_h * dst_w + dst_h / 2) / dst_h);
+  } else {
+    r.h = (uint16_t)(((uint32_t)src_w * dst_h + dst_w / 2) / dst_w);
+  }
+  r.x = (src_w - r.w) / 2;
+  r.y = (src_h - r.h) / 2;
+  return r;
+}
+
+int tensor_jpeg_scale(uint16_t src_w, uint16_t src_h, uint16_t dst_w, uint16_t dst_h) {
+  for (int shift = 3; shift > 0; shift--) {
+    tensor_rect_t c = tensor_center_crop(src_w >> shift, src_h >> shift, dst_w, dst_h);
+    if (c.w >= dst_w && c.h >= dst_h) {
+      return shift;
+    }
+  }
+  return 0;
+}
+
+// Posisi sampel half-pixel: src = (dst + 0.5) * in / out - 0.5, dalam 1/1024 piksel.
+// Hasil: indeks kiri (0..in-2) dan bobot kanan 0..TENSOR_ONE.
+static inline void bilinear_tap(uint32_t d, uint16_t in, uint16_t out, uint16_t *i0, uint16_t *w) {
+  int32_t pos = (int32_t)((((int64_t)(2 * d + 1) * in - out) * TENSOR_ONE) / (2 * out));
+  if (pos < 0) {
+    pos = 0;
+  }
+  int32_t i = pos >> TENSOR_FRAC;
+  int32_t f = pos & (TENSOR_ONE - 1);
+  if (i >= in - 1) {
+    i = in - 2;  // sampel di tepi kanan: ambil penuh piksel terakhir
+    f = TENSOR_ONE;
+  }
+  *i0 = (uint16_t)i;
+  *w = (uint16_t)f;
+}
+
+bool tensor_scaler_init(tensor_scaler_t *s, uint16_t src_w, uint16_t src_h, uint16_t dst_w, uint16_t dst_h, uint8_t channels) {
+  if (dst_w < TENSOR_MIN_DIM || dst_h < TENSOR_MIN_DIM || dst_w > TENSOR_MAX_DIM || dst_h > TENSOR_MAX_DIM) {
+    return false;
+  }
+  if (src_w < 2 || src_h < 2 || (channels != 1 && channels != 3)) {
+    return false;
+  }
+  s->src_w = src_w;
+  s->src_h = src_h;
+  s->dst_w = dst_w;
+  s->dst_h = dst_h;
+  s->channels = channels;
+  s->crop = tensor_center_crop(src_w, src_h, dst_w, dst_h);
+  if (s->crop.w < 2 || s->crop.h < 2) {
+    return false;
+  }
+  for (uint16_t x = 0; x < dst_w; x++) {
+    bilinear_tap(x, s->crop.w, dst_w, &s->x0[x], &s->wx[x]);
+    s->x0[x] += s->crop.x;
+  }
+  return true;
+}
+
+void tensor_scale_rgb888(const tensor_scaler_t *s, const uint8_t *src, size_t stride, uint8_t *dst) {
+  for (uint16_t y = 0; y < s->dst_h; y++) {
+    uint16_t y0, wy;
+    bilinear_tap(y, s->crop.h, s->dst_h, &y0, &wy);
+    const uint8_t *r0 = src + (size_t)(y0 + s->crop.y) * stride;
+    const uint8_t *r1 = r0 + stride;
+    uint32_t wy1 = wy, wy0 = TENSOR_ONE - wy;
+
+    if (s->channels == 3) {
+      for (uint16_t x = 0; x < s->dst_w; x++) {
+        const uint8_t *a = r0 + s->x0[x] * 3;
+        const uint8_t *b = r1 + s->x0[x] * 3;
+        uint32_t wx1 = s->wx[x], wx0 = TENSOR_ONE - wx1;
+        for (int c = 0; c < 3; c++) {
+          uint32_t top = a[c] * wx0 + a[c + 3] * wx1;
+          uint32_t bot = b[c] * wx0 + b[c + 3] * wx1;
+          dst[c] = (uint8_t)((top * wy0 + bot * wy1 + TENSOR_HALF) >> (2 * TENSOR_FRAC));
+        }
+        dst += 3;
+      }
+    } else {
+      // luma BT.601 (x256); linear, jadi boleh diinterpolasi sebelum dibulatkan
+      for (uint16_t x = 0; x < s->dst_w; x++) {
+        const uint8_t *a = r0 + s->x0[x] * 3;
+        const uint8_t *b = r1 + s->x0[x] * 3;
+        uint32_t wx1 = s->wx[x], wx0 = TENSOR_ONE - wx1;
+        uint32_t la0 = 77 * a[0] + 150 * a[1] + 29 * a[2];
+        uint32_t la1 = 77 * a[3] + 150 * a[4] + 29 * a[5];
+        uint32_t lb0 = 77 * b[0] + 150 * b[1] + 29 * b[2];
+        uint32_t lb1 = 77 * b[3] + 150 * b[4] + 29 * b[5];
+        uint32_t top = (la0 * wx0 + la1 * wx1) >> TENSOR_FRAC;
+        uint32_t bot = (lb0 * wx0 + lb1 * wx1) >> TENSOR_FRAC;
+        *dst++ = (uint8_t)((top * wy0 + bot * wy1 + (1u << (TENSOR_FRAC + 7))) >> (TENSOR_FRAC + 8));
+      }
+    }
+  }
+}
+
+void tensor_header_init(tensor_header_t *h, const tensor_scaler_t *s, int jpeg_scale, uint32_t frame, int64_t timestamp_us) {
+  memset(h, 0, sizeof(*h));
+  memcpy(h->magic, TENSOR_MAGIC, 4);
+  h->header_len = sizeof(tensor_header_t);
+  h->channels = s->channels;
+  h->dtype = 0;
+  h->width = s->dst_w;
+  h->height = s->dst_h;
+  h->crop_x = s->crop.x << jpeg_scale;
+  h->crop_y = s->crop.y << jpeg_scale;
+  h->crop_w = s->crop.w << jpeg_scale;
+  h->crop_h = s->crop.h << jpeg_scale;
+  h->frame = frame;
+  h->timestamp_us = timestamp_us;
+}
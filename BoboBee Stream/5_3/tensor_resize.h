@@ -0,0 +1,69 @@
+#pragma once
+// Tensor input inferensi dari frame kamera: center-crop + resize ke WxH,
+// grayscale atau RGB888 (HWC, uint8), plus header bentuk untuk /tensor.
+//
+// Crop = persegi panjang terbesar di tengah frame dengan rasio dst_w:dst_h,
+// jadi objek tidak gepeng seperti cv2.resize langsung ke 224x224. Resize
+// bilinear half-pixel (setara cv2.INTER_LINEAR / tf.image.resize) dengan
+// bobot fixed-point 10 bit; tabel kolom disiapkan sekali di tensor_scaler_t.
+// Reduksi kasar (1/2, 1/4, 1/8) diserahkan ke decoder JPEG yang menskala di
+// domain DCT (rata-rata blok, sekaligus anti-alias), lihat tensor_jpeg_scale();
+// bilinear hanya menangani sisa faktor < 2.
+//
+// Murni logika, tanpa header ESP, supaya bisa dites di host
+// (tools/tensor_bench.cpp).
+#include <stdint.h>
+#include <stddef.h>
+
+#define TENSOR_MAX_DIM 320
+#define TENSOR_MIN_DIM 8
+#define TENSOR_MAGIC   "TNS1"
+
+// Header wire 32 byte (little-endian) di depan setiap tensor.
+typedef struct __attribute__((packed)) {
+  char magic[4];          // "TNS1"
+  uint16_t header_len;    // sizeof(tensor_header_t); data mulai di offset ini
+  uint8_t channels;       // 1 = gray, 3 = RGB
+  uint8_t dtype;          // 0 = uint8, layout HWC
+  uint16_t width;
+  uint16_t height;
+  uint16_t crop_x;        // area sumber dalam piksel frame asli
+  uint16_t crop_y;
+  uint16_t crop_w;
+  uint16_t crop_h;
+  uint32_t frame;         // nomor frame broadcaster
+  int64_t timestamp_us;   // waktu capture (epoch, sama dengan X-Timestamp)
+} tensor_header_t;
+
+typedef struct {
+  uint16_t x, y, w, h;
+} tensor_rect_t;
+
+typedef struct {
+  uint16_t src_w;
+  uint16_t src_h;
+  uint16_t dst_w;
+  uint16_t dst_h;
+  uint8_t channels;
+  tensor_rect_t crop;             // dalam koordinat src
+  uint16_t x0[TENSOR_MAX_DIM];    // kolom sumber kiri (sudah + crop.x)
+  uint16_t wx[TENSOR_MAX_DIM];    // bobot kolom kanan, 0..1024
+} tensor_scaler_t;
+
+static inline size_t tensor_bytes(uint16_t w, uint16_t h, uint8_t channels) {
+  return (size_t)w * h * channels;
+}
+
+tensor_rect_t tensor_center_crop(uint16_t src_w, uint16_t src_h, uint16_t dst_w, uint16_t dst_h);
+
+// Shift skala JPEG terbesar (0..3 = 1/1..1/8) yang crop-nya masih >= dst.
+int tensor_jpeg_scale(uint16_t src_w, uint16_t src_h, uint16_t dst_w, uint16_t dst_h);
+
+// false kalau ukuran di luar TENSOR_MIN_DIM..TENSOR_MAX_DIM atau channels bukan 1/3.
+bool tensor_scaler_init(tensor_scaler_t *s, uint16_t src_w, uint16_t src_h, uint16_t dst_w, uint16_t dst_h, uint8_t channels);
+
+// src: RGB888 src_w x src_h (stride byte per baris), dst: dst_h x dst_w x channels.
+void tensor_scale_rgb888(const tensor_scaler_t *s, const uint8_t *src, size_t stride, uint8_t *dst);
+
+// jpeg_scale: shift yang dipakai decoder, crop dikembalikan ke piksel frame asli.
+void tensor_header_init(tensor_header_t *h, const tensor_scaler_t *s, int jpeg_scale, uint32_t frame, int64_t timestamp_us);
@@ -0,0 +1,480 @@
+#include "ws_session.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "esp_camera.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "cam_broadcast.h"
+#include "cam_abr.h"
+#include "cam_status.h"
+#include "audio_codec.h"
+
+#if defined(ARDUINO_ARCH_ESP32) && defined(CONFIG_ARDUHAL_ESP_LOG)
+#include "esp32-hal-log.h"
+#endif
+
+#define WS_VIDEO_WAIT_MS 1000
+#define WS_TEXT_MAX 192
+
+static_assert(sizeof(ws_video_header_t) == 28, "ws_video_header_t harus 28 byte");
+
+// Dimiliki task pengirim; loop() hanya mematikan active lalu melepasnya,
+// task yang membebaskan (bisa masih di tengah kirim).
+typedef struct {
+  uint8_t num;
+  int bcast;               // id subscription broadcaster
+  volatile bool active;
+  uint8_t *buf;            // HEADROOM + header + JPEG (PSRAM, hanya tumbuh)
+  size_t cap;
+  int64_t next_us;         // frame berikutnya paling cepat (batas fps)
+} ws_video_t;
+
+typedef struct {
+  bool connected;
+  bool subscribed;         // pernah subscribe: default audio tidak berlaku lagi
+  volatile uint8_t channels;
+  volatile bool audio_header;  // audio diawali audio_header_t (audio_frame.h)
+  volatile uint8_t codec;  // AUDIO_CODEC_* ("format"); selain PCM16 selalu ber-header
+  volatile uint8_t fps;    // 0 = ikut kamera
+  uint8_t quality;         // 0 = tidak meminta
+  ws_video_t *video;
+} ws_session_t;
+
+static ws_session_t _sessions[WS_SESSION_MAX_CLIENTS];
+static ws_session_send_t _send_bin = NULL;
+static ws_session_send_t _send_txt = NULL;
+static int _base_quality = -1;  // setelan sensor sebelum ada klien meminta quality
+static SemaphoreHandle_t _ws_lock = NULL;  // semua send + WebSocketsServer::loop()
+
+static bool session_send(uint8_t num, ws_session_send_t fn, uint8_t *payload, size_t len, bool header_to_payload, TickType_t wait) {
+  if (!fn || xSemaphoreTakeRecursive(_ws_lock, wait) != pdTRUE) {
+    return false;
+  }
+  bool ok = _sessions[num].connected && fn(num, payload, len, header_to_payload);
+  xSemaphoreGiveRecursive(_ws_lock);
+  return ok;
+}
+
+// ---------- quality sensor ----------
+// Jalan di task capture (cam_bcast_between_frames).
+static void quality_job(void *arg) {
+  int q = *(int *)arg;
+  sensor_t *s = esp_camera_sensor_get();
+  if (s && s->status.quality != q) {
+    s->set_quality(s, q);
+    cam_abr_reseed();
+    cam_status_invalidate();
+  }
+}
+
+// Dari loop(): quality terbaik yang diminta klien video jadi setelan sensor.
+static void quality_update(void) {
+  sensor_t *s = esp_camera_sensor_get();
+  if (!s) {
+    return;
+  }
+  int best = 0;
+  for (int i = 0; i < WS_SESSION_MAX_CLIENTS; i++) {
+    ws_session_t *ss = &_sessions[i];
+    if (ss->video && ss->quality && (best == 0 || ss->quality < best)) {
+      best = ss->quality;
+    }
+  }
+  int target;
+  if (best == 0) {
+    if (_base_quality < 0) {
+      return;
+    }
+    target = _base_quality;
+    _base_quality = -1;
+  } else {
+    if (_base_quality < 0) {
+      _base_quality = s->status.quality;
+    }
+    target = best;
+  }
+  if (target != s->status.quality) {
+    cam_bcast_between_frames(quality_job, &target);
+    log_i("WS video: sensor quality %d", target);
+  }
+}
+
+// ---------- pengirim video ----------
+static void *video_alloc(size_t len) {
+  void *p = heap_caps_malloc(len, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  return p ? p : malloc(len);
+}
+
+static void video_task(void *arg) {
+  ws_video_t *v = (ws_video_t *)arg;
+  ws_session_t *s = &_sessions[v->num];
+  while (v->active) {
+    cam_frame_t *frame = cam_bcast_wait(v->bcast, WS_VIDEO_WAIT_MS / portTICK_PERIOD_MS);
+    if (!frame) {
+      continue;
+    }
+    int64_t now = esp_timer_get_time();
+    uint8_t fps = s->fps;
+    if (fps) {
+      if (now < v->next_us) {
+        cam_frame_release(frame);  // di atas fps klien: lewati
+        continue;
+      }
+      int64_t period = 1000000 / fps;
+      // tertinggal lebih dari satu periode (kamera lebih lambat): mulai ulang
+      v->next_us = now - v->next_us < period ? v->next_us + period : now + period;
+    }
+
+    size_t len = sizeof(ws_video_header_t) + frame->len;
+    if (WS_SESSION_HEADROOM + len > v->cap) {
+      free(v->buf);
+      v->cap = WS_SESSION_HEADROOM + len + 4096;  // sisa untuk frame berikutnya yang sedikit lebih besar
+      v->buf = (uint8_t *)video_alloc(v->cap);
+      if (!v->buf) {
+        v->cap = 0;
+        cam_frame_release(frame);
+        log_e("WS[%u] video: no memory for %u bytes", v->num, (unsigned)len);
+        continue;
+      }
+    }
+    ws_video_header_t *h = (ws_video_header_t *)(v->buf + WS_SESSION_HEADROOM);
+    memcpy(h->magic, WS_VIDEO_MAGIC, 4);
+    h->header_len = sizeof(ws_video_header_t);
+    h->flags = 0;
+    h->width = (uint16_t)frame->width;
+    h->height = (uint16_t)frame->height;
+    h->seq = frame->seq;
+    h->dropped = cam_bcast_dropped(v->bcast);
+    h->timestamp_us = (int64_t)frame->timestamp.tv_sec * 1000000LL + frame->timestamp.tv_usec;
+    memcpy(v->buf + WS_SESSION_HEADROOM + sizeof(ws_video_header_t), frame->buf, frame->len);
+    // salinan sendiri: frame pool lepas sebelum kirim, klien lambat tidak menahannya
+    cam_frame_release(frame);
+
+    if (xSemaphoreTakeRecursive(_ws_lock, portMAX_DELAY) == pdTRUE) {
+      // active dimatikan di bawah lock yang sama saat klien putus
+      if (v->active && s->connected) {
+        _send_bin(v->num, v->buf, len, true);
+      }
+      xSemaphoreGiveRecursive(_ws_lock);
+    }
+  }
+  cam_bcast_unsubscribe(v->bcast);
+  free(v->buf);
+  free(v);
+  vTaskDelete(NULL);
+}
+
+static bool video_start(uint8_t num) {
+  ws_session_t *s = &_sessions[num];
+  if (s->video) {
+    return true;
+  }
+  int id = cam_bcast_subscribe();
+  if (id < 0) {
+    log_e("WS[%u] video: no free broadcaster slot", num);
+    return false;
+  }
+  ws_video_t *v = (ws_video_t *)calloc(1, sizeof(ws_video_t));
+  if (!v) {
+    cam_bcast_unsubscribe(id);
+    return false;
+  }
+  v->num = num;
+  v->bcast = id;
+  v->active = true;
+  if (xTaskCreatePinnedToCore(video_task, "WsVideo", 4096, v, 5, NULL, tskNO_AFFINITY) != pdPASS) {
+    log_e("WS[%u] video: failed to start sender", num);
+    cam_bcast_unsubscribe(id);
+    free(v);
+    return false;
+  }
+  s->video = v;
+  return true;
+}
+
+static void video_stop(uint8_t num) {
+  ws_session_t *s = &_sessions[num];
+  if (!s->video) {
+    return;
+  }
+  s->video->active = false;  // task berhenti sendiri setelah frame/timeout berikutnya
+  s->video = NULL;
+}
+
+// ---------- pesan kontrol ----------
+// JSON datar tanpa escape, cukup untuk pesan kontrol di atas.
+static const char *json_value(const char *json, const char *key) {
+  char pat[24];
+  snprintf(pat, sizeof(pat), "\"%s\"", key);
+  const char *p = strstr(json, pat);
+  if (!p) {
+    return NULL;
+  }
+  p += strlen(pat);
+  while (*p == ' ' || *p == ':') {
+    p++;
+  }
+  return p;
+}
+
+static bool json_str(const char *json, const char *key, char *out, size_t cap) {
+  const char *p = json_value(json, key);
+  if (!p || *p != '"') {
+    return false;
+  }
+  p++;
+  size_t n = 0;
+  while (p[n] && p[n] != '"' && n + 1 < cap) {
+    out[n] = p[n];
+    n++;
+  }
+  out[n] = '\0';
+  return true;
+}
+
+static bool json_int(const char *json, const char *key, int *out) {
+  const char *p = json_value(json, key);
+  char *end;
+  long v = p ? strtol(p, &end, 10) : 0;
+  if (!p || end == p) {
+    return false;
+  }
+  *out = (int)v;
+  return true;
+}
+
+static bool json_bool(const char *json, const char *key, bool *out) {
+  const char *p = json_value(json, key);
+  int v;
+  if (p && (strncmp(p, "true", 4) == 0 || strncmp(p, "false", 5) == 0)) {
+    *out = p[0] == 't';
+    return true;
+  }
+  if (json_int(json, key, &v)) {
+    *out = v != 0;
+    return true;
+  }
+  return false;
+}
+
+static uint8_t parse_channels(const char *stream) {
+  uint8_t ch = 0;
+  if (strstr(stream, "audio")) {
+    ch |= WS_CH_AUDIO;
+  }
+  if (strstr(stream, "video")) {
+    ch |= WS_CH_VIDEO;
+  }
+  return ch;
+}
+
+static bool session_audio_header(const ws_session_t *s) {
+  return s->audio_header || s->codec != AUDIO_CODEC_PCM16;
+}
+
+static void reply(uint8_t num, const char *error) {
+  ws_session_t *s = &_sessions[num];
+  const audio_codec_t *codec = audio_codec_get(s->codec);
+  char buf[192];
+  int n = snprintf(buf, sizeof(buf), "{\"type\":\"session\",\"channels\":\"%s\",\"header\":%s,\"format\":\"%s\",\"fps\":%u,\"quality\":%u",
+                   (s->channels & WS_CH_AUDIO) && (s->channels & WS_CH_VIDEO) ? "audio+video"
+                   : s->channels & WS_CH_VIDEO                                 ? "video"
+                   : s->channels & WS_CH_AUDIO                                 ? "audio"
+                                                                               : "",
+                   session_audio_header(s) ? "true" : "false", codec ? codec->name : "", s->fps, s->quality);
+  sensor_t *sensor = esp_camera_sensor_get();
+  if (sensor) {
+    n += snprintf(buf + n, sizeof(buf) - n, ",\"sensor_quality\":%d", sensor->status.quality);
+  }
+  if (error) {
+    n += snprintf(buf + n, sizeof(buf) - n, ",\"error\":\"%s\"", error);
+  }
+  snprintf(buf + n, sizeof(buf) - n, "}");
+  session_send(num, _send_txt, (uint8_t *)buf, strlen(buf), false, WS_SESSION_TX_WAIT_MS / portTICK_PERIOD_MS);
+}
+
+// ---------- API ----------
+bool ws_session_begin(ws_session_send_t send_bin, ws_session_send_t send_txt) {
+  _send_bin = send_bin;
+  _send_txt = send_txt;
+  if (!_ws_lock) {
+    _ws_lock = xSemaphoreCreateRecursiveMutex();
+    if (!_ws_lock) {
+      log_e("Failed to create WS session lock");
+      return false;
+    }
+  }
+  return true;
+}
+
+void ws_session_lock(void) {
+  if (_ws_lock) {
+    xSemaphoreTakeRecursive(_ws_lock, portMAX_DELAY);
+  }
+}
+
+void ws_session_unlock(void) {
+  if (_ws_lock) {
+    xSemaphoreGiveRecursive(_ws_lock);
+  }
+}
+
+void ws_session_connected(uint8_t num) {
+  if (num >= WS_SESSION_MAX_CLIENTS) {
+    return;
+  }
+  ws_session_t *s = &_sessions[num];
+  s->subscribed = false;
+  s->channels = WS_CH_AUDIO;  // klien lama tidak pernah subscribe
+  s->audio_header = false;
+  s->codec = AUDIO_CODEC_PCM16;
+  s->fps = 0;
+  s->quality = 0;
+  s->connected = true;
+}
+
+void ws_session_disconnected(uint8_t num) {
+  if (num >= WS_SESSION_MAX_CLIENTS) {
+    return;
+  }
+  ws_session_t *s = &_sessions[num];
+  // biasanya dari event di dalam loop() (lock sudah dipegang); tunggu kirim
+  // yang sedang jalan (sudah gagal cepat: klien tertutup)
+  xSemaphoreTakeRecursive(_ws_lock, portMAX_DELAY);
+  s->connected = false;
+  s->channels = 0;
+  bool had_quality = s->video && s->quality;
+  video_stop(num);
+  xSemaphoreGiveRecursive(_ws_lock);
+  if (had_quality) {
+    quality_update();
+  }
+}
+
+void ws_session_text(uint8_t num, const char *text, size_t len) {
+  if (num >= WS_SESSION_MAX_CLIENTS || !_sessions[num].connected) {
+    return;
+  }
+  ws_session_t *s = &_sessions[num];
+  char msg[WS_TEXT_MAX], action[16], stream[16], format[16];
+  if (len >= sizeof(msg)) {
+    return;
+  }
+  memcpy(msg, text, len);
+  msg[len] = '\0';
+  if (!json_str(msg, "action", action, sizeof(action))) {
+    return;  // bukan pesan kontrol
+  }
+
+  int v;
+  bool b;
+  const char *error = NULL;
+  if (json_bool(msg, "header", &b)) {
+    s->audio_header = b;
+  }
+  if (json_str(msg, "format", format, sizeof(format))) {
+    const audio_codec_t *codec = audio_codec_find(format);
+    if (codec) {
+      s->codec = codec->id;
+    } else {
+      error = "unknown format";
+    }
+  }
+  uint8_t old_quality = s->video ? s->quality : 0;
+  if (json_int(msg, "fps", &v)) {
+    s->fps = v < 0 ? 0 : v > WS_VIDEO_MAX_FPS ? WS_VIDEO_MAX_FPS : v;
+  }
+  if (json_int(msg, "quality", &v)) {
+    s->quality = v < 0 ? 0 : v > 63 ? 63 : v;
+  }
+
+  if (strcmp(action, "subscribe") == 0 || strcmp(action, "unsubscribe") == 0) {
+    uint8_t ch = json_str(msg, "stream", stream, sizeof(stream)) ? parse_channels(stream) : 0;
+    if (!ch) {
+      error = "unknown stream";
+    } else if (action[0] == 's') {
+      s->channels = (s->subscribed ? s->channels : 0) | ch;
+      s->subscribed = true;
+    } else {
+      s->channels &= ~ch;
+      s->subscribed = true;
+    }
+    if ((s->channels & WS_CH_VIDEO) && !video_start(num)) {
+      s->channels &= ~WS_CH_VIDEO;
+      error = "video busy";
+    }
+    if (!(s->channels & WS_CH_VIDEO)) {
+      video_stop(num);
+    }
+  } else if (strcmp(action, "video") != 0) {
+    error = "unknown action";
+  }
+  if ((s->video ? s->quality : 0) != old_quality) {
+    quality_update();
+  }
+  log_i("WS[%u] %s: channels=%u fps=%u quality=%u%s%s", num, action, s->channels, s->fps, s->quality,
+        error ? " error=" : "", error ? error : "");
+  reply(num, error);
+}
+
+static bool session_wants(uint8_t num, uint8_t channel) {
+  return _sessions[num].connected && (channel == 0 || (_sessions[num].channels & channel));
+}
+
+int ws_session_count(uint8_t channel) {
+  int n = 0;
+  for (uint8_t i = 0; i < WS_SESSION_MAX_CLIENTS; i++) {
+    n += session_wants(i, channel);
+  }
+  return n;
+}
+
+int ws_session_broadcast_bin(uint8_t channel, const uint8_t *data, size_t len) {
+  int sent = 0;
+  for (uint8_t i = 0; i < WS_SESSION_MAX_CLIENTS; i++) {
+    if (session_wants(i, channel) &&
+        session_send(i, _send_bin, (uint8_t *)data, len, false, WS_SESSION_TX_WAIT_MS / portTICK_PERIOD_MS)) {
+      sent++;
+    }
+  }
+  return sent;
+}
+
+uint8_t ws_session_audio_codecs(void) {
+  uint8_t mask = 0;
+  for (uint8_t i = 0; i < WS_SESSION_MAX_CLIENTS; i++) {
+    if (session_wants(i, WS_CH_AUDIO)) {
+      mask |= 1 << _sessions[i].codec;
+    }
+  }
+  return mask;
+}
+
+int ws_session_send_audio(uint8_t codec, const uint8_t *msg, size_t header_len, size_t len) {
+  int sent = 0;
+  for (uint8_t i = 0; i < WS_SESSION_MAX_CLIENTS; i++) {
+    if (!session_wants(i, WS_CH_AUDIO) || _sessions[i].codec != codec) {
+      continue;
+    }
+    size_t skip = session_audio_header(&_sessions[i]) ? 0 : header_len;
+    if (session_send(i, _send_bin, (uint8_t *)msg + skip, len - skip, false, WS_SESSION_TX_WAIT_MS / portTICK_PERIOD_MS)) {
+      sent++;
+    }
+  }
+  return sent;
+}
+
+int ws_session_broadcast_txt(uint8_t channel, const char *text) {
+  int sent = 0;
+  for (uint8_t i = 0; i < WS_SESSION_MAX_CLIENTS; i++) {
+    if (session_wants(i, channel) &&
+        session_send(i, _send_txt, (uint8_t *)text, strlen(text), false, WS_SESSION_TX_WAIT_MS / portTICK_PERIOD_MS)) {
+      sent++;
+    }
+  }
+  return sent;
+}
@@ -0,0 +1,100 @@
+#pragma once
+// State per klien WebSocket :81: channel audio/video + pengirim video.
+//
+// Pesan kontrol (teks JSON dari klien):
+//   {"action":"subscribe","stream":"audio"}            channel: audio | video | audio+video
+//   {"action":"subscribe","stream":"audio","header":true}  audio diawali audio_header_t
+//   {"action":"subscribe","stream":"audio","format":"adpcm"}  codec audio (audio_codec.h)
+//   {"action":"subscribe","stream":"video","fps":10,"quality":12}
+//   {"action":"unsubscribe","stream":"video"}
+//   {"action":"video","fps":5,"quality":20}            ubah setelan video saja
+// fps 0 = ikut kamera (maks WS_VIDEO_MAX_FPS); quality 1..63 seperti
+// /control, 0 = tidak meminta.
+// format: "pcm16" (default) atau "adpcm"; selain pcm16 selalu diawali
+// audio_header_t karena data tidak bisa dibaca tanpa codec dan samples.
+// Tiap pesan dibalas {"type":"session",...} berisi channel dan setelan aktif.
+// Klien yang tidak pernah subscribe tetap dapat audio (perilaku lama);
+// subscribe pertama mengganti default itu, berikutnya menambah channel.
+//
+// Video: frame JPEG sebagai pesan biner ws_video_header_t + JPEG. Tiap
+// klien video punya subscription broadcaster sendiri ("latest only": satu
+// frame dikirim + satu pending, sisanya dibuang) dan task pengirim sendiri,
+// jadi klien lambat hanya menurunkan fps-nya sendiri. fps dibatasi per
+// klien dengan melewatkan frame. Encoder JPEG sensor cuma satu, jadi
+// quality tidak bisa per klien: quality terbaik (angka terkecil) yang
+// diminta klien jadi setelan sensor (plafon ABR), dan setelan awal
+// dikembalikan saat tidak ada lagi yang meminta.
+//
+// WebSocketsServer tidak thread-safe: loop() mengirim ping/pong heartbeat
+// dan membebaskan klien yang putus, sementara audio (AudioTask), video (task
+// pengirim) dan balasan mengirim dari task lain. Semua send di sini dan
+// loop() memakai satu lock (rekursif: balasan dikirim dari event di dalam
+// loop()), jadi frame tidak pernah berselang-seling di wire dan send tidak
+// memakai klien yang sedang dibebaskan:
+//
+//   ws_session_lock();
+//   g_ws.loop();
+//   ws_session_unlock();
+//
+// Video menunggu giliran; audio dan teks menunggu paling lama
+// WS_SESSION_TX_WAIT_MS lalu melewati blok itu supaya AudioTask tidak
+// tertahan klien video yang lambat.
+#include <stdint.h>
+#include <stddef.h>
+
+#ifndef WS_SESSION_MAX_CLIENTS
+#define WS_SESSION_MAX_CLIENTS 5  // = WEBSOCKETS_SERVER_CLIENT_MAX
+#endif
+
+// ruang di depan buffer video untuk header frame WS (headerToPayload);
+// minimal WEBSOCKETS_MAX_HEADER_SIZE
+#define WS_SESSION_HEADROOM 14
+
+#ifndef WS_VIDEO_MAX_FPS
+#define WS_VIDEO_MAX_FPS 30
+#endif
+
+// tunggu giliran kirim (audio, teks) selagi lock dipegang frame video atau
+// loop(); lewat dari ini pesan dilewati
+#ifndef WS_SESSION_TX_WAIT_MS
+#define WS_SESSION_TX_WAIT_MS 50
+#endif
+
+#define WS_CH_AUDIO (1 << 0)
+#define WS_CH_VIDEO (1 << 1)
+
+#define WS_VIDEO_MAGIC "VID1"
+
+typedef struct __attribute__((packed)) {
+  char magic[4];          // "VID1"
+  uint16_t header_len;    // sizeof(ws_video_header_t); JPEG mulai di offset ini
+  uint16_t flags;         // cadangan, 0
+  uint16_t width;
+  uint16_t height;
+  uint32_t seq;           // nomor frame broadcaster (lompat = frame dilewati)
+  uint32_t dropped;       // total frame yang dilewati klien ini
+  int64_t timestamp_us;   // waktu capture (epoch, sama dengan X-Timestamp)
+} ws_video_header_t;
+
+// Sama dengan WebSocketsServer::sendBIN/sendTXT. headerToPayload = true:
+// payload diawali WS_SESSION_HEADROOM byte yang boleh ditimpa.
+typedef bool (*ws_session_send_t)(uint8_t num, uint8_t *payload, size_t len, bool header_to_payload);
+
+bool ws_session_begin(ws_session_send_t send_bin, ws_session_send_t send_txt);
+void ws_session_lock(void);    // pegang selama WebSocketsServer::loop()
+void ws_session_unlock(void);
+void ws_session_connected(uint8_t num);
+void ws_session_disconnected(uint8_t num);
+void ws_session_text(uint8_t num, const char *text, size_t len);  // dari WStype_TEXT
+int ws_session_count(uint8_t channel);  // klien yang berlangganan channel
+// Ke semua klien channel (0 = semua klien), menggantikan broadcastBIN/TXT.
+// Return jumlah klien yang terkirim.
+int ws_session_broadcast_bin(uint8_t channel, const uint8_t *data, size_t len);
+int ws_session_broadcast_txt(uint8_t channel, const char *text);
+// Bitmask (1 << AUDIO_CODEC_*) codec yang dipakai klien audio saat ini:
+// AudioTask hanya meng-encode codec yang ada di sini.
+uint8_t ws_session_audio_codecs(void);
+// Blok audio ter-encode codec = header_len byte audio_header_t + data, ke
+// klien audio yang memilih codec itu. Klien yang meminta header menerima
+// semuanya, klien lain hanya data.
+int ws_session_send_audio(uint8_t codec, const uint8_t *msg, size_t header_len, size_t len);
@@ -0,0 +1,69 @@
+/**
+ * Decoder codec audio WS 5_3.ino (BoboBee Stream/5_3/audio_codec.h).
+ * Format dipilih lewat "format" di subscribe: 'pcm16' (32 KB/s) atau
+ * 'adpcm' (IMA-ADPCM 4 bit/sampel, ~8 KB/s). Tiap pesan bisa didecode
+ * sendiri; pesan yang hilang tidak merusak pesan berikutnya.
+ */
+import {
+  AUDIO_CODEC_IMA_ADPCM,
+  AUDIO_CODEC_PCM16,
+  AUDIO_IMA_BLOCK_HEADER,
+  AUDIO_IMA_BLOCK_SAMPLES,
+  audioDataLen,
+} from './AudioFrame'
+import type { AudioFrame } from './AudioFrame'
+
+export type AudioFormat = 'pcm16' | 'adpcm'
+
+// Tabel standar IMA/DVI ADPCM, sama dengan audio_codec.cpp.
+const IMA_STEP = new Int16Array([
+  7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28,
+  31, 34, 37, 41, 45, 50, 55, 60, 66, 73, 80, 88, 97, 107, 118,
+  130, 143, 157, 173, 190, 209, 230, 253, 279, 307, 337, 371, 408, 449, 494,
+  544, 598, 658, 724, 796, 876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066,
+  2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630,
+  9493, 10442, 11487, 12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767,
+])
+const IMA_INDEX = new Int8Array([-1, -1, -1, -1, 2, 4, 6, 8, -1, -1, -1, -1, 2, 4, 6, 8])
+
+/**
+ * Blok-blok AUDIO_IMA_BLOCK_SAMPLES: predictor i16 LE | step index u8 | cadangan u8,
+ * lalu 2 sampel per byte (sampel genap di nibble bawah). null kalau rusak.
+ */
+export function decodeImaAdpcm(data: ArrayBuffer, samples: number): Int16Array | null {
+  if (data.byteLength !== audioDataLen(AUDIO_CODEC_IMA_ADPCM, samples)) return null
+  const u8 = new Uint8Array(data)
+  const out = new Int16Array(samples)
+  let p = 0
+  for (let done = 0; done < samples; done += AUDIO_IMA_BLOCK_SAMPLES) {
+    const n = Math.min(AUDIO_IMA_BLOCK_SAMPLES, samples - done)
+    let predictor = (u8[p] | (u8[p + 1] << 8)) << 16 >> 16
+    let index = u8[p + 2]
+    if (index > 88) return null
+    p += AUDIO_IMA_BLOCK_HEADER
+    for (let i = 0; i < n; i++) {
+      const code = i & 1 ? u8[p++] >> 4 : u8[p] & 0x0f
+      const step = IMA_STEP[index]
+      let delta = step >> 3
+      if (code & 4) delta += step
+      if (code & 2) delta += step >> 1
+      if (code & 1) delta += step >> 2
+      predictor += code & 8 ? -delta : delta
+      if (predictor > 32767) predictor = 32767
+      else if (predictor < -32768) predictor = -32768
+      index += IMA_INDEX[code]
+      if (index < 0) index = 0
+      else if (index > 88) index = 88
+      out[done + i] = predictor
+    }
+    if (n & 1) p++  // nibble atas byte terakhir blok ganjil = isian
+  }
+  return out
+}
+
+/** Sampel PCM16 dari frame ber-header, apa pun codec-nya; null kalau tidak dikenal/rusak. */
+export function decodeAudioFrame(frame: AudioFrame): Int16Array | null {
+  if (frame.codec === AUDIO_CODEC_PCM16) return new Int16Array(frame.data)
+  if (frame.codec === AUDIO_CODEC_IMA_ADPCM) return decodeImaAdpcm(frame.data, frame.samples)
+  return null
+}
@@ -0,0 +1,95 @@
+/**
+ * Header pesan audio WS dari 5_3.ino (BoboBee Stream/5_3/audio_frame.h).
+ * 24 byte little-endian di depan setiap blok I2S:
+ *   "AUD1" | header_len u16 | codec u8 | gain_shift u8 | seq u32 |
+ *   sample_rate u16 | samples u16 | capture_us i64 (jam esp_timer, sama dengan X-Timestamp)
+ * Dikirim kalau subscribe membawa header: true, atau format selain pcm16.
+ */
+export const AUDIO_HEADER_LEN = 24
+export const AUDIO_CODEC_PCM16 = 0
+export const AUDIO_CODEC_IMA_ADPCM = 1
+export const AUDIO_IMA_BLOCK_SAMPLES = 1024  // = AUDIO_BUF_32_COUNT di 5_3.ino
+export const AUDIO_IMA_BLOCK_HEADER = 4
+
+/** Panjang data tepat untuk codec (audio_frame_data_len di firmware); 0 = tidak dikenal. */
+export function audioDataLen(codec: number, samples: number): number {
+  if (codec === AUDIO_CODEC_PCM16) return samples * 2
+  if (codec === AUDIO_CODEC_IMA_ADPCM) {
+    const full = Math.floor(samples / AUDIO_IMA_BLOCK_SAMPLES)
+    const rest = samples % AUDIO_IMA_BLOCK_SAMPLES
+    return full * (AUDIO_IMA_BLOCK_HEADER + AUDIO_IMA_BLOCK_SAMPLES / 2) +
+      (rest ? AUDIO_IMA_BLOCK_HEADER + Math.ceil(rest / 2) : 0)
+  }
+  return 0
+}
+
+export type AudioFrame = {
+  codec: number
+  gainShift: number
+  seq: number
+  sampleRate: number
+  samples: number
+  captureUs: number
+  data: ArrayBuffer  // potongan setelah header (di-copy, rata 2 byte)
+}
+
+/** null kalau bukan pesan ber-header (PCM16 polos firmware lama) atau rusak. */
+export function parseAudioFrame(buf: ArrayBuffer): AudioFrame | null {
+  if (buf.byteLength < AUDIO_HEADER_LEN) return null
+  const dv = new DataView(buf)
+  if (dv.getUint32(0, false) !== 0x41554431) return null  // "AUD1"
+  const headerLen = dv.getUint16(4, true)
+  if (headerLen < AUDIO_HEADER_LEN || headerLen > buf.byteLength) return null
+  const codec = dv.getUint8(6)
+  const samples = dv.getUint16(14, true)
+  const want = audioDataLen(codec, samples)
+  if (want && buf.byteLength - headerLen !== want) return null
+  return {
+    codec,
+    gainShift: dv.getUint8(7),
+    seq: dv.getUint32(8, true),
+    sampleRate: dv.getUint16(12, true),
+    samples,
+    captureUs: Number(dv.getBigInt64(16, true)),
+    data: buf.slice(headerLen),
+  }
+}
+
+/** Blok hilang/terlambat dari seq, jitter RFC 3550 dari capture_us. */
+export class AudioRxStats {
+  received = 0
+  lost = 0
+  late = 0
+  restarts = 0
+  jitterUs = 0
+  private nextSeq = -1
+  private lastTransitUs = 0
+
+  /** arrivalUs: jam lokal (bebas offset). Return blok hilang tepat sebelum frame ini. */
+  update(f: AudioFrame, arrivalUs: number): number {
+    this.received++
+    const transit = arrivalUs - f.captureUs
+    if (this.nextSeq < 0) {
+      this.nextSeq = (f.seq + 1) >>> 0
+      this.lastTransitUs = transit
+      return 0
+    }
+    const ahead = (f.seq - this.nextSeq) >>> 0
+    if (ahead >= 0x80000000) {
+      if (((this.nextSeq - f.seq) >>> 0) <= 64) {
+        this.late++
+        return 0
+      }
+      this.restarts++  // perangkat reboot
+      this.nextSeq = (f.seq + 1) >>> 0
+      this.lastTransitUs = transit
+      return 0
+    }
+    this.lost += ahead
+    this.nextSeq = (f.seq + 1) >>> 0
+    const d = Math.abs(transit - this.lastTransitUs)
+    this.lastTransitUs = transit
+    this.jitterUs += (d - this.jitterUs) / 16
+    return ahead
+  }
+}
@@ -1,12 +1,20 @@
+import { AudioRxStats, parseAudioFrame } from './AudioFrame'
+import type { AudioFrame } from './AudioFrame'
+import { decodeAudioFrame } from './AudioCodec'
+import type { AudioFormat } from './AudioCodec'
+
 export type EspAudioStatus = 'connecting' | 'connected' | 'disconnected' | 'error'
 
 type Handlers = {
   onStatus?: (s: EspAudioStatus) => void
   onAudioChunk?: (chunk: Float32Array, sampleRate: number) => void
+  // hanya untuk pesan ber-header (firmware baru): seq, capture_us, gain
+  onAudioFrame?: (frame: AudioFrame, stats: AudioRxStats) => void
 }
 
 type Options = {
   sampleRate?: number
+  format?: AudioFormat     // 'adpcm' = ~4x lebih hemat bandwidth dari 'pcm16'
   minBackoffMs?: number
   maxBackoffMs?: number
   minBinaryBytes?: number  // minimal bytes agar dianggap audio
@@ -19,6 +27,7 @@ export class EspWsAudioClient {
   private attempt = 0
 
   private readonly sampleRate: number
+  private readonly format: AudioFormat
   private readonly minBackoff: number
   private readonly maxBackoff: number
   private readonly minBinaryBytes: number
@@ -26,9 +35,11 @@ export class EspWsAudioClient {
   private bytesSinceTick = 0
   private lastThroughputTs = 0
   private firstBinarySeen = false
+  private rx = new AudioRxStats()
 
   constructor(private handlers: Handlers = {}, opts: Options = {}) {
     this.sampleRate = opts.sampleRate ?? 16000
+    this.format = opts.format ?? 'pcm16'
     this.minBackoff = opts.minBackoffMs ?? 1000
     this.maxBackoff = opts.maxBackoffMs ?? 5000
     this.minBinaryBytes = opts.minBinaryBytes ?? 512
@@ -53,14 +64,16 @@ export class EspWsAudioClient {
         this.bytesSinceTick = 0
         this.lastThroughputTs = performance.now()
         this.firstBinarySeen = false
+        this.rx = new AudioRxStats()
         console.log('🔊 ESP WS connected:', this.url)
 
         try {
           ws.send(JSON.stringify({
             action: 'subscribe',
             stream: 'audio',
-            format: 'pcm16',
-            sampleRate: this.sampleRate
+            format: this.format,
+            sampleRate: this.sampleRate,
+            header: true
           }))
         } catch {}
       }
@@ -108,21 +121,35 @@ export class EspWsAudioClient {
   }
 
   private handleBinary(abLike: ArrayBufferLike) {
+    // firmware baru: header AUD1 (seq, capture_us, sample rate) → tanpa tebakan ukuran
+    const frame = parseAudioFrame(abLike as ArrayBuffer)
+    let sampleRate = this.sampleRate
+    let i16: Int16Array
     const byteLength = (abLike as ArrayBuffer).byteLength ?? (abLike as any).byteLength
-    if ((byteLength & 1) !== 0) return                // PCM16 harus genap
-    if (byteLength < this.minBinaryBytes) return      // terlalu kecil → buang
+    if (frame) {
+      const lost = this.rx.update(frame, performance.now() * 1000)
+      if (lost > 0) console.warn(`[ESP WS] ${lost} audio block(s) lost before seq ${frame.seq}`)
+      this.handlers.onAudioFrame?.(frame, this.rx)
+      const pcm = decodeAudioFrame(frame)  // pcm16 / adpcm
+      if (!pcm) {
+        console.warn(`[ESP WS] cannot decode audio codec ${frame.codec}`)
+        return
+      }
+      i16 = pcm
+      sampleRate = frame.sampleRate
+    } else {
+      if ((byteLength & 1) !== 0) return                // PCM16 harus genap
+      if (byteLength < this.minBinaryBytes) return      // terlalu kecil → buang
+      i16 = new Int16Array(abLike)
+    }
 
     this.bytesSinceTick += byteLength
 
-    if (!this.firstBinarySeen) {
-      const dv = new DataView(abLike as ArrayBuffer)
-      const s0 = dv.getInt16(0, true)
-      const s1 = dv.getInt16(2, true)
-      console.log(`[ESP WS] First packet bytes: ${byteLength} | samples[0..1]=${s0},${s1}`)
+    if (!this.firstBinarySeen && i16.length >= 2) {
+      console.log(`[ESP WS] First packet bytes: ${byteLength} | samples[0..1]=${i16[0]},${i16[1]}`)
       this.firstBinarySeen = true
     }
 
-    const i16 = new Int16Array(abLike)
     const out = new Float32Array(i16.length)
     const inv = 1 / 32768
     for (let i = 0; i < i16.length; i++) {
@@ -132,7 +159,7 @@ export class EspWsAudioClient {
       out[i] = v
     }
 
-    this.handlers.onAudioChunk?.(out, this.sampleRate)
+    this.handlers.onAudioChunk?.(out, sampleRate)
 
     const now = performance.now()
     if (now - this.lastThroughputTs >= 1000) {
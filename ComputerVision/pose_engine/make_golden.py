@@ -0,0 +1,135 @@
+"""Membuat file golden untuk pose_head_cli --golden.
+
+Output referensi dihitung dengan tf.keras (model Sequential yang sama dengan
+modelTopology, bobot dari weights.bin). Kalau TensorFlow tidak terpasang,
+dipakai numpy float64 dengan rumus yang sama (Dropout tidak aktif saat
+inference).
+
+Format golden (little-endian):
+  char[4] "PHG1", uint32 n, uint32 inputs, uint32 classes,
+  float32 x[n][inputs], float32 probs[n][classes]
+
+Contoh:
+  python make_golden.py --model ../my-pose-model --out golden.bin
+  python make_golden.py --model /tmp/pm --synthetic --out /tmp/golden.bin
+"""
+import argparse
+import json
+import os
+import struct
+
+import numpy as np
+
+
+def model_json_path(model_dir):
+    for name in ("model.json", "model"):
+        path = os.path.join(model_dir, name)
+        if os.path.isfile(path):
+            return path
+    raise FileNotFoundError(f"model.json tidak ada di {model_dir}")
+
+
+def load_weights(model_dir):
+    with open(model_json_path(model_dir), "r") as f:
+        model_json = json.load(f)
+    manifest = model_json["weightsManifest"][0]
+    raw = open(os.path.join(model_dir, manifest["paths"][0]), "rb").read()
+    tensors, offset = [], 0
+    for w in manifest["weights"]:
+        count = int(np.prod(w["shape"]))
+        tensors.append(np.frombuffer(raw, "<f4", count, offset).reshape(w["shape"]))
+        offset += count * 4
+    return model_json, tensors
+
+
+def write_synthetic(model_dir, inputs, hidden, classes, seed):
+    """Model acak dengan topologi Teachable Machine (untuk tes tanpa weights.bin asli)."""
+    rng = np.random.default_rng(seed)
+    w1 = rng.normal(0, np.sqrt(1.0 / inputs), (inputs, hidden)).astype("<f4")
+    b1 = rng.normal(0, 0.05, hidden).astype("<f4")
+    w2 = rng.normal(0, np.sqrt(1.0 / hidden), (hidden, classes)).astype("<f4")
+    os.makedirs(model_dir, exist_ok=True)
+    with open(os.path.join(model_dir, "weights.bin"), "wb") as f:
+        for t in (w1, b1, w2):
+            f.write(t.tobytes())
+    layers = [
+        {"class_name": "Dense", "config": {"units": hidden, "activation": "relu", "use_bias": True,
+                                           "name": "dense_Dense1", "batch_input_shape": [None, inputs]}},
+        {"class_name": "Dropout", "config": {"rate": 0.5, "name": "dropout_Dropout1"}},
+        {"class_name": "Dense", "config": {"units": classes, "activation": "softmax", "use_bias": False,
+                                           "name": "dense_Dense2"}},
+    ]
+    model_json = {
+        "modelTopology": {"class_name": "Sequential", "config": {"name": "sequential", "layers": layers}},
+        "weightsManifest": [{"paths": ["weights.bin"], "weights": [
+            {"name": "dense_Dense1/kernel", "shape": [inputs, hidden], "dtype": "float32"},
+            {"name": "dense_Dense1/bias", "shape": [hidden], "dtype": "float32"},
+            {"name": "dense_Dense2/kernel", "shape": [hidden, classes], "dtype": "float32"},
+        ]}],
+    }
+    with open(os.path.join(model_dir, "model.json"), "w") as f:
+        json.dump(model_json, f)
+
+
+def reference_tf(tensors, x):
+    import tensorflow as tf
+
+    w1, b1, w2 = tensors[:3]
+    b2 = tensors[3] if len(tensors) > 3 else None
+    model = tf.keras.Sequential([
+        tf.keras.Input(shape=(w1.shape[0],)),
+        tf.keras.layers.Dense(w1.shape[1], activation="relu"),
+        tf.keras.layers.Dropout(0.5),
+        tf.keras.layers.Dense(w2.shape[1], activation="softmax", use_bias=b2 is not None),
+    ])
+    model.set_weights([w1, b1, w2] + ([b2] if b2 is not None else []))
+    return model.predict(x, verbose=0)
+
+
+def reference_numpy(tensors, x):
+    w1, b1, w2 = (t.astype(np.float64) for t in tensors[:3])
+    h = np.maximum(x.astype(np.float64) @ w1 + b1, 0.0)
+    z = h @ w2
+    if len(tensors) > 3:
+        z += tensors[3]
+    z -= z.max(axis=1, keepdims=True)
+    e = np.exp(z)
+    return e / e.sum(axis=1, keepdims=True)
+
+
+def main():
+    ap = argparse.ArgumentParser()
+    ap.add_argument("--model", default="../my-pose-model")
+    ap.add_argument("--out", default="golden.bin")
+    ap.add_argument("--n", type=int, default=32)
+    ap.add_argument("--seed", type=int, default=7)
+    ap.add_argument("--synthetic", action="store_true", help="tulis model acak ke --model dulu")
+    args = ap.parse_args()
+
+    if args.synthetic:
+        write_synthetic(args.model, 14739, 100, 2, args.seed)
+    _, tensors = load_weights(args.model)
+    inputs, classes = tensors[0].shape[0], tensors[2].shape[1]
+
+    # Fitur PoseNet: heatmap/offset, sebagian besar kecil dan banyak nol
+    rng = np.random.default_rng(args.seed + 1)
+    x = rng.normal(0, 1, (args.n, inputs)).astype("<f4")
+    x[rng.random(x.shape) < 0.5] = 0.0
+
+    try:
+        probs = reference_tf(tensors, x)
+        source = "tensorflow"
+    except ImportError:
+        probs = reference_numpy(tensors, x)
+        source = "numpy float64"
+    probs = np.asarray(probs, "<f4")
+
+    with open(args.out, "wb") as f:
+        f.write(b"PHG1" + struct.pack("<III", args.n, inputs, classes))
+        f.write(x.tobytes())
+        f.write(probs.tobytes())
+    print(f"{args.out}: {args.n} x {inputs} -> {classes}, referensi {source}")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,300 @@
+#include "pose_head.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define POSE_X86 1
+#endif
+#if defined(__aarch64__) && defined(__ARM_NEON)  // 32 register q; ARMv7 pakai jalur scalar
+#include <arm_neon.h>
+#define POSE_NEON 1
+#endif
+
+namespace pose {
+
+// Baris bobot per blok (256 x 100 float = 100 KB, muat di L2) untuk batch > 1
+static const int kRowBlock = 256;
+
+// ---------- Kernel dense: h[b][j] = relu(b1[j] + sum_i x[b][i] * W[i][j]) ----------
+// acc: [batch][stride] sudah berisi bias. W dibaca per baris (kontigu); lane
+// setelah kolom terakhir membaca awal baris berikutnya dan dibuang, jadi
+// baris terakhir selalu dikerjakan scalar supaya tidak lewat ujung mmap.
+
+static void dense_rows_scalar(const float *W, int out, int i0, int i1, const float *x, float *acc) {
+  for (int i = i0; i < i1; i++) {
+    float xi = x[i];
+    if (xi == 0.0f) continue;  // fitur PoseNet banyak yang nol
+    const float *w = W + (size_t)i * out;
+    for (int j = 0; j < out; j++) acc[j] += xi * w[j];
+  }
+}
+
+typedef void (*dense_block_fn)(const float *, int, int, int, int, const float *, float *);
+
+#if POSE_X86
+template <int NV>
+__attribute__((target("avx2,fma"))) static void dense_block_avx2(const float *W, int out, int j0, int i0, int i1, const float *x, float *acc) {
+  __m256 a[NV];
+  for (int v = 0; v < NV; v++) a[v] = _mm256_loadu_ps(acc + j0 + v * 8);
+  for (int i = i0; i < i1; i++) {
+    float xi = x[i];
+    if (xi == 0.0f) continue;
+    __m256 xv = _mm256_set1_ps(xi);
+    const float *w = W + (size_t)i * out + j0;
+    for (int v = 0; v < NV; v++) a[v] = _mm256_fmadd_ps(xv, _mm256_loadu_ps(w + v * 8), a[v]);
+  }
+  for (int v = 0; v < NV; v++) _mm256_storeu_ps(acc + j0 + v * 8, a[v]);
+}
+
+static const dense_block_fn kAvx2Blocks[] = {
+  nullptr,
+  dense_block_avx2<1>,
+  dense_block_avx2<2>,
+  dense_block_avx2<3>,
+  dense_block_avx2<4>,
+  dense_block_avx2<5>,
+  dense_block_avx2<6>,
+  dense_block_avx2<7>,
+  dense_block_avx2<8>,
+  dense_block_avx2<9>,
+  dense_block_avx2<10>,
+  dense_block_avx2<11>,
+  dense_block_avx2<12>,
+  dense_block_avx2<13>,
+};
+static const int kAvx2Chunk = 13 * 8;  // 13 akumulator ymm + bobot + broadcast = 15 register
+
+static bool have_avx2() {
+  static const bool ok = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+  return ok;
+}
+#endif
+
+#if POSE_NEON
+template <int NV>
+static void dense_block_neon(const float *W, int out, int j0, int i0, int i1, const float *x, float *acc) {
+  float32x4_t a[NV];
+  for (int v = 0; v < NV; v++) a[v] = vld1q_f32(acc + j0 + v * 4);
+  for (int i = i0; i < i1; i++) {
+    float xi = x[i];
+    if (xi == 0.0f) continue;
+    const float *w = W + (size_t)i * out + j0;
+    for (int v = 0; v < NV; v++) a[v] = vfmaq_n_f32(a[v], vld1q_f32(w + v * 4), xi);
+  }
+  for (int v = 0; v < NV; v++) vst1q_f32(acc + j0 + v * 4, a[v]);
+}
+
+static const dense_block_fn kNeonBlocks[] = {
+  nullptr,
+  dense_block_neon<1>,
+  dense_block_neon<2>,
+  dense_block_neon<3>,
+  dense_block_neon<4>,
+  dense_block_neon<5>,
+  dense_block_neon<6>,
+  dense_block_neon<7>,
+  dense_block_neon<8>,
+  dense_block_neon<9>,
+  dense_block_neon<10>,
+  dense_block_neon<11>,
+  dense_block_neon<12>,
+  dense_block_neon<13>,
+  dense_block_neon<14>,
+  dense_block_neon<15>,
+  dense_block_neon<16>,
+  dense_block_neon<17>,
+  dense_block_neon<18>,
+  dense_block_neon<19>,
+  dense_block_neon<20>,
+  dense_block_neon<21>,
+  dense_block_neon<22>,
+  dense_block_neon<23>,
+  dense_block_neon<24>,
+  dense_block_neon<25>,
+  dense_block_neon<26>,
+};
+static const int kNeonChunk = 26 * 4;  // 26 akumulator q + bobot = 27 dari 32 register
+#endif
+
+const char *PoseHead::kernel_name() {
+#if POSE_X86
+  if (have_avx2()) return "avx2";
+#endif
+#if POSE_NEON
+  return "neon";
+#endif
+  return "scalar";
+}
+
+// acc: [batch][stride], stride >= out dibulatkan ke lebar vektor.
+static void dense_forward(const float *W, int in, int out, const float *x, size_t batch, float *acc, size_t stride) {
+  const dense_block_fn *blocks = nullptr;
+  int chunk = 0, lanes = 1;
+#if POSE_X86
+  if (have_avx2()) {
+    blocks = kAvx2Blocks;
+    chunk = kAvx2Chunk;
+    lanes = 8;
+  }
+#endif
+#if POSE_NEON
+  blocks = kNeonBlocks;
+  chunk = kNeonChunk;
+  lanes = 4;
+#endif
+  if (!blocks) {
+    for (size_t b = 0; b < batch; b++) dense_rows_scalar(W, out, 0, in, x + b * in, acc + b * stride);
+    return;
+  }
+  int last = in - 1;  // baris terakhir: scalar (vektor terakhir bisa lewat ujung buffer)
+  int block = batch > 1 ? kRowBlock : in;
+  for (int i0 = 0; i0 < last; i0 += block) {
+    int i1 = std::min(last, i0 + block);
+    for (size_t b = 0; b < batch; b++) {
+      for (int j0 = 0; j0 < out; j0 += chunk) {
+        int n = std::min(chunk, out - j0);
+        blocks[(n + lanes - 1) / lanes](W, out, j0, i0, i1, x + b * in, acc + b * stride);
+      }
+    }
+  }
+  for (size_t b = 0; b < batch; b++) dense_rows_scalar(W, out, last, in, x + b * in, acc + b * stride);
+}
+
+// ---------- Loader ----------
+bool PoseHead::fail(const std::string &msg) {
+  error_ = msg;
+  return false;
+}
+
+bool PoseHead::load(const std::string &path) {
+  if (!weights_.load(path)) return fail(weights_.error());
+  const std::string &js = weights_.json();
+
+  // aktivasi: Dense pertama relu, terakhir softmax
+  size_t a1 = json::find_key(js, "activation", 0, js.size());
+  size_t a2 = a1 == std::string::npos ? a1 : json::find_key(js, "activation", a1, js.size());
+  if (a1 == std::string::npos || a2 == std::string::npos) return fail("model.json: expected two Dense layers");
+  if (json::string_at(js, &a1) != "relu" || json::string_at(js, &a2) != "softmax") return fail("model.json: expected relu -> softmax");
+
+  // urutan manifest Keras: kernel, bias, kernel[, bias]
+  const std::vector<Tensor> &t = weights_.tensors();
+  if (t.size() < 3 || t[0].shape.size() != 2 || t[1].shape.size() != 1 || t[2].shape.size() != 2) {
+    return fail("model.json: expected kernel, bias, kernel[, bias]");
+  }
+  in_ = t[0].shape[0];
+  hidden_ = t[0].shape[1];
+  classes_ = t[2].shape[1];
+  if (t[1].shape[0] != hidden_ || t[2].shape[0] != hidden_) return fail("model.json: layer shapes do not chain");
+  w1_ = t[0].data;
+  b1_ = t[1].data;
+  w2_ = t[2].data;
+  b2_ = t.size() > 3 && t[3].shape.size() == 1 && t[3].shape[0] == classes_ ? t[3].data : nullptr;
+
+  // label dari metadata.json (opsional)
+  std::string meta;
+  labels_.clear();
+  if (json::read_file(weights_.dir() + "/metadata.json", &meta)) {
+    size_t l = json::find_key(meta, "labels", 0, meta.size());
+    if (l != std::string::npos && meta[l] == '[') {
+      size_t le = json::match(meta, l);
+      for (size_t p = meta.find('"', l); p != std::string::npos && p < le; p = meta.find('"', p)) labels_.push_back(json::string_at(meta, &p));
+    }
+  }
+  return true;
+}
+
+// ---------- Inference ----------
+void PoseHead::run(const float *x, size_t batch, float *probs) const {
+  // stride kelipatan 8: store vektor di chunk terakhir tidak menabrak baris berikutnya
+  size_t stride = ((size_t)hidden_ + 7) & ~(size_t)7;
+  thread_local std::vector<float> scratch;
+  if (scratch.size() < batch * stride) scratch.resize(batch * stride);
+  float *acc = scratch.data();
+  for (size_t b = 0; b < batch; b++) memcpy(acc + b * stride, b1_, hidden_ * sizeof(float));
+
+  dense_forward(w1_, in_, hidden_, x, batch, acc, stride);
+
+  for (size_t b = 0; b < batch; b++) {
+    const float *h = acc + b * stride;
+    float *p = probs + b * classes_;
+    float logits[16];
+    float *z = classes_ <= 16 ? logits : p;
+    for (int c = 0; c < classes_; c++) z[c] = b2_ ? b2_[c] : 0.0f;
+    for (int j = 0; j < hidden_; j++) {
+      float hj = h[j] > 0.0f ? h[j] : 0.0f;  // relu
+      if (hj == 0.0f) continue;
+      const float *w = w2_ + (size_t)j * classes_;
+      for (int c = 0; c < classes_; c++) z[c] += hj * w[c];
+    }
+    float zmax = z[0];
+    for (int c = 1; c < classes_; c++) zmax = std::max(zmax, z[c]);
+    float sum = 0;
+    for (int c = 0; c < classes_; c++) {
+      p[c] = std::exp(z[c] - zmax);
+      sum += p[c];
+    }
+    for (int c = 0; c < classes_; c++) p[c] /= sum;
+  }
+}
+
+int PoseHead::predict(const float *x, float *confidence) const {
+  float probs[16];
+  std::vector<float> big;
+  float *p = probs;
+  if (classes_ > 16) {
+    big.resize(classes_);
+    p = big.data();
+  }
+  run(x, 1, p);
+  int best = (int)(std::max_element(p, p + classes_) - p);
+  if (confidence) *confidence = p[best];
+  return best;
+}
+
+}  // namespace pose
+
+// ---------- API C ----------
+static thread_local std::string g_open_error;
+
+extern "C" {
+
+void *pose_head_open(const char *path) {
+  pose::PoseHead *h = new pose::PoseHead();
+  if (!h->load(path)) {
+    g_open_error = h->error();
+    delete h;
+    return nullptr;
+  }
+  return h;
+}
+
+const char *pose_head_error(void) {
+  return g_open_error.c_str();
+}
+
+void pose_head_close(void *h) {
+  delete (pose::PoseHead *)h;
+}
+
+int pose_head_inputs(void *h) {
+  return h ? ((pose::PoseHead *)h)->inputs() : 0;
+}
+
+int pose_head_classes(void *h) {
+  return h ? ((pose::PoseHead *)h)->classes() : 0;
+}
+
+int pose_head_run(void *h, const float *x, size_t batch, float *probs) {
+  if (!h || !x || !probs) return -1;
+  ((pose::PoseHead *)h)->run(x, batch, probs);
+  return 0;
+}
+
+const char *pose_head_kernel(void) {
+  return pose::PoseHead::kernel_name();
+}
+}
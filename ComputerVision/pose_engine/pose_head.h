@@ -0,0 +1,73 @@
+// Engine native untuk head klasifikasi pose Teachable Machine.
+//
+// Model: fitur PoseNet (14739) -> Dense(100, relu) -> Dropout -> Dense(2,
+// softmax, tanpa bias). Topologi dan manifest dibaca dari model.json (di
+// repo bernama "model"), bobot dari weights.bin di-mmap langsung (zero-copy,
+// float32 little-endian, layout kernel Keras [in][out]).
+//
+// Dense pertama memakai kernel GEMV/GEMM kecil: AVX2+FMA (dipilih saat
+// runtime), NEON, atau scalar. Untuk batch > 1 baris bobot diproses per blok
+// yang muat di L2 sehingga bobot 5.9 MB dibaca dari memori sekali per batch,
+// bukan sekali per input.
+#pragma once
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "tfjs_weights.h"
+
+namespace pose {
+
+class PoseHead {
+ public:
+  PoseHead() = default;
+  PoseHead(const PoseHead &) = delete;
+  PoseHead &operator=(const PoseHead &) = delete;
+
+  // path = folder model (cari model.json lalu model) atau file model.json.
+  bool load(const std::string &path);
+
+  // x: [batch][inputs()], probs: [batch][classes()]
+  void run(const float *x, size_t batch, float *probs) const;
+  int predict(const float *x, float *confidence = nullptr) const;  // argmax satu input
+
+  int inputs() const { return in_; }
+  int hidden() const { return hidden_; }
+  int classes() const { return classes_; }
+  const std::vector<std::string> &labels() const { return labels_; }
+  const std::string &error() const { return error_; }
+  static const char *kernel_name();  // "avx2", "neon", "scalar"
+
+  // Bobot float langsung dari mmap (untuk kuantisasi, lihat pose_head_q8.h)
+  const float *w1() const { return w1_; }
+  const float *b1() const { return b1_; }
+  const float *w2() const { return w2_; }
+  const float *b2() const { return b2_; }
+
+ private:
+  bool fail(const std::string &msg);
+
+  WeightFile weights_;
+  const float *w1_ = nullptr;  // [in][hidden]
+  const float *b1_ = nullptr;  // [hidden]
+  const float *w2_ = nullptr;  // [hidden][classes]
+  const float *b2_ = nullptr;  // [classes] atau nullptr
+  int in_ = 0;
+  int hidden_ = 0;
+  int classes_ = 0;
+  std::vector<std::string> labels_;
+  std::string error_;
+};
+
+}  // namespace pose
+
+// API C untuk ctypes (Python) dan bahasa lain.
+extern "C" {
+void *pose_head_open(const char *path);  // NULL kalau gagal, lihat pose_head_error()
+const char *pose_head_error(void);
+void pose_head_close(void *h);
+int pose_head_inputs(void *h);
+int pose_head_classes(void *h);
+int pose_head_run(void *h, const float *x, size_t batch, float *probs);  // 0 = ok
+const char *pose_head_kernel(void);
+}
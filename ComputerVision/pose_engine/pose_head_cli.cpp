@@ -0,0 +1,163 @@
+// CLI untuk pose_head: cek golden, benchmark, atau klasifikasi satu file fitur.
+//
+// Build:  g++ -O2 -std=c++17 pose_head_cli.cpp pose_head.cpp tfjs_weights.cpp -o pose_head_cli
+// Contoh: ./pose_head_cli ../my-pose-model --golden golden.bin --tol 1e-5
+//         ./pose_head_cli ../my-pose-model --bench --batch 8 --iters 200
+//         ./pose_head_cli ../my-pose-model --input features.f32
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "pose_head.h"
+
+struct Options {
+  std::string model;
+  std::string golden;
+  std::string input;
+  double tol = 1e-5;
+  bool bench = false;
+  int batch = 1;
+  int iters = 200;
+};
+
+static double now_seconds() {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static bool read_all(const std::string &path, std::vector<uint8_t> *out) {
+  FILE *f = fopen(path.c_str(), "rb");
+  if (!f) return false;
+  fseek(f, 0, SEEK_END);
+  long n = ftell(f);
+  fseek(f, 0, SEEK_SET);
+  out->resize(n > 0 ? n : 0);
+  bool ok = fread(out->data(), 1, out->size(), f) == out->size();
+  fclose(f);
+  return ok;
+}
+
+// Golden: "PHG1", n, inputs, classes, x[n][inputs], probs[n][classes]
+static int run_golden(const pose::PoseHead &head, const Options &o) {
+  std::vector<uint8_t> raw;
+  if (!read_all(o.golden, &raw) || raw.size() < 16 || memcmp(raw.data(), "PHG1", 4) != 0) {
+    fprintf(stderr, "%s: not a golden file\n", o.golden.c_str());
+    return 1;
+  }
+  uint32_t hdr[3];
+  memcpy(hdr, raw.data() + 4, sizeof(hdr));
+  uint32_t n = hdr[0], inputs = hdr[1], classes = hdr[2];
+  if ((int)inputs != head.inputs() || (int)classes != head.classes() ||
+      raw.size() != 16 + (size_t)n * (inputs + classes) * sizeof(float)) {
+    fprintf(stderr, "golden shape %u x %u -> %u does not match model %d -> %d\n", n, inputs, classes, head.inputs(), head.classes());
+    return 1;
+  }
+  std::vector<float> x((size_t)n * inputs), ref((size_t)n * classes), got(ref.size());
+  memcpy(x.data(), raw.data() + 16, x.size() * sizeof(float));
+  memcpy(ref.data(), raw.data() + 16 + x.size() * sizeof(float), ref.size() * sizeof(float));
+
+  // satu batch penuh dan satu per satu harus sama-sama cocok
+  double max_err = 0;
+  int argmax_miss = 0;
+  head.run(x.data(), n, got.data());
+  for (uint32_t b = 0; b < n; b++) {
+    int best_ref = 0;
+    for (uint32_t c = 0; c < classes; c++) {
+      max_err = std::max(max_err, (double)std::fabs(got[b * classes + c] - ref[b * classes + c]));
+      if (ref[b * classes + c] > ref[b * classes + best_ref]) best_ref = c;
+    }
+    if (head.predict(&x[(size_t)b * inputs]) != best_ref) argmax_miss++;
+  }
+  bool ok = max_err <= o.tol && argmax_miss == 0;
+  printf("golden %s: %u samples, kernel %s, max |err| %.3g (tol %.3g), argmax mismatch %d\n", ok ? "PASS" : "FAIL", n,
+         pose::PoseHead::kernel_name(), max_err, o.tol, argmax_miss);
+  return ok ? 0 : 1;
+}
+
+static int run_bench(const pose::PoseHead &head, const Options &o) {
+  std::mt19937 rng(1);
+  std::normal_distribution<float> nd(0, 1);
+  std::vector<float> x((size_t)o.batch * head.inputs());
+  for (size_t i = 0; i < x.size(); i++) x[i] = (rng() & 1) ? nd(rng) : 0.0f;
+  std::vector<float> probs((size_t)o.batch * head.classes());
+
+  head.run(x.data(), o.batch, probs.data());  // pemanasan: page-in mmap
+  double t0 = now_seconds();
+  for (int i = 0; i < o.iters; i++) head.run(x.data(), o.batch, probs.data());
+  double dt = now_seconds() - t0;
+  double per_call = dt / o.iters;
+  double weight_mb = (double)head.inputs() * head.hidden() * sizeof(float) / (1024.0 * 1024.0);
+  printf("kernel %s, batch %d: %.3f ms/call, %.3f ms/sample, %.0f samples/s, weights %.1f MB -> %.1f GB/s\n",
+         pose::PoseHead::kernel_name(), o.batch, per_call * 1e3, per_call * 1e3 / o.batch, o.batch / per_call, weight_mb,
+         weight_mb / 1024.0 / per_call);
+  return 0;
+}
+
+// Fitur mentah float32 [inputs] (mis. dari backbone PoseNet).
+static int run_input(const pose::PoseHead &head, const Options &o) {
+  std::vector<uint8_t> raw;
+  if (!read_all(o.input, &raw) || raw.size() != (size_t)head.inputs() * sizeof(float)) {
+    fprintf(stderr, "%s: expected %d float32 values\n", o.input.c_str(), head.inputs());
+    return 1;
+  }
+  std::vector<float> x(head.inputs());
+  memcpy(x.data(), raw.data(), raw.size());
+  float conf = 0;
+  int c = head.predict(x.data(), &conf);
+  const char *label = c < (int)head.labels().size() ? head.labels()[c].c_str() : "?";
+  printf("%d %s (%.1f%%)\n", c, label, conf * 100);
+  return 0;
+}
+
+int main(int argc, char **argv) {
+  Options o;
+  if (argc < 2) {
+    fprintf(stderr,
+            "usage: %s MODEL_DIR [--golden FILE] [--tol 1e-5]\n"
+            "          [--bench] [--batch 1] [--iters 200] [--input FEATURES.f32]\n",
+            argv[0]);
+    return 2;
+  }
+  o.model = argv[1];
+  for (int i = 2; i < argc; i++) {
+    std::string k = argv[i];
+    if (k == "--bench") {
+      o.bench = true;
+      continue;
+    }
+    if (i + 1 >= argc) {
+      fprintf(stderr, "missing value for %s\n", k.c_str());
+      return 2;
+    }
+    const char *v = argv[++i];
+    if (k == "--golden") o.golden = v;
+    else if (k == "--tol") o.tol = atof(v);
+    else if (k == "--batch") o.batch = atoi(v) > 0 ? atoi(v) : 1;
+    else if (k == "--iters") o.iters = atoi(v) > 0 ? atoi(v) : 1;
+    else if (k == "--input") o.input = v;
+    else {
+      fprintf(stderr, "unknown option %s\n", k.c_str());
+      return 2;
+    }
+  }
+
+  pose::PoseHead head;
+  if (!head.load(o.model)) {
+    fprintf(stderr, "%s\n", head.error().c_str());
+    return 1;
+  }
+  printf("model %d -> %d -> %d", head.inputs(), head.hidden(), head.classes());
+  for (const auto &l : head.labels()) printf(" [%s]", l.c_str());
+  printf("\n");
+
+  int rc = 0;
+  if (!o.golden.empty()) rc |= run_golden(head, o);
+  if (!o.input.empty()) rc |= run_input(head, o);
+  if (o.bench) rc |= run_bench(head, o);
+  return rc;
+}
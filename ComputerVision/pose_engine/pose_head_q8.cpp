@@ -0,0 +1,308 @@
+#include "pose_head_q8.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+#include "pose_head.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define POSE_X86 1
+#endif
+#if defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define POSE_NEON 1
+#endif
+
+namespace pose {
+
+static const char kMagic[4] = {'P', 'H', 'Q', '8'};
+static const uint32_t kVersion = 1;
+static const int kRowAlign = 16;   // byte per baris int8 (register 128-bit)
+static const int kBlockAlign = 64;  // awal blok int8 dalam file
+
+struct QuantHeader {
+  char magic[4];
+  uint32_t version, in, in_padded, hidden, classes, groups, has_b2;
+};
+
+static size_t align_up(size_t v, size_t a) {
+  return (v + a - 1) / a * a;
+}
+
+static size_t float_count(const QuantHeader &h) {
+  return h.groups + 2 * (size_t)h.hidden + (size_t)h.hidden * h.classes + h.classes;
+}
+
+// ---------- Kalibrasi + kuantisasi ----------
+bool quantize_head(const PoseHead &head, const float *samples, size_t n, const QuantOptions &opt, const std::string &out_path,
+                   std::string *error) {
+  const int in = head.inputs(), hidden = head.hidden(), classes = head.classes();
+  const int groups = std::max(1, std::min(opt.groups, in));
+  if (n == 0) {
+    *error = "no calibration samples";
+    return false;
+  }
+
+  // skala aktivasi: persentil |x| per grup
+  std::vector<float> act_scale(groups);
+  std::vector<float> vals;
+  for (int g = 0; g < groups; g++) {
+    vals.clear();
+    for (size_t s = 0; s < n; s++) {
+      const float *x = samples + s * in;
+      for (int i = g; i < in; i += groups) vals.push_back(std::fabs(x[i]));
+    }
+    size_t k = (size_t)std::min<double>(vals.size() - 1, std::floor(opt.percentile / 100.0 * (vals.size() - 1) + 0.5));
+    std::nth_element(vals.begin(), vals.begin() + k, vals.end());
+    float v = vals[k];
+    act_scale[g] = v > 0 ? v / 127.0f : 1.0f / 127.0f;
+  }
+
+  // bobot: lipat skala aktivasi, lalu skala per output channel
+  QuantHeader h = {{kMagic[0], kMagic[1], kMagic[2], kMagic[3]}, kVersion, (uint32_t)in, (uint32_t)align_up(in, kRowAlign),
+                   (uint32_t)hidden, (uint32_t)classes, (uint32_t)groups, head.b2() != nullptr};
+  std::vector<float> w_scale(hidden);
+  std::vector<int8_t> q((size_t)hidden * h.in_padded, 0);
+  const float *W = head.w1();
+  for (int j = 0; j < hidden; j++) {
+    float m = 0;
+    for (int i = 0; i < in; i++) m = std::max(m, std::fabs(W[(size_t)i * hidden + j] * act_scale[i % groups]));
+    float s = m > 0 ? m / 127.0f : 1.0f;
+    w_scale[j] = s;
+    int8_t *row = q.data() + (size_t)j * h.in_padded;
+    for (int i = 0; i < in; i++) {
+      float v = std::nearbyint(W[(size_t)i * hidden + j] * act_scale[i % groups] / s);
+      row[i] = (int8_t)std::max(-127.0f, std::min(127.0f, v));
+    }
+  }
+
+  FILE *f = fopen(out_path.c_str(), "wb");
+  if (!f) {
+    *error = "cannot write " + out_path;
+    return false;
+  }
+  std::vector<float> b2(classes, 0.0f);
+  if (head.b2()) memcpy(b2.data(), head.b2(), classes * sizeof(float));
+  fwrite(&h, sizeof(h), 1, f);
+  fwrite(act_scale.data(), sizeof(float), groups, f);
+  fwrite(w_scale.data(), sizeof(float), hidden, f);
+  fwrite(head.b1(), sizeof(float), hidden, f);
+  fwrite(head.w2(), sizeof(float), (size_t)hidden * classes, f);
+  fwrite(b2.data(), sizeof(float), classes, f);
+  size_t pos = sizeof(h) + float_count(h) * sizeof(float);
+  static const char kZero[kBlockAlign] = {};
+  fwrite(kZero, 1, align_up(pos, kBlockAlign) - pos, f);
+  fwrite(q.data(), 1, q.size(), f);
+  bool ok = fclose(f) == 0;
+  if (!ok) *error = "write failed: " + out_path;
+  return ok;
+}
+
+// ---------- Kernel dot int8 ----------
+int32_t QuantHead::dot_reference(const int8_t *a, const int8_t *b, int n) {
+  int32_t acc = 0;
+  for (int i = 0; i < n; i++) acc += (int32_t)a[i] * b[i];
+  return acc;
+}
+
+// out[r] = dot(x, W[r]) untuk r < rows; n kelipatan 16.
+typedef void (*dot_rows_fn)(const int8_t *x, const int8_t *W, int n, int rows, int32_t *out);
+
+static void dot_rows_reference(const int8_t *x, const int8_t *W, int n, int rows, int32_t *out) {
+  for (int r = 0; r < rows; r++) out[r] = QuantHead::dot_reference(x, W + (size_t)r * n, n);
+}
+
+#if POSE_X86
+// int8 -> int16 lalu madd (pasangan int16 -> int32): eksak, tanpa saturasi
+// seperti maddubs. Empat baris per putaran supaya x dimuat sekali.
+__attribute__((target("avx2"))) static inline int32_t hsum_avx2(__m256i v) {
+  __m128i s = _mm_add_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+  s = _mm_add_epi32(s, _mm_shuffle_epi32(s, 0x4E));
+  s = _mm_add_epi32(s, _mm_shuffle_epi32(s, 0xB1));
+  return _mm_cvtsi128_si32(s);
+}
+
+__attribute__((target("avx2"))) static void dot_rows_avx2(const int8_t *x, const int8_t *W, int n, int rows, int32_t *out) {
+  int r = 0;
+  for (; r + 4 <= rows; r += 4) {
+    const int8_t *w0 = W + (size_t)r * n;
+    const int8_t *w1 = w0 + n;
+    const int8_t *w2 = w1 + n;
+    const int8_t *w3 = w2 + n;
+    __m256i a0 = _mm256_setzero_si256(), a1 = a0, a2 = a0, a3 = a0;
+    for (int i = 0; i < n; i += 16) {
+      __m256i xv = _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i *)(x + i)));
+      a0 = _mm256_add_epi32(a0, _mm256_madd_epi16(xv, _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i *)(w0 + i)))));
+      a1 = _mm256_add_epi32(a1, _mm256_madd_epi16(xv, _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i *)(w1 + i)))));
+      a2 = _mm256_add_epi32(a2, _mm256_madd_epi16(xv, _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i *)(w2 + i)))));
+      a3 = _mm256_add_epi32(a3, _mm256_madd_epi16(xv, _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i *)(w3 + i)))));
+    }
+    out[r] = hsum_avx2(a0);
+    out[r + 1] = hsum_avx2(a1);
+    out[r + 2] = hsum_avx2(a2);
+    out[r + 3] = hsum_avx2(a3);
+  }
+  for (; r < rows; r++) {
+    const int8_t *w = W + (size_t)r * n;
+    __m256i a = _mm256_setzero_si256();
+    for (int i = 0; i < n; i += 16) {
+      __m256i xv = _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i *)(x + i)));
+      a = _mm256_add_epi32(a, _mm256_madd_epi16(xv, _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i *)(w + i)))));
+    }
+    out[r] = hsum_avx2(a);
+  }
+}
+
+static bool have_avx2() {
+  static const bool ok = __builtin_cpu_supports("avx2");
+  return ok;
+}
+#endif
+
+#if POSE_NEON
+// vmull_s8 + vmlal_high_s8: dua hasil kali int8 (maks 2 * 127 * 127) muat int16.
+static void dot_rows_neon(const int8_t *x, const int8_t *W, int n, int rows, int32_t *out) {
+  for (int r = 0; r < rows; r++) {
+    const int8_t *w = W + (size_t)r * n;
+    int32x4_t acc = vdupq_n_s32(0);
+    for (int i = 0; i < n; i += 16) {
+      int8x16_t a = vld1q_s8(x + i);
+      int8x16_t b = vld1q_s8(w + i);
+      int16x8_t p = vmull_s8(vget_low_s8(a), vget_low_s8(b));
+      p = vmlal_high_s8(p, a, b);
+      acc = vpadalq_s16(acc, p);
+    }
+    out[r] = vaddvq_s32(acc);
+  }
+}
+#endif
+
+static dot_rows_fn select_dot_rows() {
+#if POSE_X86
+  if (have_avx2()) return dot_rows_avx2;
+#endif
+#if POSE_NEON
+  return dot_rows_neon;
+#endif
+  return dot_rows_reference;
+}
+
+const char *QuantHead::kernel_name() {
+#if POSE_X86
+  if (have_avx2()) return "avx2";
+#endif
+#if POSE_NEON
+  return "neon";
+#endif
+  return "reference";
+}
+
+// ---------- Loader ----------
+QuantHead::~QuantHead() {
+  if (map_) munmap(map_, map_len_);
+}
+
+bool QuantHead::fail(const std::string &msg) {
+  error_ = msg;
+  return false;
+}
+
+bool QuantHead::load(const std::string &path) {
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) return fail("cannot open " + path);
+  struct stat st;
+  if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(QuantHeader)) {
+    close(fd);
+    return fail(path + ": too short");
+  }
+  map_len_ = st.st_size;
+  map_ = mmap(nullptr, map_len_, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (map_ == MAP_FAILED) {
+    map_ = nullptr;
+    return fail("mmap failed for " + path);
+  }
+  QuantHeader h;
+  memcpy(&h, map_, sizeof(h));
+  if (memcmp(h.magic, kMagic, 4) != 0 || h.version != kVersion) return fail(path + ": not a PHQ8 v1 file");
+  if (h.in_padded % kRowAlign || h.in_padded < h.in || h.groups == 0 || h.hidden == 0 || h.classes == 0) return fail(path + ": bad header");
+  size_t q_off = align_up(sizeof(h) + float_count(h) * sizeof(float), kBlockAlign);
+  if (map_len_ < q_off + (size_t)h.hidden * h.in_padded) return fail(path + ": truncated");
+
+  in_ = h.in;
+  in_pad_ = h.in_padded;
+  hidden_ = h.hidden;
+  classes_ = h.classes;
+  groups_ = h.groups;
+  const float *f = (const float *)((const uint8_t *)map_ + sizeof(h));
+  act_scale_ = f;
+  w_scale_ = act_scale_ + groups_;
+  b1_ = w_scale_ + hidden_;
+  w2_ = b1_ + hidden_;
+  b2_ = w2_ + (size_t)hidden_ * classes_;
+  w1q_ = (const int8_t *)map_ + q_off;
+  inv_act_.resize(in_);
+  for (int i = 0; i < in_; i++) inv_act_[i] = 1.0f / act_scale_[i % groups_];
+  return true;
+}
+
+// ---------- Inference ----------
+void QuantHead::run(const float *x, size_t batch, float *probs) const {
+  thread_local std::vector<int8_t> xq;
+  thread_local std::vector<int32_t> acc;
+  thread_local std::vector<float> hid;
+  xq.assign(batch * in_pad_, 0);
+  acc.resize(hidden_);
+  hid.resize(batch * hidden_);
+
+  for (size_t b = 0; b < batch; b++) {
+    const float *xb = x + b * in_;
+    int8_t *q = xq.data() + b * in_pad_;
+    for (int i = 0; i < in_; i++) {
+      float v = std::nearbyint(xb[i] * inv_act_[i]);
+      q[i] = (int8_t)std::max(-127.0f, std::min(127.0f, v));
+    }
+  }
+
+  static const dot_rows_fn dot_rows = select_dot_rows();
+  for (size_t b = 0; b < batch; b++) {
+    dot_rows(xq.data() + b * in_pad_, w1q_, in_pad_, hidden_, acc.data());
+    float *h = hid.data() + b * hidden_;
+    for (int j = 0; j < hidden_; j++) h[j] = std::max(0.0f, acc[j] * w_scale_[j] + b1_[j]);
+  }
+
+  for (size_t b = 0; b < batch; b++) {
+    const float *h = hid.data() + b * hidden_;
+    float *p = probs + b * classes_;
+    for (int c = 0; c < classes_; c++) p[c] = b2_[c];
+    for (int j = 0; j < hidden_; j++) {
+      if (h[j] == 0.0f) continue;
+      for (int c = 0; c < classes_; c++) p[c] += h[j] * w2_[(size_t)j * classes_ + c];
+    }
+    float zmax = *std::max_element(p, p + classes_);
+    float sum = 0;
+    for (int c = 0; c < classes_; c++) {
+      p[c] = std::exp(p[c] - zmax);
+      sum += p[c];
+    }
+    for (int c = 0; c < classes_; c++) p[c] /= sum;
+  }
+}
+
+int QuantHead::predict(const float *x, float *confidence) const {
+  std::vector<float> p(classes_);
+  run(x, 1, p.data());
+  int best = (int)(std::max_element(p.begin(), p.end()) - p.begin());
+  if (confidence) *confidence = p[best];
+  return best;
+}
+
+}  // namespace pose
@@ -0,0 +1,80 @@
+// Head klasifikasi pose terkuantisasi int8 (post-training, per-channel).
+//
+// Dense pertama (14739 -> 100) disimpan int8 dengan skala per output channel.
+// Skala aktivasi dikalibrasi per jenis fitur (i % 51: 17 heatmap + 34 offset
+// PoseNet punya rentang yang sangat berbeda) dari vektor fitur yang direkam,
+// lalu dilipat ke bobot sebelum kuantisasi:
+//   x_q[i] = round(x[i] / a[i % G])          int8
+//   W'[i][j] = W[i][j] * a[i % G]            dikuantisasi: W'[i][j] ~ q[j][i] * s[j]
+//   h[j] = relu(s[j] * sum_i x_q[i] * q[j][i] + b1[j])
+// Dense kedua (100 -> 2) tetap float.
+//
+// Bobot int8 disimpan transpos [hidden][in_padded], baris kontigu dan
+// kelipatan 16 byte: satu dot product int8 per output, cocok untuk register
+// 128-bit (SSE/NEON, dan EE.VMULAS.S8.ACCX di ESP32-S3). Kernel: referensi
+// portabel, AVX2 (runtime), NEON (aarch64). File .q8 di-mmap.
+//
+// Format .q8 (little-endian):
+//   char[4] "PHQ8", uint32 version (1), in, in_padded, hidden, classes, groups, has_b2
+//   float act_scale[groups], w_scale[hidden], b1[hidden], w2[hidden][classes], b2[classes]
+//   (padding ke kelipatan 64 byte)
+//   int8 w1q[hidden][in_padded]
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace pose {
+
+class PoseHead;
+
+struct QuantOptions {
+  int groups = 51;             // skala aktivasi per i % groups (51 = channel fitur PoseNet)
+  double percentile = 99.99;  // |x| persentil untuk skala aktivasi (100 = max)
+};
+
+// Kalibrasi + kuantisasi dari head float dan sampel fitur [n][inputs].
+bool quantize_head(const PoseHead &head, const float *samples, size_t n, const QuantOptions &opt, const std::string &out_path,
+                   std::string *error);
+
+class QuantHead {
+ public:
+  QuantHead() = default;
+  ~QuantHead();
+  QuantHead(const QuantHead &) = delete;
+  QuantHead &operator=(const QuantHead &) = delete;
+
+  bool load(const std::string &path);
+
+  // x: [batch][inputs()], probs: [batch][classes()]
+  void run(const float *x, size_t batch, float *probs) const;
+  int predict(const float *x, float *confidence = nullptr) const;
+
+  int inputs() const { return in_; }
+  int hidden() const { return hidden_; }
+  int classes() const { return classes_; }
+  size_t weight_bytes() const { return map_len_; }
+  const std::string &error() const { return error_; }
+  static const char *kernel_name();  // "avx2", "neon", "reference"
+
+  // Dot product int8 referensi (juga dipakai untuk cek kernel vektor).
+  static int32_t dot_reference(const int8_t *a, const int8_t *b, int n);
+
+ private:
+  bool fail(const std::string &msg);
+
+  void *map_ = nullptr;
+  size_t map_len_ = 0;
+  int in_ = 0, in_pad_ = 0, hidden_ = 0, classes_ = 0, groups_ = 0;
+  const float *act_scale_ = nullptr;
+  const float *w_scale_ = nullptr;
+  const float *b1_ = nullptr;
+  const float *w2_ = nullptr;
+  const float *b2_ = nullptr;
+  const int8_t *w1q_ = nullptr;
+  std::vector<float> inv_act_;  // [in]: 1 / act_scale[i % groups]
+  std::string error_;
+};
+
+}  // namespace pose
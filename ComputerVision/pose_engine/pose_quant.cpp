@@ -0,0 +1,210 @@
+// Kuantisasi int8 head pose + laporan akurasi/kecepatan terhadap float32.
+//
+// Fitur kalibrasi/evaluasi: float32 [n][14739] mentah, mis. gabungan output
+// posenet_cli --save-features (cat frame_*.f32 > calib.f32). Tanpa file,
+// --synthetic N membuat fitur mirip PoseNet (heatmap 0..1, offset +-20 px).
+//
+// Build:  g++ -O2 -std=c++17 pose_quant.cpp pose_head_q8.cpp pose_head.cpp tfjs_weights.cpp -o pose_quant
+// Contoh: ./pose_quant ../my-pose-model --calib calib.f32 --out pose_head.q8
+//         ./pose_quant ../my-pose-model --q8 pose_head.q8 --eval test.f32 --batch 8
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "pose_head.h"
+#include "pose_head_q8.h"
+
+struct Options {
+  std::string model;
+  std::string calib;
+  std::string eval;
+  std::string out;
+  std::string q8;
+  int synthetic = 0;
+  int batch = 8;
+  int iters = 200;
+  pose::QuantOptions quant;
+};
+
+static double now_seconds() {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static bool read_features(const std::string &path, int inputs, std::vector<float> *out, size_t *n) {
+  FILE *f = fopen(path.c_str(), "rb");
+  if (!f) return false;
+  fseek(f, 0, SEEK_END);
+  long bytes = ftell(f);
+  fseek(f, 0, SEEK_SET);
+  size_t row = (size_t)inputs * sizeof(float);
+  if (bytes <= 0 || bytes % row) {
+    fclose(f);
+    return false;
+  }
+  *n = bytes / row;
+  out->resize(*n * inputs);
+  bool ok = fread(out->data(), 1, bytes, f) == (size_t)bytes;
+  fclose(f);
+  return ok;
+}
+
+// Layout sel PoseNet: 17 heatmap (sigmoid) lalu 34 offset.
+static void synthetic_features(int inputs, size_t n, uint32_t seed, std::vector<float> *out) {
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<float> u(0, 1);
+  std::normal_distribution<float> off(0, 8);
+  out->resize(n * inputs);
+  for (size_t s = 0; s < n; s++) {
+    float *x = out->data() + s * inputs;
+    for (int i = 0; i < inputs; i++) {
+      int c = i % 51;
+      x[i] = c < 17 ? std::pow(u(rng), 6.0f) : std::max(-20.0f, std::min(20.0f, off(rng)));
+    }
+  }
+}
+
+static bool load_samples(const Options &o, const std::string &path, int inputs, uint32_t seed, std::vector<float> *x, size_t *n) {
+  if (!path.empty()) {
+    if (!read_features(path, inputs, x, n)) {
+      fprintf(stderr, "%s: expected float32 [n][%d]\n", path.c_str(), inputs);
+      return false;
+    }
+    return true;
+  }
+  if (o.synthetic <= 0) {
+    fprintf(stderr, "need feature vectors (--calib/--eval FILE) or --synthetic N\n");
+    return false;
+  }
+  *n = o.synthetic;
+  synthetic_features(inputs, *n, seed, x);
+  return true;
+}
+
+template <class Head>
+static double time_per_sample(const Head &head, const std::vector<float> &x, size_t n, int batch, int iters) {
+  batch = (int)std::min<size_t>(batch, n);
+  std::vector<float> probs((size_t)batch * head.classes());
+  head.run(x.data(), batch, probs.data());
+  double t0 = now_seconds();
+  for (int i = 0; i < iters; i++) {
+    size_t off = (size_t)(i * batch % (n - batch + 1)) * head.inputs();
+    head.run(x.data() + off, batch, probs.data());
+  }
+  return (now_seconds() - t0) / iters / batch;
+}
+
+static int run_eval(const pose::PoseHead &fhead, const Options &o) {
+  pose::QuantHead qhead;
+  if (!qhead.load(o.q8)) {
+    fprintf(stderr, "%s\n", qhead.error().c_str());
+    return 1;
+  }
+  if (qhead.inputs() != fhead.inputs() || qhead.classes() != fhead.classes()) {
+    fprintf(stderr, "%s does not match the float model\n", o.q8.c_str());
+    return 1;
+  }
+  std::vector<float> x;
+  size_t n = 0;
+  if (!load_samples(o, o.eval, fhead.inputs(), 2, &x, &n)) return 1;
+
+  // agreement keputusan kelas + selisih probabilitas
+  const int C = fhead.classes();
+  std::vector<float> pf(n * C), pq(n * C);
+  fhead.run(x.data(), n, pf.data());
+  qhead.run(x.data(), n, pq.data());
+  std::vector<int> confusion(C * C, 0);
+  size_t agree = 0;
+  double max_dp = 0, sum_dp = 0;
+  for (size_t s = 0; s < n; s++) {
+    const float *a = &pf[s * C], *b = &pq[s * C];
+    int ca = (int)(std::max_element(a, a + C) - a);
+    int cb = (int)(std::max_element(b, b + C) - b);
+    confusion[ca * C + cb]++;
+    agree += ca == cb;
+    for (int c = 0; c < C; c++) {
+      double d = std::fabs(a[c] - b[c]);
+      max_dp = std::max(max_dp, d);
+      sum_dp += d;
+    }
+  }
+
+  double tf1 = time_per_sample(fhead, x, n, 1, o.iters);
+  double tq1 = time_per_sample(qhead, x, n, 1, o.iters);
+  double tfb = time_per_sample(fhead, x, n, o.batch, o.iters / 4 + 1);
+  double tqb = time_per_sample(qhead, x, n, o.batch, o.iters / 4 + 1);
+  double fbytes = ((double)fhead.inputs() * fhead.hidden() + fhead.hidden() * (C + 1.0) + C) * sizeof(float);
+
+  printf("samples %zu, kernels float %s / int8 %s\n", n, pose::PoseHead::kernel_name(), pose::QuantHead::kernel_name());
+  printf("%-8s %12s %12s %11s %-3d (per sample)\n", "", "weights", "batch 1", "batch", o.batch);
+  printf("%-8s %9.2f MB %9.3f ms %11.3f ms\n", "float32", fbytes / 1048576.0, tf1 * 1e3, tfb * 1e3);
+  printf("%-8s %9.2f MB %9.3f ms %11.3f ms\n", "int8", qhead.weight_bytes() / 1048576.0, tq1 * 1e3, tqb * 1e3);
+  printf("speedup %.2fx (batch 1), %.2fx (batch %d), memory %.2fx smaller\n", tf1 / tq1, tfb / tqb, o.batch,
+         fbytes / qhead.weight_bytes());
+  printf("agreement %zu/%zu = %.2f%%, |dp| max %.4f mean %.5f\n", agree, n, 100.0 * agree / n, max_dp, sum_dp / (n * C));
+  printf("confusion (rows float, cols int8):\n");
+  for (int a = 0; a < C; a++) {
+    const char *label = a < (int)fhead.labels().size() ? fhead.labels()[a].c_str() : "?";
+    printf("  %-20s", label);
+    for (int b = 0; b < C; b++) printf(" %7d", confusion[a * C + b]);
+    printf("\n");
+  }
+  return 0;
+}
+
+int main(int argc, char **argv) {
+  Options o;
+  if (argc < 2) {
+    fprintf(stderr,
+            "usage: %s MODEL_DIR --calib FEATURES.f32 --out HEAD.q8 [--percentile 99.99] [--groups 51]\n"
+            "       %s MODEL_DIR --q8 HEAD.q8 --eval FEATURES.f32 [--batch 8] [--iters 200]\n"
+            "       (--synthetic N replaces a missing --calib/--eval file)\n",
+            argv[0], argv[0]);
+    return 2;
+  }
+  o.model = argv[1];
+  for (int i = 2; i + 1 < argc; i += 2) {
+    std::string k = argv[i];
+    const char *v = argv[i + 1];
+    if (k == "--calib") o.calib = v;
+    else if (k == "--eval") o.eval = v;
+    else if (k == "--out") o.out = v;
+    else if (k == "--q8") o.q8 = v;
+    else if (k == "--synthetic") o.synthetic = atoi(v);
+    else if (k == "--batch") o.batch = atoi(v) > 0 ? atoi(v) : 1;
+    else if (k == "--iters") o.iters = atoi(v) > 0 ? atoi(v) : 1;
+    else if (k == "--percentile") o.quant.percentile = atof(v);
+    else if (k == "--groups") o.quant.groups = atoi(v);
+    else {
+      fprintf(stderr, "unknown option %s\n", k.c_str());
+      return 2;
+    }
+  }
+
+  pose::PoseHead fhead;
+  if (!fhead.load(o.model)) {
+    fprintf(stderr, "%s\n", fhead.error().c_str());
+    return 1;
+  }
+
+  if (!o.out.empty()) {
+    std::vector<float> x;
+    size_t n = 0;
+    if (!load_samples(o, o.calib, fhead.inputs(), 1, &x, &n)) return 1;
+    std::string err;
+    if (!pose::quantize_head(fhead, x.data(), n, o.quant, o.out, &err)) {
+      fprintf(stderr, "%s\n", err.c_str());
+      return 1;
+    }
+    printf("%s: calibrated on %zu samples (percentile %.3f, %d groups)\n", o.out.c_str(), n, o.quant.percentile, o.quant.groups);
+    if (o.q8.empty()) o.q8 = o.out;
+  }
+  if (!o.q8.empty() && (!o.eval.empty() || o.synthetic > 0)) return run_eval(fhead, o);
+  return 0;
+}
@@ -0,0 +1,565 @@
+#include "posenet.h"
+
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace pose {
+
+// Kernel ditulis dengan vector extension GCC (8 float) sebagai badan
+// always_inline. Di x86 badan yang sama diinstansiasi dua kali, AVX2+FMA dan
+// baseline, lalu dipilih saat runtime dengan __builtin_cpu_supports (seperti
+// pose_head); di aarch64 v8 menjadi pasangan register NEON.
+#if defined(__x86_64__) || defined(__i386__)
+#define POSE_X86 1
+#endif
+#define POSE_INLINE inline __attribute__((always_inline))
+
+// Helper v8 selalu inline; peringatan ABI AVX untuk fungsi static tidak relevan.
+#pragma GCC diagnostic ignored "-Wpsabi"
+typedef float v8 __attribute__((vector_size(32)));
+
+static POSE_INLINE v8 load8(const float *p) {
+  v8 v;
+  memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+static POSE_INLINE void store8(float *p, const v8 &v) {
+  memcpy(p, &v, sizeof(v));
+}
+
+// Broadcast skalar: "float * v8" menghasilkan vbroadcastss di AVX2, tapi di
+// baseline SSE2 v8 dipecah lewat stack; di sana initializer list jauh lebih cepat.
+struct ScalarSplat {
+  static POSE_INLINE float of(float x) { return x; }
+};
+struct VectorSplat {
+  static POSE_INLINE v8 of(float x) { return v8{x, x, x, x, x, x, x, x}; }
+};
+
+static POSE_INLINE v8 relu6(const v8 &x) {
+  const v8 zero = {};
+  const v8 six = zero + 6.0f;
+  v8 v = x > zero ? x : zero;
+  return v < six ? v : six;
+}
+
+static POSE_INLINE float relu6(float v) {
+  return std::min(std::max(v, 0.0f), 6.0f);
+}
+
+static const char *kKeypointNames[kKeypoints] = {
+  "nose",
+  "leftEye",
+  "rightEye",
+  "leftEar",
+  "rightEar",
+  "leftShoulder",
+  "rightShoulder",
+  "leftElbow",
+  "rightElbow",
+  "leftWrist",
+  "rightWrist",
+  "leftHip",
+  "rightHip",
+  "leftKnee",
+  "rightKnee",
+  "leftAnkle",
+  "rightAnkle",
+};
+
+const char *keypoint_name(int k) {
+  return k >= 0 && k < kKeypoints ? kKeypointNames[k] : "?";
+}
+
+// ---------- ThreadPool ----------
+ThreadPool::ThreadPool(int threads) {
+  if (threads <= 0) threads = std::max(1u, std::thread::hardware_concurrency());
+  for (int i = 1; i < threads; i++) workers_.emplace_back(&ThreadPool::loop, this, i);
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lk(mu_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  for (auto &t : workers_) t.join();
+}
+
+static void split(int n, int parts, int i, int *begin, int *end) {
+  *begin = (int)((long)n * i / parts);
+  *end = (int)((long)n * (i + 1) / parts);
+}
+
+void ThreadPool::loop(int id) {
+  uint64_t seen = 0;
+  for (;;) {
+    const std::function<void(int, int, int)> *job;
+    int n;
+    {
+      std::unique_lock<std::mutex> lk(mu_);
+      cv_.wait(lk, [&] { return stop_ || gen_ != seen; });
+      if (stop_) return;
+      seen = gen_;
+      job = job_;
+      n = job_n_;
+    }
+    int b, e;
+    split(n, size(), id, &b, &e);
+    if (b < e) (*job)(id, b, e);
+    {
+      std::lock_guard<std::mutex> lk(mu_);
+      if (--pending_ == 0) done_cv_.notify_one();
+    }
+  }
+}
+
+void ThreadPool::parallel_for(int n, const std::function<void(int, int, int)> &fn) {
+  if (workers_.empty() || n <= 1) {
+    if (n > 0) fn(0, 0, n);
+    return;
+  }
+  std::lock_guard<std::mutex> job_lk(job_mu_);
+  {
+    std::lock_guard<std::mutex> lk(mu_);
+    job_ = &fn;
+    job_n_ = n;
+    pending_ = (int)workers_.size();
+    gen_++;
+  }
+  cv_.notify_all();
+  int b, e;
+  split(n, size(), 0, &b, &e);
+  if (b < e) fn(0, b, e);
+  std::unique_lock<std::mutex> lk(mu_);
+  done_cv_.wait(lk, [&] { return pending_ == 0; });
+}
+
+// ---------- Kernel ----------
+// Semua aktivasi HWC float. Padding "same" TF: pad_t = total / 2.
+
+// Conv 3x3 biasa (Conv2d_0), cout kelipatan 8 dan <= 64.
+template <class S>
+static POSE_INLINE void conv3x3_body(const PoseNet::Layer &L, const float *in, float *out, int y0, int y1) {
+  const int nv = L.cout / 8;
+  for (int y = y0; y < y1; y++) {
+    for (int x = 0; x < L.out_w; x++) {
+      v8 acc[8];
+      for (int v = 0; v < nv; v++) acc[v] = load8(L.dw_b + v * 8);
+      for (int ky = 0; ky < 3; ky++) {
+        int iy = y * L.stride - L.pad_t + ky * L.rate;
+        if (iy < 0 || iy >= L.in_h) continue;
+        for (int kx = 0; kx < 3; kx++) {
+          int ix = x * L.stride - L.pad_l + kx * L.rate;
+          if (ix < 0 || ix >= L.in_w) continue;
+          const float *px = in + ((size_t)iy * L.in_w + ix) * L.cin;
+          const float *w = L.dw + (size_t)(ky * 3 + kx) * L.cin * L.cout;
+          for (int ci = 0; ci < L.cin; ci++) {
+            auto s = S::of(px[ci]);
+            for (int v = 0; v < nv; v++) acc[v] += s * load8(w + ci * L.cout + v * 8);
+          }
+        }
+      }
+      float *o = out + ((size_t)y * L.out_w + x) * L.cout;
+      for (int v = 0; v < nv; v++) store8(o + v * 8, relu6(acc[v]));
+    }
+  }
+}
+
+// Depthwise 3x3 (multiplier 1), channel kelipatan 8.
+static POSE_INLINE void depthwise_body(const PoseNet::Layer &L, const float *in, float *out, int y0, int y1) {
+  const int C = L.cin;
+  for (int y = y0; y < y1; y++) {
+    for (int x = 0; x < L.out_w; x++) {
+      // tap yang valid untuk piksel ini (maks 9)
+      const float *src[9];
+      const float *wt[9];
+      int taps = 0;
+      for (int ky = 0; ky < 3; ky++) {
+        int iy = y * L.stride - L.pad_t + ky * L.rate;
+        if (iy < 0 || iy >= L.in_h) continue;
+        for (int kx = 0; kx < 3; kx++) {
+          int ix = x * L.stride - L.pad_l + kx * L.rate;
+          if (ix < 0 || ix >= L.in_w) continue;
+          src[taps] = in + ((size_t)iy * L.in_w + ix) * C;
+          wt[taps] = L.dw + (ky * 3 + kx) * C;
+          taps++;
+        }
+      }
+      float *o = out + ((size_t)y * L.out_w + x) * C;
+      for (int c = 0; c < C; c += 8) {
+        v8 acc = load8(L.dw_b + c);
+        for (int t = 0; t < taps; t++) acc += load8(src[t] + c) * load8(wt[t] + c);
+        store8(o + c, relu6(acc));
+      }
+    }
+  }
+}
+
+// Pointwise 1x1 untuk piksel [p0, p1): blok 4 piksel x 16 channel di register.
+template <class S>
+static POSE_INLINE void pointwise_body(const float *in, int cin, const float *w, const float *bias, int cout, float *out, int ostride,
+                                       int p0, int p1, bool act) {
+  int p = p0;
+  for (; p + 4 <= p1; p += 4) {
+    const float *x0 = in + (size_t)p * cin;
+    const float *x1 = x0 + cin;
+    const float *x2 = x1 + cin;
+    const float *x3 = x2 + cin;
+    float *o0 = out + (size_t)p * ostride;
+    float *o1 = o0 + ostride;
+    float *o2 = o1 + ostride;
+    float *o3 = o2 + ostride;
+    int c = 0;
+    for (; c + 16 <= cout; c += 16) {
+      v8 a00 = load8(bias + c), a01 = load8(bias + c + 8);
+      v8 a10 = a00, a11 = a01, a20 = a00, a21 = a01, a30 = a00, a31 = a01;
+      const float *wr = w + c;
+      for (int ci = 0; ci < cin; ci++, wr += cout) {
+        v8 w0 = load8(wr), w1 = load8(wr + 8);
+        auto s = S::of(x0[ci]);
+        a00 += s * w0;
+        a01 += s * w1;
+        s = S::of(x1[ci]);
+        a10 += s * w0;
+        a11 += s * w1;
+        s = S::of(x2[ci]);
+        a20 += s * w0;
+        a21 += s * w1;
+        s = S::of(x3[ci]);
+        a30 += s * w0;
+        a31 += s * w1;
+      }
+      if (act) {
+        a00 = relu6(a00), a01 = relu6(a01), a10 = relu6(a10), a11 = relu6(a11);
+        a20 = relu6(a20), a21 = relu6(a21), a30 = relu6(a30), a31 = relu6(a31);
+      }
+      store8(o0 + c, a00), store8(o0 + c + 8, a01);
+      store8(o1 + c, a10), store8(o1 + c + 8, a11);
+      store8(o2 + c, a20), store8(o2 + c + 8, a21);
+      store8(o3 + c, a30), store8(o3 + c + 8, a31);
+    }
+    for (; c < cout; c++) {
+      float a0 = bias[c], a1 = a0, a2 = a0, a3 = a0;
+      for (int ci = 0; ci < cin; ci++) {
+        float wv = w[(size_t)ci * cout + c];
+        a0 += x0[ci] * wv;
+        a1 += x1[ci] * wv;
+        a2 += x2[ci] * wv;
+        a3 += x3[ci] * wv;
+      }
+      o0[c] = act ? relu6(a0) : a0;
+      o1[c] = act ? relu6(a1) : a1;
+      o2[c] = act ? relu6(a2) : a2;
+      o3[c] = act ? relu6(a3) : a3;
+    }
+  }
+  for (; p < p1; p++) {
+    const float *x0 = in + (size_t)p * cin;
+    float *o0 = out + (size_t)p * ostride;
+    for (int c = 0; c < cout; c++) {
+      float a = bias[c];
+      for (int ci = 0; ci < cin; ci++) a += x0[ci] * w[(size_t)ci * cout + c];
+      o0[c] = act ? relu6(a) : a;
+    }
+  }
+}
+
+// Instansiasi per ISA dan pemilihan sekali saat pertama dipakai.
+struct Kernels {
+  void (*conv3x3)(const PoseNet::Layer &, const float *, float *, int, int);
+  void (*depthwise)(const PoseNet::Layer &, const float *, float *, int, int);
+  void (*pointwise)(const float *, int, const float *, const float *, int, float *, int, int, int, bool);
+  const char *name;
+};
+
+static void conv3x3_base(const PoseNet::Layer &L, const float *in, float *out, int y0, int y1) {
+  conv3x3_body<VectorSplat>(L, in, out, y0, y1);
+}
+static void depthwise_base(const PoseNet::Layer &L, const float *in, float *out, int y0, int y1) {
+  depthwise_body(L, in, out, y0, y1);
+}
+static void pointwise_base(const float *in, int cin, const float *w, const float *bias, int cout, float *out, int ostride, int p0, int p1,
+                           bool act) {
+  pointwise_body<VectorSplat>(in, cin, w, bias, cout, out, ostride, p0, p1, act);
+}
+
+#if POSE_X86
+#define POSE_AVX2 __attribute__((target("avx2,fma")))
+POSE_AVX2 static void conv3x3_avx2(const PoseNet::Layer &L, const float *in, float *out, int y0, int y1) {
+  conv3x3_body<ScalarSplat>(L, in, out, y0, y1);
+}
+POSE_AVX2 static void depthwise_avx2(const PoseNet::Layer &L, const float *in, float *out, int y0, int y1) {
+  depthwise_body(L, in, out, y0, y1);
+}
+POSE_AVX2 static void pointwise_avx2(const float *in, int cin, const float *w, const float *bias, int cout, float *out, int ostride, int p0,
+                                     int p1, bool act) {
+  pointwise_body<ScalarSplat>(in, cin, w, bias, cout, out, ostride, p0, p1, act);
+}
+#endif
+
+static const Kernels &kernels() {
+#if POSE_X86
+  static const Kernels k = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")
+                             ? Kernels{conv3x3_avx2, depthwise_avx2, pointwise_avx2, "avx2"}
+                             : Kernels{conv3x3_base, depthwise_base, pointwise_base, "generic"};
+#else
+  static const Kernels k = {conv3x3_base, depthwise_base, pointwise_base, "generic"};
+#endif
+  return k;
+}
+
+const char *PoseNet::kernel_name() {
+  return kernels().name;
+}
+
+// ---------- Loader ----------
+// Definisi MobileNetV1 PoseNet (mobilenet.ts): stride per blok; 0.75/0.5
+// tidak punya blok stride 2 ke-12 seperti 1.0.
+static const int kStrides100[] = {2, 1, 2, 1, 2, 1, 2, 1, 1, 1, 1, 1, 2, 1};
+static const int kStrides75[] = {2, 1, 2, 1, 2, 1, 2, 1, 1, 1, 1, 1, 1, 1};
+static const int kBlocks = 14;
+
+bool PoseNet::fail(const std::string &msg) {
+  error_ = msg;
+  return false;
+}
+
+static bool shape_is(const Tensor *t, std::initializer_list<int> dims) {
+  if (!t || t->shape.size() != dims.size()) return false;
+  size_t i = 0;
+  for (int d : dims) {
+    if (d >= 0 && t->shape[i] != d) return false;
+    i++;
+  }
+  return true;
+}
+
+bool PoseNet::load(const std::string &path, const PoseNetConfig &cfg) {
+  cfg_ = cfg;
+  layers_.clear();
+  max_act_ = 0;
+  // folder hasil unduhan PoseNet: model-stride16.json + group1-shard*.bin
+  std::string json_path = path;
+  struct stat st;
+  if (stat(path.c_str(), &st) == 0 && S_ISDIR(st.st_mode)) {
+    std::string strided = path + "/model-stride" + std::to_string(cfg.output_stride) + ".json";
+    if (stat(strided.c_str(), &st) == 0) json_path = strided;
+  }
+  if (!weights_.load(json_path)) return fail(weights_.error());
+  const int *strides = cfg.multiplier >= 1.0f ? kStrides100 : kStrides75;
+
+  // toOutputStridedLayers: setelah stride tercapai, stride diganti dilation
+  int current = 1, rate = 1;
+  int h = cfg.input_resolution, w = cfg.input_resolution, c = 3;
+  for (int i = 0; i < kBlocks; i++) {
+    Layer L = {};
+    L.separable = i > 0;
+    if (current == cfg.output_stride) {
+      L.stride = 1;
+      L.rate = rate;
+      rate *= strides[i];
+    } else {
+      L.stride = strides[i];
+      L.rate = 1;
+      current *= strides[i];
+    }
+    std::string name = "Conv2d_" + std::to_string(i);
+    if (!L.separable) {
+      const Tensor *k = weights_.find_all((name + "/").c_str(), "weights");
+      const Tensor *b = weights_.find_all((name + "/").c_str(), "bias");
+      if (!shape_is(k, {3, 3, c, -1}) || !shape_is(b, {k->shape[3]})) return fail(name + ": missing or bad weights");
+      L.cout = k->shape[3];
+      if (L.cout % 8 || L.cout > 64) return fail(name + ": unsupported channel count");
+      L.dw = k->data;
+      L.dw_b = b->data;
+    } else {
+      const Tensor *dk = weights_.find_all((name + "_depthwise/").c_str(), "weights");
+      const Tensor *db = weights_.find_all((name + "_depthwise/").c_str(), "bias");
+      const Tensor *pk = weights_.find_all((name + "_pointwise/").c_str(), "weights");
+      const Tensor *pb = weights_.find_all((name + "_pointwise/").c_str(), "bias");
+      if (!shape_is(dk, {3, 3, c, 1}) || !shape_is(db, {c}) || !shape_is(pk, {1, 1, c, -1}) || !shape_is(pb, {pk->shape[3]})) {
+        return fail(name + ": missing or bad separable weights");
+      }
+      if (c % 8) return fail(name + ": unsupported channel count");
+      L.cout = pk->shape[3];
+      L.dw = dk->data;
+      L.dw_b = db->data;
+      L.pw = pk->data;
+      L.pw_b = pb->data;
+    }
+    L.cin = c;
+    L.in_h = h;
+    L.in_w = w;
+    int keff = 2 * L.rate + 1;
+    L.out_h = (h + L.stride - 1) / L.stride;
+    L.out_w = (w + L.stride - 1) / L.stride;
+    L.pad_t = std::max((L.out_h - 1) * L.stride + keff - h, 0) / 2;
+    L.pad_l = std::max((L.out_w - 1) * L.stride + keff - w, 0) / 2;
+    h = L.out_h;
+    w = L.out_w;
+    c = L.cout;
+    max_act_ = std::max(max_act_, (size_t)h * w * std::max(L.cin, L.cout));
+    layers_.push_back(L);
+  }
+  if (current != cfg.output_stride) return fail("output stride " + std::to_string(cfg.output_stride) + " not reachable");
+  grid_ = h;
+
+  // heatmap_2 dan offset_2: 1x1 conv, digabung jadi satu pointwise 51 channel
+  const Tensor *hk = weights_.find_all("heatmap_2/", "weights");
+  const Tensor *hb = weights_.find_all("heatmap_2/", "bias");
+  const Tensor *ok = weights_.find_all("offset_2/", "weights");
+  const Tensor *ob = weights_.find_all("offset_2/", "bias");
+  if (!shape_is(hk, {1, 1, c, kKeypoints}) || !shape_is(hb, {kKeypoints}) || !shape_is(ok, {1, 1, c, 2 * kKeypoints}) ||
+      !shape_is(ob, {2 * kKeypoints})) {
+    return fail("heatmap_2/offset_2: missing or bad weights");
+  }
+  const int heads = 3 * kKeypoints;
+  head_w_.assign((size_t)c * heads, 0.0f);
+  head_b_.assign(heads, 0.0f);
+  for (int ci = 0; ci < c; ci++) {
+    memcpy(&head_w_[(size_t)ci * heads], hk->data + (size_t)ci * kKeypoints, kKeypoints * sizeof(float));
+    memcpy(&head_w_[(size_t)ci * heads + kKeypoints], ok->data + (size_t)ci * 2 * kKeypoints, 2 * kKeypoints * sizeof(float));
+  }
+  memcpy(head_b_.data(), hb->data, kKeypoints * sizeof(float));
+  memcpy(head_b_.data() + kKeypoints, ob->data, 2 * kKeypoints * sizeof(float));
+  max_act_ = std::max(max_act_, (size_t)grid_ * grid_ * heads);
+  return true;
+}
+
+// ---------- Runner ----------
+PoseNetRunner::PoseNetRunner(const PoseNet &net, ThreadPool *pool) : net_(net), pool_(pool) {
+  int res = net.input_resolution();
+  size_t in_len = (size_t)res * res * 3;
+  size_t act_len = (net.max_act_ + 15) & ~(size_t)15;
+  arena_.assign(in_len + 16 + 2 * act_len, 0.0f);
+  input_ = arena_.data();
+  act_[0] = input_ + ((in_len + 15) & ~(size_t)15);
+  act_[1] = act_[0] + act_len;
+  col_src_.resize((size_t)res * 2);
+  col_frac_.resize(res);
+}
+
+void PoseNetRunner::for_rows(int rows, const std::function<void(int, int, int)> &fn) {
+  if (pool_) pool_->parallel_for(rows, fn);
+  else fn(0, 0, rows);
+}
+
+// resizeBilinear TFJS (alignCorners = false, halfPixelCenters = false) dari
+// gambar yang di-pad nol, lalu x / 127.5 - 1 (preprocessInput MobileNet).
+void PoseNetRunner::preprocess(const uint8_t *rgb, int w, int h, size_t stride, bool stretch) {
+  const int res = net_.input_resolution();
+  pad_t_ = pad_b_ = pad_l_ = pad_r_ = 0;
+  if (!stretch) {
+    if (w < h) pad_l_ = pad_r_ = (int)std::floor(0.5 * (h - w) + 0.5);
+    else pad_t_ = pad_b_ = (int)std::floor(0.5 * (w - h) + 0.5);
+  }
+  const int ph = h + pad_t_ + pad_b_;
+  const int pw = w + pad_l_ + pad_r_;
+  const float ry = (float)ph / res;
+  const float rx = (float)pw / res;
+  for (int x = 0; x < res; x++) {
+    float sx = rx * x;
+    int x0 = (int)std::floor(sx);
+    col_src_[x * 2] = x0 - pad_l_;
+    col_src_[x * 2 + 1] = std::min(pw - 1, (int)std::ceil(sx)) - pad_l_;
+    col_frac_[x] = sx - x0;
+  }
+  for_rows(res, [&](int, int y0, int y1) {
+    static const uint8_t kZero[3] = {0, 0, 0};
+    for (int y = y0; y < y1; y++) {
+      float sy = ry * y;
+      int top = (int)std::floor(sy);
+      int bot = std::min(ph - 1, (int)std::ceil(sy)) - pad_t_;
+      top -= pad_t_;
+      float fy = sy - std::floor(sy);
+      const uint8_t *rt = top >= 0 && top < h ? rgb + (size_t)top * stride : nullptr;
+      const uint8_t *rb = bot >= 0 && bot < h ? rgb + (size_t)bot * stride : nullptr;
+      float *o = input_ + (size_t)y * res * 3;
+      for (int x = 0; x < res; x++) {
+        int c0 = col_src_[x * 2], c1 = col_src_[x * 2 + 1];
+        bool in0 = c0 >= 0 && c0 < w, in1 = c1 >= 0 && c1 < w;
+        const uint8_t *tl = rt && in0 ? rt + c0 * 3 : kZero;
+        const uint8_t *tr = rt && in1 ? rt + c1 * 3 : kZero;
+        const uint8_t *bl = rb && in0 ? rb + c0 * 3 : kZero;
+        const uint8_t *br = rb && in1 ? rb + c1 * 3 : kZero;
+        float fx = col_frac_[x];
+        for (int k = 0; k < 3; k++) {
+          float t = tl[k] + (tr[k] - tl[k]) * fx;
+          float b = bl[k] + (br[k] - bl[k]) * fx;
+          o[x * 3 + k] = (t + (b - t) * fy) / 127.5f - 1.0f;
+        }
+      }
+    }
+  });
+}
+
+void PoseNetRunner::forward(const float *input, float *features) {
+  const Kernels &k = kernels();
+  const float *in = input;
+  float *a = act_[0];
+  float *b = act_[1];
+  for (const PoseNet::Layer &L : net_.layers_) {
+    if (!L.separable) {
+      for_rows(L.out_h, [&](int, int y0, int y1) { k.conv3x3(L, in, a, y0, y1); });
+    } else {
+      // depthwise in -> b, pointwise b -> a (in == a boleh ditimpa)
+      for_rows(L.out_h, [&](int, int y0, int y1) { k.depthwise(L, in, b, y0, y1); });
+      for_rows(L.out_h, [&](int, int y0, int y1) {
+        k.pointwise(b, L.cin, L.pw, L.pw_b, L.cout, a, L.cout, y0 * L.out_w, y1 * L.out_w, true);
+      });
+    }
+    in = a;
+  }
+
+  // heads langsung ke buffer fitur: per sel [sigmoid(heatmap) 17][offset 34]
+  const int g = net_.grid_;
+  const int heads = 3 * kKeypoints;
+  const int cin = net_.layers_.back().cout;
+  for_rows(g, [&](int, int y0, int y1) {
+    k.pointwise(in, cin, net_.head_w_.data(), net_.head_b_.data(), heads, features, heads, y0 * g, y1 * g, false);
+    for (int p = y0 * g; p < y1 * g; p++) {
+      float *f = features + (size_t)p * heads;
+      for (int k = 0; k < kKeypoints; k++) f[k] = 1.0f / (1.0f + std::exp(-f[k]));
+    }
+  });
+}
+
+// decodeSinglePose + scaleAndFlipPoses PoseNet.
+void PoseNetRunner::decode(const float *features, int w, int h, bool flip, Keypoint *kp) const {
+  const int g = net_.grid_;
+  const int heads = 3 * kKeypoints;
+  const int res = net_.input_resolution();
+  const float sy = (float)(h + pad_t_ + pad_b_) / res;
+  const float sx = (float)(w + pad_l_ + pad_r_) / res;
+  for (int k = 0; k < kKeypoints; k++) {
+    int best = 0;
+    for (int p = 1; p < g * g; p++) {
+      if (features[(size_t)p * heads + k] > features[(size_t)best * heads + k]) best = p;
+    }
+    const float *f = features + (size_t)best * heads;
+    float y = (best / g) * net_.output_stride() + f[kKeypoints + k];
+    float x = (best % g) * net_.output_stride() + f[2 * kKeypoints + k];
+    kp[k].score = f[k];
+    kp[k].y = y * sy - pad_t_;
+    kp[k].x = x * sx - pad_l_;
+    if (flip) kp[k].x = w - 1 - kp[k].x;
+  }
+}
+
+void PoseNetRunner::run(const uint8_t *rgb, int w, int h, size_t stride, float *features, Keypoint *keypoints, const InputOptions &opt) {
+  preprocess(rgb, w, h, stride, opt.stretch);
+  forward(input_, features);
+  if (keypoints) decode(features, w, h, opt.flip, keypoints);
+}
+
+void PoseNetRunner::run_tensor(const float *input, float *features) {
+  pad_t_ = pad_b_ = pad_l_ = pad_r_ = 0;
+  forward(input, features);
+}
+
+}  // namespace pose
@@ -0,0 +1,153 @@
+// Backbone PoseNet MobileNetV1 native (pengganti @teachablemachine/pose di TM_HTML).
+//
+// Konfigurasi mengikuti metadata.json my-pose-model: MobileNetV1 multiplier
+// 0.75, outputStride 16, inputResolution 257 -> grid 17x17. Output fitur sama
+// dengan poseOutputsToAray TM: concat(sigmoid(heatmap) 17, offsets 34) per
+// sel, urutan HWC -> 17 * 17 * 51 = 14739 float, input untuk PoseHead.
+//
+// Bobot dibaca dari model TFJS PoseNet (model-stride16.json + shard), dicari
+// per nama layer MobilenetV1/Conv2d_N(_depthwise|_pointwise), heatmap_2 dan
+// offset_2. Float32 dan kuantisasi uint8/uint16 didukung (tfjs_weights.h).
+//
+// PoseNet (bobot) read-only dan bisa dipakai bersama; setiap kamera punya
+// PoseNetRunner sendiri dengan arena aktivasi yang dialokasikan sekali di
+// konstruktor. Konvolusi depthwise/pointwise dibagi per baris output ke
+// ThreadPool.
+//
+//   pose::PoseNet net;
+//   net.load("posenet/mobilenet/float/075");
+//   pose::ThreadPool pool(4);
+//   pose::PoseNetRunner runner(net, &pool);
+//   runner.run(rgb, 320, 240, 320 * 3, features, keypoints);
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "tfjs_weights.h"
+
+namespace pose {
+
+static const int kKeypoints = 17;
+
+struct Keypoint {
+  float score;
+  float x;  // piksel gambar asli
+  float y;
+};
+
+const char *keypoint_name(int k);  // "nose", "leftEye", ...
+
+// Pool kecil untuk parallel_for; pemanggil ikut mengerjakan satu bagian.
+class ThreadPool {
+ public:
+  explicit ThreadPool(int threads = 0);  // 0 = hardware_concurrency
+  ~ThreadPool();
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  int size() const { return (int)workers_.size() + 1; }
+  // fn(worker, begin, end): [0, n) dibagi rata ke size() bagian.
+  // Aman dipanggil dari beberapa thread (job dijalankan bergantian).
+  void parallel_for(int n, const std::function<void(int, int, int)> &fn);
+
+ private:
+  void loop(int id);
+
+  std::vector<std::thread> workers_;
+  std::mutex job_mu_;
+  std::mutex mu_;
+  std::condition_variable cv_;
+  std::condition_variable done_cv_;
+  const std::function<void(int, int, int)> *job_ = nullptr;
+  int job_n_ = 0;
+  uint64_t gen_ = 0;
+  int pending_ = 0;
+  bool stop_ = false;
+};
+
+struct PoseNetConfig {
+  float multiplier = 0.75f;
+  int output_stride = 16;
+  int input_resolution = 257;
+};
+
+class PoseNet {
+ public:
+  // path = folder atau file model JSON TFJS PoseNet MobileNetV1.
+  bool load(const std::string &path, const PoseNetConfig &cfg = PoseNetConfig());
+
+  int input_resolution() const { return cfg_.input_resolution; }
+  int output_stride() const { return cfg_.output_stride; }
+  int grid() const { return grid_; }  // 17 untuk 257 / 16
+  int features() const { return grid_ * grid_ * kKeypoints * 3; }
+  const std::string &error() const { return error_; }
+  static const char *kernel_name();  // "avx2" atau "generic"
+
+  // Satu blok MobileNetV1 (geometri sudah dihitung untuk input_resolution).
+  struct Layer {
+    bool separable;
+    int stride, rate;
+    int cin, cout;
+    int in_h, in_w, out_h, out_w;
+    int pad_t, pad_l;
+    const float *dw;    // conv2d: [3][3][cin][cout], separable: [3][3][cin]
+    const float *dw_b;  // conv2d: [cout], separable: [cin]
+    const float *pw;    // [cin][cout]
+    const float *pw_b;  // [cout]
+  };
+
+ private:
+  friend class PoseNetRunner;
+
+  bool fail(const std::string &msg);
+
+  PoseNetConfig cfg_;
+  WeightFile weights_;
+  std::vector<Layer> layers_;
+  std::vector<float> head_w_;  // [cin][17 + 34]: heatmap_2 dan offset_2 digabung
+  std::vector<float> head_b_;
+  int grid_ = 0;
+  size_t max_act_ = 0;  // float terbesar per aktivasi
+  std::string error_;
+};
+
+struct InputOptions {
+  bool stretch = false;  // true: resize langsung ke persegi (seperti canvas 200x200 TM_HTML)
+  bool flip = false;     // cermin horizontal keypoint (fitur tidak berubah, sama dengan TM)
+};
+
+class PoseNetRunner {
+ public:
+  explicit PoseNetRunner(const PoseNet &net, ThreadPool *pool = nullptr);
+
+  // rgb: RGB888 HWC, stride byte per baris. Default gambar di-pad ke persegi
+  // lalu di-resize bilinear seperti padAndResizeTo PoseNet. features:
+  // net.features() float. keypoints (opsional): 17 titik di koordinat gambar asli.
+  void run(const uint8_t *rgb, int w, int h, size_t stride, float *features, Keypoint *keypoints = nullptr,
+           const InputOptions &opt = InputOptions());
+  // input: [res][res][3] sudah dinormalisasi ke [-1, 1].
+  void run_tensor(const float *input, float *features);
+
+ private:
+  void preprocess(const uint8_t *rgb, int w, int h, size_t stride, bool stretch);
+  void forward(const float *input, float *features);
+  void decode(const float *features, int w, int h, bool flip, Keypoint *keypoints) const;
+  void for_rows(int rows, const std::function<void(int, int, int)> &fn);
+
+  const PoseNet &net_;
+  ThreadPool *pool_;
+  std::vector<float> arena_;  // input + 2 aktivasi ping-pong, dialokasikan sekali
+  float *input_;
+  float *act_[2];
+  std::vector<int> col_src_;     // [res][2] kolom kiri/kanan bilinear
+  std::vector<float> col_frac_;  // [res]
+  int pad_t_ = 0, pad_b_ = 0, pad_l_ = 0, pad_r_ = 0;
+};
+
+}  // namespace pose
@@ -0,0 +1,241 @@
+// CLI untuk backbone PoseNet: cek golden, benchmark multi-kamera, atau
+// pipeline lengkap gambar -> keypoint -> kelas pose (dengan --head).
+//
+// Build:  g++ -O2 -std=c++17 -pthread posenet_cli.cpp posenet.cpp pose_head.cpp tfjs_weights.cpp -o posenet_cli
+// Contoh: ./posenet_cli posenet/075 --golden posenet_golden.bin
+//         ./posenet_cli posenet/075 --bench --threads 4 --streams 2 --iters 50
+//         ./posenet_cli posenet/075 --image frame.ppm --head ../my-pose-model --stretch
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "pose_head.h"
+#include "posenet.h"
+
+struct Options {
+  std::string model;
+  std::string golden;
+  std::string image;
+  std::string head;
+  std::string save_features;
+  double tol = 1e-3;
+  bool bench = false;
+  bool stretch = false;
+  bool flip = false;
+  int threads = 0;  // per stream, 0 = semua core
+  int streams = 1;
+  int iters = 50;
+  int width = 320;
+  int height = 240;
+};
+
+static double now_seconds() {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static bool read_all(const std::string &path, std::vector<uint8_t> *out) {
+  FILE *f = fopen(path.c_str(), "rb");
+  if (!f) return false;
+  fseek(f, 0, SEEK_END);
+  long n = ftell(f);
+  fseek(f, 0, SEEK_SET);
+  out->resize(n > 0 ? n : 0);
+  bool ok = fread(out->data(), 1, out->size(), f) == out->size();
+  fclose(f);
+  return ok;
+}
+
+// PPM biner (P6, maxval 255), mis. dari: ffmpeg -i frame.jpg frame.ppm
+static bool read_ppm(const std::string &path, std::vector<uint8_t> *rgb, int *w, int *h) {
+  std::vector<uint8_t> raw;
+  if (!read_all(path, &raw) || raw.size() < 3 || raw[0] != 'P' || raw[1] != '6') return false;
+  size_t p = 2;
+  int vals[3];
+  for (int i = 0; i < 3; i++) {
+    while (p < raw.size() && (isspace(raw[p]) || raw[p] == '#')) {
+      if (raw[p] == '#') {
+        while (p < raw.size() && raw[p] != '\n') p++;
+      } else {
+        p++;
+      }
+    }
+    vals[i] = 0;
+    while (p < raw.size() && isdigit(raw[p])) vals[i] = vals[i] * 10 + (raw[p++] - '0');
+  }
+  p++;  // satu whitespace setelah maxval
+  *w = vals[0];
+  *h = vals[1];
+  if (vals[2] != 255 || raw.size() < p + (size_t)*w * *h * 3) return false;
+  rgb->assign(raw.begin() + p, raw.begin() + p + (size_t)*w * *h * 3);
+  return true;
+}
+
+static pose::InputOptions input_options(const Options &o) {
+  pose::InputOptions in;
+  in.stretch = o.stretch;
+  in.flip = o.flip;
+  return in;
+}
+
+// Golden: "PBG1", w, h, n, rgb[h][w][3], features[n]
+static int run_golden(const pose::PoseNet &net, const Options &o) {
+  std::vector<uint8_t> raw;
+  if (!read_all(o.golden, &raw) || raw.size() < 16 || memcmp(raw.data(), "PBG1", 4) != 0) {
+    fprintf(stderr, "%s: not a golden file\n", o.golden.c_str());
+    return 1;
+  }
+  uint32_t hdr[3];
+  memcpy(hdr, raw.data() + 4, sizeof(hdr));
+  uint32_t w = hdr[0], h = hdr[1], n = hdr[2];
+  size_t img = (size_t)w * h * 3;
+  if ((int)n != net.features() || raw.size() != 16 + img + n * sizeof(float)) {
+    fprintf(stderr, "golden has %u features, model %d\n", n, net.features());
+    return 1;
+  }
+  std::vector<float> ref(n), got(n);
+  memcpy(ref.data(), raw.data() + 16 + img, n * sizeof(float));
+
+  pose::ThreadPool pool(o.threads);
+  pose::PoseNetRunner runner(net, &pool);
+  runner.run(raw.data() + 16, w, h, (size_t)w * 3, got.data());
+  double max_err = 0, max_ref = 0;
+  for (uint32_t i = 0; i < n; i++) {
+    max_err = std::max(max_err, (double)std::fabs(got[i] - ref[i]));
+    max_ref = std::max(max_ref, (double)std::fabs(ref[i]));
+  }
+  bool ok = max_err <= o.tol * std::max(1.0, max_ref);
+  printf("golden %s: %ux%u, %u features, max |err| %.3g (max |ref| %.3g, tol %.3g)\n", ok ? "PASS" : "FAIL", w, h, n, max_err,
+         max_ref, o.tol);
+  return ok ? 0 : 1;
+}
+
+// Beberapa kamera: satu runner + pool per stream, bobot dipakai bersama.
+static int run_bench(const pose::PoseNet &net, const Options &o) {
+  std::vector<uint8_t> rgb((size_t)o.width * o.height * 3);
+  for (size_t i = 0; i < rgb.size(); i++) rgb[i] = (uint8_t)(i * 2654435761u >> 24);
+  std::atomic<uint64_t> frames{0};
+  std::vector<std::thread> threads;
+  double t0 = now_seconds();
+  for (int s = 0; s < o.streams; s++) {
+    threads.emplace_back([&] {
+      pose::ThreadPool pool(o.threads);
+      pose::PoseNetRunner runner(net, &pool);
+      std::vector<float> features(net.features());
+      std::vector<pose::Keypoint> kp(pose::kKeypoints);
+      for (int i = 0; i < o.iters; i++) {
+        runner.run(rgb.data(), o.width, o.height, (size_t)o.width * 3, features.data(), kp.data(), input_options(o));
+        frames++;
+      }
+    });
+  }
+  for (auto &t : threads) t.join();
+  double dt = now_seconds() - t0;
+  printf("kernel %s, %d stream(s) x %d thread(s), %dx%d: %.1f ms/frame per stream, %.1f fps total\n", pose::PoseNet::kernel_name(),
+         o.streams, o.threads > 0 ? o.threads : (int)std::thread::hardware_concurrency(), o.width, o.height, dt / o.iters * 1e3,
+         frames / dt);
+  return 0;
+}
+
+static int run_image(const pose::PoseNet &net, const Options &o) {
+  std::vector<uint8_t> rgb;
+  int w = 0, h = 0;
+  if (!read_ppm(o.image, &rgb, &w, &h)) {
+    fprintf(stderr, "%s: expected binary PPM (P6)\n", o.image.c_str());
+    return 1;
+  }
+  pose::ThreadPool pool(o.threads);
+  pose::PoseNetRunner runner(net, &pool);
+  std::vector<float> features(net.features());
+  pose::Keypoint kp[pose::kKeypoints];
+  double t0 = now_seconds();
+  runner.run(rgb.data(), w, h, (size_t)w * 3, features.data(), kp, input_options(o));
+  printf("backbone %.1f ms\n", (now_seconds() - t0) * 1e3);
+  for (int k = 0; k < pose::kKeypoints; k++) printf("  %-14s %.2f  (%.1f, %.1f)\n", pose::keypoint_name(k), kp[k].score, kp[k].x, kp[k].y);
+
+  if (!o.save_features.empty()) {
+    FILE *f = fopen(o.save_features.c_str(), "wb");
+    if (f) {
+      fwrite(features.data(), sizeof(float), features.size(), f);
+      fclose(f);
+    }
+  }
+  if (!o.head.empty()) {
+    pose::PoseHead head;
+    if (!head.load(o.head)) {
+      fprintf(stderr, "%s\n", head.error().c_str());
+      return 1;
+    }
+    if (head.inputs() != net.features()) {
+      fprintf(stderr, "head expects %d features, backbone gives %d\n", head.inputs(), net.features());
+      return 1;
+    }
+    float conf = 0;
+    int c = head.predict(features.data(), &conf);
+    const char *label = c < (int)head.labels().size() ? head.labels()[c].c_str() : "?";
+    printf("pose: %s (%.1f%%)\n", label, conf * 100);
+  }
+  return 0;
+}
+
+int main(int argc, char **argv) {
+  Options o;
+  if (argc < 2) {
+    fprintf(stderr,
+            "usage: %s POSENET_DIR [--golden FILE] [--tol 1e-3]\n"
+            "          [--bench] [--threads 0] [--streams 1] [--iters 50] [--width 320] [--height 240]\n"
+            "          [--image FRAME.ppm] [--head MODEL_DIR] [--save-features FILE] [--stretch] [--flip]\n",
+            argv[0]);
+    return 2;
+  }
+  o.model = argv[1];
+  for (int i = 2; i < argc; i++) {
+    std::string k = argv[i];
+    if (k == "--bench" || k == "--stretch" || k == "--flip") {
+      if (k == "--bench") o.bench = true;
+      if (k == "--stretch") o.stretch = true;
+      if (k == "--flip") o.flip = true;
+      continue;
+    }
+    if (i + 1 >= argc) {
+      fprintf(stderr, "missing value for %s\n", k.c_str());
+      return 2;
+    }
+    const char *v = argv[++i];
+    if (k == "--golden") o.golden = v;
+    else if (k == "--tol") o.tol = atof(v);
+    else if (k == "--threads") o.threads = atoi(v);
+    else if (k == "--streams") o.streams = atoi(v) > 0 ? atoi(v) : 1;
+    else if (k == "--iters") o.iters = atoi(v) > 0 ? atoi(v) : 1;
+    else if (k == "--width") o.width = atoi(v);
+    else if (k == "--height") o.height = atoi(v);
+    else if (k == "--image") o.image = v;
+    else if (k == "--head") o.head = v;
+    else if (k == "--save-features") o.save_features = v;
+    else {
+      fprintf(stderr, "unknown option %s\n", k.c_str());
+      return 2;
+    }
+  }
+
+  pose::PoseNet net;
+  if (!net.load(o.model)) {
+    fprintf(stderr, "%s\n", net.error().c_str());
+    return 1;
+  }
+  printf("posenet %dx%d stride %d -> grid %d, %d features\n", net.input_resolution(), net.input_resolution(), net.output_stride(),
+         net.grid(), net.features());
+
+  int rc = 0;
+  if (!o.golden.empty()) rc |= run_golden(net, o);
+  if (!o.image.empty()) rc |= run_image(net, o);
+  if (o.bench) rc |= run_bench(net, o);
+  return rc;
+}
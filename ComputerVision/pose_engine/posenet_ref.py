@@ -0,0 +1,177 @@
+"""Referensi numpy untuk backbone PoseNet MobileNetV1 + file golden posenet_cli.
+
+Mengikuti tfjs-models/posenet: padAndResizeTo (pad nol ke persegi, lalu
+resizeBilinear alignCorners=false), x / 127.5 - 1, blok MobileNetV1 dengan
+relu6, heatmap_2 (sigmoid) dan offset_2. Fitur = concat(heatmap, offsets)
+per sel HWC, sama dengan poseOutputsToAray di @teachablemachine/pose.
+
+--synthetic menulis model TFJS acak (model.json + group1-shardNofM.bin,
+shard 4 MB seperti converter TFJS) dengan nama layer PoseNet, untuk tes
+tanpa mengunduh bobot asli.
+
+Format golden (little-endian):
+  char[4] "PBG1", uint32 w, uint32 h, uint32 features,
+  uint8 rgb[h][w][3], float32 features[features]
+
+Contoh:
+  python posenet_ref.py --model /tmp/posenet --synthetic --out /tmp/posenet_golden.bin
+"""
+import argparse
+import json
+import os
+import struct
+
+import numpy as np
+
+STRIDES_100 = [2, 1, 2, 1, 2, 1, 2, 1, 1, 1, 1, 1, 2, 1]
+STRIDES_75 = [2, 1, 2, 1, 2, 1, 2, 1, 1, 1, 1, 1, 1, 1]
+DEPTHS = [32, 64, 128, 128, 256, 256, 512, 512, 512, 512, 512, 512, 1024, 1024]
+SHARD_BYTES = 4 * 1024 * 1024
+
+
+def write_synthetic(model_dir, multiplier, seed):
+    rng = np.random.default_rng(seed)
+    tensors = []
+    cin = 3
+    for i, depth in enumerate(DEPTHS):
+        cout = int(depth * multiplier)
+        if i == 0:
+            tensors.append((f"MobilenetV1/Conv2d_0/weights", rng.normal(0, np.sqrt(2.0 / (9 * cin)), (3, 3, cin, cout))))
+            tensors.append((f"MobilenetV1/Conv2d_0/biases", rng.normal(0.1, 0.05, cout)))
+        else:
+            name = f"MobilenetV1/Conv2d_{i}"
+            tensors.append((f"{name}_depthwise/depthwise_weights", rng.normal(0, np.sqrt(2.0 / 9), (3, 3, cin, 1))))
+            tensors.append((f"{name}_depthwise/biases", rng.normal(0.1, 0.05, cin)))
+            tensors.append((f"{name}_pointwise/weights", rng.normal(0, np.sqrt(2.0 / cin), (1, 1, cin, cout))))
+            tensors.append((f"{name}_pointwise/biases", rng.normal(0.1, 0.05, cout)))
+        cin = cout
+    tensors.append(("MobilenetV1/heatmap_2/weights", rng.normal(0, np.sqrt(1.0 / cin), (1, 1, cin, 17))))
+    tensors.append(("MobilenetV1/heatmap_2/biases", rng.normal(-1.0, 0.1, 17)))
+    tensors.append(("MobilenetV1/offset_2/weights", rng.normal(0, np.sqrt(1.0 / cin), (1, 1, cin, 34))))
+    tensors.append(("MobilenetV1/offset_2/biases", rng.normal(0, 1.0, 34)))
+
+    os.makedirs(model_dir, exist_ok=True)
+    blob = b"".join(np.asarray(t, "<f4").tobytes() for _, t in tensors)
+    shards = [blob[i:i + SHARD_BYTES] for i in range(0, len(blob), SHARD_BYTES)]
+    paths = [f"group1-shard{i + 1}of{len(shards)}.bin" for i in range(len(shards))]
+    for path, data in zip(paths, shards):
+        with open(os.path.join(model_dir, path), "wb") as f:
+            f.write(data)
+    manifest = [{"paths": paths, "weights": [
+        {"name": n, "shape": list(np.shape(t)), "dtype": "float32"} for n, t in tensors]}]
+    with open(os.path.join(model_dir, "model-stride16.json"), "w") as f:
+        json.dump({"format": "graph-model", "weightsManifest": manifest}, f)
+
+
+def load_weights(model_dir):
+    path = os.path.join(model_dir, "model-stride16.json")
+    model_json = json.load(open(path))
+    out = {}
+    for group in model_json["weightsManifest"]:
+        raw = b"".join(open(os.path.join(model_dir, p), "rb").read() for p in group["paths"])
+        offset = 0
+        for w in group["weights"]:
+            count = int(np.prod(w["shape"]))
+            out[w["name"]] = np.frombuffer(raw, "<f4", count, offset).reshape(w["shape"]).astype(np.float64)
+            offset += count * 4
+    return out
+
+
+def find(weights, *parts):
+    for name, t in weights.items():
+        if all(p in name for p in parts):
+            return t
+    raise KeyError(parts)
+
+
+def pad_and_resize(rgb, res):
+    h, w, _ = rgb.shape
+    pad_t = pad_b = pad_l = pad_r = 0
+    if w < h:
+        pad_l = pad_r = int(np.floor(0.5 * (h - w) + 0.5))
+    else:
+        pad_t = pad_b = int(np.floor(0.5 * (w - h) + 0.5))
+    img = np.pad(rgb.astype(np.float64), ((pad_t, pad_b), (pad_l, pad_r), (0, 0)))
+    ph, pw = img.shape[:2]
+    sy = np.float32(ph / res) * np.arange(res, dtype=np.float32)
+    sx = np.float32(pw / res) * np.arange(res, dtype=np.float32)
+    y0 = np.floor(sy).astype(int)
+    y1 = np.minimum(ph - 1, np.ceil(sy).astype(int))
+    x0 = np.floor(sx).astype(int)
+    x1 = np.minimum(pw - 1, np.ceil(sx).astype(int))
+    fy = (sy - y0)[:, None, None]
+    fx = (sx - x0)[None, :, None]
+    top = img[y0][:, x0] + (img[y0][:, x1] - img[y0][:, x0]) * fx
+    bot = img[y1][:, x0] + (img[y1][:, x1] - img[y1][:, x0]) * fx
+    return (top + (bot - top) * fy) / 127.5 - 1.0
+
+
+def conv3x3(x, k, stride, rate, depthwise):
+    h, w, _ = x.shape
+    keff = 2 * rate + 1
+    oh, ow = -(-h // stride), -(-w // stride)
+    pt = max((oh - 1) * stride + keff - h, 0) // 2
+    pl = max((ow - 1) * stride + keff - w, 0) // 2
+    pb = max((oh - 1) * stride + keff - h, 0) - pt
+    pr = max((ow - 1) * stride + keff - w, 0) - pl
+    xp = np.pad(x, ((pt, pb), (pl, pr), (0, 0)))
+    out = 0.0
+    for ky in range(3):
+        for kx in range(3):
+            patch = xp[ky * rate:ky * rate + (oh - 1) * stride + 1:stride, kx * rate:kx * rate + (ow - 1) * stride + 1:stride]
+            out = out + (patch * k[ky, kx, :, 0] if depthwise else patch @ k[ky, kx])
+    return out
+
+
+def forward(weights, rgb, multiplier=0.75, output_stride=16, res=257):
+    x = pad_and_resize(rgb, res)
+    strides = STRIDES_100 if multiplier >= 1.0 else STRIDES_75
+    current, rate = 1, 1
+    relu6 = lambda v: np.clip(v, 0.0, 6.0)
+    for i, s in enumerate(strides):
+        if current == output_stride:
+            stride, layer_rate, rate = 1, rate, rate * s
+        else:
+            stride, layer_rate, current = s, 1, current * s
+        if i == 0:
+            x = relu6(conv3x3(x, find(weights, "Conv2d_0/", "weights"), stride, layer_rate, False) + find(weights, "Conv2d_0/", "bias"))
+        else:
+            n = f"Conv2d_{i}"
+            x = relu6(conv3x3(x, find(weights, n + "_depthwise/", "weights"), stride, layer_rate, True) +
+                      find(weights, n + "_depthwise/", "bias"))
+            x = relu6(x @ find(weights, n + "_pointwise/", "weights")[0, 0] + find(weights, n + "_pointwise/", "bias"))
+    heat = x @ find(weights, "heatmap_2/", "weights")[0, 0] + find(weights, "heatmap_2/", "bias")
+    offs = x @ find(weights, "offset_2/", "weights")[0, 0] + find(weights, "offset_2/", "bias")
+    return np.concatenate([1.0 / (1.0 + np.exp(-heat)), offs], axis=2).reshape(-1)
+
+
+def main():
+    ap = argparse.ArgumentParser()
+    ap.add_argument("--model", required=True, help="folder model-stride16.json")
+    ap.add_argument("--out", default="posenet_golden.bin")
+    ap.add_argument("--width", type=int, default=320)
+    ap.add_argument("--height", type=int, default=240)
+    ap.add_argument("--multiplier", type=float, default=0.75)
+    ap.add_argument("--seed", type=int, default=3)
+    ap.add_argument("--synthetic", action="store_true", help="tulis model acak ke --model dulu")
+    args = ap.parse_args()
+
+    if args.synthetic:
+        write_synthetic(args.model, args.multiplier, args.seed)
+    weights = load_weights(args.model)
+
+    # gambar uji halus (gradien + blob) supaya aktivasi tidak sekadar noise
+    yy, xx = np.mgrid[0:args.height, 0:args.width]
+    rgb = np.stack([xx * 255 // max(args.width - 1, 1), yy * 255 // max(args.height - 1, 1),
+                    128 + 127 * np.sin(xx / 9.0) * np.cos(yy / 7.0)], axis=2).astype(np.uint8)
+    features = forward(weights, rgb, args.multiplier).astype("<f4")
+
+    with open(args.out, "wb") as f:
+        f.write(b"PBG1" + struct.pack("<III", args.width, args.height, features.size))
+        f.write(rgb.tobytes())
+        f.write(features.tobytes())
+    print(f"{args.out}: {args.width}x{args.height} -> {features.size} features")
+
+
+if __name__ == "__main__":
+    main()
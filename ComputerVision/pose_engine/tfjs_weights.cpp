@@ -0,0 +1,266 @@
+#include "tfjs_weights.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cctype>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+namespace pose {
+
+// ---------- JSON ----------
+namespace json {
+
+bool read_file(const std::string &path, std::string *out) {
+  std::ifstream f(path, std::ios::binary);
+  if (!f) return false;
+  std::stringstream ss;
+  ss << f.rdbuf();
+  *out = ss.str();
+  return true;
+}
+
+size_t skip_ws(const std::string &s, size_t p) {
+  while (p < s.size() && isspace((unsigned char)s[p])) p++;
+  return p;
+}
+
+std::string string_at(const std::string &s, size_t *p) {
+  std::string out;
+  size_t i = *p + 1;
+  while (i < s.size() && s[i] != '"') {
+    if (s[i] == '\\' && i + 1 < s.size()) i++;
+    out += s[i++];
+  }
+  *p = i + 1;
+  return out;
+}
+
+size_t find_key(const std::string &s, const char *key, size_t from, size_t to) {
+  std::string k = std::string("\"") + key + "\"";
+  size_t p = s.find(k, from);
+  if (p == std::string::npos || p >= to) return std::string::npos;
+  p = skip_ws(s, p + k.size());
+  if (p >= s.size() || s[p] != ':') return std::string::npos;
+  return skip_ws(s, p + 1);
+}
+
+size_t match(const std::string &s, size_t p) {
+  int depth = 0;
+  for (size_t i = p; i < s.size(); i++) {
+    char c = s[i];
+    if (c == '"') {
+      size_t q = i;
+      string_at(s, &q);
+      i = q - 1;
+    } else if (c == '{' || c == '[') {
+      depth++;
+    } else if (c == '}' || c == ']') {
+      if (--depth == 0) return i;
+    }
+  }
+  return std::string::npos;
+}
+
+}  // namespace json
+
+// ---------- Manifest ----------
+struct Entry {
+  size_t group;
+  size_t offset;  // byte dalam gabungan shard grup
+  int bytes;      // per elemen di file
+  bool is_int;    // int32 / bool
+  bool quant;     // uint8/uint16: q * scale + min
+  double scale;
+  double min;
+};
+
+static std::string dir_of(const std::string &path) {
+  size_t s = path.find_last_of('/');
+  return s == std::string::npos ? std::string(".") : path.substr(0, s);
+}
+
+WeightFile::~WeightFile() {
+  if (map_) munmap(map_, map_len_);
+}
+
+bool WeightFile::fail(const std::string &msg) {
+  error_ = msg;
+  return false;
+}
+
+static bool read_shards(const std::string &dir, const std::vector<std::string> &paths, std::vector<uint8_t> *out) {
+  out->clear();
+  for (const auto &p : paths) {
+    std::string raw;
+    if (!json::read_file(dir + "/" + p, &raw)) return false;
+    out->insert(out->end(), raw.begin(), raw.end());
+  }
+  return true;
+}
+
+bool WeightFile::load(const std::string &path) {
+  struct stat st;
+  std::string json_path = path;
+  if (stat(path.c_str(), &st) == 0 && S_ISDIR(st.st_mode)) {
+    json_path = path + "/model.json";
+    if (stat(json_path.c_str(), &st) != 0) json_path = path + "/model";  // nama file di my-pose-model
+  }
+  dir_ = dir_of(json_path);
+  if (!json::read_file(json_path, &json_)) return fail("cannot read " + json_path);
+  const std::string &js = json_;
+
+  size_t wm = json::find_key(js, "weightsManifest", 0, js.size());
+  if (wm == std::string::npos || js[wm] != '[') return fail(json_path + ": no weightsManifest");
+  size_t wm_end = json::match(js, wm);
+
+  std::vector<std::vector<std::string>> groups;
+  std::vector<Entry> entries;
+  bool all_float = true;
+  for (size_t g = js.find('{', wm); g != std::string::npos && g < wm_end; g = js.find('{', g)) {
+    size_t g_end = json::match(js, g);
+    size_t paths = json::find_key(js, "paths", g, g_end);
+    size_t wlist = json::find_key(js, "weights", g, g_end);
+    if (paths == std::string::npos || wlist == std::string::npos) return fail(json_path + ": bad manifest group");
+    std::vector<std::string> files;
+    size_t paths_end = json::match(js, paths);
+    for (size_t p = js.find('"', paths); p != std::string::npos && p < paths_end; p = js.find('"', p)) files.push_back(json::string_at(js, &p));
+    groups.push_back(files);
+
+    size_t wend = json::match(js, wlist);
+    size_t offset = 0;
+    for (size_t p = js.find('{', wlist); p != std::string::npos && p < wend; p = js.find('{', p)) {
+      size_t e = json::match(js, p);
+      size_t n = json::find_key(js, "name", p, e);
+      size_t s = json::find_key(js, "shape", p, e);
+      size_t d = json::find_key(js, "dtype", p, e);
+      if (n == std::string::npos || s == std::string::npos || d == std::string::npos) return fail(json_path + ": bad manifest entry");
+      Tensor t;
+      t.name = json::string_at(js, &n);
+      t.count = 1;
+      for (const char *c = js.c_str() + s + 1; *c && *c != ']';) {
+        char *next;
+        long v = strtol(c, &next, 10);
+        if (next == c) break;
+        t.shape.push_back((int)v);
+        t.count *= v;
+        c = next;
+        while (*c == ',' || isspace((unsigned char)*c)) c++;
+      }
+      std::string dtype = json::string_at(js, &d);
+      Entry en = {groups.size() - 1, offset, 4, dtype != "float32", false, 1.0, 0.0};
+      if (dtype == "bool") en.bytes = 1;
+      else if (dtype != "float32" && dtype != "int32") return fail(t.name + ": unsupported dtype " + dtype);
+
+      size_t q = json::find_key(js, "quantization", p, e);
+      if (q != std::string::npos) {
+        size_t q_end = json::match(js, q);
+        size_t qd = json::find_key(js, "dtype", q, q_end);
+        size_t qs = json::find_key(js, "scale", q, q_end);
+        size_t qm = json::find_key(js, "min", q, q_end);
+        std::string qdtype = qd == std::string::npos ? "" : json::string_at(js, &qd);
+        if ((qdtype != "uint8" && qdtype != "uint16") || qs == std::string::npos || qm == std::string::npos) {
+          return fail(t.name + ": unsupported quantization " + qdtype);
+        }
+        en.bytes = qdtype == "uint8" ? 1 : 2;
+        en.quant = true;
+        en.is_int = false;
+        en.scale = strtod(js.c_str() + qs, nullptr);
+        en.min = strtod(js.c_str() + qm, nullptr);
+      }
+      if (en.quant || en.is_int) all_float = false;
+      offset += t.count * en.bytes;
+      entries.push_back(en);
+      tensors_.push_back(t);
+      p = e + 1;
+    }
+    g = g_end + 1;
+  }
+  if (tensors_.empty()) return fail(json_path + ": empty weightsManifest");
+
+  // Jalur cepat: satu shard float32 -> mmap, tensor menunjuk langsung ke file
+  if (groups.size() == 1 && groups[0].size() == 1 && all_float) {
+    std::string bin_path = dir_ + "/" + groups[0][0];
+    size_t need = entries.back().offset + tensors_.back().count * 4;
+    int fd = open(bin_path.c_str(), O_RDONLY);
+    if (fd < 0) return fail("cannot open " + bin_path);
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < need) {
+      close(fd);
+      return fail(bin_path + ": expected " + std::to_string(need) + " bytes");
+    }
+    map_len_ = st.st_size;
+    map_ = mmap(nullptr, map_len_, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map_ == MAP_FAILED) {
+      map_ = nullptr;
+      return fail("mmap failed for " + bin_path);
+    }
+    madvise(map_, map_len_, MADV_WILLNEED);
+    for (size_t i = 0; i < tensors_.size(); i++) tensors_[i].data = (const float *)((const uint8_t *)map_ + entries[i].offset);
+    return true;
+  }
+
+  // Jalur salin: gabungkan shard per grup, dekuantisasi ke float32
+  size_t total = 0;
+  for (const auto &t : tensors_) total += t.count;
+  owned_.assign(total, 0.0f);
+  size_t pos = 0;
+  std::vector<uint8_t> raw;
+  size_t loaded_group = (size_t)-1;
+  for (size_t i = 0; i < tensors_.size(); i++) {
+    const Entry &en = entries[i];
+    Tensor &t = tensors_[i];
+    if (en.group != loaded_group) {
+      if (!read_shards(dir_, groups[en.group], &raw)) return fail("cannot read weight shards of group " + std::to_string(en.group));
+      loaded_group = en.group;
+    }
+    if (en.offset + t.count * en.bytes > raw.size()) return fail(t.name + ": weight shards too short");
+    const uint8_t *src = raw.data() + en.offset;
+    float *dst = owned_.data() + pos;
+    for (size_t k = 0; k < t.count; k++) {
+      if (en.quant && en.bytes == 1) {
+        dst[k] = (float)(src[k] * en.scale + en.min);
+      } else if (en.quant) {
+        uint16_t v;
+        memcpy(&v, src + k * 2, 2);
+        dst[k] = (float)(v * en.scale + en.min);
+      } else if (en.bytes == 1) {
+        dst[k] = src[k] ? 1.0f : 0.0f;
+      } else if (en.is_int) {
+        int32_t v;
+        memcpy(&v, src + k * 4, 4);
+        dst[k] = (float)v;
+      } else {
+        memcpy(dst + k, src + k * 4, 4);
+      }
+    }
+    t.data = dst;
+    pos += t.count;
+  }
+  return true;
+}
+
+const Tensor *WeightFile::find(const std::string &name) const {
+  for (const auto &t : tensors_) {
+    if (t.name == name) return &t;
+  }
+  return nullptr;
+}
+
+const Tensor *WeightFile::find_all(const char *a, const char *b, const char *c) const {
+  for (const auto &t : tensors_) {
+    if (t.name.find(a) == std::string::npos) continue;
+    if (b && t.name.find(b) == std::string::npos) continue;
+    if (c && t.name.find(c) == std::string::npos) continue;
+    return &t;
+  }
+  return nullptr;
+}
+
+}  // namespace pose
@@ -0,0 +1,62 @@
+// Pembaca bobot format TensorFlow.js (model.json + shard .bin).
+//
+// weightsManifest dibaca berurutan; offset tiap tensor dihitung dari dtype
+// dan shape. Satu shard float32 di-mmap langsung (zero-copy). Kalau bobot
+// dipecah ke beberapa shard (tensor bisa melintasi batas shard) atau
+// terkuantisasi uint8/uint16 (q * scale + min), isinya disalin/didekuantisasi
+// ke buffer float32 milik WeightFile.
+#pragma once
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace pose {
+
+// JSON minimal: cukup untuk model.json, metadata.json dan manifest TFJS.
+namespace json {
+bool read_file(const std::string &path, std::string *out);
+size_t skip_ws(const std::string &s, size_t p);
+std::string string_at(const std::string &s, size_t *p);  // s[*p] == '"', *p maju lewat penutup
+// Posisi nilai untuk "key" pertama di [from, to); npos kalau tidak ada.
+size_t find_key(const std::string &s, const char *key, size_t from, size_t to);
+size_t match(const std::string &s, size_t p);  // akhir objek/array yang dibuka di s[p]
+}  // namespace json
+
+struct Tensor {
+  std::string name;
+  std::vector<int> shape;
+  size_t count = 0;
+  const float *data = nullptr;
+};
+
+class WeightFile {
+ public:
+  WeightFile() = default;
+  ~WeightFile();
+  WeightFile(const WeightFile &) = delete;
+  WeightFile &operator=(const WeightFile &) = delete;
+
+  // path = folder (model.json, lalu model) atau file JSON.
+  bool load(const std::string &path);
+
+  const std::string &json() const { return json_; }  // isi model.json (topologi)
+  const std::string &dir() const { return dir_; }
+  const std::vector<Tensor> &tensors() const { return tensors_; }
+  const Tensor *find(const std::string &name) const;
+  // Tensor pertama yang namanya memuat semua potongan (nullptr di akhir list).
+  const Tensor *find_all(const char *a, const char *b = nullptr, const char *c = nullptr) const;
+  const std::string &error() const { return error_; }
+
+ private:
+  bool fail(const std::string &msg);
+
+  std::string json_;
+  std::string dir_;
+  std::vector<Tensor> tensors_;
+  void *map_ = nullptr;
+  size_t map_len_ = 0;
+  std::vector<float> owned_;
+  std::string error_;
+};
+
+}  // namespace pose
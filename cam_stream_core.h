@@ -0,0 +1,4 @@
+#pragma once
+// Inti streaming ada di folder sketch firmware (build Arduino 5_3 hanya
+// melihat folder itu); sketch di root memakai file yang sama.
+#include "BoboBee Stream/5_3/cam_stream_core.h"
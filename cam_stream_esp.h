@@ -0,0 +1,195 @@
+#pragma once
+// Glue cam_stream_core.h ke esp_camera + esp_http_server.
+//
+//   Pixel policy:  cam_core::JpegOnly                       fb JPEG dikirim langsung (zero copy)
+//                  cam_core::EncodeJpeg<PIXFORMAT_RGB565>   frame2jpg_cb ke buffer yang dipakai ulang
+//   Led policy:    cam_core::StreamLed<LED_GPIO_NUM>        LED menyala selama ada stream
+//
+// cam_core::apply_config<Config>() mengisi pixel_format/fb_count/grab_mode/
+// fb_location di camera_config_t dari policy yang sama, jadi setting driver
+// tidak bisa lagi berbeda dari yang diasumsikan loop stream.
+// Response ditulis langsung ke socket (httpd_send) dengan Connection: close:
+// dua send per frame (prefix, payload) tanpa chunked encoding. Firmware 5_3
+// memakai loop yang sama lewat cam_stream.h (broadcaster + writev).
+#include <Arduino.h>
+#include <stdlib.h>
+#include <type_traits>
+#include "esp_camera.h"
+#include "esp_heap_caps.h"
+#include "esp_http_server.h"
+#include "img_converters.h"
+#include "cam_stream_core.h"
+
+namespace cam_core {
+
+struct JpegOnly {
+  static constexpr pixformat_t format = PIXFORMAT_JPEG;
+  static constexpr bool kEncode = false;
+};
+
+template <pixformat_t Format, int Quality = 80>
+struct EncodeJpeg {
+  static_assert(Format != PIXFORMAT_JPEG, "sensor JPEG: pakai JpegOnly");
+  static constexpr pixformat_t format = Format;
+  static constexpr bool kEncode = true;
+  static constexpr int quality = Quality;
+};
+
+// Hitung stream terbuka; LED mati setelah stream terakhir ditutup.
+template <int Pin>
+struct StreamLed {
+  static inline int open = 0;
+  static void stream_start() {
+    if (__atomic_fetch_add(&open, 1, __ATOMIC_RELAXED) == 0) {
+      digitalWrite(Pin, HIGH);
+    }
+  }
+  static void stream_stop() {
+    if (__atomic_sub_fetch(&open, 1, __ATOMIC_RELAXED) == 0) {
+      digitalWrite(Pin, LOW);
+    }
+  }
+};
+
+// Config::Pixel kalau ada, selain itu JpegOnly.
+template <class Config, class = void>
+struct pixel_of {
+  using type = JpegOnly;
+};
+template <class Config>
+struct pixel_of<Config, std::void_t<typename Config::Pixel>> {
+  using type = typename Config::Pixel;
+};
+
+template <class Config>
+void apply_config(camera_config_t &cfg, bool psram) {
+  using Grab = typename Config::Grab;
+  cfg.pixel_format = pixel_of<Config>::type::format;
+  if (psram) {
+    cfg.fb_location = CAMERA_FB_IN_PSRAM;
+    cfg.fb_count = Grab::fb_count;
+    cfg.grab_mode = Grab::latest ? CAMERA_GRAB_LATEST : CAMERA_GRAB_WHEN_EMPTY;
+  } else {
+    // DRAM hanya muat satu frame buffer
+    cfg.fb_location = CAMERA_FB_IN_DRAM;
+    cfg.fb_count = 1;
+    cfg.grab_mode = CAMERA_GRAB_WHEN_EMPTY;
+  }
+}
+
+template <class Pixel>
+class EspCamera {
+ public:
+  struct Frame {
+    const uint8_t *buf;
+    size_t len;
+    struct timeval timestamp;
+    camera_fb_t *fb;
+  };
+
+  ~EspCamera() { free(jpg_); }
+
+  bool grab(Frame *f) {
+    camera_fb_t *fb = esp_camera_fb_get();
+    if (!fb) {
+      return false;
+    }
+    f->timestamp = fb->timestamp;
+    if constexpr (!Pixel::kEncode) {
+      f->fb = fb;
+      f->buf = fb->buf;
+      f->len = fb->len;
+      return true;
+    } else {
+      jpg_len_ = 0;
+      bool ok = frame2jpg_cb(fb, Pixel::quality, on_jpeg, this) && jpg_len_ > 0 && !oom_;
+      esp_camera_fb_return(fb);
+      f->fb = nullptr;
+      f->buf = jpg_;
+      f->len = jpg_len_;
+      return ok;
+    }
+  }
+
+  void release(Frame *f) {
+    if constexpr (!Pixel::kEncode) {
+      esp_camera_fb_return(f->fb);
+    }
+  }
+
+ private:
+  // Buffer hanya tumbuh: setelah frame terbesar tidak ada alokasi lagi.
+  static size_t on_jpeg(void *arg, size_t index, const void *data, size_t len) {
+    EspCamera *c = (EspCamera *)arg;
+    if (index + len > c->jpg_cap_) {
+      size_t cap = (index + len) * 3 / 2;
+      uint8_t *p = (uint8_t *)heap_caps_realloc(c->jpg_, cap, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+      if (!p) {
+        p = (uint8_t *)realloc(c->jpg_, cap);
+      }
+      if (!p) {
+        c->oom_ = true;
+        return 0;
+      }
+      c->jpg_ = p;
+      c->jpg_cap_ = cap;
+    }
+    memcpy(c->jpg_ + index, data, len);
+    c->jpg_len_ = index + len;
+    return len;
+  }
+
+  uint8_t *jpg_ = nullptr;
+  size_t jpg_cap_ = 0;
+  size_t jpg_len_ = 0;
+  bool oom_ = false;
+};
+
+class HttpdSink {
+ public:
+  explicit HttpdSink(httpd_req_t *req) : req_(req) {}
+
+  bool begin(const char *content_type, const char *extra_hdrs) {
+    char head[320];
+    int n = snprintf(head, sizeof(head), "HTTP/1.1 200 OK\r\nContent-Type: %s\r\n%sCache-Control: no-cache\r\nConnection: close\r\n\r\n", content_type,
+                     extra_hdrs ? extra_hdrs : "");
+    return n > 0 && n < (int)sizeof(head) && write(head, n);
+  }
+
+  bool write_part(const char *prefix, size_t prefix_len, const uint8_t *buf, size_t len) {
+    return write(prefix, prefix_len) && write(buf, len);
+  }
+
+  bool write(const void *data, size_t len) {
+    const char *p = (const char *)data;
+    while (len > 0) {
+      int n = httpd_send(req_, p, len);
+      if (n <= 0) {
+        return false;
+      }
+      p += n;
+      len -= n;
+    }
+    return true;
+  }
+
+  // body dibatasi close
+  void end() { httpd_sess_trigger_close(req_->handle, httpd_req_to_sockfd(req_)); }
+
+ private:
+  httpd_req_t *req_;
+};
+
+template <class Config>
+esp_err_t serve_httpd(httpd_req_t *req) {
+  EspCamera<typename pixel_of<Config>::type> camera;
+  HttpdSink sink(req);
+  ServeStats st = serve<Config>(camera, sink);
+  sink.end();
+  if (st.grab_failed) {
+    Serial.println("Camera capture failed");
+  }
+  return st.frames > 0 || !st.grab_failed ? ESP_OK : ESP_FAIL;
+}
+
+}  // namespace cam_core
@@ -0,0 +1,580 @@
+// Core Arduino untuk simulator host: main(), Serial, String/Print/Stream,
+// waktu, GPIO dan LEDC.
+//
+// main() memanggil setup() lalu loop() terus-menerus dari thread utama
+// (task "loopTask"), seperti core ESP32. loop() yang kembali dalam kurang dari
+// 50 µs diberi jeda 1 ms supaya loop kosong tidak memakan satu core host.
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <deque>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Arduino.h"
+#include "sim.h"
+
+// ---------- Lingkungan ----------
+extern "C" const char *sim_env(const char *name, const char *def) {
+  const char *v = getenv(name);
+  return v && *v ? v : def;
+}
+
+extern "C" long sim_env_int(const char *name, long def) {
+  const char *v = getenv(name);
+  return v && *v ? strtol(v, NULL, 0) : def;
+}
+
+extern "C" double sim_env_double(const char *name, double def) {
+  const char *v = getenv(name);
+  return v && *v ? strtod(v, NULL) : def;
+}
+
+extern "C" int sim_verbose(void) {
+  static int v = (int)sim_env_int("SIM_VERBOSE", 0);
+  return v;
+}
+
+extern "C" int sim_port(int port) {
+  return port + (int)sim_env_int("SIM_PORT_OFFSET", 8000);
+}
+
+extern "C" void sim_sleep_us(int64_t us) {
+  if (us <= 0) {
+    return;
+  }
+  struct timespec ts;
+  ts.tv_sec = us / 1000000;
+  ts.tv_nsec = (long)(us % 1000000) * 1000;
+  while (nanosleep(&ts, &ts) != 0 && errno == EINTR) {
+  }
+}
+
+// ---------- Serial ----------
+HardwareSerial Serial;
+
+static std::mutex _out_mu;
+static std::mutex _in_mu;
+static std::deque<char> _in;
+static bool _in_started = false;
+
+// stdin dibaca di thread sendiri supaya available() tidak pernah blok.
+static void stdin_reader() {
+  char buf[256];
+  for (;;) {
+    ssize_t n = ::read(STDIN_FILENO, buf, sizeof(buf));
+    if (n <= 0) {
+      return;
+    }
+    std::lock_guard<std::mutex> lock(_in_mu);
+    _in.insert(_in.end(), buf, buf + n);
+  }
+}
+
+static void stdin_start() {
+  std::lock_guard<std::mutex> lock(_in_mu);
+  if (!_in_started) {
+    _in_started = true;
+    std::thread(stdin_reader).detach();
+  }
+}
+
+int HardwareSerial::available() {
+  stdin_start();
+  std::lock_guard<std::mutex> lock(_in_mu);
+  return (int)_in.size();
+}
+
+int HardwareSerial::read() {
+  stdin_start();
+  std::lock_guard<std::mutex> lock(_in_mu);
+  if (_in.empty()) {
+    return -1;
+  }
+  int c = (uint8_t)_in.front();
+  _in.pop_front();
+  return c;
+}
+
+int HardwareSerial::peek() {
+  stdin_start();
+  std::lock_guard<std::mutex> lock(_in_mu);
+  return _in.empty() ? -1 : (uint8_t)_in.front();
+}
+
+size_t HardwareSerial::write(const uint8_t *buf, size_t len) {
+  std::lock_guard<std::mutex> lock(_out_mu);
+  fwrite(buf, 1, len, stdout);
+  if (memchr(buf, '\n', len)) {
+    fflush(stdout);
+  }
+  return len;
+}
+
+void HardwareSerial::flush() {
+  std::lock_guard<std::mutex> lock(_out_mu);
+  fflush(stdout);
+}
+
+// Format log core Arduino: [   1234][E][file.cpp:12] func(): pesan
+extern "C" void sim_log(char level, const char *file, int line, const char *func, const char *fmt, ...) {
+  char msg[512];
+  va_list ap;
+  va_start(ap, fmt);
+  vsnprintf(msg, sizeof(msg), fmt, ap);
+  va_end(ap);
+  const char *base = strrchr(file, '/');
+  std::lock_guard<std::mutex> lock(_out_mu);
+  fprintf(stdout, "[%7lu][%c][%s:%d] %s(): %s\n", millis(), level, base ? base + 1 : file, line, func, msg);
+  fflush(stdout);
+}
+
+// ---------- String ----------
+static std::string to_base(unsigned long long v, bool neg, unsigned char base) {
+  if (base < 2 || base > 36) {
+    base = 10;
+  }
+  char tmp[72];
+  int i = sizeof(tmp);
+  tmp[--i] = 0;
+  do {
+    int d = (int)(v % base);
+    tmp[--i] = (char)(d < 10 ? '0' + d : 'a' + d - 10);
+    v /= base;
+  } while (v);
+  if (neg) {
+    tmp[--i] = '-';
+  }
+  return std::string(tmp + i);
+}
+
+static std::string signed_str(long long v, unsigned char base) {
+  // basis selain 10 dicetak tanpa tanda, seperti core Arduino
+  if (base == 10 && v < 0) {
+    return to_base(0ULL - (unsigned long long)v, true, base);
+  }
+  return to_base((unsigned long long)v, false, base);
+}
+
+static std::string float_str(double v, unsigned int decimals) {
+  char buf[64];
+  snprintf(buf, sizeof(buf), "%.*f", (int)decimals, v);
+  return buf;
+}
+
+String::String(int v, unsigned char base) : s_(signed_str(base == 10 ? (long long)v : (long long)(unsigned int)v, base)) {}
+String::String(unsigned int v, unsigned char base) : s_(to_base(v, false, base)) {}
+String::String(long v, unsigned char base) : s_(signed_str(base == 10 ? (long long)v : (long long)(unsigned long)v, base)) {}
+String::String(unsigned long v, unsigned char base) : s_(to_base(v, false, base)) {}
+String::String(long long v, unsigned char base) : s_(signed_str(v, base)) {}
+String::String(unsigned long long v, unsigned char base) : s_(to_base(v, false, base)) {}
+String::String(float v, unsigned int decimals) : s_(float_str(v, decimals)) {}
+String::String(double v, unsigned int decimals) : s_(float_str(v, decimals)) {}
+
+void String::trim() {
+  size_t b = s_.find_first_not_of(" \t\r\n\f\v");
+  if (b == std::string::npos) {
+    s_.clear();
+    return;
+  }
+  size_t e = s_.find_last_not_of(" \t\r\n\f\v");
+  s_ = s_.substr(b, e - b + 1);
+}
+
+void String::toLowerCase() {
+  for (char &c : s_) {
+    c = (char)tolower((unsigned char)c);
+  }
+}
+
+void String::toUpperCase() {
+  for (char &c : s_) {
+    c = (char)toupper((unsigned char)c);
+  }
+}
+
+int String::indexOf(char c, unsigned int from) const {
+  size_t p = s_.find(c, from);
+  return p == std::string::npos ? -1 : (int)p;
+}
+
+int String::indexOf(const String &s, unsigned int from) const {
+  size_t p = s_.find(s.s_, from);
+  return p == std::string::npos ? -1 : (int)p;
+}
+
+String String::substring(unsigned int begin) const {
+  return begin >= s_.size() ? String() : String(s_.substr(begin));
+}
+
+String String::substring(unsigned int begin, unsigned int end) const {
+  if (begin > end) {
+    std::swap(begin, end);
+  }
+  if (begin >= s_.size()) {
+    return String();
+  }
+  return String(s_.substr(begin, std::min<size_t>(end, s_.size()) - begin));
+}
+
+bool String::endsWith(const String &s) const {
+  return s_.size() >= s.s_.size() && s_.compare(s_.size() - s.s_.size(), s.s_.size(), s.s_) == 0;
+}
+
+bool String::equalsIgnoreCase(const String &s) const {
+  return s_.size() == s.s_.size() && strcasecmp(s_.c_str(), s.s_.c_str()) == 0;
+}
+
+long String::toInt() const {
+  return strtol(s_.c_str(), NULL, 10);
+}
+
+float String::toFloat() const {
+  return strtof(s_.c_str(), NULL);
+}
+
+void String::replace(const String &from, const String &to) {
+  if (from.s_.empty()) {
+    return;
+  }
+  size_t p = 0;
+  while ((p = s_.find(from.s_, p)) != std::string::npos) {
+    s_.replace(p, from.s_.size(), to.s_);
+    p += to.s_.size();
+  }
+}
+
+String IPAddress::toString() const {
+  char buf[16];
+  snprintf(buf, sizeof(buf), "%u.%u.%u.%u", (*this)[0], (*this)[1], (*this)[2], (*this)[3]);
+  return String(buf);
+}
+
+// ---------- Print / Stream ----------
+size_t Print::write(const uint8_t *buf, size_t len) {
+  size_t n = 0;
+  while (len--) {
+    n += write(*buf++);
+  }
+  return n;
+}
+
+size_t Print::printf(const char *fmt, ...) {
+  char small[256];
+  va_list ap;
+  va_start(ap, fmt);
+  int n = vsnprintf(small, sizeof(small), fmt, ap);
+  va_end(ap);
+  if (n < 0) {
+    return 0;
+  }
+  if ((size_t)n < sizeof(small)) {
+    return write((const uint8_t *)small, n);
+  }
+  std::vector<char> big(n + 1);
+  va_start(ap, fmt);
+  vsnprintf(big.data(), big.size(), fmt, ap);
+  va_end(ap);
+  return write((const uint8_t *)big.data(), n);
+}
+
+size_t Print::print(long v, int base) {
+  return print(String(v, (unsigned char)base));
+}
+
+size_t Print::print(unsigned long v, int base) {
+  return print(String(v, (unsigned char)base));
+}
+
+size_t Print::print(long long v, int base) {
+  return print(String(v, (unsigned char)base));
+}
+
+size_t Print::print(unsigned long long v, int base) {
+  return print(String(v, (unsigned char)base));
+}
+
+size_t Print::print(double v, int digits) {
+  return print(String(v, (unsigned int)digits));
+}
+
+int Stream::timed_read() {
+  unsigned long start = millis();
+  do {
+    int c = read();
+    if (c >= 0) {
+      return c;
+    }
+    delay(1);
+  } while (millis() - start < timeout_ms_);
+  return -1;
+}
+
+size_t Stream::readBytes(char *buf, size_t len) {
+  size_t n = 0;
+  while (n < len) {
+    int c = timed_read();
+    if (c < 0) {
+      break;
+    }
+    buf[n++] = (char)c;
+  }
+  return n;
+}
+
+String Stream::readString() {
+  std::string s;
+  int c;
+  while ((c = timed_read()) >= 0) {
+    s += (char)c;
+  }
+  return String(s);
+}
+
+String Stream::readStringUntil(char terminator) {
+  std::string s;
+  int c;
+  while ((c = timed_read()) >= 0 && c != terminator) {
+    s += (char)c;
+  }
+  return String(s);
+}
+
+// ---------- Waktu ----------
+unsigned long millis(void) {
+  return (unsigned long)(esp_timer_get_time() / 1000);
+}
+
+unsigned long micros(void) {
+  return (unsigned long)esp_timer_get_time();
+}
+
+void delay(uint32_t ms) {
+  vTaskDelay(pdMS_TO_TICKS(ms));
+}
+
+void delayMicroseconds(uint32_t us) {
+  sim_sleep_us(us);
+}
+
+void yield(void) {
+  taskYIELD();
+}
+
+// ---------- GPIO / LEDC ----------
+static uint8_t _pin_level[GPIO_NUM_MAX];
+static uint32_t _ledc_duty[GPIO_NUM_MAX];
+
+void pinMode(uint8_t pin, uint8_t mode) {
+  (void)pin;
+  (void)mode;
+}
+
+void digitalWrite(uint8_t pin, uint8_t val) {
+  if (pin >= GPIO_NUM_MAX) {
+    return;
+  }
+  if (_pin_level[pin] != val && sim_verbose()) {
+    sim_log('I', __FILE__, __LINE__, __FUNCTION__, "GPIO%u = %u", pin, val);
+  }
+  _pin_level[pin] = val;
+}
+
+int digitalRead(uint8_t pin) {
+  return pin < GPIO_NUM_MAX ? _pin_level[pin] : LOW;
+}
+
+uint16_t analogRead(uint8_t pin) {
+  (void)pin;
+  return 0;
+}
+
+extern "C" bool ledcAttach(uint8_t pin, uint32_t freq, uint8_t resolution) {
+  if (sim_verbose()) {
+    sim_log('I', __FILE__, __LINE__, __FUNCTION__, "LEDC GPIO%u %u Hz %u bit", pin, (unsigned)freq, resolution);
+  }
+  return pin < GPIO_NUM_MAX;
+}
+
+extern "C" bool ledcWrite(uint8_t pin, uint32_t duty) {
+  if (pin >= GPIO_NUM_MAX) {
+    return false;
+  }
+  if (_ledc_duty[pin] != duty && sim_verbose()) {
+    sim_log('I', __FILE__, __LINE__, __FUNCTION__, "LEDC GPIO%u duty %u", pin, (unsigned)duty);
+  }
+  _ledc_duty[pin] = duty;
+  return true;
+}
+
+extern "C" uint32_t ledcRead(uint8_t pin) {
+  return pin < GPIO_NUM_MAX ? _ledc_duty[pin] : 0;
+}
+
+// ---------- Random / math ----------
+static bool _seeded = false;
+
+long random(long max) {
+  if (max <= 0) {
+    return 0;
+  }
+  return _seeded ? rand() % max : (long)(esp_random() % (uint32_t)max);
+}
+
+long random(long min, long max) {
+  if (min >= max) {
+    return min;
+  }
+  return random(max - min) + min;
+}
+
+void randomSeed(unsigned long seed) {
+  if (seed != 0) {
+    srand((unsigned)seed);
+    _seeded = true;
+  }
+}
+
+long map(long x, long in_min, long in_max, long out_min, long out_max) {
+  long in_range = in_max - in_min;
+  if (in_range == 0) {
+    return out_min;
+  }
+  return (x - in_min) * (out_max - out_min) / in_range + out_min;
+}
+
+// ---------- stdlib_noniso ----------
+char *ultoa(unsigned long value, char *result, int base) {
+  if (base < 2 || base > 36) {
+    *result = 0;
+    return result;
+  }
+  char tmp[sizeof(unsigned long) * 8 + 1];
+  int n = 0;
+  do {
+    int d = (int)(value % base);
+    tmp[n++] = (char)(d < 10 ? '0' + d : 'a' + d - 10);
+    value /= base;
+  } while (value);
+  for (int i = 0; i < n; i++) {
+    result[i] = tmp[n - 1 - i];
+  }
+  result[n] = 0;
+  return result;
+}
+
+char *ltoa(long value, char *result, int base) {
+  if (value < 0 && base == 10) {
+    *result = '-';
+    ultoa(-(unsigned long)value, result + 1, base);
+    return result;
+  }
+  return ultoa((unsigned long)value, result, base);
+}
+
+char *itoa(int value, char *result, int base) {
+  if (value < 0 && base == 10) {
+    return ltoa(value, result, base);
+  }
+  return ultoa((unsigned)value, result, base);
+}
+
+char *utoa(unsigned value, char *result, int base) {
+  return ultoa(value, result, base);
+}
+
+// ---------- ESP ----------
+EspClass ESP;
+
+bool psramFound(void) {
+  return sim_env_int("SIM_PSRAM_SIZE", 8 << 20) > 0;
+}
+
+bool psramInit(void) {
+  return psramFound();
+}
+
+uint32_t EspClass::getHeapSize() {
+  return (uint32_t)sim_env_int("SIM_INTERNAL_SIZE", 320 << 10);
+}
+
+uint32_t EspClass::getFreeHeap() {
+  return (uint32_t)heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+}
+
+uint32_t EspClass::getMinFreeHeap() {
+  return (uint32_t)heap_caps_get_minimum_free_size(MALLOC_CAP_INTERNAL);
+}
+
+uint32_t EspClass::getMaxAllocHeap() {
+  return (uint32_t)heap_caps_get_largest_free_block(MALLOC_CAP_INTERNAL);
+}
+
+uint32_t EspClass::getPsramSize() {
+  return (uint32_t)sim_env_int("SIM_PSRAM_SIZE", 8 << 20);
+}
+
+uint32_t EspClass::getFreePsram() {
+  return (uint32_t)heap_caps_get_free_size(MALLOC_CAP_SPIRAM);
+}
+
+void EspClass::restart() {
+  Serial.println("ESP.restart() dipanggil, simulator keluar");
+  fflush(stdout);
+  exit(0);
+}
+
+// ---------- main ----------
+struct loop_hook {
+  void (*fn)(void *);
+  void *arg;
+};
+static std::mutex _hook_mu;
+static std::vector<loop_hook> _hooks;
+
+extern "C" void sim_add_loop_hook(void (*fn)(void *arg), void *arg) {
+  std::lock_guard<std::mutex> lock(_hook_mu);
+  _hooks.push_back({fn, arg});
+}
+
+static void run_hooks() {
+  std::vector<loop_hook> hooks;
+  {
+    std::lock_guard<std::mutex> lock(_hook_mu);
+    hooks = _hooks;
+  }
+  for (const loop_hook &h : hooks) {
+    h.fn(h.arg);
+  }
+}
+
+int main(int argc, char **argv) {
+  (void)argc;
+  (void)argv;
+  // socket yang ditutup peer: send/writev dapat EPIPE, bukan sinyal (lwIP juga)
+  signal(SIGPIPE, SIG_IGN);
+  setvbuf(stdout, NULL, _IOFBF, 1 << 16);
+  pthread_setname_np(pthread_self(), "loopTask");
+  xTaskGetCurrentTaskHandle();
+
+  setup();
+  for (;;) {
+    int64_t t0 = esp_timer_get_time();
+    loop();
+    run_hooks();
+    if (esp_timer_get_time() - t0 < 50) {
+      delay(1);
+    }
+  }
+}
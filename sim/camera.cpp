@@ -0,0 +1,565 @@
+// Stand-in esp_camera untuk simulator host.
+//
+// Thread capture meminta frame dari sim_cam::Source (default: pola sintetis
+// bergerak pada SIM_CAMERA_FPS) dan menaruhnya di fb_count slot seperti
+// driver: WHEN_EMPTY hanya mengisi slot kosong (frame dibuang kalau semua
+// terpakai), LATEST menimpa frame READY tertua dan fb_get memberi yang
+// terbaru. fb_get menunggu paling lama 4 s lalu NULL, sama seperti driver.
+// Sumber lossless (replay kecepatan maksimum) tidak pernah kehilangan frame.
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "esp_camera.h"
+#include "esp32-hal-log.h"
+#include "esp_timer.h"
+#include "sim.h"
+#include "sim_camera.h"
+
+#define CAM_FB_GET_TIMEOUT_US 4000000
+
+const resolution_info_t resolution[FRAMESIZE_INVALID] = {
+  {96, 96, ASPECT_RATIO_1X1},     {160, 120, ASPECT_RATIO_4X3},   {128, 128, ASPECT_RATIO_1X1},
+  {176, 144, ASPECT_RATIO_5X4},   {240, 176, ASPECT_RATIO_3X2},   {240, 240, ASPECT_RATIO_1X1},
+  {320, 240, ASPECT_RATIO_4X3},   {320, 320, ASPECT_RATIO_1X1},   {400, 296, ASPECT_RATIO_4X3},
+  {480, 320, ASPECT_RATIO_3X2},   {640, 480, ASPECT_RATIO_4X3},   {800, 600, ASPECT_RATIO_4X3},
+  {1024, 768, ASPECT_RATIO_4X3},  {1280, 720, ASPECT_RATIO_16X9}, {1280, 1024, ASPECT_RATIO_5X4},
+  {1600, 1200, ASPECT_RATIO_4X3}, {1920, 1080, ASPECT_RATIO_16X9}, {720, 1280, ASPECT_RATIO_9X16},
+  {864, 1536, ASPECT_RATIO_9X16}, {2048, 1536, ASPECT_RATIO_4X3}, {2560, 1440, ASPECT_RATIO_16X9},
+  {2560, 1600, ASPECT_RATIO_16X10}, {1080, 1920, ASPECT_RATIO_9X16}, {2560, 1920, ASPECT_RATIO_4X3},
+  {2592, 1944, ASPECT_RATIO_4X3},
+};
+
+namespace sim_cam {
+
+int libjpeg_quality(int cam_quality) {
+  int q = (int)lround(100 - 1.4 * cam_quality);
+  return q < 5 ? 5 : q > 98 ? 98 : q;
+}
+
+// ---------- Konversi ----------
+static void to_yuv(const uint8_t *bgr, uint8_t *y, uint8_t *u, uint8_t *v) {
+  int b = bgr[0], g = bgr[1], r = bgr[2];
+  *y = (uint8_t)(16 + ((66 * r + 129 * g + 25 * b + 128) >> 8));
+  if (u) {
+    *u = (uint8_t)(128 + ((-38 * r - 74 * g + 112 * b + 128) >> 8));
+    *v = (uint8_t)(128 + ((112 * r - 94 * g - 18 * b + 128) >> 8));
+  }
+}
+
+bool encode_bgr(const uint8_t *bgr, int w, int h, pixformat_t format, int quality, Frame *f) {
+  f->width = w;
+  f->height = h;
+  f->format = format;
+  f->data.clear();
+  switch (format) {
+    case PIXFORMAT_JPEG: {
+      uint8_t *jpg = NULL;
+      size_t len = 0;
+      if (!fmt2jpg((uint8_t *)bgr, (size_t)w * h * 3, w, h, PIXFORMAT_RGB888, libjpeg_quality(quality), &jpg, &len)) {
+        return false;
+      }
+      f->data.assign(jpg, jpg + len);
+      free(jpg);
+      break;
+    }
+    case PIXFORMAT_RGB888:
+      f->data.assign(bgr, bgr + (size_t)w * h * 3);
+      break;
+    case PIXFORMAT_GRAYSCALE:
+      f->data.resize((size_t)w * h);
+      for (size_t i = 0; i < f->data.size(); i++) {
+        const uint8_t *p = &bgr[i * 3];
+        f->data[i] = (uint8_t)((p[0] * 29 + p[1] * 150 + p[2] * 77) >> 8);
+      }
+      break;
+    case PIXFORMAT_RGB565:
+      f->data.resize((size_t)w * h * 2);
+      for (size_t i = 0; i < (size_t)w * h; i++) {
+        const uint8_t *p = &bgr[i * 3];
+        uint16_t c = (uint16_t)((p[2] & 0xF8) << 8 | (p[1] & 0xFC) << 3 | p[0] >> 3);
+        f->data[i * 2] = (uint8_t)(c >> 8);
+        f->data[i * 2 + 1] = (uint8_t)c;
+      }
+      break;
+    case PIXFORMAT_YUV422:
+      f->data.resize((size_t)w * h * 2);
+      for (size_t i = 0; i + 1 < (size_t)w * h; i += 2) {
+        uint8_t y0, y1, u, v;
+        to_yuv(&bgr[i * 3], &y0, &u, &v);
+        to_yuv(&bgr[i * 3 + 3], &y1, NULL, NULL);
+        f->data[i * 2] = y0;
+        f->data[i * 2 + 1] = u;
+        f->data[i * 2 + 2] = y1;
+        f->data[i * 2 + 3] = v;
+      }
+      break;
+    default:
+      return false;
+  }
+  return true;
+}
+
+// ---------- Pola sintetis ----------
+// Gradien bergeser + balok yang memantul; cukup detail supaya ukuran JPEG
+// dan waktu encode mirip gambar kamera sungguhan.
+class PatternSource : public Source {
+ public:
+  bool next(const sensor_t *s, Frame *f) override {
+    double fps = sim_env_double("SIM_CAMERA_FPS", 25);
+    int64_t period = (int64_t)(1e6 / (fps > 0 ? fps : 25));
+    int64_t now = esp_timer_get_time();
+    if (due_ == 0 || now - due_ > period) {
+      due_ = now;
+    }
+    sim_sleep_us(due_ - now);
+    f->timestamp_us = esp_timer_get_time();
+    due_ += period;
+
+    framesize_t fs = s->status.framesize < FRAMESIZE_INVALID ? s->status.framesize : FRAMESIZE_QVGA;
+    int w = resolution[fs].width, h = resolution[fs].height;
+    render(w, h, s);
+    if (!encode_bgr(bgr_.data(), w, h, s->pixformat, s->status.quality, f)) {
+      return false;
+    }
+    n_++;
+    return true;
+  }
+
+ private:
+  void render(int w, int h, const sensor_t *s) {
+    bgr_.resize((size_t)w * h * 3);
+    int shift = (int)(n_ * 3);
+    int bs = h / 4 > 8 ? h / 4 : 8;
+    int span_x = w - bs > 1 ? w - bs : 1, span_y = h - bs > 1 ? h - bs : 1;
+    int bx = (int)(n_ * 5 % (2 * span_x)), by = (int)(n_ * 3 % (2 * span_y));
+    bx = bx < span_x ? bx : 2 * span_x - bx;
+    by = by < span_y ? by : 2 * span_y - by;
+    int bright = s->status.brightness * 16;
+    for (int y = 0; y < h; y++) {
+      int sy = s->status.vflip ? h - 1 - y : y;
+      uint8_t *row = &bgr_[(size_t)y * w * 3];
+      for (int x = 0; x < w; x++) {
+        int sx = s->status.hmirror ? w - 1 - x : x;
+        int r, g, b;
+        if (s->status.colorbar) {
+          static const uint8_t bars[8][3] = {{255, 255, 255}, {0, 255, 255}, {255, 255, 0}, {0, 255, 0}, {255, 0, 255}, {0, 0, 255}, {255, 0, 0}, {0, 0, 0}};
+          const uint8_t *c = bars[sx * 8 / w];
+          b = c[0], g = c[1], r = c[2];
+        } else if (sx >= bx && sx < bx + bs && sy >= by && sy < by + bs) {
+          r = 230, g = 60, b = 40;
+        } else {
+          r = (sx * 255 / w + shift) & 0xFF;
+          g = (sy * 255 / h) & 0xFF;
+          b = ((sx ^ sy) & 0x10) ? 200 : 90;
+        }
+        r += bright, g += bright, b += bright;
+        row[x * 3] = (uint8_t)(b < 0 ? 0 : b > 255 ? 255 : b);
+        row[x * 3 + 1] = (uint8_t)(g < 0 ? 0 : g > 255 ? 255 : g);
+        row[x * 3 + 2] = (uint8_t)(r < 0 ? 0 : r > 255 ? 255 : r);
+      }
+    }
+  }
+
+  std::vector<uint8_t> bgr_;
+  uint64_t n_ = 0;
+  int64_t due_ = 0;
+};
+
+}  // namespace sim_cam
+
+// ---------- Driver ----------
+namespace {
+
+enum SlotState { SLOT_FREE, SLOT_READY, SLOT_HELD };
+
+struct Slot {
+  camera_fb_t fb;
+  std::vector<uint8_t> buf;
+  SlotState state = SLOT_FREE;
+  uint64_t seq = 0;
+};
+
+struct Camera {
+  camera_config_t cfg;
+  sensor_t sensor;
+  std::map<int, int> regs;
+  std::vector<Slot> slots;
+  std::unique_ptr<sim_cam::Source> source;
+  std::mutex mu;
+  std::condition_variable cv;
+  std::thread thread;
+  bool stop = false;
+  uint64_t seq = 0;
+  uint32_t dropped = 0;
+};
+
+Camera *_cam = NULL;
+std::unique_ptr<sim_cam::Source> _pending_source;
+
+Camera *cam_of(sensor_t *s) {
+  (void)s;
+  return _cam;
+}
+
+// ---------- sensor_t ----------
+#define SET_STATUS(name, field)                 \
+  int name(sensor_t *s, int v) {                \
+    std::lock_guard<std::mutex> lock(cam_of(s)->mu); \
+    s->status.field = v;                        \
+    return 0;                                   \
+  }
+
+SET_STATUS(set_contrast, contrast)
+SET_STATUS(set_brightness, brightness)
+SET_STATUS(set_saturation, saturation)
+SET_STATUS(set_sharpness, sharpness)
+SET_STATUS(set_denoise, denoise)
+SET_STATUS(set_colorbar, colorbar)
+SET_STATUS(set_whitebal, awb)
+SET_STATUS(set_gain_ctrl, agc)
+SET_STATUS(set_exposure_ctrl, aec)
+SET_STATUS(set_hmirror, hmirror)
+SET_STATUS(set_vflip, vflip)
+SET_STATUS(set_aec2, aec2)
+SET_STATUS(set_awb_gain, awb_gain)
+SET_STATUS(set_agc_gain, agc_gain)
+SET_STATUS(set_aec_value, aec_value)
+SET_STATUS(set_special_effect, special_effect)
+SET_STATUS(set_wb_mode, wb_mode)
+SET_STATUS(set_ae_level, ae_level)
+SET_STATUS(set_dcw, dcw)
+SET_STATUS(set_bpc, bpc)
+SET_STATUS(set_wpc, wpc)
+SET_STATUS(set_raw_gma, raw_gma)
+SET_STATUS(set_lenc, lenc)
+
+int set_quality(sensor_t *s, int q) {
+  if (q < 0 || q > 63) {
+    return -1;
+  }
+  std::lock_guard<std::mutex> lock(cam_of(s)->mu);
+  s->status.quality = (uint8_t)q;
+  return 0;
+}
+
+int set_gainceiling(sensor_t *s, gainceiling_t g) {
+  std::lock_guard<std::mutex> lock(cam_of(s)->mu);
+  s->status.gainceiling = (uint8_t)g;
+  return 0;
+}
+
+int set_framesize(sensor_t *s, framesize_t fs) {
+  if (fs < 0 || fs >= FRAMESIZE_INVALID) {
+    return -1;
+  }
+  std::lock_guard<std::mutex> lock(cam_of(s)->mu);
+  s->status.framesize = fs;
+  return 0;
+}
+
+bool pixformat_ok(pixformat_t pf) {
+  switch (pf) {
+    case PIXFORMAT_JPEG:
+    case PIXFORMAT_RGB565:
+    case PIXFORMAT_YUV422:
+    case PIXFORMAT_GRAYSCALE:
+    case PIXFORMAT_RGB888:
+      return true;
+    default:
+      return false;
+  }
+}
+
+int set_pixformat(sensor_t *s, pixformat_t pf) {
+  if (!pixformat_ok(pf)) {
+    return -1;
+  }
+  std::lock_guard<std::mutex> lock(cam_of(s)->mu);
+  s->pixformat = pf;
+  return 0;
+}
+
+int init_status(sensor_t *s) {
+  (void)s;
+  return 0;
+}
+
+int reset(sensor_t *s) {
+  std::lock_guard<std::mutex> lock(cam_of(s)->mu);
+  cam_of(s)->regs.clear();
+  return 0;
+}
+
+int get_reg(sensor_t *s, int reg, int mask) {
+  std::lock_guard<std::mutex> lock(cam_of(s)->mu);
+  auto it = cam_of(s)->regs.find(reg);
+  return (it == cam_of(s)->regs.end() ? 0 : it->second) & mask;
+}
+
+int set_reg(sensor_t *s, int reg, int mask, int value) {
+  std::lock_guard<std::mutex> lock(cam_of(s)->mu);
+  int &r = cam_of(s)->regs[reg];
+  r = (r & ~mask) | (value & mask);
+  return 0;
+}
+
+int set_res_raw(sensor_t *s, int, int, int, int, int, int, int, int, int, int, bool scale, bool binning) {
+  std::lock_guard<std::mutex> lock(cam_of(s)->mu);
+  s->status.scale = scale;
+  s->status.binning = binning;
+  return 0;
+}
+
+int set_pll(sensor_t *, int, int, int, int, int, int, int, int) {
+  return 0;
+}
+
+int set_xclk(sensor_t *s, int timer, int xclk) {
+  (void)timer;
+  s->xclk_freq_hz = xclk * 1000000;
+  return 0;
+}
+
+void init_sensor(sensor_t *s, const camera_config_t *cfg) {
+  memset(s, 0, sizeof(*s));
+  s->id.PID = (uint16_t)sim_env_int("SIM_CAMERA_PID", OV3660_PID);
+  s->id.MIDH = 0x7F;
+  s->id.MIDL = 0xA2;
+  s->slv_addr = 0x3C;
+  s->pixformat = cfg->pixel_format;
+  s->xclk_freq_hz = cfg->xclk_freq_hz;
+  s->status.framesize = cfg->frame_size;
+  s->status.quality = (uint8_t)cfg->jpeg_quality;
+  s->status.awb = s->status.awb_gain = s->status.aec = s->status.agc = 1;
+  s->status.bpc = s->status.wpc = s->status.raw_gma = s->status.lenc = s->status.dcw = 1;
+  s->init_status = init_status;
+  s->reset = reset;
+  s->set_pixformat = set_pixformat;
+  s->set_framesize = set_framesize;
+  s->set_contrast = set_contrast;
+  s->set_brightness = set_brightness;
+  s->set_saturation = set_saturation;
+  s->set_sharpness = set_sharpness;
+  s->set_denoise = set_denoise;
+  s->set_gainceiling = set_gainceiling;
+  s->set_quality = set_quality;
+  s->set_colorbar = set_colorbar;
+  s->set_whitebal = set_whitebal;
+  s->set_gain_ctrl = set_gain_ctrl;
+  s->set_exposure_ctrl = set_exposure_ctrl;
+  s->set_hmirror = set_hmirror;
+  s->set_vflip = set_vflip;
+  s->set_aec2 = set_aec2;
+  s->set_awb_gain = set_awb_gain;
+  s->set_agc_gain = set_agc_gain;
+  s->set_aec_value = set_aec_value;
+  s->set_special_effect = set_special_effect;
+  s->set_wb_mode = set_wb_mode;
+  s->set_ae_level = set_ae_level;
+  s->set_dcw = set_dcw;
+  s->set_bpc = set_bpc;
+  s->set_wpc = set_wpc;
+  s->set_raw_gma = set_raw_gma;
+  s->set_lenc = set_lenc;
+  s->get_reg = get_reg;
+  s->set_reg = set_reg;
+  s->set_res_raw = set_res_raw;
+  s->set_pll = set_pll;
+  s->set_xclk = set_xclk;
+}
+
+// ---------- Capture ----------
+void capture_loop(Camera *c) {
+  sim_cam::Frame f;
+  for (;;) {
+    sensor_t snap;
+    {
+      std::lock_guard<std::mutex> lock(c->mu);
+      if (c->stop) {
+        return;
+      }
+      snap = c->sensor;
+    }
+    if (!c->source->next(&snap, &f)) {
+      log_w("camera source ended");
+      return;
+    }
+    std::unique_lock<std::mutex> lock(c->mu);
+    if (c->source->lossless()) {
+      // satu frame READY sekaligus: LATEST tidak sempat membuang yang lain
+      c->cv.wait(lock, [c] {
+        bool free_slot = false;
+        for (const Slot &s : c->slots) {
+          if (s.state == SLOT_READY) {
+            return c->stop;
+          }
+          free_slot |= s.state == SLOT_FREE;
+        }
+        return free_slot || c->stop;
+      });
+    }
+    if (c->stop) {
+      return;
+    }
+    Slot *dst = NULL;
+    for (Slot &s : c->slots) {
+      if (s.state == SLOT_FREE && (!dst || dst->state != SLOT_FREE)) {
+        dst = &s;
+      }
+    }
+    if (!dst && c->cfg.grab_mode == CAMERA_GRAB_LATEST) {
+      for (Slot &s : c->slots) {
+        if (s.state == SLOT_READY && (!dst || s.seq < dst->seq)) {
+          dst = &s;
+        }
+      }
+    }
+    if (!dst) {
+      c->dropped++;
+      continue;
+    }
+    dst->buf.swap(f.data);
+    dst->fb.buf = dst->buf.data();
+    dst->fb.len = dst->buf.size();
+    dst->fb.width = f.width;
+    dst->fb.height = f.height;
+    dst->fb.format = f.format;
+    dst->fb.timestamp.tv_sec = f.timestamp_us / 1000000;
+    dst->fb.timestamp.tv_usec = f.timestamp_us % 1000000;
+    dst->state = SLOT_READY;
+    dst->seq = ++c->seq;
+    c->cv.notify_all();
+  }
+}
+
+}  // namespace
+
+void sim_cam::set_source(Source *src) {
+  _pending_source.reset(src);
+}
+
+extern "C" esp_err_t esp_camera_init(const camera_config_t *config) {
+  if (_cam) {
+    return ESP_ERR_INVALID_STATE;
+  }
+  if (config->frame_size < 0 || config->frame_size >= FRAMESIZE_INVALID) {
+    return ESP_ERR_CAMERA_FAILED_TO_SET_FRAME_SIZE;
+  }
+  Camera *c = new Camera;
+  c->cfg = *config;
+  if (c->cfg.fb_count < 1) {
+    c->cfg.fb_count = 1;
+  }
+  if (c->cfg.pixel_format == PIXFORMAT_JPEG && c->cfg.fb_count > 1 && c->cfg.grab_mode != CAMERA_GRAB_LATEST) {
+    log_i("fb_count > 1 dengan GRAB_WHEN_EMPTY: frame bisa basi");
+  }
+  if (!pixformat_ok(c->cfg.pixel_format)) {
+    delete c;
+    return ESP_ERR_CAMERA_FAILED_TO_SET_OUT_FORMAT;
+  }
+  init_sensor(&c->sensor, &c->cfg);
+  c->slots.resize(c->cfg.fb_count);
+  if (!_pending_source) {
+    _pending_source.reset(sim_cam::replay_from_env());
+  }
+  c->source = _pending_source ? std::move(_pending_source) : std::unique_ptr<sim_cam::Source>(new sim_cam::PatternSource);
+  _cam = c;
+  c->thread = std::thread(capture_loop, c);
+  log_i("camera sim: PID 0x%x, %ux%u, fb_count %u, %s", c->sensor.id.PID, resolution[c->cfg.frame_size].width,
+        resolution[c->cfg.frame_size].height, (unsigned)c->cfg.fb_count,
+        c->cfg.grab_mode == CAMERA_GRAB_LATEST ? "LATEST" : "WHEN_EMPTY");
+  return ESP_OK;
+}
+
+extern "C" esp_err_t esp_camera_deinit(void) {
+  Camera *c = _cam;
+  if (!c) {
+    return ESP_ERR_INVALID_STATE;
+  }
+  {
+    std::lock_guard<std::mutex> lock(c->mu);
+    c->stop = true;
+    c->cv.notify_all();
+  }
+  c->thread.join();
+  _cam = NULL;
+  delete c;
+  return ESP_OK;
+}
+
+extern "C" camera_fb_t *esp_camera_fb_get(void) {
+  Camera *c = _cam;
+  if (!c) {
+    return NULL;
+  }
+  std::unique_lock<std::mutex> lock(c->mu);
+  Slot *pick = NULL;
+  bool ok = c->cv.wait_for(lock, std::chrono::microseconds(CAM_FB_GET_TIMEOUT_US), [&] {
+    pick = NULL;
+    for (Slot &s : c->slots) {
+      if (s.state != SLOT_READY) {
+        continue;
+      }
+      bool better = c->cfg.grab_mode == CAMERA_GRAB_LATEST ? (!pick || s.seq > pick->seq) : (!pick || s.seq < pick->seq);
+      if (better) {
+        pick = &s;
+      }
+    }
+    return pick != NULL || c->stop;
+  });
+  if (!ok || !pick) {
+    log_w("Failed to get the frame on time!");
+    return NULL;
+  }
+  if (c->cfg.grab_mode == CAMERA_GRAB_LATEST) {
+    for (Slot &s : c->slots) {
+      if (s.state == SLOT_READY && &s != pick) {
+        s.state = SLOT_FREE;
+      }
+    }
+  }
+  pick->state = SLOT_HELD;
+  c->cv.notify_all();  // capture lossless menunggu tidak ada slot READY
+  return &pick->fb;
+}
+
+extern "C" void esp_camera_fb_return(camera_fb_t *fb) {
+  Camera *c = _cam;
+  if (!c || !fb) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(c->mu);
+  for (Slot &s : c->slots) {
+    if (&s.fb == fb) {
+      s.state = SLOT_FREE;
+      c->cv.notify_all();
+      return;
+    }
+  }
+  log_e("fb_return: buffer bukan milik kamera");
+}
+
+extern "C" void esp_camera_return_all(void) {
+  Camera *c = _cam;
+  if (!c) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(c->mu);
+  for (Slot &s : c->slots) {
+    s.state = SLOT_FREE;
+  }
+  c->cv.notify_all();
+}
+
+extern "C" sensor_t *esp_camera_sensor_get(void) {
+  return _cam ? &_cam->sensor : NULL;
+}
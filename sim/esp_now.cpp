@@ -0,0 +1,452 @@
+// Stand-in ESP-NOW untuk simulator host (lihat esp_now.h untuk transport).
+//
+// Thread RX (pengganti MAC hardware) menerima datagram, menyaring MAC dan
+// channel, langsung meng-ACK unicast lalu menaruh frame di antrean RX
+// (ESPNOW_RX_QUEUE_LEN, seperti buffer RX WiFi); thread callback (pengganti
+// task WiFi) memanggil recv cb dari antrean itu. Jadi recv cb yang lama
+// (mis. memutar alarm) tidak membuat pengirim kehilangan ACK, tapi frame
+// yang datang saat antrean penuh dibuang tanpa ACK. Thread TX mengirim
+// antrean frame satu per satu dengan jeda airtime 1 Mbps lalu memanggil
+// send cb, jadi kedua callback jalan di luar task pemanggil seperti di board.
+#include <dirent.h>
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "esp32-hal-log.h"
+#include "esp_mac.h"
+#include "esp_now.h"
+#include "esp_timer.h"
+#include "sim.h"
+
+#define ESPNOW_ACK_TIMEOUT_US 30000
+#define ESPNOW_TX_QUEUE_LEN 32
+#define ESPNOW_RX_QUEUE_LEN 32
+#define ESPNOW_MAGIC 0x574F4E45  // "ENOW"
+
+enum { PKT_DATA = 1, PKT_ACK = 2 };
+
+struct __attribute__((packed)) espnow_pkt {
+  uint32_t magic;
+  uint8_t type;
+  uint8_t channel;
+  uint8_t src[6];
+  uint8_t dst[6];
+  uint32_t seq;
+  uint16_t len;
+  uint8_t data[ESP_NOW_MAX_DATA_LEN];
+};
+
+namespace {
+
+struct TxFrame {
+  uint8_t dst[6];
+  std::vector<uint8_t> data;
+};
+
+struct EspNow {
+  int fd = -1;
+  std::string dir;
+  std::string path;
+  uint8_t mac[6];
+  esp_now_recv_cb_t recv_cb = NULL;
+  esp_now_send_cb_t send_cb = NULL;
+  std::vector<esp_now_peer_info_t> peers;
+  std::deque<TxFrame> txq;
+  std::deque<espnow_pkt> rxq;
+  std::condition_variable rx_cv;
+  std::mutex mu;
+  std::condition_variable cv;
+  uint32_t seq = 0;
+  uint32_t acked = 0;  // seq ACK terakhir
+  bool stop = false;
+  std::thread rx;
+  std::thread cb;
+  std::thread tx;
+};
+
+EspNow *_now = NULL;
+const uint8_t kBroadcast[6] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+
+uint8_t channel_now() {
+  uint8_t ch = 0;
+  esp_wifi_get_channel(&ch, NULL);
+  return ch;
+}
+
+[[maybe_unused]] std::string mac_str(const uint8_t *m) {
+  char b[18];
+  snprintf(b, sizeof(b), "%02X:%02X:%02X:%02X:%02X:%02X", m[0], m[1], m[2], m[3], m[4], m[5]);
+  return b;
+}
+
+bool send_to(EspNow *n, const char *path, const espnow_pkt &p) {
+  struct sockaddr_un to;
+  memset(&to, 0, sizeof(to));
+  to.sun_family = AF_UNIX;
+  snprintf(to.sun_path, sizeof(to.sun_path), "%s", path);
+  size_t len = offsetof(espnow_pkt, data) + p.len;
+  if (sendto(n->fd, &p, len, MSG_DONTWAIT, (struct sockaddr *)&to, sizeof(to)) == (ssize_t)len) {
+    return true;
+  }
+  if (errno == ECONNREFUSED) {
+    unlink(path);  // sisa proses yang sudah mati
+  }
+  return false;
+}
+
+// "Udara": kirim ke semua radio lain di direktori.
+void air_send(EspNow *n, const espnow_pkt &p) {
+  DIR *d = opendir(n->dir.c_str());
+  if (!d) {
+    return;
+  }
+  struct dirent *e;
+  while ((e = readdir(d)) != NULL) {
+    size_t l = strlen(e->d_name);
+    if (l < 5 || strcmp(e->d_name + l - 5, ".sock") != 0) {
+      continue;
+    }
+    std::string path = n->dir + "/" + e->d_name;
+    if (path != n->path) {
+      send_to(n, path.c_str(), p);
+    }
+  }
+  closedir(d);
+}
+
+bool peer_find(EspNow *n, const uint8_t *mac, esp_now_peer_info_t *out) {
+  for (const esp_now_peer_info_t &p : n->peers) {
+    if (memcmp(p.peer_addr, mac, 6) == 0) {
+      if (out) {
+        *out = p;
+      }
+      return true;
+    }
+  }
+  return false;
+}
+
+void rx_loop(EspNow *n) {
+  espnow_pkt p;
+  struct sockaddr_un from;
+  for (;;) {
+    socklen_t flen = sizeof(from);
+    ssize_t got = recvfrom(n->fd, &p, sizeof(p), 0, (struct sockaddr *)&from, &flen);
+    if (got < 0) {
+      if (errno == EINTR || errno == EAGAIN) {
+        std::lock_guard<std::mutex> lock(n->mu);
+        if (n->stop) {
+          return;
+        }
+        continue;
+      }
+      return;
+    }
+    if ((size_t)got < offsetof(espnow_pkt, data) || p.magic != ESPNOW_MAGIC || p.len > ESP_NOW_MAX_DATA_LEN ||
+        (size_t)got < offsetof(espnow_pkt, data) + p.len) {
+      continue;
+    }
+    if (p.channel != channel_now()) {
+      continue;  // radio di channel lain tidak mendengar
+    }
+    bool to_me = memcmp(p.dst, n->mac, 6) == 0;
+    if (p.type == PKT_ACK) {
+      if (to_me) {
+        std::lock_guard<std::mutex> lock(n->mu);
+        n->acked = p.seq;
+        n->cv.notify_all();
+      }
+      continue;
+    }
+    if (!to_me && memcmp(p.dst, kBroadcast, 6) != 0) {
+      continue;
+    }
+    {
+      std::lock_guard<std::mutex> lock(n->mu);
+      if (n->rxq.size() >= ESPNOW_RX_QUEUE_LEN) {
+        continue;  // buffer RX penuh: tidak diterima, tidak di-ACK
+      }
+      n->rxq.push_back(p);
+      n->rx_cv.notify_all();
+    }
+    if (to_me && flen > offsetof(struct sockaddr_un, sun_path)) {
+      espnow_pkt ack = p;
+      ack.type = PKT_ACK;
+      memcpy(ack.src, n->mac, 6);
+      memcpy(ack.dst, p.src, 6);
+      ack.len = 0;
+      send_to(n, from.sun_path, ack);
+    }
+  }
+}
+
+void cb_loop(EspNow *n) {
+  std::unique_lock<std::mutex> lock(n->mu);
+  for (;;) {
+    n->rx_cv.wait(lock, [n] { return n->stop || !n->rxq.empty(); });
+    if (n->stop) {
+      return;
+    }
+    espnow_pkt p = n->rxq.front();
+    n->rxq.pop_front();
+    esp_now_recv_cb_t cb = n->recv_cb;
+    lock.unlock();
+    if (cb) {
+      wifi_pkt_rx_ctrl_t ctrl;
+      memset(&ctrl, 0, sizeof(ctrl));
+      ctrl.rssi = (int)sim_env_int("SIM_RSSI", -55);
+      ctrl.channel = p.channel;
+      ctrl.sig_len = p.len;
+      ctrl.timestamp = (uint32_t)esp_timer_get_time();
+      esp_now_recv_info_t info = {p.src, p.dst, &ctrl};
+      cb(&info, p.data, p.len);
+    }
+    lock.lock();
+  }
+}
+
+void tx_loop(EspNow *n) {
+  std::unique_lock<std::mutex> lock(n->mu);
+  for (;;) {
+    n->cv.wait(lock, [n] { return n->stop || !n->txq.empty(); });
+    if (n->stop) {
+      return;
+    }
+    TxFrame f = std::move(n->txq.front());
+    n->txq.pop_front();
+    espnow_pkt p;
+    p.magic = ESPNOW_MAGIC;
+    p.type = PKT_DATA;
+    p.channel = channel_now();
+    memcpy(p.src, n->mac, 6);
+    memcpy(p.dst, f.dst, 6);
+    p.seq = ++n->seq;
+    p.len = (uint16_t)f.data.size();
+    memcpy(p.data, f.data.data(), f.data.size());
+    bool unicast = memcmp(f.dst, kBroadcast, 6) != 0;
+    lock.unlock();
+
+    // airtime 1 Mbps: preamble + header MAC/vendor + payload
+    sim_sleep_us(192 + (int64_t)(43 + p.len) * 8);
+    air_send(n, p);
+
+    lock.lock();
+    bool ok = true;
+    if (unicast) {
+      ok = n->cv.wait_for(lock, std::chrono::microseconds(ESPNOW_ACK_TIMEOUT_US), [n, &p] { return n->stop || n->acked == p.seq; });
+      ok = ok && n->acked == p.seq;
+    }
+    esp_now_send_cb_t cb = n->send_cb;
+    lock.unlock();
+    if (sim_verbose()) {
+      log_i("esp_now: %u bytes -> %s %s", p.len, mac_str(p.dst).c_str(), ok ? "OK" : "no ACK");
+    }
+    if (cb) {
+      wifi_tx_info_t info;
+      memset(&info, 0, sizeof(info));
+      info.des_addr = p.dst;
+      info.src_addr = p.src;
+      info.ifidx = WIFI_IF_STA;
+      info.data = p.data;
+      info.data_len = (uint8_t)p.len;
+      info.rate = WIFI_PHY_RATE_1M_L;
+      cb(&info, ok ? ESP_NOW_SEND_SUCCESS : ESP_NOW_SEND_FAIL);
+    }
+    lock.lock();
+  }
+}
+
+}  // namespace
+
+extern "C" esp_err_t esp_now_init(void) {
+  if (_now) {
+    return ESP_OK;
+  }
+  EspNow *n = new EspNow;
+  n->dir = sim_env("SIM_ESPNOW_DIR", "/tmp/sim_espnow");
+  mkdir(n->dir.c_str(), 0777);
+  esp_read_mac(n->mac, ESP_MAC_WIFI_STA);
+  char name[64];
+  snprintf(name, sizeof(name), "/%02x%02x%02x%02x%02x%02x-%d.sock", n->mac[0], n->mac[1], n->mac[2], n->mac[3], n->mac[4], n->mac[5], (int)getpid());
+  n->path = n->dir + name;
+  n->fd = socket(AF_UNIX, SOCK_DGRAM, 0);
+  struct sockaddr_un addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  snprintf(addr.sun_path, sizeof(addr.sun_path), "%s", n->path.c_str());
+  unlink(n->path.c_str());
+  if (n->fd < 0 || bind(n->fd, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+    log_e("esp_now: bind %s failed: %s", n->path.c_str(), strerror(errno));
+    if (n->fd >= 0) {
+      close(n->fd);
+    }
+    delete n;
+    return ESP_ERR_ESPNOW_INTERNAL;
+  }
+  // supaya rx_loop bisa melihat stop
+  struct timeval tv = {0, 200000};
+  setsockopt(n->fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+  _now = n;
+  n->rx = std::thread(rx_loop, n);
+  n->cb = std::thread(cb_loop, n);
+  n->tx = std::thread(tx_loop, n);
+  log_i("esp_now: radio %s on channel %u (%s)", mac_str(n->mac).c_str(), channel_now(), n->path.c_str());
+  return ESP_OK;
+}
+
+extern "C" esp_err_t esp_now_deinit(void) {
+  EspNow *n = _now;
+  if (!n) {
+    return ESP_ERR_ESPNOW_NOT_INIT;
+  }
+  {
+    std::lock_guard<std::mutex> lock(n->mu);
+    n->stop = true;
+    n->cv.notify_all();
+    n->rx_cv.notify_all();
+  }
+  n->tx.join();
+  n->cb.join();
+  n->rx.join();
+  close(n->fd);
+  unlink(n->path.c_str());
+  _now = NULL;
+  delete n;
+  return ESP_OK;
+}
+
+extern "C" esp_err_t esp_now_register_recv_cb(esp_now_recv_cb_t cb) {
+  if (!_now) {
+    return ESP_ERR_ESPNOW_NOT_INIT;
+  }
+  std::lock_guard<std::mutex> lock(_now->mu);
+  _now->recv_cb = cb;
+  return ESP_OK;
+}
+
+extern "C" esp_err_t esp_now_unregister_recv_cb(void) {
+  return esp_now_register_recv_cb(NULL);
+}
+
+extern "C" esp_err_t esp_now_register_send_cb(esp_now_send_cb_t cb) {
+  if (!_now) {
+    return ESP_ERR_ESPNOW_NOT_INIT;
+  }
+  std::lock_guard<std::mutex> lock(_now->mu);
+  _now->send_cb = cb;
+  return ESP_OK;
+}
+
+extern "C" esp_err_t esp_now_unregister_send_cb(void) {
+  return esp_now_register_send_cb(NULL);
+}
+
+extern "C" esp_err_t esp_now_send(const uint8_t *peer_addr, const uint8_t *data, size_t len) {
+  EspNow *n = _now;
+  if (!n) {
+    return ESP_ERR_ESPNOW_NOT_INIT;
+  }
+  if (!data || len == 0 || len > ESP_NOW_MAX_DATA_LEN) {
+    return ESP_ERR_ESPNOW_ARG;
+  }
+  std::lock_guard<std::mutex> lock(n->mu);
+  std::vector<const uint8_t *> dsts;
+  if (peer_addr) {
+    esp_now_peer_info_t peer;
+    if (!peer_find(n, peer_addr, &peer)) {
+      return ESP_ERR_ESPNOW_NOT_FOUND;
+    }
+    if (peer.channel != 0 && peer.channel != channel_now()) {
+      return ESP_ERR_ESPNOW_CHAN;
+    }
+    dsts.push_back(peer_addr);
+  } else {
+    // NULL: semua peer unicast
+    for (const esp_now_peer_info_t &p : n->peers) {
+      if (memcmp(p.peer_addr, kBroadcast, 6) != 0) {
+        dsts.push_back(p.peer_addr);
+      }
+    }
+  }
+  if (n->txq.size() + dsts.size() > ESPNOW_TX_QUEUE_LEN) {
+    return ESP_ERR_ESPNOW_NO_MEM;
+  }
+  for (const uint8_t *d : dsts) {
+    TxFrame f;
+    memcpy(f.dst, d, 6);
+    f.data.assign(data, data + len);
+    n->txq.push_back(std::move(f));
+  }
+  n->cv.notify_all();
+  return ESP_OK;
+}
+
+extern "C" esp_err_t esp_now_add_peer(const esp_now_peer_info_t *peer) {
+  EspNow *n = _now;
+  if (!n) {
+    return ESP_ERR_ESPNOW_NOT_INIT;
+  }
+  if (!peer || peer->channel > 14) {
+    return ESP_ERR_ESPNOW_ARG;
+  }
+  std::lock_guard<std::mutex> lock(n->mu);
+  if (peer_find(n, peer->peer_addr, NULL)) {
+    return ESP_ERR_ESPNOW_EXIST;
+  }
+  if (n->peers.size() >= ESP_NOW_MAX_TOTAL_PEER_NUM) {
+    return ESP_ERR_ESPNOW_FULL;
+  }
+  n->peers.push_back(*peer);
+  return ESP_OK;
+}
+
+extern "C" esp_err_t esp_now_del_peer(const uint8_t *peer_addr) {
+  EspNow *n = _now;
+  if (!n) {
+    return ESP_ERR_ESPNOW_NOT_INIT;
+  }
+  std::lock_guard<std::mutex> lock(n->mu);
+  for (size_t i = 0; i < n->peers.size(); i++) {
+    if (memcmp(n->peers[i].peer_addr, peer_addr, 6) == 0) {
+      n->peers.erase(n->peers.begin() + i);
+      return ESP_OK;
+    }
+  }
+  return ESP_ERR_ESPNOW_NOT_FOUND;
+}
+
+extern "C" esp_err_t esp_now_mod_peer(const esp_now_peer_info_t *peer) {
+  EspNow *n = _now;
+  if (!n) {
+    return ESP_ERR_ESPNOW_NOT_INIT;
+  }
+  std::lock_guard<std::mutex> lock(n->mu);
+  for (esp_now_peer_info_t &p : n->peers) {
+    if (memcmp(p.peer_addr, peer->peer_addr, 6) == 0) {
+      p = *peer;
+      return ESP_OK;
+    }
+  }
+  return ESP_ERR_ESPNOW_NOT_FOUND;
+}
+
+extern "C" bool esp_now_is_peer_exist(const uint8_t *peer_addr) {
+  EspNow *n = _now;
+  if (!n) {
+    return false;
+  }
+  std::lock_guard<std::mutex> lock(n->mu);
+  return peer_find(n, peer_addr, NULL);
+}
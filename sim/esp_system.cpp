@@ -0,0 +1,700 @@
+// Layanan sistem ESP-IDF untuk simulator host: esp_timer, esp_random,
+// heap_caps, NVS + Preferences, WiFi/esp_wifi dan MAC.
+#include <arpa/inet.h>
+#include <malloc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <map>
+#include <mutex>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Arduino.h"
+#include "Preferences.h"
+#include "WiFi.h"
+#include "esp_mac.h"
+#include "esp_wifi.h"
+#include "nvs.h"
+#include "sim.h"
+
+// ---------- esp_timer ----------
+static int64_t mono_us() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+// Nol saat proses mulai, seperti esp_timer sejak boot.
+static const int64_t _boot_us = mono_us();
+
+extern "C" int64_t esp_timer_get_time(void) {
+  return mono_us() - _boot_us;
+}
+
+// ---------- esp_random ----------
+// SIM_SEED membuat urutan acak bisa diulang (replay, load test).
+static std::mutex _rng_mu;
+static std::mt19937 &rng() {
+  static std::mt19937 r((uint32_t)sim_env_int("SIM_SEED", (long)std::random_device()()));
+  return r;
+}
+
+extern "C" uint32_t esp_random(void) {
+  std::lock_guard<std::mutex> lock(_rng_mu);
+  return rng()();
+}
+
+extern "C" void esp_fill_random(void *buf, size_t len) {
+  uint8_t *p = (uint8_t *)buf;
+  while (len > 0) {
+    uint32_t r = esp_random();
+    size_t n = len < 4 ? len : 4;
+    memcpy(p, &r, n);
+    p += n;
+    len -= n;
+  }
+}
+
+extern "C" const char *esp_err_to_name(esp_err_t code) {
+  switch (code) {
+    case ESP_OK: return "ESP_OK";
+    case ESP_FAIL: return "ESP_FAIL";
+    case ESP_ERR_NO_MEM: return "ESP_ERR_NO_MEM";
+    case ESP_ERR_INVALID_ARG: return "ESP_ERR_INVALID_ARG";
+    case ESP_ERR_INVALID_STATE: return "ESP_ERR_INVALID_STATE";
+    case ESP_ERR_INVALID_SIZE: return "ESP_ERR_INVALID_SIZE";
+    case ESP_ERR_NOT_FOUND: return "ESP_ERR_NOT_FOUND";
+    case ESP_ERR_NOT_SUPPORTED: return "ESP_ERR_NOT_SUPPORTED";
+    case ESP_ERR_TIMEOUT: return "ESP_ERR_TIMEOUT";
+    case ESP_ERR_NVS_NOT_FOUND: return "ESP_ERR_NVS_NOT_FOUND";
+    default: return "UNKNOWN ERROR";
+  }
+}
+
+// ---------- heap_caps ----------
+static size_t _min_free = SIZE_MAX;
+
+static size_t heap_used() {
+  struct mallinfo2 mi = mallinfo2();
+  return mi.uordblks + mi.hblkhd;
+}
+
+extern "C" void *heap_caps_malloc(size_t size, uint32_t caps) {
+  (void)caps;
+  return malloc(size);
+}
+
+extern "C" void *heap_caps_calloc(size_t n, size_t size, uint32_t caps) {
+  (void)caps;
+  return calloc(n, size);
+}
+
+extern "C" void *heap_caps_realloc(void *ptr, size_t size, uint32_t caps) {
+  (void)caps;
+  return realloc(ptr, size);
+}
+
+extern "C" void heap_caps_free(void *ptr) {
+  free(ptr);
+}
+
+extern "C" size_t heap_caps_get_free_size(uint32_t caps) {
+  if (caps & MALLOC_CAP_INTERNAL) {
+    return (size_t)sim_env_int("SIM_INTERNAL_FREE", 200 << 10);
+  }
+  size_t total = (size_t)sim_env_int("SIM_PSRAM_SIZE", 8 << 20);
+  size_t used = heap_used();
+  size_t free_bytes = used < total ? total - used : 0;
+  if (free_bytes < _min_free) {
+    _min_free = free_bytes;
+  }
+  return free_bytes;
+}
+
+extern "C" size_t heap_caps_get_minimum_free_size(uint32_t caps) {
+  size_t now = heap_caps_get_free_size(caps);
+  return caps & MALLOC_CAP_INTERNAL ? now : _min_free;
+}
+
+extern "C" size_t heap_caps_get_largest_free_block(uint32_t caps) {
+  return heap_caps_get_free_size(caps);
+}
+
+extern "C" uint32_t esp_get_free_heap_size(void) {
+  return (uint32_t)(heap_caps_get_free_size(MALLOC_CAP_INTERNAL) + heap_caps_get_free_size(MALLOC_CAP_SPIRAM));
+}
+
+// ---------- NVS ----------
+// File teks, satu entri per baris: namespace<TAB>key<TAB>type<TAB>hex.
+struct nvs_value {
+  nvs_type_t type;
+  std::vector<uint8_t> data;
+};
+typedef std::map<std::string, std::map<std::string, nvs_value>> nvs_store;
+
+struct nvs_open_handle {
+  std::string ns;
+  bool read_only;
+};
+
+static std::mutex _nvs_mu;
+static nvs_store _nvs;
+static bool _nvs_loaded = false;
+static std::map<nvs_handle_t, nvs_open_handle> _nvs_handles;
+static nvs_handle_t _nvs_next = 1;
+
+static const char *nvs_path() {
+  return sim_env("SIM_NVS_FILE", "sim_nvs.txt");
+}
+
+static void nvs_load() {
+  if (_nvs_loaded) {
+    return;
+  }
+  _nvs_loaded = true;
+  FILE *f = fopen(nvs_path(), "r");
+  if (!f) {
+    return;
+  }
+  char line[4096];
+  while (fgets(line, sizeof(line), f)) {
+    char *ns = strtok(line, "\t\n");
+    char *key = strtok(NULL, "\t\n");
+    char *type = strtok(NULL, "\t\n");
+    char *hex = strtok(NULL, "\t\n");
+    if (!ns || !key || !type) {
+      continue;
+    }
+    nvs_value v;
+    v.type = (nvs_type_t)strtol(type, NULL, 16);
+    for (size_t i = 0; hex && hex[i] && hex[i + 1]; i += 2) {
+      char b[3] = {hex[i], hex[i + 1], 0};
+      v.data.push_back((uint8_t)strtol(b, NULL, 16));
+    }
+    _nvs[ns][key] = v;
+  }
+  fclose(f);
+}
+
+static esp_err_t nvs_save() {
+  std::string tmp = std::string(nvs_path()) + ".tmp";
+  FILE *f = fopen(tmp.c_str(), "w");
+  if (!f) {
+    return ESP_FAIL;
+  }
+  for (const auto &ns : _nvs) {
+    for (const auto &kv : ns.second) {
+      fprintf(f, "%s\t%s\t%02x\t", ns.first.c_str(), kv.first.c_str(), (unsigned)kv.second.type);
+      for (uint8_t b : kv.second.data) {
+        fprintf(f, "%02x", b);
+      }
+      fputc('\n', f);
+    }
+  }
+  fclose(f);
+  return rename(tmp.c_str(), nvs_path()) == 0 ? ESP_OK : ESP_FAIL;
+}
+
+static nvs_open_handle *nvs_handle_get(nvs_handle_t h) {
+  auto it = _nvs_handles.find(h);
+  return it == _nvs_handles.end() ? NULL : &it->second;
+}
+
+static bool nvs_name_ok(const char *s) {
+  return s && *s && strlen(s) < NVS_KEY_NAME_MAX_SIZE;
+}
+
+extern "C" esp_err_t nvs_open(const char *ns, nvs_open_mode_t mode, nvs_handle_t *out) {
+  if (!nvs_name_ok(ns) || !out) {
+    return ESP_ERR_NVS_INVALID_NAME;
+  }
+  std::lock_guard<std::mutex> lock(_nvs_mu);
+  nvs_load();
+  // read-only pada namespace yang belum ada gagal, seperti IDF
+  if (mode == NVS_READONLY && _nvs.find(ns) == _nvs.end()) {
+    return ESP_ERR_NVS_NOT_FOUND;
+  }
+  nvs_handle_t h = _nvs_next++;
+  _nvs_handles[h] = {ns, mode == NVS_READONLY};
+  *out = h;
+  return ESP_OK;
+}
+
+extern "C" void nvs_close(nvs_handle_t h) {
+  std::lock_guard<std::mutex> lock(_nvs_mu);
+  _nvs_handles.erase(h);
+}
+
+extern "C" esp_err_t nvs_commit(nvs_handle_t h) {
+  std::lock_guard<std::mutex> lock(_nvs_mu);
+  if (!nvs_handle_get(h)) {
+    return ESP_ERR_NVS_INVALID_HANDLE;
+  }
+  return nvs_save();
+}
+
+static esp_err_t nvs_set(nvs_handle_t h, const char *key, nvs_type_t type, const void *data, size_t len) {
+  std::lock_guard<std::mutex> lock(_nvs_mu);
+  nvs_open_handle *oh = nvs_handle_get(h);
+  if (!oh) {
+    return ESP_ERR_NVS_INVALID_HANDLE;
+  }
+  if (oh->read_only) {
+    return ESP_ERR_NVS_READ_ONLY;
+  }
+  if (!nvs_name_ok(key)) {
+    return ESP_ERR_NVS_INVALID_NAME;
+  }
+  nvs_value &v = _nvs[oh->ns][key];
+  v.type = type;
+  v.data.assign((const uint8_t *)data, (const uint8_t *)data + len);
+  return ESP_OK;
+}
+
+// len: in = kapasitas out, out = panjang data. out NULL = tanya panjang.
+static esp_err_t nvs_get(nvs_handle_t h, const char *key, nvs_type_t type, void *out, size_t *len) {
+  std::lock_guard<std::mutex> lock(_nvs_mu);
+  nvs_open_handle *oh = nvs_handle_get(h);
+  if (!oh) {
+    return ESP_ERR_NVS_INVALID_HANDLE;
+  }
+  auto ns = _nvs.find(oh->ns);
+  if (ns == _nvs.end()) {
+    return ESP_ERR_NVS_NOT_FOUND;
+  }
+  auto it = ns->second.find(key ? key : "");
+  if (it == ns->second.end()) {
+    return ESP_ERR_NVS_NOT_FOUND;
+  }
+  if (it->second.type != type) {
+    return ESP_ERR_NVS_TYPE_MISMATCH;
+  }
+  const std::vector<uint8_t> &d = it->second.data;
+  if (!out) {
+    *len = d.size();
+    return ESP_OK;
+  }
+  if (*len < d.size()) {
+    *len = d.size();
+    return ESP_ERR_NVS_INVALID_LENGTH;
+  }
+  memcpy(out, d.data(), d.size());
+  *len = d.size();
+  return ESP_OK;
+}
+
+extern "C" esp_err_t nvs_get_str(nvs_handle_t h, const char *key, char *out, size_t *len) {
+  return nvs_get(h, key, NVS_TYPE_STR, out, len);
+}
+
+extern "C" esp_err_t nvs_set_str(nvs_handle_t h, const char *key, const char *value) {
+  return nvs_set(h, key, NVS_TYPE_STR, value, strlen(value) + 1);
+}
+
+extern "C" esp_err_t nvs_get_blob(nvs_handle_t h, const char *key, void *out, size_t *len) {
+  return nvs_get(h, key, NVS_TYPE_BLOB, out, len);
+}
+
+extern "C" esp_err_t nvs_set_blob(nvs_handle_t h, const char *key, const void *value, size_t len) {
+  return nvs_set(h, key, NVS_TYPE_BLOB, value, len);
+}
+
+extern "C" esp_err_t nvs_get_u32(nvs_handle_t h, const char *key, uint32_t *out) {
+  size_t len = sizeof(*out);
+  return nvs_get(h, key, NVS_TYPE_U32, out, &len);
+}
+
+extern "C" esp_err_t nvs_set_u32(nvs_handle_t h, const char *key, uint32_t value) {
+  return nvs_set(h, key, NVS_TYPE_U32, &value, sizeof(value));
+}
+
+extern "C" esp_err_t nvs_get_i32(nvs_handle_t h, const char *key, int32_t *out) {
+  size_t len = sizeof(*out);
+  return nvs_get(h, key, NVS_TYPE_I32, out, &len);
+}
+
+extern "C" esp_err_t nvs_set_i32(nvs_handle_t h, const char *key, int32_t value) {
+  return nvs_set(h, key, NVS_TYPE_I32, &value, sizeof(value));
+}
+
+extern "C" esp_err_t nvs_erase_key(nvs_handle_t h, const char *key) {
+  std::lock_guard<std::mutex> lock(_nvs_mu);
+  nvs_open_handle *oh = nvs_handle_get(h);
+  if (!oh) {
+    return ESP_ERR_NVS_INVALID_HANDLE;
+  }
+  if (oh->read_only) {
+    return ESP_ERR_NVS_READ_ONLY;
+  }
+  return _nvs[oh->ns].erase(key ? key : "") ? ESP_OK : ESP_ERR_NVS_NOT_FOUND;
+}
+
+extern "C" esp_err_t nvs_erase_all(nvs_handle_t h) {
+  std::lock_guard<std::mutex> lock(_nvs_mu);
+  nvs_open_handle *oh = nvs_handle_get(h);
+  if (!oh) {
+    return ESP_ERR_NVS_INVALID_HANDLE;
+  }
+  if (oh->read_only) {
+    return ESP_ERR_NVS_READ_ONLY;
+  }
+  _nvs[oh->ns].clear();
+  return ESP_OK;
+}
+
+// Iterator = snapshot entri yang cocok saat nvs_entry_find.
+struct nvs_opaque_iterator_t {
+  std::vector<nvs_entry_info_t> entries;
+  size_t pos;
+};
+
+extern "C" esp_err_t nvs_entry_find(const char *part, const char *ns, nvs_type_t type, nvs_iterator_t *out) {
+  (void)part;
+  *out = NULL;
+  nvs_opaque_iterator_t *it = new nvs_opaque_iterator_t();
+  it->pos = 0;
+  {
+    std::lock_guard<std::mutex> lock(_nvs_mu);
+    nvs_load();
+    for (const auto &n : _nvs) {
+      if (ns && n.first != ns) {
+        continue;
+      }
+      for (const auto &kv : n.second) {
+        if (type != NVS_TYPE_ANY && kv.second.type != type) {
+          continue;
+        }
+        nvs_entry_info_t info;
+        memset(&info, 0, sizeof(info));
+        snprintf(info.namespace_name, sizeof(info.namespace_name), "%s", n.first.c_str());
+        snprintf(info.key, sizeof(info.key), "%s", kv.first.c_str());
+        info.type = kv.second.type;
+        it->entries.push_back(info);
+      }
+    }
+  }
+  if (it->entries.empty()) {
+    delete it;
+    return ESP_ERR_NVS_NOT_FOUND;
+  }
+  *out = it;
+  return ESP_OK;
+}
+
+extern "C" esp_err_t nvs_entry_next(nvs_iterator_t *it) {
+  if (!it || !*it) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  if (++(*it)->pos >= (*it)->entries.size()) {
+    delete *it;
+    *it = NULL;
+    return ESP_ERR_NVS_NOT_FOUND;
+  }
+  return ESP_OK;
+}
+
+extern "C" esp_err_t nvs_entry_info(nvs_iterator_t it, nvs_entry_info_t *out) {
+  if (!it || !out) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  *out = it->entries[it->pos];
+  return ESP_OK;
+}
+
+extern "C" void nvs_release_iterator(nvs_iterator_t it) {
+  delete it;
+}
+
+// ---------- Preferences ----------
+bool Preferences::begin(const char *name, bool read_only, const char *partition) {
+  (void)partition;
+  end();
+  read_only_ = read_only;
+  if (nvs_open(name, read_only ? NVS_READONLY : NVS_READWRITE, &handle_) != ESP_OK) {
+    handle_ = 0;
+    return false;
+  }
+  return true;
+}
+
+void Preferences::end() {
+  if (handle_) {
+    nvs_close(handle_);
+    handle_ = 0;
+  }
+}
+
+bool Preferences::clear() {
+  return handle_ && !read_only_ && nvs_erase_all(handle_) == ESP_OK && nvs_commit(handle_) == ESP_OK;
+}
+
+bool Preferences::remove(const char *key) {
+  return handle_ && !read_only_ && nvs_erase_key(handle_, key) == ESP_OK && nvs_commit(handle_) == ESP_OK;
+}
+
+bool Preferences::isKey(const char *key) {
+  if (!handle_) {
+    return false;
+  }
+  size_t len = 0;
+  uint32_t u;
+  int32_t i;
+  return nvs_get_str(handle_, key, NULL, &len) == ESP_OK || nvs_get_blob(handle_, key, NULL, &len) == ESP_OK ||
+         nvs_get_u32(handle_, key, &u) == ESP_OK || nvs_get_i32(handle_, key, &i) == ESP_OK;
+}
+
+size_t Preferences::putString(const char *key, const char *value) {
+  if (!handle_ || read_only_ || !value || nvs_set_str(handle_, key, value) != ESP_OK || nvs_commit(handle_) != ESP_OK) {
+    return 0;
+  }
+  return strlen(value);
+}
+
+String Preferences::getString(const char *key, const String &def) {
+  size_t len = 0;
+  if (!handle_ || nvs_get_str(handle_, key, NULL, &len) != ESP_OK || len == 0) {
+    return def;
+  }
+  std::vector<char> buf(len);
+  if (nvs_get_str(handle_, key, buf.data(), &len) != ESP_OK) {
+    return def;
+  }
+  return String(buf.data());
+}
+
+size_t Preferences::getString(const char *key, char *out, size_t max_len) {
+  size_t len = max_len;
+  if (!handle_ || nvs_get_str(handle_, key, out, &len) != ESP_OK) {
+    return 0;
+  }
+  return len;
+}
+
+size_t Preferences::putUInt(const char *key, uint32_t value) {
+  if (!handle_ || read_only_ || nvs_set_u32(handle_, key, value) != ESP_OK || nvs_commit(handle_) != ESP_OK) {
+    return 0;
+  }
+  return sizeof(value);
+}
+
+uint32_t Preferences::getUInt(const char *key, uint32_t def) {
+  uint32_t v;
+  return handle_ && nvs_get_u32(handle_, key, &v) == ESP_OK ? v : def;
+}
+
+size_t Preferences::putInt(const char *key, int32_t value) {
+  if (!handle_ || read_only_ || nvs_set_i32(handle_, key, value) != ESP_OK || nvs_commit(handle_) != ESP_OK) {
+    return 0;
+  }
+  return sizeof(value);
+}
+
+int32_t Preferences::getInt(const char *key, int32_t def) {
+  int32_t v;
+  return handle_ && nvs_get_i32(handle_, key, &v) == ESP_OK ? v : def;
+}
+
+size_t Preferences::putBytes(const char *key, const void *value, size_t len) {
+  if (!handle_ || read_only_ || nvs_set_blob(handle_, key, value, len) != ESP_OK || nvs_commit(handle_) != ESP_OK) {
+    return 0;
+  }
+  return len;
+}
+
+size_t Preferences::getBytes(const char *key, void *out, size_t max_len) {
+  size_t len = max_len;
+  if (!handle_ || nvs_get_blob(handle_, key, out, &len) != ESP_OK) {
+    return 0;
+  }
+  return len;
+}
+
+// ---------- MAC ----------
+static bool parse_mac(const char *s, uint8_t mac[6]) {
+  unsigned v[6];
+  if (!s || sscanf(s, "%x:%x:%x:%x:%x:%x", &v[0], &v[1], &v[2], &v[3], &v[4], &v[5]) != 6) {
+    return false;
+  }
+  for (int i = 0; i < 6; i++) {
+    mac[i] = (uint8_t)v[i];
+  }
+  return true;
+}
+
+extern "C" esp_err_t esp_efuse_mac_get_default(uint8_t *mac) {
+  if (parse_mac(sim_env("SIM_MAC", NULL), mac)) {
+    return ESP_OK;
+  }
+  // locally administered, unik per proses
+  uint32_t pid = (uint32_t)getpid();
+  const uint8_t def[6] = {0x02, 0x53, 0x49, (uint8_t)(pid >> 16), (uint8_t)(pid >> 8), (uint8_t)pid};
+  memcpy(mac, def, 6);
+  return ESP_OK;
+}
+
+extern "C" esp_err_t esp_read_mac(uint8_t *mac, esp_mac_type_t type) {
+  if (!mac) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  esp_efuse_mac_get_default(mac);
+  // urutan turunan seperti IDF: STA = base, AP = +1, BT = +2, ETH = +3
+  if (type != ESP_MAC_BASE) {
+    mac[5] = (uint8_t)(mac[5] + (int)type);
+  }
+  return ESP_OK;
+}
+
+// ---------- esp_wifi ----------
+static std::mutex _wifi_mu;
+static bool _wifi_started = false;
+static wifi_mode_t _wifi_mode = WIFI_MODE_NULL;
+static uint8_t _wifi_channel = 0;
+
+static uint8_t wifi_channel_now() {
+  if (_wifi_channel == 0) {
+    _wifi_channel = (uint8_t)sim_env_int("SIM_WIFI_CHANNEL", 8);
+  }
+  return _wifi_channel;
+}
+
+extern "C" esp_err_t esp_wifi_start(void) {
+  std::lock_guard<std::mutex> lock(_wifi_mu);
+  _wifi_started = true;
+  return ESP_OK;
+}
+
+extern "C" esp_err_t esp_wifi_stop(void) {
+  std::lock_guard<std::mutex> lock(_wifi_mu);
+  _wifi_started = false;
+  return ESP_OK;
+}
+
+extern "C" esp_err_t esp_wifi_set_mode(wifi_mode_t mode) {
+  std::lock_guard<std::mutex> lock(_wifi_mu);
+  _wifi_mode = mode;
+  return ESP_OK;
+}
+
+extern "C" esp_err_t esp_wifi_set_channel(uint8_t primary, wifi_second_chan_t second) {
+  (void)second;
+  if (primary < 1 || primary > 14) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  std::lock_guard<std::mutex> lock(_wifi_mu);
+  if (_wifi_mode == WIFI_MODE_NULL) {
+    return ESP_ERR_INVALID_STATE;  // ESP_ERR_WIFI_NOT_INIT di IDF
+  }
+  _wifi_channel = primary;
+  return ESP_OK;
+}
+
+extern "C" esp_err_t esp_wifi_get_channel(uint8_t *primary, wifi_second_chan_t *second) {
+  std::lock_guard<std::mutex> lock(_wifi_mu);
+  if (primary) {
+    *primary = wifi_channel_now();
+  }
+  if (second) {
+    *second = WIFI_SECOND_CHAN_NONE;
+  }
+  return ESP_OK;
+}
+
+extern "C" esp_err_t esp_wifi_get_mac(wifi_interface_t ifx, uint8_t mac[6]) {
+  return esp_read_mac(mac, ifx == WIFI_IF_AP ? ESP_MAC_WIFI_SOFTAP : ESP_MAC_WIFI_STA);
+}
+
+extern "C" esp_err_t esp_wifi_set_ps(int type) {
+  (void)type;
+  return ESP_OK;
+}
+
+// ---------- WiFi ----------
+WiFiClass WiFi;
+
+bool WiFiClass::mode(wifi_mode_t m) {
+  mode_ = m;
+  esp_wifi_set_mode(m);
+  if (m != WIFI_MODE_NULL) {
+    esp_wifi_start();
+  }
+  return true;
+}
+
+wl_status_t WiFiClass::begin(const char *ssid, const char *pass, int32_t channel, const uint8_t *bssid, bool connect) {
+  (void)pass;
+  (void)bssid;
+  if (mode_ == WIFI_MODE_NULL) {
+    mode(WIFI_STA);
+  }
+  ssid_ = ssid ? ssid : "";
+  if (channel > 0) {
+    esp_wifi_set_channel((uint8_t)channel, WIFI_SECOND_CHAN_NONE);
+  }
+  status_ = connect && !ssid_.isEmpty() ? WL_CONNECTED : WL_NO_SSID_AVAIL;
+  if (status_ == WL_CONNECTED) {
+    // ikut channel AP, seperti STA sungguhan
+    std::lock_guard<std::mutex> lock(_wifi_mu);
+    _wifi_channel = (uint8_t)sim_env_int("SIM_WIFI_CHANNEL", 8);
+  }
+  return status_;
+}
+
+bool WiFiClass::disconnect(bool wifioff, bool erase_ap) {
+  (void)erase_ap;
+  status_ = WL_DISCONNECTED;
+  if (wifioff) {
+    mode(WIFI_MODE_NULL);
+  }
+  return true;
+}
+
+wl_status_t WiFiClass::status() {
+  return status_;
+}
+
+IPAddress WiFiClass::localIP() {
+  if (status_ != WL_CONNECTED) {
+    return IPAddress();
+  }
+  struct in_addr a;
+  if (inet_pton(AF_INET, sim_env("SIM_IP", "127.0.0.1"), &a) != 1) {
+    return IPAddress(127, 0, 0, 1);
+  }
+  return IPAddress((uint32_t)a.s_addr);
+}
+
+IPAddress WiFiClass::gatewayIP() {
+  return status_ == WL_CONNECTED ? IPAddress(127, 0, 0, 1) : IPAddress();
+}
+
+String WiFiClass::SSID() {
+  return status_ == WL_CONNECTED ? ssid_ : String();
+}
+
+int32_t WiFiClass::RSSI() {
+  return status_ == WL_CONNECTED ? (int32_t)sim_env_int("SIM_RSSI", -55) : 0;
+}
+
+int32_t WiFiClass::channel() {
+  uint8_t ch = 0;
+  esp_wifi_get_channel(&ch, NULL);
+  return ch;
+}
+
+String WiFiClass::macAddress() {
+  uint8_t mac[6];
+  char buf[18];
+  esp_read_mac(mac, ESP_MAC_WIFI_STA);
+  snprintf(buf, sizeof(buf), "%02X:%02X:%02X:%02X:%02X:%02X", mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+  return String(buf);
+}
+
+uint8_t *WiFiClass::macAddress(uint8_t *mac) {
+  esp_read_mac(mac, ESP_MAC_WIFI_STA);
+  return mac;
+}
@@ -0,0 +1,452 @@
+// FreeRTOS di atas pthread untuk simulator host.
+//
+// Task = pthread detached; vTaskDelete(NULL) keluar lewat pthread_exit.
+// Notifikasi, semaphore dan queue = mutex + condition variable. Timeout
+// dalam tick (1 ms). Tidak ada preemption berbasis prioritas: scheduler host
+// yang memutuskan, jadi hasil timing hanya bisa dibandingkan antar build
+// simulator, bukan dengan board.
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "esp_timer.h"
+#include "sim.h"
+
+struct sim_task {
+  int id = 0;  // pemilik portMUX, tidak pernah 0
+  std::string name;
+  TaskFunction_t fn = nullptr;
+  void *arg = nullptr;
+  BaseType_t core = tskNO_AFFINITY;
+  std::mutex mu;
+  std::condition_variable cv;
+  uint32_t notify = 0;
+  bool notified = false;  // xTaskNotifyWait
+};
+
+static thread_local sim_task *_self = nullptr;
+static int _next_id = 1;
+
+static sim_task *task_new(const char *name) {
+  sim_task *t = new sim_task();
+  t->id = __atomic_fetch_add(&_next_id, 1, __ATOMIC_RELAXED);
+  t->name = name ? name : "task";
+  return t;
+}
+
+using sim_clock = std::chrono::steady_clock;
+
+static sim_clock::time_point deadline_for(TickType_t ticks) {
+  return sim_clock::now() + std::chrono::milliseconds(ticks);
+}
+
+// Tunggu pred() dengan timeout tick; portMAX_DELAY = tanpa batas.
+template <class Pred>
+static bool wait_ticks(std::condition_variable &cv, std::unique_lock<std::mutex> &lock, TickType_t ticks, Pred pred) {
+  if (ticks == portMAX_DELAY) {
+    cv.wait(lock, pred);
+    return true;
+  }
+  return cv.wait_until(lock, deadline_for(ticks), pred);
+}
+
+static void *task_main(void *p) {
+  sim_task *t = (sim_task *)p;
+  _self = t;
+  pthread_setname_np(pthread_self(), t->name.substr(0, 15).c_str());
+  t->fn(t->arg);
+  // task FreeRTOS tidak boleh return; di host cukup diakhiri saja
+  return nullptr;
+}
+
+// ---------- Task ----------
+extern "C" BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char *name, uint32_t stack_depth, void *arg, UBaseType_t priority, TaskHandle_t *out, BaseType_t core_id) {
+  (void)priority;
+  sim_task *t = task_new(name);
+  t->fn = fn;
+  t->arg = arg;
+  t->core = core_id;
+  pthread_attr_t attr;
+  pthread_attr_init(&attr);
+  pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+  // stack FreeRTOS dalam byte (ESP-IDF); host butuh lebih untuk libc/libjpeg
+  size_t stack = (size_t)stack_depth * 4 < (1 << 20) ? (1 << 20) : (size_t)stack_depth * 4;
+  pthread_attr_setstacksize(&attr, stack);
+  pthread_t th;
+  int err = pthread_create(&th, &attr, task_main, t);
+  pthread_attr_destroy(&attr);
+  if (err != 0) {
+    delete t;
+    return pdFAIL;
+  }
+  if (out) {
+    *out = t;
+  }
+  return pdPASS;
+}
+
+extern "C" BaseType_t xTaskCreate(TaskFunction_t fn, const char *name, uint32_t stack_depth, void *arg, UBaseType_t priority, TaskHandle_t *out) {
+  return xTaskCreatePinnedToCore(fn, name, stack_depth, arg, priority, out, tskNO_AFFINITY);
+}
+
+extern "C" void vTaskDelete(TaskHandle_t task) {
+  if (task == nullptr || task == _self) {
+    pthread_exit(nullptr);
+  }
+  // task lain tidak bisa dihentikan paksa di host; tidak dipakai firmware
+  sim_log('W', __FILE__, __LINE__, __func__, "vTaskDelete(%s) dari task lain diabaikan", task->name.c_str());
+}
+
+extern "C" void vTaskDelay(TickType_t ticks) {
+  if (ticks == 0) {
+    sched_yield();
+    return;
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(ticks));
+}
+
+extern "C" TickType_t xTaskGetTickCount(void) {
+  return (TickType_t)(esp_timer_get_time() / (1000000 / configTICK_RATE_HZ));
+}
+
+extern "C" void vTaskDelayUntil(TickType_t *prev_wake, TickType_t increment) {
+  *prev_wake += increment;
+  TickType_t now = xTaskGetTickCount();
+  if ((int32_t)(*prev_wake - now) > 0) {
+    vTaskDelay(*prev_wake - now);
+  }
+}
+
+extern "C" TaskHandle_t xTaskGetCurrentTaskHandle(void) {
+  if (!_self) {
+    // thread yang tidak dibuat lewat xTaskCreate (main/loopTask, httpd, ...)
+    char name[16] = "";
+    pthread_getname_np(pthread_self(), name, sizeof(name));
+    _self = task_new(name);
+  }
+  return _self;
+}
+
+extern "C" const char *pcTaskGetName(TaskHandle_t task) {
+  return (task ? task : xTaskGetCurrentTaskHandle())->name.c_str();
+}
+
+extern "C" UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task) {
+  (void)task;
+  return 0;
+}
+
+extern "C" uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t ticks) {
+  sim_task *t = xTaskGetCurrentTaskHandle();
+  std::unique_lock<std::mutex> lock(t->mu);
+  wait_ticks(t->cv, lock, ticks, [t] { return t->notify > 0; });
+  uint32_t v = t->notify;
+  if (v > 0) {
+    t->notify = clear_on_exit ? 0 : v - 1;
+  }
+  return v;
+}
+
+extern "C" BaseType_t xTaskNotify(TaskHandle_t task, uint32_t value, eNotifyAction action) {
+  BaseType_t res = pdPASS;
+  {
+    std::lock_guard<std::mutex> lock(task->mu);
+    switch (action) {
+      case eSetBits: task->notify |= value; break;
+      case eIncrement: task->notify++; break;
+      case eSetValueWithOverwrite: task->notify = value; break;
+      case eSetValueWithoutOverwrite:
+        if (task->notified) {
+          res = pdFAIL;
+        } else {
+          task->notify = value;
+        }
+        break;
+      case eNoAction: break;
+    }
+    task->notified = true;
+  }
+  task->cv.notify_all();
+  return res;
+}
+
+extern "C" BaseType_t xTaskNotifyGive(TaskHandle_t task) {
+  return xTaskNotify(task, 0, eIncrement);
+}
+
+extern "C" void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t *woken) {
+  xTaskNotifyGive(task);
+  if (woken) {
+    *woken = pdFALSE;
+  }
+}
+
+extern "C" BaseType_t xTaskNotifyWait(uint32_t clear_on_entry, uint32_t clear_on_exit, uint32_t *value, TickType_t ticks) {
+  sim_task *t = xTaskGetCurrentTaskHandle();
+  std::unique_lock<std::mutex> lock(t->mu);
+  if (!t->notified) {
+    t->notify &= ~clear_on_entry;
+  }
+  if (!wait_ticks(t->cv, lock, ticks, [t] { return t->notified; })) {
+    return pdFALSE;
+  }
+  if (value) {
+    *value = t->notify;
+  }
+  t->notify &= ~clear_on_exit;
+  t->notified = false;
+  return pdTRUE;
+}
+
+extern "C" void taskYIELD(void) {
+  sched_yield();
+}
+
+// ---------- Critical section ----------
+extern "C" void vPortCPUInitializeMutex(portMUX_TYPE *mux) {
+  mux->owner = 0;
+  mux->count = 0;
+}
+
+// Spinlock rekursif per thread seperti portMUX ESP-IDF (rekursif per core).
+extern "C" void vPortEnterCritical(portMUX_TYPE *mux) {
+  int me = xTaskGetCurrentTaskHandle()->id;
+  if (__atomic_load_n(&mux->owner, __ATOMIC_ACQUIRE) == me) {
+    mux->count++;
+    return;
+  }
+  int expected = 0;
+  while (!__atomic_compare_exchange_n(&mux->owner, &expected, me, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+    expected = 0;
+    sched_yield();
+  }
+  mux->count = 1;
+}
+
+extern "C" void vPortExitCritical(portMUX_TYPE *mux) {
+  if (--mux->count == 0) {
+    __atomic_store_n(&mux->owner, 0, __ATOMIC_RELEASE);
+  }
+}
+
+extern "C" BaseType_t xPortGetCoreID(void) {
+  sim_task *t = xTaskGetCurrentTaskHandle();
+  return t->core == tskNO_AFFINITY ? 0 : t->core;
+}
+
+// ---------- Semaphore ----------
+struct sim_sem {
+  std::mutex mu;
+  std::condition_variable cv;
+  UBaseType_t count = 0;
+  UBaseType_t max = 1;
+  sim_task *holder = nullptr;  // recursive mutex
+  UBaseType_t depth = 0;
+};
+
+static SemaphoreHandle_t sem_new(UBaseType_t max, UBaseType_t initial) {
+  sim_sem *s = new sim_sem();
+  s->max = max;
+  s->count = initial;
+  return s;
+}
+
+extern "C" SemaphoreHandle_t xSemaphoreCreateBinary(void) {
+  return sem_new(1, 0);
+}
+
+extern "C" SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t max, UBaseType_t initial) {
+  return sem_new(max, initial);
+}
+
+extern "C" SemaphoreHandle_t xSemaphoreCreateMutex(void) {
+  return sem_new(1, 1);
+}
+
+extern "C" SemaphoreHandle_t xSemaphoreCreateRecursiveMutex(void) {
+  return sem_new(1, 1);
+}
+
+extern "C" BaseType_t xSemaphoreTake(SemaphoreHandle_t s, TickType_t ticks) {
+  std::unique_lock<std::mutex> lock(s->mu);
+  if (!wait_ticks(s->cv, lock, ticks, [s] { return s->count > 0; })) {
+    return pdFALSE;
+  }
+  s->count--;
+  return pdTRUE;
+}
+
+extern "C" BaseType_t xSemaphoreGive(SemaphoreHandle_t s) {
+  {
+    std::lock_guard<std::mutex> lock(s->mu);
+    if (s->count >= s->max) {
+      return pdFALSE;
+    }
+    s->count++;
+  }
+  s->cv.notify_one();
+  return pdTRUE;
+}
+
+extern "C" BaseType_t xSemaphoreGiveFromISR(SemaphoreHandle_t s, BaseType_t *woken) {
+  if (woken) {
+    *woken = pdFALSE;
+  }
+  return xSemaphoreGive(s);
+}
+
+extern "C" BaseType_t xSemaphoreTakeRecursive(SemaphoreHandle_t s, TickType_t ticks) {
+  sim_task *me = xTaskGetCurrentTaskHandle();
+  {
+    std::lock_guard<std::mutex> lock(s->mu);
+    if (s->holder == me) {
+      s->depth++;
+      return pdTRUE;
+    }
+  }
+  if (xSemaphoreTake(s, ticks) != pdTRUE) {
+    return pdFALSE;
+  }
+  std::lock_guard<std::mutex> lock(s->mu);
+  s->holder = me;
+  s->depth = 1;
+  return pdTRUE;
+}
+
+extern "C" BaseType_t xSemaphoreGiveRecursive(SemaphoreHandle_t s) {
+  {
+    std::lock_guard<std::mutex> lock(s->mu);
+    if (s->holder != xTaskGetCurrentTaskHandle()) {
+      return pdFALSE;
+    }
+    if (--s->depth > 0) {
+      return pdTRUE;
+    }
+    s->holder = nullptr;
+  }
+  return xSemaphoreGive(s);
+}
+
+extern "C" UBaseType_t uxSemaphoreGetCount(SemaphoreHandle_t s) {
+  std::lock_guard<std::mutex> lock(s->mu);
+  return s->count;
+}
+
+extern "C" void vSemaphoreDelete(SemaphoreHandle_t s) {
+  delete s;
+}
+
+// ---------- Queue ----------
+struct sim_queue {
+  std::mutex mu;
+  std::condition_variable not_empty;
+  std::condition_variable not_full;
+  std::deque<std::vector<uint8_t>> items;
+  UBaseType_t length;
+  UBaseType_t item_size;
+};
+
+extern "C" QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size) {
+  sim_queue *q = new sim_queue();
+  q->length = length;
+  q->item_size = item_size;
+  return q;
+}
+
+static BaseType_t queue_put(QueueHandle_t q, const void *item, TickType_t ticks, bool front, bool overwrite) {
+  std::unique_lock<std::mutex> lock(q->mu);
+  if (overwrite) {
+    q->items.clear();
+  } else if (!wait_ticks(q->not_full, lock, ticks, [q] { return q->items.size() < q->length; })) {
+    return errQUEUE_FULL;
+  }
+  std::vector<uint8_t> v((const uint8_t *)item, (const uint8_t *)item + q->item_size);
+  if (front) {
+    q->items.push_front(std::move(v));
+  } else {
+    q->items.push_back(std::move(v));
+  }
+  lock.unlock();
+  q->not_empty.notify_one();
+  return pdTRUE;
+}
+
+extern "C" BaseType_t xQueueSend(QueueHandle_t q, const void *item, TickType_t ticks) {
+  return queue_put(q, item, ticks, false, false);
+}
+
+extern "C" BaseType_t xQueueSendToBack(QueueHandle_t q, const void *item, TickType_t ticks) {
+  return queue_put(q, item, ticks, false, false);
+}
+
+extern "C" BaseType_t xQueueSendToFront(QueueHandle_t q, const void *item, TickType_t ticks) {
+  return queue_put(q, item, ticks, true, false);
+}
+
+extern "C" BaseType_t xQueueOverwrite(QueueHandle_t q, const void *item) {
+  return queue_put(q, item, 0, false, true);
+}
+
+extern "C" BaseType_t xQueueSendFromISR(QueueHandle_t q, const void *item, BaseType_t *woken) {
+  if (woken) {
+    *woken = pdFALSE;
+  }
+  return queue_put(q, item, 0, false, false);
+}
+
+static BaseType_t queue_get(QueueHandle_t q, void *item, TickType_t ticks, bool peek) {
+  std::unique_lock<std::mutex> lock(q->mu);
+  if (!wait_ticks(q->not_empty, lock, ticks, [q] { return !q->items.empty(); })) {
+    return errQUEUE_EMPTY;
+  }
+  memcpy(item, q->items.front().data(), q->item_size);
+  if (!peek) {
+    q->items.pop_front();
+    lock.unlock();
+    q->not_full.notify_one();
+  }
+  return pdTRUE;
+}
+
+extern "C" BaseType_t xQueueReceive(QueueHandle_t q, void *item, TickType_t ticks) {
+  return queue_get(q, item, ticks, false);
+}
+
+extern "C" BaseType_t xQueuePeek(QueueHandle_t q, void *item, TickType_t ticks) {
+  return queue_get(q, item, ticks, true);
+}
+
+extern "C" UBaseType_t uxQueueMessagesWaiting(QueueHandle_t q) {
+  std::lock_guard<std::mutex> lock(q->mu);
+  return q->items.size();
+}
+
+extern "C" UBaseType_t uxQueueSpacesAvailable(QueueHandle_t q) {
+  std::lock_guard<std::mutex> lock(q->mu);
+  return q->length - q->items.size();
+}
+
+extern "C" BaseType_t xQueueReset(QueueHandle_t q) {
+  {
+    std::lock_guard<std::mutex> lock(q->mu);
+    q->items.clear();
+  }
+  q->not_full.notify_all();
+  return pdPASS;
+}
+
+extern "C" void vQueueDelete(QueueHandle_t q) {
+  delete q;
+}
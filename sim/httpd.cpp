@@ -0,0 +1,819 @@
+// esp_http_server di atas socket POSIX untuk simulator host.
+//
+// Satu thread server per httpd_start(), seperti task httpd IDF: select() atas
+// socket listen, pipe kontrol dan semua sesi yang tidak sedang dipegang
+// handler async. Handler dijalankan di thread ini, jadi handler yang blok
+// (mis. stream tanpa httpd_async) menahan semua sesi lain, sama seperti di
+// board. Batas max_open_sockets dan max_uri_handlers ikut ditegakkan.
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "esp_http_server.h"
+#include "esp_timer.h"
+#include "sim.h"
+
+#define HTTPD_SIM_MAX_HDR 8192
+
+struct httpd_sess {
+  int fd = -1;
+  std::string inbuf;          // byte sesudah header yang sudah diterima
+  bool async = false;         // dipegang handler async
+  bool close_pending = false;  // httpd_sess_trigger_close
+  int64_t lru = 0;
+  void *ctx = nullptr;
+  httpd_free_ctx_fn_t free_ctx = nullptr;
+};
+
+struct sim_httpd;
+
+struct httpd_req_aux {
+  sim_httpd *hd = nullptr;
+  httpd_sess *sess = nullptr;
+  std::string query;
+  bool has_query = false;
+  std::vector<std::pair<std::string, std::string>> req_hdrs;
+  size_t remaining = 0;  // body yang belum dibaca
+  std::string status = HTTPD_200;
+  std::string type = HTTPD_TYPE_TEXT;
+  std::vector<std::pair<std::string, std::string>> resp_hdrs;
+  bool first_chunk_sent = false;
+  bool handed_off = false;  // httpd_req_async_handler_begin sudah dipanggil
+};
+
+struct sim_uri {
+  std::string uri;
+  httpd_uri_t h;
+};
+
+struct sim_httpd {
+  httpd_config_t cfg;
+  int listen_fd = -1;
+  int wake[2] = {-1, -1};
+  std::mutex mu;
+  std::vector<sim_uri> uris;
+  std::map<int, httpd_sess *> sessions;
+  std::deque<std::pair<httpd_work_fn_t, void *>> work;
+  std::thread thread;
+  bool stop = false;
+};
+
+extern "C" const char *http_method_str(enum http_method m) {
+  switch (m) {
+    case HTTP_DELETE: return "DELETE";
+    case HTTP_GET: return "GET";
+    case HTTP_HEAD: return "HEAD";
+    case HTTP_POST: return "POST";
+    case HTTP_PUT: return "PUT";
+    case HTTP_CONNECT: return "CONNECT";
+    case HTTP_OPTIONS: return "OPTIONS";
+    case HTTP_TRACE: return "TRACE";
+    case HTTP_PATCH: return "PATCH";
+  }
+  return "<unknown>";
+}
+
+static int method_from_str(const std::string &s) {
+  static const enum http_method all[] = {HTTP_DELETE, HTTP_GET, HTTP_HEAD, HTTP_POST, HTTP_PUT, HTTP_CONNECT, HTTP_OPTIONS, HTTP_TRACE, HTTP_PATCH};
+  for (enum http_method m : all) {
+    if (s == http_method_str(m)) {
+      return m;
+    }
+  }
+  return -1;
+}
+
+static void wake(sim_httpd *hd) {
+  char c = 0;
+  (void)!write(hd->wake[1], &c, 1);
+}
+
+static httpd_req_aux *aux_of(httpd_req_t *r) {
+  return (httpd_req_aux *)r->aux;
+}
+
+// ---------- I/O ----------
+static int sock_send(int fd, const char *buf, size_t len) {
+  ssize_t n = send(fd, buf, len, MSG_NOSIGNAL);
+  if (n < 0) {
+    return errno == EAGAIN || errno == EWOULDBLOCK ? HTTPD_SOCK_ERR_TIMEOUT : HTTPD_SOCK_ERR_FAIL;
+  }
+  return (int)n;
+}
+
+static bool send_all(int fd, const char *buf, size_t len) {
+  while (len > 0) {
+    int n = sock_send(fd, buf, len);
+    if (n <= 0) {
+      return false;
+    }
+    buf += n;
+    len -= n;
+  }
+  return true;
+}
+
+static bool send_str(int fd, const std::string &s) {
+  return send_all(fd, s.data(), s.size());
+}
+
+// ---------- Sesi ----------
+static void sess_close(sim_httpd *hd, httpd_sess *s) {
+  if (hd->cfg.close_fn) {
+    hd->cfg.close_fn(hd, s->fd);
+  } else {
+    close(s->fd);
+  }
+  if (s->ctx) {
+    if (s->free_ctx) {
+      s->free_ctx(s->ctx);
+    } else {
+      free(s->ctx);
+    }
+  }
+  hd->sessions.erase(s->fd);
+  delete s;
+}
+
+static void sess_accept(sim_httpd *hd) {
+  int fd = accept(hd->listen_fd, NULL, NULL);
+  if (fd < 0) {
+    return;
+  }
+  std::unique_lock<std::mutex> lock(hd->mu);
+  if (hd->sessions.size() >= hd->cfg.max_open_sockets) {
+    // hanya sampai di sini kalau lru_purge_enable
+    httpd_sess *oldest = nullptr;
+    for (auto &kv : hd->sessions) {
+      if (!kv.second->async && (!oldest || kv.second->lru < oldest->lru)) {
+        oldest = kv.second;
+      }
+    }
+    if (!oldest) {
+      close(fd);
+      return;
+    }
+    sess_close(hd, oldest);
+  }
+  struct timeval rcv = {hd->cfg.recv_wait_timeout, 0};
+  struct timeval snd = {hd->cfg.send_wait_timeout, 0};
+  setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &rcv, sizeof(rcv));
+  setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &snd, sizeof(snd));
+  if (hd->cfg.open_fn && hd->cfg.open_fn(hd, fd) != ESP_OK) {
+    close(fd);
+    return;
+  }
+  httpd_sess *s = new httpd_sess();
+  s->fd = fd;
+  s->lru = esp_timer_get_time();
+  hd->sessions[fd] = s;
+}
+
+// ---------- Request ----------
+static httpd_req_t *req_new(sim_httpd *hd, httpd_sess *s) {
+  httpd_req_t *r = (httpd_req_t *)calloc(1, sizeof(httpd_req_t));
+  httpd_req_aux *ra = new httpd_req_aux();
+  ra->hd = hd;
+  ra->sess = s;
+  r->handle = hd;
+  r->aux = ra;
+  r->sess_ctx = s->ctx;
+  r->free_ctx = s->free_ctx;
+  return r;
+}
+
+static void req_free(httpd_req_t *r) {
+  delete aux_of(r);
+  free(r);
+}
+
+// Simpan perubahan sess_ctx dari handler ke sesi.
+static void req_sync_ctx(httpd_req_t *r) {
+  httpd_sess *s = aux_of(r)->sess;
+  if (!r->ignore_sess_ctx_changes) {
+    s->ctx = r->sess_ctx;
+    s->free_ctx = r->free_ctx;
+  }
+}
+
+static esp_err_t resp_err(httpd_req_t *r, httpd_err_code_t code) {
+  return httpd_resp_send_err(r, code, NULL);
+}
+
+static bool uri_match(sim_httpd *hd, const sim_uri &u, const char *uri, size_t len) {
+  if (hd->cfg.uri_match_fn) {
+    return hd->cfg.uri_match_fn(u.uri.c_str(), uri, len);
+  }
+  return u.uri.size() == len && strncmp(u.uri.c_str(), uri, len) == 0;
+}
+
+// Return false kalau sesi harus ditutup.
+static bool handle_request(sim_httpd *hd, httpd_sess *s) {
+  // header lengkap dulu
+  size_t end;
+  while ((end = s->inbuf.find("\r\n\r\n")) == std::string::npos) {
+    if (s->inbuf.size() > HTTPD_SIM_MAX_HDR) {
+      httpd_req_t *r = req_new(hd, s);
+      resp_err(r, HTTPD_431_REQ_HDR_FIELDS_TOO_LARGE);
+      req_free(r);
+      return false;
+    }
+    char buf[1024];
+    ssize_t n = recv(s->fd, buf, sizeof(buf), 0);
+    if (n <= 0) {
+      return false;  // ditutup klien atau recv_wait_timeout
+    }
+    s->inbuf.append(buf, n);
+  }
+  std::string head = s->inbuf.substr(0, end);
+  s->inbuf.erase(0, end + 4);
+  s->lru = esp_timer_get_time();
+
+  httpd_req_t *r = req_new(hd, s);
+  httpd_req_aux *ra = aux_of(r);
+
+  size_t eol = head.find("\r\n");
+  std::string line = head.substr(0, eol);
+  size_t sp1 = line.find(' ');
+  size_t sp2 = line.rfind(' ');
+  if (sp1 == std::string::npos || sp2 == sp1) {
+    resp_err(r, HTTPD_400_BAD_REQUEST);
+    req_free(r);
+    return false;
+  }
+  std::string method = line.substr(0, sp1);
+  std::string uri = line.substr(sp1 + 1, sp2 - sp1 - 1);
+  std::string version = line.substr(sp2 + 1);
+  if (version.compare(0, 7, "HTTP/1.") != 0) {
+    resp_err(r, HTTPD_505_VERSION_NOT_SUPPORTED);
+    req_free(r);
+    return false;
+  }
+  if (uri.size() > HTTPD_MAX_URI_LEN) {
+    resp_err(r, HTTPD_414_URI_TOO_LONG);
+    req_free(r);
+    return false;
+  }
+  r->method = method_from_str(method);
+  memcpy((char *)r->uri, uri.c_str(), uri.size() + 1);
+  size_t q = uri.find('?');
+  if (q != std::string::npos) {
+    ra->has_query = true;
+    ra->query = uri.substr(q + 1);
+  }
+
+  size_t pos = eol == std::string::npos ? head.size() : eol + 2;
+  while (pos < head.size()) {
+    size_t e = head.find("\r\n", pos);
+    if (e == std::string::npos) {
+      e = head.size();
+    }
+    std::string h = head.substr(pos, e - pos);
+    size_t colon = h.find(':');
+    if (colon != std::string::npos) {
+      std::string v = h.substr(colon + 1);
+      size_t b = v.find_first_not_of(" \t");
+      ra->req_hdrs.emplace_back(h.substr(0, colon), b == std::string::npos ? "" : v.substr(b));
+      if (strcasecmp(ra->req_hdrs.back().first.c_str(), "Content-Length") == 0) {
+        r->content_len = strtoul(ra->req_hdrs.back().second.c_str(), NULL, 10);
+      }
+    }
+    pos = e + 2;
+  }
+  ra->remaining = r->content_len;
+
+  if (r->method < 0) {
+    resp_err(r, HTTPD_501_METHOD_NOT_IMPLEMENTED);
+    req_free(r);
+    return false;
+  }
+
+  // cocokkan path tanpa query, lalu metode
+  size_t path_len = strcspn(r->uri, "?");
+  httpd_uri_t hit;
+  bool found = false;
+  bool path_hit = false;
+  {
+    std::lock_guard<std::mutex> lock(hd->mu);
+    for (const sim_uri &u : hd->uris) {
+      if (!uri_match(hd, u, r->uri, path_len)) {
+        continue;
+      }
+      path_hit = true;
+      if (u.h.method == r->method || (int)u.h.method == HTTP_ANY) {
+        hit = u.h;
+        found = true;
+        break;
+      }
+    }
+  }
+  esp_err_t res;
+  if (!found) {
+    res = resp_err(r, path_hit ? HTTPD_405_METHOD_NOT_ALLOWED : HTTPD_404_NOT_FOUND);
+  } else {
+    r->user_ctx = hit.user_ctx;
+    if (sim_verbose()) {
+      sim_log('I', __FILE__, __LINE__, __FUNCTION__, "fd=%d %s %s", s->fd, method.c_str(), r->uri);
+    }
+    res = hit.handler(r);
+    if (ra->handed_off) {
+      // sesi sekarang milik salinan async; server tidak menyentuhnya lagi
+      req_free(r);
+      return true;
+    }
+  }
+  req_sync_ctx(r);
+  bool keep = res == ESP_OK;
+  if (!keep && sim_verbose()) {
+    sim_log('W', __FILE__, __LINE__, __FUNCTION__, "handler %s gagal (0x%x), sesi ditutup", r->uri, res);
+  }
+  // buang sisa body yang tidak dibaca handler
+  while (keep && ra->remaining > 0) {
+    char buf[512];
+    int n = httpd_req_recv(r, buf, sizeof(buf));
+    if (n <= 0) {
+      keep = false;
+    }
+  }
+  req_free(r);
+  return keep;
+}
+
+// ---------- Thread server ----------
+static void server_loop(sim_httpd *hd) {
+  pthread_setname_np(pthread_self(), "httpd");
+  for (;;) {
+    fd_set rd;
+    FD_ZERO(&rd);
+    int maxfd = hd->wake[0];
+    FD_SET(hd->wake[0], &rd);
+    std::vector<httpd_sess *> ready;
+    {
+      std::lock_guard<std::mutex> lock(hd->mu);
+      if (hd->stop) {
+        break;
+      }
+      // tutup yang diminta, kecuali masih dipegang handler async
+      for (auto it = hd->sessions.begin(); it != hd->sessions.end();) {
+        httpd_sess *s = (it++)->second;
+        if (s->close_pending && !s->async) {
+          sess_close(hd, s);
+        }
+      }
+      if (hd->sessions.size() < hd->cfg.max_open_sockets || hd->cfg.lru_purge_enable) {
+        FD_SET(hd->listen_fd, &rd);
+        maxfd = std::max(maxfd, hd->listen_fd);
+      }
+      for (auto &kv : hd->sessions) {
+        if (!kv.second->async) {
+          FD_SET(kv.first, &rd);
+          maxfd = std::max(maxfd, kv.first);
+        }
+      }
+    }
+    if (select(maxfd + 1, &rd, NULL, NULL, NULL) < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      break;
+    }
+    if (FD_ISSET(hd->wake[0], &rd)) {
+      char buf[64];
+      (void)!read(hd->wake[0], buf, sizeof(buf));
+    }
+    // httpd_queue_work dijalankan di thread server
+    for (;;) {
+      std::pair<httpd_work_fn_t, void *> w;
+      {
+        std::lock_guard<std::mutex> lock(hd->mu);
+        if (hd->work.empty()) {
+          break;
+        }
+        w = hd->work.front();
+        hd->work.pop_front();
+      }
+      w.first(w.second);
+    }
+    if (FD_ISSET(hd->listen_fd, &rd)) {
+      sess_accept(hd);
+    }
+    {
+      std::lock_guard<std::mutex> lock(hd->mu);
+      for (auto &kv : hd->sessions) {
+        if (!kv.second->async && !kv.second->close_pending && FD_ISSET(kv.first, &rd)) {
+          ready.push_back(kv.second);
+        }
+      }
+    }
+    for (httpd_sess *s : ready) {
+      // request pipelined: layani selama masih ada data di buffer
+      bool keep;
+      do {
+        keep = handle_request(hd, s);
+      } while (keep && !s->async && !s->close_pending && !s->inbuf.empty());
+      if (!keep) {
+        std::lock_guard<std::mutex> lock(hd->mu);
+        if (s->async) {
+          s->close_pending = true;  // ditutup setelah handler async selesai
+        } else {
+          sess_close(hd, s);
+        }
+      }
+    }
+  }
+  std::lock_guard<std::mutex> lock(hd->mu);
+  while (!hd->sessions.empty()) {
+    sess_close(hd, hd->sessions.begin()->second);
+  }
+}
+
+// ---------- API server ----------
+extern "C" esp_err_t httpd_start(httpd_handle_t *handle, const httpd_config_t *config) {
+  if (!handle || !config) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  sim_httpd *hd = new sim_httpd();
+  hd->cfg = *config;
+  int port = sim_port(config->server_port);
+  hd->listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+  int one = 1;
+  setsockopt(hd->listen_fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+  struct sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_ANY);
+  addr.sin_port = htons((uint16_t)port);
+  if (hd->listen_fd < 0 || bind(hd->listen_fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 || listen(hd->listen_fd, config->backlog_conn) != 0 || pipe(hd->wake) != 0) {
+    sim_log('E', __FILE__, __LINE__, __FUNCTION__, "port %d: %s", port, strerror(errno));
+    if (hd->listen_fd >= 0) {
+      close(hd->listen_fd);
+    }
+    delete hd;
+    return ESP_ERR_HTTPD_TASK;
+  }
+  fcntl(hd->wake[0], F_SETFL, O_NONBLOCK);
+  if (sim_verbose()) {
+    sim_log('I', __FILE__, __LINE__, __FUNCTION__, "httpd :%d -> host :%d", config->server_port, port);
+  }
+  hd->thread = std::thread(server_loop, hd);
+  *handle = hd;
+  return ESP_OK;
+}
+
+extern "C" esp_err_t httpd_stop(httpd_handle_t handle) {
+  sim_httpd *hd = (sim_httpd *)handle;
+  if (!hd) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  {
+    std::lock_guard<std::mutex> lock(hd->mu);
+    hd->stop = true;
+  }
+  wake(hd);
+  hd->thread.join();
+  close(hd->listen_fd);
+  close(hd->wake[0]);
+  close(hd->wake[1]);
+  if (hd->cfg.global_user_ctx) {
+    if (hd->cfg.global_user_ctx_free_fn) {
+      hd->cfg.global_user_ctx_free_fn(hd->cfg.global_user_ctx);
+    } else {
+      free(hd->cfg.global_user_ctx);
+    }
+  }
+  delete hd;
+  return ESP_OK;
+}
+
+extern "C" esp_err_t httpd_register_uri_handler(httpd_handle_t handle, const httpd_uri_t *uri_handler) {
+  sim_httpd *hd = (sim_httpd *)handle;
+  if (!hd || !uri_handler || !uri_handler->uri) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  std::lock_guard<std::mutex> lock(hd->mu);
+  for (const sim_uri &u : hd->uris) {
+    if (u.uri == uri_handler->uri && u.h.method == uri_handler->method) {
+      return ESP_ERR_HTTPD_HANDLER_EXISTS;
+    }
+  }
+  if (hd->uris.size() >= hd->cfg.max_uri_handlers) {
+    sim_log('W', __FILE__, __LINE__, __FUNCTION__, "no slots left for registering handler %s (max_uri_handlers %u)", uri_handler->uri, hd->cfg.max_uri_handlers);
+    return ESP_ERR_HTTPD_HANDLERS_FULL;
+  }
+  sim_uri u;
+  u.uri = uri_handler->uri;
+  u.h = *uri_handler;
+  hd->uris.push_back(u);
+  return ESP_OK;
+}
+
+extern "C" esp_err_t httpd_unregister_uri_handler(httpd_handle_t handle, const char *uri, httpd_method_t method) {
+  sim_httpd *hd = (sim_httpd *)handle;
+  std::lock_guard<std::mutex> lock(hd->mu);
+  for (auto it = hd->uris.begin(); it != hd->uris.end(); ++it) {
+    if (it->uri == uri && it->h.method == method) {
+      hd->uris.erase(it);
+      return ESP_OK;
+    }
+  }
+  return ESP_ERR_NOT_FOUND;
+}
+
+extern "C" esp_err_t httpd_queue_work(httpd_handle_t handle, httpd_work_fn_t work, void *arg) {
+  sim_httpd *hd = (sim_httpd *)handle;
+  if (!hd || !work) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  {
+    std::lock_guard<std::mutex> lock(hd->mu);
+    hd->work.emplace_back(work, arg);
+  }
+  wake(hd);
+  return ESP_OK;
+}
+
+extern "C" void *httpd_get_global_user_ctx(httpd_handle_t handle) {
+  return handle ? ((sim_httpd *)handle)->cfg.global_user_ctx : NULL;
+}
+
+extern "C" bool httpd_uri_match_wildcard(const char *tpl, const char *uri, size_t len) {
+  size_t tpl_len = strlen(tpl);
+  if (tpl_len > 0 && tpl[tpl_len - 1] == '*') {
+    return len >= tpl_len - 1 && strncmp(tpl, uri, tpl_len - 1) == 0;
+  }
+  if (tpl_len > 0 && tpl[tpl_len - 1] == '?') {
+    return (len == tpl_len - 1 || len == tpl_len) && strncmp(tpl, uri, tpl_len - 1) == 0 && (len == tpl_len - 1 || uri[len - 1] == tpl[tpl_len - 2]);
+  }
+  return tpl_len == len && strncmp(tpl, uri, len) == 0;
+}
+
+extern "C" esp_err_t httpd_sess_trigger_close(httpd_handle_t handle, int sockfd) {
+  sim_httpd *hd = (sim_httpd *)handle;
+  {
+    std::lock_guard<std::mutex> lock(hd->mu);
+    auto it = hd->sessions.find(sockfd);
+    if (it == hd->sessions.end()) {
+      return ESP_ERR_NOT_FOUND;
+    }
+    it->second->close_pending = true;
+  }
+  wake(hd);
+  return ESP_OK;
+}
+
+// ---------- API request ----------
+extern "C" int httpd_req_recv(httpd_req_t *r, char *buf, size_t buf_len) {
+  httpd_req_aux *ra = aux_of(r);
+  size_t want = std::min(buf_len, ra->remaining);
+  if (want == 0) {
+    return 0;
+  }
+  httpd_sess *s = ra->sess;
+  if (!s->inbuf.empty()) {
+    size_t n = std::min(want, s->inbuf.size());
+    memcpy(buf, s->inbuf.data(), n);
+    s->inbuf.erase(0, n);
+    ra->remaining -= n;
+    return (int)n;
+  }
+  ssize_t n = recv(s->fd, buf, want, 0);
+  if (n < 0) {
+    return errno == EAGAIN || errno == EWOULDBLOCK ? HTTPD_SOCK_ERR_TIMEOUT : HTTPD_SOCK_ERR_FAIL;
+  }
+  ra->remaining -= n;
+  return (int)n;
+}
+
+static const std::string *find_hdr(httpd_req_t *r, const char *field) {
+  for (const auto &h : aux_of(r)->req_hdrs) {
+    if (strcasecmp(h.first.c_str(), field) == 0) {
+      return &h.second;
+    }
+  }
+  return nullptr;
+}
+
+static esp_err_t copy_out(const std::string &v, char *out, size_t cap) {
+  if (!out || cap == 0) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  size_t n = std::min(v.size(), cap - 1);
+  memcpy(out, v.data(), n);
+  out[n] = 0;
+  return n < v.size() ? ESP_ERR_HTTPD_RESULT_TRUNC : ESP_OK;
+}
+
+extern "C" size_t httpd_req_get_hdr_value_len(httpd_req_t *r, const char *field) {
+  const std::string *v = find_hdr(r, field);
+  return v ? v->size() : 0;
+}
+
+extern "C" esp_err_t httpd_req_get_hdr_value_str(httpd_req_t *r, const char *field, char *val, size_t val_size) {
+  const std::string *v = find_hdr(r, field);
+  if (!v) {
+    return ESP_ERR_NOT_FOUND;
+  }
+  return copy_out(*v, val, val_size);
+}
+
+extern "C" size_t httpd_req_get_url_query_len(httpd_req_t *r) {
+  return aux_of(r)->query.size();
+}
+
+extern "C" esp_err_t httpd_req_get_url_query_str(httpd_req_t *r, char *buf, size_t buf_len) {
+  httpd_req_aux *ra = aux_of(r);
+  if (!ra->has_query) {
+    return ESP_ERR_NOT_FOUND;
+  }
+  return copy_out(ra->query, buf, buf_len);
+}
+
+extern "C" esp_err_t httpd_query_key_value(const char *qry, const char *key, char *val, size_t val_size) {
+  if (!qry || !key || !val) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  size_t key_len = strlen(key);
+  const char *p = qry;
+  while (*p) {
+    const char *amp = strchr(p, '&');
+    const char *end = amp ? amp : p + strlen(p);
+    const char *eq = (const char *)memchr(p, '=', end - p);
+    if (eq && (size_t)(eq - p) == key_len && strncmp(p, key, key_len) == 0) {
+      return copy_out(std::string(eq + 1, end), val, val_size);
+    }
+    if (!amp) {
+      break;
+    }
+    p = amp + 1;
+  }
+  return ESP_ERR_NOT_FOUND;
+}
+
+extern "C" int httpd_req_to_sockfd(httpd_req_t *r) {
+  return r && r->aux ? aux_of(r)->sess->fd : -1;
+}
+
+extern "C" esp_err_t httpd_req_async_handler_begin(httpd_req_t *r, httpd_req_t **out) {
+  if (!r || !out) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  httpd_req_aux *ra = aux_of(r);
+  httpd_req_t *copy = (httpd_req_t *)malloc(sizeof(httpd_req_t));
+  memcpy((void *)copy, r, sizeof(httpd_req_t));  // uri const: salin mentah seperti IDF
+  copy->aux = new httpd_req_aux(*ra);
+  {
+    std::lock_guard<std::mutex> lock(ra->hd->mu);
+    ra->sess->async = true;
+  }
+  ra->handed_off = true;
+  *out = copy;
+  return ESP_OK;
+}
+
+extern "C" esp_err_t httpd_req_async_handler_complete(httpd_req_t *r) {
+  if (!r) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  httpd_req_aux *ra = aux_of(r);
+  sim_httpd *hd = ra->hd;
+  {
+    std::lock_guard<std::mutex> lock(hd->mu);
+    req_sync_ctx(r);
+    // body yang tidak dibaca membuat request berikutnya rusak: tutup saja
+    if (ra->remaining > 0) {
+      ra->sess->close_pending = true;
+    }
+    ra->sess->async = false;
+  }
+  req_free(r);
+  wake(hd);
+  return ESP_OK;
+}
+
+// ---------- API response ----------
+extern "C" esp_err_t httpd_resp_set_status(httpd_req_t *r, const char *status) {
+  aux_of(r)->status = status;
+  return ESP_OK;
+}
+
+extern "C" esp_err_t httpd_resp_set_type(httpd_req_t *r, const char *type) {
+  aux_of(r)->type = type;
+  return ESP_OK;
+}
+
+extern "C" esp_err_t httpd_resp_set_hdr(httpd_req_t *r, const char *field, const char *value) {
+  httpd_req_aux *ra = aux_of(r);
+  if (ra->resp_hdrs.size() >= ra->hd->cfg.max_resp_headers) {
+    return ESP_ERR_HTTPD_RESP_HDR;
+  }
+  ra->resp_hdrs.emplace_back(field, value);
+  return ESP_OK;
+}
+
+static std::string resp_head(httpd_req_aux *ra, const char *length_line) {
+  std::string h = "HTTP/1.1 " + ra->status + "\r\nContent-Type: " + ra->type + "\r\n" + length_line;
+  for (const auto &kv : ra->resp_hdrs) {
+    h += kv.first + ": " + kv.second + "\r\n";
+  }
+  h += "\r\n";
+  return h;
+}
+
+extern "C" esp_err_t httpd_resp_send(httpd_req_t *r, const char *buf, ssize_t buf_len) {
+  if (!r) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  httpd_req_aux *ra = aux_of(r);
+  if (buf_len == HTTPD_RESP_USE_STRLEN) {
+    buf_len = buf ? (ssize_t)strlen(buf) : 0;
+  }
+  char len_line[48];
+  snprintf(len_line, sizeof(len_line), "Content-Length: %d\r\n", (int)buf_len);
+  // header dan body dua send terpisah, seperti IDF
+  if (!send_str(ra->sess->fd, resp_head(ra, len_line))) {
+    return ESP_ERR_HTTPD_RESP_SEND;
+  }
+  if (buf && buf_len > 0 && !send_all(ra->sess->fd, buf, buf_len)) {
+    return ESP_ERR_HTTPD_RESP_SEND;
+  }
+  return ESP_OK;
+}
+
+extern "C" esp_err_t httpd_resp_send_chunk(httpd_req_t *r, const char *buf, ssize_t buf_len) {
+  if (!r) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  httpd_req_aux *ra = aux_of(r);
+  if (buf_len == HTTPD_RESP_USE_STRLEN) {
+    buf_len = buf ? (ssize_t)strlen(buf) : 0;
+  }
+  if (!ra->first_chunk_sent) {
+    if (!send_str(ra->sess->fd, resp_head(ra, "Transfer-Encoding: chunked\r\n"))) {
+      return ESP_ERR_HTTPD_RESP_SEND;
+    }
+    ra->first_chunk_sent = true;
+  }
+  // ukuran, data, CRLF: tiga send per chunk seperti IDF
+  char len_str[16];
+  snprintf(len_str, sizeof(len_str), "%x\r\n", (unsigned)buf_len);
+  if (!send_all(ra->sess->fd, len_str, strlen(len_str))) {
+    return ESP_ERR_HTTPD_RESP_SEND;
+  }
+  if (buf && buf_len > 0 && !send_all(ra->sess->fd, buf, buf_len)) {
+    return ESP_ERR_HTTPD_RESP_SEND;
+  }
+  if (!send_all(ra->sess->fd, "\r\n", 2)) {
+    return ESP_ERR_HTTPD_RESP_SEND;
+  }
+  return ESP_OK;
+}
+
+extern "C" esp_err_t httpd_resp_send_err(httpd_req_t *req, httpd_err_code_t error, const char *msg) {
+  static const struct {
+    const char *status;
+    const char *msg;
+  } table[HTTPD_ERR_CODE_MAX] = {
+      {"500 Internal Server Error", "Server has encountered an unexpected error"},
+      {"501 Method Not Implemented", "Server does not support this method"},
+      {"505 Version Not Supported", "HTTP version not supported by server"},
+      {"400 Bad Request", "Bad request syntax"},
+      {"401 Unauthorized", "No permission -- see authorization schemes"},
+      {"403 Forbidden", "Request forbidden -- authorization will not help"},
+      {"404 Not Found", "Nothing matches the given URI"},
+      {"405 Method Not Allowed", "Specified method is invalid for this resource"},
+      {"408 Request Timeout", "Server closed this connection"},
+      {"411 Length Required", "Client must specify Content-Length"},
+      {"414 URI Too Long", "URI is too long"},
+      {"431 Request Header Fields Too Large", "Header fields are too long"},
+  };
+  if (error < 0 || error >= HTTPD_ERR_CODE_MAX) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  httpd_resp_set_status(req, table[error].status);
+  httpd_resp_set_type(req, HTTPD_TYPE_TEXT);
+  return httpd_resp_send(req, msg ? msg : table[error].msg, HTTPD_RESP_USE_STRLEN);
+}
+
+extern "C" int httpd_send(httpd_req_t *r, const char *buf, size_t buf_len) {
+  if (!r || !buf) {
+    return HTTPD_SOCK_ERR_INVALID;
+  }
+  return sock_send(aux_of(r)->sess->fd, buf, buf_len);
+}
@@ -0,0 +1,254 @@
+// Stand-in I2SClass (ESP_I2S, dipakai 5_3.ino) untuk simulator host. Sampel
+// diberi jarak real-time dari sample rate, jadi task audio berjalan dengan
+// tempo yang sama seperti di board. Driver legacy ada di i2s_legacy.cpp
+// (header keduanya bentrok di i2s_mode_t, sama seperti di IDF).
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <mutex>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "ESP_I2S.h"
+#include "esp32-hal-log.h"
+#include "esp_timer.h"
+#include "sim.h"
+
+// "DMA" RX menyimpan sampel sebanyak ini; task yang telat lebih lama
+// kehilangan sampel seperti overflow DMA di board.
+#define I2S_SIM_RX_BACKLOG_US 100000
+
+// ---------- Sumber sinyal RX ----------
+struct I2SClass::Source {
+  std::vector<int16_t> wav;  // kosong = sintetis
+  size_t wav_pos = 0;
+  std::mt19937 rng;
+  std::string pending;       // sisa byte untuk read()/peek()
+
+  // Satu sampel mono PCM16 ke-n.
+  int16_t sample(uint64_t n, uint32_t rate) {
+    if (!wav.empty()) {
+      int16_t v = wav[wav_pos];
+      wav_pos = (wav_pos + 1) % wav.size();
+      return v;
+    }
+    // nada 440 Hz yang timbul-tenggelam tiap 2 s + derau kecil
+    double t = (double)n / rate;
+    double env = 0.5 + 0.5 * sin(2 * M_PI * 0.5 * t);
+    double v = 3000.0 * env * sin(2 * M_PI * 440.0 * t) + (double)((int)(rng() % 201) - 100);
+    return (int16_t)v;
+  }
+};
+
+// WAV PCM16 (kanal pertama saja). Tanpa resample: rate file diabaikan.
+static bool load_wav(const char *path, std::vector<int16_t> *out) {
+  FILE *f = fopen(path, "rb");
+  if (!f) {
+    return false;
+  }
+  std::vector<uint8_t> d;
+  uint8_t buf[65536];
+  size_t n;
+  while ((n = fread(buf, 1, sizeof(buf), f)) > 0) {
+    d.insert(d.end(), buf, buf + n);
+  }
+  fclose(f);
+  if (d.size() < 12 || memcmp(&d[0], "RIFF", 4) != 0 || memcmp(&d[8], "WAVE", 4) != 0) {
+    return false;
+  }
+  int channels = 1, bits = 16;
+  for (size_t p = 12; p + 8 <= d.size();) {
+    uint32_t len = d[p + 4] | d[p + 5] << 8 | d[p + 6] << 16 | (uint32_t)d[p + 7] << 24;
+    if (memcmp(&d[p], "fmt ", 4) == 0 && p + 24 <= d.size()) {
+      channels = d[p + 10] | d[p + 11] << 8;
+      bits = d[p + 22] | d[p + 23] << 8;
+    } else if (memcmp(&d[p], "data", 4) == 0) {
+      if (bits != 16 || channels < 1) {
+        return false;
+      }
+      size_t end = p + 8 + len < d.size() ? p + 8 + len : d.size();
+      for (size_t i = p + 8; i + 2 * channels <= end; i += 2 * channels) {
+        out->push_back((int16_t)(d[i] | d[i + 1] << 8));
+      }
+      return !out->empty();
+    }
+    p += 8 + len + (len & 1);
+  }
+  return false;
+}
+
+I2SClass::I2SClass() {}
+
+I2SClass::~I2SClass() {
+  end();
+}
+
+void I2SClass::setPins(int8_t bclk, int8_t ws, int8_t dout, int8_t din, int8_t mclk) {
+  (void)bclk;
+  (void)ws;
+  (void)dout;
+  (void)mclk;
+  din_ = din;
+}
+
+void I2SClass::setPinsPdmTx(int8_t clk, int8_t dout0, int8_t dout1) {
+  (void)clk;
+  (void)dout0;
+  (void)dout1;
+}
+
+void I2SClass::setPinsPdmRx(int8_t clk, int8_t din0, int8_t din1, int8_t din2, int8_t din3) {
+  (void)clk;
+  (void)din1;
+  (void)din2;
+  (void)din3;
+  din_ = din0;
+}
+
+bool I2SClass::begin(i2s_mode_t mode, uint32_t rate, i2s_data_bit_width_t bits_cfg, i2s_slot_mode_t ch, int8_t slot_mask) {
+  (void)slot_mask;
+  end();
+  if (rate == 0 || (mode == I2S_MODE_PDM_RX && din_ < 0)) {
+    last_error_ = ESP_ERR_INVALID_ARG;
+    log_e("I2S begin: invalid rate or DATA pin");
+    return false;
+  }
+  mode_ = mode;
+  rate_ = rate;
+  bytes_ = bits_cfg / 8;
+  channels_ = ch;
+  src_ = new Source;
+  src_->rng.seed((uint32_t)sim_env_int("SIM_SEED", 1));
+  const char *wav = sim_env("SIM_I2S_WAV", "");
+  if (*wav && !load_wav(wav, &src_->wav)) {
+    log_w("SIM_I2S_WAV %s: not a PCM16 WAV, using synthetic tone", wav);
+  }
+  t0_us_ = esp_timer_get_time();
+  frames_ = 0;
+  last_error_ = 0;
+  if (sim_verbose()) {
+    log_i("I2S begin mode %d, %u Hz, %d bit, %d ch, DATA=%d", mode, rate, bits_cfg, ch, din_);
+  }
+  return true;
+}
+
+bool I2SClass::end() {
+  delete src_;
+  src_ = nullptr;
+  return true;
+}
+
+int I2SClass::available() {
+  if (!src_) {
+    return 0;
+  }
+  int64_t ready = (esp_timer_get_time() - t0_us_) * rate_ / 1000000 - (int64_t)frames_;
+  return (int)src_->pending.size() + (ready > 0 ? (int)ready * bytes_ * channels_ : 0);
+}
+
+int I2SClass::read() {
+  char c;
+  return readBytes(&c, 1) == 1 ? (uint8_t)c : -1;
+}
+
+int I2SClass::peek() {
+  if (!src_) {
+    return -1;
+  }
+  if (src_->pending.empty()) {
+    std::string frame(bytes_ * channels_, '\0');
+    if (!fill(&frame[0], frame.size())) {
+      return -1;
+    }
+    src_->pending = frame;
+  }
+  return (uint8_t)src_->pending[0];
+}
+
+size_t I2SClass::readBytes(char *buffer, size_t size) {
+  if (!src_ || mode_ == I2S_MODE_PDM_TX) {
+    return 0;
+  }
+  size_t done = 0;
+  if (!src_->pending.empty()) {
+    done = size < src_->pending.size() ? size : src_->pending.size();
+    memcpy(buffer, src_->pending.data(), done);
+    src_->pending.erase(0, done);
+  }
+  size_t frame = bytes_ * channels_;
+  size_t whole = (size - done) / frame * frame;
+  if (whole && fill(buffer + done, whole)) {
+    done += whole;
+  }
+  if (done < size && (size - done) < frame) {
+    std::string f(frame, '\0');
+    if (fill(&f[0], frame)) {
+      memcpy(buffer + done, f.data(), size - done);
+      src_->pending.assign(f, size - done, std::string::npos);
+      done = size;
+    }
+  }
+  return done;
+}
+
+// Blok sampai size byte "terekam", lalu isi sampel berikutnya.
+bool I2SClass::fill(char *buffer, size_t size) {
+  size_t n = size / (bytes_ * channels_);
+  int64_t now = esp_timer_get_time();
+  int64_t behind = now - (t0_us_ + (int64_t)(frames_ * 1000000 / rate_));
+  if (behind > I2S_SIM_RX_BACKLOG_US) {
+    // overflow DMA: sampel lama hilang
+    frames_ += (uint64_t)((behind - I2S_SIM_RX_BACKLOG_US) * rate_ / 1000000);
+  }
+  int64_t due = t0_us_ + (int64_t)((frames_ + n) * 1000000 / rate_);
+  sim_sleep_us(due - esp_timer_get_time());
+
+  static long dead_pin = sim_env_int("SIM_I2S_DEAD_PIN", -1);
+  bool dead = din_ == dead_pin;
+  for (size_t i = 0; i < n; i++) {
+    int16_t s = dead ? 0 : src_->sample(frames_ + i, rate_);
+    for (int c = 0; c < channels_; c++) {
+      char *p = buffer + (i * channels_ + c) * bytes_;
+      switch (bytes_) {
+        case 4: {
+          int32_t v = (int32_t)s << 16;
+          memcpy(p, &v, 4);
+          break;
+        }
+        case 3:
+          p[0] = 0;
+          p[1] = (char)(s & 0xFF);
+          p[2] = (char)(s >> 8);
+          break;
+        case 2:
+          memcpy(p, &s, 2);
+          break;
+        default:
+          p[0] = (char)(s >> 8);
+          break;
+      }
+    }
+  }
+  frames_ += n;
+  return true;
+}
+
+size_t I2SClass::write(const uint8_t *buffer, size_t size) {
+  if (!src_ || mode_ == I2S_MODE_PDM_RX) {
+    return 0;
+  }
+  size_t n = size / (bytes_ * channels_);
+  int64_t now = esp_timer_get_time();
+  if (t0_us_ + (int64_t)(frames_ * 1000000 / rate_) < now) {
+    // underrun: DMA memutar senyap, mulai lagi dari sekarang
+    t0_us_ = now;
+    frames_ = 0;
+  }
+  frames_ += n;
+  sim_sleep_us(t0_us_ + (int64_t)(frames_ * 1000000 / rate_) - I2S_SIM_RX_BACKLOG_US - esp_timer_get_time());
+  (void)buffer;
+  return n * bytes_ * channels_;
+}
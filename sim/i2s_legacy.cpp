@@ -0,0 +1,150 @@
+// Stand-in driver I2S legacy (driver/i2s.h, dipakai receiver_fix.ino) untuk
+// simulator host: i2s_write diberi jarak real-time lewat kedalaman DMA.
+#include <stdint.h>
+#include <stdio.h>
+
+#include <mutex>
+
+#include "driver/i2s.h"
+#include "esp32-hal-log.h"
+#include "esp_timer.h"
+#include "sim.h"
+
+namespace {
+
+struct LegacyPort {
+  bool installed = false;
+  bool started = false;
+  i2s_config_t cfg;
+  size_t frame_bytes = 2;
+  int64_t t0_us = 0;
+  uint64_t written = 0;  // frame sejak t0
+  FILE *out = NULL;
+};
+
+std::mutex _i2s_mu;
+LegacyPort _ports[I2S_NUM_MAX];
+
+}  // namespace
+
+extern "C" esp_err_t i2s_driver_install(i2s_port_t port, const i2s_config_t *config, int queue_size, void *queue) {
+  (void)queue_size;
+  (void)queue;
+  if (port >= I2S_NUM_MAX || !config || config->sample_rate == 0 || config->dma_buf_count < 2 || config->dma_buf_len < 8) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  std::lock_guard<std::mutex> lock(_i2s_mu);
+  LegacyPort &p = _ports[port];
+  if (p.installed) {
+    return ESP_ERR_INVALID_STATE;
+  }
+  p.cfg = *config;
+  int channels = config->channel_format == I2S_CHANNEL_FMT_RIGHT_LEFT ? 2 : 1;
+  p.frame_bytes = (size_t)(config->bits_per_sample / 8) * channels;
+  p.installed = true;
+  const char *out = sim_env("SIM_I2S_OUT", "");
+  if (*out && (config->mode & I2S_MODE_TX)) {
+    p.out = fopen(out, "wb");
+    if (!p.out) {
+      log_w("SIM_I2S_OUT %s: cannot open", out);
+    }
+  }
+  log_i("i2s%d: %u Hz, %d bit, %d ch, DMA %d x %d", port, config->sample_rate, config->bits_per_sample, channels,
+        config->dma_buf_count, config->dma_buf_len);
+  return ESP_OK;
+}
+
+extern "C" esp_err_t i2s_driver_uninstall(i2s_port_t port) {
+  if (port >= I2S_NUM_MAX) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  std::lock_guard<std::mutex> lock(_i2s_mu);
+  LegacyPort &p = _ports[port];
+  if (!p.installed) {
+    return ESP_ERR_INVALID_STATE;
+  }
+  if (p.out) {
+    fclose(p.out);
+  }
+  p = LegacyPort();
+  return ESP_OK;
+}
+
+extern "C" esp_err_t i2s_set_pin(i2s_port_t port, const i2s_pin_config_t *pin) {
+  (void)pin;
+  return port < I2S_NUM_MAX && _ports[port].installed ? ESP_OK : ESP_ERR_INVALID_STATE;
+}
+
+extern "C" esp_err_t i2s_start(i2s_port_t port) {
+  if (port >= I2S_NUM_MAX) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  std::lock_guard<std::mutex> lock(_i2s_mu);
+  LegacyPort &p = _ports[port];
+  if (!p.installed) {
+    return ESP_ERR_INVALID_STATE;
+  }
+  p.started = true;
+  p.t0_us = esp_timer_get_time();
+  p.written = 0;
+  return ESP_OK;
+}
+
+extern "C" esp_err_t i2s_stop(i2s_port_t port) {
+  if (port >= I2S_NUM_MAX) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  std::lock_guard<std::mutex> lock(_i2s_mu);
+  _ports[port].started = false;
+  return ESP_OK;
+}
+
+extern "C" esp_err_t i2s_zero_dma_buffer(i2s_port_t port) {
+  if (port >= I2S_NUM_MAX) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  std::lock_guard<std::mutex> lock(_i2s_mu);
+  LegacyPort &p = _ports[port];
+  p.t0_us = esp_timer_get_time();
+  p.written = 0;
+  return ESP_OK;
+}
+
+// Blok selama antrean DMA (dma_buf_count x dma_buf_len frame) penuh.
+extern "C" esp_err_t i2s_write(i2s_port_t port, const void *src, size_t size, size_t *bytes_written, TickType_t ticks_to_wait) {
+  *bytes_written = 0;
+  if (port >= I2S_NUM_MAX) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  std::unique_lock<std::mutex> lock(_i2s_mu);
+  LegacyPort &p = _ports[port];
+  if (!p.installed || !(p.cfg.mode & I2S_MODE_TX)) {
+    return ESP_ERR_INVALID_STATE;
+  }
+  uint64_t depth = (uint64_t)p.cfg.dma_buf_count * p.cfg.dma_buf_len;
+  uint64_t frames = size / p.frame_bytes;
+  int64_t now = esp_timer_get_time();
+  uint64_t played = (uint64_t)((now - p.t0_us) * p.cfg.sample_rate / 1000000);
+  if (!p.started || played > p.written) {
+    // DMA kosong (underrun): hitung ulang dari sekarang
+    p.t0_us = now;
+    p.written = 0;
+    played = 0;
+  }
+  if (p.written + frames > depth + played) {
+    int64_t free_at = p.t0_us + (int64_t)((p.written + frames - depth) * 1000000 / p.cfg.sample_rate);
+    int64_t limit = ticks_to_wait == portMAX_DELAY ? INT64_MAX : now + (int64_t)ticks_to_wait * 1000000 / configTICK_RATE_HZ;
+    if (free_at > limit) {
+      return ESP_ERR_TIMEOUT;
+    }
+    lock.unlock();
+    sim_sleep_us(free_at - now);
+    lock.lock();
+  }
+  p.written += frames;
+  if (p.out) {
+    fwrite(src, 1, frames * p.frame_bytes, p.out);
+  }
+  *bytes_written = frames * p.frame_bytes;
+  return ESP_OK;
+}
@@ -0,0 +1,454 @@
+// img_converters + esp_jpg_decode esp32-camera untuk simulator host, dengan
+// libjpeg. Konversi piksel mentah disalin dari to_bmp.c/yuv.c (sama dengan
+// tools/bmp_check.cpp), jadi "rgb888" tetap urutan B, G, R. Decode JPEG
+// memakai libjpeg, bukan tjpgd: piksel bisa berbeda beberapa LSB dari board,
+// urutan dan ukuran blok MCU ke writer tetap seperti tjpgd.
+#include <setjmp.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Arduino.h sudah punya typedef boolean (bool); libjpeg butuh int.
+#define boolean jpeg_boolean
+#include <jpeglib.h>
+#undef boolean
+
+#include <vector>
+
+#include "esp_camera.h"
+#include "esp_jpg_decode.h"
+#include "img_converters.h"
+
+#define JPG_CB_CHUNK 1024
+
+// ---------- Piksel mentah ----------
+static uint8_t clamp8(int v) {
+  return v < 0 ? 0 : v > 255 ? 255 : v;
+}
+
+static void yuv2rgb(uint8_t y, uint8_t u, uint8_t v, uint8_t *r, uint8_t *g, uint8_t *b) {
+  int yy = (int)(1.164 * (y - 16)), du = u - 128, dv = v - 128;
+  *r = clamp8(yy + (int)(1.596 * dv));
+  *g = clamp8(yy - (int)(0.391 * du) - (int)(0.813 * dv));
+  *b = clamp8(yy + (int)(2.018 * du));
+}
+
+static size_t bytes_per_pixel(pixformat_t format) {
+  switch (format) {
+    case PIXFORMAT_GRAYSCALE: return 1;
+    case PIXFORMAT_RGB565:
+    case PIXFORMAT_YUV422: return 2;
+    case PIXFORMAT_RGB888: return 3;
+    default: return 0;
+  }
+}
+
+// Sumber mentah -> B, G, R (src_len boleh sepotong frame).
+static bool raw2bgr(const uint8_t *src, size_t src_len, pixformat_t format, uint8_t *rgb) {
+  switch (format) {
+    case PIXFORMAT_RGB888:
+      memcpy(rgb, src, src_len);
+      return true;
+    case PIXFORMAT_GRAYSCALE:
+      for (size_t i = 0; i < src_len; i++) {
+        *rgb++ = src[i];
+        *rgb++ = src[i];
+        *rgb++ = src[i];
+      }
+      return true;
+    case PIXFORMAT_RGB565:
+      for (size_t i = 0; i + 1 < src_len; i += 2) {
+        uint8_t hb = src[i], lb = src[i + 1];
+        *rgb++ = (lb & 0x1F) << 3;
+        *rgb++ = (hb & 0x07) << 5 | (lb & 0xE0) >> 3;
+        *rgb++ = hb & 0xF8;
+      }
+      return true;
+    case PIXFORMAT_YUV422: {
+      uint8_t r, g, b;
+      for (size_t i = 0; i + 3 < src_len; i += 4) {
+        uint8_t y0 = src[i], u = src[i + 1], y1 = src[i + 2], v = src[i + 3];
+        yuv2rgb(y0, u, v, &r, &g, &b);
+        *rgb++ = b;
+        *rgb++ = g;
+        *rgb++ = r;
+        yuv2rgb(y1, u, v, &r, &g, &b);
+        *rgb++ = b;
+        *rgb++ = g;
+        *rgb++ = r;
+      }
+      return true;
+    }
+    default:
+      return false;
+  }
+}
+
+// ---------- libjpeg ----------
+struct jpg_err {
+  struct jpeg_error_mgr mgr;
+  jmp_buf jmp;
+};
+
+static void jpg_error_exit(j_common_ptr cinfo) {
+  longjmp(((jpg_err *)cinfo->err)->jmp, 1);
+}
+
+static void jpg_silent(j_common_ptr cinfo, int level) {
+  (void)cinfo;
+  (void)level;
+}
+
+// Decode penuh ke R, G, B (atau gray kalau gray=true).
+static bool jpg_decode(const uint8_t *src, size_t len, int scale_denom, std::vector<uint8_t> *out, int *w, int *h, int *mcu_w, int *mcu_h) {
+  struct jpeg_decompress_struct cinfo;
+  jpg_err err;
+  cinfo.err = jpeg_std_error(&err.mgr);
+  err.mgr.error_exit = jpg_error_exit;
+  err.mgr.emit_message = jpg_silent;
+  if (setjmp(err.jmp)) {
+    jpeg_destroy_decompress(&cinfo);
+    return false;
+  }
+  jpeg_create_decompress(&cinfo);
+  jpeg_mem_src(&cinfo, src, (unsigned long)len);
+  if (jpeg_read_header(&cinfo, TRUE) != JPEG_HEADER_OK) {
+    jpeg_destroy_decompress(&cinfo);
+    return false;
+  }
+  if (mcu_w) {
+    int hs = cinfo.num_components > 1 ? cinfo.comp_info[0].h_samp_factor : 1;
+    int vs = cinfo.num_components > 1 ? cinfo.comp_info[0].v_samp_factor : 1;
+    *mcu_w = 8 * hs;
+    *mcu_h = 8 * vs;
+  }
+  cinfo.out_color_space = JCS_RGB;
+  cinfo.scale_num = 1;
+  cinfo.scale_denom = scale_denom;
+  jpeg_start_decompress(&cinfo);
+  *w = cinfo.output_width;
+  *h = cinfo.output_height;
+  out->resize((size_t)*w * *h * 3);
+  while (cinfo.output_scanline < cinfo.output_height) {
+    JSAMPROW row = &(*out)[(size_t)cinfo.output_scanline * *w * 3];
+    jpeg_read_scanlines(&cinfo, &row, 1);
+  }
+  jpeg_finish_decompress(&cinfo);
+  jpeg_destroy_decompress(&cinfo);
+  return true;
+}
+
+struct jpg_cb_dest {
+  struct jpeg_destination_mgr pub;
+  jpg_out_cb cb;
+  void *arg;
+  size_t index;
+  bool failed;
+  JOCTET buf[JPG_CB_CHUNK];
+};
+
+static void dest_init(j_compress_ptr cinfo) {
+  jpg_cb_dest *d = (jpg_cb_dest *)cinfo->dest;
+  d->pub.next_output_byte = d->buf;
+  d->pub.free_in_buffer = JPG_CB_CHUNK;
+}
+
+static bool dest_flush(jpg_cb_dest *d, size_t len) {
+  if (len == 0 || d->failed) {
+    return !d->failed;
+  }
+  if (d->cb(d->arg, d->index, d->buf, len) != len) {
+    d->failed = true;
+    return false;
+  }
+  d->index += len;
+  return true;
+}
+
+static jpeg_boolean dest_empty(j_compress_ptr cinfo) {
+  jpg_cb_dest *d = (jpg_cb_dest *)cinfo->dest;
+  dest_flush(d, JPG_CB_CHUNK);
+  d->pub.next_output_byte = d->buf;
+  d->pub.free_in_buffer = JPG_CB_CHUNK;
+  return TRUE;
+}
+
+static void dest_term(j_compress_ptr cinfo) {
+  jpg_cb_dest *d = (jpg_cb_dest *)cinfo->dest;
+  dest_flush(d, JPG_CB_CHUNK - d->pub.free_in_buffer);
+}
+
+extern "C" bool fmt2jpg_cb(uint8_t *src, size_t src_len, uint16_t width, uint16_t height, pixformat_t format, uint8_t quality, jpg_out_cb cb, void *arg) {
+  size_t bpp = bytes_per_pixel(format);
+  if (!bpp || src_len < (size_t)width * height * bpp) {
+    return false;
+  }
+  struct jpeg_compress_struct cinfo;
+  jpg_err err;
+  jpg_cb_dest dest;
+  std::vector<uint8_t> row((size_t)width * 3);
+  cinfo.err = jpeg_std_error(&err.mgr);
+  err.mgr.error_exit = jpg_error_exit;
+  err.mgr.emit_message = jpg_silent;
+  if (setjmp(err.jmp)) {
+    jpeg_destroy_compress(&cinfo);
+    return false;
+  }
+  jpeg_create_compress(&cinfo);
+  memset(&dest, 0, sizeof(dest.pub));
+  dest.pub.init_destination = dest_init;
+  dest.pub.empty_output_buffer = dest_empty;
+  dest.pub.term_destination = dest_term;
+  dest.cb = cb;
+  dest.arg = arg;
+  dest.index = 0;
+  dest.failed = false;
+  cinfo.dest = &dest.pub;
+  cinfo.image_width = width;
+  cinfo.image_height = height;
+  bool gray = format == PIXFORMAT_GRAYSCALE;
+  cinfo.input_components = gray ? 1 : 3;
+  cinfo.in_color_space = gray ? JCS_GRAYSCALE : JCS_RGB;
+  jpeg_set_defaults(&cinfo);
+  jpeg_set_quality(&cinfo, quality, TRUE);
+  jpeg_start_compress(&cinfo, TRUE);
+  size_t stride = (size_t)width * bpp;
+  std::vector<uint8_t> bgr((size_t)width * 3);
+  while (cinfo.next_scanline < cinfo.image_height && !dest.failed) {
+    const uint8_t *line = src + stride * cinfo.next_scanline;
+    JSAMPROW p;
+    if (gray) {
+      p = (JSAMPROW)line;
+    } else {
+      raw2bgr(line, stride, format, bgr.data());
+      for (size_t x = 0; x < width; x++) {
+        row[x * 3] = bgr[x * 3 + 2];
+        row[x * 3 + 1] = bgr[x * 3 + 1];
+        row[x * 3 + 2] = bgr[x * 3];
+      }
+      p = row.data();
+    }
+    jpeg_write_scanlines(&cinfo, &p, 1);
+  }
+  if (dest.failed) {
+    jpeg_abort_compress(&cinfo);
+    jpeg_destroy_compress(&cinfo);
+    return false;
+  }
+  jpeg_finish_compress(&cinfo);
+  jpeg_destroy_compress(&cinfo);
+  return !dest.failed;
+}
+
+extern "C" bool frame2jpg_cb(camera_fb_t *fb, uint8_t quality, jpg_out_cb cb, void *arg) {
+  return fmt2jpg_cb(fb->buf, fb->len, fb->width, fb->height, fb->format, quality, cb, arg);
+}
+
+struct mem_out {
+  uint8_t *buf;
+  size_t len;
+  size_t cap;
+};
+
+static size_t mem_cb(void *arg, size_t index, const void *data, size_t len) {
+  mem_out *m = (mem_out *)arg;
+  if (index + len > m->cap) {
+    size_t cap = (index + len) * 2;
+    uint8_t *p = (uint8_t *)realloc(m->buf, cap);
+    if (!p) {
+      return 0;
+    }
+    m->buf = p;
+    m->cap = cap;
+  }
+  memcpy(m->buf + index, data, len);
+  m->len = index + len;
+  return len;
+}
+
+extern "C" bool fmt2jpg(uint8_t *src, size_t src_len, uint16_t width, uint16_t height, pixformat_t format, uint8_t quality, uint8_t **out, size_t *out_len) {
+  mem_out m = {NULL, 0, 0};
+  if (!fmt2jpg_cb(src, src_len, width, height, format, quality, mem_cb, &m)) {
+    free(m.buf);
+    return false;
+  }
+  *out = m.buf;
+  *out_len = m.len;
+  return true;
+}
+
+extern "C" bool frame2jpg(camera_fb_t *fb, uint8_t quality, uint8_t **out, size_t *out_len) {
+  return fmt2jpg(fb->buf, fb->len, fb->width, fb->height, fb->format, quality, out, out_len);
+}
+
+// ---------- BMP (to_bmp.c) ----------
+#define BMP_HEADER_LEN 54
+
+typedef struct __attribute__((packed)) {
+  uint32_t filesize;
+  uint32_t reserved;
+  uint32_t fileoffset_to_pixelarray;
+  uint32_t dibheadersize;
+  int32_t width;
+  int32_t height;
+  uint16_t planes;
+  uint16_t bitsperpixel;
+  uint32_t compression;
+  uint32_t imagesize;
+  uint32_t ypixelspermeter;
+  uint32_t xpixelspermeter;
+  uint32_t numcolorspallette;
+  uint32_t mostimpcolor;
+} bmp_header_t;
+
+static uint8_t *bmp_alloc(uint16_t w, uint16_t h, int bpp, size_t *out_len) {
+  size_t palette = bpp == 1 ? 1024 : 0;
+  size_t len = (size_t)w * h * bpp + BMP_HEADER_LEN + palette;
+  uint8_t *out = (uint8_t *)calloc(1, len);
+  if (!out) {
+    return NULL;
+  }
+  out[0] = 'B';
+  out[1] = 'M';
+  bmp_header_t *b = (bmp_header_t *)&out[2];
+  b->filesize = (uint32_t)len;
+  b->fileoffset_to_pixelarray = (uint32_t)(BMP_HEADER_LEN + palette);
+  b->dibheadersize = 40;
+  b->width = w;
+  b->height = -h;
+  b->planes = 1;
+  b->bitsperpixel = (uint16_t)(bpp * 8);
+  b->imagesize = (uint32_t)w * h * bpp;
+  b->ypixelspermeter = 0x0B13;
+  b->xpixelspermeter = 0x0B13;
+  for (size_t i = 0; i < palette / 4; i++) {
+    out[BMP_HEADER_LEN + i * 4] = out[BMP_HEADER_LEN + i * 4 + 1] = out[BMP_HEADER_LEN + i * 4 + 2] = (uint8_t)i;
+  }
+  *out_len = len;
+  return out;
+}
+
+extern "C" bool fmt2rgb888(const uint8_t *src_buf, size_t src_len, pixformat_t format, uint8_t *rgb_buf) {
+  if (format != PIXFORMAT_JPEG) {
+    return raw2bgr(src_buf, src_len, format, rgb_buf);
+  }
+  std::vector<uint8_t> rgb;
+  int w, h;
+  if (!jpg_decode(src_buf, src_len, 1, &rgb, &w, &h, NULL, NULL)) {
+    return false;
+  }
+  for (size_t i = 0; i < rgb.size(); i += 3) {
+    rgb_buf[i] = rgb[i + 2];
+    rgb_buf[i + 1] = rgb[i + 1];
+    rgb_buf[i + 2] = rgb[i];
+  }
+  return true;
+}
+
+extern "C" bool fmt2bmp(uint8_t *src, size_t src_len, uint16_t width, uint16_t height, pixformat_t format, uint8_t **out, size_t *out_len) {
+  if (format == PIXFORMAT_JPEG) {
+    std::vector<uint8_t> rgb;
+    int w, h;
+    if (!jpg_decode(src, src_len, 1, &rgb, &w, &h, NULL, NULL)) {
+      return false;
+    }
+    uint8_t *bmp = bmp_alloc((uint16_t)w, (uint16_t)h, 3, out_len);
+    if (!bmp) {
+      return false;
+    }
+    for (size_t i = 0; i < rgb.size(); i += 3) {
+      bmp[BMP_HEADER_LEN + i] = rgb[i + 2];
+      bmp[BMP_HEADER_LEN + i + 1] = rgb[i + 1];
+      bmp[BMP_HEADER_LEN + i + 2] = rgb[i];
+    }
+    *out = bmp;
+    return true;
+  }
+  size_t bpp = bytes_per_pixel(format);
+  if (!bpp) {
+    return false;
+  }
+  size_t pix = (size_t)width * height;
+  if (format == PIXFORMAT_GRAYSCALE) {
+    uint8_t *bmp = bmp_alloc(width, height, 1, out_len);
+    if (!bmp) {
+      return false;
+    }
+    memcpy(bmp + BMP_HEADER_LEN + 1024, src, pix);
+    *out = bmp;
+    return true;
+  }
+  uint8_t *bmp = bmp_alloc(width, height, 3, out_len);
+  if (!bmp) {
+    return false;
+  }
+  raw2bgr(src, pix * bpp, format, bmp + BMP_HEADER_LEN);
+  *out = bmp;
+  (void)src_len;
+  return true;
+}
+
+extern "C" bool frame2bmp(camera_fb_t *fb, uint8_t **out, size_t *out_len) {
+  return fmt2bmp(fb->buf, fb->len, fb->width, fb->height, fb->format, out, out_len);
+}
+
+extern "C" bool jpg2rgb565(const uint8_t *src, size_t src_len, uint8_t *out, jpg_scale_t scale) {
+  std::vector<uint8_t> rgb;
+  int w, h;
+  if (!jpg_decode(src, src_len, 1 << scale, &rgb, &w, &h, NULL, NULL)) {
+    return false;
+  }
+  for (size_t i = 0, o = 0; i < rgb.size(); i += 3, o += 2) {
+    uint16_t c = (uint16_t)((rgb[i] & 0xF8) << 8 | (rgb[i + 1] & 0xFC) << 3 | rgb[i + 2] >> 3);
+    out[o] = (uint8_t)(c >> 8);
+    out[o + 1] = (uint8_t)c;
+  }
+  return true;
+}
+
+// ---------- esp_jpg_decode ----------
+extern "C" esp_err_t esp_jpg_decode(size_t len, jpg_scale_t scale, jpg_reader_cb reader, jpg_writer_cb writer, void *arg) {
+  std::vector<uint8_t> src(len);
+  size_t got = 0;
+  while (got < len) {
+    size_t n = reader(arg, got, src.data() + got, len - got);
+    if (n == 0) {
+      break;
+    }
+    got += n;
+  }
+  std::vector<uint8_t> rgb;
+  int w, h, mw, mh;
+  if (!jpg_decode(src.data(), got, 1 << scale, &rgb, &w, &h, &mw, &mh)) {
+    return ESP_FAIL;
+  }
+  // blok MCU dalam urutan raster, diskalakan seperti tjpgd
+  mw >>= scale;
+  mh >>= scale;
+  if (mw < 1) {
+    mw = 1;
+  }
+  if (mh < 1) {
+    mh = 1;
+  }
+  if (!writer(arg, 0, 0, (uint16_t)w, (uint16_t)h, NULL)) {
+    return ESP_FAIL;
+  }
+  std::vector<uint8_t> block((size_t)mw * mh * 3);
+  for (int y = 0; y < h; y += mh) {
+    for (int x = 0; x < w; x += mw) {
+      int bw = x + mw > w ? w - x : mw;
+      int bh = y + mh > h ? h - y : mh;
+      for (int r = 0; r < bh; r++) {
+        memcpy(&block[(size_t)r * bw * 3], &rgb[((size_t)(y + r) * w + x) * 3], (size_t)bw * 3);
+      }
+      if (!writer(arg, (uint16_t)x, (uint16_t)y, (uint16_t)bw, (uint16_t)bh, block.data())) {
+        return ESP_FAIL;
+      }
+    }
+  }
+  if (!writer(arg, (uint16_t)w, (uint16_t)h, (uint16_t)w, (uint16_t)h, NULL)) {
+    return ESP_FAIL;
+  }
+  return ESP_OK;
+}
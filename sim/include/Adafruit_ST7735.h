@@ -0,0 +1,62 @@
+#pragma once
+// Stand-in Adafruit_ST7735: framebuffer RGB565 di memori. Setiap primitif
+// memakan waktu transfer SPI-nya (2 byte per piksel + overhead window pada
+// frekuensi SPI), jadi animasi di loop() selambat di perangkat.
+// SIM_TFT_PPM=path menulis isi layar sebagai PPM (maks. 5x per detik).
+#include <stdint.h>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "Adafruit_GFX.h"
+#include "SPI.h"
+
+#define INITR_GREENTAB 0x00
+#define INITR_REDTAB 0x01
+#define INITR_BLACKTAB 0x02
+#define INITR_18GREENTAB INITR_GREENTAB
+#define INITR_18REDTAB INITR_REDTAB
+#define INITR_18BLACKTAB INITR_BLACKTAB
+#define INITR_144GREENTAB 0x01
+#define INITR_MINI160x80 0x04
+
+#define ST77XX_BLACK 0x0000
+#define ST77XX_WHITE 0xFFFF
+#define ST77XX_RED 0xF800
+#define ST77XX_GREEN 0x07E0
+#define ST77XX_BLUE 0x001F
+#define ST77XX_CYAN 0x07FF
+#define ST77XX_MAGENTA 0xF81F
+#define ST77XX_YELLOW 0xFFE0
+#define ST77XX_ORANGE 0xFC00
+#define ST7735_BLACK ST77XX_BLACK
+#define ST7735_WHITE ST77XX_WHITE
+
+class Adafruit_ST7735 : public Adafruit_GFX {
+ public:
+  Adafruit_ST7735(SPIClass *spi, int8_t cs, int8_t dc, int8_t rst);
+  Adafruit_ST7735(int8_t cs, int8_t dc, int8_t rst);
+
+  void initR(uint8_t options = INITR_GREENTAB);
+  void setRotation(uint8_t r) override;
+  void drawPixel(int16_t x, int16_t y, uint16_t color) override;
+  void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override;
+  size_t write(uint8_t c) override;
+  size_t write(const uint8_t *buf, size_t len) override;
+  uint16_t color565(uint8_t r, uint8_t g, uint8_t b) { return (uint16_t)(((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3)); }
+
+  // Salinan framebuffer (orientasi rotasi saat ini), untuk tes/screenshot.
+  std::vector<uint16_t> snapshot(int16_t *w, int16_t *h);
+
+ private:
+  void spi_cost(uint32_t bytes);
+  static void hook(void *arg);
+  void poll();
+
+  SPIClass *spi_;
+  std::mutex mu_;
+  std::vector<uint16_t> fb_;  // WIDTH x HEIGHT, orientasi panel
+  std::string text_;
+  bool dirty_ = false;
+  uint32_t last_dump_ms_ = 0;
+  uint64_t spi_debt_ns_ = 0;
+};
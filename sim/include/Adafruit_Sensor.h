@@ -0,0 +1,6 @@
+#pragma once
+// Stand-in Adafruit Unified Sensor: hanya basis kelas, sketch memakai DHT langsung.
+class Adafruit_Sensor {
+ public:
+  virtual ~Adafruit_Sensor() {}
+};
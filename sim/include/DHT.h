@@ -0,0 +1,32 @@
+#pragma once
+// Stand-in DHT: suhu/kelembapan sintetis yang berubah pelan. SIM_DHT_TEMP dan
+// SIM_DHT_HUM memaksa nilai tetap; SIM_DHT_FAIL=1 membuat pembacaan NaN.
+// Seperti library asli, hasil di-cache 2 s dan satu pembacaan sensor memakan
+// waktu ~5 ms (protokol 1-wire, interrupt mati).
+#include <stdint.h>
+
+#define DHT11 11
+#define DHT12 12
+#define DHT21 21
+#define DHT22 22
+#define AM2301 21
+
+class DHT {
+ public:
+  DHT(uint8_t pin, uint8_t type, uint8_t count = 6);
+  void begin(uint8_t usec = 55);
+  float readTemperature(bool S = false, bool force = false);
+  float readHumidity(bool force = false);
+  float convertCtoF(float c) { return c * 1.8f + 32; }
+
+ private:
+  bool read(bool force);
+
+  uint8_t pin_;
+  uint8_t type_;
+  uint32_t last_ms_ = 0;
+  bool first_ = true;
+  bool ok_ = false;
+  float temp_ = 0;
+  float hum_ = 0;
+};
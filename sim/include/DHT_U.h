@@ -0,0 +1,3 @@
+#pragma once
+#include "Adafruit_Sensor.h"
+#include "DHT.h"
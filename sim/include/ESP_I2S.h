@@ -0,0 +1,52 @@
+#pragma once
+// Stand-in I2SClass (arduino-esp32 3.x ESP_I2S). Mode RX menghasilkan sinyal
+// mikrofon 32-bit yang diberi jarak waktu real-time sesuai sample rate:
+// readBytes() blok sampai sampelnya "terekam", seperti DMA. Sumber sinyal:
+// SIM_I2S_WAV (WAV PCM16 mono, diulang) atau nada sintetis; pin DATA yang
+// tercantum di SIM_I2S_DEAD_PIN hanya memberi nol (uji failover pin).
+#include <stddef.h>
+#include <stdint.h>
+#include "Print.h"
+
+typedef enum { I2S_MODE_STD, I2S_MODE_TDM, I2S_MODE_PDM_TX, I2S_MODE_PDM_RX } i2s_mode_t;
+typedef enum {
+  I2S_DATA_BIT_WIDTH_8BIT = 8,
+  I2S_DATA_BIT_WIDTH_16BIT = 16,
+  I2S_DATA_BIT_WIDTH_24BIT = 24,
+  I2S_DATA_BIT_WIDTH_32BIT = 32,
+} i2s_data_bit_width_t;
+typedef enum { I2S_SLOT_MODE_MONO = 1, I2S_SLOT_MODE_STEREO = 2 } i2s_slot_mode_t;
+
+class I2SClass : public Stream {
+ public:
+  I2SClass();
+  ~I2SClass();
+
+  void setPins(int8_t bclk, int8_t ws, int8_t dout, int8_t din = -1, int8_t mclk = -1);
+  void setPinsPdmTx(int8_t clk, int8_t dout0, int8_t dout1 = -1);
+  void setPinsPdmRx(int8_t clk, int8_t din0, int8_t din1 = -1, int8_t din2 = -1, int8_t din3 = -1);
+  bool begin(i2s_mode_t mode, uint32_t rate, i2s_data_bit_width_t bits_cfg, i2s_slot_mode_t ch, int8_t slot_mask = -1);
+  bool end();
+
+  int available() override;
+  int read() override;
+  int peek() override;
+  size_t readBytes(char *buffer, size_t size);
+  size_t write(uint8_t c) override { return write(&c, 1); }
+  size_t write(const uint8_t *buffer, size_t size) override;
+  int lastError() { return last_error_; }
+
+ private:
+  bool fill(char *buffer, size_t size);
+
+  struct Source;
+  Source *src_ = nullptr;
+  i2s_mode_t mode_ = I2S_MODE_STD;
+  uint32_t rate_ = 0;
+  int bytes_ = 0;
+  int channels_ = 0;
+  int din_ = -1;
+  int64_t t0_us_ = 0;
+  uint64_t frames_ = 0;
+  int last_error_ = 0;
+};
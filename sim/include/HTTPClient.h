@@ -0,0 +1,16 @@
+#pragma once
+// Stand-in HTTPClient: tidak ada klien HTTP keluar di simulator; setiap
+// request gagal dengan HTTPC_ERROR_CONNECTION_REFUSED.
+#include "WString.h"
+
+#define HTTPC_ERROR_CONNECTION_REFUSED (-1)
+
+class HTTPClient {
+ public:
+  bool begin(const String &url) { (void)url; return true; }
+  void end() {}
+  void addHeader(const String &name, const String &value) { (void)name; (void)value; }
+  int GET() { return HTTPC_ERROR_CONNECTION_REFUSED; }
+  int POST(const String &payload) { (void)payload; return HTTPC_ERROR_CONNECTION_REFUSED; }
+  String getString() { return String(); }
+};
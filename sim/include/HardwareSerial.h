@@ -0,0 +1,21 @@
+#pragma once
+// Serial simulator: output ke stdout (per baris, aman antar thread),
+// input dari stdin (non-blocking, untuk prompt SSID dsb).
+#include "Print.h"
+
+class HardwareSerial : public Stream {
+ public:
+  void begin(unsigned long baud, uint32_t config = 0, int8_t rx = -1, int8_t tx = -1) { (void)baud; (void)config; (void)rx; (void)tx; }
+  void end() {}
+  void setDebugOutput(bool on) { (void)on; }
+  int available() override;
+  int read() override;
+  int peek() override;
+  size_t write(uint8_t c) override { return write(&c, 1); }
+  size_t write(const uint8_t *buf, size_t len) override;
+  using Print::write;
+  void flush() override;
+  operator bool() const { return true; }
+};
+
+extern HardwareSerial Serial;
@@ -0,0 +1,17 @@
+#pragma once
+#include <stdint.h>
+#include "WString.h"
+
+class IPAddress {
+ public:
+  IPAddress() : addr_(0) {}
+  IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) : addr_((uint32_t)a | (uint32_t)b << 8 | (uint32_t)c << 16 | (uint32_t)d << 24) {}
+  explicit IPAddress(uint32_t addr) : addr_(addr) {}  // network order, seperti lwIP
+  uint8_t operator[](int i) const { return (uint8_t)(addr_ >> (8 * i)); }
+  operator uint32_t() const { return addr_; }
+  bool operator==(const IPAddress &o) const { return addr_ == o.addr_; }
+  String toString() const;
+
+ private:
+  uint32_t addr_;
+};
@@ -0,0 +1,38 @@
+#pragma once
+// Stand-in LiquidCrystal_I2C (HD44780 lewat PCF8574): isi layar disimpan per
+// baris dan dicetak ke log setiap berubah ("[LCD] |baris 1|baris 2|").
+// Waktu bus ditiru: ~4 byte I2C per karakter (mode 4-bit), clear() 2 ms.
+#include <stdint.h>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "Print.h"
+
+class LiquidCrystal_I2C : public Print {
+ public:
+  LiquidCrystal_I2C(uint8_t addr, uint8_t cols, uint8_t rows);
+
+  void init();
+  void begin(uint8_t cols = 0, uint8_t rows = 0) { (void)cols; (void)rows; init(); }
+  void clear();
+  void home() { setCursor(0, 0); }
+  void setCursor(uint8_t col, uint8_t row);
+  void backlight();
+  void noBacklight();
+  void display() {}
+  void noDisplay() {}
+  size_t write(uint8_t c) override;
+  using Print::write;
+
+ private:
+  static void hook(void *arg);
+  void show();
+
+  uint8_t addr_, cols_, rows_;
+  uint8_t col_ = 0, row_ = 0;
+  bool backlight_ = false;
+  std::mutex mu_;
+  std::vector<std::string> lines_;
+  std::string last_shown_;
+  uint32_t changed_ms_ = 0;
+};
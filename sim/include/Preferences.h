@@ -0,0 +1,32 @@
+#pragma once
+// Stand-in Preferences di atas nvs.h simulator (namespace dan file yang sama).
+#include <stddef.h>
+#include <stdint.h>
+#include "WString.h"
+#include "nvs.h"
+
+class Preferences {
+ public:
+  ~Preferences() { end(); }
+  bool begin(const char *name, bool read_only = false, const char *partition = NULL);
+  void end();
+  bool clear();
+  bool remove(const char *key);
+  bool isKey(const char *key);
+  size_t putString(const char *key, const char *value);
+  size_t putString(const char *key, const String &value) { return putString(key, value.c_str()); }
+  String getString(const char *key, const String &def = String());
+  size_t getString(const char *key, char *out, size_t max_len);
+  size_t putUInt(const char *key, uint32_t value);
+  uint32_t getUInt(const char *key, uint32_t def = 0);
+  size_t putInt(const char *key, int32_t value);
+  int32_t getInt(const char *key, int32_t def = 0);
+  size_t putBool(const char *key, bool value) { return putUInt(key, value ? 1 : 0); }
+  bool getBool(const char *key, bool def = false) { return getUInt(key, def ? 1 : 0) != 0; }
+  size_t putBytes(const char *key, const void *value, size_t len);
+  size_t getBytes(const char *key, void *out, size_t max_len);
+
+ private:
+  nvs_handle_t handle_ = 0;
+  bool read_only_ = false;
+};
@@ -0,0 +1,63 @@
+#pragma once
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "WString.h"
+#include "IPAddress.h"
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+class Print {
+ public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t *buf, size_t len);
+  size_t write(const char *s) { return s ? write((const uint8_t *)s, __builtin_strlen(s)) : 0; }
+  size_t write(const char *buf, size_t len) { return write((const uint8_t *)buf, len); }
+
+  size_t printf(const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+  size_t print(const char *s) { return write(s); }
+  size_t print(const String &s) { return write(s.c_str(), s.length()); }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(unsigned char v, int base = DEC) { return print((unsigned long)v, base); }
+  size_t print(int v, int base = DEC) { return print((long)v, base); }
+  size_t print(unsigned int v, int base = DEC) { return print((unsigned long)v, base); }
+  size_t print(long v, int base = DEC);
+  size_t print(unsigned long v, int base = DEC);
+  size_t print(long long v, int base = DEC);
+  size_t print(unsigned long long v, int base = DEC);
+  size_t print(double v, int digits = 2);
+  size_t print(const IPAddress &ip) { return print(ip.toString()); }
+
+  size_t println() { return write("\r\n"); }
+  template <class T>
+  size_t println(const T &v) {
+    size_t n = print(v);
+    return n + println();
+  }
+  template <class T>
+  size_t println(const T &v, int arg) {
+    size_t n = print(v, arg);
+    return n + println();
+  }
+  virtual void flush() {}
+};
+
+class Stream : public Print {
+ public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+  void setTimeout(unsigned long ms) { timeout_ms_ = ms; }
+  size_t readBytes(char *buf, size_t len);
+  size_t readBytes(uint8_t *buf, size_t len) { return readBytes((char *)buf, len); }
+  String readString();
+  String readStringUntil(char terminator);
+
+ protected:
+  int timed_read();
+  unsigned long timeout_ms_ = 1000;
+};
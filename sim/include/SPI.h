@@ -0,0 +1,22 @@
+#pragma once
+// Stand-in SPIClass: hanya mencatat pin dan frekuensi; waktu transfer
+// disimulasikan oleh driver (Adafruit_ST7735) dari frekuensi ini.
+#include <stdint.h>
+
+#define FSPI 0
+#define HSPI 1
+
+class SPIClass {
+ public:
+  explicit SPIClass(uint8_t bus = FSPI) : bus_(bus) {}
+  void begin(int8_t sck = -1, int8_t miso = -1, int8_t mosi = -1, int8_t ss = -1);
+  void end() {}
+  void setFrequency(uint32_t freq) { freq_ = freq; }
+  uint32_t frequency() const { return freq_; }
+
+ private:
+  uint8_t bus_;
+  uint32_t freq_ = 27000000;
+};
+
+extern SPIClass SPI;
@@ -0,0 +1,77 @@
+#pragma once
+// Stand-in String Arduino (subset yang dipakai sketch), di atas std::string.
+#include <stddef.h>
+#include <string>
+
+class String {
+ public:
+  String(const char *s = "") : s_(s ? s : "") {}
+  String(const std::string &s) : s_(s) {}
+  String(char c) : s_(1, c) {}
+  String(int v, unsigned char base = 10);
+  String(unsigned int v, unsigned char base = 10);
+  String(long v, unsigned char base = 10);
+  String(unsigned long v, unsigned char base = 10);
+  String(long long v, unsigned char base = 10);
+  String(unsigned long long v, unsigned char base = 10);
+  String(float v, unsigned int decimals = 2);
+  String(double v, unsigned int decimals = 2);
+
+  const char *c_str() const { return s_.c_str(); }
+  unsigned int length() const { return (unsigned int)s_.size(); }
+  bool isEmpty() const { return s_.empty(); }
+  char charAt(unsigned int i) const { return i < s_.size() ? s_[i] : 0; }
+  char operator[](unsigned int i) const { return charAt(i); }
+  void trim();
+  void toLowerCase();
+  void toUpperCase();
+  int indexOf(char c, unsigned int from = 0) const;
+  int indexOf(const String &s, unsigned int from = 0) const;
+  String substring(unsigned int begin) const;
+  String substring(unsigned int begin, unsigned int end) const;
+  bool startsWith(const String &s) const { return s_.compare(0, s.s_.size(), s.s_) == 0; }
+  bool endsWith(const String &s) const;
+  bool equals(const String &s) const { return s_ == s.s_; }
+  bool equalsIgnoreCase(const String &s) const;
+  long toInt() const;
+  float toFloat() const;
+  void replace(const String &from, const String &to);
+  void reserve(unsigned int n) { s_.reserve(n); }
+
+  String &operator+=(const String &s) { s_ += s.s_; return *this; }
+  String &operator+=(const char *s) { s_ += s ? s : ""; return *this; }
+  String &operator+=(char c) { s_ += c; return *this; }
+  String &concat(const String &s) { return *this += s; }
+
+  bool operator==(const String &s) const { return s_ == s.s_; }
+  bool operator==(const char *s) const { return s_ == (s ? s : ""); }
+  bool operator!=(const String &s) const { return s_ != s.s_; }
+  bool operator!=(const char *s) const { return !(*this == s); }
+  bool operator<(const String &s) const { return s_ < s.s_; }
+
+  const std::string &str() const { return s_; }
+
+ private:
+  std::string s_;
+};
+
+inline String operator+(const String &a, const String &b) {
+  String r(a);
+  r += b;
+  return r;
+}
+inline String operator+(const String &a, const char *b) {
+  String r(a);
+  r += b;
+  return r;
+}
+inline String operator+(const char *a, const String &b) {
+  String r(a);
+  r += b;
+  return r;
+}
+inline String operator+(const String &a, char b) {
+  String r(a);
+  r += b;
+  return r;
+}
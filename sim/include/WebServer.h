@@ -0,0 +1,66 @@
+#pragma once
+// Stand-in WebServer (arduino-esp32 3.x) di atas socket POSIX: handleClient()
+// melayani paling banyak satu request per panggilan di thread pemanggil
+// (loop()), lalu menutup koneksi. Port = port firmware + SIM_PORT_OFFSET.
+#include <stddef.h>
+#include <stdint.h>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+#include "WString.h"
+#include "http_parser.h"
+
+typedef enum http_method HTTPMethod;
+
+class WebServer {
+ public:
+  typedef std::function<void(void)> THandlerFunction;
+
+  explicit WebServer(int port = 80);
+  ~WebServer();
+
+  void begin();
+  void begin(uint16_t port) { port_ = port; begin(); }
+  void close();
+  void stop() { close(); }
+  void handleClient();
+
+  void on(const String &uri, THandlerFunction fn) { on(uri, (HTTPMethod)HTTP_ANY, fn); }
+  void on(const String &uri, HTTPMethod method, THandlerFunction fn);
+  void onNotFound(THandlerFunction fn) { not_found_ = fn; }
+
+  String uri() const { return uri_; }
+  HTTPMethod method() const { return method_; }
+  String arg(const String &name) const;
+  String arg(int i) const;
+  String argName(int i) const;
+  int args() const { return (int)args_.size(); }
+  bool hasArg(const String &name) const;
+  String header(const String &name) const;
+
+  void sendHeader(const String &name, const String &value, bool first = false);
+  void send(int code, const char *content_type = NULL, const String &content = String(""));
+  void send(int code, const String &content_type, const String &content) { send(code, content_type.c_str(), content); }
+
+ private:
+  struct Route {
+    String uri;
+    HTTPMethod method;
+    THandlerFunction fn;
+  };
+
+  bool read_request(int fd);
+
+  int port_;
+  int listen_fd_ = -1;
+  int client_fd_ = -1;
+  bool sent_ = false;
+  std::vector<Route> routes_;
+  THandlerFunction not_found_;
+  String uri_;
+  HTTPMethod method_ = HTTP_GET;
+  std::vector<std::pair<String, String>> args_;
+  std::vector<std::pair<String, String>> req_headers_;
+  std::vector<std::pair<String, String>> resp_headers_;
+};
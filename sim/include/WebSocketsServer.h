@@ -0,0 +1,71 @@
+#pragma once
+// Stand-in WebSocketsServer (links2004/arduinoWebSockets) di atas socket POSIX.
+//
+// Seperti library aslinya: loop() menerima klien, membaca frame dan
+// menjalankan heartbeat; send/broadcast menulis blocking ke tiap klien
+// berurutan (klien macet menahan broadcast sampai timeout kirim 5 s lalu
+// diputus). Berbeda dengan aslinya, aman dipanggil dari task lain
+// (AudioTask, pengirim video): loop() dan state klien dilindungi mutex,
+// kirim hanya mengunci klien tujuan, jadi satu frame tidak pernah
+// bercampur dan klien macet hanya menahan pengirim ke klien itu.
+// Port = port firmware + SIM_PORT_OFFSET.
+#include <stddef.h>
+#include <stdint.h>
+#include <functional>
+#include "IPAddress.h"
+#include "WString.h"
+
+#define WEBSOCKETS_SERVER_CLIENT_MAX (5)
+// headerToPayload = true: payload diawali ruang sebesar ini untuk header frame
+#define WEBSOCKETS_MAX_HEADER_SIZE (14)
+
+typedef enum {
+  WStype_ERROR,
+  WStype_DISCONNECTED,
+  WStype_CONNECTED,
+  WStype_TEXT,
+  WStype_BIN,
+  WStype_FRAGMENT_TEXT_START,
+  WStype_FRAGMENT_BIN_START,
+  WStype_FRAGMENT,
+  WStype_FRAGMENT_FIN,
+  WStype_PING,
+  WStype_PONG,
+} WStype_t;
+
+class WebSocketsServer {
+ public:
+  typedef std::function<void(uint8_t num, WStype_t type, uint8_t *payload, size_t length)> WebSocketServerEvent;
+
+  WebSocketsServer(uint16_t port, const String &origin = "", const String &protocol = "arduino");
+  ~WebSocketsServer();
+
+  void begin();
+  void close();
+  void loop();
+  void onEvent(WebSocketServerEvent cb);
+
+  bool sendTXT(uint8_t num, const uint8_t *payload, size_t length = 0, bool headerToPayload = false);
+  bool sendTXT(uint8_t num, const char *payload, size_t length = 0, bool headerToPayload = false) { return sendTXT(num, (const uint8_t *)payload, length, headerToPayload); }
+  bool sendTXT(uint8_t num, const String &payload) { return sendTXT(num, payload.c_str(), payload.length()); }
+  bool broadcastTXT(const uint8_t *payload, size_t length = 0, bool headerToPayload = false);
+  bool broadcastTXT(const char *payload, size_t length = 0, bool headerToPayload = false) { return broadcastTXT((const uint8_t *)payload, length, headerToPayload); }
+  bool broadcastTXT(const String &payload) { return broadcastTXT(payload.c_str(), payload.length()); }
+  bool sendBIN(uint8_t num, const uint8_t *payload, size_t length, bool headerToPayload = false);
+  bool broadcastBIN(const uint8_t *payload, size_t length, bool headerToPayload = false);
+  bool sendPing(uint8_t num, const uint8_t *payload = NULL, size_t length = 0);
+  bool broadcastPing(const uint8_t *payload = NULL, size_t length = 0);
+
+  void disconnect();
+  void disconnect(uint8_t num);
+  uint8_t connectedClients(bool ping = false);
+  bool clientIsConnected(uint8_t num);
+  IPAddress remoteIP(uint8_t num);
+
+  void enableHeartbeat(uint32_t pingInterval, uint32_t pongTimeout, uint8_t disconnectTimeoutCount);
+  void disableHeartbeat();
+
+ private:
+  struct Impl;
+  Impl *impl_;
+};
@@ -0,0 +1,47 @@
+#pragma once
+// Stand-in WiFi: host selalu "terhubung" ke SSID apa pun yang tidak kosong.
+// IP = SIM_IP (default 127.0.0.1), channel AP = SIM_WIFI_CHANNEL (default 8).
+#include <stdint.h>
+#include "IPAddress.h"
+#include "WString.h"
+#include "esp_wifi.h"
+
+typedef enum {
+  WL_NO_SHIELD = 255,
+  WL_IDLE_STATUS = 0,
+  WL_NO_SSID_AVAIL = 1,
+  WL_SCAN_COMPLETED = 2,
+  WL_CONNECTED = 3,
+  WL_CONNECT_FAILED = 4,
+  WL_CONNECTION_LOST = 5,
+  WL_DISCONNECTED = 6,
+} wl_status_t;
+
+class WiFiClass {
+ public:
+  bool mode(wifi_mode_t m);
+  wifi_mode_t getMode() { return mode_; }
+  bool setSleep(bool enable) { (void)enable; return true; }
+  void persistent(bool on) { (void)on; }
+  void setAutoReconnect(bool on) { (void)on; }
+  wl_status_t begin(const char *ssid, const char *pass = NULL, int32_t channel = 0, const uint8_t *bssid = NULL, bool connect = true);
+  wl_status_t begin(const String &ssid, const String &pass) { return begin(ssid.c_str(), pass.c_str()); }
+  bool disconnect(bool wifioff = false, bool erase_ap = false);
+  bool reconnect() { return status() == WL_CONNECTED; }
+  wl_status_t status();
+  bool isConnected() { return status() == WL_CONNECTED; }
+  IPAddress localIP();
+  IPAddress gatewayIP();
+  String SSID();
+  int32_t RSSI();
+  int32_t channel();
+  String macAddress();
+  uint8_t *macAddress(uint8_t *mac);
+
+ private:
+  wifi_mode_t mode_ = WIFI_MODE_NULL;
+  wl_status_t status_ = WL_DISCONNECTED;
+  String ssid_;
+};
+
+extern WiFiClass WiFi;
@@ -0,0 +1,23 @@
+#pragma once
+// Stand-in TwoWire: transaksi I2C diterima tanpa perangkat; durasinya
+// (9 bit per byte pada clock bus) dipakai driver seperti LiquidCrystal_I2C.
+#include <stddef.h>
+#include <stdint.h>
+
+class TwoWire {
+ public:
+  bool begin(int sda = -1, int scl = -1, uint32_t frequency = 0);
+  bool end() { return true; }
+  bool setClock(uint32_t frequency) { freq_ = frequency; return true; }
+  uint32_t getClock() const { return freq_; }
+  void beginTransmission(uint8_t address) { (void)address; pending_ = 1; }
+  size_t write(uint8_t data) { (void)data; pending_++; return 1; }
+  size_t write(const uint8_t *data, size_t len) { (void)data; pending_ += len; return len; }
+  uint8_t endTransmission(bool stop = true);
+
+ private:
+  uint32_t freq_ = 100000;
+  size_t pending_ = 0;
+};
+
+extern TwoWire Wire;
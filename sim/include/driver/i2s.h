@@ -0,0 +1,84 @@
+#pragma once
+// Stand-in driver I2S legacy (driver/i2s.h, ESP-IDF 5.x). i2s_write diberi
+// jarak real-time dari sample rate dan kedalaman DMA (dma_buf_count x
+// dma_buf_len frame): blok saat "DMA" penuh, lalu dibuang atau ditulis
+// sebagai PCM mentah ke SIM_I2S_OUT.
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+
+typedef enum { I2S_NUM_0 = 0, I2S_NUM_1 = 1, I2S_NUM_MAX } i2s_port_t;
+
+typedef enum {
+  I2S_MODE_MASTER = (0x1 << 0),
+  I2S_MODE_SLAVE = (0x1 << 1),
+  I2S_MODE_TX = (0x1 << 2),
+  I2S_MODE_RX = (0x1 << 3),
+  I2S_MODE_PDM = (0x1 << 6),
+} i2s_mode_t;
+
+typedef enum {
+  I2S_BITS_PER_SAMPLE_8BIT = 8,
+  I2S_BITS_PER_SAMPLE_16BIT = 16,
+  I2S_BITS_PER_SAMPLE_24BIT = 24,
+  I2S_BITS_PER_SAMPLE_32BIT = 32,
+} i2s_bits_per_sample_t;
+
+typedef enum {
+  I2S_CHANNEL_FMT_RIGHT_LEFT,
+  I2S_CHANNEL_FMT_ALL_RIGHT,
+  I2S_CHANNEL_FMT_ALL_LEFT,
+  I2S_CHANNEL_FMT_ONLY_RIGHT,
+  I2S_CHANNEL_FMT_ONLY_LEFT,
+} i2s_channel_fmt_t;
+
+typedef enum {
+  I2S_COMM_FORMAT_STAND_I2S = 0x01,
+  I2S_COMM_FORMAT_STAND_MSB = 0x01 | 0x02,
+  I2S_COMM_FORMAT_STAND_PCM_SHORT = 0x04,
+  I2S_COMM_FORMAT_STAND_PCM_LONG = 0x0C,
+  I2S_COMM_FORMAT_I2S = 0x01,
+  I2S_COMM_FORMAT_I2S_MSB = 0x01,
+  I2S_COMM_FORMAT_I2S_LSB = 0x02,
+} i2s_comm_format_t;
+
+#define I2S_PIN_NO_CHANGE (-1)
+
+typedef struct {
+  i2s_mode_t mode;
+  uint32_t sample_rate;
+  i2s_bits_per_sample_t bits_per_sample;
+  i2s_channel_fmt_t channel_format;
+  i2s_comm_format_t communication_format;
+  int intr_alloc_flags;
+  int dma_buf_count;
+  int dma_buf_len;
+  bool use_apll;
+  bool tx_desc_auto_clear;
+  int fixed_mclk;
+} i2s_driver_config_t;
+typedef i2s_driver_config_t i2s_config_t;
+
+typedef struct {
+  int mck_io_num;
+  int bck_io_num;
+  int ws_io_num;
+  int data_out_num;
+  int data_in_num;
+} i2s_pin_config_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+esp_err_t i2s_driver_install(i2s_port_t port, const i2s_config_t *config, int queue_size, void *queue);
+esp_err_t i2s_driver_uninstall(i2s_port_t port);
+esp_err_t i2s_set_pin(i2s_port_t port, const i2s_pin_config_t *pin);
+esp_err_t i2s_start(i2s_port_t port);
+esp_err_t i2s_stop(i2s_port_t port);
+esp_err_t i2s_zero_dma_buffer(i2s_port_t port);
+esp_err_t i2s_write(i2s_port_t port, const void *src, size_t size, size_t *bytes_written, TickType_t ticks_to_wait);
+#ifdef __cplusplus
+}
+#endif
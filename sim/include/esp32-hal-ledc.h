@@ -0,0 +1,13 @@
+#pragma once
+// Stand-in LEDC: duty disimpan per pin, dicatat saat berubah.
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+bool ledcAttach(uint8_t pin, uint32_t freq, uint8_t resolution);
+bool ledcWrite(uint8_t pin, uint32_t duty);
+uint32_t ledcRead(uint8_t pin);
+#ifdef __cplusplus
+}
+#endif
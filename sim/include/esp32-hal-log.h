@@ -0,0 +1,50 @@
+#pragma once
+// Stand-in esp32-hal-log.h: log_x ke stderr dengan format core Arduino.
+#include <stdio.h>
+
+#define ARDUHAL_LOG_LEVEL_NONE 0
+#define ARDUHAL_LOG_LEVEL_ERROR 1
+#define ARDUHAL_LOG_LEVEL_WARN 2
+#define ARDUHAL_LOG_LEVEL_INFO 3
+#define ARDUHAL_LOG_LEVEL_DEBUG 4
+#define ARDUHAL_LOG_LEVEL_VERBOSE 5
+
+#ifndef ARDUHAL_LOG_LEVEL
+#define ARDUHAL_LOG_LEVEL ARDUHAL_LOG_LEVEL_ERROR
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+void sim_log(char level, const char *file, int line, const char *func, const char *fmt, ...) __attribute__((format(printf, 5, 6)));
+#ifdef __cplusplus
+}
+#endif
+
+#define ARDUHAL_SIM_LOG(l, format, ...) sim_log(l, __FILE__, __LINE__, __FUNCTION__, format, ##__VA_ARGS__)
+
+#if ARDUHAL_LOG_LEVEL >= ARDUHAL_LOG_LEVEL_VERBOSE
+#define log_v(format, ...) ARDUHAL_SIM_LOG('V', format, ##__VA_ARGS__)
+#else
+#define log_v(format, ...) do {} while (0)
+#endif
+#if ARDUHAL_LOG_LEVEL >= ARDUHAL_LOG_LEVEL_DEBUG
+#define log_d(format, ...) ARDUHAL_SIM_LOG('D', format, ##__VA_ARGS__)
+#else
+#define log_d(format, ...) do {} while (0)
+#endif
+#if ARDUHAL_LOG_LEVEL >= ARDUHAL_LOG_LEVEL_INFO
+#define log_i(format, ...) ARDUHAL_SIM_LOG('I', format, ##__VA_ARGS__)
+#else
+#define log_i(format, ...) do {} while (0)
+#endif
+#if ARDUHAL_LOG_LEVEL >= ARDUHAL_LOG_LEVEL_WARN
+#define log_w(format, ...) ARDUHAL_SIM_LOG('W', format, ##__VA_ARGS__)
+#else
+#define log_w(format, ...) do {} while (0)
+#endif
+#if ARDUHAL_LOG_LEVEL >= ARDUHAL_LOG_LEVEL_ERROR
+#define log_e(format, ...) ARDUHAL_SIM_LOG('E', format, ##__VA_ARGS__)
+#else
+#define log_e(format, ...) do {} while (0)
+#endif
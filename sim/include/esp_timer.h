@@ -0,0 +1,11 @@
+#pragma once
+// Stand-in esp_timer.h: mikrodetik sejak proses mulai (CLOCK_MONOTONIC).
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+int64_t esp_timer_get_time(void);
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,35 @@
+#pragma once
+// Stand-in esp_wifi: cukup untuk mode, channel dan MAC di simulator ESP-NOW.
+#include <stdint.h>
+#include "esp_err.h"
+
+typedef enum { WIFI_MODE_NULL = 0, WIFI_MODE_STA, WIFI_MODE_AP, WIFI_MODE_APSTA, WIFI_MODE_MAX } wifi_mode_t;
+#define WIFI_OFF WIFI_MODE_NULL
+#define WIFI_STA WIFI_MODE_STA
+#define WIFI_AP WIFI_MODE_AP
+#define WIFI_AP_STA WIFI_MODE_APSTA
+
+typedef enum { WIFI_IF_STA = 0, WIFI_IF_AP = 1 } wifi_interface_t;
+typedef enum { WIFI_SECOND_CHAN_NONE = 0, WIFI_SECOND_CHAN_ABOVE, WIFI_SECOND_CHAN_BELOW } wifi_second_chan_t;
+typedef enum { WIFI_PHY_RATE_1M_L = 0x00, WIFI_PHY_RATE_MCS0_LGI = 0x10 } wifi_phy_rate_t;
+
+typedef struct {
+  signed rssi : 8;
+  unsigned channel : 4;
+  unsigned sig_len : 12;
+  unsigned timestamp : 32;
+} wifi_pkt_rx_ctrl_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+esp_err_t esp_wifi_start(void);
+esp_err_t esp_wifi_stop(void);
+esp_err_t esp_wifi_set_mode(wifi_mode_t mode);
+esp_err_t esp_wifi_set_channel(uint8_t primary, wifi_second_chan_t second);
+esp_err_t esp_wifi_get_channel(uint8_t *primary, wifi_second_chan_t *second);
+esp_err_t esp_wifi_get_mac(wifi_interface_t ifx, uint8_t mac[6]);
+esp_err_t esp_wifi_set_ps(int type);
+#ifdef __cplusplus
+}
+#endif
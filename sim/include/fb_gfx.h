@@ -0,0 +1,13 @@
+#pragma once
+// Stand-in fb_gfx.h: hanya tipe; face detection tidak dipakai firmware ini.
+#include <stdint.h>
+
+typedef enum { FB_RGB888, FB_BGR888, FB_RGB565, FB_BGR565, FB_GRAY } fb_format_t;
+
+typedef struct {
+  int width;
+  int height;
+  int bytes_per_pixel;
+  fb_format_t format;
+  uint8_t *data;
+} fb_data_t;
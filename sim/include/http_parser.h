@@ -0,0 +1,22 @@
+#pragma once
+// Metode HTTP (nodejs http_parser, dipakai esp_http_server dan WebServer).
+enum http_method {
+  HTTP_DELETE = 0,
+  HTTP_GET = 1,
+  HTTP_HEAD = 2,
+  HTTP_POST = 3,
+  HTTP_PUT = 4,
+  HTTP_CONNECT = 5,
+  HTTP_OPTIONS = 6,
+  HTTP_TRACE = 7,
+  HTTP_PATCH = 28,
+};
+#define HTTP_ANY -1
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+const char *http_method_str(enum http_method m);
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,15 @@
+#pragma once
+// lwIP socket API = socket POSIX di host.
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+
+#define lwip_writev writev
+#define lwip_send send
+#define lwip_recv recv
+#define lwip_setsockopt setsockopt
+#define lwip_getsockopt getsockopt
+#define lwip_close close
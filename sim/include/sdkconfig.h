@@ -0,0 +1,6 @@
+#pragma once
+// Stand-in sdkconfig.h. CONFIG_HTTPD_WS_SUPPORT sengaja tidak didefinisikan:
+// server httpd simulator tidak menangani upgrade WebSocket.
+#define CONFIG_IDF_TARGET_ESP32S3 1
+#define CONFIG_SPIRAM 1
+#define CONFIG_FREERTOS_HZ 1000
@@ -0,0 +1,19 @@
+#pragma once
+// Konfigurasi simulator host (dibaca dari environment, lihat sim/README.md).
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+const char *sim_env(const char *name, const char *def);
+long sim_env_int(const char *name, long def);
+double sim_env_double(const char *name, double def);
+int sim_verbose(void);     // SIM_VERBOSE=1: catat aktivitas stand-in
+int sim_port(int port);    // port firmware + SIM_PORT_OFFSET
+void sim_log(char level, const char *file, int line, const char *func, const char *fmt, ...) __attribute__((format(printf, 5, 6)));
+void sim_sleep_us(int64_t us);
+// Dipanggil main() setelah setiap loop() (dump layar, log LCD, ...).
+void sim_add_loop_hook(void (*fn)(void *arg), void *arg);
+#ifdef __cplusplus
+}
+#endif
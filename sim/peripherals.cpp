@@ -0,0 +1,539 @@
+// Stand-in periferal sketch sender/receiver untuk simulator host:
+// Adafruit_GFX + ST7735 (framebuffer), LiquidCrystal_I2C, DHT, SPI dan Wire.
+// Tidak ada perangkat keras; yang ditiru adalah isi layar dan waktu bus,
+// karena itu yang menentukan tempo loop() di board.
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "Adafruit_GFX.h"
+#include "Adafruit_ST7735.h"
+#include "Arduino.h"
+#include "DHT.h"
+#include "LiquidCrystal_I2C.h"
+#include "SPI.h"
+#include "Wire.h"
+#include "sim.h"
+
+SPIClass SPI(FSPI);
+TwoWire Wire;
+
+// ---------- SPI / Wire ----------
+void SPIClass::begin(int8_t sck, int8_t miso, int8_t mosi, int8_t ss) {
+  (void)sck, (void)miso, (void)mosi, (void)ss;  // hanya untuk log_i
+  if (sim_verbose()) {
+    log_i("SPI%u begin sck=%d miso=%d mosi=%d ss=%d", bus_, sck, miso, mosi, ss);
+  }
+}
+
+bool TwoWire::begin(int sda, int scl, uint32_t frequency) {
+  (void)sda, (void)scl;  // hanya untuk log_i
+  if (frequency) {
+    freq_ = frequency;
+  }
+  if (sim_verbose()) {
+    log_i("Wire begin sda=%d scl=%d %u Hz", sda, scl, freq_);
+  }
+  return true;
+}
+
+uint8_t TwoWire::endTransmission(bool stop) {
+  (void)stop;
+  // 9 clock per byte (8 data + ACK) + start/stop
+  sim_sleep_us((int64_t)(pending_ * 9 + 2) * 1000000 / freq_);
+  pending_ = 0;
+  return 0;
+}
+
+// ---------- Adafruit_GFX ----------
+void Adafruit_GFX::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+  for (int16_t i = x; i < x + w; i++) {
+    for (int16_t j = y; j < y + h; j++) {
+      drawPixel(i, j, color);
+    }
+  }
+}
+
+void Adafruit_GFX::setRotation(uint8_t r) {
+  rotation = r & 3;
+  _width = (rotation & 1) ? HEIGHT : WIDTH;
+  _height = (rotation & 1) ? WIDTH : HEIGHT;
+}
+
+void Adafruit_GFX::drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color) {
+  if (x0 == x1) {
+    drawFastVLine(x0, y0 < y1 ? y0 : y1, (int16_t)abs(y1 - y0) + 1, color);
+    return;
+  }
+  if (y0 == y1) {
+    drawFastHLine(x0 < x1 ? x0 : x1, y0, (int16_t)abs(x1 - x0) + 1, color);
+    return;
+  }
+  bool steep = abs(y1 - y0) > abs(x1 - x0);
+  if (steep) {
+    int16_t t = x0;
+    x0 = y0, y0 = t;
+    t = x1, x1 = y1, y1 = t;
+  }
+  if (x0 > x1) {
+    int16_t t = x0;
+    x0 = x1, x1 = t;
+    t = y0, y0 = y1, y1 = t;
+  }
+  int16_t dx = x1 - x0, dy = (int16_t)abs(y1 - y0), err = dx / 2, ystep = y0 < y1 ? 1 : -1;
+  for (; x0 <= x1; x0++) {
+    if (steep) {
+      drawPixel(y0, x0, color);
+    } else {
+      drawPixel(x0, y0, color);
+    }
+    err -= dy;
+    if (err < 0) {
+      y0 += ystep;
+      err += dx;
+    }
+  }
+}
+
+void Adafruit_GFX::drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+  drawFastHLine(x, y, w, color);
+  drawFastHLine(x, y + h - 1, w, color);
+  drawFastVLine(x, y, h, color);
+  drawFastVLine(x + w - 1, y, h, color);
+}
+
+void Adafruit_GFX::drawCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color) {
+  drawPixel(x0, y0 + r, color);
+  drawPixel(x0, y0 - r, color);
+  drawPixel(x0 + r, y0, color);
+  drawPixel(x0 - r, y0, color);
+  circleHelper(x0, y0, r, 0xF, color);
+}
+
+void Adafruit_GFX::circleHelper(int16_t x0, int16_t y0, int16_t r, uint8_t corners, uint16_t color) {
+  int16_t f = 1 - r, ddx = 1, ddy = -2 * r, x = 0, y = r;
+  while (x < y) {
+    if (f >= 0) {
+      y--;
+      ddy += 2;
+      f += ddy;
+    }
+    x++;
+    ddx += 2;
+    f += ddx;
+    if (corners & 0x4) {
+      drawPixel(x0 + x, y0 + y, color);
+      drawPixel(x0 + y, y0 + x, color);
+    }
+    if (corners & 0x2) {
+      drawPixel(x0 + x, y0 - y, color);
+      drawPixel(x0 + y, y0 - x, color);
+    }
+    if (corners & 0x8) {
+      drawPixel(x0 - y, y0 + x, color);
+      drawPixel(x0 - x, y0 + y, color);
+    }
+    if (corners & 0x1) {
+      drawPixel(x0 - y, y0 - x, color);
+      drawPixel(x0 - x, y0 - y, color);
+    }
+  }
+}
+
+void Adafruit_GFX::fillCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color) {
+  drawFastVLine(x0, y0 - r, 2 * r + 1, color);
+  fillCircleHelper(x0, y0, r, 3, 0, color);
+}
+
+void Adafruit_GFX::fillCircleHelper(int16_t x0, int16_t y0, int16_t r, uint8_t corners, int16_t delta, uint16_t color) {
+  int16_t f = 1 - r, ddx = 1, ddy = -2 * r, x = 0, y = r, px = x, py = y;
+  delta++;
+  while (x < y) {
+    if (f >= 0) {
+      y--;
+      ddy += 2;
+      f += ddy;
+    }
+    x++;
+    ddx += 2;
+    f += ddx;
+    if (x < y + 1) {
+      if (corners & 1) {
+        drawFastVLine(x0 + x, y0 - y, 2 * y + delta, color);
+      }
+      if (corners & 2) {
+        drawFastVLine(x0 - x, y0 - y, 2 * y + delta, color);
+      }
+    }
+    if (y != py) {
+      if (corners & 1) {
+        drawFastVLine(x0 + py, y0 - px, 2 * px + delta, color);
+      }
+      if (corners & 2) {
+        drawFastVLine(x0 - py, y0 - px, 2 * px + delta, color);
+      }
+      py = y;
+    }
+    px = x;
+  }
+}
+
+void Adafruit_GFX::drawRoundRect(int16_t x, int16_t y, int16_t w, int16_t h, int16_t r, uint16_t color) {
+  int16_t max_r = (w < h ? w : h) / 2;
+  if (r > max_r) {
+    r = max_r;
+  }
+  drawFastHLine(x + r, y, w - 2 * r, color);
+  drawFastHLine(x + r, y + h - 1, w - 2 * r, color);
+  drawFastVLine(x, y + r, h - 2 * r, color);
+  drawFastVLine(x + w - 1, y + r, h - 2 * r, color);
+  circleHelper(x + r, y + r, r, 1, color);
+  circleHelper(x + w - r - 1, y + r, r, 2, color);
+  circleHelper(x + w - r - 1, y + h - r - 1, r, 4, color);
+  circleHelper(x + r, y + h - r - 1, r, 8, color);
+}
+
+void Adafruit_GFX::fillRoundRect(int16_t x, int16_t y, int16_t w, int16_t h, int16_t r, uint16_t color) {
+  int16_t max_r = (w < h ? w : h) / 2;
+  if (r > max_r) {
+    r = max_r;
+  }
+  fillRect(x + r, y, w - 2 * r, h, color);
+  fillCircleHelper(x + w - r - 1, y + r, r, 1, h - 2 * r - 1, color);
+  fillCircleHelper(x + r, y + r, r, 2, h - 2 * r - 1, color);
+}
+
+// ---------- ST7735 ----------
+// CASET + RASET + RAMWR: 3 perintah + 8 byte parameter
+#define ST7735_WINDOW_BYTES 11
+
+Adafruit_ST7735::Adafruit_ST7735(SPIClass *spi, int8_t cs, int8_t dc, int8_t rst) : Adafruit_GFX(128, 160), spi_(spi) {
+  (void)cs;
+  (void)dc;
+  (void)rst;
+}
+
+Adafruit_ST7735::Adafruit_ST7735(int8_t cs, int8_t dc, int8_t rst) : Adafruit_ST7735(&SPI, cs, dc, rst) {}
+
+void Adafruit_ST7735::initR(uint8_t options) {
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    if (options == INITR_MINI160x80) {
+      WIDTH = 80;
+    }
+    fb_.assign((size_t)WIDTH * HEIGHT, 0);
+  }
+  setRotation(0);
+  // urutan init ST7735R: reset + SLPOUT 500 ms + perintah lain
+  delay(150 + 500 + 100);
+  sim_add_loop_hook(hook, this);
+}
+
+void Adafruit_ST7735::setRotation(uint8_t r) {
+  std::lock_guard<std::mutex> lock(mu_);
+  Adafruit_GFX::setRotation(r);
+}
+
+void Adafruit_ST7735::spi_cost(uint32_t bytes) {
+  uint32_t freq = spi_ && spi_->frequency() ? spi_->frequency() : 27000000;
+  spi_debt_ns_ += (uint64_t)bytes * 8 * 1000000000ull / freq;
+  // tidur per ~1 ms supaya tidak ada syscall per piksel
+  if (spi_debt_ns_ >= 1000000) {
+    uint64_t us = spi_debt_ns_ / 1000;
+    spi_debt_ns_ %= 1000;
+    mu_.unlock();
+    sim_sleep_us((int64_t)us);
+    mu_.lock();
+  }
+}
+
+void Adafruit_ST7735::drawPixel(int16_t x, int16_t y, uint16_t color) {
+  std::lock_guard<std::mutex> lock(mu_);
+  if (fb_.empty() || x < 0 || y < 0 || x >= _width || y >= _height) {
+    return;
+  }
+  int16_t px = x, py = y;
+  switch (rotation) {
+    case 1:
+      px = WIDTH - 1 - y, py = x;
+      break;
+    case 2:
+      px = WIDTH - 1 - x, py = HEIGHT - 1 - y;
+      break;
+    case 3:
+      px = y, py = HEIGHT - 1 - x;
+      break;
+  }
+  fb_[(size_t)py * WIDTH + px] = color;
+  dirty_ = true;
+  spi_cost(ST7735_WINDOW_BYTES + 2);
+}
+
+void Adafruit_ST7735::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    if (fb_.empty()) {
+      return;
+    }
+    if (x < 0) {
+      w += x, x = 0;
+    }
+    if (y < 0) {
+      h += y, y = 0;
+    }
+    if (x + w > _width) {
+      w = _width - x;
+    }
+    if (y + h > _height) {
+      h = _height - y;
+    }
+    if (w <= 0 || h <= 0) {
+      return;
+    }
+  }
+  for (int16_t j = y; j < y + h; j++) {
+    for (int16_t i = x; i < x + w; i++) {
+      std::lock_guard<std::mutex> lock(mu_);
+      int16_t px = i, py = j;
+      switch (rotation) {
+        case 1:
+          px = WIDTH - 1 - j, py = i;
+          break;
+        case 2:
+          px = WIDTH - 1 - i, py = HEIGHT - 1 - j;
+          break;
+        case 3:
+          px = j, py = HEIGHT - 1 - i;
+          break;
+      }
+      fb_[(size_t)py * WIDTH + px] = color;
+    }
+  }
+  std::lock_guard<std::mutex> lock(mu_);
+  dirty_ = true;
+  spi_cost(ST7735_WINDOW_BYTES + (uint32_t)w * h * 2);
+}
+
+// Tanpa font: teks hanya dicatat per baris dan menggeser kursor 6x8 piksel.
+size_t Adafruit_ST7735::write(uint8_t c) {
+  std::lock_guard<std::mutex> lock(mu_);
+  if (c == '\n') {
+    fprintf(stderr, "[TFT] %s\n", text_.c_str());
+    text_.clear();
+    cursor_x = 0;
+    cursor_y += 8 * textsize;
+  } else if (c != '\r') {
+    text_ += (char)c;
+    cursor_x += 6 * textsize;
+    spi_cost((uint32_t)(ST7735_WINDOW_BYTES + 6 * 8 * textsize * textsize * 2));
+  }
+  return 1;
+}
+
+size_t Adafruit_ST7735::write(const uint8_t *buf, size_t len) {
+  for (size_t i = 0; i < len; i++) {
+    write(buf[i]);
+  }
+  return len;
+}
+
+std::vector<uint16_t> Adafruit_ST7735::snapshot(int16_t *w, int16_t *h) {
+  std::lock_guard<std::mutex> lock(mu_);
+  std::vector<uint16_t> out((size_t)_width * _height);
+  for (int16_t y = 0; y < _height; y++) {
+    for (int16_t x = 0; x < _width; x++) {
+      int16_t px = x, py = y;
+      switch (rotation) {
+        case 1:
+          px = WIDTH - 1 - y, py = x;
+          break;
+        case 2:
+          px = WIDTH - 1 - x, py = HEIGHT - 1 - y;
+          break;
+        case 3:
+          px = y, py = HEIGHT - 1 - x;
+          break;
+      }
+      out[(size_t)y * _width + x] = fb_.empty() ? 0 : fb_[(size_t)py * WIDTH + px];
+    }
+  }
+  *w = _width;
+  *h = _height;
+  return out;
+}
+
+void Adafruit_ST7735::hook(void *arg) {
+  ((Adafruit_ST7735 *)arg)->poll();
+}
+
+// SIM_TFT_PPM: tulis layar (orientasi saat ini) lewat file sementara + rename.
+void Adafruit_ST7735::poll() {
+  static const char *path = sim_env("SIM_TFT_PPM", "");
+  if (!*path) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    if (!dirty_ || millis() - last_dump_ms_ < 200) {
+      return;
+    }
+    dirty_ = false;
+    last_dump_ms_ = millis();
+  }
+  int16_t w, h;
+  std::vector<uint16_t> px = snapshot(&w, &h);
+  std::string tmp = std::string(path) + ".tmp";
+  FILE *f = fopen(tmp.c_str(), "wb");
+  if (!f) {
+    return;
+  }
+  fprintf(f, "P6\n%d %d\n255\n", w, h);
+  for (uint16_t c : px) {
+    uint8_t rgb[3] = {(uint8_t)((c >> 8) & 0xF8), (uint8_t)((c >> 3) & 0xFC), (uint8_t)((c << 3) & 0xF8)};
+    fwrite(rgb, 1, 3, f);
+  }
+  fclose(f);
+  rename(tmp.c_str(), path);
+}
+
+// ---------- LiquidCrystal_I2C ----------
+// Satu byte HD44780 dalam mode 4-bit = 4 tulisan PCF8574 (nibble x EN).
+#define LCD_I2C_BYTES_PER_CHAR 4
+
+LiquidCrystal_I2C::LiquidCrystal_I2C(uint8_t addr, uint8_t cols, uint8_t rows)
+    : addr_(addr), cols_(cols), rows_(rows), lines_(rows, std::string(cols, ' ')) {}
+
+static void lcd_bus(size_t bytes) {
+  Wire.beginTransmission(0);
+  for (size_t i = 1; i < bytes; i++) {
+    Wire.write((uint8_t)0);
+  }
+  Wire.endTransmission();
+}
+
+void LiquidCrystal_I2C::init() {
+  // power-on + urutan init 4-bit (datasheet: >40 ms, 4.1 ms, 100 us)
+  delay(50);
+  lcd_bus(6 * LCD_I2C_BYTES_PER_CHAR);
+  delay(5);
+  clear();
+  sim_add_loop_hook(hook, this);
+}
+
+void LiquidCrystal_I2C::clear() {
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    for (std::string &l : lines_) {
+      l.assign(cols_, ' ');
+    }
+    col_ = row_ = 0;
+    changed_ms_ = millis();
+  }
+  lcd_bus(LCD_I2C_BYTES_PER_CHAR);
+  delay(2);
+}
+
+void LiquidCrystal_I2C::setCursor(uint8_t col, uint8_t row) {
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    col_ = col;
+    row_ = row < rows_ ? row : rows_ - 1;
+  }
+  lcd_bus(LCD_I2C_BYTES_PER_CHAR);
+}
+
+void LiquidCrystal_I2C::backlight() {
+  std::lock_guard<std::mutex> lock(mu_);
+  backlight_ = true;
+}
+
+void LiquidCrystal_I2C::noBacklight() {
+  std::lock_guard<std::mutex> lock(mu_);
+  backlight_ = false;
+}
+
+size_t LiquidCrystal_I2C::write(uint8_t c) {
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    if (row_ < rows_ && col_ < cols_) {
+      // ROM A00 tidak punya UTF-8: byte non-ASCII tampil sebagai simbol acak
+      lines_[row_][col_] = c >= 0x20 && c < 0x7F ? (char)c : '?';
+    }
+    col_++;
+    changed_ms_ = millis();
+  }
+  lcd_bus(LCD_I2C_BYTES_PER_CHAR);
+  return 1;
+}
+
+void LiquidCrystal_I2C::hook(void *arg) {
+  ((LiquidCrystal_I2C *)arg)->show();
+}
+
+// Dicetak setelah isi diam 50 ms, supaya clear()+print() tidak tampil separuh.
+void LiquidCrystal_I2C::show() {
+  std::string now;
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    if (millis() - changed_ms_ < 50) {
+      return;
+    }
+    now = "|";
+    for (const std::string &l : lines_) {
+      now += l + "|";
+    }
+    if (now == last_shown_) {
+      return;
+    }
+    last_shown_ = now;
+  }
+  fprintf(stderr, "[LCD 0x%02X] %s\n", addr_, now.c_str());
+}
+
+// ---------- DHT ----------
+DHT::DHT(uint8_t pin, uint8_t type, uint8_t count) : pin_(pin), type_(type) {
+  (void)count;
+}
+
+void DHT::begin(uint8_t usec) {
+  (void)usec;
+  last_ms_ = millis();
+}
+
+bool DHT::read(bool force) {
+  uint32_t now = millis();
+  if (!force && !first_ && now - last_ms_ < 2000) {
+    return ok_;
+  }
+  first_ = false;
+  last_ms_ = now;
+  // start 1-18 ms + 40 bit x ~100 us
+  delay(type_ == DHT11 ? 18 : 1);
+  delayMicroseconds(4000);
+  if (sim_env_int("SIM_DHT_FAIL", 0)) {
+    ok_ = false;
+    return false;
+  }
+  double t = now / 1000.0;
+  temp_ = (float)sim_env_double("SIM_DHT_TEMP", 29.0 + 3.0 * sin(2 * M_PI * t / 120.0));
+  hum_ = (float)sim_env_double("SIM_DHT_HUM", 65.0 + 10.0 * sin(2 * M_PI * t / 300.0));
+  // resolusi DHT22 0.1
+  temp_ = roundf(temp_ * 10) / 10;
+  hum_ = roundf(hum_ * 10) / 10;
+  ok_ = true;
+  if (sim_verbose()) {
+    log_i("DHT%u pin %u: %.1f C %.1f %%", type_, pin_, temp_, hum_);
+  }
+  return true;
+}
+
+float DHT::readTemperature(bool S, bool force) {
+  if (!read(force)) {
+    return NAN;
+  }
+  return S ? convertCtoF(temp_) : temp_;
+}
+
+float DHT::readHumidity(bool force) {
+  return read(force) ? hum_ : NAN;
+}
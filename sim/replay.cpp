@@ -0,0 +1,159 @@
+// Sumber kamera replay: memutar rekaman .bbr (tools/cam_record) lewat
+// esp_camera_fb_get()/fb_return() supaya streaming, gating dan inferensi
+// bisa diukur dengan input yang sama persis di setiap run.
+//
+//   SIM_CAMERA_REPLAY=day.bbr,night.bbr   diputar berurutan sebagai satu sekuens
+//   SIM_CAMERA_REPLAY_SPEED=1             1 = waktu nyata, 2 = 2x, 0 = secepatnya
+//   SIM_CAMERA_REPLAY_LOOP=1              0 = berhenti di akhir (fb_get lalu timeout)
+//
+// Jarak fb->timestamp antar frame selalu sama dengan rekaman aslinya, juga
+// pada speed != 1; pada speed 1 timestamp juga cocok dengan jam esp_timer.
+// Dengan speed 0 tidak ada frame yang dibuang (Source::lossless), jadi
+// setiap konsumen melihat urutan frame yang identik.
+#include <stdlib.h>
+#include <string.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "esp32-hal-log.h"
+#include "esp_timer.h"
+#include "img_converters.h"
+#include "replay_file.h"
+#include "sim.h"
+#include "sim_camera.h"
+
+#define REPLAY_RESYNC_US 1000000  // tertinggal lebih dari ini: jadwal digeser, bukan dikejar
+
+namespace sim_cam {
+
+class ReplaySource : public Source {
+ public:
+  bool open(const std::string &list, double speed, bool loop) {
+    speed_ = speed;
+    loop_ = loop;
+    int64_t base = 0;
+    size_t start = 0;
+    while (start <= list.size()) {
+      size_t comma = list.find(',', start);
+      std::string path = list.substr(start, comma == std::string::npos ? std::string::npos : comma - start);
+      start = comma == std::string::npos ? list.size() + 1 : comma + 1;
+      if (path.empty()) {
+        continue;
+      }
+      std::unique_ptr<replay::Reader> r(new replay::Reader);
+      if (!r->open(path)) {
+        log_e("%s", r->error().c_str());
+        return false;
+      }
+      if (r->frames() == 0) {
+        log_w("%s: rekaman kosong", path.c_str());
+        continue;
+      }
+      // timestamp dibuat relatif ke awal playlist; file berikutnya menyambung
+      // satu interval rata-rata setelah frame terakhir file sebelumnya
+      int64_t first = r->entry(0).timestamp_us;
+      for (size_t i = 0; i < r->frames(); i++) {
+        items_.push_back({readers_.size(), i, base + r->entry(i).timestamp_us - first});
+      }
+      log_i("replay %s: \"%s\", %u frame, %.1f s", path.c_str(), r->header().label, (unsigned)r->frames(),
+            r->duration_us() / 1e6);
+      base += r->duration_us() + r->mean_interval_us();
+      readers_.push_back(std::move(r));
+    }
+    period_ = base;
+    return !items_.empty();
+  }
+
+  bool next(const sensor_t *s, Frame *f) override {
+    if (pos_ == items_.size()) {
+      if (!loop_) {
+        return false;
+      }
+      pos_ = 0;
+      lap_ += period_;
+    }
+    const Item &it = items_[pos_++];
+    int64_t v = lap_ + it.vts;
+    int64_t now = esp_timer_get_time();
+    if (!started_) {
+      started_ = true;
+      wall_base_ = ts_base_ = now - (int64_t)(v / (speed_ > 0 ? speed_ : 1));
+    }
+    if (speed_ > 0) {
+      int64_t due = wall_base_ + (int64_t)(v / speed_);
+      if (now - due > REPLAY_RESYNC_US) {
+        wall_base_ += now - due;
+        ts_base_ += (int64_t)((now - due) * speed_);
+        due = now;
+      }
+      sim_sleep_us(due - now);
+    }
+    f->timestamp_us = ts_base_ + v;
+
+    replay::Reader &r = *readers_[it.file];
+    const replay_index_t &e = r.entry(it.frame);
+    if (s->pixformat == PIXFORMAT_JPEG) {
+      // byte rekaman apa adanya; quality sensor tidak berpengaruh
+      f->format = PIXFORMAT_JPEG;
+      f->width = e.width;
+      f->height = e.height;
+      return r.read(it.frame, &f->data);
+    }
+    if (!r.read(it.frame, &jpg_) || e.width == 0 || e.height == 0) {
+      return false;
+    }
+    bgr_.resize((size_t)e.width * e.height * 3);
+    if (!fmt2rgb888(jpg_.data(), jpg_.size(), PIXFORMAT_JPEG, bgr_.data())) {
+      log_e("replay: frame %u tidak bisa di-decode", (unsigned)it.frame);
+      return false;
+    }
+    return encode_bgr(bgr_.data(), e.width, e.height, s->pixformat, s->status.quality, f);
+  }
+
+  bool lossless() const override { return speed_ <= 0; }
+
+ private:
+  struct Item {
+    size_t file;
+    size_t frame;
+    int64_t vts;  // µs sejak frame pertama playlist
+  };
+
+  std::vector<std::unique_ptr<replay::Reader>> readers_;
+  std::vector<Item> items_;
+  std::vector<uint8_t> jpg_;
+  std::vector<uint8_t> bgr_;
+  double speed_ = 1;
+  bool loop_ = true;
+  bool started_ = false;
+  size_t pos_ = 0;
+  int64_t period_ = 0;  // panjang satu putaran playlist
+  int64_t lap_ = 0;
+  int64_t wall_base_ = 0;
+  int64_t ts_base_ = 0;
+};
+
+Source *replay_from_env() {
+  const char *list = sim_env("SIM_CAMERA_REPLAY", NULL);
+  if (!list || !*list) {
+    return NULL;
+  }
+  double speed = sim_env_double("SIM_CAMERA_REPLAY_SPEED", 1);
+  bool loop = sim_env_int("SIM_CAMERA_REPLAY_LOOP", 1) != 0;
+  ReplaySource *src = new ReplaySource;
+  if (!src->open(list, speed, loop)) {
+    log_e("SIM_CAMERA_REPLAY tidak bisa dipakai, kembali ke pola sintetis");
+    delete src;
+    return NULL;
+  }
+  if (speed > 0) {
+    log_i("camera replay: speed %.2fx, %s", speed, loop ? "loop" : "sekali");
+  } else {
+    log_i("camera replay: secepatnya (lossless), %s", loop ? "loop" : "sekali");
+  }
+  return src;
+}
+
+}  // namespace sim_cam
@@ -0,0 +1,165 @@
+// Baca/tulis rekaman kamera .bbr (lihat replay_file.h).
+#include "replay_file.h"
+
+#include <string.h>
+#include <time.h>
+
+static_assert(sizeof(replay_header_t) == 64, "replay_header_t harus 64 byte");
+static_assert(sizeof(replay_index_t) == 24, "replay_index_t harus 24 byte");
+
+namespace replay {
+
+bool jpeg_size(const uint8_t *data, size_t len, uint16_t *width, uint16_t *height) {
+  if (len < 4 || data[0] != 0xFF || data[1] != 0xD8) {
+    return false;
+  }
+  size_t i = 2;
+  while (i + 4 <= len) {
+    if (data[i] != 0xFF) {
+      return false;
+    }
+    uint8_t marker = data[i + 1];
+    if (marker == 0xFF) {  // padding
+      i++;
+      continue;
+    }
+    size_t seg = (size_t)data[i + 2] << 8 | data[i + 3];
+    // SOF0..SOF15 kecuali DHT (C4), JPG (C8) dan DAC (CC)
+    if (marker >= 0xC0 && marker <= 0xCF && marker != 0xC4 && marker != 0xC8 && marker != 0xCC) {
+      if (i + 9 > len) {
+        return false;
+      }
+      *height = (uint16_t)(data[i + 5] << 8 | data[i + 6]);
+      *width = (uint16_t)(data[i + 7] << 8 | data[i + 8]);
+      return true;
+    }
+    if (marker == 0xDA || seg < 2) {  // scan mulai sebelum SOF: rusak
+      return false;
+    }
+    i += 2 + seg;
+  }
+  return false;
+}
+
+// ---------- Writer ----------
+bool Writer::open(const std::string &path, const std::string &label) {
+  close();
+  fp_ = fopen(path.c_str(), "wb");
+  if (!fp_) {
+    return false;
+  }
+  memset(&header_, 0, sizeof(header_));
+  memcpy(header_.magic, REPLAY_MAGIC, 4);
+  header_.header_len = sizeof(replay_header_t);
+  header_.index_entry_len = sizeof(replay_index_t);
+  header_.recorded_at = (int64_t)time(NULL);
+  strncpy(header_.label, label.c_str(), REPLAY_LABEL_LEN - 1);
+  index_.clear();
+  pos_ = sizeof(header_);
+  // header sementara (index_offset 0) sampai close()
+  return fwrite(&header_, sizeof(header_), 1, fp_) == 1;
+}
+
+bool Writer::add(const uint8_t *jpg, size_t len, int64_t timestamp_us) {
+  if (!fp_ || len == 0 || len > UINT32_MAX) {
+    return false;
+  }
+  replay_index_t e = {};
+  e.offset = pos_;
+  e.len = (uint32_t)len;
+  e.timestamp_us = timestamp_us;
+  uint16_t width = 0, height = 0;
+  jpeg_size(jpg, len, &width, &height);
+  e.width = width;
+  e.height = height;
+  if (fwrite(jpg, 1, len, fp_) != len) {
+    return false;
+  }
+  pos_ += len;
+  index_.push_back(e);
+  return true;
+}
+
+bool Writer::close() {
+  if (!fp_) {
+    return true;
+  }
+  header_.frame_count = (uint32_t)index_.size();
+  header_.index_offset = pos_;
+  bool ok = index_.empty() || fwrite(index_.data(), sizeof(replay_index_t), index_.size(), fp_) == index_.size();
+  ok = ok && fseek(fp_, 0, SEEK_SET) == 0 && fwrite(&header_, sizeof(header_), 1, fp_) == 1;
+  ok = fclose(fp_) == 0 && ok;
+  fp_ = NULL;
+  return ok;
+}
+
+// ---------- Reader ----------
+bool Reader::open(const std::string &path) {
+  close();
+  fp_ = fopen(path.c_str(), "rb");
+  if (!fp_) {
+    error_ = path + ": tidak bisa dibuka";
+    return false;
+  }
+  if (fread(&header_, sizeof(header_), 1, fp_) != 1 || memcmp(header_.magic, REPLAY_MAGIC, 4) != 0 ||
+      header_.header_len < sizeof(replay_header_t) || header_.index_entry_len < sizeof(replay_index_t)) {
+    error_ = path + ": bukan rekaman " REPLAY_MAGIC;
+    close();
+    return false;
+  }
+  header_.label[REPLAY_LABEL_LEN - 1] = '\0';
+  if (header_.index_offset == 0) {
+    error_ = path + ": rekaman tidak ditutup (index tidak ada)";
+    close();
+    return false;
+  }
+  // entry bisa lebih panjang di versi berikutnya: baca awalnya saja
+  index_.resize(header_.frame_count);
+  std::vector<uint8_t> raw(header_.index_entry_len);
+  if (fseeko(fp_, (off_t)header_.index_offset, SEEK_SET) != 0) {
+    error_ = path + ": index di luar file";
+    close();
+    return false;
+  }
+  for (replay_index_t &e : index_) {
+    if (fread(raw.data(), raw.size(), 1, fp_) != 1) {
+      error_ = path + ": index terpotong";
+      close();
+      return false;
+    }
+    memcpy(&e, raw.data(), sizeof(e));
+    if (e.offset + e.len > header_.index_offset) {
+      error_ = path + ": entry index di luar data";
+      close();
+      return false;
+    }
+  }
+  return true;
+}
+
+void Reader::close() {
+  if (fp_) {
+    fclose(fp_);
+    fp_ = NULL;
+  }
+  index_.clear();
+}
+
+bool Reader::read(size_t i, std::vector<uint8_t> *out) {
+  if (!fp_ || i >= index_.size()) {
+    return false;
+  }
+  const replay_index_t &e = index_[i];
+  out->resize(e.len);
+  return fseeko(fp_, (off_t)e.offset, SEEK_SET) == 0 && fread(out->data(), 1, e.len, fp_) == e.len;
+}
+
+int64_t Reader::duration_us() const {
+  return index_.size() > 1 ? index_.back().timestamp_us - index_.front().timestamp_us : 0;
+}
+
+int64_t Reader::mean_interval_us() const {
+  return index_.size() > 1 ? duration_us() / (int64_t)(index_.size() - 1) : 40000;
+}
+
+}  // namespace replay
@@ -0,0 +1,82 @@
+#pragma once
+// Format rekaman kamera (.bbr) untuk replay di simulator (sim/replay.cpp)
+// dan perekam tools/cam_record.cpp. Tidak bergantung pada stand-in sim.
+//
+// Layout (little-endian):
+//   replay_header_t                      64 byte
+//   JPEG frame 0, JPEG frame 1, ...      byte mentah, tanpa pembungkus
+//   replay_index_t[frame_count]          24 byte per frame, di index_offset
+//
+// Index ditulis saat close(); rekaman yang tidak ditutup (index_offset 0)
+// ditolak Reader.
+#include <stdint.h>
+#include <stdio.h>
+
+#include <string>
+#include <vector>
+
+#define REPLAY_MAGIC "BBR1"
+#define REPLAY_LABEL_LEN 32
+
+typedef struct __attribute__((packed)) {
+  char magic[4];               // "BBR1"
+  uint16_t header_len;         // sizeof(replay_header_t)
+  uint16_t index_entry_len;    // sizeof(replay_index_t)
+  uint32_t frame_count;
+  uint32_t reserved;
+  uint64_t index_offset;       // 0 = rekaman belum ditutup
+  int64_t recorded_at;         // epoch detik saat mulai merekam
+  char label[REPLAY_LABEL_LEN];  // mis. "night", "empty-crib"; diakhiri NUL
+} replay_header_t;
+
+typedef struct __attribute__((packed)) {
+  uint64_t offset;             // dari awal file
+  uint32_t len;
+  uint16_t width;              // dari SOF JPEG, 0 kalau tidak terbaca
+  uint16_t height;
+  int64_t timestamp_us;        // X-Timestamp asli (jam esp_timer perangkat)
+} replay_index_t;
+
+namespace replay {
+
+// Ukuran dari marker SOFn; false kalau bukan JPEG yang valid.
+bool jpeg_size(const uint8_t *data, size_t len, uint16_t *width, uint16_t *height);
+
+class Writer {
+ public:
+  ~Writer() { close(); }
+  bool open(const std::string &path, const std::string &label);
+  bool add(const uint8_t *jpg, size_t len, int64_t timestamp_us);
+  bool close();  // tulis index lalu tambal header
+  size_t frames() const { return index_.size(); }
+  uint64_t bytes() const { return pos_; }
+
+ private:
+  FILE *fp_ = NULL;
+  replay_header_t header_ = {};
+  std::vector<replay_index_t> index_;
+  uint64_t pos_ = 0;
+};
+
+class Reader {
+ public:
+  ~Reader() { close(); }
+  bool open(const std::string &path);  // baca header + index saja
+  void close();
+  bool read(size_t i, std::vector<uint8_t> *out);
+  size_t frames() const { return index_.size(); }
+  const replay_index_t &entry(size_t i) const { return index_[i]; }
+  const replay_header_t &header() const { return header_; }
+  // Durasi rekaman dan jarak rata-rata antar frame (µs).
+  int64_t duration_us() const;
+  int64_t mean_interval_us() const;
+  const std::string &error() const { return error_; }
+
+ private:
+  FILE *fp_ = NULL;
+  replay_header_t header_ = {};
+  std::vector<replay_index_t> index_;
+  std::string error_;
+};
+
+}  // namespace replay
@@ -0,0 +1,44 @@
+#pragma once
+// Sumber frame untuk stand-in esp_camera (sim/camera.cpp). Default-nya pola
+// sintetis, atau replay rekaman kalau SIM_CAMERA_REPLAY diset (sim/replay.cpp);
+// sumber lain dipasang dengan set_source() sebelum esp_camera_init().
+#include <stdint.h>
+
+#include <vector>
+
+#include "sensor.h"
+
+namespace sim_cam {
+
+struct Frame {
+  std::vector<uint8_t> data;
+  pixformat_t format;
+  int width;
+  int height;
+  int64_t timestamp_us;  // jam esp_timer saat "capture"
+};
+
+class Source {
+ public:
+  virtual ~Source() {}
+  // Blok sampai frame berikutnya jatuh tempo lalu isi *f. Setting sensor
+  // (framesize, pixformat, quality) dibaca dari s. false = sumber habis.
+  virtual bool next(const sensor_t *s, Frame *f) = 0;
+  // true = setiap frame harus sampai ke fb_get (replay kecepatan maksimum):
+  // capture menunggu slot kosong alih-alih membuang/menimpa frame.
+  virtual bool lossless() const { return false; }
+};
+
+// Kepemilikan pindah ke kamera; NULL = kembali ke pola sintetis.
+void set_source(Source *src);
+
+// Sumber replay dari SIM_CAMERA_REPLAY; NULL kalau tidak diset atau gagal.
+Source *replay_from_env();
+
+// Isi *f dari piksel BGR (urutan RGB888 esp32-camera) dalam format sensor.
+bool encode_bgr(const uint8_t *bgr, int w, int h, pixformat_t format, int quality, Frame *f);
+
+// esp32-camera quality 0..63 (kecil = bagus) -> quality libjpeg.
+int libjpeg_quality(int cam_quality);
+
+}  // namespace sim_cam
@@ -0,0 +1,74 @@
+// Sketch pendamping untuk menjalankan app_httpd.cpp di simulator host: setara
+// contoh CameraWebServer (kamera + WiFi + startCameraServer), karena 5_3.ino
+// sendiri hanya memakai server addon. Dikompilasi bersama modul
+// "BoboBee Stream/5_3/*.cpp" tanpa 5_3.ino, lihat sim/README.md.
+#include <Arduino.h>
+#include <WiFi.h>
+#include "esp_camera.h"
+
+#define LED_GPIO_NUM 47
+
+void startCameraServer();
+void setupLedFlash(int pin);
+
+void setup() {
+  Serial.begin(115200);
+  Serial.println();
+
+  camera_config_t config;
+  memset(&config, 0, sizeof(config));
+  config.ledc_channel = LEDC_CHANNEL_0;
+  config.ledc_timer = LEDC_TIMER_0;
+  config.xclk_freq_hz = 20000000;
+  config.frame_size = FRAMESIZE_UXGA;
+  config.pixel_format = PIXFORMAT_JPEG;
+  config.grab_mode = CAMERA_GRAB_WHEN_EMPTY;
+  config.fb_location = CAMERA_FB_IN_PSRAM;
+  config.jpeg_quality = 12;
+  config.fb_count = 1;
+
+  // sama dengan contoh: PSRAM -> 2 buffer, GRAB_LATEST, kualitas lebih baik
+  if (psramFound()) {
+    config.jpeg_quality = 10;
+    config.fb_count = 2;
+    config.grab_mode = CAMERA_GRAB_LATEST;
+  } else {
+    config.frame_size = FRAMESIZE_SVGA;
+    config.fb_location = CAMERA_FB_IN_DRAM;
+  }
+
+  esp_err_t err = esp_camera_init(&config);
+  if (err != ESP_OK) {
+    Serial.printf("Camera init failed with error 0x%x", err);
+    return;
+  }
+
+  sensor_t *s = esp_camera_sensor_get();
+  if (s->id.PID == OV3660_PID) {
+    s->set_vflip(s, 1);
+    s->set_brightness(s, 1);
+    s->set_saturation(s, -2);
+  }
+  // framesize kecil supaya frame rate awal tinggi
+  s->set_framesize(s, FRAMESIZE_QVGA);
+
+  setupLedFlash(LED_GPIO_NUM);
+
+  WiFi.begin("sim", "sim");
+  WiFi.setSleep(false);
+  while (WiFi.status() != WL_CONNECTED) {
+    delay(500);
+    Serial.print(".");
+  }
+  Serial.println("WiFi connected");
+
+  startCameraServer();
+
+  Serial.print("Camera Ready! Use 'http://");
+  Serial.print(WiFi.localIP());
+  Serial.println("' to connect");
+}
+
+void loop() {
+  delay(10000);
+}
@@ -0,0 +1,295 @@
+// Stand-in WebServer (arduino-esp32) untuk simulator host. Satu request per
+// handleClient(), dilayani di thread loop() lalu koneksi ditutup, seperti
+// library aslinya tanpa keep-alive. Argumen dari query string dan body
+// application/x-www-form-urlencoded; body lain tersedia sebagai arg("plain").
+#include <errno.h>
+#include <netinet/in.h>
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <string>
+
+#include "Arduino.h"
+#include "WebServer.h"
+#include "sim.h"
+
+#define WEBSERVER_MAX_DATA_WAIT_MS 5000
+#define WEBSERVER_MAX_HEADER 8192
+
+static int method_from(const std::string &s) {
+  static const enum http_method all[] = {HTTP_DELETE, HTTP_GET, HTTP_HEAD, HTTP_POST, HTTP_PUT, HTTP_CONNECT, HTTP_OPTIONS, HTTP_TRACE, HTTP_PATCH};
+  for (enum http_method m : all) {
+    if (s == http_method_str(m)) {
+      return m;
+    }
+  }
+  return -1;
+}
+
+static const char *reason(int code) {
+  switch (code) {
+    case 200: return "OK";
+    case 201: return "Created";
+    case 204: return "No Content";
+    case 301: return "Moved Permanently";
+    case 302: return "Found";
+    case 304: return "Not Modified";
+    case 400: return "Bad Request";
+    case 401: return "Unauthorized";
+    case 403: return "Forbidden";
+    case 404: return "Not Found";
+    case 405: return "Method Not Allowed";
+    case 500: return "Internal Server Error";
+    case 503: return "Service Unavailable";
+    default: return "";
+  }
+}
+
+static int hexval(char c) {
+  return c >= '0' && c <= '9' ? c - '0' : c >= 'a' && c <= 'f' ? c - 'a' + 10 : c >= 'A' && c <= 'F' ? c - 'A' + 10 : -1;
+}
+
+static String url_decode(const std::string &s) {
+  std::string out;
+  for (size_t i = 0; i < s.size(); i++) {
+    if (s[i] == '+') {
+      out += ' ';
+    } else if (s[i] == '%' && i + 2 < s.size() && hexval(s[i + 1]) >= 0 && hexval(s[i + 2]) >= 0) {
+      out += (char)(hexval(s[i + 1]) * 16 + hexval(s[i + 2]));
+      i += 2;
+    } else {
+      out += s[i];
+    }
+  }
+  return String(out.c_str());
+}
+
+static void parse_args(const std::string &q, std::vector<std::pair<String, String>> *args) {
+  size_t pos = 0;
+  while (pos < q.size()) {
+    size_t amp = q.find('&', pos);
+    std::string kv = q.substr(pos, amp == std::string::npos ? std::string::npos : amp - pos);
+    if (!kv.empty()) {
+      size_t eq = kv.find('=');
+      args->push_back({url_decode(kv.substr(0, eq)), eq == std::string::npos ? String("") : url_decode(kv.substr(eq + 1))});
+    }
+    if (amp == std::string::npos) {
+      break;
+    }
+    pos = amp + 1;
+  }
+}
+
+WebServer::WebServer(int port) : port_(port) {}
+
+WebServer::~WebServer() {
+  close();
+}
+
+void WebServer::begin() {
+  if (listen_fd_ >= 0) {
+    return;
+  }
+  int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+  int one = 1;
+  setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+  struct sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons((uint16_t)sim_port(port_));
+  addr.sin_addr.s_addr = htonl(INADDR_ANY);
+  if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 || listen(fd, 4) != 0) {
+    log_e("WebServer bind :%d failed: %s", sim_port(port_), strerror(errno));
+    ::close(fd);
+    return;
+  }
+  listen_fd_ = fd;
+  log_i("WebServer :%d listening on :%d", port_, sim_port(port_));
+}
+
+void WebServer::close() {
+  if (listen_fd_ >= 0) {
+    ::close(listen_fd_);
+    listen_fd_ = -1;
+  }
+}
+
+void WebServer::on(const String &uri, HTTPMethod method, THandlerFunction fn) {
+  routes_.push_back({uri, method, fn});
+}
+
+bool WebServer::read_request(int fd) {
+  std::string in;
+  char buf[1024];
+  size_t end;
+  while ((end = in.find("\r\n\r\n")) == std::string::npos) {
+    ssize_t n = recv(fd, buf, sizeof(buf), 0);
+    if (n <= 0 || in.size() > WEBSERVER_MAX_HEADER) {
+      return false;
+    }
+    in.append(buf, n);
+  }
+  size_t line_end = in.find("\r\n");
+  std::string line = in.substr(0, line_end);
+  size_t sp1 = line.find(' '), sp2 = line.rfind(' ');
+  if (sp1 == std::string::npos || sp2 == sp1) {
+    return false;
+  }
+  int m = method_from(line.substr(0, sp1));
+  method_ = m < 0 ? HTTP_GET : (HTTPMethod)m;
+  std::string target = line.substr(sp1 + 1, sp2 - sp1 - 1);
+  size_t q = target.find('?');
+  uri_ = url_decode(target.substr(0, q));
+  args_.clear();
+  req_headers_.clear();
+  if (q != std::string::npos) {
+    parse_args(target.substr(q + 1), &args_);
+  }
+  size_t content_len = 0;
+  std::string content_type;
+  for (size_t pos = line_end + 2; pos < end;) {
+    size_t e = in.find("\r\n", pos);
+    std::string h = in.substr(pos, e - pos);
+    size_t colon = h.find(':');
+    if (colon != std::string::npos) {
+      std::string k = h.substr(0, colon), v = h.substr(colon + 1);
+      v.erase(0, v.find_first_not_of(' '));
+      req_headers_.push_back({String(k.c_str()), String(v.c_str())});
+      if (strcasecmp(k.c_str(), "Content-Length") == 0) {
+        content_len = strtoul(v.c_str(), NULL, 10);
+      } else if (strcasecmp(k.c_str(), "Content-Type") == 0) {
+        content_type = v;
+      }
+    }
+    pos = e + 2;
+  }
+  std::string body = in.substr(end + 4);
+  while (body.size() < content_len) {
+    ssize_t n = recv(fd, buf, sizeof(buf), 0);
+    if (n <= 0) {
+      return false;
+    }
+    body.append(buf, n);
+  }
+  body.resize(content_len);
+  if (content_len) {
+    if (content_type.compare(0, 33, "application/x-www-form-urlencoded") == 0) {
+      parse_args(body, &args_);
+    } else {
+      args_.push_back({String("plain"), String(body.c_str())});
+    }
+  }
+  return true;
+}
+
+void WebServer::handleClient() {
+  if (listen_fd_ < 0) {
+    return;
+  }
+  int fd = accept(listen_fd_, NULL, NULL);
+  if (fd < 0) {
+    return;
+  }
+  struct timeval tv = {WEBSERVER_MAX_DATA_WAIT_MS / 1000, 0};
+  setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+  setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+  if (!read_request(fd)) {
+    ::close(fd);
+    return;
+  }
+  client_fd_ = fd;
+  sent_ = false;
+  resp_headers_.clear();
+  if (sim_verbose()) {
+    log_i("WebServer %s %s", http_method_str(method_), uri_.c_str());
+  }
+  bool handled = false;
+  for (const Route &r : routes_) {
+    if (r.uri == uri_ && ((int)r.method == HTTP_ANY || r.method == method_)) {
+      r.fn();
+      handled = true;
+      break;
+    }
+  }
+  if (!handled) {
+    if (not_found_) {
+      not_found_();
+    } else {
+      send(404, "text/plain", String("Not found: ") + uri_);
+    }
+  }
+  ::close(fd);
+  client_fd_ = -1;
+}
+
+String WebServer::arg(const String &name) const {
+  for (const auto &a : args_) {
+    if (a.first == name) {
+      return a.second;
+    }
+  }
+  return String("");
+}
+
+String WebServer::arg(int i) const {
+  return i >= 0 && i < (int)args_.size() ? args_[i].second : String("");
+}
+
+String WebServer::argName(int i) const {
+  return i >= 0 && i < (int)args_.size() ? args_[i].first : String("");
+}
+
+bool WebServer::hasArg(const String &name) const {
+  for (const auto &a : args_) {
+    if (a.first == name) {
+      return true;
+    }
+  }
+  return false;
+}
+
+String WebServer::header(const String &name) const {
+  for (const auto &h : req_headers_) {
+    if (strcasecmp(h.first.c_str(), name.c_str()) == 0) {
+      return h.second;
+    }
+  }
+  return String("");
+}
+
+void WebServer::sendHeader(const String &name, const String &value, bool first) {
+  if (first) {
+    resp_headers_.insert(resp_headers_.begin(), {name, value});
+  } else {
+    resp_headers_.push_back({name, value});
+  }
+}
+
+void WebServer::send(int code, const char *content_type, const String &content) {
+  if (client_fd_ < 0 || sent_) {
+    return;
+  }
+  sent_ = true;
+  std::string out = "HTTP/1.1 " + std::to_string(code) + " " + reason(code) + "\r\n";
+  if (content_type) {
+    out += std::string("Content-Type: ") + content_type + "\r\n";
+  }
+  out += "Content-Length: " + std::to_string(content.length()) + "\r\n";
+  for (const auto &h : resp_headers_) {
+    out += std::string(h.first.c_str()) + ": " + h.second.c_str() + "\r\n";
+  }
+  out += "Connection: close\r\n\r\n";
+  if (method_ != HTTP_HEAD) {
+    out.append(content.c_str(), content.length());
+  }
+  for (size_t off = 0; off < out.size();) {
+    ssize_t n = ::send(client_fd_, out.data() + off, out.size() - off, MSG_NOSIGNAL);
+    if (n <= 0) {
+      break;
+    }
+    off += n;
+  }
+}
@@ -0,0 +1,616 @@
+// Stand-in WebSocketsServer (RFC 6455) untuk simulator host. Lihat header
+// untuk perilaku; di sini: handshake (SHA-1 + base64 sendiri, tanpa
+// OpenSSL), parser frame klien (ber-mask, fragmen, ping/pong/close) dan
+// heartbeat seperti WebSocketsServer::handleHBPing.
+#include <errno.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "Arduino.h"
+#include "WebSocketsServer.h"
+#include "esp32-hal-log.h"
+#include "sim.h"
+
+#define WS_SEND_TIMEOUT_S 5
+#define WS_MAX_HEADER 4096
+#define WS_MAX_MESSAGE (1 << 20)
+
+// ---------- SHA-1 / base64 ----------
+static void sha1(const uint8_t *data, size_t len, uint8_t out[20]) {
+  uint32_t h[5] = {0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0};
+  std::string m((const char *)data, len);
+  uint64_t bits = (uint64_t)len * 8;
+  m += (char)0x80;
+  while (m.size() % 64 != 56) {
+    m += (char)0;
+  }
+  for (int i = 7; i >= 0; i--) {
+    m += (char)(bits >> (i * 8));
+  }
+  for (size_t off = 0; off < m.size(); off += 64) {
+    uint32_t w[80];
+    for (int i = 0; i < 16; i++) {
+      const uint8_t *p = (const uint8_t *)&m[off + i * 4];
+      w[i] = (uint32_t)p[0] << 24 | (uint32_t)p[1] << 16 | (uint32_t)p[2] << 8 | p[3];
+    }
+    for (int i = 16; i < 80; i++) {
+      uint32_t x = w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16];
+      w[i] = x << 1 | x >> 31;
+    }
+    uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+    for (int i = 0; i < 80; i++) {
+      uint32_t f, k;
+      if (i < 20) {
+        f = (b & c) | (~b & d), k = 0x5A827999;
+      } else if (i < 40) {
+        f = b ^ c ^ d, k = 0x6ED9EBA1;
+      } else if (i < 60) {
+        f = (b & c) | (b & d) | (c & d), k = 0x8F1BBCDC;
+      } else {
+        f = b ^ c ^ d, k = 0xCA62C1D6;
+      }
+      uint32_t t = (a << 5 | a >> 27) + f + e + k + w[i];
+      e = d, d = c, c = b << 30 | b >> 2, b = a, a = t;
+    }
+    h[0] += a, h[1] += b, h[2] += c, h[3] += d, h[4] += e;
+  }
+  for (int i = 0; i < 20; i++) {
+    out[i] = (uint8_t)(h[i / 4] >> (24 - (i % 4) * 8));
+  }
+}
+
+static std::string base64(const uint8_t *d, size_t len) {
+  static const char tbl[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  std::string out;
+  for (size_t i = 0; i < len; i += 3) {
+    uint32_t v = (uint32_t)d[i] << 16 | (i + 1 < len ? (uint32_t)d[i + 1] << 8 : 0) | (i + 2 < len ? d[i + 2] : 0);
+    out += tbl[v >> 18 & 63];
+    out += tbl[v >> 12 & 63];
+    out += i + 1 < len ? tbl[v >> 6 & 63] : '=';
+    out += i + 2 < len ? tbl[v & 63] : '=';
+  }
+  return out;
+}
+
+// ---------- Server ----------
+enum { WS_OP_CONT = 0x0, WS_OP_TEXT = 0x1, WS_OP_BIN = 0x2, WS_OP_CLOSE = 0x8, WS_OP_PING = 0x9, WS_OP_PONG = 0xA };
+
+// Sisi kirim satu klien. Pengirim tidak memegang mutex server: kirim
+// blocking ke klien macet hanya menahan pengirim ke klien itu, bukan
+// loop() atau klien lain.
+struct WsTx {
+  std::mutex mu;  // satu frame utuh per giliran
+  int fd;
+  std::atomic<bool> closed{false};
+  explicit WsTx(int f) : fd(f) {}
+};
+
+struct WsClient {
+  int fd = -1;
+  bool connected = false;  // handshake selesai
+  std::shared_ptr<WsTx> tx;  // ada selama connected
+  std::string in;
+  IPAddress ip;
+  uint32_t last_ping_ms = 0;
+  bool pong_pending = false;
+  uint8_t missed_pongs = 0;
+};
+
+struct WebSocketsServer::Impl {
+  uint16_t port;
+  String protocol;
+  int listen_fd = -1;
+  WsClient clients[WEBSOCKETS_SERVER_CLIENT_MAX];
+  WebSocketServerEvent cb;
+  std::recursive_mutex mu;
+  std::mutex tx_mu;  // hanya melindungi clients[].tx
+  uint32_t hb_interval = 0, hb_timeout = 0;
+  uint8_t hb_count = 0;
+
+  void event(uint8_t num, WStype_t type, uint8_t *payload, size_t len) {
+    if (cb) {
+      cb(num, type, payload, len);
+    }
+  }
+
+  void drop(uint8_t num, bool notify) {
+    WsClient &c = clients[num];
+    if (c.fd < 0) {
+      return;
+    }
+    bool was = c.connected;
+    std::shared_ptr<WsTx> tx;
+    {
+      std::lock_guard<std::mutex> lock(tx_mu);
+      tx.swap(c.tx);
+    }
+    if (tx) {
+      // bangunkan pengirim yang sedang blok, tunggu ia lepas, baru fd ditutup
+      ::shutdown(c.fd, SHUT_RDWR);
+      std::lock_guard<std::mutex> lock(tx->mu);
+      tx->closed = true;
+    }
+    ::close(c.fd);
+    {
+      std::lock_guard<std::mutex> lock(tx_mu);
+      c = WsClient();
+    }
+    if (sim_verbose()) {
+      log_i("ws:%u client %u closed", port, num);
+    }
+    if (was && notify) {
+      event(num, WStype_DISCONNECTED, NULL, 0);
+    }
+  }
+
+  // Kirim blocking. Gagal = socket di-shutdown; poll() di loop() yang
+  // kemudian memutus klien (pengirim tidak menyentuh mu).
+  bool send_all(uint8_t num, WsTx *tx, const struct iovec *iov, int iovcnt) {
+    (void)num;  // hanya untuk log_w
+    struct iovec v[3];
+    memcpy(v, iov, sizeof(struct iovec) * iovcnt);
+    struct msghdr mh;
+    memset(&mh, 0, sizeof(mh));
+    mh.msg_iov = v;
+    mh.msg_iovlen = iovcnt;
+    while (mh.msg_iovlen > 0) {
+      ssize_t n = sendmsg(tx->fd, &mh, MSG_NOSIGNAL);
+      if (n < 0 && errno == EINTR) {
+        continue;
+      }
+      if (n <= 0) {
+        log_w("ws:%u client %u send failed (%s)", port, num, n < 0 ? strerror(errno) : "closed");
+        ::shutdown(tx->fd, SHUT_RDWR);
+        tx->closed = true;
+        return false;
+      }
+      while (n > 0 && mh.msg_iovlen > 0) {
+        if ((size_t)n >= mh.msg_iov->iov_len) {
+          n -= mh.msg_iov->iov_len;
+          mh.msg_iov++;
+          mh.msg_iovlen--;
+        } else {
+          mh.msg_iov->iov_base = (char *)mh.msg_iov->iov_base + n;
+          mh.msg_iov->iov_len -= n;
+          n = 0;
+        }
+      }
+    }
+    return true;
+  }
+
+  bool send_frame(uint8_t num, uint8_t op, const uint8_t *payload, size_t len) {
+    if (num >= WEBSOCKETS_SERVER_CLIENT_MAX) {
+      return false;
+    }
+    std::shared_ptr<WsTx> tx;
+    {
+      std::lock_guard<std::mutex> lock(tx_mu);
+      tx = clients[num].tx;
+    }
+    if (!tx) {
+      return false;
+    }
+    uint8_t hdr[10];
+    size_t hl = 2;
+    hdr[0] = 0x80 | op;
+    if (len < 126) {
+      hdr[1] = (uint8_t)len;
+    } else if (len < 65536) {
+      hdr[1] = 126;
+      hdr[2] = (uint8_t)(len >> 8);
+      hdr[3] = (uint8_t)len;
+      hl = 4;
+    } else {
+      hdr[1] = 127;
+      for (int i = 0; i < 8; i++) {
+        hdr[2 + i] = (uint8_t)((uint64_t)len >> (56 - i * 8));
+      }
+      hl = 10;
+    }
+    struct iovec iov[2] = {{hdr, hl}, {(void *)payload, len}};
+    std::lock_guard<std::mutex> lock(tx->mu);
+    return !tx->closed && send_all(num, tx.get(), iov, len ? 2 : 1);
+  }
+
+  void accept_new() {
+    for (;;) {
+      struct sockaddr_in addr;
+      socklen_t alen = sizeof(addr);
+      int fd = accept(listen_fd, (struct sockaddr *)&addr, &alen);
+      if (fd < 0) {
+        return;
+      }
+      int slot = -1;
+      for (int i = 0; i < WEBSOCKETS_SERVER_CLIENT_MAX; i++) {
+        if (clients[i].fd < 0) {
+          slot = i;
+          break;
+        }
+      }
+      if (slot < 0) {
+        static const char busy[] = "HTTP/1.1 503 Service Unavailable\r\nServer: arduino-WebSocket-Server\r\nContent-Length: 32\r\nConnection: close\r\n\r\nThis Server is full, no free slot";
+        send(fd, busy, sizeof(busy) - 2, MSG_NOSIGNAL);
+        ::close(fd);
+        log_w("ws:%u no free client slot", port);
+        continue;
+      }
+      struct timeval tv = {WS_SEND_TIMEOUT_S, 0};
+      setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+      int one = 1;
+      setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+      WsClient &c = clients[slot];
+      std::lock_guard<std::mutex> lock(tx_mu);
+      c = WsClient();
+      c.fd = fd;
+      c.ip = IPAddress((uint32_t)addr.sin_addr.s_addr);
+      c.last_ping_ms = millis();
+    }
+  }
+
+  static std::string header(const std::string &req, const char *name) {
+    size_t nl = strlen(name), pos = req.find("\r\n");
+    while (pos != std::string::npos && pos + 2 < req.size()) {
+      size_t start = pos + 2, end = req.find("\r\n", start);
+      if (end == std::string::npos || end == start) {
+        break;
+      }
+      if (end - start > nl && req[start + nl] == ':' && strncasecmp(&req[start], name, nl) == 0) {
+        size_t v = start + nl + 1;
+        while (v < end && req[v] == ' ') {
+          v++;
+        }
+        return req.substr(v, end - v);
+      }
+      pos = end;
+    }
+    return std::string();
+  }
+
+  // false = klien ditutup
+  bool handshake(uint8_t num) {
+    WsClient &c = clients[num];
+    size_t end = c.in.find("\r\n\r\n");
+    if (end == std::string::npos) {
+      if (c.in.size() > WS_MAX_HEADER) {
+        drop(num, false);
+        return false;
+      }
+      return true;
+    }
+    std::string req = c.in.substr(0, end + 2);
+    c.in.erase(0, end + 4);
+    std::string key = header(req, "Sec-WebSocket-Key");
+    if (req.compare(0, 4, "GET ") != 0 || strcasecmp(header(req, "Upgrade").c_str(), "websocket") != 0 || key.empty()) {
+      static const char bad[] = "HTTP/1.1 400 Bad Request\r\nServer: arduino-WebSocket-Server\r\nContent-Type: text/plain\r\nContent-Length: 32\r\nConnection: close\r\nSec-WebSocket-Version: 13\r\n\r\nThis is a Websocket server only!";
+      send(c.fd, bad, sizeof(bad) - 1, MSG_NOSIGNAL);
+      drop(num, false);
+      return false;
+    }
+    std::string accept = key + "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+    uint8_t digest[20];
+    sha1((const uint8_t *)accept.data(), accept.size(), digest);
+    std::string resp = "HTTP/1.1 101 Switching Protocols\r\nServer: arduino-WebSocket-Server\r\nUpgrade: websocket\r\nConnection: Upgrade\r\nSec-WebSocket-Version: 13\r\nSec-WebSocket-Accept: " + base64(digest, 20) + "\r\n";
+    std::string proto = header(req, "Sec-WebSocket-Protocol");
+    if (!proto.empty()) {
+      resp += "Sec-WebSocket-Protocol: " + std::string(protocol.c_str()) + "\r\n";
+    }
+    resp += "\r\n";
+    if (send(c.fd, resp.data(), resp.size(), MSG_NOSIGNAL) != (ssize_t)resp.size()) {
+      drop(num, false);
+      return false;
+    }
+    c.connected = true;
+    c.last_ping_ms = millis();
+    {
+      std::lock_guard<std::mutex> lock(tx_mu);
+      c.tx = std::make_shared<WsTx>(c.fd);
+    }
+    size_t sp = req.find(' ', 4);
+    std::string url = req.substr(4, sp == std::string::npos ? std::string::npos : sp - 4);
+    if (sim_verbose()) {
+      log_i("ws:%u client %u connected %s", port, num, url.c_str());
+    }
+    event(num, WStype_CONNECTED, (uint8_t *)url.c_str(), url.size());
+    return true;
+  }
+
+  // Satu frame lengkap di c.in -> diproses. false = belum lengkap / klien ditutup.
+  bool frame(uint8_t num) {
+    WsClient &c = clients[num];
+    if (c.in.size() < 2) {
+      return false;
+    }
+    const uint8_t *p = (const uint8_t *)c.in.data();
+    bool fin = p[0] & 0x80, masked = p[1] & 0x80;
+    uint8_t op = p[0] & 0x0F;
+    uint64_t len = p[1] & 0x7F;
+    size_t hl = 2;
+    if (len == 126) {
+      if (c.in.size() < 4) {
+        return false;
+      }
+      len = (uint64_t)p[2] << 8 | p[3];
+      hl = 4;
+    } else if (len == 127) {
+      if (c.in.size() < 10) {
+        return false;
+      }
+      len = 0;
+      for (int i = 0; i < 8; i++) {
+        len = len << 8 | p[2 + i];
+      }
+      hl = 10;
+    }
+    if (len > WS_MAX_MESSAGE || !masked) {
+      // RFC 6455 5.1: frame klien wajib di-mask
+      log_w("ws:%u client %u bad frame (len %llu, masked %d)", port, num, (unsigned long long)len, masked);
+      uint8_t code[2] = {1002 >> 8, 1002 & 0xFF};
+      send_frame(num, WS_OP_CLOSE, code, 2);
+      drop(num, true);
+      return false;
+    }
+    hl += 4;
+    if (c.in.size() < hl + len) {
+      return false;
+    }
+    const uint8_t *mask = p + hl - 4;
+    std::string payload(c.in, hl, (size_t)len);
+    for (size_t i = 0; i < payload.size(); i++) {
+      payload[i] ^= mask[i & 3];
+    }
+    c.in.erase(0, hl + (size_t)len);
+
+    switch (op) {
+      case WS_OP_PING:
+        send_frame(num, WS_OP_PONG, (const uint8_t *)payload.data(), payload.size());
+        event(num, WStype_PING, (uint8_t *)&payload[0], payload.size());
+        return clients[num].fd >= 0;
+      case WS_OP_PONG:
+        c.pong_pending = false;
+        c.missed_pongs = 0;
+        event(num, WStype_PONG, (uint8_t *)&payload[0], payload.size());
+        return clients[num].fd >= 0;
+      case WS_OP_CLOSE: {
+        uint8_t code[2] = {1000 >> 8, 1000 & 0xFF};
+        send_frame(num, WS_OP_CLOSE, code, 2);
+        drop(num, true);
+        return false;
+      }
+      case WS_OP_TEXT:
+      case WS_OP_BIN:
+        if (!fin) {
+          event(num, op == WS_OP_TEXT ? WStype_FRAGMENT_TEXT_START : WStype_FRAGMENT_BIN_START, (uint8_t *)&payload[0], payload.size());
+          return clients[num].fd >= 0;
+        }
+        // seperti aslinya, payload teks diakhiri NUL
+        event(num, op == WS_OP_TEXT ? WStype_TEXT : WStype_BIN, (uint8_t *)&payload[0], payload.size());
+        return clients[num].fd >= 0;
+      case WS_OP_CONT:
+        event(num, fin ? WStype_FRAGMENT_FIN : WStype_FRAGMENT, (uint8_t *)&payload[0], payload.size());
+        return clients[num].fd >= 0;
+      default:
+        drop(num, true);
+        return false;
+    }
+  }
+
+  void heartbeat(uint8_t num) {
+    WsClient &c = clients[num];
+    if (!hb_interval || !c.connected) {
+      return;
+    }
+    uint32_t now = millis();
+    if (c.pong_pending) {
+      if (now - c.last_ping_ms > hb_timeout) {
+        c.pong_pending = false;
+        c.last_ping_ms = now;
+        if (++c.missed_pongs >= hb_count) {
+          log_w("ws:%u client %u heartbeat timeout", port, num);
+          drop(num, true);
+        }
+      }
+    } else if (now - c.last_ping_ms > hb_interval) {
+      c.last_ping_ms = now;
+      c.pong_pending = true;
+      send_frame(num, WS_OP_PING, NULL, 0);
+    }
+  }
+
+  void poll(uint8_t num) {
+    WsClient &c = clients[num];
+    char buf[4096];
+    for (;;) {
+      ssize_t n = recv(c.fd, buf, sizeof(buf), MSG_DONTWAIT);
+      if (n > 0) {
+        c.in.append(buf, n);
+        continue;
+      }
+      if (n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+        drop(num, true);
+        return;
+      }
+      break;
+    }
+    if (!c.connected && !handshake(num)) {
+      return;
+    }
+    while (clients[num].fd >= 0 && clients[num].connected && frame(num)) {
+    }
+    if (clients[num].fd >= 0) {
+      heartbeat(num);
+    }
+  }
+};
+
+WebSocketsServer::WebSocketsServer(uint16_t port, const String &origin, const String &protocol) : impl_(new Impl) {
+  (void)origin;
+  impl_->port = port;
+  impl_->protocol = protocol;
+}
+
+WebSocketsServer::~WebSocketsServer() {
+  close();
+  delete impl_;
+}
+
+void WebSocketsServer::begin() {
+  std::lock_guard<std::recursive_mutex> lock(impl_->mu);
+  if (impl_->listen_fd >= 0) {
+    return;
+  }
+  int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+  int one = 1;
+  setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+  struct sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons((uint16_t)sim_port(impl_->port));
+  addr.sin_addr.s_addr = htonl(INADDR_ANY);
+  if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 || listen(fd, 8) != 0) {
+    log_e("ws:%u bind :%d failed: %s", impl_->port, sim_port(impl_->port), strerror(errno));
+    ::close(fd);
+    return;
+  }
+  impl_->listen_fd = fd;
+  log_i("ws:%u listening on :%d", impl_->port, sim_port(impl_->port));
+}
+
+void WebSocketsServer::close() {
+  std::lock_guard<std::recursive_mutex> lock(impl_->mu);
+  disconnect();
+  if (impl_->listen_fd >= 0) {
+    ::close(impl_->listen_fd);
+    impl_->listen_fd = -1;
+  }
+}
+
+void WebSocketsServer::loop() {
+  std::lock_guard<std::recursive_mutex> lock(impl_->mu);
+  if (impl_->listen_fd < 0) {
+    return;
+  }
+  impl_->accept_new();
+  for (uint8_t i = 0; i < WEBSOCKETS_SERVER_CLIENT_MAX; i++) {
+    if (impl_->clients[i].fd >= 0) {
+      impl_->poll(i);
+    }
+  }
+}
+
+void WebSocketsServer::onEvent(WebSocketServerEvent cb) {
+  std::lock_guard<std::recursive_mutex> lock(impl_->mu);
+  impl_->cb = cb;
+}
+
+// Kirim tanpa mu (lihat WsTx); headerToPayload: payload diawali
+// WEBSOCKETS_MAX_HEADER_SIZE byte cadangan untuk header frame.
+bool WebSocketsServer::sendTXT(uint8_t num, const uint8_t *payload, size_t length, bool headerToPayload) {
+  if (length == 0 && payload) {
+    length = strlen((const char *)payload + (headerToPayload ? WEBSOCKETS_MAX_HEADER_SIZE : 0));
+  }
+  return impl_->send_frame(num, WS_OP_TEXT, payload + (headerToPayload ? WEBSOCKETS_MAX_HEADER_SIZE : 0), length);
+}
+
+bool WebSocketsServer::broadcastTXT(const uint8_t *payload, size_t length, bool headerToPayload) {
+  bool ok = true;
+  for (uint8_t i = 0; i < WEBSOCKETS_SERVER_CLIENT_MAX; i++) {
+    if (clientIsConnected(i)) {
+      ok &= sendTXT(i, payload, length, headerToPayload);
+    }
+  }
+  return ok;
+}
+
+bool WebSocketsServer::sendBIN(uint8_t num, const uint8_t *payload, size_t length, bool headerToPayload) {
+  return impl_->send_frame(num, WS_OP_BIN, payload + (headerToPayload ? WEBSOCKETS_MAX_HEADER_SIZE : 0), length);
+}
+
+bool WebSocketsServer::broadcastBIN(const uint8_t *payload, size_t length, bool headerToPayload) {
+  bool ok = true;
+  for (uint8_t i = 0; i < WEBSOCKETS_SERVER_CLIENT_MAX; i++) {
+    if (clientIsConnected(i)) {
+      ok &= sendBIN(i, payload, length, headerToPayload);
+    }
+  }
+  return ok;
+}
+
+bool WebSocketsServer::sendPing(uint8_t num, const uint8_t *payload, size_t length) {
+  return impl_->send_frame(num, WS_OP_PING, payload, length);
+}
+
+bool WebSocketsServer::broadcastPing(const uint8_t *payload, size_t length) {
+  bool ok = true;
+  for (uint8_t i = 0; i < WEBSOCKETS_SERVER_CLIENT_MAX; i++) {
+    if (clientIsConnected(i)) {
+      ok &= sendPing(i, payload, length);
+    }
+  }
+  return ok;
+}
+
+void WebSocketsServer::disconnect() {
+  std::lock_guard<std::recursive_mutex> lock(impl_->mu);
+  for (uint8_t i = 0; i < WEBSOCKETS_SERVER_CLIENT_MAX; i++) {
+    disconnect(i);
+  }
+}
+
+void WebSocketsServer::disconnect(uint8_t num) {
+  std::lock_guard<std::recursive_mutex> lock(impl_->mu);
+  if (num >= WEBSOCKETS_SERVER_CLIENT_MAX || impl_->clients[num].fd < 0) {
+    return;
+  }
+  if (impl_->clients[num].connected) {
+    uint8_t code[2] = {1000 >> 8, 1000 & 0xFF};
+    impl_->send_frame(num, WS_OP_CLOSE, code, 2);
+  }
+  impl_->drop(num, true);
+}
+
+uint8_t WebSocketsServer::connectedClients(bool ping) {
+  uint8_t n = 0;
+  for (uint8_t i = 0; i < WEBSOCKETS_SERVER_CLIENT_MAX; i++) {
+    if (clientIsConnected(i) && (!ping || impl_->send_frame(i, WS_OP_PING, NULL, 0))) {
+      n++;
+    }
+  }
+  return n;
+}
+
+bool WebSocketsServer::clientIsConnected(uint8_t num) {
+  if (num >= WEBSOCKETS_SERVER_CLIENT_MAX) {
+    return false;
+  }
+  std::lock_guard<std::mutex> lock(impl_->tx_mu);
+  return impl_->clients[num].tx && !impl_->clients[num].tx->closed;
+}
+
+IPAddress WebSocketsServer::remoteIP(uint8_t num) {
+  std::lock_guard<std::recursive_mutex> lock(impl_->mu);
+  return num < WEBSOCKETS_SERVER_CLIENT_MAX && impl_->clients[num].connected ? impl_->clients[num].ip : IPAddress();
+}
+
+void WebSocketsServer::enableHeartbeat(uint32_t pingInterval, uint32_t pongTimeout, uint8_t disconnectTimeoutCount) {
+  std::lock_guard<std::recursive_mutex> lock(impl_->mu);
+  impl_->hb_interval = pingInterval;
+  impl_->hb_timeout = pongTimeout;
+  impl_->hb_count = disconnectTimeoutCount ? disconnectTimeoutCount : 1;
+}
+
+void WebSocketsServer::disableHeartbeat() {
+  std::lock_guard<std::recursive_mutex> lock(impl_->mu);
+  impl_->hb_interval = 0;
+}
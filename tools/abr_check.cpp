@@ -0,0 +1,342 @@
+// Cek adaptive bitrate (BoboBee Stream/5_3/abr_controller.cpp) di host.
+//
+// Controller dijalankan terhadap model link sederhana: kamera 25 fps, slot
+// "latest only" (frame yang lewat selama kirim dihitung drop), ukuran JPEG
+// ~ piksel * f(quality) dengan tangga framesize yang sama dengan cam_abr.cpp.
+// Trace yang dicek:
+//   - step: bandwidth turun tajam lalu pulih -> turun cepat (quality dulu,
+//     baru framesize), stabil di setelan yang muat, naik pelan ke plafon
+//   - ramp: bandwidth turun lalu naik perlahan -> tidak bolak-balik
+//   - congestion: burst interferensi periodik -> turun dobel saat parah,
+//     tidak lebih dari satu perubahan per hold
+//   - dead band: link pas-pasan dengan jitter -> tidak ada perubahan
+//   - hysteresis: jarak antar perubahan >= hold, naik butuh 3x hold sehat
+//   - banyak klien: setelan sensor mengikuti klien paling lambat (abr_slowest)
+//
+// Build:  g++ -O2 -std=c++17 -I"../BoboBee Stream/5_3" abr_check.cpp "../BoboBee Stream/5_3/abr_controller.cpp" -o abr_check
+// Contoh: ./abr_check
+//         ./abr_check --trace step
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "abr_controller.h"
+
+static int _failed = 0;
+
+#define CHECK(cond)                                                  \
+  do {                                                               \
+    if (!(cond)) {                                                   \
+      fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+      _failed++;                                                     \
+    }                                                                \
+  } while (0)
+
+// tangga cam_abr.cpp: QQVGA, QVGA, CIF, VGA, SVGA, XGA, UXGA
+static const int kLadderW[] = {160, 320, 400, 640, 800, 1024, 1600};
+static const int kLadderH[] = {120, 240, 296, 480, 600, 768, 1200};
+static const char *kLadderName[] = {"QQVGA", "QVGA", "CIF", "VGA", "SVGA", "XGA", "UXGA"};
+
+static const char *_trace = nullptr;  // --trace NAME: cetak keputusan trace ini
+
+// ~0.15 B/piksel di quality 10, ~0.06 di 40 (kira-kira OV2640)
+static double frame_bytes(int quality, int level) {
+  return (double)kLadderW[level] * kLadderH[level] * 0.15 * 20.0 / (quality + 10);
+}
+
+namespace {
+
+struct Event {
+  int frame;
+  int action;
+  int quality_before;
+  int size_before;
+  int quality;
+  int size;
+};
+
+// Satu klien di belakang link dengan bandwidth kbps (KB/s).
+struct Client {
+  const char *name;
+  abr_state_t st;
+  int64_t now_us = 1000000;
+  int frames = 0;
+  double cam_ms = 40.0;  // 25 fps
+  std::vector<Event> events;
+
+  Client(const char *n, int quality, int size, int size_max = 3) : name(n) {
+    abr_config_t cfg;
+    abr_default_config(&cfg);  // 15 fps, 300 ms, quality 10..40 step 4, hold 10
+    cfg.size_max = size_max;   // plafon VGA
+    abr_init(&st, &cfg, quality, size);
+  }
+
+  // Kirim satu frame dengan setelan `quality`/`size` (default: milik klien ini).
+  int step(double kbps, int quality = -1, int size = -1) {
+    quality = quality < 0 ? st.quality : quality;
+    size = size < 0 ? st.size : size;
+    double send_ms = frame_bytes(quality, size) / 1024.0 / kbps * 1000.0 + 2.0;
+    double gap_ms = send_ms > cam_ms ? send_ms : cam_ms;
+    uint32_t dropped = (uint32_t)(send_ms / cam_ms);
+    double latency_ms = send_ms + cam_ms / 2;  // rata-rata tunggu di slot
+    now_us += (int64_t)(gap_ms * 1000);
+    int qb = st.quality, sb = st.size;
+    int action = abr_update(&st, now_us, (uint32_t)(send_ms * 1000), (uint32_t)(latency_ms * 1000), dropped);
+    if (action) {
+      events.push_back({frames, action, qb, sb, st.quality, st.size});
+      if (_trace && !strcmp(_trace, name)) {
+        printf("%-10s %6.1f s  %5.0f KB/s  %s q%-2d -> %s q%-2d  (send %.0f ms, latency %.0f ms)\n", name, (now_us - 1000000) / 1e6, kbps,
+               kLadderName[sb], qb, kLadderName[st.size], st.quality, st.send_ms, st.latency_ms);
+      }
+    }
+    frames++;
+    return action;
+  }
+
+  int downgrades() const {
+    return (int)st.downgrades;
+  }
+  int upgrades() const {
+    return (int)st.upgrades;
+  }
+};
+
+}  // namespace
+
+static bool is_down(const Event &e) {
+  return e.size < e.size_before || (e.size == e.size_before && e.quality > e.quality_before);
+}
+
+// Hysteresis yang harus selalu berlaku: perubahan berjarak >= hold, naik
+// butuh 3x hold frame sehat berturut-turut setelah hold, dan framesize
+// hanya turun setelah quality habis.
+static void check_hysteresis(const Client &c) {
+  const abr_config_t &cfg = c.st.cfg;
+  for (size_t i = 0; i < c.events.size(); i++) {
+    const Event &e = c.events[i];
+    if (i > 0) {
+      int gap = e.frame - c.events[i - 1].frame;
+      CHECK(gap >= (int)cfg.hold_frames);
+      if (!is_down(e)) {
+        CHECK(gap >= (int)(cfg.hold_frames + 3 * cfg.hold_frames - 1));
+      }
+    }
+    if (is_down(e) && e.size < e.size_before) {
+      CHECK(e.quality_before == cfg.quality_worst);
+    }
+    CHECK(e.quality >= cfg.quality_best && e.quality <= cfg.quality_worst);
+    CHECK(e.size >= cfg.size_min && e.size <= cfg.size_max);
+  }
+}
+
+static void check_basics() {
+  abr_config_t cfg;
+  abr_default_config(&cfg);
+  cfg.size_max = 3;
+  abr_state_t st;
+  abr_init(&st, &cfg, 2, 9);  // di luar batas -> di-clamp
+  CHECK(st.quality == cfg.quality_best && st.size == 3);
+
+  // hold: tidak ada keputusan di 9 frame pertama walau sangat lambat
+  int64_t now = 1000000;
+  for (uint32_t i = 1; i < cfg.hold_frames; i++) {
+    now += 500000;
+    CHECK(abr_update(&st, now, 500000, 600000, 10) == 0);
+  }
+  // parah (kirim > 1.5x budget): quality turun 2 step sekaligus
+  now += 500000;
+  CHECK(abr_update(&st, now, 500000, 600000, 10) == ABR_SET_QUALITY);
+  CHECK(st.quality == cfg.quality_best + 2 * cfg.quality_step);
+  CHECK(st.downgrades == 1);
+
+  // quality habis -> framesize turun satu anak tangga, quality ke tengah
+  abr_init(&st, &cfg, cfg.quality_worst, 3);
+  now = 1000000;
+  int action = 0;
+  for (uint32_t i = 0; i < cfg.hold_frames && !action; i++) {
+    now += 100000;
+    action = abr_update(&st, now, 100000, 200000, 2);
+  }
+  CHECK(action == (ABR_SET_QUALITY | ABR_SET_FRAMESIZE));
+  CHECK(st.size == 2 && st.quality == (cfg.quality_best + cfg.quality_worst) / 2);
+
+  // lantai: QQVGA q40 tidak bisa turun lagi
+  abr_init(&st, &cfg, cfg.quality_worst, 0);
+  now = 1000000;
+  for (int i = 0; i < 100; i++) {
+    now += 300000;
+    CHECK(abr_update(&st, now, 300000, 900000, 8) == 0);
+  }
+  CHECK(st.downgrades == 0);
+}
+
+static void check_step() {
+  Client c("step", 10, 3);
+  for (int i = 0; i < 500; i++) c.step(2000);  // 20 s sehat di plafon
+  CHECK(c.events.empty());
+
+  int drop_at = c.frames;
+  for (int i = 0; i < 1000; i++) c.step(100);
+  CHECK(!c.events.empty() && c.events[0].frame - drop_at <= (int)c.st.cfg.hold_frames + 2);
+  // quality dulu, baru framesize
+  CHECK(!c.events.empty() && c.events[0].action == ABR_SET_QUALITY);
+  // stabil: setelan akhir muat di budget 15 fps dan tidak berubah lagi di akhir
+  int last_change = c.events.empty() ? 0 : c.events.back().frame;
+  CHECK(c.frames - last_change > 300);
+  CHECK(c.st.send_ms < 0.8f * 1000.0f / c.st.cfg.target_fps);
+  CHECK(c.st.size < 3);
+  CHECK(c.upgrades() == 0);  // tidak pernah naik selama link buruk
+
+  int recover_at = c.frames;
+  size_t before = c.events.size();
+  for (int i = 0; i < 2500; i++) c.step(2000);
+  // naik pelan: tidak ada upgrade di 3x hold pertama
+  CHECK(c.events.size() > before && c.events[before].frame - recover_at >= (int)(3 * c.st.cfg.hold_frames));
+  // dan akhirnya kembali ke plafon, tanpa turun lagi
+  CHECK(c.st.quality == c.st.cfg.quality_best && c.st.size == 3);
+  for (size_t i = before; i < c.events.size(); i++) {
+    CHECK(!is_down(c.events[i]));
+  }
+  check_hysteresis(c);
+}
+
+static void check_ramp() {
+  Client c("ramp", 10, 3);
+  const int n = 1500;  // 60 s turun, 60 s naik
+  for (int i = 0; i < n; i++) c.step(2000.0 - (2000.0 - 60.0) * i / n);
+  size_t falling = c.events.size();
+  for (int i = 0; i < n; i++) c.step(60.0 + (2000.0 - 60.0) * i / n);
+
+  // selama bandwidth turun hanya ada downgrade, selama naik hanya upgrade
+  int up_while_falling = 0, down_while_rising = 0;
+  for (size_t i = 0; i < c.events.size(); i++) {
+    if (i < falling && !is_down(c.events[i])) up_while_falling++;
+    if (i >= falling && is_down(c.events[i])) down_while_rising++;
+  }
+  CHECK(falling > 0);
+  CHECK(up_while_falling == 0);
+  CHECK(down_while_rising == 0);
+  CHECK(c.st.size == 3);
+  check_hysteresis(c);
+}
+
+static void check_congestion() {
+  // 1500 KB/s, tiap 8 s ada 1.5 s interferensi ke 40 KB/s
+  Client c("congestion", 10, 3);
+  int severe = 0;
+  int first_down_ms = -1;
+  int down_per_cycle[8] = {0};
+  for (;;) {
+    double sec = (c.now_us - 1000000) / 1e6;
+    if (sec >= 64.0) {
+      break;
+    }
+    double phase = fmod(sec, 8.0);
+    bool burst = phase >= 4.0 && phase < 5.5;
+    int q = c.st.quality;
+    uint32_t downs = c.st.downgrades;
+    int action = c.step(burst ? 40 : 1500);
+    if (action == ABR_SET_QUALITY && c.st.quality - q == 2 * c.st.cfg.quality_step) {
+      severe++;
+    }
+    if (c.st.downgrades != downs) {
+      if (first_down_ms < 0) first_down_ms = (int)(sec * 1000);
+      down_per_cycle[(int)(sec / 8.0)]++;
+    }
+  }
+  // burst pertama (4.0 s) langsung ditanggapi, dengan step dobel
+  CHECK(first_down_ms >= 4000 && first_down_ms < 5500);
+  CHECK(severe > 0);
+  // tidak panik: paling banyak 4 downgrade per siklus 8 s
+  for (int i = 0; i < 8; i++) {
+    CHECK(down_per_cycle[i] <= 4);
+  }
+  check_hysteresis(c);
+}
+
+static void check_dead_band() {
+  // plafon VGA q10 ~46 KB: 1100 KB/s -> kirim ~43 ms (antara 0.4 dan 0.8 budget)
+  Client c("deadband", 10, 3);
+  uint32_t seed = 3;
+  for (int i = 0; i < 60 * 25; i++) {
+    seed = seed * 1103515245u + 12345u;
+    double jitter = 0.9 + 0.2 * ((seed >> 8) % 1000) / 1000.0;  // +/-10%
+    c.step(1100 * jitter);
+  }
+  CHECK(c.events.empty());
+}
+
+// Satu sensor, dua klien: setelan yang diterapkan = klien paling lambat.
+static void check_clients() {
+  abr_state_t st[4] = {};
+  bool active[4] = {false, false, false, false};
+  CHECK(abr_slowest(st, active, 4) == -1);
+
+  abr_config_t cfg;
+  abr_default_config(&cfg);
+  cfg.size_max = 3;
+  abr_init(&st[0], &cfg, 18, 3);
+  abr_init(&st[1], &cfg, 30, 3);
+  abr_init(&st[2], &cfg, 10, 2);
+  abr_init(&st[3], &cfg, 40, 0);
+  active[0] = active[1] = true;
+  CHECK(abr_slowest(st, active, 4) == 1);  // framesize sama, quality lebih buruk
+  active[2] = true;
+  CHECK(abr_slowest(st, active, 4) == 2);  // framesize lebih kecil menang
+  CHECK(abr_slowest(st, active, 2) == 1);
+  active[3] = false;
+  CHECK(abr_slowest(st, active, 4) == 2);  // slot tidak aktif diabaikan
+
+  // simulasi: LAN cepat + viewer lewat link 120 KB/s. Tiap klien punya
+  // estimator sendiri, semua frame dikirim dengan setelan klien terlambat.
+  Client fast("fast", 10, 3), slow("slow", 10, 3);
+  abr_state_t both[2];
+  bool on[2] = {true, true};
+  int quality = 10, size = 3;
+  for (int i = 0; i < 1500; i++) {
+    fast.step(3000, quality, size);
+    slow.step(120, quality, size);
+    both[0] = fast.st;
+    both[1] = slow.st;
+    int w = abr_slowest(both, on, 2);
+    quality = both[w].quality;
+    size = both[w].size;
+  }
+  CHECK(fast.downgrades() == 0);  // link cepat tidak pernah ikut turun
+  CHECK(slow.downgrades() > 0);
+  CHECK(quality == slow.st.quality && size == slow.st.size);
+  CHECK(size < 3);
+  // klien lambat pergi: setelan kembali mengikuti klien cepat (plafon)
+  on[1] = false;
+  int w = abr_slowest(both, on, 2);
+  CHECK(w == 0 && both[w].quality == 10 && both[w].size == 3);
+  check_hysteresis(fast);
+  check_hysteresis(slow);
+}
+
+int main(int argc, char **argv) {
+  for (int i = 1; i < argc; i++) {
+    std::string a = argv[i];
+    if (a == "--trace" && i + 1 < argc) {
+      _trace = argv[++i];
+    } else {
+      fprintf(stderr, "usage: %s [--trace step|ramp|congestion|deadband|slow|fast]\n", argv[0]);
+      return 2;
+    }
+  }
+  check_basics();
+  check_step();
+  check_ramp();
+  check_congestion();
+  check_dead_band();
+  check_clients();
+  if (_failed) {
+    printf("%d check(s) FAILED\n", _failed);
+    return 1;
+  }
+  printf("all abr checks passed\n");
+  return 0;
+}
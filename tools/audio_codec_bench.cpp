@@ -0,0 +1,316 @@
+// Cek + benchmark codec audio WebSocket (BoboBee Stream/5_3/audio_codec.cpp) di host.
+//
+// Cek: panjang hasil encode = audio_frame_data_len untuk banyak jumlah
+// sampel (blok penuh, sisa ganjil), PCM16 bolak-balik tepat, IMA-ADPCM:
+// vektor kecil yang dihitung tangan, encode per pesan = encode sekaligus
+// (keadaan encoder berlanjut), tiap pesan bisa didecode sendiri, data
+// rusak (panjang, step index) ditolak, dan SNR minimum per sinyal.
+// Benchmark per sinyal sintetis (atau --pcm rekaman s16le 16 kHz mono),
+// dipotong per baca I2S 5_3.ino (2048 sampel):
+//   bytes    data per pesan dan rasio terhadap PCM16
+//   SNR      sinyal asli vs hasil decode, dB
+//   encode   ns/sampel dan porsi CPU host pada 16 kHz (ESP32-S3 jauh lebih
+//            lambat; angka perangkat ada di /metrics stage="audio_encode")
+//   decode   ns/sampel (yang dikerjakan klien)
+//
+// Build:  g++ -O2 -std=c++17 -I"../BoboBee Stream/5_3" audio_codec_bench.cpp "../BoboBee Stream/5_3/audio_codec.cpp" "../BoboBee Stream/5_3/audio_frame.cpp" -o audio_codec_bench
+// Contoh: ./audio_codec_bench
+//         ./audio_codec_bench --pcm tangis.raw --iters 50
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "audio_codec.h"
+
+#define SAMPLE_RATE 16000
+#define READ_SAMPLES 2048  // sizeof(buffer_in_32) / 4 di 5_3.ino
+
+struct Options {
+  std::string pcm;
+  int iters = 20;
+  double seconds = 10;
+};
+
+struct Signal {
+  const char *name;
+  std::vector<int16_t> pcm;
+  double min_snr_db;  // batas cek IMA-ADPCM (~3 dB di bawah hasil saat ini)
+};
+
+static double now_seconds() {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static int16_t clip16(double v) {
+  return (int16_t)std::lround(std::max(-32768.0, std::min(32767.0, v)));
+}
+
+// ---------- sinyal ----------
+static std::vector<Signal> synthetic_signals(double seconds) {
+  size_t n = (size_t)(seconds * SAMPLE_RATE);
+  std::mt19937 rng(11);
+  std::normal_distribution<double> gauss(0, 1);
+  std::vector<Signal> out;
+
+  Signal sine = {"sine 440 Hz -12 dBFS", {}, 33};
+  Signal quiet = {"sine 440 Hz -50 dBFS", {}, 32};
+  Signal sweep = {"sweep 100..7000 Hz", {}, 19};
+  Signal cry = {"cry (harmonik + AM)", {}, 27};
+  Signal noise = {"white noise -20 dBFS", {}, 11};
+  Signal square = {"square 1 kHz 0 dBFS", {}, 6};
+  double phase = 0, f0_phase = 0;
+  for (size_t i = 0; i < n; i++) {
+    double t = (double)i / SAMPLE_RATE;
+    sine.pcm.push_back(clip16(8192 * sin(2 * M_PI * 440 * t)));
+    quiet.pcm.push_back(clip16(103 * sin(2 * M_PI * 440 * t)));
+    double f = 100 * pow(70.0, fmod(t, 5.0) / 5.0);
+    phase += 2 * M_PI * f / SAMPLE_RATE;
+    sweep.pcm.push_back(clip16(8192 * sin(phase)));
+    // tangis bayi kasar: f0 350..550 Hz, harmonik turun 12 dB/oktaf, 1 s bunyi / 0.5 s jeda
+    double f0 = 450 + 100 * sin(2 * M_PI * 0.7 * t);
+    f0_phase += 2 * M_PI * f0 / SAMPLE_RATE;
+    double env = fmod(t, 1.5) < 1.0 ? sin(M_PI * fmod(t, 1.5)) : 0;
+    double v = 0;
+    for (int h = 1; h * f0 < SAMPLE_RATE / 2; h++) v += sin(h * f0_phase) / (h * h);
+    cry.pcm.push_back(clip16(6000 * env * v + 30 * gauss(rng)));
+    noise.pcm.push_back(clip16(3277 * gauss(rng)));
+    square.pcm.push_back(fmod(t * 1000, 1.0) < 0.5 ? 32767 : -32768);
+  }
+  out.push_back(sine);
+  out.push_back(quiet);
+  out.push_back(sweep);
+  out.push_back(cry);
+  out.push_back(noise);
+  out.push_back(square);
+  return out;
+}
+
+static bool read_pcm(const std::string &path, std::vector<int16_t> *out) {
+  FILE *f = fopen(path.c_str(), "rb");
+  if (!f) return false;
+  int16_t buf[4096];
+  size_t n;
+  while ((n = fread(buf, sizeof(int16_t), 4096, f)) > 0) out->insert(out->end(), buf, buf + n);
+  fclose(f);
+  return !out->empty();
+}
+
+// ---------- encode/decode per pesan seperti 5_3.ino dan klien ----------
+static std::vector<std::vector<uint8_t>> encode_messages(const audio_codec_t *c, const std::vector<int16_t> &pcm) {
+  std::vector<std::vector<uint8_t>> msgs;
+  audio_codec_state_t st;
+  c->reset(&st);
+  for (size_t off = 0; off < pcm.size(); off += READ_SAMPLES) {
+    uint16_t n = (uint16_t)std::min<size_t>(READ_SAMPLES, pcm.size() - off);
+    std::vector<uint8_t> m(audio_frame_data_len(c->id, n));
+    c->encode(&st, pcm.data() + off, n, m.data());
+    msgs.push_back(m);
+  }
+  return msgs;
+}
+
+static bool decode_messages(const audio_codec_t *c, const std::vector<std::vector<uint8_t>> &msgs, size_t total,
+                            std::vector<int16_t> *out) {
+  out->assign(total, 0);
+  audio_codec_state_t st;
+  c->reset(&st);
+  size_t off = 0;
+  for (auto &m : msgs) {
+    uint16_t n = (uint16_t)std::min<size_t>(READ_SAMPLES, total - off);
+    if (c->decode(&st, m.data(), m.size(), out->data() + off, n) != n) return false;
+    off += n;
+  }
+  return true;
+}
+
+static double snr_db(const std::vector<int16_t> &ref, const std::vector<int16_t> &got) {
+  double sig = 0, err = 0;
+  for (size_t i = 0; i < ref.size(); i++) {
+    double d = (double)ref[i] - got[i];
+    sig += (double)ref[i] * ref[i];
+    err += d * d;
+  }
+  return err == 0 ? INFINITY : 10 * log10(sig / err);
+}
+
+// ---------- cek ----------
+static int _failures = 0;
+
+static void fail(const char *what) {
+  printf("  FAIL %s\n", what);
+  _failures++;
+}
+
+static void check_lengths() {
+  const uint16_t counts[] = {1, 2, 3, 255, 1023, 1024, 1025, 2047, 2048, 4095};
+  std::mt19937 rng(3);
+  for (uint8_t id = 0; id < AUDIO_CODEC_MAX; id++) {
+    const audio_codec_t *c = audio_codec_get(id);
+    if (!c) continue;
+    for (uint16_t n : counts) {
+      std::vector<int16_t> pcm(n), back(n);
+      for (auto &v : pcm) v = (int16_t)rng();
+      size_t want = audio_frame_data_len(id, n);
+      std::vector<uint8_t> data(want + 16, 0xA5);
+      audio_codec_state_t st;
+      c->reset(&st);
+      size_t got = c->encode(&st, pcm.data(), n, data.data());
+      char what[96];
+      snprintf(what, sizeof(what), "%s n=%u: encode %zu bytes, want %zu", c->name, n, got, want);
+      if (got != want || data[want] != 0xA5) fail(what);
+      c->reset(&st);
+      if (c->decode(&st, data.data(), want, back.data(), n) != n) fail(what);
+      if (c->decode(&st, data.data(), want - 1, back.data(), n) != -1) fail("decode accepted short data");
+    }
+  }
+  if (audio_frame_data_len(AUDIO_CODEC_IMA_ADPCM, 2048) != 2 * 516 || audio_frame_data_len(AUDIO_CODEC_IMA_ADPCM, 1025) != 516 + 5)
+    fail("IMA data_len formula");
+}
+
+static void check_pcm16() {
+  const audio_codec_t *c = audio_codec_find("pcm16");
+  if (!c || c->id != AUDIO_CODEC_PCM16) return fail("pcm16 not registered");
+  std::vector<int16_t> pcm = {0, 1, -1, 32767, -32768, 0x1234}, back(pcm.size());
+  std::vector<uint8_t> data(pcm.size() * 2);
+  audio_codec_state_t st;
+  c->encode(&st, pcm.data(), (uint16_t)pcm.size(), data.data());
+  if (data[10] != 0x34 || data[11] != 0x12) fail("pcm16 not little-endian");
+  c->decode(&st, data.data(), data.size(), back.data(), (uint16_t)back.size());
+  if (back != pcm) fail("pcm16 round trip");
+}
+
+static void check_ima() {
+  const audio_codec_t *c = audio_codec_find("adpcm");
+  if (!c || c->id != AUDIO_CODEC_IMA_ADPCM) return fail("adpcm not registered");
+  audio_codec_state_t st;
+
+  // dihitung tangan dari keadaan awal (predictor 0, index 0):
+  //   1000: step 7,  selisih 1000 -> kode 7,  predictor 0+0+7+3+1 = 11,    index 8
+  //   1000: step 16, selisih 989  -> kode 7,  predictor 11+2+16+8+4 = 41,  index 16
+  //   0:    step 34, selisih -41  -> kode 12, predictor 41-(4+34) = 3,     index 18
+  // sampel ketiga di nibble bawah byte terakhir, nibble atas diisi 0
+  std::vector<int16_t> pcm = {1000, 1000, 0};
+  std::vector<uint8_t> data(audio_frame_data_len(c->id, 3));
+  c->reset(&st);
+  c->encode(&st, pcm.data(), 3, data.data());
+  static const uint8_t want[6] = {0, 0, 0, 0, 0x77, 0x0C};
+  if (data.size() != 6 || memcmp(data.data(), want, 6) != 0 || st.ima.predictor != 3 || st.ima.index != 18)
+    fail("ima hand-computed vector");
+  std::vector<int16_t> back(3);
+  c->decode(&st, data.data(), data.size(), back.data(), 3);
+  if (back[0] != 11 || back[1] != 41 || back[2] != 3) fail("ima hand-computed decode");
+
+  // keadaan berlanjut antar pesan: encode per pesan = encode sekaligus
+  std::mt19937 rng(5);
+  std::vector<int16_t> sig(3 * READ_SAMPLES);
+  double ph = 0;
+  for (auto &v : sig) v = clip16(9000 * sin(ph += 0.07) + (int)(rng() % 2001) - 1000);
+  std::vector<uint8_t> whole(audio_frame_data_len(c->id, (uint16_t)sig.size()));
+  c->reset(&st);
+  c->encode(&st, sig.data(), (uint16_t)sig.size(), whole.data());
+  std::vector<std::vector<uint8_t>> msgs = encode_messages(c, sig);
+  std::vector<uint8_t> joined;
+  for (auto &m : msgs) joined.insert(joined.end(), m.begin(), m.end());
+  if (joined != whole) fail("ima per-message encode differs from one-shot encode");
+
+  // pesan kedua didecode sendiri (pesan pertama hilang) = decode berurutan
+  std::vector<int16_t> all, alone(READ_SAMPLES);
+  decode_messages(c, msgs, sig.size(), &all);
+  c->reset(&st);
+  c->decode(&st, msgs[1].data(), msgs[1].size(), alone.data(), READ_SAMPLES);
+  if (memcmp(alone.data(), all.data() + READ_SAMPLES, READ_SAMPLES * 2) != 0) fail("ima message not self-contained");
+
+  std::vector<uint8_t> bad = msgs[0];
+  bad[2] = 89;
+  if (c->decode(&st, bad.data(), bad.size(), alone.data(), READ_SAMPLES) != -1) fail("ima accepted step index 89");
+  bad = msgs[0];
+  bad[AUDIO_IMA_BLOCK_HEADER + AUDIO_IMA_BLOCK_SAMPLES / 2 + 2] = 200;  // header blok kedua
+  if (c->decode(&st, bad.data(), bad.size(), alone.data(), READ_SAMPLES) != -1) fail("ima accepted bad second block");
+}
+
+static int run_checks(const std::vector<Signal> &signals) {
+  check_lengths();
+  check_pcm16();
+  check_ima();
+  const audio_codec_t *c = audio_codec_get(AUDIO_CODEC_IMA_ADPCM);
+  for (auto &s : signals) {
+    std::vector<int16_t> back;
+    if (!decode_messages(c, encode_messages(c, s.pcm), s.pcm.size(), &back)) {
+      fail(s.name);
+      continue;
+    }
+    double snr = snr_db(s.pcm, back);
+    if (snr < s.min_snr_db) {
+      printf("  FAIL %s: SNR %.1f dB < %.0f dB\n", s.name, snr, s.min_snr_db);
+      _failures++;
+    }
+  }
+  printf("checks: %s\n", _failures ? "FAIL" : "PASS");
+  return _failures ? 1 : 0;
+}
+
+// ---------- benchmark ----------
+static void bench(const Signal &s, const audio_codec_t *c, int iters) {
+  std::vector<std::vector<uint8_t>> msgs = encode_messages(c, s.pcm);
+  std::vector<int16_t> back;
+  decode_messages(c, msgs, s.pcm.size(), &back);
+  double snr = snr_db(s.pcm, back);
+
+  size_t bytes = 0;
+  for (auto &m : msgs) bytes += m.size();
+  volatile size_t sink = 0;
+  double t0 = now_seconds();
+  for (int i = 0; i < iters; i++) sink = sink + encode_messages(c, s.pcm).size();
+  double enc = (now_seconds() - t0) / iters / s.pcm.size();
+  t0 = now_seconds();
+  for (int i = 0; i < iters; i++) {
+    decode_messages(c, msgs, s.pcm.size(), &back);
+    sink = sink + back[0];
+  }
+  double dec = (now_seconds() - t0) / iters / s.pcm.size();
+
+  char snr_s[16];
+  if (std::isinf(snr)) snprintf(snr_s, sizeof(snr_s), "exact");
+  else snprintf(snr_s, sizeof(snr_s), "%5.1f dB", snr);
+  printf("%-22s %-6s %5zu B/read %4.2f:1 %6.1f kbit/s  SNR %-9s  encode %6.2f ns/sample (%.3f%% CPU @16 kHz)  decode %6.2f ns/sample\n",
+         s.name, c->name, audio_frame_data_len(c->id, READ_SAMPLES), (double)s.pcm.size() * 2 / bytes, bytes * 8.0 / s.pcm.size() * SAMPLE_RATE / 1e3,
+         snr_s, enc * 1e9, enc * SAMPLE_RATE * 100, dec * 1e9);
+}
+
+int main(int argc, char **argv) {
+  Options o;
+  for (int i = 1; i + 1 < argc; i += 2) {
+    std::string k = argv[i];
+    const char *v = argv[i + 1];
+    if (k == "--pcm") o.pcm = v;
+    else if (k == "--iters") o.iters = atoi(v) > 0 ? atoi(v) : 1;
+    else if (k == "--seconds") o.seconds = atof(v) > 0 ? atof(v) : 1;
+    else {
+      fprintf(stderr, "usage: %s [--pcm REC.raw (s16le 16 kHz mono)] [--iters 20] [--seconds 10]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  std::vector<Signal> signals = synthetic_signals(o.seconds);
+  int rc = run_checks(signals);
+  if (!o.pcm.empty()) {
+    Signal rec = {o.pcm.c_str(), {}, 0};
+    if (!read_pcm(o.pcm, &rec.pcm)) {
+      fprintf(stderr, "cannot read %s\n", o.pcm.c_str());
+      return 1;
+    }
+    signals = {rec};
+  }
+  for (auto &s : signals) {
+    for (uint8_t id = 0; id < AUDIO_CODEC_MAX; id++) {
+      if (const audio_codec_t *c = audio_codec_get(id)) bench(s, c, o.iters);
+    }
+  }
+  return rc;
+}
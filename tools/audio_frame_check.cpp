@@ -0,0 +1,194 @@
+// Cek header pesan audio WebSocket (BoboBee Stream/5_3/audio_frame.cpp) di host.
+//
+// Dicek: layout wire byte per byte (little-endian, 24 byte), parse balik
+// hasil audio_header_init, penolakan pesan rusak (pendek, magic salah / PCM16
+// polos, header_len tidak masuk akal, panjang data tidak cocok), header_len
+// lebih besar dari versi ini (field baru dilewati), lalu statistik penerima:
+// blok hilang, terlambat, wrap seq, perangkat mulai ulang, dan jitter.
+//
+// Build:  g++ -O2 -std=c++17 -I"../BoboBee Stream/5_3" audio_frame_check.cpp "../BoboBee Stream/5_3/audio_frame.cpp" -o audio_frame_check
+// Contoh: ./audio_frame_check
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "audio_frame.h"
+
+static int _failed = 0;
+
+#define CHECK(cond)                                                  \
+  do {                                                               \
+    if (!(cond)) {                                                   \
+      fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+      _failed++;                                                     \
+    }                                                                \
+  } while (0)
+
+// Pesan seperti yang dikirim 5_3.ino: header lalu sampel PCM16.
+static std::vector<uint8_t> make_msg(uint32_t seq, uint16_t samples, int64_t capture_us) {
+  std::vector<uint8_t> msg(sizeof(audio_header_t) + samples * 2);
+  audio_header_init((audio_header_t *)msg.data(), AUDIO_CODEC_PCM16, seq, 16000, samples, 13, capture_us);
+  for (uint16_t i = 0; i < samples; i++) {
+    int16_t v = (int16_t)(i * 37 - 1000);
+    memcpy(&msg[sizeof(audio_header_t) + i * 2], &v, 2);
+  }
+  return msg;
+}
+
+static void check_layout() {
+  std::vector<uint8_t> m = make_msg(0x01020304, 1024, 0x1122334455667788LL);
+  static const uint8_t want[24] = {'A', 'U', 'D', '1', 24, 0, AUDIO_CODEC_PCM16, 13, 0x04, 0x03, 0x02, 0x01,
+                                   0x80, 0x3E, 0x00, 0x04, 0x88, 0x77, 0x66, 0x55, 0x44, 0x33, 0x22, 0x11};
+  CHECK(memcmp(m.data(), want, sizeof(want)) == 0);
+  CHECK(m.size() == 24 + 2048);
+}
+
+static void check_parse() {
+  std::vector<uint8_t> m = make_msg(77, 1024, -5);  // jam sebelum epoch esp_timer tetap terbaca
+  audio_frame_t f;
+  CHECK(audio_frame_parse(m.data(), m.size(), &f) == AUDIO_FRAME_OK);
+  CHECK(f.codec == AUDIO_CODEC_PCM16);
+  CHECK(f.gain_shift == 13);
+  CHECK(f.seq == 77);
+  CHECK(f.sample_rate == 16000);
+  CHECK(f.samples == 1024);
+  CHECK(f.capture_us == -5);
+  CHECK(f.data == m.data() + 24);
+  CHECK(f.data_len == 2048);
+  int16_t s1;
+  memcpy(&s1, f.data + 2, 2);
+  CHECK(s1 == 37 - 1000);
+
+  // header_len lebih besar (versi berikutnya): data tetap ditemukan
+  std::vector<uint8_t> big(m.begin(), m.begin() + 24);
+  big.insert(big.end(), 8, 0xEE);
+  big.insert(big.end(), m.begin() + 24, m.end());
+  big[4] = 32;
+  CHECK(audio_frame_parse(big.data(), big.size(), &f) == AUDIO_FRAME_OK);
+  CHECK(f.data == big.data() + 32);
+  CHECK(f.data_len == 2048);
+
+  // codec tidak dikenal: panjang data tidak bisa dicek, diserahkan ke pemanggil
+  std::vector<uint8_t> other = m;
+  other[6] = 200;
+  other.resize(24 + 100);
+  CHECK(audio_frame_parse(other.data(), other.size(), &f) == AUDIO_FRAME_OK);
+  CHECK(f.codec == 200 && f.data_len == 100);
+  CHECK(audio_frame_data_len(200, 1024) == 0);
+  CHECK(audio_frame_data_len(AUDIO_CODEC_PCM16, 1024) == 2048);
+  CHECK(audio_frame_data_len(AUDIO_CODEC_IMA_ADPCM, 1024) == 516);
+  CHECK(audio_frame_data_len(AUDIO_CODEC_IMA_ADPCM, 2049) == 2 * 516 + 5);
+
+  // IMA-ADPCM: panjang data dicek seperti PCM16
+  std::vector<uint8_t> ima(24 + 516, 0);
+  audio_header_init((audio_header_t *)ima.data(), AUDIO_CODEC_IMA_ADPCM, 1, 16000, 1024, 13, 0);
+  CHECK(audio_frame_parse(ima.data(), ima.size(), &f) == AUDIO_FRAME_OK);
+  CHECK(f.codec == AUDIO_CODEC_IMA_ADPCM && f.data_len == 516);
+  CHECK(audio_frame_parse(ima.data(), ima.size() - 1, &f) == AUDIO_FRAME_BAD_LENGTH);
+}
+
+static void check_reject() {
+  std::vector<uint8_t> m = make_msg(1, 256, 0);
+  audio_frame_t f;
+  CHECK(audio_frame_parse(m.data(), 23, &f) == AUDIO_FRAME_SHORT);
+  CHECK(audio_frame_parse(m.data(), 0, &f) == AUDIO_FRAME_SHORT);
+
+  // PCM16 polos dari firmware lama
+  std::vector<uint8_t> pcm(2048, 0);
+  CHECK(audio_frame_parse(pcm.data(), pcm.size(), &f) == AUDIO_FRAME_BAD_MAGIC);
+
+  std::vector<uint8_t> bad = m;
+  bad[4] = 20;
+  CHECK(audio_frame_parse(bad.data(), bad.size(), &f) == AUDIO_FRAME_BAD_HEADER);
+  bad = m;
+  bad[4] = 0xFF;
+  bad[5] = 0xFF;
+  CHECK(audio_frame_parse(bad.data(), bad.size(), &f) == AUDIO_FRAME_BAD_HEADER);
+
+  // terpotong / kelebihan / ganjil
+  CHECK(audio_frame_parse(m.data(), m.size() - 2, &f) == AUDIO_FRAME_BAD_LENGTH);
+  CHECK(audio_frame_parse(m.data(), m.size() - 1, &f) == AUDIO_FRAME_BAD_LENGTH);
+  std::vector<uint8_t> more = m;
+  more.push_back(0);
+  more.push_back(0);
+  CHECK(audio_frame_parse(more.data(), more.size(), &f) == AUDIO_FRAME_BAD_LENGTH);
+}
+
+static audio_frame_t frame(uint32_t seq, int64_t capture_us) {
+  audio_frame_t f = {};
+  f.seq = seq;
+  f.samples = 1024;
+  f.sample_rate = 16000;
+  f.capture_us = capture_us;
+  return f;
+}
+
+static void check_rx() {
+  const int64_t block = 64000;  // 1024 sampel @ 16 kHz
+  audio_rx_t rx;
+  audio_rx_init(&rx);
+  audio_frame_t f;
+
+  // mulai dari seq berapa pun (klien bergabung di tengah)
+  f = frame(500, 0);
+  CHECK(audio_rx_update(&rx, &f, 1000000) == 0);
+  for (uint32_t s = 501; s < 510; s++) {
+    f = frame(s, (s - 500) * block);
+    CHECK(audio_rx_update(&rx, &f, 1000000 + (s - 500) * block) == 0);
+  }
+  CHECK(rx.lost == 0 && rx.received == 10);
+  CHECK(rx.jitter_us == 0);
+
+  // 3 blok dilewati server
+  f = frame(513, 13 * block);
+  CHECK(audio_rx_update(&rx, &f, 1000000 + 13 * block) == 3);
+  CHECK(rx.lost == 3);
+
+  // duplikat / terlambat: dihitung, urutan tidak mundur
+  f = frame(511, 11 * block);
+  CHECK(audio_rx_update(&rx, &f, 1000000 + 14 * block) == 0);
+  CHECK(rx.late == 1);
+  f = frame(514, 14 * block);
+  CHECK(audio_rx_update(&rx, &f, 1000000 + 14 * block) == 0);
+  CHECK(rx.lost == 3);
+
+  // perangkat reboot: seq mulai dari 0 lagi, bukan 4 miliar blok hilang
+  f = frame(0, 5);
+  CHECK(audio_rx_update(&rx, &f, 1000000 + 20 * block) == 0);
+  CHECK(rx.restarts == 1 && rx.lost == 3);
+  f = frame(1, 5 + block);
+  CHECK(audio_rx_update(&rx, &f, 1000000 + 21 * block) == 0);
+
+  // wrap 2^32
+  audio_rx_init(&rx);
+  f = frame(0xFFFFFFFEu, 0);
+  audio_rx_update(&rx, &f, 0);
+  f = frame(0xFFFFFFFFu, block);
+  CHECK(audio_rx_update(&rx, &f, block) == 0);
+  f = frame(1, 3 * block);
+  CHECK(audio_rx_update(&rx, &f, 3 * block) == 1);
+  CHECK(rx.lost == 1 && rx.restarts == 0);
+
+  // jitter: kedatangan selang-seling +-500 us -> |D| = 1000 us
+  audio_rx_init(&rx);
+  for (int i = 0; i < 400; i++) {
+    f = frame(i, i * block);
+    audio_rx_update(&rx, &f, i * block + (i % 2 ? 500 : -500) + 7000000);
+  }
+  CHECK(fabs(rx.jitter_us - 1000) < 1);
+  CHECK(rx.lost == 0);
+}
+
+int main() {
+  check_layout();
+  check_parse();
+  check_reject();
+  check_rx();
+  if (_failed) {
+    printf("%d check(s) FAILED\n", _failed);
+    return 1;
+  }
+  printf("all audio_frame checks passed\n");
+  return 0;
+}
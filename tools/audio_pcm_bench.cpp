@@ -0,0 +1,217 @@
+// Cek + benchmark konversi I2S 32-bit -> PCM16 (BoboBee Stream/5_3/audio_pcm.cpp) di host.
+//
+// Cek bit-exact:
+//   - terhadap dua lintasan lama audioTask (maxAbs32, lalu geser + kali
+//     float SOFTWARE_GAIN + clamp) dengan shift yang dihitung dari blok
+//     itu sendiri, untuk gain bulat (SOFTWARE_GAIN 3.0 dan lainnya)
+//   - terhadap referensi int64 rumus audio_pcm.h untuk gain sembarang dan
+//     shift yang terlalu kecil (lonjakan: saturasi, bukan terbungkus)
+//   - puncak |x| termasuk INT32_MIN dan audio_gain_init
+// Benchmark per blok 2048 sampel (satu baca I2S 5_3.ino): dua lintasan
+// float lama vs satu lintasan fixed point. Angka perangkat ada di /metrics
+// stage="audio_convert".
+//
+// Build:  g++ -O2 -std=c++17 -I"../BoboBee Stream/5_3" audio_pcm_bench.cpp "../BoboBee Stream/5_3/audio_pcm.cpp" -o audio_pcm_bench
+// Contoh: ./audio_pcm_bench
+//         ./audio_pcm_bench --iters 20000
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "audio_pcm.h"
+
+#define READ_SAMPLES 2048  // sizeof(buffer_in_32) / 4 di 5_3.ino
+
+static double now_seconds() {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// ---------- jalur lama audioTask (sebelum audio_pcm) ----------
+static int32_t old_peak(const int32_t *in, size_t n) {
+  int32_t maxAbs32 = 0;
+  for (size_t i = 0; i < n; i++) {
+    int32_t v = in[i];
+    int32_t a = v >= 0 ? v : -v;
+    if (a > maxAbs32) maxAbs32 = a;
+  }
+  return maxAbs32;
+}
+
+static int old_shift(int32_t maxAbs32, int prev) {
+  if (maxAbs32 <= 0) return prev;
+  int new_shift = (31 - __builtin_clz((uint32_t)maxAbs32)) - 13;
+  return new_shift < 0 ? 0 : new_shift > 20 ? 20 : new_shift;
+}
+
+static void old_convert(const int32_t *in, int16_t *out, size_t n, int shift, float gain) {
+  for (size_t i = 0; i < n; i++) {
+    int16_t s = (int16_t)(in[i] >> shift);
+    int32_t g = (int32_t)((float)s * gain);
+    if (g > 32767) g = 32767;
+    if (g < -32768) g = -32768;
+    out[i] = (int16_t)g;
+  }
+}
+
+// ---------- referensi rumus audio_pcm.h ----------
+static int64_t clamp64(int64_t v, int64_t lo, int64_t hi) {
+  return v < lo ? lo : v > hi ? hi : v;
+}
+
+static int32_t ref_convert(const int32_t *in, int16_t *out, size_t n, int shift, const audio_gain_t *g) {
+  int64_t peak = 0;
+  for (size_t i = 0; i < n; i++) {
+    int64_t v = in[i];
+    peak = std::max(peak, v < 0 ? -v : v);
+    int64_t s = clamp64(v >> shift, -32768, 32767);
+    out[i] = (int16_t)clamp64((s * g->q15) >> g->shift, -32768, 32767);
+  }
+  return (int32_t)std::min<int64_t>(peak, INT32_MAX);
+}
+
+// Blok mikrofon sintetis: sinus + derau pada level 2^bits, seperti PDM 32-bit.
+static std::vector<int32_t> block(std::mt19937 &rng, int bits, size_t n) {
+  std::normal_distribution<double> gauss(0, 1);
+  std::vector<int32_t> b(n);
+  double amp = std::ldexp(1.0, bits);
+  double f = 0.02 + (rng() % 100) * 1e-3;
+  for (size_t i = 0; i < n; i++) {
+    double v = amp * (0.6 * sin(f * i) + 0.1 * gauss(rng));
+    b[i] = (int32_t)std::max(-2147483648.0, std::min(2147483647.0, v));
+  }
+  return b;
+}
+
+// ---------- cek ----------
+static int _failures = 0;
+
+static void fail(const char *what) {
+  printf("  FAIL %s\n", what);
+  _failures++;
+}
+
+static void check_gain_init() {
+  audio_gain_t g;
+  if (!audio_gain_init(&g, 3.0f) || g.q15 != 24576 || g.shift != 13) fail("gain 3.0");
+  if (!audio_gain_init(&g, 1.0f) || g.q15 != 16384 || g.shift != 14) fail("gain 1.0");
+  if (!audio_gain_init(&g, 0.7f) || g.q15 != 22938 || g.shift != 15) fail("gain 0.7");
+  if (!audio_gain_init(&g, 12.0f) || g.q15 != 24576 || g.shift != 11) fail("gain 12");
+  audio_gain_t keep = {123, 4};
+  g = keep;
+  if (audio_gain_init(&g, 0.0f) || audio_gain_init(&g, -1.0f) || audio_gain_init(&g, 40000.0f) || audio_gain_init(&g, NAN) ||
+      g.q15 != 123 || g.shift != 4)
+    fail("gain out of range accepted");
+}
+
+static void check_against_old() {
+  std::mt19937 rng(21);
+  const float gains[] = {3.0f, 1.0f, 2.0f, 4.0f, 6.0f, 12.0f};
+  std::vector<int16_t> want(READ_SAMPLES), got(READ_SAMPLES);
+  int blocks = 0;
+  for (float gf : gains) {
+    audio_gain_t g;
+    audio_gain_init(&g, gf);
+    for (int bits = 4; bits <= 30; bits++) {
+      std::vector<int32_t> in = block(rng, bits, READ_SAMPLES);
+      int32_t peak = old_peak(in.data(), in.size());
+      int shift = old_shift(peak, 8);
+      // jalur lama tidak terbungkus hanya kalau in >> shift muat 16 bit
+      if (peak >> shift > 32767) continue;
+      old_convert(in.data(), want.data(), in.size(), shift, gf);
+      int32_t p = audio_pcm_convert(in.data(), got.data(), in.size(), shift, &g);
+      blocks++;
+      char what[64];
+      snprintf(what, sizeof(what), "old path, gain %.1f, 2^%d", gf, bits);
+      if (p != peak || want != got) fail(what);
+    }
+  }
+  if (blocks < 100) fail("too few comparable blocks");
+}
+
+static void check_against_ref() {
+  std::mt19937 rng(22);
+  const float gains[] = {3.0f, 0.7f, 1.37f, 100.0f, 0.01f};
+  std::vector<int16_t> want(READ_SAMPLES), got(READ_SAMPLES);
+  for (float gf : gains) {
+    audio_gain_t g;
+    audio_gain_init(&g, gf);
+    for (int shift = 0; shift <= 20; shift += 4) {
+      // level jauh di atas shift (lonjakan setelah hening) sampai jauh di bawahnya
+      for (int bits : {6, 14, 22, 30}) {
+        std::vector<int32_t> in = block(rng, bits, READ_SAMPLES);
+        in[5] = INT32_MAX;
+        in[6] = INT32_MIN + 1;
+        int32_t a = ref_convert(in.data(), want.data(), in.size(), shift, &g);
+        int32_t b = audio_pcm_convert(in.data(), got.data(), in.size(), shift, &g);
+        char what[64];
+        snprintf(what, sizeof(what), "ref, gain %.2f shift %d 2^%d", gf, shift, bits);
+        if (a != b || want != got) fail(what);
+      }
+    }
+  }
+  // puncak INT32_MIN: tidak ada |x| yang lebih besar dari INT32_MAX
+  int32_t in[3] = {5, INT32_MIN, -7};
+  int16_t out[3];
+  audio_gain_t g;
+  audio_gain_init(&g, 3.0f);
+  if (audio_pcm_convert(in, out, 3, 13, &g) != INT32_MAX || out[1] != -32768) fail("INT32_MIN peak");
+  if (audio_pcm_convert(in, out, 0, 13, &g) != 0) fail("empty block peak");
+}
+
+static int run_checks() {
+  check_gain_init();
+  check_against_old();
+  check_against_ref();
+  printf("checks: %s\n", _failures ? "FAIL" : "PASS");
+  return _failures ? 1 : 0;
+}
+
+// ---------- benchmark ----------
+static void bench(int iters) {
+  std::mt19937 rng(9);
+  std::vector<int32_t> in = block(rng, 26, READ_SAMPLES);
+  std::vector<int16_t> out(READ_SAMPLES);
+  audio_gain_t g;
+  audio_gain_init(&g, 3.0f);
+  volatile int32_t sink = 0;
+
+  double t0 = now_seconds();
+  for (int i = 0; i < iters; i++) {
+    int32_t peak = old_peak(in.data(), in.size());
+    old_convert(in.data(), out.data(), in.size(), 13, 3.0f);
+    sink = sink + peak + out[i % READ_SAMPLES];
+  }
+  double old_s = (now_seconds() - t0) / iters;
+
+  t0 = now_seconds();
+  for (int i = 0; i < iters; i++) {
+    sink = sink + audio_pcm_convert(in.data(), out.data(), in.size(), 13, &g) + out[i % READ_SAMPLES];
+  }
+  double new_s = (now_seconds() - t0) / iters;
+
+  printf("%d samples per block\n", READ_SAMPLES);
+  printf("  two-pass float (old)   %7.2f us/block %6.3f ns/sample\n", old_s * 1e6, old_s * 1e9 / READ_SAMPLES);
+  printf("  one-pass Q15 (new)     %7.2f us/block %6.3f ns/sample  (%.2fx)\n", new_s * 1e6, new_s * 1e9 / READ_SAMPLES,
+         old_s / new_s);
+}
+
+int main(int argc, char **argv) {
+  int iters = 5000;
+  for (int i = 1; i + 1 < argc; i += 2) {
+    std::string k = argv[i];
+    if (k == "--iters") iters = atoi(argv[i + 1]) > 0 ? atoi(argv[i + 1]) : 1;
+    else {
+      fprintf(stderr, "usage: %s [--iters 5000]\n", argv[0]);
+      return 2;
+    }
+  }
+  int rc = run_checks();
+  bench(iters);
+  return rc;
+}
@@ -0,0 +1,385 @@
+// Cek encoder BMP streaming /bmp (BoboBee Stream/5_3/bmp_stream.cpp) di host.
+//
+// Output stream dibandingkan byte per byte dengan salinan frame2bmp() /
+// jpg2bmp() esp32-camera (to_bmp.c: satu buffer penuh, header 54 byte,
+// tinggi negatif, BGR, gray + palette) untuk gray, RGB888, RGB565, YUV422
+// dan JPEG (decoder tiruan yang mengirim blok MCU 8x8/16x8/16x16 seperti
+// tjpgd, termasuk blok terpotong di tepi), di beberapa resolusi termasuk
+// lebar ganjil. Juga: tiap write <= BMP_STREAM_CHUNK, berhenti setelah write
+// gagal, urutan blok yang salah ditolak, band setinggi MCU dari SOF
+// (bmp_jpeg_mcu_rows: 4:2:0, 4:2:2, 4:4:4, gray, JPEG rusak). Terakhir:
+// memori puncak per resolusi dibanding frame2bmp, dan throughput konversi.
+//
+// Build:  g++ -O2 -std=c++17 -I"../BoboBee Stream/5_3" bmp_check.cpp "../BoboBee Stream/5_3/bmp_stream.cpp" -o bmp_check
+// Contoh: ./bmp_check
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "bmp_stream.h"
+
+static int _failed = 0;
+
+#define CHECK(cond)                                                  \
+  do {                                                               \
+    if (!(cond)) {                                                   \
+      fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+      _failed++;                                                     \
+    }                                                                \
+  } while (0)
+
+static double now_seconds() {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+enum fmt_t { FMT_GRAY, FMT_RGB888, FMT_RGB565, FMT_YUV422 };
+
+// ---------- salinan to_bmp.c / yuv.c ----------
+static uint8_t clamp8(int v) {
+  return v < 0 ? 0 : v > 255 ? 255 : v;
+}
+
+// Rumus di balik yuv_table (koefisien BT.601, dibulatkan ke int seperti tabel).
+static void yuv2rgb(uint8_t y, uint8_t u, uint8_t v, uint8_t *r, uint8_t *g, uint8_t *b) {
+  int yy = (int)(1.164 * (y - 16)), du = u - 128, dv = v - 128;
+  *r = clamp8(yy + (int)(1.596 * dv));
+  *g = clamp8(yy - (int)(0.391 * du) - (int)(0.813 * dv));
+  *b = clamp8(yy + (int)(2.018 * du));
+}
+
+// fmt2rgb888() untuk sumber 2 byte/piksel; src_len boleh sepotong frame.
+static void fmt2rgb888(const uint8_t *src, size_t src_len, fmt_t format, uint8_t *rgb) {
+  size_t pix = src_len / 2;
+  if (format == FMT_RGB565) {
+    for (size_t i = 0; i < pix; i++) {
+      uint8_t hb = *src++, lb = *src++;
+      *rgb++ = (lb & 0x1F) << 3;
+      *rgb++ = (hb & 0x07) << 5 | (lb & 0xE0) >> 3;
+      *rgb++ = hb & 0xF8;
+    }
+  } else {
+    uint8_t r, g, b;
+    for (size_t i = 0; i < pix; i += 2) {
+      uint8_t y0 = *src++, u = *src++, y1 = *src++, v = *src++;
+      yuv2rgb(y0, u, v, &r, &g, &b);
+      *rgb++ = b;
+      *rgb++ = g;
+      *rgb++ = r;
+      yuv2rgb(y1, u, v, &r, &g, &b);
+      *rgb++ = b;
+      *rgb++ = g;
+      *rgb++ = r;
+    }
+  }
+}
+
+static void ref_header(std::vector<uint8_t> &out, uint16_t w, uint16_t h, int bpp) {
+  size_t palette = bpp == 1 ? 1024 : 0;
+  out.assign((size_t)w * h * bpp + 54 + palette, 0);
+  struct __attribute__((packed)) {
+    uint32_t filesize, reserved, fileoffset_to_pixelarray, dibheadersize;
+    int32_t width, height;
+    uint16_t planes, bitsperpixel;
+    uint32_t compression, imagesize, ypixelspermeter, xpixelspermeter, numcolorspallette, mostimpcolor;
+  } hdr = {(uint32_t)out.size(), 0, (uint32_t)(54 + palette), 40, w, -h, 1, (uint16_t)(bpp * 8), 0, (uint32_t)(w * h * bpp), 0x0B13, 0x0B13, 0, 0};
+  static_assert(sizeof(hdr) == 52, "bmp_header_t");
+  out[0] = 'B';
+  out[1] = 'M';
+  memcpy(&out[2], &hdr, sizeof(hdr));
+  for (size_t i = 0; i < palette / 4; i++) {
+    out[54 + i * 4] = out[54 + i * 4 + 1] = out[54 + i * 4 + 2] = i;
+  }
+}
+
+static std::vector<uint8_t> ref_frame2bmp(const uint8_t *src, uint16_t w, uint16_t h, fmt_t format) {
+  std::vector<uint8_t> out;
+  size_t pix = (size_t)w * h;
+  if (format == FMT_GRAY) {
+    ref_header(out, w, h, 1);
+    memcpy(&out[54 + 1024], src, pix);
+  } else {
+    ref_header(out, w, h, 3);
+    if (format == FMT_RGB888) {
+      memcpy(&out[54], src, pix * 3);
+    } else {
+      fmt2rgb888(src, pix * 2, format, &out[54]);
+    }
+  }
+  return out;
+}
+
+// ---------- decoder JPEG tiruan (urutan blok tjpgd) ----------
+typedef bool (*writer_t)(void *, uint16_t, uint16_t, uint16_t, uint16_t, uint8_t *);
+
+static bool fake_decode(const uint8_t *rgb, uint16_t w, uint16_t h, int mw, int mh, writer_t writer, void *arg) {
+  if (!writer(arg, 0, 0, w, h, nullptr)) {
+    return false;
+  }
+  std::vector<uint8_t> block(mw * mh * 3);
+  for (int y = 0; y < h; y += mh) {
+    for (int x = 0; x < w; x += mw) {
+      int bw = x + mw > w ? w - x : mw, bh = y + mh > h ? h - y : mh;
+      for (int r = 0; r < bh; r++) {
+        memcpy(&block[r * bw * 3], rgb + ((size_t)(y + r) * w + x) * 3, bw * 3);
+      }
+      if (!writer(arg, x, y, bw, bh, block.data())) {
+        return false;
+      }
+    }
+  }
+  return writer(arg, w, h, w, h, nullptr);
+}
+
+typedef struct {
+  std::vector<uint8_t> out;
+  uint16_t width;
+} ref_jpg_t;
+
+// _rgb_write() to_bmp.c (data_offset = BMP_HEADER_LEN, RGB -> BGR)
+static bool ref_rgb_write(void *arg, uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint8_t *data) {
+  ref_jpg_t *j = (ref_jpg_t *)arg;
+  if (!data) {
+    if (x == 0 && y == 0) {
+      j->width = w;
+      ref_header(j->out, w, h, 3);
+    }
+    return true;
+  }
+  size_t jw = j->width * 3, t = y * jw, b = t + h * jw, l = x * 3;
+  uint8_t *out = &j->out[54];
+  w *= 3;
+  for (size_t iy = t; iy < b; iy += jw) {
+    uint8_t *o = out + iy + l;
+    for (size_t ix = 0; ix < w; ix += 3) {
+      o[ix] = data[ix + 2];
+      o[ix + 1] = data[ix + 1];
+      o[ix + 2] = data[ix];
+    }
+    data += w;
+  }
+  return true;
+}
+
+// ---------- sisi stream ----------
+typedef struct {
+  std::vector<uint8_t> out;
+  size_t writes;
+  size_t max_write;
+  size_t fail_at;  // write ke-n gagal (0 = tidak pernah)
+} sink_t;
+
+static bool sink_write(void *arg, const uint8_t *data, size_t len) {
+  sink_t *k = (sink_t *)arg;
+  k->writes++;
+  if (len > k->max_write) {
+    k->max_write = len;
+  }
+  if (k->fail_at && k->writes >= k->fail_at) {
+    return false;
+  }
+  k->out.insert(k->out.end(), data, data + len);
+  return true;
+}
+
+static void convert(void *arg, const uint8_t *src, size_t n, uint8_t *dst) {
+  fmt2rgb888(src, n * 2, *(fmt_t *)arg, dst);
+}
+
+static bool stream_frame(bmp_stream_t *s, const uint8_t *src, uint16_t w, uint16_t h, fmt_t *format) {
+  switch (*format) {
+    case FMT_GRAY:   return bmp_stream_raw(s, src, w, h, 1, nullptr, nullptr);
+    case FMT_RGB888: return bmp_stream_raw(s, src, w, h, 3, nullptr, nullptr);
+    default:         return bmp_stream_raw(s, src, w, h, 2, convert, format);
+  }
+}
+
+static std::vector<uint8_t> random_bytes(size_t n, uint32_t seed) {
+  std::vector<uint8_t> v(n);
+  for (auto &b : v) {
+    seed = seed * 1103515245u + 12345u;
+    b = seed >> 16;
+  }
+  return v;
+}
+
+static const int SRC_BPP[] = {1, 3, 2, 2};
+static const char *const FMT_NAMES[] = {"gray", "rgb888", "rgb565", "yuv422"};
+static const uint16_t SIZES[][2] = {{96, 96}, {160, 120}, {320, 240}, {240, 240}, {400, 296}, {642, 3}, {18, 17}, {2, 1}, {800, 600}};
+
+static void check_raw() {
+  for (int f = 0; f < 4; f++) {
+    for (auto &sz : SIZES) {
+      fmt_t format = (fmt_t)f;
+      uint16_t w = sz[0], h = sz[1];
+      std::vector<uint8_t> src = random_bytes((size_t)w * h * SRC_BPP[f], w * 31 + h + f);
+      std::vector<uint8_t> ref = ref_frame2bmp(src.data(), w, h, format);
+
+      static bmp_stream_t s;
+      sink_t k = {};
+      bmp_stream_init(&s, sink_write, &k);
+      bool ok = stream_frame(&s, src.data(), w, h, &format);
+      CHECK(ok);
+      CHECK(s.total == ref.size());
+      CHECK(k.max_write <= BMP_STREAM_CHUNK);
+      if (k.out != ref) {
+        fprintf(stderr, "%s %ux%u: stream != frame2bmp (%zu vs %zu bytes)\n", FMT_NAMES[f], w, h, k.out.size(), ref.size());
+        _failed++;
+      }
+    }
+  }
+}
+
+static void check_jpeg() {
+  static const int MCU[][2] = {{8, 8}, {16, 8}, {16, 16}};
+  for (auto &m : MCU) {
+    for (auto &sz : SIZES) {
+      uint16_t w = sz[0], h = sz[1];
+      std::vector<uint8_t> rgb = random_bytes((size_t)w * h * 3, w + h * 7 + m[1]);
+      ref_jpg_t ref;
+      CHECK(fake_decode(rgb.data(), w, h, m[0], m[1], ref_rgb_write, &ref));
+
+      static bmp_stream_t s;
+      sink_t k = {};
+      bmp_stream_init(&s, sink_write, &k);
+      std::vector<uint8_t> band(bmp_band_bytes(w, m[1]));
+      s.band = band.data();
+      s.band_cap = band.size();
+      s.band_rows = m[1];
+      bool ok = fake_decode(rgb.data(), w, h, m[0], m[1], bmp_jpeg_write, &s);
+      CHECK(ok && !s.failed && s.sent == s.total);
+      CHECK(k.max_write <= BMP_STREAM_CHUNK);
+      if (k.out != ref.out) {
+        fprintf(stderr, "jpeg mcu %dx%d %ux%u: stream != jpg2bmp\n", m[0], m[1], w, h);
+        _failed++;
+      }
+    }
+  }
+}
+
+static void check_errors() {
+  uint16_t w = 320, h = 240;
+  fmt_t format = FMT_RGB565;
+  std::vector<uint8_t> src = random_bytes((size_t)w * h * 2, 7);
+  static bmp_stream_t s;
+  sink_t k = {};
+  k.fail_at = 3;
+  bmp_stream_init(&s, sink_write, &k);
+  CHECK(!stream_frame(&s, src.data(), w, h, &format));
+  CHECK(k.writes == 3);  // tidak ada write setelah gagal
+
+  std::vector<uint8_t> rgb = random_bytes((size_t)w * h * 3, 9);
+  std::vector<uint8_t> band(bmp_band_bytes(w, 16));
+  k = {};
+  k.fail_at = 5;
+  bmp_stream_init(&s, sink_write, &k);
+  s.band = band.data();
+  s.band_cap = band.size();
+  CHECK(!fake_decode(rgb.data(), w, h, 16, 16, bmp_jpeg_write, &s));
+  CHECK(s.failed && k.writes == 5);
+
+  // band terlalu kecil untuk lebar JPEG
+  k = {};
+  bmp_stream_init(&s, sink_write, &k);
+  s.band = band.data();
+  s.band_cap = bmp_band_bytes(w - 8, 16);
+  CHECK(!fake_decode(rgb.data(), w, h, 16, 16, bmp_jpeg_write, &s));
+  CHECK(k.writes == 0);
+
+  // band 8 baris (4:2:2) tidak menerima MCU 16 baris
+  k = {};
+  bmp_stream_init(&s, sink_write, &k);
+  s.band = band.data();
+  s.band_cap = bmp_band_bytes(w, 8);
+  s.band_rows = 8;
+  CHECK(!fake_decode(rgb.data(), w, h, 16, 16, bmp_jpeg_write, &s));
+
+  // blok dari baris MCU yang salah
+  k = {};
+  bmp_stream_init(&s, sink_write, &k);
+  s.band = band.data();
+  s.band_cap = band.size();
+  uint8_t block[16 * 16 * 3] = {};
+  CHECK(bmp_jpeg_write(&s, 0, 0, w, h, nullptr));
+  CHECK(!bmp_jpeg_write(&s, 0, 16, 16, 16, block));
+
+  // RGB565 tanpa konverter tidak didukung
+  bmp_stream_init(&s, sink_write, &k);
+  CHECK(!bmp_stream_raw(&s, src.data(), w, h, 2, nullptr, nullptr));
+}
+
+// SOI, APP0 pendek, lalu SOF0 dengan faktor sampling per komponen (HV).
+static std::vector<uint8_t> jpeg_head(uint8_t sof, const std::vector<uint8_t> &hv) {
+  std::vector<uint8_t> j = {0xFF, 0xD8, 0xFF, 0xE0, 0x00, 0x04, 'J', 'F', 0xFF, 0xFF};
+  size_t seg = 8 + 3 * hv.size();
+  j.insert(j.end(), {0xFF, sof, (uint8_t)(seg >> 8), (uint8_t)seg, 8, 0x00, 0xF0, 0x01, 0x40, (uint8_t)hv.size()});
+  for (size_t c = 0; c < hv.size(); c++) {
+    j.insert(j.end(), {(uint8_t)(c + 1), hv[c], 0});
+  }
+  j.insert(j.end(), {0xFF, 0xDA, 0x00, 0x08});
+  return j;
+}
+
+static void check_mcu_rows() {
+  std::vector<uint8_t> j420 = jpeg_head(0xC0, {0x22, 0x11, 0x11});
+  std::vector<uint8_t> j422 = jpeg_head(0xC0, {0x21, 0x11, 0x11});
+  std::vector<uint8_t> j444 = jpeg_head(0xC2, {0x11, 0x11, 0x11});
+  std::vector<uint8_t> gray = jpeg_head(0xC1, {0x11});
+  CHECK(bmp_jpeg_mcu_rows(j420.data(), j420.size()) == 16);
+  CHECK(bmp_jpeg_mcu_rows(j422.data(), j422.size()) == 8);
+  CHECK(bmp_jpeg_mcu_rows(j444.data(), j444.size()) == 8);
+  CHECK(bmp_jpeg_mcu_rows(gray.data(), gray.size()) == 8);
+  // SOF terpotong, SOS sebelum SOF, bukan JPEG
+  CHECK(bmp_jpeg_mcu_rows(j420.data(), 16) == 0);
+  std::vector<uint8_t> no_sof = {0xFF, 0xD8, 0xFF, 0xDA, 0x00, 0x08, 0xFF, 0xC0, 0x00, 0x0B};
+  CHECK(bmp_jpeg_mcu_rows(no_sof.data(), no_sof.size()) == 0);
+  CHECK(bmp_jpeg_mcu_rows(j420.data() + 2, j420.size() - 2) == 0);
+}
+
+static bool null_write(void *, const uint8_t *, size_t) {
+  return true;
+}
+
+static void report() {
+  static const struct {
+    const char *name;
+    uint16_t w, h;
+  } frames[] = {{"QVGA", 320, 240}, {"VGA", 640, 480}, {"SVGA", 800, 600}, {"HD", 1280, 720}, {"UXGA", 1600, 1200}};
+  printf("%-6s %12s %14s %14s %14s\n", "frame", "frame2bmp", "stream raw", "jpeg 4:2:2", "jpeg 4:2:0");
+  for (auto &f : frames) {
+    size_t full = bmp_file_size(f.w, f.h, 3);
+    size_t raw = sizeof(bmp_stream_t);
+    size_t j422 = raw + bmp_band_bytes(f.w, 8);
+    size_t j420 = raw + bmp_band_bytes(f.w, 16);
+    printf("%-6s %10zu B %12zu B %12zu B %12zu B\n", f.name, full, raw, j422, j420);
+  }
+  printf("band cap BMP_BAND_MAX = %u B\n", (unsigned)BMP_BAND_MAX);
+
+  uint16_t w = 1600, h = 1200;
+  fmt_t format = FMT_RGB565;
+  std::vector<uint8_t> src = random_bytes((size_t)w * h * 2, 3);
+  static bmp_stream_t s;
+  double t0 = now_seconds();
+  const int iters = 5;
+  for (int i = 0; i < iters; i++) {
+    bmp_stream_init(&s, null_write, nullptr);
+    stream_frame(&s, src.data(), w, h, &format);
+  }
+  double dt = (now_seconds() - t0) / iters;
+  printf("RGB565 UXGA -> BMP: %.2f ms/frame, %.0f MB/s (host)\n", dt * 1e3, s.total / dt / 1e6);
+}
+
+int main() {
+  check_raw();
+  check_jpeg();
+  check_errors();
+  check_mcu_rows();
+  if (_failed) {
+    printf("%d check(s) FAILED\n", _failed);
+    return 1;
+  }
+  printf("all bmp checks passed\n");
+  report();
+  return 0;
+}
@@ -0,0 +1,439 @@
+// Cek + benchmark broadcaster capture (BoboBee Stream/5_3/cam_broadcast.cpp) di host.
+//
+// Broadcaster asli jalan di atas stand-in simulator (sim/freertos.cpp untuk
+// task/semaphore, sim/camera.cpp untuk fb_count/grab mode driver) dengan
+// kamera tiruan: sim_cam::Source yang mengirim "JPEG" sintetis berisi nomor
+// frame dan pola yang bisa dicek ulang. Klien adalah thread yang memanggil
+// cam_bcast_wait / cam_frame_release seperti handler /stream.
+//
+// Dicek:
+//   - isi frame utuh saat diterima dan setelah ditahan klien lambat (buffer
+//     pool tidak dipakai ulang selama masih direferensikan)
+//   - seq naik per klien; slot "latest only": klien lambat selalu dapat
+//     frame terbaru, dropped = jumlah frame yang dilewati; klien cepat tidak
+//     tertahan klien lambat; cam_bcast_wait tidak pernah NULL sebelum timeout
+//   - pool tidak pernah habis, alokasi buffer tetap setelah pemanasan
+//   - batas CAM_BCAST_MAX_CLIENTS, slot bisa dipakai lagi setelah unsubscribe;
+//     klien terakhir pergi saat task capture menunggu fb_get (tanpa sink)
+//   - sinyal basi: 4 klien dengan jeda acak, tidak ada NULL sebelum timeout
+//   - cam_bcast_between_frames: job jalan di task capture, lalu
+//     CAM_BCAST_SETTLE_FRAMES frame dibuang; sink menerima frame tanpa klien
+// Benchmark: kamera tanpa jeda (sumber lossless), 1..CAM_BCAST_MAX_CLIENTS
+// klien cepat, lalu klien cepat + klien lambat: fps capture dan per klien.
+//
+// Dibangun seperti sketch simulator (main() ada di sim/arduino.cpp): setup()
+// menjalankan cek + benchmark lalu keluar dengan kode hasil cek. Opsi lewat
+// environment: BENCH_SECONDS (per kasus, default 2), BENCH_KB (default 30).
+//
+// Build:  g++ -std=gnu++17 -O2 -pthread -I../sim/include -I../sim -I"../BoboBee Stream/5_3" -include Arduino.h -DARDUINO_ARCH_ESP32 -DCONFIG_ARDUHAL_ESP_LOG -DARDUHAL_LOG_LEVEL=2 cam_bcast_bench.cpp "../BoboBee Stream/5_3/cam_broadcast.cpp" "../BoboBee Stream/5_3/frame_gate.cpp" "../BoboBee Stream/5_3/cam_metrics.cpp" "../BoboBee Stream/5_3/stream_hist.cpp" ../sim/*.cpp -ljpeg -o cam_bcast_bench
+// Contoh: ./cam_bcast_bench
+//         BENCH_SECONDS=5 BENCH_KB=60 ./cam_bcast_bench
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "cam_broadcast.h"
+#include "esp_camera.h"
+#include "esp_timer.h"
+#include "sim.h"
+#include "sim_camera.h"
+
+static int _failed = 0;
+
+#define CHECK(cond)                                                  \
+  do {                                                               \
+    if (!(cond)) {                                                   \
+      fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+      _failed++;                                                     \
+    }                                                                \
+  } while (0)
+
+static double now_seconds() {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static void sleep_ms(int ms) {
+  std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+// ---------- kamera tiruan ----------
+// FF D8 | nomor frame u32 | panjang u32 | pola(nomor, i) ... | FF D9
+static std::atomic<int> _source_fps{200};  // 0 = tanpa jeda
+static std::atomic<size_t> _source_len{30 * 1024};
+
+static uint8_t pattern(uint32_t index, size_t i) {
+  return (uint8_t)(index * 131u + i * 7u + (i >> 8));
+}
+
+static bool frame_intact(const uint8_t *buf, size_t len) {
+  if (len < 12 || buf[0] != 0xFF || buf[1] != 0xD8 || buf[len - 2] != 0xFF || buf[len - 1] != 0xD9) {
+    return false;
+  }
+  uint32_t index, n;
+  memcpy(&index, buf + 2, 4);
+  memcpy(&n, buf + 6, 4);
+  if (n != len) {
+    return false;
+  }
+  for (size_t i = 10; i < len - 2; i++) {
+    if (buf[i] != pattern(index, i)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+namespace {
+
+class FakeSource : public sim_cam::Source {
+ public:
+  bool next(const sensor_t *, sim_cam::Frame *f) override {
+    int fps = _source_fps;
+    if (fps > 0) {
+      int64_t due = last_us_ + 1000000 / fps;
+      int64_t now = esp_timer_get_time();
+      if (due > now) {
+        std::this_thread::sleep_for(std::chrono::microseconds(due - now));
+      }
+    }
+    last_us_ = esp_timer_get_time();
+    size_t len = _source_len;
+    uint32_t n = (uint32_t)len;
+    f->data.resize(len);
+    uint8_t *p = f->data.data();
+    p[0] = 0xFF;
+    p[1] = 0xD8;
+    memcpy(p + 2, &index_, 4);
+    memcpy(p + 6, &n, 4);
+    for (size_t i = 10; i < len - 2; i++) {
+      p[i] = pattern(index_, i);
+    }
+    p[len - 2] = 0xFF;
+    p[len - 1] = 0xD9;
+    f->format = PIXFORMAT_JPEG;
+    f->width = 640;
+    f->height = 480;
+    f->timestamp_us = last_us_;
+    index_++;
+    return true;
+  }
+  // setiap frame sampai ke fb_get: kecepatan capture = kecepatan broadcaster
+  bool lossless() const override { return true; }
+
+ private:
+  uint32_t index_ = 0;
+  int64_t last_us_ = 0;
+};
+
+// ---------- klien ----------
+struct Viewer {
+  int hold_ms = 0;  // lama frame ditahan (klien lambat)
+  int jitter_us = 0;  // tahan frame 0..jitter_us secara acak (klien tidak sinkron dengan producer)
+  int id = -1;
+  std::atomic<bool> stop{false};
+  std::thread th;
+  uint32_t frames = 0;
+  uint32_t bad = 0;        // isi rusak saat diterima atau setelah ditahan
+  uint32_t seq_regress = 0;
+  uint32_t stale = 0;      // bukan frame terbaru saat diambil
+  uint32_t early_null = 0; // cam_bcast_wait NULL sebelum timeout (sinyal basi)
+  uint64_t skipped = 0;    // jumlah celah seq antar frame yang diterima
+  uint32_t first_dropped = 0, last_dropped = 0;
+  uint32_t first_seq = 0, last_seq = 0;
+
+  void start() {
+    id = cam_bcast_subscribe();
+    th = std::thread([this] { run(); });
+  }
+
+  void finish() {
+    stop = true;
+    th.join();
+    cam_bcast_unsubscribe(id);
+  }
+
+  void run() {
+    while (!stop) {
+      double wait_start = now_seconds();
+      cam_frame_t *f = cam_bcast_wait(id, 100 / portTICK_PERIOD_MS);
+      if (!f) {
+        // NULL hanya boleh berarti timeout; /stream menganggapnya kamera mati
+        if (now_seconds() - wait_start < 0.095) {
+          early_null++;
+        }
+        continue;
+      }
+      cam_bcast_stats_t st;
+      cam_bcast_get_stats(&st);
+      uint32_t dropped = cam_bcast_dropped(id);
+      // captured naik sebelum publish: frame terbaru = captured atau captured - 1
+      if (f->seq + 2 < st.captured) {
+        stale++;
+      }
+      if (frames == 0) {
+        first_seq = f->seq;
+        first_dropped = dropped;
+      } else if (f->seq <= last_seq) {
+        seq_regress++;
+      } else {
+        skipped += f->seq - last_seq - 1;
+      }
+      last_seq = f->seq;
+      last_dropped = dropped;
+      frames++;
+      if (!frame_intact(f->buf, f->len)) {
+        bad++;
+      }
+      if (jitter_us) {
+        std::this_thread::sleep_for(std::chrono::microseconds(rand() % jitter_us));
+      }
+      if (hold_ms) {
+        sleep_ms(hold_ms);
+        if (!frame_intact(f->buf, f->len)) {
+          bad++;
+        }
+      }
+      cam_frame_release(f);
+    }
+  }
+};
+
+}  // namespace
+
+static void camera_start() {
+  sim_cam::set_source(new FakeSource);
+  camera_config_t config = {};
+  config.pixel_format = PIXFORMAT_JPEG;
+  config.frame_size = FRAMESIZE_VGA;
+  config.jpeg_quality = 12;
+  config.fb_count = 2;
+  config.grab_mode = CAMERA_GRAB_LATEST;
+  if (esp_camera_init(&config) != ESP_OK) {
+    fprintf(stderr, "esp_camera_init failed\n");
+    exit(1);
+  }
+}
+
+// ---------- cek ----------
+static void check_fast_and_slow() {
+  _source_fps = 200;
+  Viewer fast, slow;
+  slow.hold_ms = 40;
+  fast.start();
+  slow.start();
+  CHECK(fast.id >= 0 && slow.id >= 0 && fast.id != slow.id);
+  sleep_ms(300);
+  cam_bcast_stats_t st0;
+  cam_bcast_get_stats(&st0);
+  sleep_ms(1500);
+  cam_bcast_stats_t st1;
+  cam_bcast_get_stats(&st1);
+  fast.finish();
+  slow.finish();
+
+  uint32_t captured = st1.captured - st0.captured;
+  printf("  fast + slow (200 fps)  captured %u, fast %u frames, slow %u frames / %u dropped\n", (unsigned)captured,
+         (unsigned)fast.frames, (unsigned)slow.frames, (unsigned)(slow.last_dropped - slow.first_dropped));
+  CHECK(captured > 200);
+  CHECK(fast.bad == 0 && slow.bad == 0);
+  CHECK(fast.seq_regress == 0 && slow.seq_regress == 0);
+  CHECK(fast.early_null == 0 && slow.early_null == 0);
+  // klien lambat tidak menahan klien cepat
+  CHECK(fast.frames + 10 >= fast.last_seq - fast.first_seq);
+  // klien lambat: frame terbaru, yang lain dihitung sebagai drop
+  CHECK(slow.frames > 10 && slow.frames < fast.frames / 3);
+  CHECK(slow.stale == 0);
+  uint64_t dropped = slow.last_dropped - slow.first_dropped;
+  CHECK(dropped + 2 >= slow.skipped && dropped <= slow.skipped + 2);
+  CHECK(st1.pool_exhausted == 0);
+  CHECK(st1.allocs == st0.allocs);  // ukuran frame tetap: tidak ada realloc
+}
+
+static void check_slots() {
+  int ids[CAM_BCAST_MAX_CLIENTS];
+  for (int i = 0; i < CAM_BCAST_MAX_CLIENTS; i++) {
+    ids[i] = cam_bcast_subscribe();
+    CHECK(ids[i] >= 0);
+  }
+  CHECK(cam_bcast_subscribe() == -1);
+  // semua klien menahan frame sekaligus: pool (2 per klien + 2) tetap cukup
+  std::vector<cam_frame_t *> held;
+  for (int i = 0; i < CAM_BCAST_MAX_CLIENTS; i++) {
+    cam_frame_t *f = cam_bcast_wait(ids[i], 1000 / portTICK_PERIOD_MS);
+    CHECK(f && frame_intact(f->buf, f->len));
+    held.push_back(f);
+  }
+  sleep_ms(100);  // producer terus mengganti frame pending sementara frame lama ditahan
+  cam_bcast_stats_t st;
+  cam_bcast_get_stats(&st);
+  CHECK(st.pool_exhausted == 0);
+  CHECK(st.clients == CAM_BCAST_MAX_CLIENTS);
+  for (cam_frame_t *f : held) {
+    CHECK(f && frame_intact(f->buf, f->len));
+    cam_frame_release(f);
+  }
+  cam_bcast_unsubscribe(ids[1]);
+  int again = cam_bcast_subscribe();
+  CHECK(again == ids[1]);
+  cam_frame_t *f = cam_bcast_wait(again, 1000 / portTICK_PERIOD_MS);
+  CHECK(f && frame_intact(f->buf, f->len));
+  cam_frame_release(f);
+  for (int i = 0; i < CAM_BCAST_MAX_CLIENTS; i++) {
+    cam_bcast_unsubscribe(ids[i]);
+  }
+  cam_bcast_get_stats(&st);
+  CHECK(st.clients == 0);
+}
+
+// Klien yang sempat mengambil frame pending lewat sinyal publish sebelumnya
+// lalu bertemu give basi: cam_bcast_wait tidak boleh mengembalikan NULL
+// sebelum timeout (/stream akan mengira kamera mati).
+static void check_stale_signal() {
+  _source_fps = 0;
+  std::vector<Viewer> clients(CAM_BCAST_MAX_CLIENTS);
+  for (auto &c : clients) {
+    c.jitter_us = 60;
+    c.start();
+  }
+  sleep_ms(1500);
+  uint32_t early_null = 0, frames = 0, bad = 0;
+  for (auto &c : clients) {
+    c.finish();
+    early_null += c.early_null;
+    frames += c.frames;
+    bad += c.bad + c.seq_regress;
+  }
+  _source_fps = 200;
+  printf("  stale signal (%d clients)  %u frames, %u early NULL\n", CAM_BCAST_MAX_CLIENTS, (unsigned)frames,
+         (unsigned)early_null);
+  CHECK(frames > 1000 && bad == 0);
+  CHECK(early_null == 0);
+}
+
+static std::atomic<int> _jobs{0};
+static std::thread::id _job_thread;
+
+static void job(void *arg) {
+  _job_thread = std::this_thread::get_id();
+  _jobs += *(int *)arg;
+}
+
+static std::atomic<uint32_t> _sink_frames{0}, _sink_bad{0};
+
+static void sink(const uint8_t *buf, size_t len, const struct timeval *, uint16_t width, uint16_t height) {
+  _sink_frames++;
+  if (!frame_intact(buf, len) || width != 640 || height != 480) {
+    _sink_bad++;
+  }
+}
+
+static void check_between_frames_and_sink() {
+  Viewer c;
+  c.start();
+  sleep_ms(100);
+  cam_bcast_stats_t st0, st1;
+  cam_bcast_get_stats(&st0);
+  int one = 1;
+  for (int i = 0; i < 10; i++) {
+    cam_bcast_between_frames(job, &one);
+    CHECK(_job_thread != std::this_thread::get_id());
+    sleep_ms(20);
+  }
+  cam_bcast_get_stats(&st1);
+  c.finish();
+  CHECK(_jobs == 10);
+  CHECK(st1.settle_skipped - st0.settle_skipped == 10 * CAM_BCAST_SETTLE_FRAMES);
+  CHECK(c.bad == 0 && c.seq_regress == 0 && c.early_null == 0);
+
+  // tanpa klien: capture tetap jalan untuk sink, langsung dari buffer driver
+  CHECK(cam_bcast_set_sink(sink));
+  sleep_ms(200);
+  CHECK(cam_bcast_set_sink(NULL));
+  sleep_ms(20);
+  uint32_t n = _sink_frames;
+  sleep_ms(100);
+  CHECK(n > 10 && _sink_bad == 0);
+  CHECK(_sink_frames == n);  // sink dilepas, tidak ada klien: capture berhenti
+}
+
+static int run_checks() {
+  printf("checks:\n");
+  check_fast_and_slow();
+  check_slots();
+  check_stale_signal();
+  check_between_frames_and_sink();
+  printf("checks: %s\n", _failed ? "FAIL" : "PASS");
+  return _failed ? 1 : 0;
+}
+
+// ---------- benchmark ----------
+static void bench_case(const char *name, int fast_n, int slow_hold_ms, double seconds) {
+  std::vector<Viewer> clients(fast_n + (slow_hold_ms ? 1 : 0));
+  if (slow_hold_ms) {
+    clients.back().hold_ms = slow_hold_ms;
+  }
+  for (auto &c : clients) c.start();
+  sleep_ms(200);
+  cam_bcast_stats_t st0, st1;
+  cam_bcast_get_stats(&st0);
+  std::vector<uint32_t> f0;
+  for (auto &c : clients) f0.push_back(c.frames);
+  double t0 = now_seconds();
+  std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+  double dt = now_seconds() - t0;
+  cam_bcast_get_stats(&st1);
+  std::vector<uint32_t> f1;
+  for (auto &c : clients) f1.push_back(c.frames);
+  uint32_t bad = 0, early_null = 0;
+  for (auto &c : clients) {
+    c.finish();
+    bad += c.bad;
+    early_null += c.early_null;
+  }
+  double cap = (st1.captured - st0.captured) / dt;
+  double fast_min = 1e9, slow = 0;
+  for (size_t i = 0; i < clients.size(); i++) {
+    double fps = (f1[i] - f0[i]) / dt;
+    if (clients[i].hold_ms) slow = fps;
+    else if (fps < fast_min) fast_min = fps;
+  }
+  printf("  %-20s capture %8.0f fps  fast client min %8.0f fps", name, cap, fast_min);
+  if (slow_hold_ms) printf("  slow %5.1f fps", slow);
+  printf("  allocs %u  pool exhausted %u%s\n", (unsigned)(st1.allocs - st0.allocs), (unsigned)st1.pool_exhausted,
+         bad ? "  CORRUPT" : "");
+  if (early_null) printf("  %u early NULL from cam_bcast_wait\n", (unsigned)early_null);
+  CHECK(bad == 0);
+  CHECK(early_null == 0);
+  CHECK(fast_min > 0 && (!slow_hold_ms || slow > 0));  // tidak ada klien yang macet
+}
+
+static void bench(double seconds, int kb) {
+  _source_fps = 0;
+  _source_len = (size_t)kb * 1024;
+  sleep_ms(100);
+  printf("bench: unpaced camera, %d KB frames, %.1f s per case\n", kb, seconds);
+  char name[32];
+  for (int n = 1; n <= CAM_BCAST_MAX_CLIENTS; n++) {
+    snprintf(name, sizeof(name), "%d fast", n);
+    bench_case(name, n, 0, seconds);
+  }
+  snprintf(name, sizeof(name), "%d fast + 1 slow", CAM_BCAST_MAX_CLIENTS - 1);
+  bench_case(name, CAM_BCAST_MAX_CLIENTS - 1, 40, seconds);
+}
+
+void setup() {
+  double seconds = sim_env_double("BENCH_SECONDS", 2);
+  long kb = sim_env_int("BENCH_KB", 30);
+  camera_start();
+  int rc = run_checks();
+  bench(seconds > 0 ? seconds : 2, kb > 0 ? (int)kb : 30);
+  fflush(stdout);
+  exit(rc || _failed ? 1 : 0);
+}
+
+void loop() {}
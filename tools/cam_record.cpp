@@ -0,0 +1,144 @@
+// Rekam /stream ke file .bbr terindeks untuk replay kamera di simulator
+// (SIM_CAMERA_REPLAY, lihat sim/replay.cpp), atau tampilkan isi rekaman.
+//
+// Build:  g++ -O2 -std=c++17 -pthread -I../sim cam_record.cpp mjpeg_client.cpp ../sim/replay_file.cpp -o cam_record
+// Contoh: ./cam_record 192.168.1.50 --label night --seconds 120 --out night.bbr
+//         ./cam_record --info night.bbr
+#include <atomic>
+#include <cmath>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include "mjpeg_client.h"
+#include "replay_file.h"
+
+struct Options {
+  std::string host;
+  int port = 80;
+  std::string path = "/stream";
+  int seconds = 60;  // 0 = sampai stream berhenti / Ctrl-C
+  int max_frames = 0;
+  std::string label;
+  std::string out;
+  int timeout_ms = 5000;
+};
+
+static std::atomic<bool> g_stop{false};
+
+static void on_signal(int) {
+  g_stop = true;
+}
+
+static int info(const char *path) {
+  replay::Reader r;
+  if (!r.open(path)) {
+    fprintf(stderr, "%s\n", r.error().c_str());
+    return 1;
+  }
+  const replay_header_t &h = r.header();
+  uint64_t bytes = 0;
+  uint32_t min_len = UINT32_MAX, max_len = 0;
+  int64_t max_gap = 0;
+  for (size_t i = 0; i < r.frames(); i++) {
+    const replay_index_t &e = r.entry(i);
+    bytes += e.len;
+    min_len = e.len < min_len ? e.len : min_len;
+    max_len = e.len > max_len ? e.len : max_len;
+    if (i > 0 && e.timestamp_us - r.entry(i - 1).timestamp_us > max_gap) {
+      max_gap = e.timestamp_us - r.entry(i - 1).timestamp_us;
+    }
+  }
+  printf("label      %s\n", h.label);
+  printf("recorded   %lld (epoch s)\n", (long long)h.recorded_at);
+  printf("frames     %u\n", h.frame_count);
+  if (r.frames() == 0) {
+    return 0;
+  }
+  double dur = r.duration_us() / 1e6;
+  printf("size       %ux%u (first frame)\n", r.entry(0).width, r.entry(0).height);
+  printf("duration   %.2f s, %.2f fps, max gap %.1f ms\n", dur, dur > 0 ? (r.frames() - 1) / dur : 0.0, max_gap / 1e3);
+  printf("bytes      %.1f KB/frame (min %.1f, max %.1f), %.1f KB/s\n", bytes / 1024.0 / r.frames(), min_len / 1024.0,
+         max_len / 1024.0, dur > 0 ? bytes / 1024.0 / dur : 0.0);
+  return 0;
+}
+
+int main(int argc, char **argv) {
+  if (argc == 3 && std::string(argv[1]) == "--info") {
+    return info(argv[2]);
+  }
+  Options o;
+  if (argc < 2) {
+    fprintf(stderr,
+            "usage: %s HOST --out FILE.bbr [--label NAME] [--port 80] [--path /stream]\n"
+            "          [--seconds 60] [--frames 0]\n"
+            "       %s --info FILE.bbr\n",
+            argv[0], argv[0]);
+    return 2;
+  }
+  o.host = argv[1];
+  for (int i = 2; i + 1 < argc; i += 2) {
+    std::string k = argv[i];
+    const char *v = argv[i + 1];
+    if (k == "--port") o.port = atoi(v);
+    else if (k == "--path") o.path = v;
+    else if (k == "--seconds") o.seconds = atoi(v);
+    else if (k == "--frames") o.max_frames = atoi(v);
+    else if (k == "--label") o.label = v;
+    else if (k == "--out") o.out = v;
+    else {
+      fprintf(stderr, "unknown option %s\n", k.c_str());
+      return 2;
+    }
+  }
+  if (o.out.empty()) {
+    fprintf(stderr, "--out is required\n");
+    return 2;
+  }
+  signal(SIGINT, on_signal);
+
+  replay::Writer w;
+  if (!w.open(o.out, o.label)) {
+    perror(o.out.c_str());
+    return 1;
+  }
+  bool write_ok = true;
+  uint64_t no_ts = 0;
+  double t0 = mjpeg::now_seconds();
+  mjpeg::FramePool pool(2, 64 * 1024);
+  mjpeg::StreamParser parser(pool, [&](const mjpeg::Frame &f) {
+    // X-Timestamp (jam perangkat) kalau ada; tanpa itu jam host
+    double ts = f.device_ts >= 0 ? f.device_ts : f.host_ts;
+    no_ts += f.device_ts < 0;
+    if (!w.add(f.data, f.len, (int64_t)llround(ts * 1e6))) {
+      write_ok = false;
+      g_stop = true;
+    }
+    if ((o.max_frames > 0 && (int)w.frames() >= o.max_frames) || (o.seconds > 0 && f.host_ts - t0 >= o.seconds)) {
+      g_stop = true;
+    }
+    return false;
+  });
+
+  mjpeg::Client client;
+  if (!client.open(o.host, o.port, o.path, o.timeout_ms)) {
+    fprintf(stderr, "%s\n", client.error().c_str());
+    return 1;
+  }
+  bool ok = client.run(parser, &g_stop);
+  client.close();
+  if (!w.close() || !write_ok) {
+    perror(o.out.c_str());
+    return 1;
+  }
+  printf("%s: %zu frames, %.1f KB, %.1f s\n", o.out.c_str(), w.frames(), w.bytes() / 1024.0, mjpeg::now_seconds() - t0);
+  if (no_ts > 0) {
+    printf("warning: %llu frames without X-Timestamp, host time used\n", (unsigned long long)no_ts);
+  }
+  if (!ok) {
+    fprintf(stderr, "stream error: %s\n", client.error().c_str());
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,368 @@
+// Cek ring buffer clip pre-event (BoboBee Stream/5_3/clip_ring.cpp) di host.
+//
+// Dicek:
+//   - append/open/next: isi, timestamp, ukuran frame utuh; cursor mulai dari
+//     frame pertama dengan t_us >= from_us; 0 kalau belum ada frame baru
+//   - peek tidak memindahkan cursor (dipakai untuk menghitung ukuran AVI)
+//   - wraparound: frame selalu kontigu (lompat ke awal buffer), frame tertua
+//     dibuang karena byte atau karena index penuh, isi tetap utuh
+//   - pin: frame yang sedang dibaca tidak pernah ditimpa, writer membuang
+//     frame baru (dropped_pinned); setelah next/close ruang bisa dipakai lagi
+//   - frame 0 byte / lebih besar dari ring (dropped_oversize), batas pembaca
+//   - clip_ring_fit_us: panjang window yang muat untuk laju frame sekarang
+//   - writer + 2 pembaca paralel: isi frame yang dibaca selalu cocok seq-nya
+//
+// Dibangun seperti sketch simulator (main() ada di sim/arduino.cpp): ring
+// asli memakai stand-in sim untuk portMUX/heap_caps. setup() menjalankan
+// cek lalu keluar dengan kode hasil cek.
+//
+// Build:  g++ -std=gnu++17 -O2 -pthread -I../sim/include -I../sim -I"../BoboBee Stream/5_3" -include Arduino.h -DARDUINO_ARCH_ESP32 -DCONFIG_ARDUHAL_ESP_LOG -DARDUHAL_LOG_LEVEL=2 clip_ring_check.cpp "../BoboBee Stream/5_3/clip_ring.cpp" ../sim/*.cpp -ljpeg -o clip_ring_check
+// Contoh: ./clip_ring_check
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "clip_ring.h"
+
+static int _failed = 0;
+
+#define CHECK(cond)                                                  \
+  do {                                                               \
+    if (!(cond)) {                                                   \
+      fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+      _failed++;                                                     \
+    }                                                                \
+  } while (0)
+
+// ring kecil supaya wrap dan eviction terjadi dalam beberapa frame; satu ring
+// per proses (clip_ring_begin idempotent), jadi tiap cek mulai dari waktu baru
+#define RING_BYTES  10000
+#define RING_FRAMES 16
+
+static int64_t _t_us = 1000000;  // jam tiruan, naik 10 ms per frame
+static uint32_t _id = 0;         // id frame yang ditulis ke isi frame
+
+// Isi frame: 4 byte id lalu pola dari id, jadi frame yang tertimpa ketahuan.
+static std::vector<uint8_t> make_frame(uint32_t id, size_t len) {
+  std::vector<uint8_t> f(len);
+  for (size_t i = 0; i < len; i++) {
+    f[i] = (uint8_t)(id * 7 + i);
+  }
+  if (len >= 4) {
+    memcpy(f.data(), &id, 4);
+  }
+  return f;
+}
+
+static bool frame_ok(const clip_frame_t &f) {
+  if (f.len < 4) {
+    return false;
+  }
+  uint32_t id;
+  memcpy(&id, f.buf, 4);
+  for (size_t i = 4; i < f.len; i++) {
+    if (f.buf[i] != (uint8_t)(id * 7 + i)) {
+      return false;
+    }
+  }
+  return f.width == (uint16_t)(100 + id % 3) && f.height == 75;
+}
+
+static uint32_t frame_id(const clip_frame_t &f) {
+  uint32_t id = 0;
+  memcpy(&id, f.buf, 4);
+  return id;
+}
+
+static bool append(size_t len) {
+  std::vector<uint8_t> f = make_frame(_id, len);
+  struct timeval ts = {(time_t)(_t_us / 1000000), (suseconds_t)(_t_us % 1000000)};
+  bool ok = clip_ring_append(f.data(), f.size(), &ts, (uint16_t)(100 + _id % 3), 75, _t_us);
+  _id++;
+  _t_us += 10000;
+  return ok;
+}
+
+static clip_ring_stats_t stats() {
+  clip_ring_stats_t st;
+  clip_ring_get_stats(&st);
+  return st;
+}
+
+static void check_basic() {
+  int64_t start = _t_us;
+  uint32_t first_id = _id;
+  for (int i = 0; i < 5; i++) {
+    CHECK(append(200 + i));
+  }
+  clip_cursor_t cur;
+  CHECK(clip_ring_open(&cur, start));
+  clip_frame_t f;
+  // peek tidak memindahkan cursor
+  CHECK(clip_ring_peek(&cur, 0, &f) == 1 && frame_id(f) == first_id);
+  CHECK(clip_ring_peek(&cur, 4, &f) == 1 && frame_id(f) == first_id + 4);
+  CHECK(clip_ring_peek(&cur, 5, &f) == 0);
+  for (int i = 0; i < 5; i++) {
+    CHECK(clip_ring_next(&cur, &f) == 1);
+    CHECK(frame_ok(f) && frame_id(f) == first_id + i && f.len == (size_t)(200 + i));
+    CHECK(f.t_us == start + i * 10000 && f.timestamp.tv_usec == (suseconds_t)(f.t_us % 1000000));
+  }
+  CHECK(clip_ring_next(&cur, &f) == 0);  // belum ada frame baru
+  CHECK(append(64));
+  CHECK(clip_ring_next(&cur, &f) == 1 && frame_id(f) == first_id + 5);
+  clip_ring_close(&cur);
+  CHECK(clip_ring_next(&cur, &f) == -1);
+  CHECK(clip_ring_peek(&cur, 0, &f) == -1);
+
+  // mulai di tengah: frame pertama dengan t_us >= from_us
+  CHECK(clip_ring_open(&cur, start + 25000));
+  CHECK(clip_ring_next(&cur, &f) == 1 && frame_id(f) == first_id + 3);
+  clip_ring_close(&cur);
+  // from_us di masa depan: kosong sampai frame berikutnya
+  CHECK(clip_ring_open(&cur, _t_us));
+  CHECK(clip_ring_next(&cur, &f) == 0);
+  CHECK(append(100));
+  CHECK(clip_ring_next(&cur, &f) == 1 && frame_id(f) == _id - 1);
+  clip_ring_close(&cur);
+}
+
+static void check_wraparound() {
+  // 3000 B per frame di ring 10000 B: posisi 0, 3000, 6000, lalu 9000 tidak
+  // muat di ujung -> lompat ke awal, frame tertua dibuang
+  clip_ring_stats_t before = stats();
+  int64_t start = _t_us;
+  for (int i = 0; i < 20; i++) {
+    CHECK(append(3000));
+    clip_ring_stats_t st = stats();
+    CHECK(st.used <= RING_BYTES);
+    CHECK(i < 4 || st.frames <= 3);  // frame kecil sisa cek sebelumnya sudah habis
+  }
+  clip_ring_stats_t st = stats();
+  CHECK(st.evicted > before.evicted);
+  CHECK(st.dropped_pinned == before.dropped_pinned);
+  CHECK(st.frames == 3 && st.newest_us == _t_us - 10000);
+
+  clip_cursor_t cur;
+  CHECK(clip_ring_open(&cur, start));  // frame tertua yang tersisa
+  clip_frame_t f;
+  int n = 0;
+  while (clip_ring_next(&cur, &f) == 1) {
+    CHECK(frame_ok(f) && f.len == 3000);  // frame tidak terpotong di ujung buffer
+    n++;
+  }
+  CHECK(n == 3);
+  clip_ring_close(&cur);
+
+  // index penuh: frame kecil dibuang karena jumlah, bukan byte
+  for (int i = 0; i < RING_FRAMES * 3; i++) {
+    CHECK(append(50 + i % 5));
+  }
+  st = stats();
+  CHECK(st.frames == RING_FRAMES);
+  CHECK(st.used < RING_BYTES / 4);
+  CHECK(clip_ring_open(&cur, 0));
+  n = 0;
+  while (clip_ring_next(&cur, &f) == 1) {
+    CHECK(frame_ok(f));
+    n++;
+  }
+  CHECK(n == RING_FRAMES);
+  clip_ring_close(&cur);
+}
+
+static void check_pinned() {
+  // isi ring penuh dengan frame 1000 B, lalu pin frame tertua
+  for (int i = 0; i < 10; i++) append(1000);
+  clip_cursor_t cur;
+  CHECK(clip_ring_open(&cur, 0));
+  clip_frame_t pinned;
+  CHECK(clip_ring_next(&cur, &pinned) == 1);
+  uint32_t pinned_id = frame_id(pinned);
+  clip_ring_stats_t before = stats();
+
+  // frame baru harus mengusir frame yang di-pin -> dibuang, bukan ditimpa
+  int dropped = 0;
+  for (int i = 0; i < 10; i++) {
+    if (!append(1000)) dropped++;
+  }
+  clip_ring_stats_t st = stats();
+  CHECK(dropped > 0);
+  CHECK(st.dropped_pinned == before.dropped_pinned + dropped);
+  CHECK(frame_ok(pinned) && frame_id(pinned) == pinned_id);  // memori tidak tertimpa
+
+  // sisa frame di depan cursor masih utuh dan berurutan
+  clip_frame_t f;
+  uint32_t last = pinned_id;
+  while (clip_ring_next(&cur, &f) == 1) {
+    CHECK(frame_ok(f) && frame_id(f) > last);
+    last = frame_id(f);
+  }
+  // pin sekarang di frame terakhir: frame lama boleh diusir lagi
+  CHECK(append(1000));
+  clip_ring_close(&cur);
+  before = stats();
+  for (int i = 0; i < 20; i++) {
+    CHECK(append(1000));
+  }
+  CHECK(stats().dropped_pinned == before.dropped_pinned);
+
+  // batas pembaca
+  clip_cursor_t a, b, c;
+  CHECK(clip_ring_open(&a, 0));
+  CHECK(clip_ring_open(&b, 0));
+  CHECK(CLIP_RING_MAX_READERS != 2 || !clip_ring_open(&c, 0));
+  clip_ring_close(&a);
+  CHECK(clip_ring_open(&c, 0));
+  clip_ring_close(&b);
+  clip_ring_close(&c);
+}
+
+static void check_oversize() {
+  clip_ring_stats_t before = stats();
+  std::vector<uint8_t> big = make_frame(0, RING_BYTES + 1);
+  struct timeval ts = {0, 0};
+  CHECK(!clip_ring_append(big.data(), big.size(), &ts, 1, 1, _t_us));
+  CHECK(!clip_ring_append(big.data(), 0, &ts, 1, 1, _t_us));
+  clip_ring_stats_t st = stats();
+  CHECK(st.dropped_oversize == before.dropped_oversize + 2);
+  CHECK(st.appended == before.appended);
+
+  // tepat sebesar ring: mengusir semua frame lain
+  CHECK(append(RING_BYTES));
+  st = stats();
+  CHECK(st.frames == 1 && st.used == RING_BYTES);
+  clip_cursor_t cur;
+  clip_frame_t f;
+  CHECK(clip_ring_open(&cur, 0));
+  CHECK(clip_ring_next(&cur, &f) == 1 && frame_ok(f) && f.len == RING_BYTES);
+  // selama frame itu di-pin tidak ada frame lain yang muat
+  CHECK(!append(10));
+  clip_ring_close(&cur);
+  CHECK(append(10));
+}
+
+static void check_fit() {
+  // 500 B tiap 10 ms: byte -> 10000*7/8 B / 50 B per ms ~ 175 ms, index ->
+  // 14 frame * 10 ms = 140 ms; yang lebih kecil menang
+  for (int i = 0; i < RING_FRAMES * 2; i++) append(500);
+  int64_t fit = clip_ring_fit_us();
+  CHECK(fit >= 130000 && fit <= 150000);
+  // frame besar: byte yang membatasi
+  for (int i = 0; i < RING_FRAMES * 2; i++) append(2400);
+  fit = clip_ring_fit_us();
+  CHECK(fit >= 25000 && fit <= 40000);
+  if (fit < 25000 || fit > 40000) {
+    fprintf(stderr, "  fit %lld us\n", (long long)fit);
+  }
+  // window sepanjang fit memang muat: pin frame tertua di window, isi ring
+  // selama fit, tidak ada frame yang dibuang
+  clip_cursor_t cur;
+  CHECK(clip_ring_open(&cur, _t_us));
+  clip_ring_stats_t before = stats();
+  for (int64_t t = 0; t < fit; t += 10000) {
+    append(2400);
+  }
+  CHECK(stats().dropped_pinned == before.dropped_pinned);
+  clip_ring_close(&cur);
+}
+
+static void check_trigger() {
+  clip_ring_stats_t before = stats();
+  clip_ring_trigger("prone", 123);
+  clip_ring_trigger("a-very-long-reason-name", 456);
+  clip_ring_stats_t st = stats();
+  CHECK(st.triggers == before.triggers + 2);
+  CHECK(st.trigger_us == 456);
+  CHECK(strcmp(st.trigger_reason, "a-very-long-rea") == 0);
+}
+
+// Writer secepatnya + 2 pembaca: frame yang dibaca tidak pernah berisi data
+// frame lain (writer tidak menimpa frame yang di-pin).
+static void check_concurrent() {
+  std::atomic<bool> stop{false};
+  std::atomic<int> bad{0};
+  std::atomic<int> reads{0};
+  clip_ring_stats_t before = stats();
+  std::thread writer([&] {
+    while (!stop) {
+      append(200 + _id % 900);
+      std::this_thread::yield();
+    }
+  });
+  std::vector<std::thread> readers;
+  for (int r = 0; r < 2; r++) {
+    readers.emplace_back([&] {
+      for (int round = 0; round < 200; round++) {
+        clip_cursor_t cur;
+        if (!clip_ring_open(&cur, 0)) {
+          continue;
+        }
+        clip_frame_t f;
+        uint32_t last = 0;
+        bool first = true;
+        for (int i = 0; i < 50; i++) {
+          int res = clip_ring_next(&cur, &f);
+          if (res < 0) {
+            bad++;
+            break;
+          }
+          if (res == 0) {
+            continue;
+          }
+          if (!frame_ok(f) || (!first && frame_id(f) <= last)) {
+            bad++;
+          }
+          std::this_thread::yield();  // tahan frame sebentar
+          if (!frame_ok(f)) {
+            bad++;
+          }
+          last = frame_id(f);
+          first = false;
+          reads++;
+        }
+        clip_ring_close(&cur);
+      }
+    });
+  }
+  for (auto &t : readers) t.join();
+  stop = true;
+  writer.join();
+  clip_ring_stats_t st = stats();
+  CHECK(bad == 0);
+  CHECK(reads > 1000);
+  CHECK(st.appended > before.appended);
+  printf("concurrent: %u appended, %d reads, %u dropped while pinned\n", st.appended - before.appended, reads.load(),
+         st.dropped_pinned - before.dropped_pinned);
+}
+
+void setup() {
+  if (!clip_ring_begin(RING_BYTES, RING_FRAMES)) {
+    fprintf(stderr, "clip_ring_begin failed\n");
+    exit(1);
+  }
+  CHECK(clip_ring_active());
+  CHECK(clip_ring_begin(RING_BYTES * 2, 4));  // idempotent
+  CHECK(stats().capacity == RING_BYTES);
+  CHECK(clip_ring_fit_us() == 0);  // belum ada frame
+
+  check_basic();
+  check_wraparound();
+  check_pinned();
+  check_oversize();
+  check_fit();
+  check_trigger();
+  check_concurrent();
+  if (_failed) {
+    printf("%d check(s) FAILED\n", _failed);
+  } else {
+    printf("all clip ring checks passed\n");
+  }
+  fflush(stdout);
+  exit(_failed ? 1 : 0);
+}
+
+void loop() {}
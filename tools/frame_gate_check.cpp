@@ -0,0 +1,521 @@
+// Cek deteksi scene + gate frame (BoboBee Stream/5_3/frame_gate.cpp) di host.
+//
+// Dicek dengan urutan JPEG yang dibuat libjpeg secara deterministik (seed
+// tetap, 320x240, 4:2:0 seperti OV2640):
+//   - day/night/static: noise sensor tidak boleh memicu scene baru
+//   - lampu mati (day -> night) tepat satu perubahan, framesize berubah juga
+//   - motion: objek bergerak memicu perubahan di (hampir) setiap frame, lalu
+//     berhenti begitu objek diam
+//   - keputusan gate: hold 1 s setelah perubahan, lalu hanya keepalive
+//   - grid DC vs rata-rata piksel asli, DRI/RSTn sama dengan tanpa DRI
+//   - frame terpotong/rusak (segmen pendek, komponen scan tidak ada di SOF,
+//     RSTn hilang, byte acak) -> "tanpa grid", tidak membaca di luar buffer
+//   - progressive -> fallback selisih ukuran
+// Terakhir: us per frame jpeg_dc_grid vs decode libjpeg penuh.
+//
+// --bbr menjalankan detector + gate pada rekaman tools/cam_record (mis. rekaman
+// siang, malam, bayi bergerak, kamar kosong) dengan timestamp aslinya.
+//
+// Build:  g++ -O2 -std=c++17 -I"../BoboBee Stream/5_3" -I../sim frame_gate_check.cpp "../BoboBee Stream/5_3/frame_gate.cpp" ../sim/replay_file.cpp -ljpeg -o frame_gate_check
+// Contoh: ./frame_gate_check
+//         ./frame_gate_check --bbr night.bbr --keepalive 5
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <jpeglib.h>  // butuh stdio/size_t lebih dulu
+
+#include "frame_gate.h"
+#include "replay_file.h"
+
+static int _failed = 0;
+
+#define CHECK(cond)                                                  \
+  do {                                                               \
+    if (!(cond)) {                                                   \
+      fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+      _failed++;                                                     \
+    }                                                                \
+  } while (0)
+
+static double now_seconds() {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// ---------- JPEG (libjpeg) ----------
+static std::vector<uint8_t> encode_jpeg(const std::vector<uint8_t> &rgb, int w, int h, int quality, int restart = 0, bool progressive = false) {
+  jpeg_compress_struct c;
+  jpeg_error_mgr err;
+  c.err = jpeg_std_error(&err);
+  jpeg_create_compress(&c);
+  unsigned char *mem = nullptr;
+  unsigned long len = 0;
+  jpeg_mem_dest(&c, &mem, &len);
+  c.image_width = w;
+  c.image_height = h;
+  c.input_components = 3;
+  c.in_color_space = JCS_RGB;
+  jpeg_set_defaults(&c);
+  jpeg_set_quality(&c, quality, TRUE);
+  c.restart_interval = restart;
+  if (progressive) {
+    jpeg_simple_progression(&c);
+  }
+  jpeg_start_compress(&c, TRUE);
+  while (c.next_scanline < c.image_height) {
+    JSAMPROW row = (JSAMPROW)&rgb[(size_t)c.next_scanline * w * 3];
+    jpeg_write_scanlines(&c, &row, 1);
+  }
+  jpeg_finish_compress(&c);
+  jpeg_destroy_compress(&c);
+  std::vector<uint8_t> out(mem, mem + len);
+  free(mem);
+  return out;
+}
+
+static void decode_jpeg(const std::vector<uint8_t> &jpg, std::vector<uint8_t> *rgb) {
+  jpeg_decompress_struct d;
+  jpeg_error_mgr err;
+  d.err = jpeg_std_error(&err);
+  jpeg_create_decompress(&d);
+  jpeg_mem_src(&d, jpg.data(), jpg.size());
+  jpeg_read_header(&d, TRUE);
+  d.out_color_space = JCS_RGB;
+  jpeg_start_decompress(&d);
+  rgb->resize((size_t)d.output_width * d.output_height * 3);
+  while (d.output_scanline < d.output_height) {
+    JSAMPROW row = (JSAMPROW)&(*rgb)[(size_t)d.output_scanline * d.output_width * 3];
+    jpeg_read_scanlines(&d, &row, 1);
+  }
+  jpeg_finish_decompress(&d);
+  jpeg_destroy_decompress(&d);
+}
+
+// ---------- Scene sintetis ----------
+// Kamar: gradien + dua "perabot", kecerahan global (siang/malam), noise
+// sensor per piksel, dan opsional objek terang yang bergerak.
+struct Scene {
+  int w = 320;
+  int h = 240;
+  int brightness = 100;  // persen dari kondisi siang
+  int noise = 3;         // amplitudo noise per piksel (+/-)
+  int obj_x = -1;        // -1 = tanpa objek
+  int obj_y = 100;
+  int obj_size = 48;
+};
+
+static uint32_t _rng = 1;
+
+static int rand_range(int amp) {
+  _rng = _rng * 1664525u + 1013904223u;
+  return amp ? (int)((_rng >> 8) % (2 * amp + 1)) - amp : 0;
+}
+
+static std::vector<uint8_t> render(const Scene &s) {
+  std::vector<uint8_t> rgb((size_t)s.w * s.h * 3);
+  for (int y = 0; y < s.h; y++) {
+    for (int x = 0; x < s.w; x++) {
+      int v = 70 + x * 80 / s.w + y * 40 / s.h;
+      if (x > s.w / 10 && x < s.w * 3 / 10 && y > s.h / 2) v = 50;                // lemari
+      if (x > s.w * 6 / 10 && x < s.w * 9 / 10 && y > s.h * 6 / 10) v = 180;      // kasur
+      if (s.obj_x >= 0 && x >= s.obj_x && x < s.obj_x + s.obj_size && y >= s.obj_y && y < s.obj_y + s.obj_size) {
+        v = 235;
+      }
+      v = v * s.brightness / 100 + rand_range(s.noise);
+      v = v < 0 ? 0 : (v > 255 ? 255 : v);
+      uint8_t *px = &rgb[((size_t)y * s.w + x) * 3];
+      px[0] = v;
+      px[1] = v;
+      px[2] = v * 9 / 10;  // sedikit hangat supaya kroma tidak nol
+    }
+  }
+  return rgb;
+}
+
+static std::vector<uint8_t> frame(const Scene &s, int quality = 80) {
+  return encode_jpeg(render(s), s.w, s.h, quality);
+}
+
+static scene_detector_t _det;
+
+// Jalankan urutan frame (10 fps); kembalikan indeks frame yang memicu scene baru.
+static std::vector<int> run(const std::vector<std::vector<uint8_t>> &seq, int64_t t0_us = 0) {
+  std::vector<int> changed;
+  for (size_t i = 0; i < seq.size(); i++) {
+    if (scene_detector_update(&_det, seq[i].data(), seq[i].size(), t0_us + (int64_t)i * 100000)) {
+      changed.push_back((int)i);
+    }
+  }
+  return changed;
+}
+
+static void check_still_scenes() {
+  struct {
+    const char *name;
+    int brightness;
+    int noise;
+  } cases[] = {{"day", 100, 4}, {"night", 30, 24}, {"static", 100, 0}};
+  for (auto &c : cases) {
+    Scene s;
+    s.brightness = c.brightness;
+    s.noise = c.noise;
+    std::vector<std::vector<uint8_t>> seq;
+    for (int i = 0; i < 40; i++) {
+      seq.push_back(frame(s));
+    }
+    scene_detector_init(&_det);
+    std::vector<int> ch = run(seq);
+    if (ch.size() != 1 || ch[0] != 0) {
+      fprintf(stderr, "  %s: %zu perubahan\n", c.name, ch.size());
+    }
+    CHECK(ch.size() == 1 && ch[0] == 0);  // hanya frame pertama (referensi)
+    CHECK(_det.dc_failures == 0);
+    CHECK(_det.w == 20 && _det.h == 15);  // MCU 16x16
+  }
+}
+
+static void check_lights_and_framesize() {
+  Scene s;
+  std::vector<std::vector<uint8_t>> seq;
+  for (int i = 0; i < 20; i++) seq.push_back(frame(s));
+  s.brightness = 30;
+  s.noise = 24;
+  for (int i = 0; i < 20; i++) seq.push_back(frame(s));
+  scene_detector_init(&_det);
+  std::vector<int> ch = run(seq);
+  CHECK(ch.size() == 2 && ch[1] == 20);  // lampu mati tepat satu perubahan
+  CHECK(_det.changed_us == 20 * 100000);
+
+  // VGA dibinning 2x ke grid 20x15 yang sama: isi sama, bukan scene baru
+  Scene big = s;
+  big.w = 640;
+  big.h = 480;
+  std::vector<uint8_t> f = frame(big);
+  CHECK(!scene_detector_update(&_det, f.data(), f.size(), 5000000));
+  // SVGA -> grid 25x19: framesize berubah (ABR) -> referensi baru
+  big.w = 800;
+  big.h = 600;
+  f = frame(big);
+  CHECK(scene_detector_update(&_det, f.data(), f.size(), 5100000));
+  CHECK(_det.w == 25 && _det.h == 19);
+  f = frame(big);
+  CHECK(!scene_detector_update(&_det, f.data(), f.size(), 5200000));
+}
+
+static void check_motion() {
+  Scene s;
+  std::vector<std::vector<uint8_t>> seq;
+  for (int i = 0; i < 10; i++) seq.push_back(frame(s));
+  s.obj_x = 20;
+  for (int i = 0; i < 20; i++) {
+    seq.push_back(frame(s));
+    s.obj_x += 12;
+  }
+  for (int i = 0; i < 20; i++) seq.push_back(frame(s));  // objek berhenti
+  scene_detector_init(&_det);
+  std::vector<int> ch = run(seq);
+  int moving = 0, after = 0;
+  for (int i : ch) {
+    if (i >= 10 && i < 30) moving++;
+    if (i >= 31) after++;
+  }
+  CHECK(ch.size() > 0 && ch[0] == 0);
+  CHECK(moving >= 18);  // objek 48 px bergerak 12 px/frame
+  CHECK(after == 0);
+  if (moving < 18 || after) {
+    fprintf(stderr, "  motion: %d/20 saat bergerak, %d setelah diam\n", moving, after);
+  }
+
+  // objek kecil sekali (satu sel) = noise, tidak memicu
+  Scene t;
+  std::vector<uint8_t> a = frame(t);
+  t.obj_x = 160;
+  t.obj_y = 96;
+  t.obj_size = 6;
+  std::vector<uint8_t> b = frame(t);
+  scene_detector_init(&_det);
+  CHECK(run({a, b}).size() == 1);
+}
+
+// Keputusan kirim/drop untuk satu klien ber-gate (keepalive 5 s, hold 1 s).
+static void check_gate() {
+  Scene s;
+  std::vector<std::vector<uint8_t>> seq;
+  for (int i = 0; i < 100; i++) seq.push_back(frame(s));  // 10 s diam
+  s.obj_x = 20;
+  for (int i = 0; i < 20; i++) {
+    seq.push_back(frame(s));
+    s.obj_x += 12;
+  }
+  for (int i = 0; i < 80; i++) seq.push_back(frame(s));  // 8 s diam lagi
+
+  scene_detector_init(&_det);
+  frame_gate_t g;
+  frame_gate_init(&g, 5000);
+  std::vector<int> sent;
+  for (size_t i = 0; i < seq.size(); i++) {
+    int64_t now = (int64_t)i * 100000;
+    scene_detector_update(&_det, seq[i].data(), seq[i].size(), now);
+    if (frame_gate_pass(&g, _det.scene, _det.changed_us, now)) {
+      sent.push_back((int)i);
+    }
+  }
+  // diam: 10 frame hold (0..0.9 s), lalu keepalive 5 s setelah kirim terakhir
+  std::vector<int> still;
+  for (int i : sent) {
+    if (i < 100) still.push_back(i);
+  }
+  CHECK(still.size() == 11);
+  CHECK(still.size() == 11 && still[9] == 9 && still[10] == 59);
+  // gerak: semua frame lolos (scene baru atau masih dalam hold)
+  int moving = 0;
+  int last_move_change = 0;
+  for (int i : sent) {
+    if (i >= 100 && i < 120) moving++;
+  }
+  CHECK(moving == 20);
+  last_move_change = (int)(_det.changed_us / 100000);
+  CHECK(last_move_change >= 118 && last_move_change <= 120);
+  // setelah diam: hold 1 s dari perubahan terakhir, lalu keepalive lagi
+  int tail_hold = 0, tail_keepalive = 0;
+  for (int i : sent) {
+    if (i >= 120 && i < last_move_change + 10) tail_hold++;
+    if (i >= last_move_change + 10) tail_keepalive++;
+  }
+  CHECK(tail_hold == last_move_change + 10 - 120);
+  CHECK(tail_keepalive == 1);  // satu keepalive dalam ~7 s sisa
+  CHECK(g.passed == sent.size() && g.passed + g.skipped == seq.size());
+
+  // gate mati: semua frame dikirim
+  frame_gate_t off;
+  frame_gate_init(&off, 0);
+  for (int i = 0; i < 50; i++) {
+    CHECK(frame_gate_pass(&off, 7, 0, (int64_t)i * 100000));
+  }
+  CHECK(off.skipped == 0);
+}
+
+static void check_grid_values() {
+  Scene s;
+  s.noise = 0;
+  std::vector<uint8_t> rgb = render(s);
+  std::vector<uint8_t> jpg = encode_jpeg(rgb, s.w, s.h, 80);
+  static jpeg_dc_ctx_t ctx;
+  uint8_t grid[SCENE_GRID_MAX];
+  uint16_t w = 0, h = 0;
+  int cells = jpeg_dc_grid(&ctx, jpg.data(), jpg.size(), grid, SCENE_GRID_MAX, &w, &h);
+  CHECK(cells == 300 && w == 20 && h == 15);
+
+  // rata-rata luma tiap MCU 16x16 dari piksel asli (Y dari RGB, JFIF)
+  int worst = 0;
+  for (int gy = 0; gy < h && cells; gy++) {
+    for (int gx = 0; gx < w; gx++) {
+      double sum = 0;
+      for (int y = gy * 16; y < gy * 16 + 16; y++) {
+        for (int x = gx * 16; x < gx * 16 + 16; x++) {
+          const uint8_t *px = &rgb[((size_t)y * s.w + x) * 3];
+          sum += 0.299 * px[0] + 0.587 * px[1] + 0.114 * px[2];
+        }
+      }
+      int d = abs((int)(sum / 256 + 0.5) - grid[gy * w + gx]);
+      worst = d > worst ? d : worst;
+    }
+  }
+  CHECK(worst <= 3);
+
+  // DRI + RSTn: grid identik
+  std::vector<uint8_t> dri = encode_jpeg(rgb, s.w, s.h, 80, 3);
+  uint8_t grid2[SCENE_GRID_MAX];
+  CHECK(jpeg_dc_grid(&ctx, dri.data(), dri.size(), grid2, SCENE_GRID_MAX, &w, &h) == 300);
+  CHECK(memcmp(grid, grid2, 300) == 0);
+
+  // grid dibinning kalau max_cells lebih kecil
+  CHECK(jpeg_dc_grid(&ctx, jpg.data(), jpg.size(), grid2, 100, &w, &h) == 80 && w == 10 && h == 8);
+}
+
+// ---------- Frame rusak ----------
+static size_t find_marker(const std::vector<uint8_t> &jpg, uint8_t m) {
+  for (size_t i = 2; i + 1 < jpg.size(); i++) {
+    if (jpg[i] == 0xFF && jpg[i + 1] == m) {
+      return i;
+    }
+  }
+  return 0;
+}
+
+static int grid_of(const std::vector<uint8_t> &jpg) {
+  static jpeg_dc_ctx_t ctx;
+  uint8_t grid[SCENE_GRID_MAX];
+  uint16_t w = 0, h = 0;
+  int cells = jpeg_dc_grid(&ctx, jpg.data(), jpg.size(), grid, SCENE_GRID_MAX, &w, &h);
+  if (cells) {
+    CHECK(cells == w * h && cells <= SCENE_GRID_MAX);
+  }
+  return cells;
+}
+
+// Ubah panjang segmen marker m (file tetap utuh).
+static std::vector<uint8_t> with_seglen(const std::vector<uint8_t> &jpg, uint8_t m, uint16_t seglen) {
+  std::vector<uint8_t> out = jpg;
+  size_t at = find_marker(out, m);
+  out[at + 2] = seglen >> 8;
+  out[at + 3] = seglen & 0xFF;
+  return out;
+}
+
+static void check_corrupt() {
+  Scene s;
+  std::vector<uint8_t> jpg = frame(s);
+  CHECK(grid_of(jpg) == 300);
+
+  // terpotong di tengah header atau entropy data -> tanpa grid
+  size_t sos = find_marker(jpg, 0xDA);
+  CHECK(sos > 0);
+  for (size_t cut = 0; cut < sos + 14; cut++) {
+    CHECK(grid_of(std::vector<uint8_t>(jpg.begin(), jpg.begin() + cut)) == 0);
+  }
+  for (size_t cut = sos + 14; cut + 64 < jpg.size(); cut += 7) {
+    CHECK(grid_of(std::vector<uint8_t>(jpg.begin(), jpg.begin() + cut)) == 0);
+  }
+  // hanya EOI hilang: data scan lengkap, grid tetap ada
+  CHECK(grid_of(std::vector<uint8_t>(jpg.begin(), jpg.end() - 2)) == 300);
+
+  // segmen lebih pendek dari isinya
+  CHECK(grid_of(with_seglen(jpg, 0xC0, 8)) == 0);   // SOF 3 komponen butuh 17
+  CHECK(grid_of(with_seglen(jpg, 0xC4, 10)) == 0);  // DHT < 17 byte counts
+  CHECK(grid_of(with_seglen(jpg, 0xDB, 40)) == 0);  // DQT < 64 nilai
+  CHECK(grid_of(with_seglen(jpg, 0xDA, 4)) == 0);   // SOS 3 komponen butuh 8
+
+  // komponen scan tidak ada di SOF
+  std::vector<uint8_t> bad = jpg;
+  bad[sos + 5] = 0x7F;
+  CHECK(grid_of(bad) == 0);
+  bad = jpg;
+  bad[sos + 9] = 0x01;  // Cr diganti Y: Cr tidak pernah cocok
+  CHECK(grid_of(bad) == 0);
+
+  // sampling factor 0 (dulu: bagi nol)
+  bad = jpg;
+  size_t sof = find_marker(bad, 0xC0);
+  bad[sof + 2 + 2 + 7] = 0x00;
+  CHECK(grid_of(bad) == 0);
+
+  // DRI dengan RSTn yang hilang atau terpotong
+  std::vector<uint8_t> dri = encode_jpeg(render(s), s.w, s.h, 80, 4);
+  CHECK(grid_of(dri) == 300);
+  size_t rst = find_marker(dri, 0xD2);
+  CHECK(rst > 0);
+  bad = dri;
+  bad[rst + 1] = 0x00;  // FF D2 -> byte stuffing
+  CHECK(grid_of(bad) == 0);
+  CHECK(grid_of(std::vector<uint8_t>(dri.begin(), dri.begin() + rst + 40)) == 0);
+
+  // byte acak: tidak boleh crash (jalankan juga dengan -fsanitize=address)
+  uint32_t seed = 7;
+  for (int i = 0; i < 3000; i++) {
+    bad = i % 2 ? jpg : dri;
+    for (int k = 0; k < 1 + i % 4; k++) {
+      seed = seed * 1103515245u + 12345u;
+      size_t at = 2 + (seed >> 8) % (i % 3 ? sos + 20 : bad.size() - 2);
+      seed = seed * 1103515245u + 12345u;
+      bad[at] = seed >> 24;
+    }
+    grid_of(bad);
+  }
+
+  // progressive: tidak ada grid, fallback selisih ukuran
+  std::vector<std::vector<uint8_t>> seq;
+  for (int i = 0; i < 20; i++) seq.push_back(encode_jpeg(render(s), s.w, s.h, 80, 0, true));
+  scene_detector_init(&_det);
+  std::vector<int> ch = run(seq);
+  CHECK(_det.dc_failures == 20);
+  CHECK(ch.size() == 1 && ch[0] == 0);
+}
+
+static void bench() {
+  Scene s;
+  s.w = 640;
+  s.h = 480;
+  std::vector<uint8_t> jpg = frame(s, 85);
+  static jpeg_dc_ctx_t ctx;
+  uint8_t grid[SCENE_GRID_MAX];
+  uint16_t w, h;
+  const int iters = 200;
+  double t0 = now_seconds();
+  for (int i = 0; i < iters; i++) {
+    jpeg_dc_grid(&ctx, jpg.data(), jpg.size(), grid, SCENE_GRID_MAX, &w, &h);
+  }
+  double dc = (now_seconds() - t0) / iters;
+  std::vector<uint8_t> rgb;
+  t0 = now_seconds();
+  for (int i = 0; i < iters; i++) {
+    decode_jpeg(jpg, &rgb);
+  }
+  double full = (now_seconds() - t0) / iters;
+  printf("VGA %zu B: jpeg_dc_grid %.0f us/frame, decode libjpeg %.0f us/frame (host)\n", jpg.size(), dc * 1e6, full * 1e6);
+}
+
+// ---------- Rekaman .bbr ----------
+static int replay_bbr(const char *path, int keepalive_s) {
+  replay::Reader r;
+  if (!r.open(path)) {
+    fprintf(stderr, "%s\n", r.error().c_str());
+    return 1;
+  }
+  scene_detector_init(&_det);
+  frame_gate_t g;
+  frame_gate_init(&g, keepalive_s * 1000);
+  std::vector<uint8_t> jpg;
+  int64_t t0 = r.frames() ? r.entry(0).timestamp_us : 0;
+  for (size_t i = 0; i < r.frames(); i++) {
+    if (!r.read(i, &jpg)) {
+      fprintf(stderr, "gagal membaca frame %zu\n", i);
+      return 1;
+    }
+    int64_t now = r.entry(i).timestamp_us - t0;
+    scene_detector_update(&_det, jpg.data(), jpg.size(), now);
+    frame_gate_pass(&g, _det.scene, _det.changed_us, now);
+  }
+  double secs = r.duration_us() / 1e6;
+  printf("%s \"%s\": %zu frame, %.1f s\n", path, r.header().label, r.frames(), secs);
+  printf("  scene berubah %u kali (%.2f/s), tanpa grid %u frame\n", _det.changes, secs > 0 ? _det.changes / secs : 0.0, _det.dc_failures);
+  printf("  gate %d s: kirim %u, drop %u (%.0f%%)\n", keepalive_s, g.passed, g.skipped, r.frames() ? 100.0 * g.skipped / r.frames() : 0.0);
+  return 0;
+}
+
+int main(int argc, char **argv) {
+  const char *bbr = nullptr;
+  int keepalive_s = 5;
+  for (int i = 1; i < argc; i++) {
+    std::string a = argv[i];
+    if (a == "--bbr" && i + 1 < argc) {
+      bbr = argv[++i];
+    } else if (a == "--keepalive" && i + 1 < argc) {
+      keepalive_s = atoi(argv[++i]);
+    } else {
+      fprintf(stderr, "usage: %s [--bbr rekaman.bbr] [--keepalive detik]\n", argv[0]);
+      return 2;
+    }
+  }
+  if (bbr) {
+    return replay_bbr(bbr, keepalive_s);
+  }
+
+  check_still_scenes();
+  check_lights_and_framesize();
+  check_motion();
+  check_gate();
+  check_grid_values();
+  check_corrupt();
+  if (_failed) {
+    printf("%d check(s) FAILED\n", _failed);
+    return 1;
+  }
+  printf("all frame gate checks passed\n");
+  bench();
+  return 0;
+}
@@ -0,0 +1,314 @@
+// Latensi capture -> terima per frame dari X-Timestamp /stream.
+//
+// Jam host disejajarkan ke jam device lewat GET /clock (uptime_us, jam yang
+// sama dengan fb->timestamp): beberapa probe, diambil yang RTT-nya terkecil,
+// offset = jam device - titik tengah RTT (galat maks RTT/2). Sinkronisasi
+// diulang tiap --resync detik selama stream berjalan; offset per frame
+// diinterpolasi linear di antara titik sinkron, jadi drift kristal ESP32
+// ikut terkoreksi (dilaporkan dalam ppm).
+//
+// Latensi = waktu frame lengkap diterima (jam host -> jam device) - X-Timestamp.
+// Dilaporkan: p50/p90/p99/max, jitter (rata-rata |selisih latensi berurutan|,
+// RFC 3550) dan stddev, stall (jarak antar frame > --stall-ms). --csv
+// menulis satu baris per frame; --summary menambahkan satu baris ringkasan
+// ke file (header ditulis kalau file baru) untuk dilacak antar build.
+//
+// Build:  g++ -O2 -std=c++17 -pthread g2g_latency.cpp mjpeg_client.cpp -o g2g_latency
+// Contoh: ./g2g_latency 192.168.1.50 --stream-port 81 --seconds 30
+//         ./g2g_latency 192.168.1.50 --seconds 60 --csv frames.csv --summary runs.csv --label abr-off
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "mjpeg_client.h"
+
+struct Options {
+  std::string host;
+  int port = 80;
+  int stream_port = 0;  // 0 = sama dengan port (app_httpd: /stream di port + 1)
+  std::string path = "/stream";
+  std::string clock_path = "/clock";
+  int seconds = 30;
+  double warmup = 2;  // detik pertama tidak dihitung (koneksi, AEC)
+  int probes = 16;
+  double resync = 5;
+  double stall_ms = 250;
+  int timeout_ms = 5000;
+  std::string csv;
+  std::string summary;
+  std::string label;
+};
+
+struct SyncPoint {
+  double host;    // titik tengah RTT (steady clock host, detik)
+  double offset;  // jam device - jam host
+  double rtt;
+};
+
+struct Sample {
+  double device_ts;
+  double host_ts;
+  size_t len;
+};
+
+static std::atomic<bool> g_stop{false};
+
+static void on_signal(int) {
+  g_stop = true;
+}
+
+static int tcp_connect(const std::string &host, int port, int timeout_ms) {
+  addrinfo hints{}, *res = nullptr;
+  hints.ai_family = AF_INET;
+  hints.ai_socktype = SOCK_STREAM;
+  if (getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &res) != 0) return -1;
+  int fd = socket(res->ai_family, res->ai_socktype, res->ai_protocol);
+  if (fd >= 0) {
+    timeval tv{timeout_ms / 1000, (timeout_ms % 1000) * 1000};
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    if (connect(fd, res->ai_addr, res->ai_addrlen) != 0) {
+      close(fd);
+      fd = -1;
+    }
+  }
+  freeaddrinfo(res);
+  return fd;
+}
+
+// Satu probe /clock. Connect tidak ikut dihitung: RTT dari send sampai body lengkap.
+static bool clock_probe(const Options &o, SyncPoint *out) {
+  int fd = tcp_connect(o.host, o.port, o.timeout_ms);
+  if (fd < 0) return false;
+  std::string req = "GET " + o.clock_path + " HTTP/1.1\r\nHost: " + o.host + "\r\nConnection: close\r\n\r\n";
+  double t0 = mjpeg::now_seconds();
+  bool ok = send(fd, req.data(), req.size(), MSG_NOSIGNAL) == (ssize_t)req.size();
+  std::string resp;
+  char buf[512];
+  ssize_t n;
+  const char *field = nullptr;
+  while (ok && (n = recv(fd, buf, sizeof(buf), 0)) > 0) {
+    resp.append(buf, n);
+    if ((field = strstr(resp.c_str(), "\"uptime_us\":")) && strchr(field, '}')) break;
+    field = nullptr;
+  }
+  double t1 = mjpeg::now_seconds();
+  close(fd);
+  if (!field) return false;
+  double device = strtoll(field + 12, nullptr, 10) / 1e6;
+  out->host = (t0 + t1) / 2;
+  out->offset = device - out->host;
+  out->rtt = t1 - t0;
+  return true;
+}
+
+static bool clock_sync(const Options &o, SyncPoint *best) {
+  bool any = false;
+  for (int i = 0; i < o.probes; i++) {
+    SyncPoint p;
+    if (clock_probe(o, &p) && (!any || p.rtt < best->rtt)) {
+      *best = p;
+      any = true;
+    }
+  }
+  return any;
+}
+
+// Offset pada waktu host h: interpolasi linear antar titik sinkron, di luar rentang pakai ujung terdekat.
+static double offset_at(const std::vector<SyncPoint> &sync, double h) {
+  if (h <= sync.front().host) return sync.front().offset;
+  for (size_t i = 1; i < sync.size(); i++) {
+    if (h <= sync[i].host) {
+      const SyncPoint &a = sync[i - 1], &b = sync[i];
+      return a.offset + (b.offset - a.offset) * (h - a.host) / (b.host - a.host);
+    }
+  }
+  return sync.back().offset;
+}
+
+static double percentile(std::vector<double> v, double p) {
+  if (v.empty()) return 0;
+  std::sort(v.begin(), v.end());
+  size_t idx = (size_t)std::min<double>(v.size() - 1, p / 100.0 * (v.size() - 1) + 0.5);
+  return v[idx];
+}
+
+int main(int argc, char **argv) {
+  Options o;
+  if (argc < 2) {
+    fprintf(stderr,
+            "usage: %s HOST [--port 80] [--stream-port P] [--path /stream] [--clock-path /clock]\n"
+            "          [--seconds 30] [--warmup 2] [--probes 16] [--resync 5] [--stall-ms 250]\n"
+            "          [--csv FILE] [--summary FILE] [--label NAME]\n",
+            argv[0]);
+    return 2;
+  }
+  o.host = argv[1];
+  for (int i = 2; i + 1 < argc; i += 2) {
+    std::string k = argv[i];
+    const char *v = argv[i + 1];
+    if (k == "--port") o.port = atoi(v);
+    else if (k == "--stream-port") o.stream_port = atoi(v);
+    else if (k == "--path") o.path = v;
+    else if (k == "--clock-path") o.clock_path = v;
+    else if (k == "--seconds") o.seconds = atoi(v);
+    else if (k == "--warmup") o.warmup = atof(v);
+    else if (k == "--probes") o.probes = std::max(1, atoi(v));
+    else if (k == "--resync") o.resync = atof(v);
+    else if (k == "--stall-ms") o.stall_ms = atof(v);
+    else if (k == "--csv") o.csv = v;
+    else if (k == "--summary") o.summary = v;
+    else if (k == "--label") o.label = v;
+    else {
+      fprintf(stderr, "unknown option %s\n", k.c_str());
+      return 2;
+    }
+  }
+  signal(SIGINT, on_signal);
+
+  std::vector<SyncPoint> sync;
+  SyncPoint p;
+  if (!clock_sync(o, &p)) {
+    fprintf(stderr, "GET %s failed (firmware without /clock?)\n", o.clock_path.c_str());
+    return 1;
+  }
+  sync.push_back(p);
+  printf("clock offset %.3f s, rtt %.1f ms\n", p.offset, p.rtt * 1000);
+
+  // sinkron ulang di thread sendiri supaya stream tidak tertahan
+  std::mutex mu;
+  std::condition_variable cv;
+  std::thread syncer([&] {
+    std::unique_lock<std::mutex> lock(mu);
+    while (!g_stop && o.resync > 0) {
+      if (cv.wait_for(lock, std::chrono::duration<double>(o.resync), [] { return g_stop.load(); })) break;
+      lock.unlock();
+      SyncPoint s;
+      bool ok = clock_sync(o, &s);
+      lock.lock();
+      if (ok) sync.push_back(s);
+    }
+  });
+
+  std::vector<Sample> samples;
+  samples.reserve(o.seconds > 0 ? o.seconds * 60 : 4096);
+  double t0 = mjpeg::now_seconds();
+  uint64_t no_ts = 0;
+  mjpeg::FramePool pool(2, 64 * 1024);
+  mjpeg::StreamParser parser(pool, [&](const mjpeg::Frame &f) {
+    if (f.device_ts < 0) {
+      no_ts++;
+    } else if (f.host_ts - t0 >= o.warmup) {
+      samples.push_back({f.device_ts, f.host_ts, f.len});
+    }
+    if (o.seconds > 0 && f.host_ts - t0 >= o.warmup + o.seconds) g_stop = true;
+    return false;
+  });
+  mjpeg::Client client;
+  bool ok = client.open(o.host, o.stream_port ? o.stream_port : o.port, o.path, o.timeout_ms) && client.run(parser, &g_stop);
+  std::string err = client.error();
+  client.close();
+
+  {
+    std::lock_guard<std::mutex> lock(mu);
+    g_stop = true;
+  }
+  cv.notify_all();
+  syncer.join();
+  if (clock_sync(o, &p)) sync.push_back(p);
+
+  if (!ok && samples.empty()) {
+    fprintf(stderr, "stream error: %s\n", err.c_str());
+    return 1;
+  }
+  if (samples.size() < 2) {
+    fprintf(stderr, "not enough frames with X-Timestamp (%zu, %llu without)\n", samples.size(), (unsigned long long)no_ts);
+    return 1;
+  }
+
+  std::sort(sync.begin(), sync.end(), [](const SyncPoint &a, const SyncPoint &b) { return a.host < b.host; });
+  double rtt_max = 0;
+  for (auto &s : sync) rtt_max = std::max(rtt_max, s.rtt);
+  double span = sync.back().host - sync.front().host;
+  double drift_ppm = span > 1 ? (sync.back().offset - sync.front().offset) / span * 1e6 : 0;
+
+  FILE *csv = o.csv.empty() ? nullptr : fopen(o.csv.c_str(), "w");
+  if (csv) fprintf(csv, "index,device_ts,host_ts,latency_ms,bytes\n");
+  std::vector<double> lat;
+  lat.reserve(samples.size());
+  double jitter = 0, sum = 0, sum2 = 0, stall_time = 0;
+  int stalls = 0, negative = 0;
+  for (size_t i = 0; i < samples.size(); i++) {
+    const Sample &s = samples[i];
+    double ms = (s.host_ts + offset_at(sync, s.host_ts) - s.device_ts) * 1000;
+    if (ms < 0) negative++;
+    if (i > 0) {
+      jitter += std::fabs(ms - lat.back());
+      double gap = (s.host_ts - samples[i - 1].host_ts) * 1000;
+      if (gap > o.stall_ms) {
+        stalls++;
+        stall_time += gap;
+      }
+    }
+    lat.push_back(ms);
+    sum += ms;
+    sum2 += ms * ms;
+    if (csv) fprintf(csv, "%zu,%.6f,%.6f,%.3f,%zu\n", i, s.device_ts, s.host_ts - t0, ms, s.len);
+  }
+  if (csv) fclose(csv);
+
+  size_t n = lat.size();
+  double mean = sum / n;
+  double stddev = std::sqrt(std::max(0.0, sum2 / n - mean * mean));
+  jitter /= n - 1;
+  double secs = samples.back().host_ts - samples.front().host_ts;
+  double fps = secs > 0 ? (n - 1) / secs : 0;
+  double p50 = percentile(lat, 50), p90 = percentile(lat, 90), p99 = percentile(lat, 99);
+  double max = *std::max_element(lat.begin(), lat.end());
+
+  printf("%zu frames in %.1f s (%.1f fps), %zu clock syncs, max rtt %.1f ms (offset error <= %.1f ms), drift %.1f ppm\n", n, secs, fps,
+         sync.size(), rtt_max * 1000, rtt_max * 500, drift_ppm);
+  printf("latency ms: p50 %.1f  p90 %.1f  p99 %.1f  max %.1f  mean %.1f  stddev %.1f  jitter %.1f\n", p50, p90, p99, max, mean, stddev, jitter);
+  printf("stalls > %.0f ms: %d (%.0f ms total)\n", o.stall_ms, stalls, stall_time);
+  if (negative) {
+    printf("warning: %d frame(s) with negative latency: X-Timestamp is not on the /clock uptime clock, or the sync is off\n", negative);
+  }
+
+  if (!o.summary.empty()) {
+    FILE *fp = fopen(o.summary.c_str(), "r");
+    bool fresh = !fp;
+    if (fp) fclose(fp);
+    fp = fopen(o.summary.c_str(), "a");
+    if (fp) {
+      if (fresh) {
+        fprintf(fp, "time,label,host,path,frames,fps,p50_ms,p90_ms,p99_ms,max_ms,mean_ms,stddev_ms,jitter_ms,stalls,stall_ms,sync_err_ms,drift_ppm\n");
+      }
+      char when[32];
+      time_t now = time(nullptr);
+      strftime(when, sizeof(when), "%Y-%m-%dT%H:%M:%S", localtime(&now));
+      fprintf(fp, "%s,%s,%s,%s,%zu,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%d,%.0f,%.2f,%.1f\n", when, o.label.c_str(), o.host.c_str(), o.path.c_str(), n,
+              fps, p50, p90, p99, max, mean, stddev, jitter, stalls, stall_time, rtt_max * 500, drift_ppm);
+      fclose(fp);
+    }
+  }
+  return 0;
+}
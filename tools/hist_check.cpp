@@ -0,0 +1,194 @@
+// Cek histogram telemetri /metrics (BoboBee Stream/5_3/stream_hist.cpp) di host.
+//
+// Dicek: batas bucket inklusif (le), bucket +Inf, sum, kuantil yang
+// diinterpolasi seperti histogram_quantile(), format eksposisi Prometheus
+// (bucket kumulatif naik, +Inf == _count, skala us -> detik), buffer yang
+// terlalu kecil, bounds yang tidak naik, dan observe dari banyak thread
+// sekaligus (tidak ada hitungan yang hilang). Terakhir: ns per observe.
+//
+// Build:  g++ -O2 -std=c++17 -pthread -I"../BoboBee Stream/5_3" hist_check.cpp "../BoboBee Stream/5_3/stream_hist.cpp" -o hist_check
+// Contoh: ./hist_check
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "stream_hist.h"
+
+static int _failed = 0;
+
+#define CHECK(cond)                                                  \
+  do {                                                               \
+    if (!(cond)) {                                                   \
+      fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+      _failed++;                                                     \
+    }                                                                \
+  } while (0)
+
+static double now_seconds() {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static void check_buckets() {
+  hist_t h;
+  CHECK(hist_init(&h, HIST_LATENCY_US, HIST_LATENCY_US_COUNT));
+  CHECK(hist_bucket(&h, 0) == 0);
+  CHECK(hist_bucket(&h, 100) == 0);  // le inklusif
+  CHECK(hist_bucket(&h, 101) == 1);
+  CHECK(hist_bucket(&h, 2500000) == HIST_LATENCY_US_COUNT - 1);
+  CHECK(hist_bucket(&h, 2500001) == HIST_LATENCY_US_COUNT);
+  CHECK(hist_bucket(&h, UINT32_MAX) == HIST_LATENCY_US_COUNT);
+  for (int i = 0; i < HIST_LATENCY_US_COUNT; i++) {
+    CHECK(hist_bucket(&h, HIST_LATENCY_US[i]) == i);
+    CHECK(hist_bucket(&h, HIST_LATENCY_US[i] + 1) == i + 1);
+  }
+
+  hist_observe(&h, 50);
+  hist_observe(&h, 100);
+  hist_observe(&h, 3000);
+  hist_observe(&h, 9000000);
+  hist_t s;
+  hist_snapshot(&h, &s);
+  CHECK(s.counts[0] == 2);
+  CHECK(s.counts[hist_bucket(&h, 3000)] == 1);
+  CHECK(s.counts[HIST_LATENCY_US_COUNT] == 1);
+  CHECK(hist_count(&s) == 4);
+  CHECK(s.sum == 50 + 100 + 3000 + 9000000ull);
+
+  static const uint32_t bad[] = {10, 10, 20};
+  CHECK(!hist_init(&h, bad, 3));
+  static uint32_t many[HIST_MAX_BUCKETS + 1];
+  for (int i = 0; i <= HIST_MAX_BUCKETS; i++) many[i] = i + 1;
+  CHECK(!hist_init(&h, many, HIST_MAX_BUCKETS + 1));
+  CHECK(hist_init(&h, many, HIST_MAX_BUCKETS));
+}
+
+static void check_quantile() {
+  static const uint32_t b[] = {10, 20, 40};
+  hist_t h;
+  hist_init(&h, b, 3);
+  hist_t s;
+  hist_snapshot(&h, &s);
+  CHECK(hist_quantile(&s, 0.5) == 0);  // kosong
+
+  for (int i = 0; i < 10; i++) hist_observe(&h, 5);    // (0,10]
+  for (int i = 0; i < 10; i++) hist_observe(&h, 15);   // (10,20]
+  for (int i = 0; i < 20; i++) hist_observe(&h, 30);   // (20,40]
+  hist_snapshot(&h, &s);
+  CHECK(std::fabs(hist_quantile(&s, 0.25) - 10) < 1e-9);  // rank 10 = ujung bucket 0
+  CHECK(std::fabs(hist_quantile(&s, 0.375) - 15) < 1e-9);
+  CHECK(std::fabs(hist_quantile(&s, 0.75) - 30) < 1e-9);
+  CHECK(std::fabs(hist_quantile(&s, 1.0) - 40) < 1e-9);
+  CHECK(hist_quantile(&s, 2.0) == hist_quantile(&s, 1.0));
+
+  hist_observe(&h, 1000);  // +Inf
+  for (int i = 0; i < 100; i++) hist_observe(&h, 1000);
+  hist_snapshot(&h, &s);
+  CHECK(hist_quantile(&s, 0.99) == 40);  // +Inf dilaporkan sebagai batas terakhir
+}
+
+// Parse output Prometheus: bucket kumulatif naik, +Inf == _count.
+static void check_prom() {
+  hist_t h;
+  hist_init(&h, HIST_LATENCY_US, HIST_LATENCY_US_COUNT);
+  uint32_t values[] = {80, 120, 120, 900, 4000, 70000, 3000000};
+  uint64_t sum = 0;
+  for (uint32_t v : values) {
+    hist_observe(&h, v);
+    sum += v;
+  }
+  char buf[4096];
+  int n = hist_print_prom(buf, sizeof(buf), "bobobee_stage_seconds", "stage=\"send\"", &h, 1e-6);
+  CHECK(n > 0 && (size_t)n == strlen(buf));
+
+  unsigned prev = 0, inf = 0, count = 0, lines = 0;
+  double sum_s = -1;
+  for (char *line = strtok(buf, "\n"); line; line = strtok(nullptr, "\n")) {
+    lines++;
+    char le[32];
+    unsigned c;
+    if (sscanf(line, "bobobee_stage_seconds_bucket{stage=\"send\",le=\"%31[^\"]\"} %u", le, &c) == 2) {
+      CHECK(c >= prev);
+      prev = c;
+      if (!strcmp(le, "+Inf")) inf = c;
+      if (!strcmp(le, "0.0001")) CHECK(c == 1);
+      if (!strcmp(le, "0.00025")) CHECK(c == 3);
+    } else if (sscanf(line, "bobobee_stage_seconds_sum{stage=\"send\"} %lf", &sum_s) == 1) {
+    } else if (sscanf(line, "bobobee_stage_seconds_count{stage=\"send\"} %u", &count) == 1) {
+    } else {
+      fprintf(stderr, "unexpected line: %s\n", line);
+      _failed++;
+    }
+  }
+  CHECK(lines == HIST_LATENCY_US_COUNT + 3);
+  CHECK(inf == 7 && count == 7);
+  CHECK(std::fabs(sum_s - sum * 1e-6) < 1e-9);
+
+  // tanpa label: name_bucket{le=...} dan name_sum tanpa kurung kurawal
+  hist_t f;
+  hist_init(&f, HIST_FRAME_BYTES, HIST_FRAME_BYTES_COUNT);
+  hist_observe(&f, 12000);
+  n = hist_print_prom(buf, sizeof(buf), "bobobee_frame_bytes", nullptr, &f, 1);
+  CHECK(strstr(buf, "bobobee_frame_bytes_bucket{le=\"16384\"} 1\n") != nullptr);
+  CHECK(strstr(buf, "bobobee_frame_bytes_bucket{le=\"8192\"} 0\n") != nullptr);
+  CHECK(strstr(buf, "bobobee_frame_bytes_sum 12000\n") != nullptr);
+  CHECK(strstr(buf, "bobobee_frame_bytes_count 1\n") != nullptr);
+
+  // buffer kurang: -1, bukan output terpotong
+  for (size_t cap = 0; cap < (size_t)n; cap += 7) {
+    CHECK(hist_print_prom(buf, cap ? cap : 1, "bobobee_frame_bytes", nullptr, &f, 1) == -1);
+  }
+  CHECK(hist_print_prom(buf, n + 1, "bobobee_frame_bytes", nullptr, &f, 1) == n);
+}
+
+static void check_threads() {
+  static hist_t h;
+  hist_init(&h, HIST_LATENCY_US, HIST_LATENCY_US_COUNT);
+  const int threads = 4, per = 250000;
+  std::vector<std::thread> ts;
+  for (int t = 0; t < threads; t++) {
+    ts.emplace_back([t] {
+      uint32_t x = 1234567 + t;
+      for (int i = 0; i < per; i++) {
+        x = x * 1103515245u + 12345u;
+        hist_observe(&h, (x >> 8) % 3000000);
+      }
+    });
+  }
+  for (auto &t : ts) t.join();
+  hist_t s;
+  hist_snapshot(&h, &s);
+  CHECK(hist_count(&s) == (uint32_t)(threads * per));
+}
+
+static void bench() {
+  static hist_t h;
+  hist_init(&h, HIST_LATENCY_US, HIST_LATENCY_US_COUNT);
+  const int iters = 20000000;
+  uint32_t x = 1;
+  double t0 = now_seconds();
+  for (int i = 0; i < iters; i++) {
+    x = x * 1103515245u + 12345u;
+    hist_observe(&h, (x >> 8) % 3000000);
+  }
+  double dt = now_seconds() - t0;
+  printf("hist_observe: %.1f ns/call (host)\n", dt / iters * 1e9);
+}
+
+int main() {
+  check_buckets();
+  check_quantile();
+  check_prom();
+  check_threads();
+  if (_failed) {
+    printf("%d check(s) FAILED\n", _failed);
+    return 1;
+  }
+  printf("all histogram checks passed\n");
+  bench();
+  return 0;
+}
@@ -0,0 +1,620 @@
+// Load generator / soak test untuk 5_3.ino: N penonton /stream + M klien
+// audio WebSocket + K klien video WebSocket bersamaan, terhadap perangkat
+// atau build simulator (sim/).
+//
+// Klien audio meniru EspWsAudioClient.ts: setelah connect mengirim
+//   {"action":"subscribe","stream":"audio","format":"pcm16","sampleRate":16000,"header":true}
+// lalu menghitung sampel dari pesan biner ("beat" dan teks lain diabaikan).
+// --audio-format adpcm meminta IMA-ADPCM (5_3/audio_codec.h); tiap pesan
+// didecode supaya data yang rusak terhitung sebagai error.
+// Pesan ber-header audio_header_t (5_3/audio_frame.h) dihitung dari field
+// samples dan seq-nya memberi blok yang hilang dan jitter; firmware lama
+// tanpa header dihitung sebagai PCM16 polos. Klien video WS mengirim
+//   {"action":"subscribe","stream":"video","fps":F,"quality":Q}
+// lalu menerima pesan biner ws_video_header_t + JPEG (5_3/ws_session.h).
+// Semua klien reconnect sendiri dengan backoff 1 s .. 5 s seperti
+// klien web; setiap reconnect dihitung.
+//
+// Dicatat per klien per --interval: fps dan KB/s penonton, stall terpanjang
+// (jarak antar frame), frame yang dibuang server untuk klien video WS
+// (kolom gaps), laju sampel audio terhadap --rate, gap audio (jarak
+// antar pesan > durasi pesan sebelumnya + --gap-ms) dan gap terpanjang.
+// Thread probe mengambil /metrics tiap --probe detik: heap internal/PSRAM
+// (free, minimum, blok terbesar), RTT probe sebagai latensi HTTP di bawah
+// beban, dan reboot (bobobee_uptime_seconds mundur).
+//
+// Build:  g++ -O2 -std=c++17 -pthread -I"../BoboBee Stream/5_3" load_gen.cpp mjpeg_client.cpp ws_client.cpp "../BoboBee Stream/5_3/audio_frame.cpp" "../BoboBee Stream/5_3/audio_codec.cpp" -o load_gen
+// Contoh: ./load_gen 192.168.1.50 --viewers 3 --audio 2 --seconds 3600 --csv soak.csv
+//         ./load_gen 127.0.0.1 --port 8080 --ws-port 8081 --viewers 4 --audio 4 --seconds 60
+//         ./load_gen 192.168.1.50 --viewers 0 --audio 1 --ws-video 2 --ws-fps 10 --ws-quality 15
+//         ./load_gen 192.168.1.50 --viewers 2 --audio 4 --audio-format adpcm
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "audio_codec.h"
+#include "audio_frame.h"
+#include "mjpeg_client.h"
+#include "ws_client.h"
+
+struct Options {
+  std::string host;
+  int port = 80;
+  std::string path = "/stream";
+  int ws_port = 81;
+  std::string ws_path = "/";
+  int viewers = 1;
+  int audio = 1;
+  int ws_video = 0;
+  int ws_fps = 0;      // 0 = ikut kamera
+  int ws_quality = 0;  // 0 = tidak meminta
+  int seconds = 0;  // 0 = sampai Ctrl-C
+  int interval = 10;
+  int rate = 16000;
+  std::string audio_format = "pcm16";
+  double gap_ms = 100;
+  double probe = 5;  // 0 = tanpa /metrics
+  std::string metrics_path = "/metrics";
+  int ramp_ms = 250;  // jeda antar klien saat start
+  int timeout_ms = 5000;
+  std::string csv;
+};
+
+static std::atomic<bool> g_stop{false};
+
+static void on_signal(int) {
+  g_stop = true;
+}
+
+// Counter ditulis thread klien, dibaca (dan max_* di-reset) oleh reporter.
+struct Counters {
+  std::atomic<uint64_t> units{0};  // frame atau sampel
+  std::atomic<uint64_t> bytes{0};
+  std::atomic<uint64_t> gaps{0};
+  std::atomic<uint64_t> lost{0};        // audio: blok yang dilewati seq
+  std::atomic<uint32_t> jitter_us{0};   // audio: jitter RFC 3550 terakhir
+  std::atomic<uint64_t> reconnects{0};
+  std::atomic<uint32_t> max_gap_us{0};  // sejak report terakhir
+  std::atomic<bool> up{false};
+  std::mutex mu;
+  std::string last_error;
+};
+
+enum Kind { kViewer, kAudio, kWsVideo, kKinds };
+static const char *const kKindNames[kKinds] = {"video", "audio", "wsvideo"};
+
+struct Client {
+  Kind kind;
+  int id;
+  Counters c;
+  std::thread thread;
+  // total run, hanya dipakai reporter
+  uint64_t prev_units = 0, prev_bytes = 0, prev_gaps = 0, prev_lost = 0;
+  uint32_t worst_gap_us = 0;
+  double min_rate = -1;
+};
+
+struct DeviceSample {
+  bool ok = false;
+  double rtt_ms = 0;
+  double uptime = -1;
+  double heap[2] = {-1, -1};  // internal, psram
+  double heap_min[2] = {-1, -1};
+  double largest[2] = {-1, -1};
+};
+
+struct Device {
+  std::mutex mu;
+  DeviceSample last;
+  std::vector<double> rtt_ms;  // sejak report terakhir
+  std::vector<double> all_rtt_ms;
+  uint64_t probes = 0, failures = 0, reboots = 0;
+  double min_heap[2] = {-1, -1};
+  double min_largest[2] = {-1, -1};
+};
+
+static void max_into(std::atomic<uint32_t> &a, uint32_t v) {
+  uint32_t cur = a.load(std::memory_order_relaxed);
+  while (v > cur && !a.compare_exchange_weak(cur, v, std::memory_order_relaxed)) {
+  }
+}
+
+static void set_error(Counters &c, const std::string &e) {
+  std::lock_guard<std::mutex> lock(c.mu);
+  c.last_error = e;
+}
+
+// Backoff seperti EspWsAudioClient.ts: 1 s * 2^attempt, maks 5 s.
+static void backoff(int attempt) {
+  int ms = std::min(5000, 1000 << std::min(attempt, 3));
+  for (int waited = 0; waited < ms && !g_stop; waited += 50) usleep(50 * 1000);
+}
+
+static void viewer_loop(const Options &o, Client *cl) {
+  Counters &c = cl->c;
+  mjpeg::FramePool pool(2, 64 * 1024);
+  int attempt = 0;
+  bool first = true;
+  while (!g_stop) {
+    if (!first) {
+      c.reconnects++;
+      backoff(attempt++);
+      if (g_stop) break;
+    }
+    first = false;
+    double prev = -1;
+    mjpeg::StreamParser parser(pool, [&](const mjpeg::Frame &f) {
+      c.units++;
+      c.bytes += f.len;
+      if (prev >= 0) max_into(c.max_gap_us, (uint32_t)std::min(4e9, (f.host_ts - prev) * 1e6));
+      prev = f.host_ts;
+      attempt = 0;
+      return false;
+    });
+    mjpeg::Client client;
+    if (!client.open(o.host, o.port, o.path, o.timeout_ms)) {
+      set_error(c, client.error());
+      continue;
+    }
+    c.up = true;
+    bool ok = client.run(parser, &g_stop);
+    c.up = false;
+    if (!g_stop) set_error(c, ok ? "stream closed" : client.error());
+  }
+}
+
+static void audio_loop(const Options &o, Client *cl) {
+  Counters &c = cl->c;
+  char sub[160];
+  snprintf(sub, sizeof(sub), "{\"action\":\"subscribe\",\"stream\":\"audio\",\"format\":\"%s\",\"sampleRate\":%d,\"header\":true}",
+           o.audio_format.c_str(), o.rate);
+  std::vector<int16_t> pcm;
+  int attempt = 0;
+  bool first = true;
+  while (!g_stop) {
+    if (!first) {
+      c.reconnects++;
+      backoff(attempt++);
+      if (g_stop) break;
+    }
+    first = false;
+    ws::Client ws;
+    if (!ws.open(o.host, o.ws_port, o.ws_path, o.timeout_ms) || !ws.send_text(sub)) {
+      set_error(c, ws.error());
+      continue;
+    }
+    c.up = true;
+    double prev = -1, prev_dur = 0;
+    audio_rx_t rx;
+    audio_rx_init(&rx);
+    ws::Message m;
+    while (ws.read(&m, &g_stop)) {
+      if (m.opcode != ws::kBinary || m.len < 2) continue;
+      audio_frame_t f;
+      int res = audio_frame_parse(m.data, m.len, &f);
+      size_t samples = m.len / 2;
+      if (res == AUDIO_FRAME_OK) {
+        samples = f.samples;
+        c.lost += audio_rx_update(&rx, &f, (int64_t)(m.host_ts * 1e6));
+        c.jitter_us = (uint32_t)rx.jitter_us;
+        const audio_codec_t *codec = audio_codec_get(f.codec);
+        audio_codec_state_t st;
+        pcm.resize(f.samples);
+        if (codec) codec->reset(&st);
+        if (!codec || codec->decode(&st, f.data, f.data_len, pcm.data(), f.samples) != f.samples) {
+          set_error(c, "bad audio data (codec " + std::to_string(f.codec) + ")");
+          continue;
+        }
+      } else if (res != AUDIO_FRAME_BAD_MAGIC) {
+        set_error(c, "bad audio header (" + std::to_string(res) + ")");
+        continue;
+      }
+      c.units += samples;
+      c.bytes += m.len;
+      if (prev >= 0) {
+        double dt = m.host_ts - prev;
+        max_into(c.max_gap_us, (uint32_t)std::min(4e9, dt * 1e6));
+        if (dt > prev_dur + o.gap_ms / 1000) c.gaps++;
+      }
+      prev = m.host_ts;
+      prev_dur = (double)samples / o.rate;
+      attempt = 0;
+    }
+    c.up = false;
+    if (!g_stop) set_error(c, ws.error());
+  }
+}
+
+// Header pesan video WS (ws_video_header_t di 5_3/ws_session.h), little-endian.
+struct VideoHeader {
+  uint16_t header_len, width, height;
+  uint32_t seq, dropped;
+  int64_t timestamp_us;
+};
+
+template <typename T>
+static T le(const uint8_t *p) {
+  T v = 0;
+  for (size_t i = 0; i < sizeof(T); i++) v |= (T)p[i] << (8 * i);
+  return v;
+}
+
+static bool parse_video_header(const uint8_t *p, size_t len, VideoHeader *h) {
+  if (len < 28 || memcmp(p, "VID1", 4) != 0) return false;
+  h->header_len = le<uint16_t>(p + 4);
+  h->width = le<uint16_t>(p + 8);
+  h->height = le<uint16_t>(p + 10);
+  h->seq = le<uint32_t>(p + 12);
+  h->dropped = le<uint32_t>(p + 16);
+  h->timestamp_us = le<int64_t>(p + 20);
+  return h->header_len >= 28 && h->header_len <= len;
+}
+
+static void ws_video_loop(const Options &o, Client *cl) {
+  Counters &c = cl->c;
+  char sub[128];
+  snprintf(sub, sizeof(sub), "{\"action\":\"subscribe\",\"stream\":\"video\",\"fps\":%d,\"quality\":%d}", o.ws_fps, o.ws_quality);
+  int attempt = 0;
+  bool first = true;
+  while (!g_stop) {
+    if (!first) {
+      c.reconnects++;
+      backoff(attempt++);
+      if (g_stop) break;
+    }
+    first = false;
+    ws::Client ws;
+    if (!ws.open(o.host, o.ws_port, o.ws_path, o.timeout_ms) || !ws.send_text(sub)) {
+      set_error(c, ws.error());
+      continue;
+    }
+    c.up = true;
+    double prev = -1;
+    int64_t prev_dropped = -1;
+    ws::Message m;
+    while (ws.read(&m, &g_stop)) {
+      if (m.opcode == ws::kText) {
+        // balasan kontrol membawa "error" kalau subscribe ditolak (mis. video busy)
+        std::string t((const char *)m.data, m.len);
+        if (t.find("\"error\"") != std::string::npos) set_error(c, t);
+        continue;
+      }
+      VideoHeader h;
+      if (m.opcode != ws::kBinary || !parse_video_header(m.data, m.len, &h)) {
+        set_error(c, "bad video message");
+        continue;
+      }
+      c.units++;
+      c.bytes += m.len - h.header_len;
+      if (prev_dropped >= 0 && h.dropped > prev_dropped) c.gaps += h.dropped - prev_dropped;
+      prev_dropped = h.dropped;
+      if (prev >= 0) max_into(c.max_gap_us, (uint32_t)std::min(4e9, (m.host_ts - prev) * 1e6));
+      prev = m.host_ts;
+      attempt = 0;
+    }
+    c.up = false;
+    if (!g_stop) set_error(c, ws.error());
+  }
+}
+
+// ---------- /metrics ----------
+static int tcp_connect(const std::string &host, int port, int timeout_ms) {
+  addrinfo hints{}, *res = nullptr;
+  hints.ai_family = AF_INET;
+  hints.ai_socktype = SOCK_STREAM;
+  if (getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &res) != 0) return -1;
+  int fd = socket(res->ai_family, res->ai_socktype, res->ai_protocol);
+  if (fd >= 0) {
+    timeval tv{timeout_ms / 1000, (timeout_ms % 1000) * 1000};
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    if (connect(fd, res->ai_addr, res->ai_addrlen) != 0) {
+      close(fd);
+      fd = -1;
+    }
+  }
+  freeaddrinfo(res);
+  return fd;
+}
+
+// Nilai sampel Prometheus "name{labels} value"; -1 kalau tidak ada.
+static double prom_value(const std::string &body, const std::string &series) {
+  size_t pos = 0;
+  while ((pos = body.find(series, pos)) != std::string::npos) {
+    bool line_start = pos == 0 || body[pos - 1] == '\n';
+    size_t after = pos + series.size();
+    if (line_start && after < body.size() && body[after] == ' ') return strtod(body.c_str() + after + 1, nullptr);
+    pos = after;
+  }
+  return -1;
+}
+
+static DeviceSample probe_metrics(const Options &o) {
+  DeviceSample s;
+  double t0 = mjpeg::now_seconds();
+  int fd = tcp_connect(o.host, o.port, o.timeout_ms);
+  if (fd < 0) return s;
+  std::string req = "GET " + o.metrics_path + " HTTP/1.1\r\nHost: " + o.host + "\r\nConnection: close\r\n\r\n";
+  std::string resp;
+  if (send(fd, req.data(), req.size(), MSG_NOSIGNAL) == (ssize_t)req.size()) {
+    // esp_http_server tidak menutup socket setelah response: baca sampai Content-Length
+    char buf[4096];
+    ssize_t n;
+    size_t want = std::string::npos;
+    while (resp.size() < want && (n = recv(fd, buf, sizeof(buf), 0)) > 0) {
+      resp.append(buf, n);
+      size_t head = resp.find("\r\n\r\n");
+      if (want == std::string::npos && head != std::string::npos) {
+        const char *cl = strcasestr(resp.c_str(), "\r\nContent-Length:");
+        if (cl && cl < resp.c_str() + head) want = head + 4 + strtoul(cl + 17, nullptr, 10);
+      }
+    }
+  }
+  close(fd);
+  if (resp.compare(0, 12, "HTTP/1.1 200") != 0) return s;
+  // RTT termasuk connect: yang dirasakan dashboard saat perangkat sibuk
+  s.rtt_ms = (mjpeg::now_seconds() - t0) * 1000;
+  s.ok = true;
+  s.uptime = prom_value(resp, "bobobee_uptime_seconds");
+  static const char *const regions[2] = {"internal", "psram"};
+  for (int i = 0; i < 2; i++) {
+    std::string l = std::string("{region=\"") + regions[i] + "\"}";
+    s.heap[i] = prom_value(resp, "bobobee_heap_free_bytes" + l);
+    s.heap_min[i] = prom_value(resp, "bobobee_heap_min_free_bytes" + l);
+    s.largest[i] = prom_value(resp, "bobobee_heap_largest_block_bytes" + l);
+  }
+  return s;
+}
+
+static void probe_loop(const Options &o, Device *d) {
+  double next = mjpeg::now_seconds();
+  while (!g_stop) {
+    double now = mjpeg::now_seconds();
+    if (now < next) {
+      usleep(50 * 1000);
+      continue;
+    }
+    next = now + o.probe;
+    DeviceSample s = probe_metrics(o);
+    std::lock_guard<std::mutex> lock(d->mu);
+    d->probes++;
+    if (!s.ok) {
+      d->failures++;
+      continue;
+    }
+    if (d->last.ok && s.uptime >= 0 && s.uptime < d->last.uptime) d->reboots++;
+    for (int i = 0; i < 2; i++) {
+      if (s.heap[i] >= 0 && (d->min_heap[i] < 0 || s.heap[i] < d->min_heap[i])) d->min_heap[i] = s.heap[i];
+      if (s.largest[i] >= 0 && (d->min_largest[i] < 0 || s.largest[i] < d->min_largest[i])) d->min_largest[i] = s.largest[i];
+    }
+    d->rtt_ms.push_back(s.rtt_ms);
+    d->all_rtt_ms.push_back(s.rtt_ms);
+    d->last = s;
+  }
+}
+
+static double percentile(std::vector<double> v, double p) {
+  if (v.empty()) return 0;
+  std::sort(v.begin(), v.end());
+  size_t idx = (size_t)std::min<double>(v.size() - 1, p / 100.0 * (v.size() - 1) + 0.5);
+  return v[idx];
+}
+
+// ---------- Laporan ----------
+static void report(const Options &o, std::vector<std::unique_ptr<Client>> &clients, Device &dev, double elapsed, double dt, FILE *csv) {
+  int up[kKinds] = {}, total[kKinds] = {};
+  double min_rate[kKinds] = {-1, -1, -1}, sum_rate[kKinds] = {}, kbs[kKinds] = {};
+  uint64_t gaps[kKinds] = {}, lost = 0, reconnects = 0;
+  uint32_t worst[kKinds] = {}, jitter_us = 0;
+  for (auto &cl : clients) {
+    int k = cl->kind;
+    Counters &c = cl->c;
+    uint64_t units = c.units, bytes = c.bytes, g = c.gaps;
+    uint32_t gap_us = c.max_gap_us.exchange(0);
+    double rate = dt > 0 ? (units - cl->prev_units) / dt : 0;
+    double kb = dt > 0 ? (bytes - cl->prev_bytes) / dt / 1024 : 0;
+    bool is_up = c.up;
+    total[k]++;
+    up[k] += is_up;
+    sum_rate[k] += rate;
+    kbs[k] += kb;
+    if (min_rate[k] < 0 || rate < min_rate[k]) min_rate[k] = rate;
+    if (cl->min_rate < 0 || rate < cl->min_rate) cl->min_rate = rate;
+    worst[k] = std::max(worst[k], gap_us);
+    cl->worst_gap_us = std::max(cl->worst_gap_us, gap_us);
+    gaps[k] += g - cl->prev_gaps;
+    uint64_t l = c.lost, dl = l - cl->prev_lost;
+    lost += dl;
+    cl->prev_lost = l;
+    if (k == kAudio) jitter_us = std::max(jitter_us, c.jitter_us.load());
+    reconnects += c.reconnects;
+    if (csv) {
+      fprintf(csv, "%.1f,%s,%d,%d,%.2f,%.1f,%llu,%llu,%.1f,%llu,,,,,\n", elapsed, kKindNames[cl->kind], cl->id, is_up ? 1 : 0, rate,
+              kb, (unsigned long long)(g - cl->prev_gaps), (unsigned long long)dl, gap_us / 1e3, (unsigned long long)c.reconnects.load());
+    }
+    cl->prev_units = units;
+    cl->prev_bytes = bytes;
+    cl->prev_gaps = g;
+  }
+  printf("%7.0fs", elapsed);
+  if (total[kViewer]) {
+    printf("  video %d/%d fps min %5.1f avg %5.1f %7.1f KB/s stall %5.0f ms", up[kViewer], total[kViewer],
+           std::max(0.0, min_rate[kViewer]), sum_rate[kViewer] / total[kViewer], kbs[kViewer], worst[kViewer] / 1e3);
+  }
+  if (total[kAudio]) {
+    printf("  | audio %d/%d %5.0f/%d sps min gaps %llu lost %llu max %5.0f ms jitter %4.1f ms", up[kAudio], total[kAudio],
+           std::max(0.0, min_rate[kAudio]), o.rate, (unsigned long long)gaps[kAudio], (unsigned long long)lost, worst[kAudio] / 1e3,
+           jitter_us / 1e3);
+  }
+  if (total[kWsVideo]) {
+    printf("  | wsvideo %d/%d fps min %5.1f avg %5.1f %7.1f KB/s stall %5.0f ms dropped %llu", up[kWsVideo], total[kWsVideo],
+           std::max(0.0, min_rate[kWsVideo]), sum_rate[kWsVideo] / total[kWsVideo], kbs[kWsVideo], worst[kWsVideo] / 1e3,
+           (unsigned long long)gaps[kWsVideo]);
+  }
+  printf("  | reconnects %llu", (unsigned long long)reconnects);
+  if (o.probe > 0) {
+    std::lock_guard<std::mutex> lock(dev.mu);
+    const DeviceSample &s = dev.last;
+    if (s.ok && s.heap[0] >= 0) {
+      printf("  | heap %.0f KB (min %.0f, blk %.0f) psram %.0f KB", s.heap[0] / 1024, s.heap_min[0] / 1024, s.largest[0] / 1024,
+             s.heap[1] / 1024);
+    }
+    printf("  probe p50 %.0f max %.0f ms fail %llu reboots %llu", percentile(dev.rtt_ms, 50),
+           dev.rtt_ms.empty() ? 0.0 : *std::max_element(dev.rtt_ms.begin(), dev.rtt_ms.end()), (unsigned long long)dev.failures,
+           (unsigned long long)dev.reboots);
+    if (csv) {
+      fprintf(csv, "%.1f,device,0,%d,,,,,,,%.0f,%.0f,%.0f,%.0f,%.1f\n", elapsed, s.ok ? 1 : 0, s.heap[0], s.heap_min[0], s.largest[0],
+              s.heap[1], percentile(dev.rtt_ms, 50));
+    }
+    dev.rtt_ms.clear();
+  }
+  printf("\n");
+  fflush(stdout);
+  if (csv) fflush(csv);
+}
+
+static void summary(const Options &o, std::vector<std::unique_ptr<Client>> &clients, Device &dev, double elapsed) {
+  printf("\nsummary after %.0f s\n", elapsed);
+  printf("%-7s %3s %10s %9s %9s %6s %6s %10s %10s  %s\n", "client", "id", "units", "avg/s", "min/s", "gaps", "lost", "worst_ms",
+         "reconnects", "last error");
+  for (auto &cl : clients) {
+    Counters &c = cl->c;
+    std::string err;
+    {
+      std::lock_guard<std::mutex> lock(c.mu);
+      err = c.last_error;
+    }
+    uint32_t worst = std::max(cl->worst_gap_us, c.max_gap_us.load());
+    printf("%-7s %3d %10llu %9.1f %9.1f %6llu %6llu %10.0f %10llu  %s\n", kKindNames[cl->kind], cl->id,
+           (unsigned long long)c.units.load(), elapsed > 0 ? c.units / elapsed : 0.0, std::max(0.0, cl->min_rate),
+           (unsigned long long)c.gaps.load(), (unsigned long long)c.lost.load(), worst / 1e3, (unsigned long long)c.reconnects.load(),
+           err.c_str());
+  }
+  if (o.probe > 0) {
+    std::lock_guard<std::mutex> lock(dev.mu);
+    printf("device: probes %llu failed %llu reboots %llu, probe p50 %.0f p99 %.0f ms\n", (unsigned long long)dev.probes,
+           (unsigned long long)dev.failures, (unsigned long long)dev.reboots, percentile(dev.all_rtt_ms, 50),
+           percentile(dev.all_rtt_ms, 99));
+    if (dev.min_heap[0] >= 0) {
+      printf("        lowest free heap internal %.0f KB (largest block %.0f KB), psram %.0f KB (largest block %.0f KB)\n",
+             dev.min_heap[0] / 1024, dev.min_largest[0] / 1024, dev.min_heap[1] / 1024, dev.min_largest[1] / 1024);
+    }
+  }
+}
+
+int main(int argc, char **argv) {
+  Options o;
+  if (argc < 2) {
+    fprintf(stderr,
+            "usage: %s HOST [--port 80] [--path /stream] [--ws-port 81] [--ws-path /]\n"
+            "          [--viewers 1] [--audio 1] [--ws-video 0] [--ws-fps 0] [--ws-quality 0]\n"
+            "          [--seconds 0] [--interval 10] [--rate 16000] [--audio-format pcm16|adpcm]\n"
+            "          [--gap-ms 100] [--probe 5] [--metrics-path /metrics] [--ramp-ms 250]\n"
+            "          [--timeout-ms 5000] [--csv FILE]\n",
+            argv[0]);
+    return 2;
+  }
+  o.host = argv[1];
+  for (int i = 2; i + 1 < argc; i += 2) {
+    std::string k = argv[i];
+    const char *v = argv[i + 1];
+    if (k == "--port") o.port = atoi(v);
+    else if (k == "--path") o.path = v;
+    else if (k == "--ws-port") o.ws_port = atoi(v);
+    else if (k == "--ws-path") o.ws_path = v;
+    else if (k == "--viewers") o.viewers = atoi(v);
+    else if (k == "--audio") o.audio = atoi(v);
+    else if (k == "--ws-video") o.ws_video = atoi(v);
+    else if (k == "--ws-fps") o.ws_fps = atoi(v);
+    else if (k == "--ws-quality") o.ws_quality = atoi(v);
+    else if (k == "--seconds") o.seconds = atoi(v);
+    else if (k == "--interval") o.interval = atoi(v) > 0 ? atoi(v) : 1;
+    else if (k == "--rate") o.rate = atoi(v) > 0 ? atoi(v) : 16000;
+    else if (k == "--audio-format") o.audio_format = v;
+    else if (k == "--gap-ms") o.gap_ms = atof(v);
+    else if (k == "--probe") o.probe = atof(v);
+    else if (k == "--metrics-path") o.metrics_path = v;
+    else if (k == "--ramp-ms") o.ramp_ms = atoi(v);
+    else if (k == "--timeout-ms") o.timeout_ms = atoi(v);
+    else if (k == "--csv") o.csv = v;
+    else {
+      fprintf(stderr, "unknown option %s\n", k.c_str());
+      return 2;
+    }
+  }
+  if (!audio_codec_find(o.audio_format.c_str())) {
+    fprintf(stderr, "unknown --audio-format %s\n", o.audio_format.c_str());
+    return 2;
+  }
+  signal(SIGINT, on_signal);
+  signal(SIGTERM, on_signal);
+
+  FILE *csv = nullptr;
+  if (!o.csv.empty()) {
+    csv = fopen(o.csv.c_str(), "w");
+    if (!csv) {
+      perror(o.csv.c_str());
+      return 1;
+    }
+    fprintf(csv, "t_s,kind,id,up,rate,kb_s,gaps,lost,max_gap_ms,reconnects,heap_internal,heap_internal_min,largest_internal,heap_psram,probe_p50_ms\n");
+  }
+
+  std::vector<std::unique_ptr<Client>> clients;
+  const int counts[kKinds] = {o.viewers, o.audio, o.ws_video};
+  for (int k = 0; k < kKinds; k++) {
+    for (int i = 0; i < counts[k]; i++) {
+      clients.emplace_back(new Client{(Kind)k, i, {}, {}});
+    }
+  }
+  Device dev;
+  std::thread prober;
+  if (o.probe > 0) prober = std::thread(probe_loop, std::cref(o), &dev);
+
+  double t0 = mjpeg::now_seconds();
+  // jenis klien dinyalakan bergantian supaya beban naik bertahap
+  static void (*const loops[kKinds])(const Options &, Client *) = {viewer_loop, audio_loop, ws_video_loop};
+  for (int round = 0, started = 0; !g_stop && started < (int)clients.size(); round++) {
+    for (int k = 0, base = 0; k < kKinds && !g_stop; base += counts[k], k++) {
+      if (round >= counts[k]) continue;
+      Client *cl = clients[base + round].get();
+      cl->thread = std::thread(loops[k], std::cref(o), cl);
+      started++;
+      usleep(o.ramp_ms * 1000);
+    }
+  }
+
+  double last = mjpeg::now_seconds();
+  while (!g_stop) {
+    usleep(100 * 1000);
+    double now = mjpeg::now_seconds();
+    if (o.seconds > 0 && now - t0 >= o.seconds) g_stop = true;
+    if (now - last >= o.interval || g_stop) {
+      report(o, clients, dev, now - t0, now - last, csv);
+      last = now;
+    }
+  }
+  for (auto &cl : clients) {
+    if (cl->thread.joinable()) cl->thread.join();
+  }
+  if (prober.joinable()) prober.join();
+  summary(o, clients, dev, mjpeg::now_seconds() - t0);
+  if (csv) fclose(csv);
+  return 0;
+}
@@ -0,0 +1,265 @@
+// Benchmark throughput parser MJPEG terhadap server tiruan lokal (loopback).
+//
+// Server meniru framing firmware (boundary + Content-Length + X-Timestamp)
+// dengan payload sintetis: byte acak dengan 0xFF selalu di-stuff (0xFF 0x00)
+// seperti data entropy JPEG, dan satu dari --thumb-every payload berisi
+// pasangan FFD8/FFD9 di tengah (thumbnail EXIF / segmen APP). Dibandingkan:
+//   lib    mjpeg_client: state machine, recv langsung ke buffer pool
+//   naive  cara ESP32-S3_ObjectDetect.py: buffer += chunk 1 KB lalu cari
+//          FFD8/FFD9 dari awal buffer di setiap chunk
+// Setiap frame dicek byte-per-byte terhadap payload yang dikirim.
+//
+// Build:  g++ -O2 -std=c++17 -pthread mjpeg_bench.cpp mjpeg_client.cpp -o mjpeg_bench
+// Contoh: ./mjpeg_bench --seconds 3
+//         ./mjpeg_bench --no-length      (part tanpa Content-Length)
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "mjpeg_client.h"
+
+struct Options {
+  double seconds = 3;
+  int payloads = 16;
+  int min_kb = 8;
+  int max_kb = 40;
+  int thumb_every = 4;  // 0 = tanpa thumbnail
+  bool content_length = true;
+  std::string mode = "both";
+};
+
+static const char *kBoundary = "123456789000000000000987654321";
+
+static std::vector<std::vector<uint8_t>> make_payloads(const Options &o) {
+  std::mt19937 rng(1234);
+  std::vector<std::vector<uint8_t>> out(o.payloads);
+  for (int i = 0; i < o.payloads; i++) {
+    size_t len = (o.min_kb + rng() % (o.max_kb - o.min_kb + 1)) * 1024;
+    auto &p = out[i];
+    p.resize(len);
+    for (size_t j = 0; j < len; j++) {
+      p[j] = rng() & 0xFF;
+      if (p[j] == 0xFF && j + 1 < len) p[++j] = 0x00;  // byte stuffing
+    }
+    p[0] = 0xFF;
+    p[1] = 0xD8;
+    if (o.thumb_every > 0 && i % o.thumb_every == 0) {
+      // "thumbnail" di dalam frame: SOI/EOI kedua
+      size_t t = len / 3;
+      p[t] = 0xFF;
+      p[t + 1] = 0xD8;
+      p[t + 200] = 0xFF;
+      p[t + 201] = 0xD9;
+    }
+    p[len - 3] = 0x00;
+    p[len - 2] = 0xFF;
+    p[len - 1] = 0xD9;
+  }
+  return out;
+}
+
+// Server tiruan: satu klien, kirim secepat mungkin sampai klien menutup.
+static int start_server(int *port) {
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  int one = 1;
+  setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  if (bind(fd, (sockaddr *)&addr, sizeof(addr)) != 0 || listen(fd, 4) != 0) {
+    close(fd);
+    return -1;
+  }
+  socklen_t len = sizeof(addr);
+  getsockname(fd, (sockaddr *)&addr, &len);
+  *port = ntohs(addr.sin_port);
+  return fd;
+}
+
+static void serve_one(int listen_fd, const Options &o, const std::vector<std::vector<uint8_t>> *payloads) {
+  int fd = accept(listen_fd, nullptr, nullptr);
+  if (fd < 0) return;
+  char req[1024];
+  recv(fd, req, sizeof(req), 0);
+  char head[256];
+  int n = snprintf(head, sizeof(head),
+                   "HTTP/1.1 200 OK\r\nContent-Type: multipart/x-mixed-replace;boundary=%s\r\nConnection: close\r\n\r\n", kBoundary);
+  send(fd, head, n, MSG_NOSIGNAL);
+  double t0 = mjpeg::now_seconds();
+  for (uint64_t i = 0;; i++) {
+    const auto &p = (*payloads)[i % payloads->size()];
+    double ts = t0 + i / 30.0;  // timestamp device 30 fps
+    char prefix[192];
+    int m;
+    if (o.content_length) {
+      m = snprintf(prefix, sizeof(prefix), "\r\n--%s\r\nContent-Type: image/jpeg\r\nContent-Length: %zu\r\nX-Timestamp: %.6f\r\n\r\n", kBoundary,
+                   p.size(), ts);
+    } else {
+      m = snprintf(prefix, sizeof(prefix), "\r\n--%s\r\nContent-Type: image/jpeg\r\nX-Timestamp: %.6f\r\n\r\n", kBoundary, ts);
+    }
+    iovec iov[2] = {{prefix, (size_t)m}, {(void *)p.data(), p.size()}};
+    msghdr msg{};
+    msg.msg_iov = iov;
+    msg.msg_iovlen = 2;
+    size_t total = m + p.size();
+    size_t sent = 0;
+    while (sent < total) {
+      ssize_t k = sendmsg(fd, &msg, MSG_NOSIGNAL);
+      if (k <= 0) {
+        close(fd);
+        return;
+      }
+      sent += k;
+      // majukan iovec untuk partial write
+      while (msg.msg_iovlen > 0 && (size_t)k >= msg.msg_iov->iov_len) {
+        k -= msg.msg_iov->iov_len;
+        msg.msg_iov++;
+        msg.msg_iovlen--;
+      }
+      if (msg.msg_iovlen > 0) {
+        msg.msg_iov->iov_base = (char *)msg.msg_iov->iov_base + k;
+        msg.msg_iov->iov_len -= k;
+      }
+    }
+  }
+}
+
+struct Result {
+  uint64_t frames = 0;
+  uint64_t bytes = 0;
+  uint64_t bad = 0;
+  double secs = 0;
+};
+
+static void print_result(const char *name, const Result &r) {
+  printf("%-6s %8llu frames %9.1f fps %9.1f MB/s %8llu bad\n", name, (unsigned long long)r.frames, r.frames / r.secs,
+         r.bytes / r.secs / (1024.0 * 1024.0), (unsigned long long)r.bad);
+  fflush(stdout);
+}
+
+static bool same(const std::vector<std::vector<uint8_t>> &payloads, uint64_t i, const uint8_t *data, size_t len) {
+  const auto &p = payloads[i % payloads.size()];
+  return p.size() == len && memcmp(p.data(), data, len) == 0;
+}
+
+static Result run_lib(int port, const Options &o, const std::vector<std::vector<uint8_t>> &payloads) {
+  Result r;
+  std::atomic<bool> stop{false};
+  double t0 = 0;
+  mjpeg::FramePool pool(4, 64 * 1024);
+  mjpeg::StreamParser parser(pool, [&](const mjpeg::Frame &f) {
+    if (!same(payloads, f.index, f.data, f.len)) r.bad++;
+    if (f.host_ts - t0 >= o.seconds) stop = true;
+    return false;
+  });
+  mjpeg::Client client;
+  if (!client.open("127.0.0.1", port, "/stream", 5000)) {
+    fprintf(stderr, "%s\n", client.error().c_str());
+    return r;
+  }
+  t0 = mjpeg::now_seconds();
+  client.run(parser, &stop);
+  r.secs = mjpeg::now_seconds() - t0;
+  r.frames = parser.stats().frames;
+  r.bytes = parser.stats().bytes;
+  if (parser.stats().resyncs) fprintf(stderr, "lib: %llu resyncs\n", (unsigned long long)parser.stats().resyncs);
+  return r;
+}
+
+// Replika loop Python: bytes_data += chunk; cari FFD8 & FFD9 dari awal; potong.
+static Result run_naive(int port, const Options &o, const std::vector<std::vector<uint8_t>> &payloads) {
+  Result r;
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  addr.sin_port = htons(port);
+  if (connect(fd, (sockaddr *)&addr, sizeof(addr)) != 0) {
+    close(fd);
+    return r;
+  }
+  const char *req = "GET /stream HTTP/1.1\r\nHost: 127.0.0.1\r\n\r\n";
+  send(fd, req, strlen(req), MSG_NOSIGNAL);
+
+  std::string bytes_data;
+  char chunk[1024];
+  double t0 = mjpeg::now_seconds();
+  while (mjpeg::now_seconds() - t0 < o.seconds) {
+    ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+    if (n <= 0) break;
+    bytes_data.append(chunk, n);
+    size_t a = bytes_data.find("\xff\xd8");
+    size_t b = bytes_data.find("\xff\xd9");
+    if (a != std::string::npos && b != std::string::npos) {
+      if (b > a) {
+        std::string jpg = bytes_data.substr(a, b + 2 - a);
+        if (!same(payloads, r.frames + r.bad, (const uint8_t *)jpg.data(), jpg.size())) r.bad++;
+        else r.frames++;
+        r.bytes += jpg.size();
+      }
+      bytes_data = bytes_data.substr(b + 2);
+    }
+  }
+  r.secs = mjpeg::now_seconds() - t0;
+  close(fd);
+  return r;
+}
+
+int main(int argc, char **argv) {
+  Options o;
+  for (int i = 1; i < argc; i++) {
+    std::string k = argv[i];
+    if (k == "--no-length") {
+      o.content_length = false;
+      continue;
+    }
+    if (i + 1 >= argc) {
+      fprintf(stderr, "usage: %s [--seconds 3] [--mode lib|naive|both] [--min-kb 8] [--max-kb 40]\n"
+                      "          [--thumb-every 4] [--no-length]\n", argv[0]);
+      return 2;
+    }
+    const char *v = argv[++i];
+    if (k == "--seconds") o.seconds = atof(v);
+    else if (k == "--mode") o.mode = v;
+    else if (k == "--min-kb") o.min_kb = atoi(v);
+    else if (k == "--max-kb") o.max_kb = atoi(v);
+    else if (k == "--thumb-every") o.thumb_every = atoi(v);
+    else {
+      fprintf(stderr, "unknown option %s\n", k.c_str());
+      return 2;
+    }
+  }
+  if (o.max_kb < o.min_kb) o.max_kb = o.min_kb;
+  auto payloads = make_payloads(o);
+
+  printf("loopback, payload %d-%d KB, %s, %.1fs per client\n", o.min_kb, o.max_kb, o.content_length ? "Content-Length" : "boundary only",
+         o.seconds);
+  const char *modes[] = {"lib", "naive"};
+  for (const char *mode : modes) {
+    if (o.mode != "both" && o.mode != mode) continue;
+    int port = 0;
+    int lfd = start_server(&port);
+    if (lfd < 0) {
+      fprintf(stderr, "cannot start stand-in server\n");
+      return 1;
+    }
+    std::thread server(serve_one, lfd, std::cref(o), &payloads);
+    Result r = strcmp(mode, "lib") == 0 ? run_lib(port, o, payloads) : run_naive(port, o, payloads);
+    print_result(mode, r);
+    shutdown(lfd, SHUT_RDWR);
+    close(lfd);
+    server.join();
+  }
+  return 0;
+}
@@ -0,0 +1,109 @@
+// CLI untuk mjpeg_client: baca /stream, cetak fps/jitter/drop tiap detik,
+// opsional simpan frame ke folder.
+//
+// Build:  g++ -O2 -std=c++17 -pthread mjpeg_cat.cpp mjpeg_client.cpp -o mjpeg_cat
+// Contoh: ./mjpeg_cat 192.168.1.50 --path /stream --seconds 30
+//         ./mjpeg_cat 192.168.1.50 --save frames --every 15
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "mjpeg_client.h"
+
+struct Options {
+  std::string host;
+  int port = 80;
+  std::string path = "/stream";
+  int seconds = 0;  // 0 = sampai stream berhenti / Ctrl-C
+  int pool = 4;
+  std::string save_dir;
+  int every = 1;
+  int timeout_ms = 5000;
+};
+
+static std::atomic<bool> g_stop{false};
+
+static void on_signal(int) {
+  g_stop = true;
+}
+
+static void print_stats(const mjpeg::Stats &s, double elapsed, uint64_t bytes_before, double dt) {
+  printf("%7.1fs %7llu frames %6.1f fps %8.1f KB/s  interval %6.1f +- %5.1f ms  jitter %5.1f ms  gap_drops %llu  pool_drops %llu  resyncs %llu\n",
+         elapsed, (unsigned long long)s.frames, s.fps(), dt > 0 ? (s.bytes - bytes_before) / dt / 1024.0 : 0.0, s.interval_mean * 1000,
+         s.interval_stddev() * 1000, s.jitter * 1000, (unsigned long long)s.gap_drops, (unsigned long long)s.pool_drops,
+         (unsigned long long)s.resyncs);
+  fflush(stdout);
+}
+
+int main(int argc, char **argv) {
+  Options o;
+  if (argc < 2) {
+    fprintf(stderr,
+            "usage: %s HOST [--port 80] [--path /stream] [--seconds 0] [--pool 4]\n"
+            "          [--save DIR] [--every 1]\n",
+            argv[0]);
+    return 2;
+  }
+  o.host = argv[1];
+  for (int i = 2; i + 1 < argc; i += 2) {
+    std::string k = argv[i];
+    const char *v = argv[i + 1];
+    if (k == "--port") o.port = atoi(v);
+    else if (k == "--path") o.path = v;
+    else if (k == "--seconds") o.seconds = atoi(v);
+    else if (k == "--pool") o.pool = atoi(v);
+    else if (k == "--save") o.save_dir = v;
+    else if (k == "--every") o.every = atoi(v) > 0 ? atoi(v) : 1;
+    else {
+      fprintf(stderr, "unknown option %s\n", k.c_str());
+      return 2;
+    }
+  }
+  signal(SIGINT, on_signal);
+
+  // statistik dicetak dari callback (thread yang sama dengan parser)
+  double t0 = mjpeg::now_seconds();
+  double last_print = t0;
+  uint64_t last_bytes = 0;
+  mjpeg::StreamParser *parser_ptr = nullptr;
+
+  mjpeg::FramePool pool(o.pool, 64 * 1024);
+  mjpeg::StreamParser parser(pool, [&](const mjpeg::Frame &f) {
+    if (f.host_ts - last_print >= 1.0) {
+      const mjpeg::Stats &s = parser_ptr->stats();
+      print_stats(s, f.host_ts - t0, last_bytes, f.host_ts - last_print);
+      last_bytes = s.bytes;
+      last_print = f.host_ts;
+      if (o.seconds > 0 && f.host_ts - t0 >= o.seconds) g_stop = true;
+    }
+    if (!o.save_dir.empty() && f.index % o.every == 0) {
+      char name[512];
+      snprintf(name, sizeof(name), "%s/frame_%06llu.jpg", o.save_dir.c_str(), (unsigned long long)f.index);
+      FILE *fp = fopen(name, "wb");
+      if (fp) {
+        fwrite(f.data, 1, f.len, fp);
+        fclose(fp);
+      }
+    }
+    return false;
+  });
+  parser_ptr = &parser;
+
+  mjpeg::Client client;
+  if (!client.open(o.host, o.port, o.path, o.timeout_ms)) {
+    fprintf(stderr, "%s\n", client.error().c_str());
+    return 1;
+  }
+
+  bool ok = client.run(parser, &g_stop);
+  double now = mjpeg::now_seconds();
+  printf("total:\n");
+  print_stats(parser.stats(), now - t0, 0, now - t0);
+  if (!ok) {
+    fprintf(stderr, "stream error: %s\n", client.error().c_str());
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,406 @@
+#include "mjpeg_client.h"
+
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <strings.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+namespace mjpeg {
+
+double now_seconds() {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// ---------- FramePool ----------
+FramePool::FramePool(size_t count, size_t reserve) : bufs_(count), used_(count, false) {
+  for (auto &b : bufs_) b.resize(reserve);
+}
+
+int FramePool::acquire() {
+  std::lock_guard<std::mutex> lock(mu_);
+  for (size_t i = 0; i < used_.size(); i++) {
+    if (!used_[i]) {
+      used_[i] = true;
+      return (int)i;
+    }
+  }
+  return -1;
+}
+
+void FramePool::release(int slot) {
+  if (slot < 0) return;
+  std::lock_guard<std::mutex> lock(mu_);
+  used_[slot] = false;
+}
+
+uint8_t *FramePool::reserve(int slot, size_t len) {
+  auto &b = bufs_[slot];
+  if (b.size() < len) b.resize(len + len / 4);  // headroom, jarang resize lagi
+  return b.data();
+}
+
+double Stats::interval_stddev() const {
+  return frames > 2 ? std::sqrt(interval_m2 / (frames - 2)) : 0;
+}
+
+// ---------- StreamParser ----------
+static const uint8_t *find_seq(const uint8_t *hay, size_t n, const char *needle, size_t m) {
+  if (m == 0 || n < m) return nullptr;
+  const uint8_t *end = hay + n - m + 1;
+  for (const uint8_t *p = hay; (p = (const uint8_t *)memchr(p, needle[0], end - p)) != nullptr; p++) {
+    if (memcmp(p, needle, m) == 0) return p;
+  }
+  return nullptr;
+}
+
+// Nilai header (case-insensitive) dalam blok header; "" kalau tidak ada.
+static std::string header_value(const uint8_t *head, size_t len, const char *name) {
+  size_t nlen = strlen(name);
+  const char *p = (const char *)head;
+  const char *end = p + len;
+  while (p < end) {
+    const char *eol = (const char *)memchr(p, '\n', end - p);
+    if (!eol) eol = end;
+    if ((size_t)(eol - p) > nlen && strncasecmp(p, name, nlen) == 0 && p[nlen] == ':') {
+      const char *v = p + nlen + 1;
+      while (v < eol && (*v == ' ' || *v == '\t')) v++;
+      const char *ve = eol;
+      while (ve > v && (ve[-1] == '\r' || ve[-1] == ' ')) ve--;
+      return std::string(v, ve);
+    }
+    p = eol + 1;
+  }
+  return std::string();
+}
+
+StreamParser::StreamParser(FramePool &pool, Callback cb) : pool_(pool), cb_(std::move(cb)), in_(16384), discard_(16384) {
+  head_.reserve(head_limit_);
+}
+
+void StreamParser::reset() {
+  if (slot_ >= 0) pool_.release(slot_);
+  slot_ = -1;
+  state_ = kHttpHead;
+  head_.clear();
+  boundary_.clear();
+  delim_.clear();
+  prev_host_ = prev_dev_ = -1;
+  dev_interval_ = 0;
+  stats_ = Stats();
+  error_.clear();
+}
+
+uint8_t *StreamParser::prepare(size_t *room) {
+  if (state_ == kBody) {
+    size_t left = body_len_ - body_pos_;
+    if (slot_ < 0) {
+      *room = std::min(left, discard_.size());
+      return discard_.data();
+    }
+    *room = left;
+    return pool_.data(slot_) + body_pos_;
+  }
+  *room = in_.size();
+  return in_.data();
+}
+
+bool StreamParser::commit(size_t n) {
+  if (state_ == kBody) {
+    body_pos_ += n;
+    if (body_pos_ == body_len_) finish_body(body_len_);
+    return true;
+  }
+  return process(in_.data(), n);
+}
+
+bool StreamParser::feed(const uint8_t *data, size_t len) {
+  return process(data, len);
+}
+
+bool StreamParser::parse_http_head() {
+  const uint8_t *h = head_.data();
+  size_t n = head_.size();
+  if (n < 12 || memcmp(h, "HTTP/1.", 7) != 0) {
+    error_ = "not an HTTP response";
+    return false;
+  }
+  int status = atoi((const char *)h + 9);
+  if (status != 200) {
+    error_ = "HTTP status " + std::to_string(status);
+    return false;
+  }
+  std::string ct = header_value(h, n, "Content-Type");
+  size_t b = ct.find("boundary=");
+  if (ct.find("multipart/") != 0 || b == std::string::npos) {
+    error_ = "not a multipart stream: " + ct;
+    return false;
+  }
+  boundary_ = ct.substr(b + 9);
+  if (!boundary_.empty() && boundary_[0] == '"') boundary_ = boundary_.substr(1, boundary_.find('"', 1) - 1);
+  size_t semi = boundary_.find(';');
+  if (semi != std::string::npos) boundary_.resize(semi);
+  delim_ = "\r\n--" + boundary_;
+  return true;
+}
+
+// head_ berisi data sejak akhir body sebelumnya. Cari "--boundary", lalu
+// header part sampai baris kosong. consumed = byte head_ yang terpakai.
+bool StreamParser::parse_part_head(size_t *consumed) {
+  const uint8_t *h = head_.data();
+  size_t n = head_.size();
+  const uint8_t *b = find_seq(h, n, delim_.c_str() + 2, delim_.size() - 2);
+  if (!b) return false;
+  size_t skipped = b - h;
+  // normalnya hanya CRLF sebelum boundary
+  for (size_t i = 0; i < skipped; i++) {
+    if (h[i] != '\r' && h[i] != '\n') {
+      stats_.resyncs++;
+      break;
+    }
+  }
+  const uint8_t *hdr = b + delim_.size() - 2;
+  const uint8_t *end = find_seq(hdr, h + n - hdr, "\r\n\r\n", 4);
+  if (!end) return false;
+
+  std::string len = header_value(hdr, end - hdr + 2, "Content-Length");
+  std::string ts = header_value(hdr, end - hdr + 2, "X-Timestamp");
+  body_len_ = len.empty() ? 0 : strtoull(len.c_str(), nullptr, 10);
+  part_ts_ = ts.empty() ? -1 : strtod(ts.c_str(), nullptr);
+  *consumed = (end + 4) - h;
+  state_ = len.empty() ? kBodyScan : kBody;
+  return true;
+}
+
+void StreamParser::begin_body() {
+  body_pos_ = 0;
+  slot_ = pool_.acquire();
+  if (slot_ < 0) {
+    stats_.pool_drops++;
+  } else if (state_ == kBody) {
+    pool_.reserve(slot_, body_len_);
+  }
+}
+
+void StreamParser::finish_body(size_t len) {
+  if (slot_ >= 0) {
+    Frame f{pool_.data(slot_), len, part_ts_, now_seconds(), stats_.frames, slot_};
+    account(f);
+    int slot = slot_;
+    slot_ = -1;
+    if (!cb_ || !cb_(f)) pool_.release(slot);
+  }
+  state_ = kPartHead;
+  head_.clear();
+}
+
+void StreamParser::account(const Frame &f) {
+  Stats &s = stats_;
+  if (s.frames == 0) s.first_ts = f.host_ts;
+  if (prev_host_ >= 0) {
+    double dt = f.host_ts - prev_host_;
+    // Welford untuk rata-rata dan varians interval
+    uint64_t k = s.frames;  // jumlah interval setelah ini
+    double delta = dt - s.interval_mean;
+    s.interval_mean += delta / k;
+    s.interval_m2 += delta * (dt - s.interval_mean);
+    if (f.device_ts >= 0 && prev_dev_ >= 0) {
+      double ddev = f.device_ts - prev_dev_;
+      double d = dt - ddev;
+      s.jitter += (std::fabs(d) - s.jitter) / 16.0;
+      // celah timestamp device > 1.5x interval normal = frame di-skip firmware
+      if (dev_interval_ > 0 && ddev > 1.5 * dev_interval_) {
+        s.gap_drops += (uint64_t)(ddev / dev_interval_ + 0.5) - 1;
+      } else if (ddev > 0) {
+        dev_interval_ = dev_interval_ > 0 ? dev_interval_ * 0.9 + ddev * 0.1 : ddev;
+      }
+    }
+  }
+  prev_host_ = f.host_ts;
+  prev_dev_ = f.device_ts;
+  s.last_ts = f.host_ts;
+  s.frames++;
+  s.bytes += f.len;
+}
+
+bool StreamParser::process(const uint8_t *data, size_t len) {
+  while (len > 0) {
+    switch (state_) {
+      case kFailed:
+        return false;
+
+      case kHttpHead: {
+        size_t take = std::min(len, head_limit_ - head_.size());
+        size_t old = head_.size();
+        head_.insert(head_.end(), data, data + take);
+        size_t from = old > 3 ? old - 3 : 0;
+        const uint8_t *end = find_seq(head_.data() + from, head_.size() - from, "\r\n\r\n", 4);
+        if (!end) {
+          if (head_.size() >= head_limit_) {
+            error_ = "HTTP header too large";
+            state_ = kFailed;
+            return false;
+          }
+          return true;
+        }
+        size_t used = (end + 4 - head_.data()) - old;
+        head_.resize(end + 4 - head_.data());
+        if (!parse_http_head()) {
+          state_ = kFailed;
+          return false;
+        }
+        head_.clear();
+        state_ = kPartHead;
+        data += used;
+        len -= used;
+        break;
+      }
+
+      case kPartHead: {
+        size_t take = std::min(len, head_limit_ - head_.size());
+        size_t old = head_.size();
+        head_.insert(head_.end(), data, data + take);
+        size_t consumed = 0;
+        if (!parse_part_head(&consumed)) {
+          if (head_.size() >= head_limit_) {
+            // tidak ada boundary: sisakan ekor yang mungkin awal boundary
+            stats_.resyncs++;
+            head_.erase(head_.begin(), head_.end() - delim_.size());
+          }
+          data += take;
+          len -= take;
+          break;
+        }
+        size_t used = consumed - old;  // byte dari data yang masuk header
+        data += used;
+        len -= used;
+        head_.clear();
+        begin_body();
+        if (state_ == kBody && body_len_ == 0) finish_body(0);
+        break;
+      }
+
+      case kBody: {
+        size_t take = std::min(len, body_len_ - body_pos_);
+        if (slot_ >= 0) memcpy(pool_.data(slot_) + body_pos_, data, take);
+        body_pos_ += take;
+        data += take;
+        len -= take;
+        if (body_pos_ == body_len_) finish_body(body_len_);
+        break;
+      }
+
+      case kBodyScan: {
+        // tanpa Content-Length: kumpulkan sampai "\r\n--boundary"
+        if (slot_ < 0) {
+          // tetap perlu buffer untuk mencari delimiter
+          head_.insert(head_.end(), data, data + len);
+          const uint8_t *d = find_seq(head_.data(), head_.size(), delim_.c_str(), delim_.size());
+          if (d) {
+            std::vector<uint8_t> rest(head_.begin() + (d + 2 - head_.data()), head_.end());
+            head_.swap(rest);
+            state_ = kPartHead;
+          } else if (head_.size() > delim_.size()) {
+            head_.erase(head_.begin(), head_.end() - delim_.size());
+          }
+          return true;
+        }
+        uint8_t *buf = pool_.reserve(slot_, body_pos_ + len);
+        memcpy(buf + body_pos_, data, len);
+        size_t from = body_pos_ > delim_.size() ? body_pos_ - delim_.size() : 0;
+        body_pos_ += len;
+        const uint8_t *d = find_seq(buf + from, body_pos_ - from, delim_.c_str(), delim_.size());
+        if (!d) return true;
+        size_t frame_len = d - buf;
+        size_t rest = body_pos_ - frame_len - 2;  // sisakan "--boundary..." untuk kPartHead
+        std::vector<uint8_t> tail(d + 2, d + 2 + rest);
+        finish_body(frame_len);
+        head_.swap(tail);
+        // proses sisa header part yang sudah terkumpul
+        size_t consumed = 0;
+        if (parse_part_head(&consumed)) {
+          head_.erase(head_.begin(), head_.begin() + consumed);
+          std::vector<uint8_t> pending;
+          pending.swap(head_);
+          begin_body();
+          if (state_ == kBody && body_len_ == 0) finish_body(0);
+          if (!pending.empty() && !process(pending.data(), pending.size())) return false;
+        }
+        return true;
+      }
+    }
+  }
+  return true;
+}
+
+// ---------- Client ----------
+bool Client::open(const std::string &host, int port, const std::string &path, int timeout_ms) {
+  close();
+  addrinfo hints{}, *res = nullptr;
+  hints.ai_family = AF_INET;
+  hints.ai_socktype = SOCK_STREAM;
+  if (getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &res) != 0) {
+    error_ = "cannot resolve " + host;
+    return false;
+  }
+  fd_ = socket(res->ai_family, res->ai_socktype, res->ai_protocol);
+  if (fd_ >= 0) {
+    timeval tv{timeout_ms / 1000, (timeout_ms % 1000) * 1000};
+    setsockopt(fd_, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    setsockopt(fd_, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+    if (connect(fd_, res->ai_addr, res->ai_addrlen) != 0) {
+      ::close(fd_);
+      fd_ = -1;
+    }
+  }
+  freeaddrinfo(res);
+  if (fd_ < 0) {
+    error_ = "cannot connect to " + host + ":" + std::to_string(port);
+    return false;
+  }
+  std::string req = "GET " + path + " HTTP/1.1\r\nHost: " + host + "\r\nConnection: close\r\n\r\n";
+  if (send(fd_, req.data(), req.size(), MSG_NOSIGNAL) != (ssize_t)req.size()) {
+    error_ = "send failed";
+    close();
+    return false;
+  }
+  return true;
+}
+
+bool Client::run(StreamParser &parser, const std::atomic<bool> *stop) {
+  while (fd_ >= 0 && !(stop && stop->load())) {
+    size_t room = 0;
+    uint8_t *buf = parser.prepare(&room);
+    ssize_t n = recv(fd_, buf, room, 0);
+    if (n == 0) return true;  // server menutup stream
+    if (n < 0) {
+      if (stop && stop->load()) return true;
+      error_ = std::string("recv: ") + strerror(errno);
+      return false;
+    }
+    if (!parser.commit(n)) {
+      error_ = parser.error();
+      return false;
+    }
+  }
+  return true;
+}
+
+void Client::shutdown() {
+  if (fd_ >= 0) ::shutdown(fd_, SHUT_RDWR);
+}
+
+void Client::close() {
+  if (fd_ >= 0) ::close(fd_);
+  fd_ = -1;
+}
+
+}  // namespace mjpeg
@@ -0,0 +1,136 @@
+// Klien MJPEG (multipart/x-mixed-replace) incremental untuk /stream firmware.
+//
+// Parser berbasis state machine: header HTTP -> header part -> body. Body
+// dibaca sepanjang Content-Length langsung ke buffer pool (recv ke buffer
+// frame, tanpa copy perantara dan tanpa alokasi per frame). Kalau part tidak
+// punya Content-Length, body dibatasi oleh "\r\n--boundary" (bukan FFD8/FFD9,
+// yang bisa muncul di data entropy). X-Timestamp dipakai untuk statistik
+// jitter dan perkiraan frame yang di-drop firmware.
+//
+//   mjpeg::FramePool pool(4, 64 * 1024);
+//   mjpeg::StreamParser parser(pool, [&](const mjpeg::Frame &f) {
+//     ... pakai f.data / f.len ...
+//     return false;  // true = simpan slot, kembalikan nanti dengan pool.release(f.slot)
+//   });
+//   mjpeg::Client client;
+//   client.open("192.168.1.50", 80, "/stream", 5000);
+//   client.run(parser, &stop);
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace mjpeg {
+
+struct Frame {
+  const uint8_t *data;
+  size_t len;
+  double device_ts;  // X-Timestamp (detik), -1 kalau tidak ada
+  double host_ts;    // steady clock saat frame lengkap (detik)
+  uint64_t index;
+  int slot;
+};
+
+// Buffer frame yang dipakai ulang; aman dipakai dari thread lain (release).
+class FramePool {
+ public:
+  FramePool(size_t count, size_t reserve);
+  int acquire();  // -1 kalau semua slot dipegang konsumen
+  void release(int slot);
+  uint8_t *reserve(int slot, size_t len);  // tumbuh saja, tidak pernah mengecil
+  uint8_t *data(int slot) { return bufs_[slot].data(); }
+  size_t capacity(int slot) const { return bufs_[slot].size(); }
+  size_t count() const { return bufs_.size(); }
+
+ private:
+  std::vector<std::vector<uint8_t>> bufs_;
+  std::vector<bool> used_;
+  std::mutex mu_;
+};
+
+struct Stats {
+  uint64_t frames = 0;
+  uint64_t bytes = 0;       // payload JPEG
+  uint64_t pool_drops = 0;  // frame dibuang karena pool penuh
+  uint64_t gap_drops = 0;   // perkiraan frame hilang dari celah X-Timestamp
+  uint64_t resyncs = 0;     // boundary tidak ditemukan di tempat yang diharapkan
+  double first_ts = 0;
+  double last_ts = 0;
+  double interval_mean = 0;  // detik, rata-rata jarak antar frame (host)
+  double interval_m2 = 0;    // Welford, untuk stddev
+  double jitter = 0;         // RFC 3550: variasi transit host vs device (detik)
+
+  double fps() const { return frames > 1 && last_ts > first_ts ? (frames - 1) / (last_ts - first_ts) : 0; }
+  double interval_stddev() const;
+};
+
+class StreamParser {
+ public:
+  // Return true kalau konsumen menyimpan slot (wajib pool.release nanti).
+  using Callback = std::function<bool(const Frame &)>;
+
+  StreamParser(FramePool &pool, Callback cb);
+
+  // Jalur tanpa copy: recv langsung ke buffer yang disiapkan parser.
+  uint8_t *prepare(size_t *room);
+  bool commit(size_t n);  // false kalau stream tidak valid (lihat error())
+
+  bool feed(const uint8_t *data, size_t len);  // jalur biasa (copy)
+  void reset();
+
+  const Stats &stats() const { return stats_; }
+  const std::string &error() const { return error_; }
+  const std::string &boundary() const { return boundary_; }
+
+ private:
+  enum State { kHttpHead, kPartHead, kBody, kBodyScan, kFailed };
+
+  bool process(const uint8_t *data, size_t len);
+  bool parse_http_head();
+  bool parse_part_head(size_t *consumed);
+  void begin_body();
+  void finish_body(size_t len);
+  void account(const Frame &f);
+
+  FramePool &pool_;
+  Callback cb_;
+  State state_ = kHttpHead;
+  std::string boundary_;
+  std::string delim_;  // "\r\n--" + boundary
+  std::vector<uint8_t> head_;
+  std::vector<uint8_t> in_;
+  std::vector<uint8_t> discard_;
+  size_t head_limit_ = 8192;
+  int slot_ = -1;
+  size_t body_len_ = 0;  // Content-Length part sekarang
+  size_t body_pos_ = 0;
+  double part_ts_ = -1;
+  double prev_host_ = -1;
+  double prev_dev_ = -1;
+  double dev_interval_ = 0;
+  Stats stats_;
+  std::string error_;
+};
+
+class Client {
+ public:
+  ~Client() { close(); }
+  bool open(const std::string &host, int port, const std::string &path, int timeout_ms);
+  // Baca sampai stream berakhir, error, atau *stop true. Return false kalau error.
+  bool run(StreamParser &parser, const std::atomic<bool> *stop);
+  void close();
+  void shutdown();  // bangunkan run() dari thread lain
+  const std::string &error() const { return error_; }
+
+ private:
+  int fd_ = -1;
+  std::string error_;
+};
+
+double now_seconds();
+
+}  // namespace mjpeg
@@ -0,0 +1,385 @@
+// Cek + benchmark framing MJPEG firmware (BoboBee Stream/5_3/mjpeg_framing.cpp) di host.
+//
+// mjpeg_stream_begin / mjpeg_stream_write / mjpeg_body_begin dijalankan
+// terhadap socketpair; httpd_req_to_sockfd dan httpd_sess_trigger_close
+// diganti tiruan di bawah. Dicek:
+//   - output di-parse ulang dengan mjpeg::StreamParser: jumlah frame, isi
+//     byte per byte, X-Timestamp, boundary; response header tanpa chunked
+//   - satu writev per frame; partial write dan EINTR (writev tiruan yang
+//     membatasi byte per panggilan) tetap menghasilkan stream yang utuh,
+//     byte/writes terhitung benar
+//   - viewer macet (SO_SNDTIMEO, tidak pernah dibaca): write berhenti dengan
+//     ESP_ERR_TIMEOUT, tidak mengulang selamanya
+//   - prefix kasus terburuk muat di MJPEG_PREFIX_MAX, boundary terlalu
+//     panjang ditolak, body biasa dengan/tanpa Content-Length
+// Benchmark: satu writev per frame vs jalur lama (3x httpd_resp_send_chunk =
+// 9 send per frame), syscall dan byte overhead per frame.
+//
+// Build:  g++ -O2 -std=c++17 -pthread -I"../BoboBee Stream/5_3" -I../sim/include mjpeg_framing_check.cpp "../BoboBee Stream/5_3/mjpeg_framing.cpp" mjpeg_client.cpp -o mjpeg_framing_check
+// Contoh: ./mjpeg_framing_check
+//         ./mjpeg_framing_check --frames 20000 --kb 30
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/time.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "mjpeg_client.h"
+#include "mjpeg_framing.h"
+
+#define PART_BOUNDARY "123456789000000000000987654321"  // app_httpd.cpp
+
+static int _failed = 0;
+
+#define CHECK(cond)                                                  \
+  do {                                                               \
+    if (!(cond)) {                                                   \
+      fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+      _failed++;                                                     \
+    }                                                                \
+  } while (0)
+
+static double now_seconds() {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// ---------- tiruan esp_http_server: fd socket di user_ctx ----------
+static int _closed_fd = -1;
+
+extern "C" int httpd_req_to_sockfd(httpd_req_t *r) {
+  return (int)(intptr_t)r->user_ctx;
+}
+
+extern "C" esp_err_t httpd_sess_trigger_close(httpd_handle_t, int sockfd) {
+  _closed_fd = sockfd;
+  return ESP_OK;
+}
+
+// writev tiruan (menggantikan libc di binary ini): _writev_cap byte per
+// panggilan = partial write, tiap panggilan ke-_writev_eintr gagal EINTR.
+static size_t _writev_cap = 0;
+static int _writev_eintr = 0;
+static int _writev_calls = 0;
+
+extern "C" ssize_t writev(int fd, const struct iovec *iov, int cnt) {
+  _writev_calls++;
+  if (_writev_eintr && _writev_calls % _writev_eintr == 0) {
+    errno = EINTR;
+    return -1;
+  }
+  if (!_writev_cap || cnt > 8) {
+    return syscall(SYS_writev, fd, iov, cnt);
+  }
+  struct iovec cut[8];
+  size_t room = _writev_cap;
+  int k = 0;
+  for (; k < cnt && room > 0; k++) {
+    cut[k] = iov[k];
+    if (cut[k].iov_len > room) cut[k].iov_len = room;
+    room -= cut[k].iov_len;
+  }
+  return syscall(SYS_writev, fd, cut, k);
+}
+
+static httpd_req_t make_req(int fd) {
+  httpd_req_t req = {};
+  req.user_ctx = (void *)(intptr_t)fd;
+  return req;
+}
+
+// ---------- pembaca ----------
+// Baca sampai EOF di thread sendiri.
+struct Reader {
+  explicit Reader(int fd) : fd(fd) {}
+
+  int fd;
+  bool keep = true;
+  std::string data;
+  uint64_t total = 0;
+  std::thread th;
+
+  void start() {
+    th = std::thread([this] {
+      std::vector<char> buf(256 * 1024);
+      for (;;) {
+        ssize_t n = read(fd, buf.data(), buf.size());
+        if (n <= 0) break;
+        total += n;
+        if (keep) data.append(buf.data(), n);
+      }
+    });
+  }
+  void join() { th.join(); }
+};
+
+// Payload mirip JPEG: SOI/EOI plus isi acak yang memuat "\r\n--" + boundary.
+static std::vector<std::vector<uint8_t>> make_frames(int count, size_t min_len, size_t max_len) {
+  std::mt19937 rng(77);
+  std::vector<std::vector<uint8_t>> out(count);
+  for (int i = 0; i < count; i++) {
+    size_t len = min_len + rng() % (max_len - min_len + 1);
+    auto &p = out[i];
+    p.resize(len);
+    for (auto &b : p) b = rng() & 0xFF;
+    p[0] = 0xFF;
+    p[1] = 0xD8;
+    if (len > 64) memcpy(&p[len / 2], "\r\n--" PART_BOUNDARY, 4 + strlen(PART_BOUNDARY));
+    p[len - 2] = 0xFF;
+    p[len - 1] = 0xD9;
+  }
+  return out;
+}
+
+static size_t header_end(const std::string &s) {
+  size_t e = s.find("\r\n\r\n");
+  return e == std::string::npos ? 0 : e + 4;
+}
+
+// Kirim semua frame, lalu parse ulang apa yang diterima pembaca.
+// cap/eintr: lihat writev tiruan di atas (0 = writev biasa).
+static void run_roundtrip(const char *name, size_t cap, int eintr, size_t min_len, size_t max_len) {
+  int sv[2];
+  CHECK(socketpair(AF_UNIX, SOCK_STREAM, 0, sv) == 0);
+  Reader rd(sv[1]);
+  rd.start();
+  _writev_cap = cap;
+  _writev_eintr = eintr;
+  _writev_calls = 0;
+
+  auto frames = make_frames(40, min_len, max_len);
+  httpd_req_t req = make_req(sv[0]);
+  mjpeg_writer_t w;
+  CHECK(mjpeg_stream_begin(&w, &req, PART_BOUNDARY, true, "Access-Control-Allow-Origin: *\r\nX-Framerate: 60\r\n") == ESP_OK);
+  uint64_t payload = 0;
+  for (size_t i = 0; i < frames.size(); i++) {
+    struct timeval ts = {(time_t)(1000 + i), (suseconds_t)(i * 1000)};
+    CHECK(mjpeg_stream_write(&w, frames[i].data(), frames[i].size(), &ts) == ESP_OK);
+    payload += frames[i].size();
+  }
+  _writev_cap = 0;
+  _writev_eintr = 0;
+  _closed_fd = -1;
+  mjpeg_stream_end(&w, &req);
+  CHECK(_closed_fd == sv[0]);
+  close(sv[0]);
+  rd.join();
+  close(sv[1]);
+
+  size_t head = header_end(rd.data);
+  std::string hdr = rd.data.substr(0, head);
+  CHECK(hdr.find("HTTP/1.1 200 OK\r\n") == 0);
+  CHECK(hdr.find("multipart/x-mixed-replace;boundary=" PART_BOUNDARY "\r\n") != std::string::npos);
+  CHECK(hdr.find("X-Framerate: 60\r\n") != std::string::npos);
+  CHECK(hdr.find("Connection: close\r\n") != std::string::npos);
+  CHECK(hdr.find("Transfer-Encoding") == std::string::npos);
+  CHECK(w.frames == frames.size());
+  CHECK(w.bytes == rd.data.size() - head);
+
+  mjpeg::FramePool pool(4, 64 * 1024);
+  size_t got = 0;
+  bool same = true;
+  mjpeg::StreamParser parser(pool, [&](const mjpeg::Frame &f) {
+    if (got < frames.size()) {
+      const auto &want = frames[got];
+      double ts = 1000 + got + got * 1e-3;
+      same = same && f.len == want.size() && memcmp(f.data, want.data(), f.len) == 0 && fabs(f.device_ts - ts) < 1e-6;
+    }
+    got++;
+    return false;
+  });
+  CHECK(parser.feed((const uint8_t *)rd.data.data(), rd.data.size()));
+  CHECK(parser.error().empty());
+  CHECK(parser.boundary() == PART_BOUNDARY);
+  CHECK(got == frames.size());
+  CHECK(same);
+  printf("  %-22s %2u frames, %7.1f KB, %u writev, overhead %.1f B/frame\n", name, (unsigned)w.frames, payload / 1024.0,
+         (unsigned)w.writes, (double)(w.bytes - payload) / w.frames);
+  if (cap || eintr) {
+    CHECK(w.writes > w.frames);  // partial write / EINTR benar-benar terjadi
+  } else {
+    CHECK(w.writes == w.frames);
+  }
+}
+
+// Viewer macet: socket tidak pernah dibaca, SO_SNDTIMEO seperti httpd.
+static void check_stalled_viewer() {
+  int sv[2];
+  CHECK(socketpair(AF_UNIX, SOCK_STREAM, 0, sv) == 0);
+  struct timeval snd = {0, 200 * 1000};
+  setsockopt(sv[0], SOL_SOCKET, SO_SNDTIMEO, &snd, sizeof(snd));
+  auto frames = make_frames(1, 64 * 1024, 64 * 1024);
+  httpd_req_t req = make_req(sv[0]);
+
+  std::atomic<bool> done{false};
+  esp_err_t res = ESP_OK;
+  double t0 = now_seconds();
+  std::thread th([&] {
+    mjpeg_writer_t w;
+    res = mjpeg_stream_begin(&w, &req, PART_BOUNDARY, false, NULL);
+    for (int i = 0; i < 1000 && res == ESP_OK; i++) {
+      res = mjpeg_stream_write(&w, frames[0].data(), frames[0].size(), NULL);
+    }
+    done = true;
+  });
+  while (!done && now_seconds() - t0 < 5) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  bool returned = done;
+  if (!returned) {
+    shutdown(sv[1], SHUT_RDWR);  // lepaskan writer supaya thread bisa di-join
+  }
+  th.join();
+  CHECK(returned);
+  CHECK(res == ESP_ERR_TIMEOUT);
+  printf("  stalled viewer         ended after %.2f s with %s\n", now_seconds() - t0,
+         res == ESP_ERR_TIMEOUT ? "ESP_ERR_TIMEOUT" : "other error");
+  close(sv[0]);
+  close(sv[1]);
+}
+
+static void check_prefix_and_body() {
+  // prefix kasus terburuk: len 10 digit, detik int64 negatif
+  mjpeg_writer_t w;
+  int sv[2];
+  CHECK(socketpair(AF_UNIX, SOCK_STREAM, 0, sv) == 0);
+  Reader rd(sv[1]);
+  rd.start();
+  httpd_req_t req = make_req(sv[0]);
+  CHECK(mjpeg_stream_begin(&w, &req, PART_BOUNDARY, true, NULL) == ESP_OK);
+  struct timeval ts = {(time_t)INT64_MIN, 999999};
+  size_t n = mjpeg_format_prefix(&w, 4294967295u, &ts);
+  CHECK(n < MJPEG_PREFIX_MAX);
+  CHECK(memcmp(w.prefix + n - 4, "\r\n\r\n", 4) == 0);
+
+  std::string boundary(MJPEG_PREFIX_MAX, 'x');
+  CHECK(mjpeg_stream_begin(&w, &req, boundary.c_str(), false, NULL) == ESP_ERR_INVALID_ARG);
+
+  // body biasa dengan Content-Length
+  const char body[] = "RIFF....AVI ";
+  CHECK(mjpeg_body_begin(&w, &req, "video/x-msvideo", sizeof(body) - 1, "Content-Disposition: attachment\r\n") == ESP_OK);
+  struct iovec iov = {(void *)body, sizeof(body) - 1};
+  CHECK(mjpeg_writev(&w, &iov, 1) == ESP_OK);
+  CHECK(w.bytes == sizeof(body) - 1);
+  // tanpa Content-Length (body sampai close)
+  CHECK(mjpeg_body_begin(&w, &req, "application/octet-stream", 0, NULL) == ESP_OK);
+  close(sv[0]);
+  rd.join();
+  close(sv[1]);
+
+  const std::string &s = rd.data;
+  size_t avi = s.find("Content-Type: video/x-msvideo\r\nContent-Length: 12\r\nContent-Disposition: attachment\r\nConnection: close\r\n\r\n" "RIFF....AVI ");
+  CHECK(avi != std::string::npos);
+  size_t raw = s.find("Content-Type: application/octet-stream\r\nConnection: close\r\n\r\n");
+  CHECK(raw != std::string::npos && raw > avi);
+}
+
+static int run_checks() {
+  printf("checks:\n");
+  run_roundtrip("one writev per frame", 0, 0, 100, 120 * 1024);
+  run_roundtrip("partial writes", 97, 0, 20, 60 * 1024);  // juga putus di tengah prefix
+  run_roundtrip("EINTR retried", 0, 3, 100, 60 * 1024);
+  check_stalled_viewer();
+  check_prefix_and_body();
+  printf("checks: %s\n", _failed ? "FAIL" : "PASS");
+  return _failed ? 1 : 0;
+}
+
+// ---------- benchmark ----------
+// Jalur lama: httpd_resp_send_chunk untuk boundary, header part dan payload;
+// tiap chunk = panjang hex, data, CRLF (3 send).
+static bool send_all(int fd, const void *buf, size_t len) {
+  const char *p = (const char *)buf;
+  while (len) {
+    ssize_t n = send(fd, p, len, 0);
+    if (n <= 0) return false;
+    p += n;
+    len -= n;
+  }
+  return true;
+}
+
+static bool send_chunk(int fd, const void *buf, size_t len, uint64_t *calls) {
+  char hex[16];
+  int n = snprintf(hex, sizeof(hex), "%x\r\n", (unsigned)len);
+  *calls += 3;
+  return send_all(fd, hex, n) && send_all(fd, buf, len) && send_all(fd, "\r\n", 2);
+}
+
+static void bench(int count, int kb) {
+  auto frames = make_frames(8, kb * 1024, kb * 1024);
+  static const char *kStreamBoundary = "\r\n--" PART_BOUNDARY "\r\n";
+
+  double rates[2] = {0, 0}, calls_per[2] = {0, 0}, over_per[2] = {0, 0};
+  for (int mode = 0; mode < 2; mode++) {
+    int sv[2];
+    socketpair(AF_UNIX, SOCK_STREAM, 0, sv);
+    Reader rd(sv[1]);
+    rd.keep = false;
+    rd.start();
+    uint64_t calls = 0, payload = 0;
+    httpd_req_t req = make_req(sv[0]);
+    mjpeg_writer_t w;
+    mjpeg_stream_begin(&w, &req, PART_BOUNDARY, true, NULL);
+    uint64_t base = rd.total;
+    double t0 = now_seconds();
+    for (int i = 0; i < count; i++) {
+      const auto &f = frames[i % frames.size()];
+      struct timeval ts = {(time_t)i, 0};
+      payload += f.size();
+      if (mode == 0) {
+        char part[128];
+        int n = snprintf(part, sizeof(part), "Content-Type: image/jpeg\r\nContent-Length: %u\r\nX-Timestamp: %lld.%06ld\r\n\r\n",
+                         (unsigned)f.size(), (long long)ts.tv_sec, (long)ts.tv_usec);
+        send_chunk(sv[0], kStreamBoundary, strlen(kStreamBoundary), &calls);
+        send_chunk(sv[0], part, n, &calls);
+        send_chunk(sv[0], f.data(), f.size(), &calls);
+      } else {
+        mjpeg_stream_write(&w, f.data(), f.size(), &ts);
+      }
+    }
+    double dt = now_seconds() - t0;
+    close(sv[0]);
+    rd.join();
+    close(sv[1]);
+    if (mode == 1) calls = w.writes;
+    rates[mode] = count / dt;
+    calls_per[mode] = (double)calls / count;
+    over_per[mode] = (double)(rd.total - base - payload) / count;
+  }
+  printf("bench: %d frames of %d KB over a socketpair\n", count, kb);
+  printf("  3x send_chunk (old)  %9.0f frames/s  %4.1f syscalls/frame  %5.1f B/frame overhead\n", rates[0], calls_per[0],
+         over_per[0]);
+  printf("  one writev (new)     %9.0f frames/s  %4.1f syscalls/frame  %5.1f B/frame overhead  (%.2fx)\n", rates[1],
+         calls_per[1], over_per[1], rates[1] / rates[0]);
+}
+
+int main(int argc, char **argv) {
+  int count = 5000, kb = 30;
+  for (int i = 1; i + 1 < argc; i += 2) {
+    std::string k = argv[i];
+    if (k == "--frames") count = atoi(argv[i + 1]) > 0 ? atoi(argv[i + 1]) : 1;
+    else if (k == "--kb") kb = atoi(argv[i + 1]) > 0 ? atoi(argv[i + 1]) : 1;
+    else {
+      fprintf(stderr, "usage: %s [--frames 5000] [--kb 30]\n", argv[0]);
+      return 2;
+    }
+  }
+  signal(SIGPIPE, SIG_IGN);
+  int rc = run_checks();
+  bench(count, kb);
+  return rc;
+}
@@ -0,0 +1,183 @@
+// Load test: latensi GET /status (atau path lain) saat 0, 1, 4 stream terbuka.
+//
+// Build:  g++ -O2 -std=c++17 -pthread status_latency.cpp -o status_latency
+// Contoh: ./status_latency 192.168.1.50 --port 80 --path /status --streams 0,1,4
+//         ./status_latency 192.168.1.50 --path /tm          (firmware 5_3 / addon)
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+  std::string host;
+  int port = 80;
+  int stream_port = 0;  // 0 = sama dengan port
+  std::string path = "/status";
+  std::string stream_path = "/stream";
+  std::vector<int> streams = {0, 1, 4};
+  int requests = 200;
+  int warmup_ms = 1500;
+  int timeout_ms = 5000;
+};
+
+static int tcp_connect(const std::string &host, int port, int timeout_ms) {
+  addrinfo hints{}, *res = nullptr;
+  hints.ai_family = AF_INET;
+  hints.ai_socktype = SOCK_STREAM;
+  if (getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &res) != 0) return -1;
+  int fd = socket(res->ai_family, res->ai_socktype, res->ai_protocol);
+  if (fd >= 0) {
+    timeval tv{timeout_ms / 1000, (timeout_ms % 1000) * 1000};
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    if (connect(fd, res->ai_addr, res->ai_addrlen) != 0) {
+      close(fd);
+      fd = -1;
+    }
+  }
+  freeaddrinfo(res);
+  return fd;
+}
+
+static bool send_get(int fd, const std::string &host, const std::string &path) {
+  std::string req = "GET " + path + " HTTP/1.1\r\nHost: " + host + "\r\nConnection: close\r\n\r\n";
+  return send(fd, req.data(), req.size(), MSG_NOSIGNAL) == (ssize_t)req.size();
+}
+
+// Satu request lengkap (connect -> baca sampai close). Return latensi ms atau -1.
+static double timed_request(const Options &o, int *status) {
+  auto t0 = Clock::now();
+  int fd = tcp_connect(o.host, o.port, o.timeout_ms);
+  if (fd < 0) return -1;
+  char buf[2048];
+  std::string head;
+  bool ok = send_get(fd, o.host, o.path);
+  ssize_t n;
+  while (ok && (n = recv(fd, buf, sizeof(buf), 0)) > 0) {
+    if (head.size() < 16) head.append(buf, n);
+  }
+  close(fd);
+  if (!ok || head.size() < 12) return -1;
+  *status = atoi(head.c_str() + 9);
+  return std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+}
+
+// Viewer stream: baca dan buang data sampai disuruh berhenti.
+static void stream_viewer(const Options &o, std::atomic<bool> *stop, std::atomic<long long> *bytes, int *fd_out) {
+  int fd = tcp_connect(o.host, o.stream_port ? o.stream_port : o.port, o.timeout_ms);
+  *fd_out = fd;
+  if (fd < 0 || !send_get(fd, o.host, o.stream_path)) return;
+  std::vector<char> buf(16384);
+  while (!stop->load()) {
+    ssize_t n = recv(fd, buf.data(), buf.size(), 0);
+    if (n <= 0) break;
+    bytes->fetch_add(n);
+  }
+}
+
+static double percentile(std::vector<double> v, double p) {
+  if (v.empty()) return 0;
+  std::sort(v.begin(), v.end());
+  size_t idx = (size_t)std::min<double>(v.size() - 1, p / 100.0 * (v.size() - 1) + 0.5);
+  return v[idx];
+}
+
+static void run_level(const Options &o, int n_streams) {
+  std::atomic<bool> stop{false};
+  std::atomic<long long> stream_bytes{0};
+  std::vector<int> fds(n_streams, -1);
+  std::vector<std::thread> viewers;
+  for (int i = 0; i < n_streams; i++) {
+    viewers.emplace_back(stream_viewer, std::cref(o), &stop, &stream_bytes, &fds[i]);
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(n_streams ? o.warmup_ms : 0));
+
+  std::vector<double> lat;
+  int failed = 0, non200 = 0;
+  auto t0 = Clock::now();
+  long long bytes0 = stream_bytes.load();
+  for (int i = 0; i < o.requests; i++) {
+    int status = 0;
+    double ms = timed_request(o, &status);
+    if (ms < 0) {
+      failed++;
+      continue;
+    }
+    if (status != 200) non200++;
+    lat.push_back(ms);
+  }
+  double secs = std::chrono::duration<double>(Clock::now() - t0).count();
+  long long sbytes = stream_bytes.load() - bytes0;
+
+  stop = true;
+  for (int fd : fds) {
+    if (fd >= 0) shutdown(fd, SHUT_RDWR);
+  }
+  for (auto &t : viewers) t.join();
+  for (int fd : fds) {
+    if (fd >= 0) close(fd);
+  }
+
+  printf("%7d %6zu %6d %6d %8.1f %8.1f %8.1f %8.1f %10.1f\n", n_streams, lat.size(), failed, non200, percentile(lat, 50), percentile(lat, 90),
+         percentile(lat, 99), lat.empty() ? 0.0 : *std::max_element(lat.begin(), lat.end()), secs > 0 ? sbytes / secs / 1024.0 : 0.0);
+  fflush(stdout);
+}
+
+static std::vector<int> parse_list(const char *s) {
+  std::vector<int> out;
+  for (const char *p = s; *p;) {
+    out.push_back(atoi(p));
+    p = strchr(p, ',');
+    if (!p) break;
+    p++;
+  }
+  return out;
+}
+
+int main(int argc, char **argv) {
+  Options o;
+  if (argc < 2) {
+    fprintf(stderr,
+            "usage: %s HOST [--port 80] [--stream-port P] [--path /status] [--stream-path /stream]\n"
+            "          [--streams 0,1,4] [--requests 200] [--warmup-ms 1500]\n",
+            argv[0]);
+    return 2;
+  }
+  o.host = argv[1];
+  for (int i = 2; i + 1 < argc; i += 2) {
+    std::string k = argv[i];
+    const char *v = argv[i + 1];
+    if (k == "--port") o.port = atoi(v);
+    else if (k == "--stream-port") o.stream_port = atoi(v);
+    else if (k == "--path") o.path = v;
+    else if (k == "--stream-path") o.stream_path = v;
+    else if (k == "--streams") o.streams = parse_list(v);
+    else if (k == "--requests") o.requests = atoi(v);
+    else if (k == "--warmup-ms") o.warmup_ms = atoi(v);
+    else {
+      fprintf(stderr, "unknown option %s\n", k.c_str());
+      return 2;
+    }
+  }
+
+  printf("GET http://%s:%d%s, %d requests per level\n", o.host.c_str(), o.port, o.path.c_str(), o.requests);
+  printf("streams     ok failed non200   p50 ms   p90 ms   p99 ms   max ms stream KB/s\n");
+  for (int n : o.streams) run_level(o, n);
+  return 0;
+}
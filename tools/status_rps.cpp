@@ -0,0 +1,233 @@
+// Benchmark request/detik GET /status: poll biasa vs poll kondisional.
+//
+// --conns koneksi keep-alive paralel, masing-masing mengirim GET berulang
+// selama --seconds. Mode:
+//   plain  GET tanpa header tambahan (seperti dashboard lama)
+//   etag   kirim If-None-Match dengan ETag terakhir; firmware membalas
+//          304 tanpa body selama snapshot /status tidak berubah
+// Dilaporkan req/s, jumlah 200/304, byte body/s dan latensi p50/p99.
+//
+// Build:  g++ -O2 -std=c++17 -pthread status_rps.cpp -o status_rps
+// Contoh: ./status_rps 192.168.1.50 --conns 2 --seconds 10
+//         ./status_rps 192.168.1.50 --mode etag --conns 4
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+  std::string host;
+  int port = 80;
+  std::string path = "/status";
+  std::string mode = "both";
+  int conns = 2;  // httpd firmware: max_open_sockets 7, sisakan untuk stream
+  double seconds = 10;
+  int timeout_ms = 5000;
+};
+
+struct Result {
+  long ok200 = 0;
+  long ok304 = 0;
+  long other = 0;
+  long errors = 0;
+  long reconnects = 0;
+  long long body_bytes = 0;
+  std::vector<double> lat_ms;
+};
+
+static int tcp_connect(const std::string &host, int port, int timeout_ms) {
+  addrinfo hints{}, *res = nullptr;
+  hints.ai_family = AF_INET;
+  hints.ai_socktype = SOCK_STREAM;
+  if (getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &res) != 0) return -1;
+  int fd = socket(res->ai_family, res->ai_socktype, res->ai_protocol);
+  if (fd >= 0) {
+    timeval tv{timeout_ms / 1000, (timeout_ms % 1000) * 1000};
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    if (connect(fd, res->ai_addr, res->ai_addrlen) != 0) {
+      close(fd);
+      fd = -1;
+    }
+  }
+  freeaddrinfo(res);
+  return fd;
+}
+
+// Nilai header (case-insensitive) dari blok header, "" kalau tidak ada.
+static std::string header_value(const std::string &head, const char *name) {
+  size_t n = strlen(name);
+  for (size_t pos = head.find("\r\n"); pos != std::string::npos; pos = head.find("\r\n", pos + 2)) {
+    size_t line = pos + 2;
+    if (head.size() > line + n && strncasecmp(head.c_str() + line, name, n) == 0 && head[line + n] == ':') {
+      size_t v = line + n + 1;
+      while (v < head.size() && head[v] == ' ') v++;
+      size_t end = head.find("\r\n", v);
+      return head.substr(v, end == std::string::npos ? std::string::npos : end - v);
+    }
+  }
+  return "";
+}
+
+// Satu respons dari koneksi keep-alive. buf menyimpan sisa byte antar respons.
+static bool read_response(int fd, std::string *buf, int *status, std::string *etag, size_t *body_len, bool *closing) {
+  char tmp[4096];
+  size_t end;
+  while ((end = buf->find("\r\n\r\n")) == std::string::npos) {
+    ssize_t n = recv(fd, tmp, sizeof(tmp), 0);
+    if (n <= 0) return false;
+    buf->append(tmp, n);
+  }
+  std::string head = buf->substr(0, end + 2);
+  buf->erase(0, end + 4);
+  if (head.size() < 12 || head.compare(0, 5, "HTTP/") != 0) return false;
+  *status = atoi(head.c_str() + 9);
+  *etag = header_value(head, "ETag");
+  std::string conn = header_value(head, "Connection");
+  *closing = strncasecmp(conn.c_str(), "close", 5) == 0;
+  std::string cl = header_value(head, "Content-Length");
+  if (cl.empty()) return false;  // /status selalu mengirim Content-Length
+  size_t len = strtoul(cl.c_str(), nullptr, 10);
+  while (buf->size() < len) {
+    ssize_t n = recv(fd, tmp, sizeof(tmp), 0);
+    if (n <= 0) return false;
+    buf->append(tmp, n);
+  }
+  buf->erase(0, len);
+  *body_len = len;
+  return true;
+}
+
+static void worker(const Options &o, bool conditional, Clock::time_point deadline, Result *r) {
+  int fd = -1;
+  std::string buf, etag;
+  while (Clock::now() < deadline) {
+    if (fd < 0) {
+      fd = tcp_connect(o.host, o.port, o.timeout_ms);
+      if (fd < 0) {
+        r->errors++;
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        continue;
+      }
+      buf.clear();
+      r->reconnects++;
+    }
+    std::string req = "GET " + o.path + " HTTP/1.1\r\nHost: " + o.host + "\r\n";
+    if (conditional && !etag.empty()) req += "If-None-Match: " + etag + "\r\n";
+    req += "\r\n";
+
+    auto t0 = Clock::now();
+    int status = 0;
+    size_t body = 0;
+    bool closing = false;
+    std::string tag;
+    if (send(fd, req.data(), req.size(), MSG_NOSIGNAL) != (ssize_t)req.size() ||
+        !read_response(fd, &buf, &status, &tag, &body, &closing)) {
+      r->errors++;
+      close(fd);
+      fd = -1;
+      continue;
+    }
+    r->lat_ms.push_back(std::chrono::duration<double, std::milli>(Clock::now() - t0).count());
+    r->body_bytes += body;
+    if (status == 200) r->ok200++;
+    else if (status == 304) r->ok304++;
+    else r->other++;
+    if (!tag.empty()) etag = tag;
+    if (closing) {
+      close(fd);
+      fd = -1;
+    }
+  }
+  if (fd >= 0) close(fd);
+}
+
+static double percentile(std::vector<double> v, double p) {
+  if (v.empty()) return 0;
+  std::sort(v.begin(), v.end());
+  size_t idx = (size_t)std::min<double>(v.size() - 1, p / 100.0 * (v.size() - 1) + 0.5);
+  return v[idx];
+}
+
+static double run_mode(const Options &o, bool conditional) {
+  std::vector<Result> results(o.conns);
+  std::vector<std::thread> threads;
+  auto t0 = Clock::now();
+  auto deadline = t0 + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(o.seconds));
+  for (int i = 0; i < o.conns; i++) {
+    threads.emplace_back(worker, std::cref(o), conditional, deadline, &results[i]);
+  }
+  for (auto &t : threads) t.join();
+  double secs = std::chrono::duration<double>(Clock::now() - t0).count();
+
+  Result sum;
+  for (auto &r : results) {
+    sum.ok200 += r.ok200;
+    sum.ok304 += r.ok304;
+    sum.other += r.other;
+    sum.errors += r.errors;
+    sum.reconnects += r.reconnects;
+    sum.body_bytes += r.body_bytes;
+    sum.lat_ms.insert(sum.lat_ms.end(), r.lat_ms.begin(), r.lat_ms.end());
+  }
+  double rps = secs > 0 ? sum.lat_ms.size() / secs : 0;
+  printf("%-6s %9.1f %7ld %7ld %6ld %6ld %6ld %9.1f %8.2f %8.2f\n", conditional ? "etag" : "plain", rps, sum.ok200, sum.ok304,
+         sum.other, sum.errors, sum.reconnects, secs > 0 ? sum.body_bytes / secs / 1024.0 : 0.0, percentile(sum.lat_ms, 50),
+         percentile(sum.lat_ms, 99));
+  fflush(stdout);
+  return rps;
+}
+
+int main(int argc, char **argv) {
+  Options o;
+  if (argc < 2) {
+    fprintf(stderr,
+            "usage: %s HOST [--port 80] [--path /status] [--mode plain|etag|both]\n"
+            "          [--conns 2] [--seconds 10]\n",
+            argv[0]);
+    return 2;
+  }
+  o.host = argv[1];
+  for (int i = 2; i + 1 < argc; i += 2) {
+    std::string k = argv[i];
+    const char *v = argv[i + 1];
+    if (k == "--port") o.port = atoi(v);
+    else if (k == "--path") o.path = v;
+    else if (k == "--mode") o.mode = v;
+    else if (k == "--conns") o.conns = std::max(1, atoi(v));
+    else if (k == "--seconds") o.seconds = atof(v);
+    else {
+      fprintf(stderr, "unknown option %s\n", k.c_str());
+      return 2;
+    }
+  }
+  if (o.mode != "plain" && o.mode != "etag" && o.mode != "both") {
+    fprintf(stderr, "unknown mode %s\n", o.mode.c_str());
+    return 2;
+  }
+
+  printf("GET http://%s:%d%s, %d keep-alive connections, %.1f s per mode\n", o.host.c_str(), o.port, o.path.c_str(), o.conns,
+         o.seconds);
+  printf("mode       req/s     200     304  other errors  conns  body KB/s   p50 ms   p99 ms\n");
+  double plain = 0, etag = 0;
+  if (o.mode != "etag") plain = run_mode(o, false);
+  if (o.mode != "plain") etag = run_mode(o, true);
+  if (plain > 0 && etag > 0) printf("etag/plain req/s: %.2fx\n", etag / plain);
+  return 0;
+}
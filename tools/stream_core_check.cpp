@@ -0,0 +1,290 @@
+// Cek inti streaming bersama (cam_stream_core.h: firmware 5_3 + sketch root) di host.
+//
+// Kamera dan sink tiruan menggantikan esp_camera/esp_http_server. Dicek:
+// byte prefix part persis sama dengan stream_handler lama (boundary default,
+// tanpa X-Timestamp) dan dengan X-Timestamp; boundary custom; prefix kasus
+// terburuk (len 10 digit, detik int64 negatif) muat di PartFormat::kMax;
+// frame selalu dikembalikan walau kirim gagal; LED start/stop seimbang; grab
+// gagal menghentikan loop; header response tambahan (Headers). Output juga
+// di-parse ulang dengan mjpeg::StreamParser supaya format tetap cocok dengan
+// klien host.
+//
+// Build:  g++ -O2 -std=c++17 -pthread -I.. stream_core_check.cpp mjpeg_client.cpp -o stream_core_check
+// Contoh: ./stream_core_check
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "cam_stream_core.h"
+#include "mjpeg_client.h"
+
+static int _failed = 0;
+
+#define CHECK(cond)                                                  \
+  do {                                                               \
+    if (!(cond)) {                                                   \
+      fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+      _failed++;                                                     \
+    }                                                                \
+  } while (0)
+
+// ---------- tiruan ----------
+struct FakeCamera {
+  struct Frame {
+    const uint8_t *buf;
+    size_t len;
+    struct timeval timestamp;
+  };
+
+  std::vector<std::vector<uint8_t>> frames;
+  size_t next = 0;
+  int outstanding = 0;  // grab tanpa release
+  int released = 0;
+
+  bool grab(Frame *f) {
+    if (next >= frames.size()) {
+      return false;
+    }
+    const std::vector<uint8_t> &v = frames[next];
+    f->buf = v.data();
+    f->len = v.size();
+    f->timestamp.tv_sec = 1000 + (time_t)next;
+    f->timestamp.tv_usec = (suseconds_t)(next * 33333 % 1000000);
+    next++;
+    outstanding++;
+    return true;
+  }
+
+  void release(Frame *) {
+    outstanding--;
+    released++;
+  }
+};
+
+struct FakeSink {
+  std::string out;
+  int writes = 0;
+  int fail_at = -1;  // write ke-n (0 = begin) gagal
+  int parts = 0;     // write_part: satu per frame
+
+  bool begin(const char *type, const char *extra_hdrs) {
+    return write_raw("HTTP/1.1 200 OK\r\nContent-Type: " + std::string(type) + "\r\n" + (extra_hdrs ? extra_hdrs : "") + "\r\n");
+  }
+  bool write_part(const char *prefix, size_t n, const uint8_t *buf, size_t len) {
+    parts++;
+    return write(prefix, n) && write(buf, len);
+  }
+  bool write(const void *data, size_t len) { return write_raw(std::string((const char *)data, len)); }
+  bool write_raw(const std::string &s) {
+    if (writes++ == fail_at) {
+      return false;
+    }
+    out += s;
+    return true;
+  }
+};
+
+struct CountLed {
+  static inline int starts = 0;
+  static inline int stops = 0;
+  static void stream_start() { starts++; }
+  static void stream_stop() { stops++; }
+};
+
+static std::vector<uint8_t> fake_jpeg(size_t len, uint8_t seed) {
+  std::vector<uint8_t> v(len);
+  for (size_t i = 0; i < len; i++) {
+    v[i] = (uint8_t)(seed + i * 7);
+  }
+  v[0] = 0xFF;
+  v[1] = 0xD8;
+  v[len - 2] = 0xFF;
+  v[len - 1] = 0xD9;
+  return v;
+}
+
+static FakeCamera make_camera(int n) {
+  FakeCamera cam;
+  for (int i = 0; i < n; i++) {
+    cam.frames.push_back(fake_jpeg(200 + i * 1234, (uint8_t)i));
+  }
+  return cam;
+}
+
+// ---------- config ----------
+struct Legacy : cam_core::Defaults {
+  static constexpr bool kTimestamp = false;
+};
+
+struct WithTs : cam_core::Defaults {
+  using Led = CountLed;
+};
+
+struct LongBoundary {
+  static constexpr const char *value = "0123456789012345678901234567890123456789012345678901234567890123456789";
+};
+struct Custom : cam_core::Defaults {
+  using Boundary = LongBoundary;
+};
+
+struct CorsHeaders {
+  static constexpr const char *value = "Access-Control-Allow-Origin: *\r\nX-Framerate: 60\r\n";
+};
+struct WithHeaders : cam_core::Defaults {
+  using Headers = CorsHeaders;
+};
+
+// Ulang parse dengan klien host; return frame yang terbaca.
+static std::vector<mjpeg::Frame> reparse(const std::string &bytes, std::vector<std::string> *bodies, std::string *boundary) {
+  mjpeg::FramePool pool(2, 0);
+  std::vector<mjpeg::Frame> got;
+  mjpeg::StreamParser parser(pool, [&](const mjpeg::Frame &f) {
+    got.push_back(f);
+    bodies->push_back(std::string((const char *)f.data, f.len));
+    return false;
+  });
+  CHECK(parser.feed((const uint8_t *)bytes.data(), bytes.size()));
+  *boundary = parser.boundary();
+  return got;
+}
+
+static void check_legacy_bytes() {
+  FakeCamera cam = make_camera(3);
+  FakeSink sink;
+  cam_core::ServeStats st = cam_core::serve<Legacy>(cam, sink);
+  CHECK(st.frames == 3);
+  CHECK(st.grab_failed);
+  CHECK(!st.write_failed);
+  CHECK(cam.outstanding == 0);
+
+  // Persis seperti stream_handler lama: boundary, part header, payload.
+  std::string want = "HTTP/1.1 200 OK\r\nContent-Type: multipart/x-mixed-replace;boundary=123456789000000000000987654321\r\n\r\n";
+  for (const std::vector<uint8_t> &f : cam.frames) {
+    want += "\r\n--123456789000000000000987654321\r\n";
+    want += "Content-Type: image/jpeg\r\nContent-Length: " + std::to_string(f.size()) + "\r\n\r\n";
+    want += std::string(f.begin(), f.end());
+  }
+  CHECK(sink.out == want);
+  // begin + 2 write per frame, satu write_part per frame
+  CHECK(sink.writes == 1 + 2 * 3);
+  CHECK(sink.parts == 3);
+}
+
+static void check_timestamp() {
+  FakeCamera cam = make_camera(5);
+  FakeSink sink;
+  CountLed::starts = CountLed::stops = 0;
+  cam_core::ServeStats st = cam_core::serve<WithTs>(cam, sink);
+  CHECK(st.frames == 5);
+  CHECK(CountLed::starts == 1 && CountLed::stops == 1);
+  CHECK(sink.out.find("Content-Length: 200\r\nX-Timestamp: 1000.000000\r\n\r\n") != std::string::npos);
+  CHECK(sink.out.find("X-Timestamp: 1001.033333\r\n") != std::string::npos);
+
+  std::vector<std::string> bodies;
+  std::string boundary;
+  std::vector<mjpeg::Frame> got = reparse(sink.out, &bodies, &boundary);
+  CHECK(got.size() == 5);
+  CHECK(boundary == cam_core::DefaultBoundary::value);
+  for (size_t i = 0; i < got.size() && i < cam.frames.size(); i++) {
+    CHECK(bodies[i] == std::string(cam.frames[i].begin(), cam.frames[i].end()));
+    CHECK(got[i].device_ts > 1000 + (double)i - 1e-6 && got[i].device_ts < 1001 + (double)i);
+  }
+}
+
+static void check_custom_boundary() {
+  FakeCamera cam = make_camera(2);
+  FakeSink sink;
+  cam_core::serve<Custom>(cam, sink);
+  std::vector<std::string> bodies;
+  std::string boundary;
+  std::vector<mjpeg::Frame> got = reparse(sink.out, &bodies, &boundary);
+  CHECK(got.size() == 2);
+  CHECK(boundary == LongBoundary::value);
+  CHECK(sink.out.find(std::string("\r\n--") + LongBoundary::value + "\r\nContent-Type: image/jpeg\r\n") != std::string::npos);
+}
+
+static void check_headers() {
+  FakeCamera cam = make_camera(1);
+  FakeSink sink;
+  cam_core::serve<WithHeaders>(cam, sink);
+  CHECK(sink.out.find("\r\nAccess-Control-Allow-Origin: *\r\nX-Framerate: 60\r\n\r\n\r\n--") != std::string::npos);
+  FakeCamera cam2 = make_camera(1);
+  FakeSink plain;
+  cam_core::serve<Legacy>(cam2, plain);
+  CHECK(plain.out.find("Access-Control") == std::string::npos);
+}
+
+template <class Config>
+static void check_worst_case() {
+  using Format = cam_core::PartFormat<typename Config::Boundary, Config::kTimestamp>;
+  Format part;
+  struct timeval ts;
+  ts.tv_sec = (time_t)LLONG_MIN;
+  ts.tv_usec = 999999;
+  size_t n = part.format(UINT32_MAX, ts);
+  CHECK(n < Format::kMax);  // + NUL dari snprintf
+  CHECK(strlen(part.buf + Format::kFixed) == n - Format::kFixed);
+  CHECK(memcmp(part.buf + n - 4, "\r\n\r\n", 4) == 0);
+  // tv_usec rusak tidak boleh melebar ke lebih dari 6 digit
+  ts.tv_usec = 12345678;
+  size_t m = part.format(1, ts);
+  CHECK(m < Format::kMax);
+  CHECK(memcmp(part.buf + m - 4, "\r\n\r\n", 4) == 0);
+}
+
+static void check_failures() {
+  // write payload frame ke-2 gagal: frame tetap dikembalikan, LED mati
+  for (int fail = 1; fail <= 4; fail++) {
+    FakeCamera cam = make_camera(4);
+    FakeSink sink;
+    sink.fail_at = fail;
+    CountLed::starts = CountLed::stops = 0;
+    cam_core::ServeStats st = cam_core::serve<WithTs>(cam, sink);
+    CHECK(st.write_failed);
+    CHECK(!st.grab_failed);
+    CHECK(st.frames == (uint32_t)((fail - 1) / 2));
+    CHECK(cam.outstanding == 0);
+    CHECK(cam.released == (int)st.frames + 1);
+    CHECK(CountLed::starts == 1 && CountLed::stops == 1);
+  }
+
+  // begin gagal: tidak ada grab, LED tidak disentuh
+  {
+    FakeCamera cam = make_camera(2);
+    FakeSink sink;
+    sink.fail_at = 0;
+    CountLed::starts = CountLed::stops = 0;
+    cam_core::ServeStats st = cam_core::serve<WithTs>(cam, sink);
+    CHECK(st.write_failed);
+    CHECK(cam.next == 0);
+    CHECK(CountLed::starts == 0 && CountLed::stops == 0);
+  }
+
+  // stop flag
+  {
+    FakeCamera cam = make_camera(2);
+    FakeSink sink;
+    volatile bool stop = true;
+    cam_core::ServeStats st = cam_core::serve<Legacy>(cam, sink, &stop);
+    CHECK(st.frames == 0 && !st.grab_failed && !st.write_failed);
+  }
+}
+
+int main() {
+  check_legacy_bytes();
+  check_timestamp();
+  check_custom_boundary();
+  check_headers();
+  check_worst_case<Legacy>();
+  check_worst_case<WithTs>();
+  check_worst_case<Custom>();
+  check_failures();
+  if (_failed) {
+    printf("%d check(s) FAILED\n", _failed);
+    return 1;
+  }
+  printf("all stream core checks passed\n");
+  return 0;
+}
@@ -0,0 +1,263 @@
+// Cek + benchmark jalur /tensor (BoboBee Stream/5_3/tensor_resize.cpp) di host.
+//
+// Cek: tensor_scale_rgb888 dibandingkan resize bilinear half-pixel float
+// (crop sama) untuk banyak ukuran sumber/tujuan, RGB dan gray; selisih
+// maksimum harus <= 1 level. Header (magic, shape, crop) ikut dicek.
+// Benchmark per frame, JPEG 320x240 sintetis atau --jpeg frame.jpg:
+//   client   cara klien sekarang: decode JPEG penuh + resize float
+//            (preprocess_frame / canvas TM)
+//   device   yang dikerjakan firmware: decode dengan skala DCT + tensor_scale
+//            (waktu CPU host, ESP32-S3 jauh lebih lambat; lihat rasionya)
+//   tensor   yang tersisa di klien dengan /tensor: uint8 -> float / 255
+//
+// Build:  g++ -O2 -std=c++17 -I"../BoboBee Stream/5_3" tensor_bench.cpp "../BoboBee Stream/5_3/tensor_resize.cpp" -ljpeg -o tensor_bench
+// Contoh: ./tensor_bench
+//         ./tensor_bench --jpeg frames/frame_000015.jpg --iters 500
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <jpeglib.h>  // butuh stdio/size_t lebih dulu
+
+#include "tensor_resize.h"
+
+struct Options {
+  std::string jpeg;
+  int iters = 200;
+  int quality = 80;  // frame2jpg di firmware memakai 80
+};
+
+static double now_seconds() {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static bool read_all(const std::string &path, std::vector<uint8_t> *out) {
+  FILE *f = fopen(path.c_str(), "rb");
+  if (!f) return false;
+  fseek(f, 0, SEEK_END);
+  long n = ftell(f);
+  fseek(f, 0, SEEK_SET);
+  out->resize(n > 0 ? n : 0);
+  bool ok = fread(out->data(), 1, out->size(), f) == out->size();
+  fclose(f);
+  return ok;
+}
+
+// ---------- referensi float ----------
+static void reference_scale(const uint8_t *src, int sw, int sh, int dw, int dh, int channels, std::vector<float> *out) {
+  tensor_rect_t c = tensor_center_crop(sw, sh, dw, dh);
+  out->assign((size_t)dw * dh * channels, 0);
+  auto sample = [&](int x, int y, int k) { return (float)src[((size_t)y * sw + x) * 3 + k]; };
+  for (int y = 0; y < dh; y++) {
+    float fy = std::max(0.0f, (y + 0.5f) * c.h / dh - 0.5f);
+    int y0 = std::min((int)fy, c.h - 1), y1 = std::min(y0 + 1, c.h - 1);
+    float wy = std::min(fy - y0, 1.0f);
+    for (int x = 0; x < dw; x++) {
+      float fx = std::max(0.0f, (x + 0.5f) * c.w / dw - 0.5f);
+      int x0 = std::min((int)fx, c.w - 1), x1 = std::min(x0 + 1, c.w - 1);
+      float wx = std::min(fx - x0, 1.0f);
+      float rgb[3];
+      for (int k = 0; k < 3; k++) {
+        float top = sample(c.x + x0, c.y + y0, k) * (1 - wx) + sample(c.x + x1, c.y + y0, k) * wx;
+        float bot = sample(c.x + x0, c.y + y1, k) * (1 - wx) + sample(c.x + x1, c.y + y1, k) * wx;
+        rgb[k] = top * (1 - wy) + bot * wy;
+      }
+      float *o = out->data() + ((size_t)y * dw + x) * channels;
+      if (channels == 3) {
+        memcpy(o, rgb, sizeof(rgb));
+      } else {
+        o[0] = (77 * rgb[0] + 150 * rgb[1] + 29 * rgb[2]) / 256;
+      }
+    }
+  }
+}
+
+static int run_checks() {
+  std::mt19937 rng(7);
+  const int sizes[][2] = {{320, 240}, {160, 120}, {80, 60}, {240, 320}, {17, 9}, {640, 480}, {96, 96}};
+  const int targets[][2] = {{96, 96}, {224, 224}, {257, 257}, {320, 240}, {8, 8}, {120, 80}};
+  int failures = 0, cases = 0;
+  for (auto &s : sizes) {
+    std::vector<uint8_t> src((size_t)s[0] * s[1] * 3);
+    for (auto &v : src) v = (uint8_t)rng();
+    for (auto &t : targets) {
+      for (int channels : {3, 1}) {
+        tensor_scaler_t *sc = new tensor_scaler_t;
+        if (!tensor_scaler_init(sc, s[0], s[1], t[0], t[1], channels)) {
+          printf("  init failed %dx%d -> %dx%dx%d\n", s[0], s[1], t[0], t[1], channels);
+          failures++;
+          delete sc;
+          continue;
+        }
+        std::vector<uint8_t> got(tensor_bytes(t[0], t[1], channels));
+        std::vector<float> ref;
+        tensor_scale_rgb888(sc, src.data(), (size_t)s[0] * 3, got.data());
+        reference_scale(src.data(), s[0], s[1], t[0], t[1], channels, &ref);
+        float max_err = 0;
+        for (size_t i = 0; i < got.size(); i++) max_err = std::max(max_err, std::fabs(got[i] - ref[i]));
+        tensor_header_t h;
+        tensor_header_init(&h, sc, 1, 42, 1234567);
+        bool header_ok = memcmp(h.magic, TENSOR_MAGIC, 4) == 0 && h.header_len == sizeof(h) && h.width == t[0] && h.height == t[1] &&
+                         h.channels == channels && h.crop_w == sc->crop.w * 2 && h.frame == 42;
+        // crop harus di tengah dan rasionya sama dengan tujuan (toleransi pembulatan 1 px)
+        bool crop_ok = std::abs(sc->crop.w * t[1] - sc->crop.h * t[0]) <= std::max(t[0], t[1]) &&
+                       std::abs((s[0] - sc->crop.w) - 2 * sc->crop.x) <= 1 && std::abs((s[1] - sc->crop.h) - 2 * sc->crop.y) <= 1;
+        cases++;
+        if (max_err > 1.0f || !header_ok || !crop_ok) {
+          printf("  FAIL %dx%d -> %dx%dx%d: max err %.2f header %d crop %d\n", s[0], s[1], t[0], t[1], channels, max_err, header_ok, crop_ok);
+          failures++;
+        }
+        delete sc;
+      }
+    }
+  }
+  static tensor_scaler_t limits;
+  if (tensor_scaler_init(&limits, 320, 240, TENSOR_MAX_DIM + 1, 96, 3) || tensor_jpeg_scale(320, 240, 96, 96) != 1 ||
+      tensor_jpeg_scale(320, 240, 224, 224) != 0 || tensor_jpeg_scale(640, 480, 96, 96) != 2) {
+    printf("  FAIL limits / jpeg scale\n");
+    failures++;
+  }
+  printf("checks: %d cases, %s\n", cases, failures ? "FAIL" : "PASS");
+  return failures ? 1 : 0;
+}
+
+// ---------- JPEG (libjpeg) ----------
+static std::vector<uint8_t> encode_jpeg(const std::vector<uint8_t> &rgb, int w, int h, int quality) {
+  jpeg_compress_struct c;
+  jpeg_error_mgr err;
+  c.err = jpeg_std_error(&err);
+  jpeg_create_compress(&c);
+  unsigned char *mem = nullptr;
+  unsigned long len = 0;
+  jpeg_mem_dest(&c, &mem, &len);
+  c.image_width = w;
+  c.image_height = h;
+  c.input_components = 3;
+  c.in_color_space = JCS_RGB;
+  jpeg_set_defaults(&c);
+  jpeg_set_quality(&c, quality, TRUE);
+  jpeg_start_compress(&c, TRUE);
+  while (c.next_scanline < c.image_height) {
+    JSAMPROW row = (JSAMPROW)&rgb[(size_t)c.next_scanline * w * 3];
+    jpeg_write_scanlines(&c, &row, 1);
+  }
+  jpeg_finish_compress(&c);
+  jpeg_destroy_compress(&c);
+  std::vector<uint8_t> out(mem, mem + len);
+  free(mem);
+  return out;
+}
+
+// shift 0..3 = skala DCT 1/1..1/8, seperti esp_jpg_decode(JPG_SCALE_*)
+static void decode_jpeg(const std::vector<uint8_t> &jpg, int shift, std::vector<uint8_t> *rgb, int *w, int *h) {
+  jpeg_decompress_struct d;
+  jpeg_error_mgr err;
+  d.err = jpeg_std_error(&err);
+  jpeg_create_decompress(&d);
+  jpeg_mem_src(&d, jpg.data(), jpg.size());
+  jpeg_read_header(&d, TRUE);
+  d.out_color_space = JCS_RGB;
+  d.scale_num = 1;
+  d.scale_denom = 1u << shift;
+  jpeg_start_decompress(&d);
+  *w = d.output_width;
+  *h = d.output_height;
+  rgb->resize((size_t)*w * *h * 3);
+  while (d.output_scanline < d.output_height) {
+    JSAMPROW row = &(*rgb)[(size_t)d.output_scanline * *w * 3];
+    jpeg_read_scanlines(&d, &row, 1);
+  }
+  jpeg_finish_decompress(&d);
+  jpeg_destroy_decompress(&d);
+}
+
+static std::vector<uint8_t> synthetic_frame(int w, int h) {
+  std::mt19937 rng(3);
+  std::vector<uint8_t> rgb((size_t)w * h * 3);
+  for (int y = 0; y < h; y++) {
+    for (int x = 0; x < w; x++) {
+      uint8_t *p = &rgb[((size_t)y * w + x) * 3];
+      int n = (int)(rng() % 24);
+      p[0] = (uint8_t)std::min(255, x * 255 / w + n);
+      p[1] = (uint8_t)std::min(255, y * 255 / h + n);
+      p[2] = (uint8_t)std::min(255, ((x / 20 + y / 20) & 1) * 160 + n);
+    }
+  }
+  return rgb;
+}
+
+static void bench(const std::vector<uint8_t> &jpg, int dw, int dh, int channels, int iters) {
+  std::vector<uint8_t> rgb, tensor(tensor_bytes(dw, dh, channels));
+  std::vector<float> input(tensor.size());
+  int w = 0, h = 0;
+  decode_jpeg(jpg, 0, &rgb, &w, &h);
+  int shift = tensor_jpeg_scale(w, h, dw, dh);
+
+  double t0 = now_seconds();
+  for (int i = 0; i < iters; i++) {
+    decode_jpeg(jpg, 0, &rgb, &w, &h);
+    reference_scale(rgb.data(), w, h, dw, dh, channels, &input);
+    for (auto &v : input) v *= 1.0f / 255;
+  }
+  double client = (now_seconds() - t0) / iters;
+
+  tensor_scaler_t *sc = new tensor_scaler_t;
+  sc->src_w = 0;
+  double t_decode = 0, t_scale = 0;
+  for (int i = 0; i < iters; i++) {
+    double a = now_seconds();
+    int sw = 0, sh = 0;
+    decode_jpeg(jpg, shift, &rgb, &sw, &sh);
+    double b = now_seconds();
+    if (sc->src_w != sw || sc->src_h != sh) tensor_scaler_init(sc, sw, sh, dw, dh, channels);
+    tensor_scale_rgb888(sc, rgb.data(), (size_t)sw * 3, tensor.data());
+    t_decode += b - a;
+    t_scale += now_seconds() - b;
+  }
+  delete sc;
+
+  t0 = now_seconds();
+  for (int i = 0; i < iters; i++) {
+    for (size_t k = 0; k < tensor.size(); k++) input[k] = tensor[k] * (1.0f / 255);
+  }
+  double client_tensor = (now_seconds() - t0) / iters;
+
+  printf("%3dx%-3d %-4s  client decode+resize %7.3f ms | device 1/%d decode %6.3f + scale %6.3f ms | client tensor %6.3f ms | wire %6zu B (jpeg %zu B)\n",
+         dw, dh, channels == 3 ? "rgb" : "gray", client * 1e3, 1 << shift, t_decode / iters * 1e3, t_scale / iters * 1e3,
+         client_tensor * 1e3, sizeof(tensor_header_t) + tensor.size(), jpg.size());
+}
+
+int main(int argc, char **argv) {
+  Options o;
+  for (int i = 1; i + 1 < argc; i += 2) {
+    std::string k = argv[i];
+    const char *v = argv[i + 1];
+    if (k == "--jpeg") o.jpeg = v;
+    else if (k == "--iters") o.iters = atoi(v) > 0 ? atoi(v) : 1;
+    else if (k == "--quality") o.quality = atoi(v);
+    else {
+      fprintf(stderr, "usage: %s [--jpeg FRAME.jpg] [--iters 200] [--quality 80]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  int rc = run_checks();
+  std::vector<uint8_t> jpg;
+  if (!o.jpeg.empty()) {
+    if (!read_all(o.jpeg, &jpg)) {
+      fprintf(stderr, "cannot read %s\n", o.jpeg.c_str());
+      return 1;
+    }
+  } else {
+    jpg = encode_jpeg(synthetic_frame(320, 240), 320, 240, o.quality);
+  }
+  const int profiles[][3] = {{96, 96, 1}, {96, 96, 3}, {200, 200, 3}, {224, 224, 3}, {257, 257, 3}};
+  for (auto &p : profiles) bench(jpg, p[0], p[1], p[2], o.iters);
+  return rc;
+}
@@ -0,0 +1,230 @@
+#include "ws_client.h"
+
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <strings.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <random>
+
+namespace ws {
+
+static double now_seconds() {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static std::string base64(const uint8_t *p, size_t n) {
+  static const char tbl[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  std::string out;
+  for (size_t i = 0; i < n; i += 3) {
+    uint32_t v = p[i] << 16 | (i + 1 < n ? p[i + 1] << 8 : 0) | (i + 2 < n ? p[i + 2] : 0);
+    out += tbl[v >> 18 & 63];
+    out += tbl[v >> 12 & 63];
+    out += i + 1 < n ? tbl[v >> 6 & 63] : '=';
+    out += i + 2 < n ? tbl[v & 63] : '=';
+  }
+  return out;
+}
+
+bool Client::open(const std::string &host, int port, const std::string &path, int timeout_ms) {
+  close();
+  error_.clear();
+  addrinfo hints{}, *res = nullptr;
+  hints.ai_family = AF_INET;
+  hints.ai_socktype = SOCK_STREAM;
+  if (getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &res) != 0) {
+    error_ = "cannot resolve " + host;
+    return false;
+  }
+  fd_ = socket(res->ai_family, res->ai_socktype, res->ai_protocol);
+  if (fd_ >= 0) {
+    timeval tv{timeout_ms / 1000, (timeout_ms % 1000) * 1000};
+    setsockopt(fd_, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    setsockopt(fd_, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+    int one = 1;
+    setsockopt(fd_, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    if (connect(fd_, res->ai_addr, res->ai_addrlen) != 0) {
+      ::close(fd_);
+      fd_ = -1;
+    }
+  }
+  freeaddrinfo(res);
+  if (fd_ < 0) {
+    error_ = "cannot connect to " + host + ":" + std::to_string(port);
+    return false;
+  }
+
+  std::random_device rd;
+  uint8_t key[16];
+  for (uint8_t &b : key) b = (uint8_t)rd();
+  mask_seed_ = rd() | 1;
+  std::string req = "GET " + path + " HTTP/1.1\r\nHost: " + host + ":" + std::to_string(port) +
+                    "\r\nUpgrade: websocket\r\nConnection: Upgrade\r\nSec-WebSocket-Key: " + base64(key, sizeof(key)) +
+                    "\r\nSec-WebSocket-Version: 13\r\n\r\n";
+  if (::send(fd_, req.data(), req.size(), MSG_NOSIGNAL) != (ssize_t)req.size()) {
+    error_ = "send failed";
+    close();
+    return false;
+  }
+  // baca header response; sisa byte sesudahnya sudah milik frame pertama
+  std::string head;
+  char buf[1024];
+  size_t end;
+  while ((end = head.find("\r\n\r\n")) == std::string::npos) {
+    ssize_t n = recv(fd_, buf, sizeof(buf), 0);
+    if (n <= 0 || head.size() > 8192) {
+      error_ = "handshake: no response";
+      close();
+      return false;
+    }
+    head.append(buf, n);
+  }
+  if (head.compare(0, 12, "HTTP/1.1 101") != 0) {
+    error_ = "handshake: " + head.substr(0, head.find("\r\n"));
+    close();
+    return false;
+  }
+  in_.assign(head.begin() + end + 4, head.end());
+  in_pos_ = 0;
+  msg_.clear();
+  msg_op_ = -1;
+  return true;
+}
+
+bool Client::send(int opcode, const void *data, size_t len) {
+  if (fd_ < 0) return false;
+  uint8_t hdr[14];
+  size_t h = 0;
+  hdr[h++] = (uint8_t)(0x80 | opcode);
+  if (len < 126) {
+    hdr[h++] = (uint8_t)(0x80 | len);
+  } else if (len < 65536) {
+    hdr[h++] = 0x80 | 126;
+    hdr[h++] = (uint8_t)(len >> 8);
+    hdr[h++] = (uint8_t)len;
+  } else {
+    hdr[h++] = 0x80 | 127;
+    for (int i = 7; i >= 0; i--) hdr[h++] = (uint8_t)((uint64_t)len >> (8 * i));
+  }
+  // xorshift cukup: mask hanya wajib ada, bukan rahasia
+  mask_seed_ ^= mask_seed_ << 13;
+  mask_seed_ ^= mask_seed_ >> 17;
+  mask_seed_ ^= mask_seed_ << 5;
+  uint8_t mask[4] = {(uint8_t)(mask_seed_ >> 24), (uint8_t)(mask_seed_ >> 16), (uint8_t)(mask_seed_ >> 8), (uint8_t)mask_seed_};
+  memcpy(hdr + h, mask, 4);
+  h += 4;
+  std::vector<uint8_t> body((const uint8_t *)data, (const uint8_t *)data + len);
+  for (size_t i = 0; i < len; i++) body[i] ^= mask[i & 3];
+  iovec iov[2] = {{hdr, h}, {body.data(), len}};
+  msghdr mh{};
+  mh.msg_iov = iov;
+  mh.msg_iovlen = 2;
+  if (sendmsg(fd_, &mh, MSG_NOSIGNAL) != (ssize_t)(h + len)) {
+    error_ = std::string("send: ") + strerror(errno);
+    return false;
+  }
+  return true;
+}
+
+// Pastikan minimal need byte tersedia mulai in_pos_.
+bool Client::fill(size_t need, const std::atomic<bool> *stop) {
+  if (in_pos_ > 0 && in_pos_ >= in_.size() / 2) {
+    in_.erase(in_.begin(), in_.begin() + in_pos_);
+    in_pos_ = 0;
+  }
+  while (in_.size() - in_pos_ < need) {
+    if (stop && stop->load()) return false;
+    uint8_t buf[8192];
+    ssize_t n = recv(fd_, buf, sizeof(buf), 0);
+    if (n == 0) {
+      error_ = "closed by server";
+      return false;
+    }
+    if (n < 0) {
+      if (!(stop && stop->load())) error_ = std::string("recv: ") + strerror(errno);
+      return false;
+    }
+    in_.insert(in_.end(), buf, buf + n);
+  }
+  return true;
+}
+
+bool Client::read(Message *m, const std::atomic<bool> *stop) {
+  while (fd_ >= 0) {
+    if (!fill(2, stop)) return false;
+    const uint8_t *p = in_.data() + in_pos_;
+    bool fin = p[0] & 0x80;
+    int op = p[0] & 0x0F;
+    bool masked = p[1] & 0x80;
+    uint64_t len = p[1] & 0x7F;
+    size_t h = 2;
+    if (len == 126) h += 2;
+    else if (len == 127) h += 8;
+    if (masked) h += 4;
+    if (!fill(h, stop)) return false;
+    p = in_.data() + in_pos_;
+    if ((p[1] & 0x7F) == 126) {
+      len = (uint64_t)p[2] << 8 | p[3];
+    } else if ((p[1] & 0x7F) == 127) {
+      len = 0;
+      for (int i = 0; i < 8; i++) len = len << 8 | p[2 + i];
+    }
+    if (len > (64u << 20)) {
+      error_ = "frame too large";
+      return false;
+    }
+    if (!fill(h + len, stop)) return false;
+    p = in_.data() + in_pos_;
+    uint8_t *payload = in_.data() + in_pos_ + h;
+    if (masked) {
+      const uint8_t *mask = p + h - 4;
+      for (uint64_t i = 0; i < len; i++) payload[i] ^= mask[i & 3];
+    }
+    in_pos_ += h + len;
+
+    if (op == kPing) {
+      pings_++;
+      if (!send(kPong, payload, len)) return false;
+      continue;
+    }
+    if (op == kPong) continue;
+    if (op == kClose) {
+      send(kClose, payload, len < 2 ? len : 2);
+      error_ = len >= 2 ? "closed by server (" + std::to_string(payload[0] << 8 | payload[1]) + ")" : "closed by server";
+      return false;
+    }
+    if (op != kContinuation) {
+      msg_op_ = op;
+      msg_.clear();
+    } else if (msg_op_ < 0) {
+      error_ = "continuation without start";
+      return false;
+    }
+    msg_.insert(msg_.end(), payload, payload + len);
+    if (!fin) continue;
+    m->opcode = msg_op_;
+    m->data = msg_.data();
+    m->len = msg_.size();
+    m->host_ts = now_seconds();
+    msg_op_ = -1;
+    return true;
+  }
+  return false;
+}
+
+void Client::shutdown() {
+  if (fd_ >= 0) ::shutdown(fd_, SHUT_RDWR);
+}
+
+void Client::close() {
+  if (fd_ >= 0) ::close(fd_);
+  fd_ = -1;
+}
+
+}  // namespace ws
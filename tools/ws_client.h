@@ -0,0 +1,56 @@
+// Klien WebSocket (RFC 6455) minimal untuk tools host: handshake, kirim
+// frame ber-mask, terima frame teks/biner (fragmen digabung), ping dijawab
+// pong otomatis. Cukup untuk WebSocketsServer di 5_3.ino (:81).
+//
+//   ws::Client c;
+//   c.open("192.168.1.50", 81, "/", 5000);
+//   c.send_text("{\"action\":\"subscribe\",\"stream\":\"audio\"}");
+//   ws::Message m;
+//   while (c.read(&m, &stop)) { ... m.opcode, m.data, m.len ... }
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ws {
+
+enum Opcode { kContinuation = 0, kText = 1, kBinary = 2, kClose = 8, kPing = 9, kPong = 10 };
+
+struct Message {
+  int opcode;           // kText atau kBinary
+  const uint8_t *data;  // valid sampai read() berikutnya
+  size_t len;
+  double host_ts;       // steady clock saat frame terakhir lengkap (detik)
+};
+
+class Client {
+ public:
+  ~Client() { close(); }
+  // timeout_ms berlaku untuk connect, handshake dan setiap recv/send.
+  bool open(const std::string &host, int port, const std::string &path, int timeout_ms);
+  bool send(int opcode, const void *data, size_t len);
+  bool send_text(const std::string &text) { return send(kText, text.data(), text.size()); }
+  // Blok sampai satu pesan data lengkap. false kalau ditutup, error,
+  // timeout, atau *stop true (error() kosong untuk close/stop normal).
+  bool read(Message *m, const std::atomic<bool> *stop);
+  void close();
+  void shutdown();  // bangunkan read() dari thread lain
+  const std::string &error() const { return error_; }
+  uint64_t pings() const { return pings_; }
+
+ private:
+  bool fill(size_t need, const std::atomic<bool> *stop);
+
+  int fd_ = -1;
+  std::vector<uint8_t> in_;  // byte mentah yang belum diproses
+  size_t in_pos_ = 0;
+  std::vector<uint8_t> msg_;  // payload pesan (gabungan fragmen)
+  int msg_op_ = -1;
+  uint64_t pings_ = 0;
+  uint32_t mask_seed_ = 0x9E3779B9u;
+  std::string error_;
+};
+
+}  // namespace ws
@@ -5,6 +5,10 @@
 #include "esp_timer.h"
 #include "fb_gfx.h"
 #include <string.h>
+#include "cam_stream_esp.h"
+
+// Policy stream (lihat cam_stream_core.h). LED tetap diatur manual lewat /led.
+struct StreamConfig : cam_core::Defaults {};
 
 // =======================
 // === Konfigurasi Pin ===
@@ -122,20 +126,15 @@ void initCamera(){
     config.pin_reset = RESET_GPIO_NUM;
     config.xclk_freq_hz = 20000000;
     config.frame_size = FRAMESIZE_VGA; 
-    config.pixel_format = PIXFORMAT_JPEG; 
-    config.grab_mode = CAMERA_GRAB_WHEN_EMPTY;
-    config.fb_location = CAMERA_FB_IN_PSRAM;
     config.jpeg_quality = 12;
-    config.fb_count = 1;
+    // pixel_format, fb_count, grab_mode, fb_location dari StreamConfig
+    cam_core::apply_config<StreamConfig>(config, psramFound());
 
     // Deteksi PSRAM pada ESP32-S3
     if (psramFound()) {
         config.jpeg_quality = 10;
-        config.fb_count = 2;
-        config.grab_mode = CAMERA_GRAB_LATEST;
     } else {
         config.frame_size = FRAMESIZE_SVGA;
-        config.fb_location = CAMERA_FB_IN_DRAM;
     }
 
     esp_err_t err = esp_camera_init(&config);
@@ -160,59 +159,8 @@ void initCamera(){
 // === Server HTTP & Streaming Implementasi ===
 // =============================
 
-#define PART_BOUNDARY "123456789000000000000987654321"
-static const char* _STREAM_CONTENT_TYPE = "multipart/x-mixed-replace;boundary=" PART_BOUNDARY;
-static const char* _STREAM_BOUNDARY = "\r\n--" PART_BOUNDARY "\r\n";
-static const char* _STREAM_PART = "Content-Type: image/jpeg\r\nContent-Length: %u\r\n\r\n";
-
 static esp_err_t stream_handler(httpd_req_t *req){
-    camera_fb_t * fb = NULL;
-    esp_err_t res = ESP_OK;
-    size_t _jpg_buf_len = 0;
-    uint8_t * _jpg_buf = NULL;
-    char * part_buf[64];
-
-    res = httpd_resp_set_type(req, _STREAM_CONTENT_TYPE);
-    if(res != ESP_OK){ return res; }
-
-    while(true){
-        fb = esp_camera_fb_get();
-        if (!fb) {
-            Serial.println("Camera capture failed");
-            res = ESP_FAIL;
-        } else {
-            if(fb->format != PIXFORMAT_JPEG){
-                // Konversi ke JPEG jika format bukan JPEG
-                bool jpeg_converted = frame2jpg(fb, 80, &_jpg_buf, &_jpg_buf_len);
-                esp_camera_fb_return(fb);
-                fb = NULL;
-                if(!jpeg_converted){ res = ESP_FAIL; }
-            } else {
-                _jpg_buf_len = fb->len;
-                _jpg_buf = fb->buf;
-            }
-        }
-
-        if(res == ESP_OK){ res = httpd_resp_send_chunk(req, _STREAM_BOUNDARY, strlen(_STREAM_BOUNDARY)); }
-        if(res == ESP_OK){ 
-            size_t hlen = snprintf((char *)part_buf, 64, _STREAM_PART, _jpg_buf_len);
-            res = httpd_resp_send_chunk(req, (const char *)part_buf, hlen);
-        }
-        if(res == ESP_OK){ res = httpd_resp_send_chunk(req, (const char *)_jpg_buf, _jpg_buf_len); }
-        
-        // Kembalikan buffer ke pool atau bebaskan buffer yang dialokasikan (jika dikonversi)
-        if(fb){
-            esp_camera_fb_return(fb);
-            fb = NULL;
-        } else if(_jpg_buf) {
-            // Jika fb==NULL, berarti _jpg_buf dialokasikan oleh frame2jpg
-            if(fb == NULL) free(_jpg_buf); 
-            _jpg_buf = NULL;
-        }
-        
-        if(res != ESP_OK){ break; }
-    }
-    return res;
+    return cam_core::serve_httpd<StreamConfig>(req);
 }
 
 static esp_err_t led_handler(httpd_req_t *req){